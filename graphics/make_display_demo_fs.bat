@@ -60,7 +60,13 @@ set files=%files% %P%f_fixrus
 set files=%files% %P%f_larab
 set files=%files% %P%f_monfur
 
+rem Page-aligned image with a sorted file table and thumbnails, built from
+rem the originals listed in display_demo.tsfs:
+python ..\tools\tsfs\mkfs.tsfs\mkfs.tsfs.py -s -p 1024 -m display_demo.tsfs -o display_demo.raw
+
+rem Old image from the converted files above, without thumbnails, and with
+rem 16bpp alarm lights which the water tank no longer reads:
 rem python ..\tools\tsfs\mkfs.tsfs\mkfs.tsfs.py -o display_demo.raw %files%
-..\tools\tsfs\mkfs.tsfs\dist\mkfs.tsfs.exe -o display_demo.raw %files%
+rem ..\tools\tsfs\mkfs.tsfs\dist\mkfs.tsfs.exe -o display_demo.raw %files%
 
 pause
@@ -0,0 +1,7 @@
+cflags-gnu-y	+= -std=gnu99
+
+incdir-y	+= $(src)/apps/bench/include
+src-y		+= apps/$(app)/main.c
+
+app-hdr-y	+= membag.h sysfont.h win.h wtk.h
+hdr-y		+= $(addprefix apps/bench/include/app/,$(app-hdr-y))
@@ -0,0 +1,23 @@
+include $(src)/board/host/config.mk
+include $(src)/apps/bench/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+
+CONFIG_TIMER_RESOLUTION=1000000
+
+CONFIG_BLOCK_HOST_FILE=y
+
+# Set to y to profile the benchmarks
+CONFIG_PROFILE=n
+
+# Set to y to print work queue and interrupt latency statistics
+CONFIG_LATENCY=n
+
+# Let the sleep manager pick the sleep mode, and print its statistics
+CONFIG_SLEEPMGR=y
+CONFIG_SLEEPMGR_STATS=y
+
+# Run the delayed task benchmark, with delayed tasks on timer 1
+CONFIG_DELAYED_TASK=y
+CONFIG_TIMER_1=y
+CONFIG_DELAYED_TASK_TIMER_ID=1
@@ -0,0 +1,49 @@
+include $(src)/board/xplain/config.mk
+include $(src)/apps/bench/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+CONFIG_SYSCLK_SOURCE=SYSCLK_SRC_PLL
+CONFIG_PLL0_SOURCE=PLL_SRC_RC32MHZ
+CONFIG_PLL0_DIV=4
+CONFIG_PLL0_MUL=8
+CONFIG_SYSCLK_PSADIV=XMEGA_CLK_PSADIV_1
+CONFIG_SYSCLK_PSBCDIV=XMEGA_CLK_PSBCDIV_1_2
+
+CONFIG_CSTACK_SIZE=0x100
+CONFIG_RSTACK_SIZE=0x80
+
+CONFIG_MALLOC_SIMPLE=y
+
+# Huge memory copies, and the asynchronous ones, are done by DMA
+CONFIG_HUGEMEM_DMA=y
+
+# The counter runs at CPU_HZ / 64, which wraps after 131 ms
+CONFIG_TC=y
+CONFIG_TIMER_RESOLUTION=500000
+
+CONFIG_SPI=y
+CONFIG_SPI0=y
+CONFIG_SPI_MASTER=y
+CONFIG_SPI_BUF_LIST_API=y
+CONFIG_SPI_MASTER_INT=y
+
+CONFIG_AT45=y
+CONFIG_BLOCK_DATAFLASH=y
+CONFIG_APP_DATAFLASH_SPI_ID=0
+
+# Set to y to profile the benchmarks, sampling with TC1
+CONFIG_PROFILE=n
+CONFIG_PROFILE_TC_ID=1
+
+# Set to y to print work queue and interrupt latency statistics
+CONFIG_LATENCY=n
+
+# Let the sleep manager pick the sleep mode, and print its statistics
+CONFIG_SLEEPMGR=y
+CONFIG_SLEEPMGR_STATS=y
+
+# Poll the DataFlash and run the delayed task benchmark with delayed tasks
+# on TC2
+CONFIG_DELAYED_TASK=y
+CONFIG_TIMER_2=y
+CONFIG_DELAYED_TASK_TIMER_ID=2
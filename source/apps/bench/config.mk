@@ -0,0 +1,45 @@
+CONFIG_MAINLOOP=y
+
+CONFIG_PHYSMEM=y
+CONFIG_MEMPOOL=y
+CONFIG_MEMBAG=y
+CONFIG_BUFFER=y
+CONFIG_NR_BUFFERS=2
+
+CONFIG_GFX=y
+CONFIG_GFX_USE_CLIPPING=y
+CONFIG_GFX_FIXED_ORIENTATION=y
+CONFIG_GFX_HX8347A=y
+CONFIG_GFX_WIN=y
+CONFIG_GFX_WTK=y
+CONFIG_GFX_SYSFONT=y
+
+# Also draw the bitmap benchmarks as indexed color bitmaps
+CONFIG_GFX_BITMAP_INDEXED=y
+
+# Buttons replay their drawing from a display list on redraw
+CONFIG_GFX_DLIST=y
+
+CONFIG_HUGEMEM=y
+CONFIG_HUGEMEM_ASYNC=y
+CONFIG_EXTRAM_SDRAM=y
+
+CONFIG_BLOCK=y
+CONFIG_FS_TSFS=y
+CONFIG_FS_TSFS_USE_HUGEMEM=y
+
+CONFIG_TIMER=y
+CONFIG_TIMER_0=y
+CONFIG_TIMER_ID=0
+
+# Results are printed on the debug console
+CONFIG_STREAM=y
+CONFIG_SERIAL_UART=y
+CONFIG_UART_CTRL=y
+CONFIG_UART_BAUD_RATE=115200
+CONFIG_DEBUG_CONSOLE=y
+CONFIG_DEBUG_UART=y
+CONFIG_DEBUG_UART_ID=0
+CONFIG_DEBUG_LEVEL=DEBUG_INFO
+
+config_mk	+= $(appsrc)/config.mk
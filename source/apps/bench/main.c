@@ -0,0 +1,1504 @@
+/**
+ * \file
+ *
+ * \brief Framework benchmark application
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * \page bench Framework Benchmark
+ *
+ * This application measures the parts of the framework which dominate
+ * the run time of the graphical applications:
+ *
+ * - \ref gfx_gfx "Graphics drivers": filled rectangles, lines, text
+ *   and bitmaps from progmem and hugemem. If
+ *   \a CONFIG_GFX_BITMAP_INDEXED is defined, the bitmaps are also drawn
+ *   from one bit per pixel and a palette. Lines, circles, rounded
+ *   rectangles and thick lines are also drawn the way they were before
+ *   the primitives drew spans, i.e. a pixel at a time or from many small
+ *   primitives, so that the two can be compared.
+ * - \ref gfx_win "Window system": redraw of a frame holding one of
+ *   each of the common \ref gfx_wtk "widgets".
+ * - \ref membag_group "Memory bags": allocation and release, also
+ *   with the smallest bag exhausted, compared with a reference allocator
+ *   which walks the bags the way membag did before its size class and
+ *   owner tables.
+ * - \ref hugemem_group "Huge memory": hugemem_copy() between two
+ *   buffers in external RAM, and the same copy with hugemem_copy_async()
+ *   if \a CONFIG_HUGEMEM_ASYNC is defined.
+ * - \ref stream "Character streams": stream_printf() into a stream
+ *   which discards its data, so only the formatting is measured.
+ * - \ref workqueue_group "Work queues": latency from queuing a task
+ *   until the main loop runs it.
+ * - \ref block_device_group "Block device": single-block reads and
+ *   writes on the DataFlash, or the host file on the host.
+ * - \ref tsfs_group "TSFS": sequential and random reads from the first
+ *   file in the file system, if there is one.
+ * - \ref delayed_task_group "Delayed tasks": a batch of tasks with
+ *   staggered delays, which should all be run from a single wake-up.
+ *
+ * The benchmarks are timed with the free-running counter of timer
+ * \a CONFIG_TIMER_ID at \a CONFIG_TIMER_RESOLUTION Hz. Each operation is
+ * timed separately, so only a single operation has to complete before
+ * the 16-bit counter wraps. The memory bag operations are too short for
+ * that, so they are timed in batches of #BENCH_MEMBAG_BATCH. One line is
+ * printed on the debug console for each benchmark:
+ *
+ * \code
+ * bench <name> <iterations> <bytes> <ticks> <ticks per second>
+ * \endcode
+ *
+ * \a bytes is the amount of data transferred by the benchmarks which
+ * move data, and 0 for the others. On the host, the graphics benchmarks
+ * report the number of transfers on the bus of the simulated display
+ * controller instead, which is what they would cost on the real bus.
+ * The run ends with the line
+ * <tt>bench done</tt>. Benchmarks which cannot run, e.g. because there
+ * is no file system, print <tt>bench &lt;name&gt; skipped</tt> instead.
+ *
+ * The results only depend on the counter and the debug USART, so the
+ * xplain image can also be run in a simulator which models those. The
+ * host configuration runs the same suite natively. There, the counter
+ * follows the virtual clock of the host port, which stands still while
+ * the synchronous benchmarks run. So these are timed with
+ * host_clock_real() instead, and report the real time spent on the
+ * host, converted to counter ticks. The asynchronous benchmarks report
+ * the virtual time spent in the main loop.
+ *
+ * The block device write benchmark writes back the data it just read,
+ * so the contents of the DataFlash are preserved.
+ *
+ * If \a CONFIG_PROFILE is defined, the whole run is profiled with the
+ * \ref profile_group "sampling profiler", and the samples are printed
+ * before <tt>bench done</tt>. Likewise, if \a CONFIG_LATENCY is defined,
+ * the \ref latency_group "latency statistics" are printed, and if
+ * \a CONFIG_SLEEPMGR_STATS is defined, the
+ * \ref sleepmgr_group "sleep manager statistics" are printed.
+ *
+ * The delayed-batch benchmark reports the time from scheduling the batch
+ * until its last task ran, followed by a line with the number of timer
+ * alarms and the number of tasks they ran:
+ *
+ * \code
+ * bench delayed-batch <tasks> 0 <ticks> <ticks per second>
+ * delayed <alarms> <alarm tasks> <polled tasks>
+ * \endcode
+ */
+
+#include <assert.h>
+#include <bitops.h>
+#include <board.h>
+#include <buffer.h>
+#include <debug.h>
+#include <hugemem.h>
+#include <mainloop.h>
+#include <membag.h>
+#include <mempool.h>
+#include <physmem.h>
+#include <progmem.h>
+#include <status_codes.h>
+#include <stream.h>
+#include <timer.h>
+#include <util.h>
+#include <workqueue.h>
+
+#include <app/membag.h>
+#include <block/device.h>
+#include <board/physmem.h>
+#include <clk/sys.h>
+#include <fs/tsfs.h>
+
+#include <gfx/gfx.h>
+#include <gfx/sysfont.h>
+#include <gfx/win.h>
+#include <gfx/wtk.h>
+
+#ifdef CONFIG_BLOCK_DATAFLASH
+#include <spi.h>
+#include <block/dataflash.h>
+
+DECLARE_SPI_MASTER(CONFIG_APP_DATAFLASH_SPI_ID, bench_master);
+DECLARE_SPI_DEVICE(CONFIG_APP_DATAFLASH_SPI_ID, bench_device);
+#elif defined(CONFIG_BLOCK_HOST_FILE)
+#include <block/host_file.h>
+#endif
+
+#ifdef CONFIG_ARCH_HOST
+#include <arch/host_clock.h>
+#endif
+
+#ifdef CONFIG_LATENCY
+#include <latency.h>
+#endif
+
+#ifdef CONFIG_SLEEPMGR_STATS
+#include <sleepmgr.h>
+#endif
+
+#ifdef CONFIG_DELAYED_TASK
+#include <delayed_task.h>
+#endif
+
+#ifdef CONFIG_HUGEMEM_ASYNC
+#include <hugemem_async.h>
+#endif
+
+#ifdef CONFIG_PROFILE
+#include <profile.h>
+
+//! Number of profiler samples per second while the benchmarks run.
+#define BENCH_PROFILE_RATE      1000
+#endif
+
+//! Number of iterations of each graphics benchmark.
+#define BENCH_GFX_ITERATIONS    16
+//! Size of the area drawn by the graphics benchmarks.
+#define BENCH_GFX_SIZE          64
+//! Radius of the corners of the rounded rectangles.
+#define BENCH_GFX_RADIUS        8
+//! Thickness of the thick lines.
+#define BENCH_GFX_THICKNESS     5
+//! Size of the bitmaps drawn by the bitmap benchmarks.
+#define BENCH_BITMAP_SIZE       16
+//! Number of redraws of the widget tree.
+#define BENCH_WIN_ITERATIONS    8
+//! Number of timed batches of allocation and release pairs.
+#define BENCH_MEMBAG_ITERATIONS 32
+#ifdef CONFIG_ARCH_HOST
+//! Number of pairs in each batch, more on the much faster host.
+# define BENCH_MEMBAG_BATCH     1024
+#else
+//! Number of pairs in each batch.
+# define BENCH_MEMBAG_BATCH     16
+#endif
+//! Number of blocks in each bag of the reference allocator.
+#define BENCH_LINEAR_NR_BLOCKS  2
+//! Number of copies done by each huge memory benchmark.
+#define BENCH_HUGEMEM_ITERATIONS 16
+//! Number of bytes moved by each huge memory copy.
+#define BENCH_HUGEMEM_SIZE      1024
+//! Number of stream_printf() calls.
+#define BENCH_PRINTF_ITERATIONS 16
+//! Number of tasks queued by the workqueue latency benchmark.
+#define BENCH_WQ_ITERATIONS     32
+//! Number of blocks read and written by the block device benchmark.
+#define BENCH_BLOCK_ITERATIONS  16
+//! Largest block size supported by the block device benchmark.
+#define BENCH_BLOCK_SIZE        512
+//! Number of bytes read by each TSFS read.
+#define BENCH_TSFS_CHUNK        64
+//! Number of TSFS reads in each of the TSFS benchmarks.
+#define BENCH_TSFS_ITERATIONS   32
+//! Number of tasks in the delayed task batch.
+#define BENCH_DELAYED_TASKS     4
+//! Time between the delays of the tasks in the batch, in ms.
+#define BENCH_DELAYED_STEP_MS   1
+
+//! States of the asynchronous benchmarks, run in this order.
+enum bench_state {
+	BENCH_WORKQUEUE,
+	BENCH_HUGEMEM_ASYNC,
+	BENCH_BLOCK_READ,
+	BENCH_BLOCK_WRITE,
+	BENCH_TSFS_INIT,
+	BENCH_TSFS_SEQUENTIAL,
+	BENCH_TSFS_RANDOM,
+	BENCH_DELAYED_BATCH,
+	BENCH_DONE,
+};
+
+//! Accumulated result of one benchmark.
+struct bench_result {
+	//! Number of operations timed.
+	uint16_t        iterations;
+	//! Number of bytes transferred.
+	uint32_t        bytes;
+	//! Number of counter ticks spent.
+	uint32_t        ticks;
+};
+
+//! Context of the asynchronous benchmarks.
+struct bench_context {
+	//! Task running the current benchmark step.
+	struct workqueue_task   task;
+	//! Current benchmark.
+	enum bench_state        state;
+	//! Counter value when the current operation was started.
+	uint16_t                start;
+	//! True if an operation is being timed.
+	bool                    timing;
+	//! Result of the current benchmark.
+	struct bench_result     result;
+	//! Result of the block device write benchmark.
+	struct bench_result     write_result;
+	//! Operation of the current block device request.
+	enum block_operation    operation;
+	//! Block device under test.
+	struct block_device     *bdev;
+	//! Buffer descriptor for block device transfers.
+	struct buffer           buf;
+	//! File system on \a bdev.
+	struct tsfs             fs;
+	//! File read by the TSFS benchmarks.
+	struct tsfs_file        file;
+	//! State of the random number generator picking TSFS offsets.
+	uint16_t                seed;
+	//! Data buffer for block device and file system reads.
+	uint8_t                 data[BENCH_BLOCK_SIZE];
+	//! Source and destination of the huge memory copies, back to back.
+	hugemem_ptr_t           hugemem_buf;
+#ifdef CONFIG_HUGEMEM_ASYNC
+	//! Request of the asynchronous huge memory copy.
+	struct hugemem_request  hugemem_req;
+#endif
+#ifdef CONFIG_DELAYED_TASK
+	//! Tasks of the delayed task batch.
+	struct workqueue_task   batch_task[BENCH_DELAYED_TASKS];
+	//! Delayed tasks of the delayed task batch.
+	struct delayed_task     batch_dtask[BENCH_DELAYED_TASKS];
+#endif
+};
+
+static struct bench_context bench_ctx;
+
+//! Free-running timer used for all measurements.
+static struct timer bench_timer;
+//! Resolution of \ref bench_timer in Hz.
+static uint32_t bench_timer_hz;
+
+//! Black and white stripes, making up a progmem bitmap.
+#define BENCH_BITMAP_ROW(a, b)                                          \
+	a, a, a, a, a, a, a, a, b, b, b, b, b, b, b, b
+
+#define BENCH_COLOR_A   GFX_COLOR(0, 0, 0)
+#define BENCH_COLOR_B   GFX_COLOR(255, 255, 255)
+
+static DEFINE_PROGMEM(gfx_color_t,
+		bench_pixels[BENCH_BITMAP_SIZE * BENCH_BITMAP_SIZE]) = {
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_A, BENCH_COLOR_B),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+	BENCH_BITMAP_ROW(BENCH_COLOR_B, BENCH_COLOR_A),
+};
+
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+//! The stripes of \ref bench_pixels, one bit per pixel.
+static DEFINE_PROGMEM(uint8_t,
+		bench_indexed_pixels[BENCH_BITMAP_SIZE * BENCH_BITMAP_SIZE / 8]) = {
+	0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff,
+	0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff,
+	0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+	0xff, 0x00, 0xff, 0x00, 0xff, 0x00, 0xff, 0x00,
+};
+
+//! Palette of \ref bench_indexed_pixels.
+static gfx_color_t bench_palette[] = {
+	BENCH_COLOR_A,
+	BENCH_COLOR_B,
+};
+#endif
+
+static inline uint16_t bench_get_time(void)
+{
+	return timer_get_time(CONFIG_TIMER_ID, &bench_timer);
+}
+
+/**
+ * \brief Read the time of an operation which doesn't return to the main
+ * loop, in counter ticks
+ *
+ * On the host, the counter follows the virtual clock, which doesn't move
+ * while such an operation runs, so the real time is used instead.
+ */
+static inline uint16_t bench_get_sync_time(void)
+{
+#ifdef CONFIG_ARCH_HOST
+	return host_clock_real() * bench_timer_hz / 1000000;
+#else
+	return bench_get_time();
+#endif
+}
+
+//! Add \a delta ticks and \a bytes to \a result.
+static inline void bench_add(struct bench_result *result, uint16_t delta,
+		uint32_t bytes)
+{
+	result->iterations++;
+	result->bytes += bytes;
+	result->ticks += delta;
+}
+
+//! Read the counter at the start of an operation.
+static inline uint16_t bench_begin(void)
+{
+	return bench_get_time();
+}
+
+//! Add the time since \a start and \a bytes to \a result.
+static inline void bench_end(struct bench_result *result, uint16_t start,
+		uint32_t bytes)
+{
+	bench_add(result, bench_get_time() - start, bytes);
+}
+
+//! Read the time at the start of a synchronous operation.
+static inline uint16_t bench_sync_begin(void)
+{
+	return bench_get_sync_time();
+}
+
+//! Add the time since \a start of a synchronous operation to \a result.
+static inline void bench_sync_end(struct bench_result *result,
+		uint16_t start, uint32_t bytes)
+{
+	bench_add(result, bench_get_sync_time() - start, bytes);
+}
+
+static void bench_report(const char *name, struct bench_result *result)
+{
+	dbg_info("bench %s %u %lu %lu %lu\n", name, result->iterations,
+			(unsigned long)result->bytes,
+			(unsigned long)result->ticks,
+			(unsigned long)bench_timer_hz);
+
+	result->iterations = 0;
+	result->bytes = 0;
+	result->ticks = 0;
+}
+
+static void bench_skip(const char *name)
+{
+	dbg_info("bench %s skipped\n", name);
+}
+
+//! Read the number of transfers on the display bus, if it is counted.
+static inline uint32_t bench_gfx_get_transfers(void)
+{
+#ifdef CONFIG_CPU_HOST
+	return gfx_hx8347a_get_bus_transfers();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * \brief Draw \a bmp at each of the positions of a grid
+ *
+ * \param name Benchmark name.
+ * \param bmp  Bitmap to draw.
+ */
+static void bench_gfx_bitmap(const char *name, struct gfx_bitmap *bmp)
+{
+	struct bench_result     result = { 0 };
+	gfx_coord_t             x;
+	gfx_coord_t             y;
+	uint32_t                transfers;
+	uint16_t                start;
+	uint8_t                 i;
+
+	for (i = 0; i < BENCH_GFX_ITERATIONS; i++) {
+		x = (i % 4) * BENCH_BITMAP_SIZE;
+		y = (i / 4) * BENCH_BITMAP_SIZE;
+
+		transfers = bench_gfx_get_transfers();
+		start = bench_sync_begin();
+		gfx_draw_bitmap(bmp, x, y);
+		bench_sync_end(&result, start,
+				bench_gfx_get_transfers() - transfers);
+	}
+
+	bench_report(name, &result);
+}
+
+/**
+ * \brief Function drawing shape number \a i of a graphics benchmark
+ *
+ * \param i     Iteration, from 0 to #BENCH_GFX_ITERATIONS - 1.
+ * \param color Color to draw with.
+ */
+typedef void (*bench_gfx_draw_t)(uint8_t i, gfx_color_t color);
+
+//! Offset along the Y axis between the lines of the line benchmarks.
+#define BENCH_GFX_STEP          (BENCH_GFX_SIZE / BENCH_GFX_ITERATIONS)
+
+static void bench_gfx_fill(uint8_t i, gfx_color_t color)
+{
+	gfx_draw_filled_rect(0, 0, BENCH_GFX_SIZE, BENCH_GFX_SIZE, color);
+}
+
+static void bench_gfx_text(uint8_t i, gfx_color_t color)
+{
+	gfx_draw_string("Benchmark", 0, i * SYSFONT_LINESPACING,
+			&sysfont, color, BENCH_COLOR_B);
+}
+
+static void bench_gfx_line(uint8_t i, gfx_color_t color)
+{
+	gfx_draw_line(0, i * BENCH_GFX_STEP,
+			BENCH_GFX_SIZE - 1,
+			BENCH_GFX_SIZE - 1 - i * BENCH_GFX_STEP, color);
+}
+
+/**
+ * \brief Draw the same line as bench_gfx_line(), a pixel at a time
+ *
+ * This is how gfx_draw_line() drew lines before it drew them as spans:
+ * the bottom right limit is set once, and each pixel moves the top left
+ * limit.
+ */
+static void bench_gfx_line_pixel(uint8_t i, gfx_color_t color)
+{
+	gfx_coord_t     x = 0;
+	gfx_coord_t     y = i * BENCH_GFX_STEP;
+	gfx_coord_t     dx = BENCH_GFX_SIZE - 1;
+	gfx_coord_t     dy = BENCH_GFX_SIZE - 1 - 2 * y;
+	int8_t          yinc = 1;
+	int16_t         e = dx >> 1;
+
+	if (dy < 0) {
+		yinc = -1;
+		dy = -dy;
+	}
+
+	// The lines are all more flat than steep.
+	assert(dy <= dx);
+
+	gfx_set_bottom_right_limit(gfx_get_width() - 1,
+			gfx_get_height() - 1);
+
+	for (; x <= dx; x++) {
+		gfx_draw_line_pixel(x, y, color);
+		e -= dy;
+		if (e < 0) {
+			e += dx;
+			y += yinc;
+		}
+	}
+}
+
+static void bench_gfx_circle(uint8_t i, gfx_color_t color)
+{
+	gfx_draw_circle(BENCH_GFX_SIZE / 2, BENCH_GFX_SIZE / 2, i * 2 + 1,
+			color, GFX_WHOLE);
+}
+
+/**
+ * \brief Draw the same circle as bench_gfx_circle(), a pixel at a time
+ *
+ * This is how gfx_draw_circle() drew circles before it drew them as
+ * spans: one pixel per octant for each step.
+ */
+static void bench_gfx_circle_pixel(uint8_t i, gfx_color_t color)
+{
+	gfx_coord_t     x = BENCH_GFX_SIZE / 2;
+	gfx_coord_t     y = BENCH_GFX_SIZE / 2;
+	gfx_coord_t     offset_x = 0;
+	gfx_coord_t     offset_y = i * 2 + 1;
+	int16_t         error = 3 - 2 * offset_y;
+
+	while (offset_x <= offset_y) {
+		gfx_draw_pixel(x + offset_y, y - offset_x, color);
+		gfx_draw_pixel(x + offset_x, y - offset_y, color);
+		gfx_draw_pixel(x - offset_x, y - offset_y, color);
+		gfx_draw_pixel(x - offset_y, y - offset_x, color);
+		gfx_draw_pixel(x - offset_y, y + offset_x, color);
+		gfx_draw_pixel(x - offset_x, y + offset_y, color);
+		gfx_draw_pixel(x + offset_x, y + offset_y, color);
+		gfx_draw_pixel(x + offset_y, y + offset_x, color);
+
+		if (error < 0) {
+			error += (offset_x << 2) + 6;
+		} else {
+			error += ((offset_x - offset_y) << 2) + 10;
+			offset_y--;
+		}
+		offset_x++;
+	}
+}
+
+static void bench_gfx_rounded_rect(uint8_t i, gfx_color_t color)
+{
+	gfx_draw_rounded_rect(i, i, BENCH_GFX_SIZE - 2 * i,
+			BENCH_GFX_SIZE - 2 * i, BENCH_GFX_RADIUS, color);
+}
+
+/**
+ * \brief Draw the same shape as bench_gfx_rounded_rect() from its sides
+ * and corners
+ *
+ * This is how a widget would draw a rounded rectangle without
+ * gfx_draw_rounded_rect(): four lines and four quadrants of a circle.
+ */
+static void bench_gfx_rounded_rect_pieces(uint8_t i, gfx_color_t color)
+{
+	gfx_coord_t     r = BENCH_GFX_RADIUS;
+	gfx_coord_t     x1 = i;
+	gfx_coord_t     y1 = i;
+	gfx_coord_t     x2 = BENCH_GFX_SIZE - 1 - i;
+	gfx_coord_t     y2 = BENCH_GFX_SIZE - 1 - i;
+	gfx_coord_t     side = x2 - x1 - 2 * r - 1;
+
+	gfx_draw_horizontal_line(x1 + r + 1, y1, side, color);
+	gfx_draw_horizontal_line(x1 + r + 1, y2, side, color);
+	gfx_draw_vertical_line(x1, y1 + r + 1, side, color);
+	gfx_draw_vertical_line(x2, y1 + r + 1, side, color);
+	gfx_draw_circle(x2 - r, y1 + r, r, color, GFX_QUADRANT0);
+	gfx_draw_circle(x1 + r, y1 + r, r, color, GFX_QUADRANT1);
+	gfx_draw_circle(x1 + r, y2 - r, r, color, GFX_QUADRANT2);
+	gfx_draw_circle(x2 - r, y2 - r, r, color, GFX_QUADRANT3);
+}
+
+static void bench_gfx_thick_line(uint8_t i, gfx_color_t color)
+{
+	gfx_draw_thick_line(0, BENCH_GFX_THICKNESS + i * BENCH_GFX_STEP,
+			BENCH_GFX_SIZE - 1, BENCH_GFX_SIZE - 1
+			- BENCH_GFX_THICKNESS - i * BENCH_GFX_STEP,
+			BENCH_GFX_THICKNESS, color);
+}
+
+/**
+ * \brief Draw about the same line as bench_gfx_thick_line() from thin
+ * lines
+ *
+ * This is how a widget would draw a thick line without
+ * gfx_draw_thick_line(): one line for each pixel of thickness.
+ */
+static void bench_gfx_thick_line_pieces(uint8_t i, gfx_color_t color)
+{
+	gfx_coord_t     y1 = BENCH_GFX_THICKNESS + i * BENCH_GFX_STEP;
+	gfx_coord_t     y2 = BENCH_GFX_SIZE - 1 - BENCH_GFX_THICKNESS
+			- i * BENCH_GFX_STEP;
+	uint8_t         j;
+
+	// Start with the top line of the stack.
+	y1 -= BENCH_GFX_THICKNESS / 2;
+	y2 -= BENCH_GFX_THICKNESS / 2;
+
+	for (j = 0; j < BENCH_GFX_THICKNESS; j++)
+		gfx_draw_line(0, y1 + j, BENCH_GFX_SIZE - 1, y2 + j, color);
+}
+
+/**
+ * \brief Time #BENCH_GFX_ITERATIONS calls to \a draw
+ *
+ * The colors alternate, so that every call changes the pixels it draws.
+ *
+ * \param name Benchmark name.
+ * \param draw Function drawing the shapes.
+ */
+static void bench_gfx_shapes(const char *name, bench_gfx_draw_t draw)
+{
+	struct bench_result     result = { 0 };
+	uint32_t                transfers;
+	uint16_t                start;
+	uint8_t                 i;
+
+	for (i = 0; i < BENCH_GFX_ITERATIONS; i++) {
+		transfers = bench_gfx_get_transfers();
+		start = bench_sync_begin();
+		draw(i, (i & 1) ? BENCH_COLOR_A : BENCH_COLOR_B);
+		bench_sync_end(&result, start,
+				bench_gfx_get_transfers() - transfers);
+	}
+
+	bench_report(name, &result);
+}
+
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+/**
+ * \brief Draw \ref bench_pixels as one bit per pixel indexed bitmaps
+ *
+ * The pixels are drawn from progmem and hugemem, like the 16-bit
+ * bitmaps, so the difference is the cost of the palette expansion.
+ */
+static void bench_gfx_indexed(void)
+{
+	struct gfx_indexed_pixmap       pixmap;
+	struct gfx_bitmap               bmp;
+	uint8_t                         row[sizeof(bench_indexed_pixels)];
+	uint8_t                         i;
+
+	pixmap.bpp = 1;
+	pixmap.transparent = GFX_INDEX_NONE;
+	pixmap.palette = bench_palette;
+	pixmap.pixels.progmem = bench_indexed_pixels;
+
+	bmp.width = BENCH_BITMAP_SIZE;
+	bmp.height = BENCH_BITMAP_SIZE;
+	bmp.type = BITMAP_INDEXED_PROGMEM;
+	bmp.data.indexed = &pixmap;
+	bench_gfx_bitmap("gfx-bitmap-indexed-progmem", &bmp);
+
+	pixmap.pixels.hugemem = hugemem_alloc(&board_extram_pool,
+			sizeof(bench_indexed_pixels), 0);
+	if (pixmap.pixels.hugemem == HUGEMEM_NULL) {
+		bench_skip("gfx-bitmap-indexed-hugemem");
+		return;
+	}
+
+	for (i = 0; i < sizeof(row); i++)
+		row[i] = progmem_read8(&bench_indexed_pixels[i]);
+	hugemem_write_block(pixmap.pixels.hugemem, row, sizeof(row));
+
+	bmp.type = BITMAP_INDEXED_HUGEMEM;
+	bench_gfx_bitmap("gfx-bitmap-indexed-hugemem", &bmp);
+}
+#endif
+
+static void bench_gfx(void)
+{
+	struct gfx_bitmap       bmp;
+	hugemem_ptr_t           hugemem_pixels;
+	uint8_t                 i;
+
+	gfx_set_clipping(0, 0, gfx_get_width() - 1, gfx_get_height() - 1);
+
+	bench_gfx_shapes("gfx-fill", bench_gfx_fill);
+	bench_gfx_shapes("gfx-line", bench_gfx_line);
+	bench_gfx_shapes("gfx-line-pixel", bench_gfx_line_pixel);
+	bench_gfx_shapes("gfx-circle", bench_gfx_circle);
+	bench_gfx_shapes("gfx-circle-pixel", bench_gfx_circle_pixel);
+	bench_gfx_shapes("gfx-rounded-rect", bench_gfx_rounded_rect);
+	bench_gfx_shapes("gfx-rounded-rect-pieces",
+			bench_gfx_rounded_rect_pieces);
+	bench_gfx_shapes("gfx-thick-line", bench_gfx_thick_line);
+	bench_gfx_shapes("gfx-thick-line-pieces",
+			bench_gfx_thick_line_pieces);
+	bench_gfx_shapes("gfx-text", bench_gfx_text);
+
+	bmp.width = BENCH_BITMAP_SIZE;
+	bmp.height = BENCH_BITMAP_SIZE;
+	bmp.type = BITMAP_PROGMEM;
+	bmp.data.progmem = bench_pixels;
+	bench_gfx_bitmap("gfx-bitmap-progmem", &bmp);
+
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+	bench_gfx_indexed();
+#endif
+
+	hugemem_pixels = hugemem_alloc(&board_extram_pool,
+			sizeof(bench_pixels), 0);
+	if (hugemem_pixels == HUGEMEM_NULL) {
+		bench_skip("gfx-bitmap-hugemem");
+		return;
+	}
+
+	for (i = 0; i < BENCH_BITMAP_SIZE; i++) {
+		gfx_color_t     row[BENCH_BITMAP_SIZE];
+		uint8_t         j;
+
+		for (j = 0; j < BENCH_BITMAP_SIZE; j++)
+			row[j] = progmem_read16(&bench_pixels[i
+					* BENCH_BITMAP_SIZE + j]);
+
+		hugemem_write_block((hugemem_ptr_t)((phys_addr_t)hugemem_pixels
+					+ i * sizeof(row)), row, sizeof(row));
+	}
+
+	bmp.type = BITMAP_HUGEMEM;
+	bmp.data.hugemem = hugemem_pixels;
+	bench_gfx_bitmap("gfx-bitmap-hugemem", &bmp);
+}
+
+/**
+ * \brief Map the window of the \a type widget \a widget, if it was created
+ */
+#define bench_win_show(type, widget)                                    \
+	do {                                                            \
+		struct wtk_##type *bench_widget = (widget);             \
+		if (bench_widget)                                       \
+			win_show(wtk_##type##_as_child(bench_widget));  \
+	} while (0)
+
+/**
+ * \brief Redraw a frame holding one of each of the common widgets
+ *
+ * The widgets are destroyed afterwards, which returns their memory to
+ * the membags before the membag benchmark runs.
+ */
+static void bench_win(void)
+{
+	struct bench_result     result = { 0 };
+	struct wtk_basic_frame  *frame;
+	struct wtk_radio_group  *group;
+	struct win_window       *parent;
+	struct win_area         area;
+	struct gfx_bitmap       background;
+	uint16_t                start;
+	uint8_t                 i;
+
+	background.type = BITMAP_SOLID;
+	background.data.color = GFX_COLOR(64, 64, 128);
+
+	area.pos.x = 0;
+	area.pos.y = 0;
+	area.size.x = gfx_get_width();
+	area.size.y = gfx_get_height();
+
+	frame = wtk_basic_frame_create(win_get_root(), &area, &background,
+			NULL, NULL, NULL);
+	if (!frame) {
+		bench_skip("win-redraw");
+		return;
+	}
+	parent = wtk_basic_frame_as_child(frame);
+
+	area.size.x = 90;
+	area.size.y = 30;
+	for (i = 0; i < 3; i++) {
+		area.pos.x = 10 + i * 100;
+		area.pos.y = 10;
+		bench_win_show(button, wtk_button_create(parent, &area,
+				"Button", (win_command_t)(uintptr_t)(i + 1)));
+	}
+
+	area.pos.x = 10;
+	area.pos.y = 50;
+	bench_win_show(check_box, wtk_check_box_create(parent, &area,
+			"Check", true, (win_command_t)4));
+	area.pos.x = 110;
+	bench_win_show(check_box, wtk_check_box_create(parent, &area,
+			"Box", false, (win_command_t)5));
+
+	group = wtk_radio_group_create();
+	if (group) {
+		area.pos.x = 10;
+		area.pos.y = 90;
+		bench_win_show(radio_button, wtk_radio_button_create(parent,
+				&area, "Radio", true, group, (win_command_t)6));
+		area.pos.x = 110;
+		bench_win_show(radio_button, wtk_radio_button_create(parent,
+				&area, "Button", false, group,
+				(win_command_t)7));
+	}
+
+	area.pos.x = 10;
+	area.pos.y = 130;
+	area.size.x = 190;
+	area.size.y = 20;
+	bench_win_show(slider, wtk_slider_create(parent, &area, 100, 50,
+			WTK_SLIDER_HORIZONTAL, (win_command_t)8));
+
+	area.pos.y = 160;
+	bench_win_show(progress_bar, wtk_progress_bar_create(parent, &area,
+			100, 75, BENCH_COLOR_B, BENCH_COLOR_A,
+			WTK_PROGRESS_BAR_HORIZONTAL));
+
+	area.pos.y = 190;
+	bench_win_show(label, wtk_label_create(parent, &area, "Label",
+			false));
+
+	win_show(parent);
+	win_show(win_get_root());
+
+	for (i = 0; i < BENCH_WIN_ITERATIONS; i++) {
+		start = bench_sync_begin();
+		win_redraw(parent);
+		bench_sync_end(&result, start, 0);
+	}
+	bench_report("win-redraw", &result);
+
+	win_destroy(parent);
+}
+
+/**
+ * \brief Bag of the reference allocator
+ *
+ * The reference allocator is membag before its size class and owner
+ * tables: an allocation tries every large enough bag from the smallest
+ * one, and a release compares the pointer with the range of every bag.
+ * It has one bag for each membag bag, with the same block size but only
+ * #BENCH_LINEAR_NR_BLOCKS blocks, as the cost only depends on the bags.
+ */
+struct bench_linear_bag {
+	//! Number of bytes per block.
+	size_t                  block_size;
+	//! Pool holding the blocks.
+	struct mem_pool         pool;
+	//! Start of the blocks.
+	void                    *start;
+	//! End of the blocks.
+	void                    *end;
+};
+
+#define MEMBAG(objsize, nr_objs, pool)                                  \
+	{ .block_size = MEMBAG_BLOCK_SIZE(objsize), }
+static struct bench_linear_bag bench_linear_bags[] = {
+	APP_MEMBAG_INITIALIZER
+};
+#undef MEMBAG
+
+static void bench_linear_init(void)
+{
+	struct bench_linear_bag *bag;
+	phys_addr_t             addr;
+	size_t                  size;
+	uint8_t                 i;
+
+	for (i = 0; i < ARRAY_LEN(bench_linear_bags); i++) {
+		bag = &bench_linear_bags[i];
+		size = BENCH_LINEAR_NR_BLOCKS
+			* round_up(bag->block_size, CPU_DMA_ALIGN);
+
+		addr = physmem_alloc(&cpu_sram_pool, size, CPU_DMA_ALIGN);
+		assert(addr != PHYSMEM_ALLOC_ERR);
+
+		bag->start = physmem_map(addr, size,
+				PHYS_MAP_WRBUF | PHYS_MAP_WRBACK);
+		bag->end = (uint8_t *)bag->start + size;
+		mem_pool_init(&bag->pool, bag->start, size, bag->block_size,
+				CPU_DMA_ALIGN);
+	}
+}
+
+static void *bench_linear_alloc(size_t size)
+{
+	void    *ptr;
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(bench_linear_bags); i++) {
+		if (bench_linear_bags[i].block_size < size)
+			continue;
+
+		ptr = mem_pool_alloc(&bench_linear_bags[i].pool);
+		if (ptr)
+			return ptr;
+	}
+
+	return NULL;
+}
+
+static void bench_linear_free(void *ptr)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(bench_linear_bags); i++) {
+		if (ptr >= bench_linear_bags[i].start
+				&& ptr <= bench_linear_bags[i].end) {
+			mem_pool_free(&bench_linear_bags[i].pool, ptr);
+			break;
+		}
+	}
+}
+
+//! Allocate from the smallest reference bag, NULL once it is exhausted.
+static void *bench_linear_alloc_smallest(void)
+{
+	return mem_pool_alloc(&bench_linear_bags[0].pool);
+}
+
+//! Allocate from the smallest membag bag, NULL once it is exhausted.
+static void *bench_membag_alloc_smallest(void)
+{
+	size_t  size = bench_linear_bags[0].block_size;
+
+	if (membag_get_smallest_free_block_size() != size)
+		return NULL;
+
+	return membag_alloc(size);
+}
+
+//! Allocator measured by the memory bag benchmarks.
+struct bench_allocator {
+	//! Names of the 16 byte, 64 byte and exhausted bag benchmarks.
+	const char      *names[3];
+	//! Allocate a block of at least \a size bytes.
+	void            *(*alloc)(size_t size);
+	//! Release the block at \a ptr.
+	void            (*free)(void *ptr);
+	//! Allocate from the smallest bag, NULL once it is exhausted.
+	void            *(*alloc_smallest)(void);
+};
+
+static void bench_membag_pairs(const struct bench_allocator *ba,
+		const char *name, size_t size)
+{
+	struct bench_result     result = { 0 };
+	void                    *p;
+	uint16_t                start;
+	uint16_t                i;
+	uint8_t                 j;
+
+	for (j = 0; j < BENCH_MEMBAG_ITERATIONS; j++) {
+		start = bench_sync_begin();
+		for (i = 0; i < BENCH_MEMBAG_BATCH; i++) {
+			p = ba->alloc(size);
+			ba->free(p);
+		}
+		bench_sync_end(&result, start, 0);
+	}
+
+	// Report pairs, not batches
+	result.iterations *= BENCH_MEMBAG_BATCH;
+	bench_report(name, &result);
+}
+
+static void bench_membag_run(const struct bench_allocator *ba)
+{
+	void    *held = NULL;
+	void    *p;
+
+	bench_membag_pairs(ba, ba->names[0], 16);
+	bench_membag_pairs(ba, ba->names[1], 64);
+
+	/*
+	 * Exhaust the smallest bag, linking the blocks through their first
+	 * word, so that its allocations have to move on to the next bag.
+	 */
+	while ((p = ba->alloc_smallest())) {
+		*(void **)p = held;
+		held = p;
+	}
+	bench_membag_pairs(ba, ba->names[2], bench_linear_bags[0].block_size);
+
+	while (held) {
+		p = held;
+		held = *(void **)p;
+		ba->free(p);
+	}
+}
+
+static void bench_membag(void)
+{
+	static const struct bench_allocator allocators[] = {
+		{
+			.names          = {
+				"membag-alloc-free-16",
+				"membag-alloc-free-64",
+				"membag-alloc-free-full",
+			},
+			.alloc          = membag_alloc,
+			.free           = membag_free,
+			.alloc_smallest = bench_membag_alloc_smallest,
+		}, {
+			.names          = {
+				"membag-linear-alloc-free-16",
+				"membag-linear-alloc-free-64",
+				"membag-linear-alloc-free-full",
+			},
+			.alloc          = bench_linear_alloc,
+			.free           = bench_linear_free,
+			.alloc_smallest = bench_linear_alloc_smallest,
+		},
+	};
+	uint8_t i;
+
+	bench_linear_init();
+
+	for (i = 0; i < ARRAY_LEN(allocators); i++)
+		bench_membag_run(&allocators[i]);
+}
+
+//! Destination of the huge memory copies, following the source.
+static inline hugemem_ptr_t bench_hugemem_dest(struct bench_context *bench)
+{
+	return (hugemem_ptr_t)((phys_addr_t)bench->hugemem_buf
+			+ BENCH_HUGEMEM_SIZE);
+}
+
+static void bench_hugemem(struct bench_context *bench)
+{
+	struct bench_result     result = { 0 };
+	uint16_t                start;
+	uint8_t                 i;
+
+	bench->hugemem_buf = hugemem_alloc(&board_extram_pool,
+			2 * BENCH_HUGEMEM_SIZE, 0);
+	if (bench->hugemem_buf == HUGEMEM_NULL) {
+		bench_skip("hugemem-copy");
+		return;
+	}
+
+	hugemem_fill(bench->hugemem_buf, 0x55, BENCH_HUGEMEM_SIZE);
+
+	for (i = 0; i < BENCH_HUGEMEM_ITERATIONS; i++) {
+		start = bench_sync_begin();
+		hugemem_copy(bench_hugemem_dest(bench), bench->hugemem_buf,
+				BENCH_HUGEMEM_SIZE);
+		bench_sync_end(&result, start, BENCH_HUGEMEM_SIZE);
+	}
+	bench_report("hugemem-copy", &result);
+}
+
+//! \see stream_ops::commit
+static void bench_null_stream_commit(struct stream *stream)
+{
+	while (stream_buf_has_data(stream))
+		stream_buf_extract_char(stream);
+}
+
+//! \see stream_ops::make_room
+static bool bench_null_stream_make_room(struct stream *stream,
+		unsigned int goal)
+{
+	bench_null_stream_commit(stream);
+	return true;
+}
+
+static const struct stream_ops bench_null_stream_ops = {
+	.commit         = bench_null_stream_commit,
+	.make_room      = bench_null_stream_make_room,
+};
+
+static void bench_printf(void)
+{
+	struct bench_result     result = { 0 };
+	char                    data[16];
+	struct stream           null_stream = {
+		.ops            = &bench_null_stream_ops,
+		.ring_mask      = sizeof(data) - 1,
+		.data           = data,
+	};
+	uint16_t                start;
+	uint8_t                 i;
+
+	for (i = 0; i < BENCH_PRINTF_ITERATIONS; i++) {
+		start = bench_sync_begin();
+		stream_printf(&null_stream, "bench %s %u %lu %x\n", "printf",
+				i, 1234567UL, 0xbeef);
+		bench_sync_end(&result, start, 0);
+	}
+	bench_report("stream-printf", &result);
+}
+
+static void bench_block_buf_list_done(struct block_device *bdev,
+		struct block_request *breq, struct slist *buf_list)
+{
+	/* Intentionally empty. */
+}
+
+static void bench_block_done(struct block_device *bdev,
+		struct block_request *breq)
+{
+	struct bench_context    *bench = breq->context;
+	struct bench_result     *result = &bench->result;
+
+	if (bench->operation == BLK_OP_WRITE)
+		result = &bench->write_result;
+	bench_end(result, bench->start, blkdev_get_block_size(bdev));
+
+	if (breq->status != STATUS_OK)
+		dbg_error("bench: block request failed: %d\n", breq->status);
+
+	block_free_request(bdev, breq);
+	workqueue_add_task(&main_workqueue, &bench->task);
+}
+
+static void bench_block_submit(struct bench_context *bench,
+		block_addr_t lba, enum block_operation operation)
+{
+	struct block_device     *bdev = bench->bdev;
+	struct block_request    *breq;
+
+	breq = block_alloc_request(bdev);
+	assert(breq);
+
+	bench->operation = operation;
+	bench->start = bench_begin();
+
+	block_prepare_req(bdev, breq, lba, 1, operation);
+	breq->req_done = bench_block_done;
+	breq->buf_list_done = bench_block_buf_list_done;
+	breq->context = bench;
+
+	if (operation == BLK_OP_READ)
+		buffer_init_rx(&bench->buf, bench->data,
+				blkdev_get_block_size(bdev));
+	else
+		buffer_init_tx(&bench->buf, bench->data,
+				blkdev_get_block_size(bdev));
+	blk_req_add_buffer(breq, &bench->buf);
+
+	block_submit_req(bdev, breq);
+}
+
+/**
+ * \brief Read a chunk of the file under test
+ *
+ * \retval true if the read was started
+ * \retval false at the end of the file
+ */
+static bool bench_tsfs_read(struct bench_context *bench)
+{
+	bench->timing = true;
+	bench->start = bench_begin();
+
+	return tsfs_read(&bench->fs, &bench->file, bench->data,
+			BENCH_TSFS_CHUNK, &bench->task) == STATUS_OK;
+}
+
+//! Open the first file in the file system.
+static bool bench_tsfs_open(struct bench_context *bench)
+{
+	uint8_t         name[TSFS_FILENAME_LEN + 1];
+
+	if (!tsfs_is_ready(&bench->fs) || !tsfs_nr_files(&bench->fs))
+		return false;
+
+	tsfs_get_filename(&bench->fs, 0, name);
+	name[TSFS_FILENAME_LEN] = '\0';
+
+	return tsfs_open(&bench->fs, (const char *)name,
+			&bench->file) == STATUS_OK;
+}
+
+//! Seek to a pseudo-random position in the file and read a chunk.
+static bool bench_tsfs_read_random(struct bench_context *bench)
+{
+	uint32_t        size = tsfs_get_file_size(&bench->file);
+
+	if (size <= BENCH_TSFS_CHUNK)
+		return false;
+
+	bench->seed = bench->seed * 25173U + 13849U;
+	tsfs_seek(&bench->file, ((uint32_t)bench->seed << 8)
+			% (size - BENCH_TSFS_CHUNK), SEEK_SET);
+
+	return bench_tsfs_read(bench);
+}
+
+/**
+ * \brief Advance to the next asynchronous benchmark
+ *
+ * Print the result of the current one, and start the next one by
+ * running the worker again.
+ */
+static void bench_next(struct bench_context *bench, const char *name)
+{
+	if (name)
+		bench_report(name, &bench->result);
+
+	bench->state++;
+	workqueue_add_task(&main_workqueue, &bench->task);
+}
+
+#ifdef CONFIG_DELAYED_TASK
+//! Count a task of the delayed task batch, finishing after the last one.
+static void bench_delayed_worker(struct workqueue_task *task)
+{
+	struct bench_context    *bench = &bench_ctx;
+	struct delayed_task_stats stats;
+
+	if (++bench->result.iterations < BENCH_DELAYED_TASKS)
+		return;
+
+	bench->result.ticks = (uint16_t)(bench_get_time() - bench->start);
+	bench_report("delayed-batch", &bench->result);
+
+	delayed_task_get_stats(&stats);
+	dbg_info("delayed %u %u %u\n", stats.nr_alarms, stats.nr_alarm_tasks,
+			stats.nr_polled_tasks);
+	bench_next(bench, NULL);
+}
+
+/**
+ * \brief Schedule the delayed task batch
+ *
+ * Task \a i may run between \a i and #BENCH_DELAYED_TASKS steps from now,
+ * so all of them can be run when the alarm of the first one triggers.
+ */
+static void bench_delayed_batch(struct bench_context *bench)
+{
+	uint8_t         i;
+
+	delayed_task_reset_stats();
+	bench->start = bench_begin();
+
+	for (i = 0; i < BENCH_DELAYED_TASKS; i++) {
+		workqueue_task_init(&bench->batch_task[i],
+				bench_delayed_worker);
+		delayed_task_init(&bench->batch_dtask[i],
+				&bench->batch_task[i]);
+		delayed_task_add(&bench->batch_dtask[i],
+				DELAYED_TASK_MS((i + 1) * BENCH_DELAYED_STEP_MS),
+				DELAYED_TASK_MS((BENCH_DELAYED_TASKS - i)
+					* BENCH_DELAYED_STEP_MS));
+	}
+}
+#endif /* CONFIG_DELAYED_TASK */
+
+static void bench_worker(struct workqueue_task *task)
+{
+	struct bench_context    *bench;
+	struct block_device     *bdev;
+	uint16_t                iterations;
+
+	bench = container_of(task, struct bench_context, task);
+	bdev = bench->bdev;
+	iterations = bench->result.iterations;
+
+	switch (bench->state) {
+	case BENCH_WORKQUEUE:
+		if (bench->timing)
+			bench_end(&bench->result, bench->start, 0);
+
+		if (bench->result.iterations < BENCH_WQ_ITERATIONS) {
+			bench->timing = true;
+			bench->start = bench_begin();
+			workqueue_add_task(&main_workqueue, task);
+		} else {
+			bench->timing = false;
+			bench_next(bench, "workqueue-latency");
+		}
+		break;
+
+	case BENCH_HUGEMEM_ASYNC:
+#ifdef CONFIG_HUGEMEM_ASYNC
+		if (bench->hugemem_buf == HUGEMEM_NULL) {
+			bench_skip("hugemem-copy-async");
+			bench_next(bench, NULL);
+			break;
+		}
+
+		if (bench->timing)
+			bench_end(&bench->result, bench->start,
+					BENCH_HUGEMEM_SIZE);
+
+		if (bench->result.iterations < BENCH_HUGEMEM_ITERATIONS) {
+			bench->timing = true;
+			bench->start = bench_begin();
+			hugemem_copy_async(&bench->hugemem_req,
+					bench_hugemem_dest(bench),
+					bench->hugemem_buf,
+					BENCH_HUGEMEM_SIZE, task);
+		} else {
+			bench->timing = false;
+			bench_next(bench, "hugemem-copy-async");
+		}
+#else
+		bench_skip("hugemem-copy-async");
+		bench_next(bench, NULL);
+#endif
+		break;
+
+	case BENCH_BLOCK_READ:
+		if (!bdev || !test_bit(BDEV_PRESENT, &bdev->flags)
+				|| bdev->nr_blocks < BENCH_BLOCK_ITERATIONS
+				|| blkdev_get_block_size(bdev)
+					> BENCH_BLOCK_SIZE) {
+			bench_skip("blkdev-read");
+			bench_skip("blkdev-write");
+			bench->state = BENCH_TSFS_INIT;
+			workqueue_add_task(&main_workqueue, task);
+			break;
+		}
+
+		/*
+		 * Read a block, then write the same data back, so that the
+		 * device contents are left untouched.
+		 */
+		if (iterations < BENCH_BLOCK_ITERATIONS) {
+			if (test_bit(BDEV_WRITEABLE, &bdev->flags))
+				bench->state = BENCH_BLOCK_WRITE;
+			bench_block_submit(bench, iterations, BLK_OP_READ);
+		} else {
+			bench_report("blkdev-read", &bench->result);
+			if (test_bit(BDEV_WRITEABLE, &bdev->flags))
+				bench_report("blkdev-write",
+						&bench->write_result);
+			else
+				bench_skip("blkdev-write");
+			bench->state = BENCH_TSFS_INIT;
+			workqueue_add_task(&main_workqueue, task);
+		}
+		break;
+
+	case BENCH_BLOCK_WRITE:
+		bench->state = BENCH_BLOCK_READ;
+		bench_block_submit(bench, iterations - 1, BLK_OP_WRITE);
+		break;
+
+	case BENCH_TSFS_INIT:
+		if (!bdev || !test_bit(BDEV_PRESENT, &bdev->flags)) {
+			bench_skip("tsfs-read-sequential");
+			bench_skip("tsfs-read-random");
+			bench->state = BENCH_DELAYED_BATCH;
+			workqueue_add_task(&main_workqueue, task);
+			break;
+		}
+
+		bench->state = BENCH_TSFS_SEQUENTIAL;
+		tsfs_init(&bench->fs, bdev, task);
+		break;
+
+	case BENCH_TSFS_SEQUENTIAL:
+		if (!bench->timing) {
+			// First run after tsfs_init() completed.
+			if (!bench_tsfs_open(bench)) {
+				bench_skip("tsfs-read-sequential");
+				bench_skip("tsfs-read-random");
+				bench->state = BENCH_DELAYED_BATCH;
+				workqueue_add_task(&main_workqueue, task);
+				break;
+			}
+		} else {
+			bench_end(&bench->result, bench->start,
+					BENCH_TSFS_CHUNK);
+		}
+
+		if (bench->result.iterations >= BENCH_TSFS_ITERATIONS
+				|| !bench_tsfs_read(bench)) {
+			bench_report("tsfs-read-sequential", &bench->result);
+			if (!bench_tsfs_read_random(bench)) {
+				bench_skip("tsfs-read-random");
+				bench->state = BENCH_DELAYED_BATCH;
+				workqueue_add_task(&main_workqueue, task);
+				break;
+			}
+			bench->state = BENCH_TSFS_RANDOM;
+		}
+		break;
+
+	case BENCH_TSFS_RANDOM:
+		bench_end(&bench->result, bench->start, BENCH_TSFS_CHUNK);
+
+		if (bench->result.iterations >= BENCH_TSFS_ITERATIONS
+				|| !bench_tsfs_read_random(bench))
+			bench_next(bench, "tsfs-read-random");
+		break;
+
+	case BENCH_DELAYED_BATCH:
+#ifdef CONFIG_DELAYED_TASK
+		bench_delayed_batch(bench);
+#else
+		bench_skip("delayed-batch");
+		bench_next(bench, NULL);
+#endif
+		break;
+
+	case BENCH_DONE:
+#ifdef CONFIG_PROFILE
+		profile_stop();
+		profile_dump();
+#endif
+#ifdef CONFIG_LATENCY
+		latency_show_top();
+		latency_dump();
+#endif
+#ifdef CONFIG_SLEEPMGR_STATS
+		sleepmgr_stats_show();
+#endif
+		dbg_info("bench done\n");
+		break;
+	}
+}
+
+int main(void)
+{
+	struct bench_context    *bench = &bench_ctx;
+	timer_res_t             timer_res;
+
+	cpu_irq_enable();
+	sysclk_init();
+	dbg_init();
+	board_init();
+	workqueue_init(&main_workqueue);
+	gfx_init();
+	membag_init(CPU_DMA_ALIGN);
+	win_init();
+
+	timer_init(CONFIG_TIMER_ID, &bench_timer, NULL);
+	timer_res = timer_set_resolution(CONFIG_TIMER_ID, &bench_timer,
+			CONFIG_TIMER_RESOLUTION);
+	timer_write_resolution(CONFIG_TIMER_ID, &bench_timer, timer_res);
+	bench_timer_hz = timer_get_resolution(CONFIG_TIMER_ID, &bench_timer,
+			timer_res);
+	timer_start(CONFIG_TIMER_ID, &bench_timer);
+#ifdef CONFIG_LATENCY
+	latency_init(&bench_timer, bench_timer_hz);
+#endif
+#ifdef CONFIG_SLEEPMGR_STATS
+	sleepmgr_stats_init(&bench_timer, bench_timer_hz);
+#endif
+#ifdef CONFIG_DELAYED_TASK
+	delayed_task_setup();
+#endif
+
+#ifdef CONFIG_PROFILE
+	profile_init();
+	profile_start(BENCH_PROFILE_RATE);
+#endif
+
+	dbg_info("bench start\n");
+
+	bench_gfx();
+	bench_win();
+	bench_membag();
+	bench_hugemem(bench);
+	bench_printf();
+
+	workqueue_task_init(&bench->task, bench_worker);
+	bench->state = BENCH_WORKQUEUE;
+	bench->seed = 1;
+
+#ifdef CONFIG_BLOCK_DATAFLASH
+	{
+		struct spi_master       *master;
+		struct spi_device       *device;
+
+		master = spi_master_get_base(CONFIG_APP_DATAFLASH_SPI_ID,
+				&bench_master);
+		device = spi_device_get_base(CONFIG_APP_DATAFLASH_SPI_ID,
+				&bench_device);
+
+		spi_enable(CONFIG_APP_DATAFLASH_SPI_ID);
+		spi_master_init(CONFIG_APP_DATAFLASH_SPI_ID, master);
+		spi_master_setup_device(CONFIG_APP_DATAFLASH_SPI_ID, master,
+				device, SPI_MODE_0, CONFIG_CPU_HZ,
+				BOARD_DATAFLASH_SS);
+
+		bench->bdev = dataflash_blkdev_init(CONFIG_APP_DATAFLASH_SPI_ID,
+				master, device, &bench->task);
+	}
+#elif defined(CONFIG_BLOCK_HOST_FILE)
+	bench->bdev = host_file_blkdev_init(NULL, &bench->task);
+#else
+	workqueue_add_task(&main_workqueue, &bench->task);
+#endif
+
+	mainloop_run(&main_workqueue);
+}
@@ -89,8 +89,8 @@
 
 //! Max value to display
 #define MAX_VALUE    999999
-//! Max digits needed to store display value and terminating null byte
-#define MAX_DIGITS   (10+1)
+//! Max digits needed to store display value, sign and terminating null byte
+#define MAX_DIGITS   (10+1+1)
 
 //! @}
 
@@ -160,10 +160,12 @@ static void calc_update_display(struct calc_context *calc)
 	// Generate string according to the selected number base.
 	switch (calc->mode) {
 	case CALC_HEX:
-		snprintf(calc->text, MAX_DIGITS, "0x%lx", calc->disp_value);
+		snprintf(calc->text, MAX_DIGITS, "0x%lx",
+				(unsigned long)(uint32_t)calc->disp_value);
 		break;
 	default:
-		snprintf(calc->text, MAX_DIGITS, "%ld", calc->disp_value);
+		snprintf(calc->text, MAX_DIGITS, "%ld",
+				(long)calc->disp_value);
 		break;
 	}
 
@@ -127,6 +127,10 @@
 //! Position for text describing each icon
 #define DESKTOP_ICON_TEXT_Y             ((DESKTOP_ICON_POS_Y + \
 			DESKTOP_ICON_SIZE_Y + DESKTOP_ICON_SPACING_Y) / 2)
+//! Corner radius of the outlines around icons and of the pop-up
+#define DESKTOP_CORNER_RADIUS           8
+//! Thickness of the cross drawn instead of an icon which can't be loaded
+#define DESKTOP_CROSS_THICKNESS         3
 
 //! @}
 
@@ -314,12 +318,13 @@ static void draw_icon_text(const char text[], gfx_coord_t center_x,
  */
 static void app_desktop_popup_empty_tsfs(void)
 {
-	gfx_draw_filled_rect(DESKTOP_POPUP_POS_X, DESKTOP_POPUP_POS_Y,
-			DESKTOP_POPUP_WIDTH, DESKTOP_POPUP_HEIGHT,
+	gfx_draw_filled_rounded_rect(DESKTOP_POPUP_POS_X,
+			DESKTOP_POPUP_POS_Y, DESKTOP_POPUP_WIDTH,
+			DESKTOP_POPUP_HEIGHT, DESKTOP_CORNER_RADIUS,
 			DESKTOP_BACKGROUND_COLOR);
-	gfx_draw_rect(DESKTOP_POPUP_POS_X, DESKTOP_POPUP_POS_Y,
+	gfx_draw_rounded_rect(DESKTOP_POPUP_POS_X, DESKTOP_POPUP_POS_Y,
 			DESKTOP_POPUP_WIDTH, DESKTOP_POPUP_HEIGHT,
-			DESKTOP_POPUP_BORDER_COLOR);
+			DESKTOP_CORNER_RADIUS, DESKTOP_POPUP_BORDER_COLOR);
 	gfx_draw_string("Warning: file system empty, please program\n\n"
 			"the DataFlash to contain a proper TSFS image.",
 			DESKTOP_POPUP_POS_X + gfx_font_get_height(&sysfont),
@@ -370,9 +375,10 @@ static bool app_desktop_handler(struct win_window *win,
 
 			last_x = x * DESKTOP_ICON_SPACING_X;
 			last_y = y * DESKTOP_ICON_SPACING_Y;
-			gfx_draw_rect(last_x, last_y,
+			gfx_draw_rounded_rect(last_x, last_y,
 					DESKTOP_ICON_SPACING_X,
 					DESKTOP_ICON_SPACING_Y,
+					DESKTOP_CORNER_RADIUS,
 					DESKTOP_ICON_TEXT_COLOR);
 			break;
 
@@ -380,9 +386,10 @@ static bool app_desktop_handler(struct win_window *win,
 			/* Remove the white outline, then launch the application
 			 * if an application launch worker function is set.
 			 */
-			gfx_draw_rect(last_x, last_y,
+			gfx_draw_rounded_rect(last_x, last_y,
 					DESKTOP_ICON_SPACING_X,
 					DESKTOP_ICON_SPACING_Y,
+					DESKTOP_CORNER_RADIUS,
 					DESKTOP_BACKGROUND_COLOR);
 
 			i = x + y * DESKTOP_NUM_APPS_PER_COLUMN;
@@ -485,14 +492,25 @@ static void load_desktop(struct workqueue_task *task)
 
 		if (result != STATUS_OK) {
 			// Unable to load icon, draw a cross instead
-			gfx_draw_rect(x, y, DESKTOP_ICON_SIZE_X,
+			gfx_draw_rounded_rect(x, y, DESKTOP_ICON_SIZE_X,
 					DESKTOP_ICON_SIZE_Y,
+					DESKTOP_CORNER_RADIUS,
 					DESKTOP_ICON_TEXT_COLOR);
-			gfx_draw_line(x, y, x + DESKTOP_ICON_SIZE_X - 1,
-					y + DESKTOP_ICON_SIZE_Y - 1,
+			gfx_draw_thick_line(x + DESKTOP_CORNER_RADIUS,
+					y + DESKTOP_CORNER_RADIUS,
+					x + DESKTOP_ICON_SIZE_X - 1
+					- DESKTOP_CORNER_RADIUS,
+					y + DESKTOP_ICON_SIZE_Y - 1
+					- DESKTOP_CORNER_RADIUS,
+					DESKTOP_CROSS_THICKNESS,
 					DESKTOP_ICON_TEXT_COLOR);
-			gfx_draw_line(x, y + DESKTOP_ICON_SIZE_Y - 1,
-					x + DESKTOP_ICON_SIZE_X - 1, y,
+			gfx_draw_thick_line(x + DESKTOP_CORNER_RADIUS,
+					y + DESKTOP_ICON_SIZE_Y - 1
+					- DESKTOP_CORNER_RADIUS,
+					x + DESKTOP_ICON_SIZE_X - 1
+					- DESKTOP_CORNER_RADIUS,
+					y + DESKTOP_CORNER_RADIUS,
+					DESKTOP_CROSS_THICKNESS,
 					DESKTOP_ICON_TEXT_COLOR);
 			// Reschedule for drawing next icon
 			workqueue_add_task(&main_workqueue, task);
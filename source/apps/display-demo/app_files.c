@@ -43,6 +43,9 @@
 #include <gfx/win.h>
 #include <gfx/wtk.h>
 #include <gfx/sysfont.h>
+#ifdef CONFIG_GFX_GLYPH_CACHE
+# include <gfx/glyph_cache.h>
+#endif
 
 #include <fs/tsfs.h>
 
@@ -72,8 +75,10 @@ enum app_files_page_numbers {
 	PAGE_NUM_INTRO_SCREEN = PAGE_NUM_FIRST,
 	//! Info screen page number.
 	PAGE_NUM_INFO_SCREEN,
+	//! Thumbnail grid page number.
+	PAGE_NUM_THUMB_SCREEN,
 	//! Last info page, not counting file info pages.
-	PAGE_NUM_LAST = PAGE_NUM_INFO_SCREEN,
+	PAGE_NUM_LAST = PAGE_NUM_THUMB_SCREEN,
 };
 
 //! \name Color scheme
@@ -100,6 +105,28 @@ enum app_files_page_numbers {
 #define TEXT_PADDING_NEWLINE    2
 //@}
 
+//! \name Thumbnail grid
+//@{
+//! Width of the images shown in the thumbnail grid.
+#define THUMB_IMAGE_SIZE_X      320
+//! Height of the images shown in the thumbnail grid.
+#define THUMB_IMAGE_SIZE_Y      240
+//! Width of a thumbnail.
+#define THUMB_SIZE_X            (THUMB_IMAGE_SIZE_X / FILE_THUMB_SCALE)
+//! Height of a thumbnail.
+#define THUMB_SIZE_Y            (THUMB_IMAGE_SIZE_Y / FILE_THUMB_SCALE)
+//! Number of thumbnail columns.
+#define THUMB_COLUMNS           3
+//! Number of thumbnail rows.
+#define THUMB_ROWS              3
+//! Number of thumbnails on the page.
+#define THUMBS_PER_PAGE         (THUMB_COLUMNS * THUMB_ROWS)
+//! Width of the grid cell for each thumbnail and its file name.
+#define THUMB_CELL_SIZE_X       106
+//! Height of the grid cell for each thumbnail and its file name.
+#define THUMB_CELL_SIZE_Y       56
+//@}
+
 /**
  * \brief Event command ID for the application widgets.
  */
@@ -124,6 +151,12 @@ struct app_files {
 	struct font             old_sysfont;
 	//! Current page number to be drawn on the screen.
 	uint_fast8_t            page_number;
+	//! Flag indicating that a thumbnail is being loaded.
+	bool                    thumb_loading;
+	//! Grid cell of the thumbnail being loaded.
+	uint8_t                 thumb_cell;
+	//! File index of the thumbnail being loaded.
+	uint8_t                 thumb_file;
 };
 
 //! TSFS control struct, needed for file listing.
@@ -132,6 +165,14 @@ extern struct tsfs              myfs;
 //! The files application context pointer.
 static struct app_files         *the_app_files;
 
+/**
+ * \brief Work queue task for loading thumbnails.
+ *
+ * This task is not part of the application context, since a thumbnail may
+ * still be loading when the application exits.
+ */
+static struct workqueue_task    app_files_thumb_task;
+
 //! Fixed point russian font object.
 static struct font              font_fixedrus = {
 	.type   = FONT_LOC_HUGEMEM,
@@ -161,19 +202,23 @@ static void string_file_size(char *file_size_str, uint32_t size,
 
 	switch (order) {
 	case 0:
-		snprintf(file_size_str, str_size, "%li B", size);
+		snprintf(file_size_str, str_size, "%lu B",
+				(unsigned long)size);
 		break;
 
 	case 1:
-		snprintf(file_size_str, str_size, "%li kB", size);
+		snprintf(file_size_str, str_size, "%lu kB",
+				(unsigned long)size);
 		break;
 
 	case 2:
-		snprintf(file_size_str, str_size, "%li MB", size);
+		snprintf(file_size_str, str_size, "%lu MB",
+				(unsigned long)size);
 		break;
 
 	case 3:
-		snprintf(file_size_str, str_size, "%li GB", size);
+		snprintf(file_size_str, str_size, "%lu GB",
+				(unsigned long)size);
 		break;
 
 	default:
@@ -239,8 +284,8 @@ static void screen_draw_introduction(void)
  */
 static void screen_draw_file_system_info(void)
 {
-	char            string[30];
-	char            file_size_str[10];
+	char            string[34];
+	char            file_size_str[16];
 	gfx_coord_t     x = TEXT_INDENT;
 	gfx_coord_t     y = TEXT_HEADER_HEIGHT;
 
@@ -294,6 +339,173 @@ static void screen_draw_file_system_info(void)
 			GFX_COLOR_TRANSPARENT);
 }
 
+/**
+ * \brief Find the image files to show in the thumbnail grid.
+ *
+ * \param file_indexes Array to store the file indexes in, with room for
+ * \ref THUMBS_PER_PAGE entries
+ *
+ * \return Number of image files with thumbnails found
+ */
+static uint8_t app_files_find_thumbnails(uint8_t *file_indexes)
+{
+	uint_fast8_t    file_index;
+	uint8_t         nr_thumbs = 0;
+
+	for (file_index = 0; file_index < myfs.header.nr_files; file_index++) {
+		if (!file_loader_has_thumbnail(file_index, THUMB_IMAGE_SIZE_X,
+					THUMB_IMAGE_SIZE_Y))
+			continue;
+
+		file_indexes[nr_thumbs++] = file_index;
+		if (nr_thumbs == THUMBS_PER_PAGE)
+			break;
+	}
+
+	return nr_thumbs;
+}
+
+/**
+ * \brief Draw a thumbnail and its file name in the grid.
+ *
+ * Thumbnails which are not in the cache yet are drawn as an outline.
+ *
+ * \param cell Grid cell to draw in
+ * \param file_index Index of the image file in the TSFS
+ */
+static void app_files_draw_thumbnail(uint8_t cell, uint8_t file_index)
+{
+	uint8_t         file_name[TSFS_FILENAME_LEN + 1];
+	hugemem_ptr_t   data;
+	gfx_coord_t     cell_x;
+	gfx_coord_t     x;
+	gfx_coord_t     y;
+
+	cell_x = (cell % THUMB_COLUMNS) * THUMB_CELL_SIZE_X;
+	x = cell_x + (THUMB_CELL_SIZE_X - THUMB_SIZE_X) / 2;
+	y = TEXT_HEADER_HEIGHT + (cell / THUMB_COLUMNS) * THUMB_CELL_SIZE_Y;
+
+	data = file_loader_get_thumbnail(file_index);
+	if (data != HUGEMEM_NULL) {
+		struct gfx_bitmap thumb;
+
+		thumb.width = THUMB_SIZE_X;
+		thumb.height = THUMB_SIZE_Y;
+		thumb.type = BITMAP_HUGEMEM;
+		thumb.data.hugemem = data;
+		gfx_draw_bitmap(&thumb, x, y);
+	} else {
+		gfx_draw_rect(x, y, THUMB_SIZE_X, THUMB_SIZE_Y, COLOR_LINE);
+	}
+
+	memset(file_name, 0, sizeof(file_name));
+	tsfs_get_filename(&myfs, file_index, file_name);
+	gfx_draw_string((char *)file_name,
+			cell_x + TEXT_PADDING,
+			y + THUMB_SIZE_Y + TEXT_PADDING_NEWLINE,
+			&font_fixedrus, COLOR_TEXT_SHADED,
+			GFX_COLOR_TRANSPARENT);
+}
+
+/**
+ * \brief Start loading the first thumbnail in the grid which is not cached.
+ *
+ * Only one thumbnail is loaded at a time. When it is loaded, it is drawn by
+ * app_files_thumb_worker(), which then loads the next one.
+ */
+static void app_files_load_next_thumbnail(void)
+{
+	uint8_t         file_indexes[THUMBS_PER_PAGE];
+	uint8_t         nr_thumbs;
+	uint8_t         cell;
+
+	if (the_app_files->thumb_loading)
+		return;
+
+	nr_thumbs = app_files_find_thumbnails(file_indexes);
+	for (cell = 0; cell < nr_thumbs; cell++) {
+		if (file_loader_get_thumbnail(file_indexes[cell])
+				!= HUGEMEM_NULL)
+			continue;
+
+		if (load_thumbnail_to_cache(file_indexes[cell],
+					THUMB_IMAGE_SIZE_X, THUMB_IMAGE_SIZE_Y,
+					&app_files_thumb_task) == STATUS_OK) {
+			the_app_files->thumb_loading = true;
+			the_app_files->thumb_cell = cell;
+			the_app_files->thumb_file = file_indexes[cell];
+		}
+		return;
+	}
+}
+
+/**
+ * \brief Draw thumbnail grid page.
+ *
+ * This function draws the thumbnails of the first images in the file system
+ * which have one, from the thumbnail cache of the \ref
+ * appsutil_fileloader_group "file loader". Thumbnails which are not cached
+ * are loaded one by one, and drawn as they arrive.
+ */
+static void screen_draw_thumbnails(void)
+{
+	uint8_t         file_indexes[THUMBS_PER_PAGE];
+	uint8_t         nr_thumbs;
+	uint8_t         cell;
+
+	/* Draw a page header and a horizontal line. */
+	gfx_draw_horizontal_line(TEXT_PADDING,
+			gfx_font_get_height(&font_fixedrus) + TEXT_INDENT,
+			gfx_get_width() - (2 * TEXT_PADDING), COLOR_LINE);
+	gfx_draw_string("Pictures in TSFS", TEXT_INDENT, TEXT_INDENT,
+			&font_fixedrus, COLOR_TEXT, GFX_COLOR_TRANSPARENT);
+
+	/* Draw the page contents. */
+	nr_thumbs = app_files_find_thumbnails(file_indexes);
+	if (!nr_thumbs) {
+		gfx_draw_string("No pictures with thumbnails.", TEXT_INDENT,
+				TEXT_HEADER_HEIGHT, &font_fixedrus, COLOR_TEXT,
+				GFX_COLOR_TRANSPARENT);
+		return;
+	}
+
+	for (cell = 0; cell < nr_thumbs; cell++)
+		app_files_draw_thumbnail(cell, file_indexes[cell]);
+
+	app_files_load_next_thumbnail();
+}
+
+/**
+ * \brief Thumbnail loaded worker.
+ *
+ * This worker is run by the \ref appsutil_fileloader_group "file loader"
+ * when a thumbnail has been loaded into the cache. It draws the thumbnail if
+ * the grid is still shown, and starts loading the next one.
+ *
+ * \param task Pointer to work queue task
+ */
+static void app_files_thumb_worker(struct workqueue_task *task)
+{
+	// The application may have exited while the thumbnail was loading.
+	if (!the_app_files)
+		return;
+
+	the_app_files->thumb_loading = false;
+
+	if (the_app_files->page_number != PAGE_NUM_THUMB_SCREEN)
+		return;
+
+	// Do not retry thumbnails which failed to load.
+	if (file_loader_get_thumbnail(the_app_files->thumb_file)
+			== HUGEMEM_NULL)
+		return;
+
+	gfx_set_clipping(0, 0, gfx_get_width(), gfx_get_height());
+	app_files_draw_thumbnail(the_app_files->thumb_cell,
+			the_app_files->thumb_file);
+	app_files_load_next_thumbnail();
+}
+
 /**
  * \brief Draw a list of files from file entry \a index.
  *
@@ -305,7 +517,7 @@ static void screen_draw_file_system_info(void)
 static void screen_draw_file_list_from_index(uint_fast8_t index)
 {
 	char            string[30];
-	char            file_size_str[10];
+	char            file_size_str[16];
 	uint8_t         file_name[TSFS_FILENAME_LEN + 1];
 	uint8_t         x = TEXT_INDENT;
 	uint8_t         y = TEXT_HEADER_HEIGHT;
@@ -370,6 +582,8 @@ static void app_files_frame_draw_handler(struct win_window *win,
 	}
 	else if (page_number == PAGE_NUM_INFO_SCREEN) {
 		screen_draw_file_system_info();
+	} else if (page_number == PAGE_NUM_THUMB_SCREEN) {
+		screen_draw_thumbnails();
 	} else {
 		uint_fast8_t file_offset;
 		file_offset = (page_number - (PAGE_NUM_LAST + 1)) *
@@ -418,6 +632,7 @@ static bool app_files_frame_command_handler(struct wtk_basic_frame *frame,
 	case BUTTON_QUIT_ID:
 		memcpy(&sysfont, &the_app_files->old_sysfont, sizeof(struct font));
 		membag_free(the_app_files);
+		the_app_files = NULL;
 		app_desktop_restart();
 		return true;
 
@@ -444,6 +659,11 @@ static void app_files_load_worker(struct workqueue_task *task)
 
 	hugemem_read_block(buffer, font->data.hugemem, FONT_HEADER_SIZE);
 
+#ifdef CONFIG_GFX_GLYPH_CACHE
+	// Drop any glyphs cached for the font before replacing it.
+	gfx_glyph_cache_invalidate_font(font);
+#endif
+
 	assert(buffer[0] == 'F' && buffer[1] == 'T');
 
 	font->width        = buffer[2];
@@ -451,7 +671,7 @@ static void app_files_load_worker(struct workqueue_task *task)
 	font->first_char   = buffer[4];
 	font->last_char    = buffer[5];
 	font->data.hugemem = (hugemem_ptr_t)
-		((uint32_t)font->data.hugemem + FONT_HEADER_SIZE);
+		((phys_addr_t)font->data.hugemem + FONT_HEADER_SIZE);
 
 	the_app_files->page_number = PAGE_NUM_INTRO_SCREEN;
 	win_show(wtk_basic_frame_as_child(the_app_files->frame));
@@ -474,6 +694,9 @@ void app_files_launch(struct workqueue_task *task)
 		goto error_membag_alloc;
 
 	the_app_files->page_number = PAGE_NUM_BLANK;
+	the_app_files->thumb_loading = false;
+	workqueue_task_set_work_func(&app_files_thumb_task,
+			app_files_thumb_worker);
 
 	/* Store previous system font and scale it to double size. */
 	memcpy(&the_app_files->old_sysfont, &sysfont, sizeof(struct font));
@@ -567,6 +790,7 @@ error_widget:
 error_text_frame:
 	memcpy(&sysfont, &the_app_files->old_sysfont, sizeof(struct font));
 	membag_free(the_app_files);
+	the_app_files = NULL;
 error_membag_alloc:
 	app_desktop_restart();
 }
@@ -45,6 +45,9 @@
 #include <gfx/win.h>
 #include <gfx/wtk.h>
 #include <gfx/sysfont.h>
+#ifdef CONFIG_GFX_GLYPH_CACHE
+# include <gfx/glyph_cache.h>
+#endif
 
 #include "app_fonts.h"
 #include "app_desktop.h"
@@ -497,6 +500,11 @@ static void app_fonts_load_worker(struct workqueue_task *task)
 		hugemem_read_block(buffer, font->data.hugemem,
 				FONT_HEADER_SIZE);
 
+#ifdef CONFIG_GFX_GLYPH_CACHE
+		// Drop any glyphs cached for the font before replacing it.
+		gfx_glyph_cache_invalidate_font(font);
+#endif
+
 		assert(buffer[0] == 'F' && buffer[1] == 'T');
 
 		font->width        = buffer[2];
@@ -504,7 +512,7 @@ static void app_fonts_load_worker(struct workqueue_task *task)
 		font->first_char   = buffer[4];
 		font->last_char    = buffer[5];
 		font->data.hugemem = (hugemem_ptr_t)
-			((uint32_t)font->data.hugemem + FONT_HEADER_SIZE);
+			((phys_addr_t)font->data.hugemem + FONT_HEADER_SIZE);
 	}
 
 	retval = app_fonts_load();
@@ -40,6 +40,9 @@
 #include <gfx/win.h>
 #include <gfx/wtk.h>
 #include <gfx/sysfont.h>
+#ifdef CONFIG_GFX_FRAME
+#include <gfx/frame.h>
+#endif
 #include <stream.h>
 #include <string.h>
 #include <timer.h>
@@ -782,7 +785,11 @@ static void memgame_timer_callback(struct timer *timer)
 				game_ctx->timer_delay);
 	} else {
 		timer_stop(CONFIG_TIMER_ID, &game_ctx->timer);
+#ifdef CONFIG_GFX_FRAME
+		gfx_frame_add_task(game_ctx->task);
+#else
 		workqueue_add_task(&main_workqueue, game_ctx->task);
+#endif
 	}
 }
 
@@ -46,6 +46,9 @@
 #include <fs/tsfs.h>
 #include <gfx/gfx.h>
 #include <gfx/win.h>
+#ifdef CONFIG_GFX_FRAME
+#include <gfx/frame.h>
+#endif
 
 #include "app_desktop.h"
 #include "app_slideshow.h"
@@ -242,6 +245,25 @@ static void slide_show_file(void)
 	}
 }
 
+#ifdef CONFIG_GFX_FRAME
+static void slide_worker(struct workqueue_task *task);
+
+/**
+ * \brief Frame task worker for automatic loading.
+ *
+ * Starts loading of the next slide at the start of a display refresh, as
+ * scheduled by the timer callback.
+ *
+ * \param task Workqueue task for this worker function.
+ */
+static void slide_frame_worker(struct workqueue_task *task)
+{
+	workqueue_task_set_work_func(task, slide_worker);
+	slide_context->busy = false;
+	slide_show_file();
+}
+#endif
+
 /**
  * \brief Timer alarm callback for automatic loading.
  *
@@ -253,6 +275,11 @@ static void slide_show_file(void)
  * \note The timeout is set either by the application window event handler, or
  * by this function after a timeout.
  *
+ * \note With the \ref gfx_frame "frame scheduler", loading is started from a
+ * task at the start of the next display refresh instead. The application is
+ * flagged as busy in the meantime, so that the slide is not changed or the
+ * application closed while the task is waiting.
+ *
  * \param timer Pointer to timer struct associated with the callback.
  */
 static void slide_timer_callback(struct timer *timer)
@@ -265,7 +292,14 @@ static void slide_timer_callback(struct timer *timer)
 	if (--secs_to_go == 0) {
 		secs_to_go = SECONDS_PER_SLIDE;
 		slide_get_next_file(true);
+#ifdef CONFIG_GFX_FRAME
+		slide_context->busy = true;
+		workqueue_task_set_work_func(slide_context->task,
+				slide_frame_worker);
+		gfx_frame_add_task(slide_context->task);
+#else
 		slide_show_file();
+#endif
 	} else {
 		timer_set_alarm(CONFIG_TIMER_ID, timer,
 				slide_context->timer_delay);
@@ -67,6 +67,9 @@
  * - AVR XMEGA presentation
  * - Display Xplained presentation
  *
+ * The slides of all five slideshows are stored with thumbnails, so the file
+ * loader shows a preview of each slide while the full image is loaded.
+ *
  * This application makes use of the \ref timer_group "Timer driver" for timing
  * of the automatic loading and the \ref appsutil_fileloader_group
  * "Fileloader utility" for loading files directly from filesystem to screen.
@@ -40,8 +40,13 @@
 #include <gfx/gfx.h>
 #include <gfx/win.h>
 #include <gfx/wtk.h>
+#include <gfx/sprite.h>
 #include <gfx/sysfont.h>
+#ifdef CONFIG_GFX_FRAME
+#include <gfx/frame.h>
+#endif
 #include <mainloop.h>
+#include <hugemem.h>
 #include <membag.h>
 #include <physmem.h>
 #include <status_codes.h>
@@ -49,6 +54,8 @@
 #include <timer.h>
 #include <util.h>
 
+#include <board/physmem.h>
+
 #include "app_tank.h"
 #include "app_desktop.h"
 #include "file_loader.h"
@@ -160,6 +167,13 @@
 #define BITMAP_LIGHT_SIZE_X             38
 //! Height of alarm light bitmap.
 #define BITMAP_LIGHT_SIZE_Y             38
+//! Bits per pixel of the indexed color alarm light bitmaps.
+#define BITMAP_LIGHT_BPP                4
+//! Number of colors in the palette of an alarm light bitmap.
+#define BITMAP_LIGHT_NR_COLORS          (1 << BITMAP_LIGHT_BPP)
+//! Size of the palette at the start of an alarm light bitmap file.
+#define BITMAP_LIGHT_PALETTE_SIZE       \
+	(BITMAP_LIGHT_NR_COLORS * sizeof(gfx_color_t))
 //! X coordinate of alarm light bitmap.
 #define BITMAP_LIGHT_POSITION_X         241
 //! Y coordinate of alarm light bitmap.
@@ -189,6 +203,14 @@
  */
 #define TICKS_PER_RANDOM_UPDATE         9
 
+/**
+ * \brief Number of application ticks between each blink of the alarm light
+ *
+ * While the tank level is critical, the red alarm light is shown and
+ * hidden at this interval.
+ */
+#define TICKS_PER_ALARM_BLINK           8
+
 //! @}
 
 //! States for the application loader task.
@@ -226,6 +248,26 @@ enum tank_bitmap_id {
  */
 static hugemem_ptr_t tank_bitmap_data[NR_OF_BITMAPS];
 
+/**
+ * \brief Palettes of the alarm light bitmaps.
+ *
+ * The bitmap files hold a palette followed by the pixels. The pixels are
+ * drawn from hugemem, while the palettes are copied here, as they are
+ * looked up for every pixel.
+ */
+static gfx_color_t tank_light_palettes[NR_OF_BITMAPS][BITMAP_LIGHT_NR_COLORS];
+
+//! Pixels and palettes of the alarm light bitmaps.
+static struct gfx_indexed_pixmap tank_light_pixmaps[NR_OF_BITMAPS];
+
+/**
+ * \brief Save-under of the alarm light sprite in hugemem.
+ *
+ * \note Like the bitmaps, this is only allocated the first time the
+ * application is run.
+ */
+static hugemem_ptr_t tank_light_save_under;
+
 /**
  * \brief Event command ID for application widgets.
  *
@@ -271,6 +313,12 @@ struct tank_context {
 	int32_t                 rand;
 	//! Metadata for alarm light bitmaps.
 	struct gfx_bitmap       bitmaps[NR_OF_BITMAPS];
+	//! Sprite showing the alarm light on top of the background image.
+	struct gfx_sprite       *light;
+	//! Flag indicating that the alarm light is shown.
+	bool                    light_on;
+	//! Tick count until the alarm light blinks.
+	uint8_t                 blink_ticks;
 };
 
 /**
@@ -303,6 +351,14 @@ static bool tank_frame_handler(struct wtk_basic_frame *basic_frame,
 		// Stop the application timer first.
 		timer_stop(CONFIG_TIMER_ID, &tank_ctx->timer);
 
+		/* Remove the alarm light right away, before the desktop
+		 * is drawn, so that a later compose does not draw over it.
+		 */
+		if (tank_ctx->light) {
+			gfx_sprite_destroy(tank_ctx->light);
+			gfx_sprite_compose();
+		}
+
 		// Free all memory and return to desktop.
 		memcpy(&sysfont, &tank_ctx->old_sysfont,
 				sizeof(struct font));
@@ -360,8 +416,12 @@ static int32_t tank_logistic_map(int32_t rand)
  *
  * If the tank level reaches 0, the indicator for demand will change color to
  * indicate that the supply is insufficient. If, on the other hand, it reaches
- * \ref VALUE_LEVEL_MAXIMUM, the alarm light changes color to indicate that the
- * supply is too great.
+ * \ref VALUE_LEVEL_MAXIMUM, the alarm light changes color and starts to blink
+ * to indicate that the supply is too great.
+ *
+ * The alarm light is a \ref gfx_sprite "sprite", so the background image
+ * under it is restored from its save-under when it blinks off, and only
+ * the area of the light is drawn.
  *
  * \note The task for this worker function is enqueued by the timer callback
  * function.
@@ -458,22 +518,24 @@ static void tank_worker(struct workqueue_task *task)
 	}
 	wtk_progress_bar_set_value(tank_ctx->level, level);
 
-	/* If a level alarm update occurred, set up clipping area and draw
-	 * the new alarm light bitmap.
+	/* If a level alarm update occurred, switch the alarm light to the
+	 * new bitmap. Otherwise, blink the light while the level is critical.
 	 */
 	if (alarm_update) {
-#ifdef CONFIG_GFX_USE_CLIPPING
-		gfx_set_clipping(BITMAP_LIGHT_POSITION_X,
-				BITMAP_LIGHT_POSITION_Y,
-				BITMAP_LIGHT_POSITION_X
-					+ BITMAP_LIGHT_SIZE_X - 1,
-				BITMAP_LIGHT_POSITION_Y
-					+ BITMAP_LIGHT_SIZE_Y - 1
-				);
-#endif /* CONFIG_GFX_USE_CLIPPING */
-		gfx_draw_bitmap(alarm_bitmap,
-				BITMAP_LIGHT_POSITION_X,
-				BITMAP_LIGHT_POSITION_Y);
+		gfx_sprite_set_bitmap(tank_ctx->light, alarm_bitmap);
+		tank_ctx->light_on = false;
+		tank_ctx->blink_ticks = 1;
+	}
+
+	if ((alarm_update || tank_ctx->level_alarm)
+			&& (--(tank_ctx->blink_ticks) == 0)) {
+		tank_ctx->blink_ticks = TICKS_PER_ALARM_BLINK;
+		tank_ctx->light_on = !tank_ctx->light_on;
+		if (tank_ctx->light_on)
+			gfx_sprite_show(tank_ctx->light);
+		else
+			gfx_sprite_hide(tank_ctx->light);
+		gfx_sprite_schedule_compose();
 	}
 }
 
@@ -481,7 +543,9 @@ static void tank_worker(struct workqueue_task *task)
  * \brief Application timer callback function.
  *
  * This callback function is used with the \ref timer_group "Timer driver" and
- * will enqueue the task for application updates.
+ * will enqueue the task for application updates. With the
+ * \ref gfx_frame "frame scheduler", the update is held back until the next
+ * refresh of the display starts.
  *
  * \param timer Pointer to timer struct associated with the callback.
  */
@@ -489,7 +553,39 @@ static void tank_timer_callback(struct timer *timer)
 {
 	timer_set_alarm(CONFIG_TIMER_ID, &tank_ctx->timer,
 			tank_ctx->timer_delay);
+#ifdef CONFIG_GFX_FRAME
+	gfx_frame_add_task(tank_ctx->task);
+#else
 	workqueue_add_task(&main_workqueue, tank_ctx->task);
+#endif
+}
+
+/**
+ * \brief Set up the alarm light bitmaps from the loaded files.
+ *
+ * This copies the palettes of the alarm light bitmaps to SRAM, and points
+ * the bitmaps to their pixels in hugemem.
+ */
+static void tank_set_light_bitmaps(void)
+{
+	struct gfx_indexed_pixmap       *pixmap;
+	uint8_t                         i;
+
+	for (i = 0; i < NR_OF_BITMAPS; i++) {
+		pixmap = &tank_light_pixmaps[i];
+
+		hugemem_read_block(tank_light_palettes[i], tank_bitmap_data[i],
+				BITMAP_LIGHT_PALETTE_SIZE);
+
+		pixmap->bpp = BITMAP_LIGHT_BPP;
+		pixmap->transparent = GFX_INDEX_NONE;
+		pixmap->palette = tank_light_palettes[i];
+		pixmap->pixels.hugemem = (hugemem_ptr_t)(
+				(phys_addr_t)tank_bitmap_data[i]
+				+ BITMAP_LIGHT_PALETTE_SIZE);
+
+		tank_ctx->bitmaps[i].data.indexed = pixmap;
+	}
 }
 
 /**
@@ -517,18 +613,28 @@ static void tank_loader(struct workqueue_task *task)
 	 */
 	switch (tank_ctx->loader_state) {
 	case LOAD_RED_LIGHT:
+		// Allocate the save-under of the alarm light sprite.
+		if (tank_light_save_under == HUGEMEM_NULL) {
+			tank_light_save_under = hugemem_alloc(
+					&board_extram_pool,
+					gfx_sprite_save_under_size(
+						BITMAP_LIGHT_SIZE_X,
+						BITMAP_LIGHT_SIZE_Y), 0);
+			if (tank_light_save_under == HUGEMEM_NULL) {
+				goto exit_load_error;
+			}
+		}
+
 		// Enqueue loading of the red alarm light bitmap.
 		bitmap_data = load_file_to_hugemem(BITMAP_RED_LIGHT_FILENAME,
 				task);
 
-		/* If memory could be allocated for the bitmap, update the
-		 * pointer in the bitmap metadata and set next load state.
-		 * Otherwise, exit the application load error.
+		/* If memory could be allocated for the bitmap, store the
+		 * pointer and set next load state. Otherwise, exit the
+		 * application load error.
 		 */
 		if (bitmap_data != HUGEMEM_NULL) {
 			tank_bitmap_data[BITMAP_RED_LIGHT] = bitmap_data;
-			tank_ctx->bitmaps[BITMAP_RED_LIGHT].data.hugemem =
-					bitmap_data;
 
 			tank_ctx->loader_state = LOAD_GREEN_LIGHT;
 		} else {
@@ -542,8 +648,6 @@ static void tank_loader(struct workqueue_task *task)
 
 		if (bitmap_data != HUGEMEM_NULL) {
 			tank_bitmap_data[BITMAP_GREEN_LIGHT] = bitmap_data;
-			tank_ctx->bitmaps[BITMAP_GREEN_LIGHT].data.hugemem
-					= bitmap_data;
 
 			tank_ctx->loader_state = LOAD_BACKGROUND;
 		} else {
@@ -552,6 +656,9 @@ static void tank_loader(struct workqueue_task *task)
 		break;
 
 	case LOAD_BACKGROUND:
+		// Both alarm light bitmaps have been loaded by now.
+		tank_set_light_bitmaps();
+
 		// Now load the background image.
 		result = load_file_to_screen(BITMAP_BACKGROUND_FILENAME,
 				BITMAP_BACKGROUND_POSITION_X,
@@ -570,6 +677,18 @@ static void tank_loader(struct workqueue_task *task)
 		// Now show the application's frame. This will draw all widgets.
 		win_show(wtk_basic_frame_as_child(tank_ctx->frame));
 
+		/* Create the alarm light, which is shown by the first update
+		 * now that the background is on the screen.
+		 */
+		tank_ctx->light = gfx_sprite_create(
+				&tank_ctx->bitmaps[BITMAP_GREEN_LIGHT],
+				tank_light_save_under, 0);
+		if (!tank_ctx->light) {
+			goto exit_load_error;
+		}
+		gfx_sprite_move(tank_ctx->light, BITMAP_LIGHT_POSITION_X,
+				BITMAP_LIGHT_POSITION_Y);
+
 		// Set the worker function that updates the application.
 		workqueue_task_set_work_func(task, tank_worker);
 
@@ -741,6 +860,7 @@ void app_tank_launch(struct workqueue_task *task)
 	tank_ctx->level_alarm = true;
 	tank_ctx->flow_alarm = false;
 	tank_ctx->task = task;
+	tank_ctx->light = NULL;
 
 	/* Initialize bitmap data and set initial application loader state:
 	 * If the alarm light bitmaps have already been loaded, skip right to
@@ -748,16 +868,12 @@ void app_tank_launch(struct workqueue_task *task)
 	 */
 	bitmap.width = BITMAP_LIGHT_SIZE_X;
 	bitmap.height = BITMAP_LIGHT_SIZE_Y;
-	bitmap.type = BITMAP_HUGEMEM;
+	bitmap.type = BITMAP_INDEXED_HUGEMEM;
 	tank_ctx->bitmaps[BITMAP_RED_LIGHT] = bitmap;
 	tank_ctx->bitmaps[BITMAP_GREEN_LIGHT] = bitmap;
 
 	if (tank_bitmap_data[BITMAP_GREEN_LIGHT]) {
 		tank_ctx->loader_state = LOAD_BACKGROUND;
-		tank_ctx->bitmaps[BITMAP_RED_LIGHT].data.hugemem =
-				tank_bitmap_data[BITMAP_RED_LIGHT];
-		tank_ctx->bitmaps[BITMAP_GREEN_LIGHT].data.hugemem =
-				tank_bitmap_data[BITMAP_GREEN_LIGHT];
 	} else {
 		tank_ctx->loader_state = LOAD_RED_LIGHT;
 	}
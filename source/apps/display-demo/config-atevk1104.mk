@@ -15,3 +15,6 @@ CONFIG_DEBUG_CONSOLE=y
 CONFIG_DEBUG_UART=y
 CONFIG_DEBUG_UART_ID=1
 #CONFIG_DEBUG_LEVEL=DEBUG_VERBOSE
+
+# Send pixels to the display with the DMA controller
+CONFIG_GFX_HX8347A_DMA=y
@@ -0,0 +1,33 @@
+include $(src)/board/host/config.mk
+include $(src)/apps/display-demo/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+
+CONFIG_SOFTIRQ=y
+
+CONFIG_EXTRAM_SDRAM=y
+
+CONFIG_GFX_WIN_USE_TOUCH=y
+
+CONFIG_TOUCH_RESISTIVE=y
+CONFIG_TOUCH_PORT_IRQ_ID=1
+CONFIG_TOUCH_PORT_INTLVL=0
+CONFIG_TOUCH_ADC_IRQ_ID=2
+CONFIG_TOUCH_ADC_INTLVL=0
+CONFIG_TOUCH_OVERSAMPLING=2
+CONFIG_TOUCH_FILTER=y
+
+CONFIG_BLOCK=y
+CONFIG_BLOCK_HOST_FILE=y
+CONFIG_FS_TSFS=y
+CONFIG_FS_TSFS_USE_HUGEMEM=y
+CONFIG_HUGEMEM=y
+CONFIG_GFX_GLYPH_CACHE=y
+CONFIG_GFX_GLYPH_CACHE_SIZE=512
+CONFIG_GFX_GLYPH_CACHE_NR_ENTRIES=24
+CONFIG_GFX_WTK_SURFACE_CACHE=y
+CONFIG_APP_SURFACE_CACHE_SIZE=32768
+CONFIG_GFX_FRAME=y
+CONFIG_GFX_SPRITE=y
+CONFIG_GFX_SPRITE_NR=2
+CONFIG_GFX_SPRITE_LINE_PIXELS=40
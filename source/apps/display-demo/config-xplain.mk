@@ -23,13 +23,14 @@ CONFIG_TOUCH_PORT_BASE=PORTA_BASE
 CONFIG_TOUCH_PORT_IRQ_ID=PMIC_PORTA_INT0_IRQ
 CONFIG_TOUCH_PORT_INTLVL=PMIC_INTLVL_LOW
 CONFIG_TOUCH_ADC_BASE=ADCA_BASE
-CONFIG_TOUCH_ADC_IRQ_ID=PMIC_ADC0_CH1_IRQ
+CONFIG_TOUCH_ADC_IRQ_ID=PMIC_ADC0_CH3_IRQ
 CONFIG_TOUCH_ADC_INTLVL=PMIC_INTLVL_LOW
 CONFIG_TOUCH_XL_PIN=4
 CONFIG_TOUCH_XR_PIN=5
 CONFIG_TOUCH_YD_PIN=6
 CONFIG_TOUCH_YU_PIN=7
 CONFIG_TOUCH_OVERSAMPLING=2
+CONFIG_TOUCH_FILTER=y
 
 CONFIG_TC=y
 CONFIG_MALLOC_SIMPLE=y
@@ -44,3 +45,13 @@ CONFIG_AT45=y
 CONFIG_FS_TSFS=y
 CONFIG_FS_TSFS_USE_HUGEMEM=y
 CONFIG_HUGEMEM=y
+CONFIG_HUGEMEM_DMA=y
+CONFIG_GFX_GLYPH_CACHE=y
+CONFIG_GFX_GLYPH_CACHE_SIZE=512
+CONFIG_GFX_GLYPH_CACHE_NR_ENTRIES=24
+CONFIG_GFX_WTK_SURFACE_CACHE=y
+CONFIG_APP_SURFACE_CACHE_SIZE=32768
+CONFIG_GFX_FRAME=y
+CONFIG_GFX_SPRITE=y
+CONFIG_GFX_SPRITE_NR=2
+CONFIG_GFX_SPRITE_LINE_PIXELS=40
@@ -8,11 +8,15 @@ CONFIG_NR_BUFFERS=2
 
 CONFIG_GFX=y
 CONFIG_GFX_USE_CLIPPING=y
+CONFIG_GFX_FIXED_ORIENTATION=y
 CONFIG_GFX_HX8347A=y
 CONFIG_GFX_WIN=y
 CONFIG_GFX_WTK=y
 CONFIG_GFX_SYSFONT=y
 
+# The water tank alarm lights are indexed color bitmaps
+CONFIG_GFX_BITMAP_INDEXED=y
+
 CONFIG_STREAM=y
 
 CONFIG_TIMER=y
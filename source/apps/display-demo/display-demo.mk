@@ -30,3 +30,8 @@ hdr-$(CONFIG_FS_TSFS)   += apps/$(app)/app_memgame.h
 hdr-y		+= apps/$(app)/app_widget.h
 
 hdr-$(CONFIG_FS_TSFS)	+= apps/$(app)/file_loader.h
+
+# TSFS volume image for "make tsfs-image", laid out for the 1024 byte pages
+# of the AT45DB642D DataFlash on Xplain.
+tsfs-manifest-$(CONFIG_FS_TSFS)	+= $(src)/../graphics/display_demo.tsfs
+tsfs-page-size	:= 1024
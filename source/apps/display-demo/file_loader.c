@@ -35,11 +35,13 @@
  * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
  * DAMAGE.
  */
+#include <assert.h>
 #include <dma.h>
 #include <hugemem.h>
 #include <physmem.h>
 #include <mainloop.h>
 #include <status_codes.h>
+#include <string.h>
 
 #include <board/physmem.h>
 
@@ -61,8 +63,21 @@
 #define MAX_LOAD_PIXELS         64
 #define MAX_LOAD_SIZE           (MAX_LOAD_PIXELS * sizeof(gfx_color_t))
 
+//! Number of thumbnails kept in the thumbnail cache.
+#define FILE_THUMB_CACHE_ENTRIES        12
+
 extern struct tsfs              myfs;
 
+//! Entry in the thumbnail cache.
+struct file_thumb_entry {
+	//! Thumbnail pixels, allocated the first time the entry is used.
+	hugemem_ptr_t           data;
+	//! Index of the image file in the TSFS.
+	uint8_t                 file_index;
+	//! True if \a data holds the thumbnail of \a file_index.
+	bool                    valid;
+};
+
 struct file_loader {
 	struct tsfs_file        file;
 	struct workqueue_task   task;
@@ -91,6 +106,11 @@ struct file_loader {
 	gfx_coord_t             width;
 	gfx_coord_t             height;
 
+	//! Number of bytes to load to hugemem.
+	uint32_t                size;
+	//! Thumbnail cache entry being loaded, or NULL.
+	struct file_thumb_entry *thumb;
+
 	uint16_t                load_size;
 	uint8_t                 buffer[MAX_LOAD_SIZE];
 	bool                    busy;
@@ -98,6 +118,45 @@ struct file_loader {
 
 static struct file_loader      the_file_loader;
 
+//! Thumbnail cache.
+static struct file_thumb_entry  file_thumb_cache[FILE_THUMB_CACHE_ENTRIES];
+
+//! Next thumbnail cache entry to replace.
+static uint8_t                  file_thumb_victim;
+
+/**
+ * \brief Get the size of the thumbnail of an image
+ *
+ * \param width Width of the image in pixels
+ * \param height Height of the image in pixels
+ *
+ * \return Size of the thumbnail in bytes
+ */
+static uint32_t file_thumb_size(gfx_coord_t width, gfx_coord_t height)
+{
+	return (uint32_t)(width / FILE_THUMB_SCALE) *
+		(height / FILE_THUMB_SCALE) * sizeof(gfx_color_t);
+}
+
+/**
+ * \brief Check if an image file has a thumbnail appended
+ *
+ * \param file Opened image file
+ * \param width Width of the image in pixels
+ * \param height Height of the image in pixels
+ *
+ * \retval true if the thumbnail follows the image pixels
+ * \retval false if the file only holds the image pixels
+ */
+static bool file_has_thumbnail(struct tsfs_file *file, gfx_coord_t width,
+		gfx_coord_t height)
+{
+	uint32_t image_size = (uint32_t)width * height * sizeof(gfx_color_t);
+
+	return tsfs_get_file_size(file) ==
+		image_size + file_thumb_size(width, height);
+}
+
 /**
  * \brief Load file data directly to screen worker
  *
@@ -128,15 +187,68 @@ static void load_to_screen_worker(struct workqueue_task *task)
 		floader->current_x = 0;
 	}
 
+	// If all lines are drawn we are done, run the image done task
+	if (floader->current_y >= floader->height)
+		goto done;
+
 	floader->load_size = min_u((floader->width - floader->current_x),
 			MAX_LOAD_PIXELS);
 
 	result = tsfs_read(&myfs, &floader->file, &floader->buffer,
 			floader->load_size * sizeof(gfx_color_t),
 			&floader->task);
+	if (result == STATUS_OK)
+		return;
+
+done:
+	floader->busy = false;
+
+	if (floader->done_task)
+		workqueue_add_task(&main_workqueue, floader->done_task);
+}
+
+/**
+ * \brief Load thumbnail preview to screen worker
+ *
+ * This worker function draws one line of the thumbnail of an image, scaled
+ * up by \ref FILE_THUMB_SCALE. When the whole preview is drawn, it starts
+ * loading the full image over it.
+ *
+ * \param task Pointer to the current work queue task
+ */
+static void load_preview_to_screen_worker(struct workqueue_task *task)
+{
+	struct file_loader      *floader = &the_file_loader;
+	gfx_color_t             *pixels = (gfx_color_t *)floader->buffer;
+	enum status_code        result;
+	gfx_coord_t             x;
+	gfx_coord_t             y;
+	uint8_t                 i;
+
+	gfx_set_clipping(0, 0, gfx_get_width(), gfx_get_height());
 
-	// If file we are done, run the image done task
-	if ((result != STATUS_OK) || (floader->current_y > floader->height)) {
+	x = floader->offset_x;
+	y = floader->offset_y + floader->current_y * FILE_THUMB_SCALE;
+	for (i = 0; i < floader->load_size; i++) {
+		gfx_draw_filled_rect(x, y, FILE_THUMB_SCALE, FILE_THUMB_SCALE,
+				pixels[i]);
+		x += FILE_THUMB_SCALE;
+	}
+
+	floader->current_y++;
+	if (floader->current_y >= floader->height / FILE_THUMB_SCALE) {
+		// Refine the preview with the full image, line by line.
+		floader->current_y = 0;
+		floader->load_size = min_u(floader->width, MAX_LOAD_PIXELS);
+		tsfs_seek(&floader->file, 0, SEEK_SET);
+		workqueue_task_set_work_func(&floader->task,
+				load_to_screen_worker);
+	}
+
+	result = tsfs_read(&myfs, &floader->file, &floader->buffer,
+			floader->load_size * sizeof(gfx_color_t),
+			&floader->task);
+	if (result != STATUS_OK) {
 		floader->busy = false;
 
 		if (floader->done_task)
@@ -156,15 +268,12 @@ static void load_to_hugemem_worker(struct workqueue_task *task)
 {
 	struct file_loader      *floader = &the_file_loader;
 	enum status_code        result = STATUS_OK;
-	uint32_t                file_size;
 
-	file_size = floader->file.end - floader->file.start;
-
-	hugemem_write_block((hugemem_ptr_t)((uint32_t)floader->hugemem_address +
+	hugemem_write_block((hugemem_ptr_t)((phys_addr_t)floader->hugemem_address +
 			floader->offset), floader->buffer, floader->load_size);
 
 	floader->offset += floader->load_size;
-	floader->load_size = min_u(file_size - floader->offset,
+	floader->load_size = min_u(floader->size - floader->offset,
 			MAX_LOAD_SIZE);
 
 	if (floader->load_size) {
@@ -175,6 +284,11 @@ static void load_to_hugemem_worker(struct workqueue_task *task)
 	if (!floader->load_size || result != STATUS_OK) {
 		floader->busy = false;
 
+		if (floader->thumb) {
+			floader->thumb->valid = (result == STATUS_OK);
+			floader->thumb = NULL;
+		}
+
 		if (floader->done_task)
 			workqueue_add_task(&main_workqueue,
 					floader->done_task);
@@ -187,6 +301,11 @@ static void load_to_hugemem_worker(struct workqueue_task *task)
  * This function opens a file from the DataFlash and loads the file data
  * directly to the screen.
  *
+ * If the file has a thumbnail appended, as described for
+ * load_thumbnail_to_cache(), the thumbnail is drawn first, scaled up to
+ * the full size. The image then replaces the preview line by line as it
+ * is read, so the first pixels are shown after reading only the thumbnail.
+ *
  * \param filename Name of file to load from file system.
  * \param pos_x X position on screen to start putting data
  * \param pos_y Y position on screen to start putting data
@@ -224,9 +343,20 @@ enum status_code load_file_to_screen(const char *filename, gfx_coord_t pos_x,
 	floader->busy = true;
 	floader->done_task = done_task;
 
-	floader->load_size = min_u(floader->width, MAX_LOAD_PIXELS);
-
-	workqueue_task_set_work_func(&floader->task, load_to_screen_worker);
+	if (file_has_thumbnail(&floader->file, width, height)) {
+		floader->load_size = width / FILE_THUMB_SCALE;
+		assert(floader->load_size <= MAX_LOAD_PIXELS);
+
+		tsfs_seek(&floader->file,
+				-(int32_t)file_thumb_size(width, height),
+				SEEK_END);
+		workqueue_task_set_work_func(&floader->task,
+				load_preview_to_screen_worker);
+	} else {
+		floader->load_size = min_u(floader->width, MAX_LOAD_PIXELS);
+		workqueue_task_set_work_func(&floader->task,
+				load_to_screen_worker);
+	}
 
 	result = tsfs_read(&myfs, &floader->file, &floader->buffer,
 			floader->load_size * sizeof(gfx_color_t),
@@ -271,6 +401,7 @@ hugemem_ptr_t load_file_to_hugemem(const char *filename,
 	floader->busy            = true;
 	floader->done_task       = task;
 	floader->offset          = 0;
+	floader->size            = file_size;
 	floader->hugemem_address = retval;
 	floader->load_size       = min_u(file_size, MAX_LOAD_SIZE);
 
@@ -284,6 +415,144 @@ hugemem_ptr_t load_file_to_hugemem(const char *filename,
 	return retval;
 }
 
+/**
+ * \brief Load the thumbnail of an image into the thumbnail cache.
+ *
+ * Image files may have a thumbnail appended after the pixels of the image.
+ * The thumbnail is (\a width / \ref FILE_THUMB_SCALE) by
+ * (\a height / \ref FILE_THUMB_SCALE) pixels, in the same format as the
+ * image. Files with a thumbnail are recognized by their size.
+ *
+ * The thumbnail replaces the least recently loaded one in the cache, and
+ * can be fetched with file_loader_get_thumbnail() once \a task has run.
+ *
+ * \param file_index Index of the image file in the TSFS
+ * \param width Width of the image in pixels
+ * \param height Height of the image in pixels
+ * \param task Pointer to work queue task to callback when done loading
+ *
+ * \return \ref STATUS_OK if loading was started, \ref ERR_INVALID_ARG if
+ * the file has no thumbnail, or another \ref status_code on error
+ */
+enum status_code load_thumbnail_to_cache(uint8_t file_index,
+		gfx_coord_t width, gfx_coord_t height,
+		struct workqueue_task *task)
+{
+	struct file_loader      *floader = &the_file_loader;
+	struct file_thumb_entry *entry = NULL;
+	char                    filename[TSFS_FILENAME_LEN + 1];
+	enum status_code        status;
+	uint32_t                thumb_size;
+	uint8_t                 i;
+
+	if (!tsfs_is_ready(&myfs))
+		return ERR_IO_ERROR;
+
+	if (floader->busy)
+		return ERR_BUSY;
+
+	memset(filename, 0, sizeof(filename));
+	tsfs_get_filename(&myfs, file_index, (uint8_t *)filename);
+
+	status = tsfs_open(&myfs, filename, &floader->file);
+	if (status != STATUS_OK)
+		return status;
+
+	if (!file_has_thumbnail(&floader->file, width, height))
+		return ERR_INVALID_ARG;
+
+	// Reload into the entry of the file, if it is already cached.
+	for (i = 0; i < FILE_THUMB_CACHE_ENTRIES; i++) {
+		if (file_thumb_cache[i].data != HUGEMEM_NULL
+				&& file_thumb_cache[i].file_index == file_index)
+			entry = &file_thumb_cache[i];
+	}
+
+	if (!entry) {
+		entry = &file_thumb_cache[file_thumb_victim];
+		file_thumb_victim = (file_thumb_victim + 1)
+			% FILE_THUMB_CACHE_ENTRIES;
+	}
+
+	thumb_size = file_thumb_size(width, height);
+	if (entry->data == HUGEMEM_NULL) {
+		entry->data = hugemem_alloc(&board_extram_pool, thumb_size,
+				CPU_DMA_ALIGN);
+		if (entry->data == HUGEMEM_NULL)
+			return ERR_NO_MEMORY;
+	}
+
+	entry->file_index = file_index;
+	entry->valid = false;
+
+	tsfs_seek(&floader->file, -(int32_t)thumb_size, SEEK_END);
+
+	floader->busy            = true;
+	floader->done_task       = task;
+	floader->thumb           = entry;
+	floader->offset          = 0;
+	floader->size            = thumb_size;
+	floader->hugemem_address = entry->data;
+	floader->load_size       = min_u(thumb_size, MAX_LOAD_SIZE);
+
+	workqueue_task_set_work_func(&floader->task, load_to_hugemem_worker);
+
+	status = tsfs_read(&myfs, &floader->file, &floader->buffer,
+			floader->load_size, &floader->task);
+	if (status != STATUS_OK) {
+		floader->busy = false;
+		floader->thumb = NULL;
+	}
+
+	return status;
+}
+
+/**
+ * \brief Check if an image file has a thumbnail.
+ *
+ * \param file_index Index of the image file in the TSFS
+ * \param width Width of the image in pixels
+ * \param height Height of the image in pixels
+ *
+ * \retval true if the file has a thumbnail appended
+ * \retval false if the file has no thumbnail or cannot be opened
+ */
+bool file_loader_has_thumbnail(uint8_t file_index, gfx_coord_t width,
+		gfx_coord_t height)
+{
+	char                    filename[TSFS_FILENAME_LEN + 1];
+	struct tsfs_file        file;
+
+	memset(filename, 0, sizeof(filename));
+	tsfs_get_filename(&myfs, file_index, (uint8_t *)filename);
+
+	if (tsfs_open(&myfs, filename, &file) != STATUS_OK)
+		return false;
+
+	return file_has_thumbnail(&file, width, height);
+}
+
+/**
+ * \brief Get a thumbnail from the thumbnail cache.
+ *
+ * \param file_index Index of the image file in the TSFS
+ *
+ * \return hugemem pointer to the thumbnail pixels, or \ref HUGEMEM_NULL if
+ * the thumbnail is not cached
+ */
+hugemem_ptr_t file_loader_get_thumbnail(uint8_t file_index)
+{
+	uint8_t i;
+
+	for (i = 0; i < FILE_THUMB_CACHE_ENTRIES; i++) {
+		if (file_thumb_cache[i].valid
+				&& file_thumb_cache[i].file_index == file_index)
+			return file_thumb_cache[i].data;
+	}
+
+	return HUGEMEM_NULL;
+}
+
 /**
  * \brief Check if the file loader is busy loading a file.
  *
@@ -50,9 +50,16 @@
  * This utility is used for loading files from a dataflash and directly to
  * the screen or into hugemem.
  *
+ * Image files may have a downscaled thumbnail appended. It is shown as a
+ * preview while the image is loaded to the screen, and can be loaded into
+ * a small cache in hugemem for showing many images at once.
+ *
  * @{
  */
 
+//! Scale factor from the size of a thumbnail to the size of its image.
+#define FILE_THUMB_SCALE        8
+
 void file_loader_init(void);
 bool file_loader_busy(void);
 
@@ -63,6 +70,14 @@ enum status_code load_file_to_screen(const char *filename, gfx_coord_t px,
 hugemem_ptr_t load_file_to_hugemem(const char *filename,
 		struct workqueue_task *task);
 
+enum status_code load_thumbnail_to_cache(uint8_t file_index,
+		gfx_coord_t width, gfx_coord_t height,
+		struct workqueue_task *task);
+
+bool file_loader_has_thumbnail(uint8_t file_index, gfx_coord_t width,
+		gfx_coord_t height);
+hugemem_ptr_t file_loader_get_thumbnail(uint8_t file_index);
+
 //! @}
 
 #endif /* APP_FILE_LOADER_H_INCLUDED */
@@ -40,6 +40,9 @@
 
 enum softirq_id {
 	SOFTIRQ_TOUCH_PROCESS,
+#ifdef CONFIG_GFX_FRAME
+	SOFTIRQ_GFX_FRAME,
+#endif
 	SOFTIRQ_NR_IDS,
 };
 
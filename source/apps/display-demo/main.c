@@ -65,6 +65,16 @@
 #include <gfx/win.h>
 #include <gfx/sysfont.h>
 
+#ifdef CONFIG_GFX_FRAME
+#include <gfx/frame.h>
+#endif
+
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+#include <hugemem.h>
+#include <board/physmem.h>
+#include <gfx/wtk.h>
+#endif
+
 #ifdef CONFIG_TOUCH_RESISTIVE
 #include <touch/touch.h>
 #endif
@@ -72,31 +82,55 @@
 #include "app_desktop.h"
 
 #ifdef CONFIG_FS_TSFS
-#include <spi.h>
 #include <block/device.h>
-#include <block/dataflash.h>
 #include <fs/tsfs.h>
 
+#ifdef CONFIG_BLOCK_DATAFLASH
+#include <spi.h>
+#include <block/dataflash.h>
+
 DECLARE_SPI_MASTER(CONFIG_APP_DATAFLASH_SPI_ID, my_master);
 DECLARE_SPI_DEVICE(CONFIG_APP_DATAFLASH_SPI_ID, my_device);
 
+struct spi_master              *master;
+struct spi_device              *device;
+#elif defined(CONFIG_BLOCK_HOST_FILE)
+#include <block/host_file.h>
+#endif
+
 static struct block_device     *bdev;
 static struct workqueue_task   ready_task;
 struct tsfs                    myfs;
-struct spi_master              *master;
-struct spi_device              *device;
 
 static void tsfs_ready_callback(struct workqueue_task *task)
 {
 }
 
-static void spi_ready_callback(struct workqueue_task *task)
+static void bdev_ready_callback(struct workqueue_task *task)
 {
 	workqueue_task_set_work_func(&ready_task, tsfs_ready_callback);
 	tsfs_init(&myfs, bdev, &ready_task);
 }
 #endif
 
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+/**
+ * \brief Give the widget surface cache its arena in external memory
+ *
+ * The arena holds \a CONFIG_APP_SURFACE_CACHE_SIZE bytes. If it cannot be
+ * allocated, the widgets are drawn without the cache.
+ */
+static void surface_cache_init(void)
+{
+	hugemem_ptr_t   arena;
+
+	arena = hugemem_alloc(&board_extram_pool,
+			CONFIG_APP_SURFACE_CACHE_SIZE, CPU_DMA_ALIGN);
+	if (arena != HUGEMEM_NULL)
+		wtk_surface_cache_init(arena, CONFIG_APP_SURFACE_CACHE_SIZE);
+}
+#endif
+
 int main(void)
 {
 	cpu_irq_enable();
@@ -110,10 +144,19 @@ int main(void)
 	touch_enable();
 #endif
 	gfx_init();
+#ifdef CONFIG_GFX_FRAME
+	gfx_frame_init();
+#endif
 	membag_init(CPU_DMA_ALIGN);
 	win_init();
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+	surface_cache_init();
+#endif
 
 #ifdef CONFIG_FS_TSFS
+	workqueue_task_init(&ready_task, bdev_ready_callback);
+
+# ifdef CONFIG_BLOCK_DATAFLASH
 	master = spi_master_get_base(CONFIG_APP_DATAFLASH_SPI_ID, &my_master);
 	device = spi_device_get_base(CONFIG_APP_DATAFLASH_SPI_ID, &my_device);
 
@@ -123,9 +166,11 @@ int main(void)
 	spi_master_setup_device(CONFIG_APP_DATAFLASH_SPI_ID, master, device,
 			SPI_MODE_0, CONFIG_CPU_HZ, BOARD_DATAFLASH_SS);
 
-	workqueue_task_init(&ready_task, spi_ready_callback);
 	bdev = dataflash_blkdev_init(CONFIG_APP_DATAFLASH_SPI_ID, master, device,
 			&ready_task);
+# elif defined(CONFIG_BLOCK_HOST_FILE)
+	bdev = host_file_blkdev_init(NULL, &ready_task);
+# endif
 #endif
 
 	app_desktop_setup();
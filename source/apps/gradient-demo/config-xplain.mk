@@ -21,13 +21,14 @@ CONFIG_TOUCH_PORT_BASE=PORTA_BASE
 CONFIG_TOUCH_PORT_IRQ_ID=PMIC_PORTA_INT0_IRQ
 CONFIG_TOUCH_PORT_INTLVL=PMIC_INTLVL_LOW
 CONFIG_TOUCH_ADC_BASE=ADCA_BASE
-CONFIG_TOUCH_ADC_IRQ_ID=PMIC_ADC0_CH1_IRQ
+CONFIG_TOUCH_ADC_IRQ_ID=PMIC_ADC0_CH3_IRQ
 CONFIG_TOUCH_ADC_INTLVL=PMIC_INTLVL_LOW
 CONFIG_TOUCH_XL_PIN=4
 CONFIG_TOUCH_XR_PIN=5
 CONFIG_TOUCH_YD_PIN=6
 CONFIG_TOUCH_YU_PIN=7
 CONFIG_TOUCH_OVERSAMPLING=2
+CONFIG_TOUCH_FILTER=y
 
 CONFIG_TC=y
 
@@ -0,0 +1,19 @@
+include $(src)/board/host/config.mk
+include $(src)/apps/msc-bench/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+
+CONFIG_HOST_UDC=y
+CONFIG_UDC_FULL_SPEED=y
+CONFIG_BLOCK_HOST_FILE=y
+
+CONFIG_DMAPOOL_SMALL_OBJ_SIZE=32
+CONFIG_DMAPOOL_NR_SMALL_OBJS=16
+CONFIG_DMAPOOL_LARGE_OBJ_SIZE=512
+CONFIG_DMAPOOL_NR_LARGE_OBJS=2
+
+# Same buffer memory as xplain-bc. Set CONFIG_UDI_MSC_PIPELINE_DEPTH=1
+# to compare against a pipeline which is not split into segments.
+CONFIG_UDI_MSC_BUFFER_SIZE=512
+CONFIG_UDI_MSC_NR_BUFFERS=2
+CONFIG_UDI_MSC_PIPELINE_DEPTH=2
@@ -0,0 +1,30 @@
+CONFIG_MAINLOOP=y
+
+CONFIG_PHYSMEM=y
+CONFIG_MEMPOOL=y
+CONFIG_BUFFER=y
+CONFIG_CRC32=y
+CONFIG_NR_BUFFERS=4
+CONFIG_DMAPOOL=y
+CONFIG_DMAPOOL_GENERIC_POOLS=y
+
+CONFIG_BLOCK=y
+CONFIG_BLOCK_FIXED_BLOCK_SIZE=512
+
+CONFIG_USB=y
+CONFIG_USB_DEV_MUX=y
+CONFIG_UDC=y
+CONFIG_UDI_MSC_BULK=y
+CONFIG_UDI_MSC_CRC32=y
+
+# Results are printed on the debug console
+CONFIG_STREAM=y
+CONFIG_SERIAL_UART=y
+CONFIG_UART_CTRL=y
+CONFIG_UART_BAUD_RATE=115200
+CONFIG_DEBUG_CONSOLE=y
+CONFIG_DEBUG_UART=y
+CONFIG_DEBUG_UART_ID=0
+CONFIG_DEBUG_LEVEL=DEBUG_INFO
+
+config_mk	+= $(appsrc)/config.mk
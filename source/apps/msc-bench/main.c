@@ -0,0 +1,542 @@
+/**
+ * \file
+ *
+ * \brief USB Mass Storage throughput benchmark
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * \page msc_bench USB Mass Storage Benchmark
+ *
+ * This application measures how fast a USB host can move data through
+ * the \ref udi_msc_bulk_group "USB Mass Storage interface". It runs on
+ * the host only, where the \ref udc_host_group "simulated USB device
+ * controller" takes the place of the USB bus and the
+ * \ref block_device_host_file_group "host file block device" takes the
+ * place of the DataFlash.
+ *
+ * The application plays the part of the USB host: it configures the
+ * device and issues READ(10) and WRITE(10) commands through the bulk
+ * endpoints, one at a time, just like a real host driver. Time is
+ * measured on the virtual clock of the host port, from the start of
+ * the Command Block Wrapper until the Command Status Wrapper has been
+ * received. The bus time is that of a full-speed bus, and setting
+ * \c HOST_BLOCK_LATENCY to e.g. 200 lets each block of the host file
+ * take about as long as on the DataFlash, so the results show how well
+ * the MSC pipeline keeps the bus and the block device busy at the same
+ * time. Compare runs with different \a CONFIG_UDI_MSC_NR_BUFFERS and
+ * \a CONFIG_UDI_MSC_PIPELINE_DEPTH settings to tune the pipeline.
+ *
+ * The following tests are run:
+ * - \c seq-read: 64 KiB reads from the start of the device
+ * - \c verify-crc32: a single #UDI_MSC_CMD_CRC32 command covering the
+ *   same blocks as \c seq-read, which is checked against the CRC-32 of
+ *   the data read by \c seq-read. Its rate can be compared to that of
+ *   \c seq-read to see how much faster the check is than a read-back.
+ * - \c seq-write: 64 KiB writes to the start of the device
+ * - \c random-read-4k: 4 KiB reads from random, aligned locations
+ * - \c random-write-4k: 4 KiB writes to random, aligned locations
+ *
+ * Each write is preceded by an untimed read of the same blocks, and
+ * writes back the data which was read, so the contents of the host
+ * file are left as they were. One line is printed on the debug console
+ * for each test:
+ *
+ * \code
+ * msc-bench <name> <commands> <bytes> <microseconds> <KB per second>
+ * \endcode
+ *
+ * \a KB per second is in units of 1000 bytes per second. The run ends
+ * with the line <tt>msc-bench done</tt>.
+ */
+
+#include <assert.h>
+#include <bitops.h>
+#include <board.h>
+#include <buffer.h>
+#include <byteorder.h>
+#include <crc32.h>
+#include <debug.h>
+#include <dmapool.h>
+#include <mainloop.h>
+#include <status_codes.h>
+#include <string.h>
+#include <util.h>
+#include <workqueue.h>
+
+#include <arch/host_clock.h>
+#include <block/device.h>
+#include <block/host_file.h>
+#include <clk/sys.h>
+#include <app/usb.h>
+#include <scsi/sbc_protocol.h>
+#include <usb/dev_mux.h>
+#include <usb/msc_protocol.h>
+#include <usb/request.h>
+#include <usb/udc.h>
+#include <usb/udi_msc_bulk.h>
+#include <usb/usb_protocol.h>
+
+//! Size of each command in the sequential benchmarks
+#define MSC_BENCH_SEQ_CHUNK		65536U
+//! Amount of data transferred by the sequential benchmarks
+#define MSC_BENCH_SEQ_BYTES		(16 * MSC_BENCH_SEQ_CHUNK)
+//! Size of each command in the random benchmarks
+#define MSC_BENCH_RANDOM_CHUNK		4096U
+//! Number of commands issued by the random benchmarks
+#define MSC_BENCH_RANDOM_ITERATIONS	64
+
+//! The benchmarks, in the order they are run
+enum msc_bench_test {
+	MSC_BENCH_SEQ_READ,
+	MSC_BENCH_CRC32,
+	MSC_BENCH_SEQ_WRITE,
+	MSC_BENCH_RANDOM_READ,
+	MSC_BENCH_RANDOM_WRITE,
+	MSC_BENCH_DONE,
+};
+
+//! Stage of the transfer which is currently in progress
+enum msc_bench_stage {
+	MSC_BENCH_STAGE_ATTACH,		//!< Waiting for the block device
+	MSC_BENCH_STAGE_ADDRESS,	//!< SET_ADDRESS
+	MSC_BENCH_STAGE_CONFIGURE,	//!< SET_CONFIGURATION
+	MSC_BENCH_STAGE_CBW,		//!< Sending a Command Block Wrapper
+	MSC_BENCH_STAGE_DATA,		//!< Moving the data of a command
+	MSC_BENCH_STAGE_CSW,		//!< Receiving a Command Status Wrapper
+};
+
+struct msc_bench {
+	struct workqueue_task	task;
+	struct udc		*udc;
+	struct block_device	*bdev;
+	struct host_udc_xfer	xfer;
+	struct usb_msc_cbw	cbw;
+	struct usb_msc_csw	csw;
+
+	enum msc_bench_test	test;
+	enum msc_bench_stage	stage;
+	uint32_t		tag;
+	uint32_t		seed;
+
+	//! Number of blocks available for the benchmarks
+	uint32_t		nr_blocks;
+	//! First block of the current command
+	uint32_t		lba;
+	//! Number of bytes moved by the current command
+	uint32_t		len;
+	//! Number of bytes of the device covered by the current command
+	uint32_t		covered;
+	//! True if the current command writes to the device
+	bool			write;
+	//! True if the current command counts towards the results
+	bool			timed;
+	//! Virtual time at which the current command was started
+	host_time_t		start;
+
+	//! Number of timed commands completed by the current test
+	unsigned int		commands;
+	//! Number of bytes moved by timed commands in the current test
+	unsigned long		bytes;
+	//! Virtual time spent in timed commands in the current test
+	unsigned long		elapsed;
+	//! CRC-32 of the data read by the seq-read test
+	uint32_t		crc;
+
+	uint8_t			data[MSC_BENCH_SEQ_CHUNK];
+};
+
+static struct msc_bench msc_bench_ctx;
+
+static const char *const msc_bench_name[] = {
+	[MSC_BENCH_SEQ_READ]		= "seq-read",
+	[MSC_BENCH_CRC32]		= "verify-crc32",
+	[MSC_BENCH_SEQ_WRITE]		= "seq-write",
+	[MSC_BENCH_RANDOM_READ]		= "random-read-4k",
+	[MSC_BENCH_RANDOM_WRITE]	= "random-write-4k",
+};
+
+static struct msc_bench *msc_bench_of(struct workqueue_task *task)
+{
+	return container_of(task, struct msc_bench, task);
+}
+
+static void msc_bench_xfer_done(struct udc *udc, struct host_udc_xfer *xfer)
+{
+	struct msc_bench	*bench = xfer->context;
+
+	workqueue_add_task(&main_workqueue, &bench->task);
+}
+
+static void msc_bench_submit(struct msc_bench *bench, uint8_t ep_addr,
+		void *data, size_t len)
+{
+	bench->xfer.data = data;
+	bench->xfer.len = len;
+	host_udc_submit(bench->udc, ep_addr, &bench->xfer);
+}
+
+static void msc_bench_send_cbw(struct msc_bench *bench, uint8_t opcode,
+		uint32_t lba, uint16_t nr_blocks)
+{
+	struct usb_msc_cbw	*cbw = &bench->cbw;
+
+	memset(cbw, 0, sizeof(*cbw));
+	cbw->dCBWSignature = cpu_to_le32(USB_CBW_SIGNATURE);
+	cbw->dCBWTag = cpu_to_le32(++bench->tag);
+	cbw->dCBWDataTransferLength = cpu_to_le32(bench->len);
+	cbw->bmCBWFlags = bench->write ? 0 : USB_CBW_DIRECTION_IN;
+	cbw->bCBWCBLength = 10;
+	cbw->CDB[0] = opcode;
+	cbw->CDB[2] = lba >> 24;
+	cbw->CDB[3] = lba >> 16;
+	cbw->CDB[4] = lba >> 8;
+	cbw->CDB[5] = lba;
+	cbw->CDB[7] = nr_blocks >> 8;
+	cbw->CDB[8] = nr_blocks;
+
+	bench->stage = MSC_BENCH_STAGE_CBW;
+	bench->start = host_clock_now();
+	msc_bench_submit(bench, USB_DIR_OUT | APP_UDI_MSC_BULK_OUT_EP,
+			cbw, sizeof(*cbw));
+}
+
+/**
+ * \brief Start a READ(10) or WRITE(10) command
+ *
+ * The data is always moved through \a bench->data, so the write tests
+ * put back whatever the untimed read issued just before found there.
+ */
+static void msc_bench_start_cmd(struct msc_bench *bench, uint32_t lba,
+		uint32_t len, bool write, bool timed)
+{
+	bench->lba = lba;
+	bench->len = len;
+	bench->covered = len;
+	bench->write = write;
+	bench->timed = timed;
+
+	msc_bench_send_cbw(bench, write ? SCSI_CMD_WRITE10 : SCSI_CMD_READ10,
+			lba, len / CONFIG_BLOCK_FIXED_BLOCK_SIZE);
+}
+
+/**
+ * \brief Ask the device for the CRC-32 of the first \a len bytes
+ */
+static void msc_bench_start_crc32(struct msc_bench *bench, uint32_t len)
+{
+	bench->lba = 0;
+	bench->len = sizeof(be32_t);
+	bench->covered = len;
+	bench->write = false;
+	bench->timed = true;
+
+	msc_bench_send_cbw(bench, UDI_MSC_CMD_CRC32, 0,
+			len / CONFIG_BLOCK_FIXED_BLOCK_SIZE);
+}
+
+static uint32_t msc_bench_random_lba(struct msc_bench *bench)
+{
+	uint32_t	nr_chunks;
+
+	nr_chunks = bench->nr_blocks
+		/ (MSC_BENCH_RANDOM_CHUNK / CONFIG_BLOCK_FIXED_BLOCK_SIZE);
+	bench->seed = bench->seed * 1103515245U + 12345U;
+
+	return ((bench->seed >> 8) % nr_chunks)
+		* (MSC_BENCH_RANDOM_CHUNK / CONFIG_BLOCK_FIXED_BLOCK_SIZE);
+}
+
+/**
+ * \brief Start the next command of the current test
+ *
+ * \retval true A command was started
+ * \retval false The current test is complete
+ */
+static bool msc_bench_next_cmd(struct msc_bench *bench)
+{
+	uint32_t	seq_bytes;
+	uint32_t	lba;
+
+	seq_bytes = min_u(MSC_BENCH_SEQ_BYTES,
+			bench->nr_blocks * CONFIG_BLOCK_FIXED_BLOCK_SIZE);
+	seq_bytes -= seq_bytes % MSC_BENCH_SEQ_CHUNK;
+
+	switch (bench->test) {
+	case MSC_BENCH_SEQ_READ:
+		if (bench->bytes >= seq_bytes)
+			return false;
+		lba = bench->bytes / CONFIG_BLOCK_FIXED_BLOCK_SIZE;
+		msc_bench_start_cmd(bench, lba, MSC_BENCH_SEQ_CHUNK,
+				false, true);
+		return true;
+
+	case MSC_BENCH_CRC32:
+		if (bench->commands)
+			return false;
+		msc_bench_start_crc32(bench, seq_bytes);
+		return true;
+
+	case MSC_BENCH_SEQ_WRITE:
+		if (bench->write || bench->timed) {
+			if (bench->bytes >= seq_bytes)
+				return false;
+			lba = bench->bytes / CONFIG_BLOCK_FIXED_BLOCK_SIZE;
+			msc_bench_start_cmd(bench, lba, MSC_BENCH_SEQ_CHUNK,
+					false, false);
+		} else {
+			msc_bench_start_cmd(bench, bench->lba,
+					MSC_BENCH_SEQ_CHUNK, true, true);
+		}
+		return true;
+
+	case MSC_BENCH_RANDOM_READ:
+		if (bench->commands >= MSC_BENCH_RANDOM_ITERATIONS)
+			return false;
+		msc_bench_start_cmd(bench, msc_bench_random_lba(bench),
+				MSC_BENCH_RANDOM_CHUNK, false, true);
+		return true;
+
+	case MSC_BENCH_RANDOM_WRITE:
+		if (bench->write || bench->timed) {
+			if (bench->commands >= MSC_BENCH_RANDOM_ITERATIONS)
+				return false;
+			msc_bench_start_cmd(bench,
+					msc_bench_random_lba(bench),
+					MSC_BENCH_RANDOM_CHUNK, false, false);
+		} else {
+			msc_bench_start_cmd(bench, bench->lba,
+					MSC_BENCH_RANDOM_CHUNK, true, true);
+		}
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+static void msc_bench_report(struct msc_bench *bench)
+{
+	unsigned long	rate = 0;
+
+	if (bench->elapsed)
+		rate = bench->bytes * 1000UL / bench->elapsed;
+
+	dbg_info("msc-bench %s %u %lu %lu %lu\n", msc_bench_name[bench->test],
+			bench->commands, bench->bytes, bench->elapsed, rate);
+}
+
+/**
+ * \brief Run the tests, starting with \a bench->test, until one of them
+ * starts a command.
+ */
+static void msc_bench_run(struct msc_bench *bench)
+{
+	while (bench->test < MSC_BENCH_DONE) {
+		if (msc_bench_next_cmd(bench))
+			return;
+
+		msc_bench_report(bench);
+		bench->test++;
+		bench->commands = 0;
+		bench->bytes = 0;
+		bench->elapsed = 0;
+		/* Start the write tests with the untimed read */
+		bench->write = false;
+		bench->timed = true;
+		bench->seed = 1;
+	}
+
+	dbg_info("msc-bench done\n");
+}
+
+static void msc_bench_fail(struct msc_bench *bench, const char *what)
+{
+	dbg_error("msc-bench %s failed: %s (status %d)\n",
+			msc_bench_name[bench->test], what,
+			bench->xfer.status);
+	bench->test = MSC_BENCH_DONE;
+}
+
+/**
+ * \brief Send a standard device request without a data stage
+ */
+static void msc_bench_control(struct msc_bench *bench,
+		enum msc_bench_stage stage, uint8_t request, uint16_t value)
+{
+	static struct usb_setup_req	setup;
+
+	setup.bmRequestType = USB_DIR_OUT | USB_REQTYPE_STANDARD_MASK
+		| USB_RECIP_DEVICE_MASK;
+	setup.bRequest = request;
+	setup.wValue = cpu_to_le16(value);
+	setup.wIndex = LE16(0);
+	setup.wLength = LE16(0);
+
+	bench->xfer.data = NULL;
+	bench->xfer.len = 0;
+	bench->stage = stage;
+	host_udc_control(bench->udc, &setup, &bench->xfer);
+}
+
+static void msc_bench_worker(struct workqueue_task *task)
+{
+	struct msc_bench	*bench = msc_bench_of(task);
+	struct usb_msc_csw	*csw = &bench->csw;
+
+	switch (bench->stage) {
+	case MSC_BENCH_STAGE_ATTACH:
+		if (!test_bit(BDEV_PRESENT, &bench->bdev->flags)) {
+			dbg_info("msc-bench skipped: no block device\n");
+			return;
+		}
+		bench->nr_blocks = bench->bdev->nr_blocks;
+		udc_attach(bench->udc);
+		msc_bench_control(bench, MSC_BENCH_STAGE_ADDRESS,
+				USB_REQ_SET_ADDRESS, 1);
+		break;
+
+	case MSC_BENCH_STAGE_ADDRESS:
+		if (bench->xfer.status != STATUS_OK) {
+			msc_bench_fail(bench, "SET_ADDRESS");
+			return;
+		}
+		msc_bench_control(bench, MSC_BENCH_STAGE_CONFIGURE,
+				USB_REQ_SET_CONFIGURATION, 1);
+		break;
+
+	case MSC_BENCH_STAGE_CONFIGURE:
+		if (bench->xfer.status != STATUS_OK) {
+			msc_bench_fail(bench, "SET_CONFIGURATION");
+			return;
+		}
+		msc_bench_run(bench);
+		break;
+
+	case MSC_BENCH_STAGE_CBW:
+		if (bench->xfer.status != STATUS_OK) {
+			msc_bench_fail(bench, "CBW");
+			return;
+		}
+		bench->stage = MSC_BENCH_STAGE_DATA;
+		msc_bench_submit(bench, bench->write
+				? USB_DIR_OUT | APP_UDI_MSC_BULK_OUT_EP
+				: USB_DIR_IN | APP_UDI_MSC_BULK_IN_EP,
+				bench->data, bench->len);
+		break;
+
+	case MSC_BENCH_STAGE_DATA:
+		if (bench->xfer.status != STATUS_OK
+				|| bench->xfer.actual != bench->len) {
+			msc_bench_fail(bench, "data");
+			return;
+		}
+		bench->stage = MSC_BENCH_STAGE_CSW;
+		msc_bench_submit(bench, USB_DIR_IN | APP_UDI_MSC_BULK_IN_EP,
+				csw, sizeof(*csw));
+		break;
+
+	case MSC_BENCH_STAGE_CSW:
+		if (bench->xfer.status != STATUS_OK
+				|| bench->xfer.actual != sizeof(*csw)
+				|| csw->dCSWSignature
+					!= cpu_to_le32(USB_CSW_SIGNATURE)
+				|| le32_to_cpu(csw->dCSWTag) != bench->tag
+				|| csw->bCSWStatus != USB_CSW_STATUS_PASS) {
+			msc_bench_fail(bench, "CSW");
+			return;
+		}
+		if (bench->test == MSC_BENCH_SEQ_READ)
+			bench->crc = crc32_update(bench->crc, bench->data,
+					bench->len);
+		if (bench->test == MSC_BENCH_CRC32
+				&& be32_to_cpu(*(be32_t *)bench->data)
+					!= bench->crc) {
+			msc_bench_fail(bench, "CRC mismatch");
+			return;
+		}
+		if (bench->timed) {
+			bench->commands++;
+			bench->bytes += bench->covered;
+			bench->elapsed += host_clock_now() - bench->start;
+		}
+		msc_bench_run(bench);
+		break;
+	}
+}
+
+int main(void)
+{
+	struct msc_bench	*bench = &msc_bench_ctx;
+	struct udm_config	*config;
+
+	cpu_irq_enable();
+	sysclk_init();
+	dbg_init();
+	board_init();
+	workqueue_init(&main_workqueue);
+	dma_pool_init();
+	buffer_pool_init();
+	usb_init();
+
+	bench->udc = udc_init();
+	if (!bench->udc) {
+		dbg_panic("UDC initialization failed\n");
+		return 1;
+	}
+
+	bench->xfer.done = msc_bench_xfer_done;
+	bench->xfer.context = bench;
+	bench->stage = MSC_BENCH_STAGE_ATTACH;
+	bench->timed = true;
+	bench->seed = 1;
+	workqueue_task_init(&bench->task, msc_bench_worker);
+
+	dbg_info("msc-bench start %u buffers of %u bytes, depth %u\n",
+			CONFIG_UDI_MSC_NR_BUFFERS, CONFIG_UDI_MSC_BUFFER_SIZE,
+			CONFIG_UDI_MSC_PIPELINE_DEPTH);
+
+	bench->bdev = host_file_blkdev_init(NULL, &bench->task);
+	if (!bench->bdev) {
+		dbg_panic("Block device initialization failed\n");
+		return 1;
+	}
+
+	config = udm_create_config(1, 1);
+	udm_config_set_bus_powered(config);
+	udm_config_set_max_power(config, 100);
+	udm_config_add_interface(config, udi_msc_create_iface(bench->bdev));
+
+	mainloop_run(&main_workqueue);
+}
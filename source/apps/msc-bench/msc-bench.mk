@@ -0,0 +1,7 @@
+cflags-gnu-y	+= -std=gnu99
+
+incdir-y	+= $(src)/apps/msc-bench/include
+src-y		+= apps/$(app)/main.c
+
+app-hdr-y	+= dmapool.h usb.h
+hdr-y		+= $(addprefix apps/msc-bench/include/app/,$(app-hdr-y))
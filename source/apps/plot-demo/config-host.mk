@@ -0,0 +1,22 @@
+include $(src)/board/host/config.mk
+include $(src)/apps/plot-demo/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+
+CONFIG_SOFTIRQ=y
+
+# The C library owns the heap on the host
+CONFIG_MALLOC_SIMPLE=n
+
+CONFIG_GFX_WIN_USE_TOUCH=y
+
+CONFIG_TOUCH_RESISTIVE=y
+CONFIG_TOUCH_PORT_IRQ_ID=1
+CONFIG_TOUCH_PORT_INTLVL=0
+CONFIG_TOUCH_ADC_IRQ_ID=2
+CONFIG_TOUCH_ADC_INTLVL=0
+CONFIG_TOUCH_OVERSAMPLING=2
+CONFIG_TOUCH_FILTER=y
+
+CONFIG_HUGEMEM=y
+CONFIG_EXTRAM_SDRAM=y
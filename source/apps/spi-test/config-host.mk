@@ -0,0 +1,24 @@
+include $(src)/board/host/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+
+CONFIG_MAINLOOP=y
+
+CONFIG_SPI=y
+CONFIG_SPI0=y
+CONFIG_SPI_MASTER=y
+CONFIG_SPI_BUF_LIST_API=y
+# Set to n to test the polled driver on the same simulated module
+CONFIG_SPI_MASTER_INT=y
+
+CONFIG_SLEEPMGR=y
+
+# Results are printed on the debug console
+CONFIG_STREAM=y
+CONFIG_SERIAL_UART=y
+CONFIG_UART_CTRL=y
+CONFIG_UART_BAUD_RATE=115200
+CONFIG_DEBUG_CONSOLE=y
+CONFIG_DEBUG_UART=y
+CONFIG_DEBUG_UART_ID=0
+CONFIG_DEBUG_LEVEL=DEBUG_INFO
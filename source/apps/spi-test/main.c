@@ -0,0 +1,391 @@
+/**
+ * \file
+ *
+ * \brief SPI master test on the simulated SPI module
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * \page spi_test SPI Master Test
+ *
+ * This application tests the ATxmega \ref spi_group "SPI master driver"
+ * on the host, where it runs on top of the
+ * \ref spi_host_section "simulated SPI module". A slave connected to the
+ * simulated bus records each byte it receives, and answers with a known
+ * sequence, so both directions of each transfer can be checked.
+ *
+ * With \a CONFIG_SPI_MASTER_INT, which the host configuration sets, this
+ * tests the interrupt driven transfers. Otherwise, the polled driver is
+ * tested against the same model.
+ *
+ * The following transfers are made, each on a separate bus request with
+ * the slave selected:
+ * - \c write, \c read and \c exchange of a single byte, which completes
+ *   in the first interrupt, and of #SPI_TEST_SIZE bytes
+ * - \c write-buf-list, \c read-buf-list and \c exchange-buf-list of
+ *   #SPI_TEST_SIZE bytes split into buffers of different sizes, if
+ *   \a CONFIG_SPI_BUF_LIST_API is defined
+ *
+ * A transfer passes if it completes with #STATUS_OK, the slave received
+ * exactly the bytes written, or zeros for a read, while it was selected,
+ * the data read is the answer of the slave, and no byte was written to
+ * the data register while the module was busy. One line is printed on
+ * the debug console for each transfer:
+ *
+ * \code
+ * spi-test <name> ok
+ * spi-test <name> FAILED <reason>
+ * \endcode
+ *
+ * The run ends with the line <tt>spi-test done &lt;failures&gt;</tt>, and
+ * the application exits with a failure status if any transfer failed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <board.h>
+#include <buffer.h>
+#include <debug.h>
+#include <gpio.h>
+#include <mainloop.h>
+#include <slist.h>
+#include <spi.h>
+#include <status_codes.h>
+#include <util.h>
+#include <workqueue.h>
+
+#include <board/spi.h>
+#include <clk/sys.h>
+
+//! SPI module under test.
+#define SPI_TEST_ID             0
+//! Number of bytes moved by the transfers which are not single bytes.
+#define SPI_TEST_SIZE           64
+//! Number of buffers in the buffer lists.
+#define SPI_TEST_NR_BUFS        3
+
+DECLARE_SPI_MASTER(SPI_TEST_ID, spi_test_master);
+DECLARE_SPI_DEVICE(SPI_TEST_ID, spi_test_device);
+
+//! Direction of a test transfer.
+enum spi_test_op {
+	SPI_TEST_WRITE,
+	SPI_TEST_READ,
+	SPI_TEST_EXCHANGE,
+};
+
+//! Steps of each test transfer.
+enum spi_test_state {
+	//! Request the bus.
+	SPI_TEST_REQUEST,
+	//! Select the slave and start the transfer.
+	SPI_TEST_START,
+	//! Deselect the slave and check the result.
+	SPI_TEST_CHECK,
+};
+
+//! A test transfer.
+struct spi_test_case {
+	//! Name printed with the result.
+	const char              *name;
+	//! Direction of the transfer.
+	enum spi_test_op        op;
+	//! Number of bytes to move.
+	uint8_t                 len;
+	//! True to use the buffer list API.
+	bool                    buf_list;
+};
+
+static const struct spi_test_case spi_test_cases[] = {
+	{ "write-1",            SPI_TEST_WRITE,    1,             false },
+	{ "read-1",             SPI_TEST_READ,     1,             false },
+	{ "exchange-1",         SPI_TEST_EXCHANGE, 1,             false },
+	{ "write",              SPI_TEST_WRITE,    SPI_TEST_SIZE, false },
+	{ "read",               SPI_TEST_READ,     SPI_TEST_SIZE, false },
+	{ "exchange",           SPI_TEST_EXCHANGE, SPI_TEST_SIZE, false },
+#ifdef CONFIG_SPI_BUF_LIST_API
+	{ "write-buf-list",     SPI_TEST_WRITE,    SPI_TEST_SIZE, true },
+	{ "read-buf-list",      SPI_TEST_READ,     SPI_TEST_SIZE, true },
+	{ "exchange-buf-list",  SPI_TEST_EXCHANGE, SPI_TEST_SIZE, true },
+#endif
+};
+
+//! Sizes of the buffers making up the buffer lists.
+static const uint8_t spi_test_buf_sizes[SPI_TEST_NR_BUFS] = {
+	1, 23, SPI_TEST_SIZE - 1 - 23,
+};
+
+//! State of the test run.
+struct spi_test {
+	//! Task running the test steps, also used to request the bus.
+	struct workqueue_task   task;
+	//! SPI master under test.
+	struct spi_master       *master;
+	//! The slave on the simulated bus.
+	struct spi_device       *device;
+	//! Index of the current transfer in #spi_test_cases.
+	uint8_t                 index;
+	//! Next step of the current transfer.
+	enum spi_test_state     state;
+	//! Number of failed transfers.
+	unsigned int            failures;
+	//! Data written.
+	uint8_t                 tx[SPI_TEST_SIZE];
+	//! Data read.
+	uint8_t                 rx[SPI_TEST_SIZE];
+#ifdef CONFIG_SPI_BUF_LIST_API
+	//! Buffers covering \a tx.
+	struct buffer           tx_bufs[SPI_TEST_NR_BUFS];
+	//! Buffers covering \a rx.
+	struct buffer           rx_bufs[SPI_TEST_NR_BUFS];
+	//! List of \a tx_bufs.
+	struct slist            tx_list;
+	//! List of \a rx_bufs.
+	struct slist            rx_list;
+#endif
+};
+
+static struct spi_test spi_test_ctx;
+
+//! Bytes received by the slave during the current transfer.
+static uint8_t spi_test_slave_data[SPI_TEST_SIZE];
+//! Number of bytes sent to the slave during the current transfer.
+static uint16_t spi_test_slave_count;
+//! Number of bytes sent on the bus while the slave was not selected.
+static uint16_t spi_test_slave_unselected;
+
+//! Byte number \a i written by the test.
+static uint8_t spi_test_tx_byte(uint8_t i)
+{
+	return i * 3 + 1;
+}
+
+//! Byte number \a i sent back by the slave.
+static uint8_t spi_test_rx_byte(uint8_t i)
+{
+	return 0xa5 ^ (i * 7);
+}
+
+//! Slave on the simulated bus, see host_spi_slave_t.
+static uint8_t spi_test_slave(uint8_t tx_byte)
+{
+	if (gpio_get_value(BOARD_SPI_SIM_SS)) {
+		spi_test_slave_unselected++;
+		return 0xff;
+	}
+
+	if (spi_test_slave_count < ARRAY_LEN(spi_test_slave_data))
+		spi_test_slave_data[spi_test_slave_count] = tx_byte;
+
+	return spi_test_rx_byte(spi_test_slave_count++);
+}
+
+#ifdef CONFIG_SPI_BUF_LIST_API
+//! Split \a tx and \a rx into the buffer lists.
+static void spi_test_init_buf_lists(struct spi_test *test)
+{
+	uint8_t         offset = 0;
+	uint8_t         i;
+
+	slist_init(&test->tx_list);
+	slist_init(&test->rx_list);
+
+	for (i = 0; i < SPI_TEST_NR_BUFS; i++) {
+		buffer_init_tx(&test->tx_bufs[i], &test->tx[offset],
+				spi_test_buf_sizes[i]);
+		buffer_init_rx(&test->rx_bufs[i], &test->rx[offset],
+				spi_test_buf_sizes[i]);
+		slist_insert_tail(&test->tx_list, &test->tx_bufs[i].node);
+		slist_insert_tail(&test->rx_list, &test->rx_bufs[i].node);
+		offset += spi_test_buf_sizes[i];
+	}
+}
+#endif
+
+//! Start the transfer \a tc.
+static void spi_test_start(struct spi_test *test,
+		const struct spi_test_case *tc)
+{
+	uint8_t         i;
+
+	for (i = 0; i < tc->len; i++)
+		test->tx[i] = spi_test_tx_byte(i);
+	memset(test->rx, 0, sizeof(test->rx));
+	memset(spi_test_slave_data, 0, sizeof(spi_test_slave_data));
+	spi_test_slave_count = 0;
+	spi_test_slave_unselected = 0;
+	test->master->status = OPERATION_IN_PROGRESS;
+
+	spi_select_device(SPI_TEST_ID, test->master, test->device);
+
+#ifdef CONFIG_SPI_BUF_LIST_API
+	if (tc->buf_list) {
+		spi_test_init_buf_lists(test);
+
+		switch (tc->op) {
+		case SPI_TEST_WRITE:
+			spi_write_buf_list(SPI_TEST_ID, test->master,
+					&test->tx_list);
+			break;
+		case SPI_TEST_READ:
+			spi_read_buf_list(SPI_TEST_ID, test->master,
+					&test->rx_list);
+			break;
+		case SPI_TEST_EXCHANGE:
+			spi_exchange_buf_list(SPI_TEST_ID, test->master,
+					&test->tx_list, &test->rx_list);
+			break;
+		}
+		return;
+	}
+#endif
+
+	switch (tc->op) {
+	case SPI_TEST_WRITE:
+		spi_write(SPI_TEST_ID, test->master, test->tx, tc->len);
+		break;
+	case SPI_TEST_READ:
+		spi_read(SPI_TEST_ID, test->master, test->rx, tc->len);
+		break;
+	case SPI_TEST_EXCHANGE:
+		spi_exchange(SPI_TEST_ID, test->master, test->tx, test->rx,
+				tc->len);
+		break;
+	}
+}
+
+/**
+ * \brief Check the result of the transfer \a tc
+ *
+ * \return NULL if the transfer passed, or the reason why it failed.
+ */
+static const char *spi_test_check(struct spi_test *test,
+		const struct spi_test_case *tc)
+{
+	bool            written = tc->op != SPI_TEST_READ;
+	bool            read = tc->op != SPI_TEST_WRITE;
+	uint8_t         i;
+
+	if (test->master->status != STATUS_OK)
+		return "status";
+	if (spi_test_slave_unselected)
+		return "unselected";
+	if (spi_test_slave_count != tc->len)
+		return "length";
+	if (host_spi_get_collisions(SPI_TEST_ID))
+		return "collision";
+
+	for (i = 0; i < tc->len; i++) {
+		if (spi_test_slave_data[i] != (written
+					? spi_test_tx_byte(i) : 0))
+			return "tx-data";
+		if (test->rx[i] != (read ? spi_test_rx_byte(i) : 0))
+			return "rx-data";
+	}
+
+	return NULL;
+}
+
+static void spi_test_worker(struct workqueue_task *task)
+{
+	struct spi_test                 *test;
+	const struct spi_test_case      *tc;
+	const char                      *reason;
+
+	test = container_of(task, struct spi_test, task);
+
+	if (test->index == ARRAY_LEN(spi_test_cases)) {
+		dbg_info("spi-test done %u\n", test->failures);
+		exit(test->failures ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
+	tc = &spi_test_cases[test->index];
+
+	switch (test->state) {
+	case SPI_TEST_REQUEST:
+		test->state = SPI_TEST_START;
+		spi_request_bus(test->master, task);
+		break;
+
+	case SPI_TEST_START:
+		test->state = SPI_TEST_CHECK;
+		spi_test_start(test, tc);
+		break;
+
+	case SPI_TEST_CHECK:
+		spi_deselect_device(SPI_TEST_ID, test->master, test->device);
+
+		reason = spi_test_check(test, tc);
+		if (reason) {
+			test->failures++;
+			dbg_info("spi-test %s FAILED %s\n", tc->name, reason);
+		} else {
+			dbg_info("spi-test %s ok\n", tc->name);
+		}
+
+		test->index++;
+		test->state = SPI_TEST_REQUEST;
+		spi_release_bus(test->master);
+		workqueue_add_task(&main_workqueue, task);
+		break;
+	}
+}
+
+int main(void)
+{
+	struct spi_test         *test = &spi_test_ctx;
+
+	cpu_irq_enable();
+	sysclk_init();
+	dbg_init();
+	board_init();
+	workqueue_init(&main_workqueue);
+
+	test->master = spi_master_get_base(SPI_TEST_ID, &spi_test_master);
+	test->device = spi_device_get_base(SPI_TEST_ID, &spi_test_device);
+
+	spi_enable(SPI_TEST_ID);
+	spi_master_init(SPI_TEST_ID, test->master);
+	spi_master_setup_device(SPI_TEST_ID, test->master, test->device,
+			SPI_MODE_0, CONFIG_CPU_HZ, BOARD_SPI_SIM_SS);
+	host_spi_set_slave(SPI_TEST_ID, spi_test_slave);
+
+	dbg_info("spi-test start\n");
+
+	workqueue_task_init(&test->task, spi_test_worker);
+	workqueue_add_task(&main_workqueue, &test->task);
+
+	mainloop_run(&main_workqueue);
+}
@@ -0,0 +1,13 @@
+include $(src)/board/xplain/config.mk
+
+CONFIG_CPU_HZ=2000000UL
+
+# Results are printed on the debug console
+CONFIG_STREAM=y
+CONFIG_SERIAL_UART=y
+CONFIG_UART_CTRL=y
+CONFIG_UART_BAUD_RATE=9600
+CONFIG_DEBUG_CONSOLE=y
+CONFIG_DEBUG_UART=y
+CONFIG_DEBUG_UART_ID=0
+CONFIG_DEBUG_LEVEL=DEBUG_INFO
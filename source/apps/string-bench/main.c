@@ -0,0 +1,237 @@
+/**
+ * \file
+ *
+ * \brief String operation benchmark
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+/**
+ * \page string_bench String Operation Benchmark
+ *
+ * This application measures memcpy(), memset(), strlen() and strcmp()
+ * for a range of sizes and alignments, both the architecture version
+ * selected by \c arch/string.h and the generic C version. Timer/Counter
+ * 0 on port C runs at the CPU clock, so the measurements are in CPU
+ * cycles regardless of \a CONFIG_CPU_HZ. They do not depend on anything
+ * else than the cycle count either, so the same image can be run in a
+ * cycle-accurate simulator which models the TC and USART.
+ *
+ * One line is printed on the debug console for each measurement:
+ *
+ * \code
+ * bench <function> <impl> <size> <align> <cycles> <cycles per byte x 100>
+ * \endcode
+ *
+ * The call overhead is included in \a cycles, but the cost of reading
+ * the counter is not.
+ */
+
+#include <assert.h>
+#include <board.h>
+#include <debug.h>
+#include <interrupt.h>
+#include <stdint.h>
+#include <string.h>
+#include <util.h>
+#include <clk/sys.h>
+#include <chip/memory-map.h>
+#include <generic/string.h>
+#include <regs/xmega_tc.h>
+
+//! Timer/Counter used for cycle counting.
+#define BENCH_TC                ((void *)TC0_BASE)
+//! Largest size to measure.
+#define BENCH_MAX_SIZE          1024
+//! Largest misalignment to measure.
+#define BENCH_MAX_ALIGN         3
+
+enum bench_func {
+	BENCH_MEMCPY,
+	BENCH_MEMSET,
+	BENCH_STRLEN,
+	BENCH_STRCMP,
+	BENCH_NR_FUNCS,
+};
+
+static const char *const bench_func_name[BENCH_NR_FUNCS] = {
+	[BENCH_MEMCPY]  = "memcpy",
+	[BENCH_MEMSET]  = "memset",
+	[BENCH_STRLEN]  = "strlen",
+	[BENCH_STRCMP]  = "strcmp",
+};
+
+static const uint16_t bench_sizes[] = {
+	1, 2, 3, 4, 7, 8, 15, 16, 31, 32, 64, 128, 256, 1024,
+};
+
+static uint8_t bench_src[BENCH_MAX_SIZE + BENCH_MAX_ALIGN + 1];
+static uint8_t bench_dst[BENCH_MAX_SIZE + BENCH_MAX_ALIGN + 1];
+
+/*
+ * strlen() and strcmp() are pure, so the compiler would remove the
+ * calls if the results were not used.
+ */
+static volatile int bench_result;
+
+//! Cycles spent reading the counter twice.
+static uint16_t bench_overhead;
+
+static inline uint16_t bench_get_cycles(void)
+{
+	return tc_read_reg16(BENCH_TC, CNT);
+}
+
+/**
+ * \brief Run one function once
+ *
+ * \param func    Function to run.
+ * \param generic True to run the generic C version.
+ * \param dst     Destination buffer.
+ * \param src     Source buffer, a string of \a size characters.
+ * \param size    Number of bytes to operate on.
+ *
+ * \return Number of cycles spent.
+ */
+static uint16_t bench_run(enum bench_func func, bool generic,
+		uint8_t *dst, uint8_t *src, uint16_t size)
+{
+	uint16_t        start;
+	uint16_t        end;
+
+	switch (func) {
+	case BENCH_MEMCPY:
+		start = bench_get_cycles();
+		if (generic)
+			generic_memcpy(dst, src, size);
+		else
+			memcpy(dst, src, size);
+		end = bench_get_cycles();
+		break;
+
+	case BENCH_MEMSET:
+		start = bench_get_cycles();
+		if (generic)
+			generic_memset(dst, 0x55, size);
+		else
+			memset(dst, 0x55, size);
+		end = bench_get_cycles();
+		break;
+
+	case BENCH_STRLEN:
+		start = bench_get_cycles();
+		if (generic)
+			bench_result = generic_strlen((const char *)src);
+		else
+			bench_result = strlen((const char *)src);
+		end = bench_get_cycles();
+		break;
+
+	case BENCH_STRCMP:
+		start = bench_get_cycles();
+		if (generic)
+			bench_result = generic_strcmp((const char *)src,
+					(const char *)dst);
+		else
+			bench_result = strcmp((const char *)src,
+					(const char *)dst);
+		end = bench_get_cycles();
+		break;
+
+	default:
+		unhandled_case(func);
+		return 0;
+	}
+
+	return end - start - bench_overhead;
+}
+
+static void bench_measure(enum bench_func func, bool generic,
+		uint16_t size, uint8_t align)
+{
+	irqflags_t      iflags;
+	uint8_t         *src = bench_src + align;
+	uint8_t         *dst = bench_dst + align;
+	uint16_t        cycles;
+
+	// Equal strings of size characters, for strlen() and strcmp().
+	generic_memset(src, 'a', size);
+	src[size] = '\0';
+	generic_memset(dst, 'a', size);
+	dst[size] = '\0';
+
+	iflags = cpu_irq_save();
+	cycles = bench_run(func, generic, dst, src, size);
+	cpu_irq_restore(iflags);
+
+	dbg_info("bench %s %s %u %u %u %lu\n", bench_func_name[func],
+			generic ? "generic" : "arch", size, align, cycles,
+			(uint32_t)cycles * 100 / size);
+}
+
+int main(void)
+{
+	uint16_t        start;
+	uint8_t         func;
+	uint8_t         i;
+	uint8_t         align;
+
+	sysclk_init();
+	dbg_init();
+	board_init();
+
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_TC0);
+	tc_write_reg16(BENCH_TC, PER, 0xffff);
+	tc_write_reg8(BENCH_TC, CTRLA, TC_BF(CTRLA_CLKSEL, TC_CLKSEL_DIV1));
+
+	start = bench_get_cycles();
+	bench_overhead = bench_get_cycles() - start;
+
+	dbg_info("bench start overhead %u\n", bench_overhead);
+
+	for (func = 0; func < BENCH_NR_FUNCS; func++) {
+		for (i = 0; i < ARRAY_LEN(bench_sizes); i++) {
+			for (align = 0; align <= BENCH_MAX_ALIGN; align++) {
+				bench_measure(func, false, bench_sizes[i],
+						align);
+				bench_measure(func, true, bench_sizes[i],
+						align);
+			}
+		}
+	}
+
+	dbg_info("bench done\n");
+
+	for (;;)
+		;
+}
@@ -0,0 +1,3 @@
+cflags-gnu-y	+= -std=gnu99
+
+src-y		+= apps/$(app)/main.c
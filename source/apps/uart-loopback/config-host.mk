@@ -0,0 +1,8 @@
+include $(src)/board/host/config.mk
+
+CONFIG_CPU_HZ=32000000UL
+
+CONFIG_SERIAL_UART=y
+CONFIG_UART_CTRL=y
+CONFIG_UART_BAUD_RATE=9600
+CONFIG_UART_ID=0
@@ -8,7 +8,11 @@ CONFIG_NR_BUFFERS=4
 CONFIG_DMAPOOL_SMALL_OBJ_SIZE=32
 CONFIG_DMAPOOL_NR_SMALL_OBJS=16
 CONFIG_DMAPOOL_LARGE_OBJ_SIZE=512
-CONFIG_DMAPOOL_NR_LARGE_OBJS=4
+CONFIG_DMAPOOL_NR_LARGE_OBJS=2
+
+CONFIG_UDI_MSC_BUFFER_SIZE=512
+CONFIG_UDI_MSC_NR_BUFFERS=2
+CONFIG_UDI_MSC_PIPELINE_DEPTH=2
 
 CONFIG_AT90USB=y
 CONFIG_AT90USB_UDC=y
@@ -1,6 +1,7 @@
 CONFIG_BLOCK=y
 CONFIG_BLOCK_FIXED_BLOCK_SIZE=512
 CONFIG_BUFFER=y
+CONFIG_CRC32=y
 CONFIG_DMAPOOL=y
 CONFIG_DMAPOOL_GENERIC_POOLS=y
 CONFIG_MAINLOOP=y
@@ -14,5 +15,6 @@ CONFIG_USB_DEV_MUX=y
 CONFIG_UDC=y
 CONFIG_UDI_MSC_BULK=y
 CONFIG_UDI_MSC_REMOVABLE=y
+CONFIG_UDI_MSC_CRC32=y
 
 config_mk	+= $(appsrc)/config.mk
@@ -67,7 +67,7 @@
 #define intc_priv_data_size(id)						\
 	intc_priv_data_sym_str(id) ", . - " intc_priv_data_sym_str(id)
 
-#define INTC_DEFINE_HANDLER(id, handler, level)				\
+#define INTC_PRIV_DEFINE_HANDLER(id, handler, level)			\
 	extern void intc_priv_entry_sym(id)(void);			\
 	extern void *intc_priv_data_sym(id);				\
 	static void __used intc_priv_dummy_ref(id)(void)		\
@@ -95,7 +95,7 @@
 
 #elif defined(__ICCAVR32__)
 
-#define INTC_DEFINE_HANDLER(id, handler, level)				\
+#define INTC_PRIV_DEFINE_HANDLER(id, handler, level)			\
 	extern void *intc_priv_data_sym(id);				\
 	__interrupt void intc_priv_entry_sym(id)(void)			\
 	{								\
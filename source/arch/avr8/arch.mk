@@ -89,3 +89,5 @@ hdr-$(CONFIG_SETJMP)    += arch/avr8/include/arch/setjmp.h
 hdr-$(CONFIG_SOFTIRQ)   += arch/avr8/include/arch/softirq.h
 hdr-y                   += arch/avr8/include/arch/stdint.h
 hdr-y                   += arch/avr8/include/arch/string.h
+
+include $(src)/arch/avr8/string/subdir.mk
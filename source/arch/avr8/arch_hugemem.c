@@ -38,8 +38,18 @@
 #include <hugemem.h>
 #include <assert.h>
 
+#ifdef CONFIG_HUGEMEM_DMA
+# include <cpu/hugemem_dma.h>
+#endif
 
 #if defined(CONFIG_HAVE_HUGEMEM) || defined(__DOXYGEN__)
+
+/**
+ * \internal
+ * \brief Largest number of bytes moved by one low-level block operation
+ */
+#define HUGEMEM_PRIV_MAX_CHUNK          0x8000UL
+
 # if defined(__GNUC__) || defined(__DOXYGEN__)
 uint_fast16_t hugemem_read16(const hugemem_ptr_t from)
 {
@@ -79,26 +89,52 @@ uint_fast32_t hugemem_read32(const hugemem_ptr_t from)
 	return value;
 }
 
-void hugemem_read_block(void *to, const hugemem_ptr_t from, size_t size)
-{
-	// Ensure that the address range to copy to is within 64 kB boundary.
-	assert(((uint32_t)to + size) <= 0x10000);
+/**
+ * \internal
+ * \brief Inline assembly loop repeating \a move_byte for each byte
+ *
+ * The byte count must be operand 1, and be non-zero. The odd bytes are
+ * handled first, and the rest in groups of four to cut the loop overhead.
+ */
+#define HUGEMEM_PRIV_LOOP(move_byte)                    \
+	"sbrs %A1, 0 \n\t"                              \
+	"rjmp two_%= \n\t"                              \
+	move_byte                                       \
+	"two_%=: \n\t"                                  \
+	"sbrs %A1, 1 \n\t"                              \
+	"rjmp four_%= \n\t"                             \
+	move_byte                                       \
+	move_byte                                       \
+	"four_%=: \n\t"                                 \
+	"lsr %B1 \n\t"                                  \
+	"ror %A1 \n\t"                                  \
+	"lsr %B1 \n\t"                                  \
+	"ror %A1 \n\t"                                  \
+	"sbiw %A1, 0 \n\t"                              \
+	"breq done_%= \n\t"                             \
+	"loop_%=: \n\t"                                 \
+	move_byte                                       \
+	move_byte                                       \
+	move_byte                                       \
+	move_byte                                       \
+	"sbiw %A1, 1 \n\t"                              \
+	"brne loop_%= \n\t"                             \
+	"done_%=: \n\t"
 
-	if (size > 0) {
-		asm volatile(
-			"movw r30, %A2 \n\t"
-			"out %3, %C2 \n\t"
-			"get_%=: \n\t"
+static void hugemem_priv_read(void *to, const hugemem_ptr_t from,
+		uint16_t size)
+{
+	asm volatile(
+		"movw r30, %A2 \n\t"
+		"out %3, %C2 \n\t"
+		HUGEMEM_PRIV_LOOP(
 			"ld __tmp_reg__, Z+ \n\t"
-			"st X+, __tmp_reg__ \n\t"
-			"sbiw %A1, 1 \n\t"
-			"brne get_%= \n\t"
-			"out %3, __zero_reg__ \n\t"
-			: "+x"(to), "+w"(size)
-			: "r"(from), "i"(CPU_REG(RAMPZ))
-			: "r30", "r31"
-		);
-	}
+			"st X+, __tmp_reg__ \n\t")
+		"out %3, __zero_reg__ \n\t"
+		: "+x"(to), "+w"(size)
+		: "r"(from), "i"(CPU_REG(RAMPZ))
+		: "r30", "r31", "memory"
+	);
 }
 
 void hugemem_write16(hugemem_ptr_t to, uint_fast16_t val)
@@ -131,38 +167,70 @@ void hugemem_write32(hugemem_ptr_t to, uint_fast32_t val)
 	);
 }
 
-void hugemem_write_block(hugemem_ptr_t to, const void *from, size_t size)
+static void hugemem_priv_write(hugemem_ptr_t to, const void *from,
+		uint16_t size)
 {
-	// Ensure that the address range to copy from is within 64 kB boundary.
-	assert(((uint32_t)from + size) <= 0x10000);
+	asm volatile(
+		"movw r30, %A2 \n\t"
+		"out %3, %C2 \n\t"
+		HUGEMEM_PRIV_LOOP(
+			"ld __tmp_reg__, X+ \n\t"
+			"st Z+, __tmp_reg__ \n\t")
+		"out %3, __zero_reg__ \n\t"
+		: "+x"(from), "+w"(size)
+		: "r"(to), "i"(CPU_REG(RAMPZ))
+		: "r30", "r31", "memory"
+	);
+}
+
+/*
+ * The source is addressed through RAMPX:X and the destination through
+ * RAMPZ:Z. The caller makes sure that neither crosses a 64 kB boundary.
+ */
+static void hugemem_priv_copy(hugemem_ptr_t to, const hugemem_ptr_t from,
+		uint16_t size)
+{
+	uint16_t        from_low = (uint16_t)from;
 
-	if (size > 0) {
-		asm volatile(
-			"movw r30, %A2 \n\t"
-			"out %3, %C2 \n\t"
-			"put_%=: \n\t"
+	asm volatile(
+		"movw r30, %A2 \n\t"
+		"out %4, %C2 \n\t"
+		"out %5, %C3 \n\t"
+		HUGEMEM_PRIV_LOOP(
 			"ld __tmp_reg__, X+ \n\t"
-			"st Z+, __tmp_reg__ \n\t"
-			"sbiw %A1, 1 \n\t"
-			"brne put_%= \n\t"
-			"out %3, __zero_reg__ \n\t"
-			: "+x"(from), "+w"(size)
-			: "r"(to), "i"(CPU_REG(RAMPZ))
-			: "r30", "r31"
-		);
-	}
+			"st Z+, __tmp_reg__ \n\t")
+		"out %4, __zero_reg__ \n\t"
+		"out %5, __zero_reg__ \n\t"
+		: "+x"(from_low), "+w"(size)
+		: "r"(to), "r"(from), "i"(CPU_REG(RAMPZ)),
+		  "i"(CPU_REG(RAMPX))
+		: "r30", "r31", "memory"
+	);
+}
+
+static void hugemem_priv_fill(hugemem_ptr_t to, uint8_t value,
+		uint16_t size)
+{
+	asm volatile(
+		"movw r30, %A2 \n\t"
+		"out %3, %C2 \n\t"
+		HUGEMEM_PRIV_LOOP(
+			"st Z+, %0 \n\t")
+		"out %3, __zero_reg__ \n\t"
+		: "+r"(value), "+w"(size)
+		: "r"(to), "i"(CPU_REG(RAMPZ))
+		: "r30", "r31", "memory"
+	);
 }
 # endif /* __GNUC__ */
 
 # ifdef __ICCAVR__
-void hugemem_read_block(void *to, const hugemem_ptr_t from, size_t size)
+static void hugemem_priv_read(void *to, const hugemem_ptr_t from,
+		uint16_t size)
 {
 	uint8_t *to_ptr;
 	uint8_t __huge *from_ptr;
 
-	// Ensure that the address range to copy to is within 64 kB boundary.
-	assert(((uint32_t)to + size) <= 0x10000);
-
 	to_ptr = (uint8_t *)to;
 	from_ptr = (uint8_t __huge *)from;
 
@@ -171,14 +239,12 @@ void hugemem_read_block(void *to, const hugemem_ptr_t from, size_t size)
 	}
 }
 
-void hugemem_write_block(hugemem_ptr_t to, const void *from, size_t size)
+static void hugemem_priv_write(hugemem_ptr_t to, const void *from,
+		uint16_t size)
 {
 	uint8_t __huge *to_ptr;
 	uint8_t *from_ptr;
 
-	// Ensure that the address range to copy from is within 64 kB boundary.
-	assert(((uint32_t)from + size) <= 0x10000);
-
 	to_ptr = (uint8_t __huge *)to;
 	from_ptr = (uint8_t *)from;
 
@@ -186,5 +252,123 @@ void hugemem_write_block(hugemem_ptr_t to, const void *from, size_t size)
 		*to_ptr++ = *from_ptr++;
 	}
 }
+
+static void hugemem_priv_copy(hugemem_ptr_t to, const hugemem_ptr_t from,
+		uint16_t size)
+{
+	uint8_t __huge *to_ptr;
+	uint8_t __huge *from_ptr;
+
+	to_ptr = (uint8_t __huge *)to;
+	from_ptr = (uint8_t __huge *)from;
+
+	for (; size > 0; size--) {
+		*to_ptr++ = *from_ptr++;
+	}
+}
+
+static void hugemem_priv_fill(hugemem_ptr_t to, uint8_t value,
+		uint16_t size)
+{
+	uint8_t __huge *to_ptr;
+
+	to_ptr = (uint8_t __huge *)to;
+
+	for (; size > 0; size--) {
+		*to_ptr++ = value;
+	}
+}
 # endif /* __ICCAVR__ */
+
+/**
+ * \internal
+ * \brief Get the number of bytes which can be moved in one go
+ *
+ * The low-level copy and fill functions only update the lower 16 bits of
+ * the address pointers, so a chunk must not cross a 64 kB boundary at
+ * either end.
+ */
+static uint16_t hugemem_priv_chunk(hugemem_ptr_t to,
+		const hugemem_ptr_t from, uint32_t size)
+{
+	uint32_t        chunk = HUGEMEM_PRIV_MAX_CHUNK;
+	uint32_t        to_room = 0x10000UL - ((uint32_t)to & 0xffff);
+	uint32_t        from_room = 0x10000UL - ((uint32_t)from & 0xffff);
+
+	if (chunk > size)
+		chunk = size;
+	if (chunk > to_room)
+		chunk = to_room;
+	if (chunk > from_room)
+		chunk = from_room;
+
+	return chunk;
+}
+
+void hugemem_read_block(void *to, const hugemem_ptr_t from, size_t size)
+{
+	// Ensure that the address range to copy to is within 64 kB boundary.
+	assert(((uint32_t)to + size) <= 0x10000);
+
+#ifdef CONFIG_HUGEMEM_DMA
+	if (size >= CONFIG_HUGEMEM_DMA_THRESHOLD && hugemem_dma_copy(
+			(uint32_t)(uintptr_t)to, (uint32_t)from, size))
+		return;
+#endif
+
+	if (size > 0)
+		hugemem_priv_read(to, from, size);
+}
+
+void hugemem_write_block(hugemem_ptr_t to, const void *from, size_t size)
+{
+	// Ensure that the address range to copy from is within 64 kB boundary.
+	assert(((uint32_t)from + size) <= 0x10000);
+
+#ifdef CONFIG_HUGEMEM_DMA
+	if (size >= CONFIG_HUGEMEM_DMA_THRESHOLD && hugemem_dma_copy(
+			(uint32_t)to, (uint32_t)(uintptr_t)from, size))
+		return;
+#endif
+
+	if (size > 0)
+		hugemem_priv_write(to, from, size);
+}
+
+void hugemem_copy(hugemem_ptr_t to, const hugemem_ptr_t from, uint32_t size)
+{
+	uint16_t        chunk;
+
+#ifdef CONFIG_HUGEMEM_DMA
+	if (size >= CONFIG_HUGEMEM_DMA_THRESHOLD
+			&& hugemem_dma_copy((uint32_t)to, (uint32_t)from, size))
+		return;
+#endif
+
+	while (size > 0) {
+		chunk = hugemem_priv_chunk(to, from, size);
+		hugemem_priv_copy(to, from, chunk);
+		to = (hugemem_ptr_t)((uint32_t)to + chunk);
+		from = (hugemem_ptr_t)((uint32_t)from + chunk);
+		size -= chunk;
+	}
+}
+
+void hugemem_fill(hugemem_ptr_t to, uint8_t value, uint32_t size)
+{
+	uint16_t        chunk;
+
+#ifdef CONFIG_HUGEMEM_DMA
+	if (size >= CONFIG_HUGEMEM_DMA_THRESHOLD
+			&& hugemem_dma_fill((uint32_t)to, value, size))
+		return;
+#endif
+
+	while (size > 0) {
+		chunk = hugemem_priv_chunk(to, to, size);
+		hugemem_priv_fill(to, value, chunk);
+		to = (hugemem_ptr_t)((uint32_t)to + chunk);
+		size -= chunk;
+	}
+}
 #endif /* CONFIG_HAVE_HUGEMEM */
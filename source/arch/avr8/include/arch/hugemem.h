@@ -51,7 +51,11 @@
  *
  * GCC does not have native support for 24-bit pointers, and therefore requires
  * custom assembly functions for this purpose. The implemented functions leave
- * RAMPZ cleared upon exit.\par
+ * RAMPX and RAMPZ cleared upon exit.\par
+ *
+ * Block operations are unrolled to move four bytes per loop iteration. On
+ * ATxmega, blocks of at least \a CONFIG_HUGEMEM_DMA_THRESHOLD bytes are moved
+ * by the DMA controller instead if \a CONFIG_HUGEMEM_DMA is defined.\par
  *
  * If the chip does not support huge memory, i.e., \a CONFIG_HAVE_HUGEMEM is
  * not defined, a generic implementation will be used.
@@ -139,6 +143,8 @@ static inline void hugemem_write32(hugemem_ptr_t to, uint_fast32_t val)
 
 void hugemem_read_block(void *to, const hugemem_ptr_t from, size_t size);
 void hugemem_write_block(hugemem_ptr_t to, const void *from, size_t size);
+void hugemem_copy(hugemem_ptr_t to, const hugemem_ptr_t from, uint32_t size);
+void hugemem_fill(hugemem_ptr_t to, uint8_t value, uint32_t size);
 
 #else
 # include <generic/hugemem.h>
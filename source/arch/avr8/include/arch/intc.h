@@ -51,7 +51,7 @@
 /* Declaration of interrupts differs between compilers. */
 #if defined(__GNUC__) || defined(__DOXYGEN__)
 
-#define INTC_DEFINE_HANDLER(id, handler, level)         \
+#define INTC_PRIV_DEFINE_HANDLER(id, handler, level)    \
 	extern void *intc_priv_data_sym(id);            \
 	extern void __attribute__((__signal__))         \
 			intc_priv_entry_sym(id)(void);  \
@@ -64,7 +64,7 @@
 #elif defined(__ICCAVR__)
 
 #define IAR_VECTOR(x) (4 * (x - 1))
-#define INTC_DEFINE_HANDLER(id, handler, level)         \
+#define INTC_PRIV_DEFINE_HANDLER(id, handler, level)    \
 	extern void *intc_priv_data_sym(id);            \
 	COMPILER_PRAGMA(vector=IAR_VECTOR(id))          \
 	__interrupt void intc_priv_entry_sym(id)(void)  \
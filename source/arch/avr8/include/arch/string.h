@@ -40,6 +40,19 @@
 
 #include <generic/string.h>
 
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+
+/*
+ * Hand-written assembly versions for GCC, see arch/avr8/string. IAR
+ * uses a different calling convention, so it gets the C versions.
+ */
+extern void *memcpy(void *dest, const void *src, size_t n);
+extern void *memset(void *s, int c, size_t n);
+extern size_t strlen(const char *str);
+extern int strcmp(const char *str1, const char *str2);
+
+#else
+
 static inline void *memcpy(void *dest, const void *src, size_t n)
 {
 	return generic_memcpy(dest, src, n);
@@ -60,6 +73,8 @@ static inline int strcmp(const char *str1, const char *str2)
 	return generic_strcmp(str1, str2);
 }
 
+#endif
+
 static inline int strncmp(const char *str1, const char *str2, size_t n)
 {
 	return generic_strncmp(str1, str2, n);
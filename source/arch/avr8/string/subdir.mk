@@ -0,0 +1,8 @@
+avr8-string-y		+= memcpy.S
+avr8-string-y		+= memset.S
+avr8-string-y		+= strcmp.S
+avr8-string-y		+= strlen.S
+
+src-gnu-y		+= $(addprefix arch/avr8/string/,$(avr8-string-y))
+
+mkfiles			+= $(src)/arch/avr8/string/subdir.mk
@@ -0,0 +1,24 @@
+# The application is run directly as a host executable
+PROGTOOL                := host
+
+appimg-gnu-y            += $(app).elf
+
+incdir-y                += $(src)/arch/host/include
+
+src-y                   += arch/host/clock.c
+src-y                   += arch/host/delay.c
+src-y                   += arch/host/intc.c
+
+hdr-y                   += arch/host/include/arch/atomic.h
+hdr-y                   += arch/host/include/arch/bitops.h
+hdr-y                   += arch/host/include/arch/byteorder.h
+hdr-y                   += arch/host/include/arch/compiler-gcc.h
+hdr-y                   += arch/host/include/arch/host_clock.h
+hdr-y                   += arch/host/include/arch/intc.h
+hdr-y                   += arch/host/include/arch/interrupt.h
+hdr-y                   += arch/host/include/arch/io.h
+hdr-$(CONFIG_HUGEMEM)   += arch/host/include/arch/hugemem.h
+hdr-y                   += arch/host/include/arch/progmem.h
+hdr-$(CONFIG_SOFTIRQ)   += arch/host/include/arch/softirq.h
+hdr-y                   += arch/host/include/arch/stdint.h
+hdr-y                   += arch/host/include/arch/string.h
@@ -0,0 +1,252 @@
+/**
+ * \file
+ *
+ * \brief Virtual clock for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+#include <interrupt.h>
+#include <intc.h>
+#include <types.h>
+#include <arch/host_clock.h>
+
+/**
+ * \weakgroup host_clock_group
+ * @{
+ */
+
+//! Current time on the virtual clock.
+static host_time_t host_clock;
+//! Events in the order they are due.
+static struct host_event *host_event_queue;
+//! Time at which the application is stopped, or 0 to run forever.
+static host_time_t host_run_time;
+//! Real time at startup, in microseconds.
+static host_time_t host_real_start;
+
+/**
+ * \brief Get the current time on the virtual clock
+ */
+host_time_t host_clock_now(void)
+{
+	return host_clock;
+}
+
+/**
+ * \internal
+ * \brief Read the monotonic clock of the host, in microseconds
+ */
+static host_time_t host_clock_read_real(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (host_time_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * \brief Get the real time spent since startup, in microseconds
+ *
+ * Unlike the virtual clock, this follows the clock of the host, so it
+ * moves while the application runs code without returning to the main
+ * loop. It can be used to measure how long such code takes on the host
+ * CPU, but the results are not deterministic.
+ */
+host_time_t host_clock_real(void)
+{
+	return host_clock_read_real() - host_real_start;
+}
+
+/**
+ * \brief Schedule an event on the virtual clock
+ *
+ * If \a event is already scheduled, it is moved to its new time.
+ *
+ * \param event The event to schedule.
+ * \param delay Number of microseconds until \a event is due.
+ */
+void host_event_schedule(struct host_event *event, host_time_t delay)
+{
+	struct host_event	**p;
+	irqflags_t		iflags;
+
+	assert(event->func);
+
+	iflags = cpu_irq_save();
+	host_event_cancel(event);
+
+	event->time = host_clock + delay;
+	for (p = &host_event_queue; *p; p = &(*p)->next)
+		if ((*p)->time > event->time)
+			break;
+	event->next = *p;
+	*p = event;
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Remove an event from the virtual clock
+ *
+ * It is safe to call this for an event that is not scheduled.
+ *
+ * \param event The event to remove.
+ */
+void host_event_cancel(struct host_event *event)
+{
+	struct host_event	**p;
+	irqflags_t		iflags;
+
+	iflags = cpu_irq_save();
+	for (p = &host_event_queue; *p; p = &(*p)->next) {
+		if (*p == event) {
+			*p = event->next;
+			event->next = NULL;
+			break;
+		}
+	}
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Test if any events are scheduled on the virtual clock
+ */
+bool host_event_is_pending(void)
+{
+	return host_event_queue != NULL;
+}
+
+/**
+ * \internal
+ * \brief Stop the application
+ */
+static void host_clock_stop(void)
+{
+	fflush(stdout);
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * \internal
+ * \brief Move the clock to \a time, stopping at the end of the run
+ */
+static void host_clock_set(host_time_t time)
+{
+	if (host_run_time && time > host_run_time)
+		host_clock_stop();
+	if (time > host_clock)
+		host_clock = time;
+}
+
+/**
+ * \internal
+ * \brief Run the first event, moving the clock forward to its due time
+ *
+ * Must be called with interrupts disabled.
+ */
+static void host_clock_run_first_event(void)
+{
+	struct host_event	*event = host_event_queue;
+
+	assert(event);
+
+	host_event_queue = event->next;
+	event->next = NULL;
+	host_clock_set(event->time);
+
+	event->func(event);
+}
+
+/**
+ * \brief Move the virtual clock forward
+ *
+ * Any events which become due are run in order, with interrupts
+ * disabled. Interrupts requested by the events are handled before this
+ * function returns, unless interrupts were disabled by the caller.
+ *
+ * \param us Number of microseconds to move the clock.
+ */
+void host_clock_advance(host_time_t us)
+{
+	host_time_t	end = host_clock + us;
+	irqflags_t	iflags;
+
+	iflags = cpu_irq_save();
+	while (host_event_queue && host_event_queue->time <= end) {
+		host_clock_run_first_event();
+		cpu_irq_restore(iflags);
+		cpu_irq_disable();
+	}
+	host_clock_set(end);
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Wait for something to happen
+ *
+ * This is the host equivalent of putting the CPU to sleep. It must be
+ * called with interrupts disabled, and returns with interrupts enabled.
+ *
+ * If no interrupts are pending, the virtual clock jumps to the next
+ * event. If there are no more events either, nothing can ever wake up
+ * the application again, so the application exits. The application is
+ * also stopped when the virtual clock passes the number of
+ * microseconds given by the HOST_RUN_TIME environment variable.
+ */
+void host_idle(void)
+{
+	assert(!cpu_irq_is_enabled());
+
+	if (!host_irq_is_pending()) {
+		if (!host_event_queue)
+			host_clock_stop();
+		host_clock_run_first_event();
+	}
+
+	cpu_irq_enable();
+}
+
+static void __attribute__((constructor)) host_clock_init(void)
+{
+	const char	*run_time = getenv("HOST_RUN_TIME");
+
+	host_real_start = host_clock_read_real();
+	if (run_time)
+		host_run_time = strtoull(run_time, NULL, 0);
+}
+
+//! @}
@@ -0,0 +1,17 @@
+CROSS_COMPILE		?=
+ARCH			:= host
+
+CONFIG_ARCH_HOST=y
+
+# Defaults which may be overridden by application-specific config file
+CONFIG_DEBUG_DWARF2=y
+CONFIG_OPTIMIZE_LEVEL=2
+CONFIG_NR_IRQS=32
+CONFIG_MALLOC_HOST=y
+
+# There is no linker script for the host, so let the compiler driver
+# link in the C library and startup files as usual.
+CONFIG_LINK_WITH_CC=y
+
+config_mk		+= $(src)/arch/host/config.mk
+platform-mkfiles	+= $(src)/arch/host/arch.mk
@@ -0,0 +1,110 @@
+/**
+ * \file
+ *
+ * \brief Bit operations for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef ARCH_BITOPS_H_INCLUDED
+#define ARCH_BITOPS_H_INCLUDED
+
+#include <interrupt.h>
+
+/**
+ * \weakgroup bitops_group
+ * @{
+ */
+
+typedef unsigned int bit_word_t;
+
+/*
+ * The host port runs the application in a single thread, and only the
+ * simulated interrupt mask needs to be respected.
+ */
+static inline void atomic_set_bit(unsigned int nr, bit_word_t *bitmap)
+{
+	irqflags_t	iflags;
+
+	iflags = cpu_irq_save();
+	set_bit(nr, bitmap);
+	cpu_irq_restore(iflags);
+}
+
+static inline void atomic_clear_bit(unsigned int nr, bit_word_t *bitmap)
+{
+	irqflags_t	iflags;
+
+	iflags = cpu_irq_save();
+	clear_bit(nr, bitmap);
+	cpu_irq_restore(iflags);
+}
+
+static inline void atomic_toggle_bit(unsigned int nr, bit_word_t *bitmap)
+{
+	irqflags_t	iflags;
+
+	iflags = cpu_irq_save();
+	toggle_bit(nr, bitmap);
+	cpu_irq_restore(iflags);
+}
+
+static inline bool atomic_test_and_set_bit(unsigned int nr, bit_word_t *bitmap)
+{
+	bool		is_set;
+	irqflags_t	iflags;
+
+	iflags = cpu_irq_save();
+	is_set = test_bit(nr, bitmap);
+	set_bit(nr, bitmap);
+	cpu_irq_restore(iflags);
+
+	return is_set;
+}
+
+static inline bool atomic_test_and_clear_bit(unsigned int nr,
+		bit_word_t *bitmap)
+{
+	bool		is_set;
+	irqflags_t	iflags;
+
+	iflags = cpu_irq_save();
+	is_set = test_bit(nr, bitmap);
+	clear_bit(nr, bitmap);
+	cpu_irq_restore(iflags);
+
+	return is_set;
+}
+
+//! @}
+
+#endif /* ARCH_BITOPS_H_INCLUDED */
@@ -0,0 +1,68 @@
+/**
+ * \file
+ *
+ * \brief GCC-specific definitions for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef ARCH_COMPILER_GCC_H_INCLUDED
+#define ARCH_COMPILER_GCC_H_INCLUDED
+
+#include <stdbool.h>
+
+/**
+ * \weakgroup interrupt_group
+ * @{
+ */
+
+//! True when the simulated interrupts are enabled.
+extern bool host_irq_priv_enabled;
+extern void host_irq_priv_enable(void);
+
+#define cpu_irq_disable()                               \
+	do {                                            \
+		host_irq_priv_enabled = false;          \
+		barrier();                              \
+	} while (0)
+#define cpu_irq_enable()                                \
+	do {                                            \
+		barrier();                              \
+		host_irq_priv_enable();                 \
+	} while (0)
+
+//! @}
+
+#define compiler_clz(x)         __builtin_clz(x)
+#define compiler_ctz(x)         __builtin_ctz(x)
+
+#endif /* ARCH_COMPILER_GCC_H_INCLUDED */
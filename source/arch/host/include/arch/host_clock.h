@@ -0,0 +1,116 @@
+/**
+ * \file
+ *
+ * \brief Virtual clock for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef ARCH_HOST_CLOCK_H_INCLUDED
+#define ARCH_HOST_CLOCK_H_INCLUDED
+
+#include <stdint.h>
+
+/**
+ * \ingroup arch_host_group
+ * \defgroup host_clock_group Virtual clock
+ *
+ * Applications running on the host don't run in real time. Instead,
+ * time is kept by a virtual clock counting microseconds, which only
+ * moves forward when the application busy-waits, goes to sleep, or
+ * runs a task from the main loop. The latter costs #HOST_TASK_COST_US
+ * so that tasks polling for something by rescheduling themselves will
+ * eventually see it happen.
+ *
+ * Simulated devices schedule events on the virtual clock to model
+ * things that happen at a later time, like a timer expiring or a
+ * conversion completing. When the application goes to sleep with
+ * nothing else to do, the virtual clock jumps directly to the next
+ * event. So a run is fully deterministic, and is usually a lot faster
+ * than real time. Code which must be timed while it runs without
+ * returning to the main loop can use host_clock_real() instead.
+ *
+ * Events are run with interrupts disabled, and will typically request
+ * an interrupt by calling host_irq_raise().
+ *
+ * @{
+ */
+
+//! Time on the virtual clock, in microseconds since startup.
+typedef uint64_t host_time_t;
+
+//! Virtual time taken by running one task from the main loop.
+#define HOST_TASK_COST_US	10
+
+struct host_event;
+
+/**
+ * \brief Function called when an event is due
+ *
+ * \param event The event which is due.
+ */
+typedef void (*host_event_func_t)(struct host_event *event);
+
+//! An event scheduled on the virtual clock
+struct host_event {
+	//! \internal Next event in the queue
+	struct host_event	*next;
+	//! \internal Time at which the event is due
+	host_time_t		time;
+	//! Function to call when the event is due
+	host_event_func_t	func;
+};
+
+/**
+ * \brief Initialize an event
+ *
+ * \param event The event to initialize.
+ * \param func Function to call when the event is due.
+ */
+static inline void host_event_init(struct host_event *event,
+		host_event_func_t func)
+{
+	event->next = 0;
+	event->func = func;
+}
+
+extern host_time_t host_clock_now(void);
+extern host_time_t host_clock_real(void);
+extern void host_clock_advance(host_time_t us);
+extern void host_event_schedule(struct host_event *event, host_time_t delay);
+extern void host_event_cancel(struct host_event *event);
+extern bool host_event_is_pending(void);
+extern void host_idle(void);
+
+//! @}
+
+#endif /* ARCH_HOST_CLOCK_H_INCLUDED */
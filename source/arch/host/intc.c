@@ -0,0 +1,146 @@
+/**
+ * \file
+ *
+ * \brief Simulated interrupt controller for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <util.h>
+#include <interrupt.h>
+#include <intc.h>
+#include <types.h>
+
+/**
+ * \weakgroup intc_group
+ * @{
+ */
+
+#ifndef CONFIG_NR_IRQS
+# define CONFIG_NR_IRQS		32
+#endif
+
+//! Interrupt handler and data registered for each interrupt line.
+struct host_intc_line {
+	void	(*handler)(void *data);
+	void	**data;
+};
+
+static struct host_intc_line host_intc_lines[CONFIG_NR_IRQS];
+static unsigned long host_intc_pending[(CONFIG_NR_IRQS + 31) / 32];
+
+bool host_irq_priv_enabled;
+
+/**
+ * \internal
+ * \brief Register the handler for interrupt \a id
+ *
+ * This is called by the constructor generated by INTC_DEFINE_HANDLER().
+ */
+void host_intc_priv_register(unsigned int id,
+		void (*handler)(void *data), void **data)
+{
+	assert(id < CONFIG_NR_IRQS);
+	assert(!host_intc_lines[id].handler);
+
+	host_intc_lines[id].handler = handler;
+	host_intc_lines[id].data = data;
+}
+
+/**
+ * \internal
+ * \brief Enable interrupts and run the handlers of any pending interrupts
+ *
+ * Handlers are run with interrupts disabled, lowest interrupt ID first,
+ * until no more interrupts are pending.
+ */
+void host_irq_priv_enable(void)
+{
+	unsigned int	id;
+
+	host_irq_priv_enabled = true;
+
+again:
+	for (id = 0; id < CONFIG_NR_IRQS; id++) {
+		struct host_intc_line	*line = &host_intc_lines[id];
+		unsigned long		mask = 1UL << (id % 32);
+
+		if (!(host_intc_pending[id / 32] & mask))
+			continue;
+
+		host_intc_pending[id / 32] &= ~mask;
+
+		if (line->handler) {
+			host_irq_priv_enabled = false;
+			line->handler(*line->data);
+			host_irq_priv_enabled = true;
+		}
+
+		goto again;
+	}
+}
+
+/**
+ * \brief Request interrupt \a id
+ *
+ * This is the host equivalent of a peripheral asserting its interrupt
+ * line. If interrupts are enabled, the handler is run before this
+ * function returns. Otherwise, it is run as soon as interrupts are
+ * enabled again.
+ *
+ * \param id The interrupt to request.
+ */
+void host_irq_raise(unsigned int id)
+{
+	assert(id < CONFIG_NR_IRQS);
+
+	host_intc_pending[id / 32] |= 1UL << (id % 32);
+	if (host_irq_priv_enabled)
+		host_irq_priv_enable();
+}
+
+/**
+ * \brief Test if any interrupts are waiting to be handled
+ */
+bool host_irq_is_pending(void)
+{
+	unsigned int	i;
+
+	for (i = 0; i < ARRAY_LEN(host_intc_pending); i++)
+		if (host_intc_pending[i])
+			return true;
+
+	return false;
+}
+
+//! @}
@@ -0,0 +1,10 @@
+incdir-y		+= $(src)/board/host/include
+
+src-y			+= board/host/init.c
+src-$(CONFIG_EXTRAM_SDRAM)      += board/host/board_physmem_pools.c
+
+hdr-y			+= board/host/include/board.h
+hdr-y			+= board/host/include/board/led.h
+hdr-y                   += board/host/include/board/physmem.h
+hdr-$(CONFIG_GFX_HX8347A)     += board/host/include/board/hx8347a.h
+hdr-$(CONFIG_SPI)		+= board/host/include/board/spi.h
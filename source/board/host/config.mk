@@ -0,0 +1,9 @@
+include $(src)/chip/host/config.mk
+
+CONFIG_BOARD_HOST=y
+
+# Size of the host memory backing the external RAM pool
+CONFIG_EXTRAM_SIZE=0x800000
+
+config_mk		+= $(src)/board/host/config.mk
+platform-mkfiles	+= $(src)/board/host/board.mk
@@ -54,5 +54,8 @@
 #define GFX_BACKLIGHT_PIN       CREATE_GPIO_PIN(PORTD, 0)
 #define GFX_RESET_PIN           CREATE_GPIO_PIN(PORTD, 1)
 #define GFX_TE_PIN              CREATE_GPIO_PIN(PORTD, 2)
+#define GFX_TE_PORT             PORTD
+#define GFX_TE_PINMASK          PIN2_bm
+#define GFX_TE_IRQ              PMIC_PORTD_INT0_IRQ
 
 #endif /* BOARD_HX8347A_H_INCLUDED */
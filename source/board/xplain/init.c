@@ -47,6 +47,9 @@
 #ifdef CONFIG_EXTRAM_SDRAM
 # include <board/sdram.h>
 #endif
+#ifdef CONFIG_SLEEPMGR
+# include <sleepmgr.h>
+#endif
 
 void board_init(void)
 {
@@ -103,5 +106,13 @@ void board_init(void)
 	port_write_reg(PORTJ_BASE, DIR, 0xf0);
 
 	board_enable_sdram();
+
+	/*
+	 * The EBI refreshes the SDRAM using the peripheral clocks, which
+	 * are stopped in all sleep modes except idle.
+	 */
+# ifdef CONFIG_SLEEPMGR
+	sleepmgr_lock_mode(SLEEPMGR_IDLE);
+# endif
 #endif
 }
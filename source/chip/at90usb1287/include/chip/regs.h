@@ -320,6 +320,12 @@
 #define AVR_BF_UPM_SIZE		2
 #define AVR_BF_UPM_OFFSET	4
 
+/* SMCR bitfield definitions */
+#define AVR_BF_SE_SIZE		1
+#define AVR_BF_SE_OFFSET	0
+#define AVR_BF_SM_SIZE		3
+#define AVR_BF_SM_OFFSET	1
+
 /* Bit manipulation macros */
 #define AVR_BIT(name) 					\
 	(1 << AVR_BF_##name##_OFFSET)
@@ -59,6 +59,7 @@
 #define DATA_SRAM_BASE                  CPU_SRAM_BASE
 
 #define CLK_BASE                        0x0040 // Clock control
+#define SLEEP_BASE                      0x0048 //!< Sleep controller
 #define OSC_BASE                        0x0050 // Oscillator control
 
 #define PR_BASE                         0x0070 //!< Power Reduction
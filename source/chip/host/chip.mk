@@ -0,0 +1,12 @@
+incdir-y		+= $(src)/chip/host/include
+
+src-y			+= chip/host/gpio.c
+src-$(CONFIG_SPI)	+= chip/host/spi.c
+
+hdr-y			+= chip/host/include/chip/gpio.h
+hdr-y			+= chip/host/include/chip/memory-map.h
+hdr-y			+= chip/host/include/chip/sysclk.h
+hdr-y			+= chip/host/include/chip/uart.h
+hdr-$(CONFIG_SPI)	+= chip/host/include/chip/pmic.h
+hdr-$(CONFIG_SPI)	+= chip/host/include/chip/spi.h
+hdr-$(CONFIG_TIMER)	+= chip/host/include/chip/timer.h
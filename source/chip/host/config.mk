@@ -0,0 +1,7 @@
+include $(src)/cpu/host/config.mk
+
+CONFIG_CHIP_HOST=y
+CONFIG_HAVE_HUGEMEM=y
+
+config_mk		+= $(src)/chip/host/config.mk
+platform-mkfiles	+= $(src)/chip/host/chip.mk
@@ -0,0 +1,81 @@
+/**
+ * \file
+ *
+ * \brief Simulated GPIO for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CHIP_GPIO_H_INCLUDED
+#define CHIP_GPIO_H_INCLUDED
+
+#include <compiler.h>
+#include <types.h>
+
+/**
+ * \ingroup gpio_group
+ * \defgroup gpio_host_group Host GPIO simulation
+ *
+ * The host has a single bank of simulated GPIO pins which simply keep
+ * the value last written to them.
+ *
+ * @{
+ */
+
+//! Number of simulated GPIO pins
+#define HOST_GPIO_NR_PINS	32
+
+typedef unsigned int gpio_pin_t;
+
+extern uint32_t host_gpio_value;
+
+__always_inline static void gpio_set_value(gpio_pin_t pin, bool value)
+{
+	if (value)
+		host_gpio_value |= 1UL << pin;
+	else
+		host_gpio_value &= ~(1UL << pin);
+}
+
+__always_inline static bool gpio_get_value(gpio_pin_t pin)
+{
+	return (host_gpio_value >> pin) & 1;
+}
+
+__always_inline static void gpio_toggle_value(gpio_pin_t pin)
+{
+	host_gpio_value ^= 1UL << pin;
+}
+
+//! @}
+
+#endif /* CHIP_GPIO_H_INCLUDED */
@@ -0,0 +1,133 @@
+/**
+ * \file
+ *
+ * \brief Simulated SPI module for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CHIP_SPI_H_INCLUDED
+#define CHIP_SPI_H_INCLUDED
+
+#include <stdint.h>
+#include <regs/xmega_spi.h>
+#include <clk/sys.h>
+
+/**
+ * \addtogroup spi_group
+ * \section spi_host_section Host SPI module
+ *
+ * The host has a single SPI module, with ID 0. It is a software model of
+ * the registers of the ATxmega SPI module, so the ATxmega SPI driver,
+ * including the interrupt driven transfers of CONFIG_SPI_MASTER_INT, runs
+ * unmodified on top of it.
+ *
+ * A byte written to the data register is shifted out over the virtual
+ * clock, taking eight periods of the SPI clock selected by the control
+ * register, but at least one microsecond. The byte is then passed to the
+ * slave set with host_spi_set_slave(), and its reply can be read from
+ * the data register. The interrupt flag is set, or the interrupt
+ * requested if it is enabled. Writing the data register while a byte is
+ * being shifted out sets the write collision flag, and the byte is lost,
+ * as on the real hardware.
+ */
+
+/**
+ * \ingroup spi_xmega_internal_group
+ * \defgroup spi_host_internal_group Host SPI internals
+ * @{
+ */
+
+#define SPI_ID_UART_FIRST		1
+#define SPI_ID_LAST			0
+
+#ifdef CONFIG_SPI0
+# define SPI_ID_NATIVE_IS_ENABLED	true
+#else
+# define SPI_ID_NATIVE_IS_ENABLED	false
+#endif
+#define SPI_ID_UART_IS_ENABLED		false
+
+/**
+ * \brief Slave on the bus of a simulated SPI module
+ *
+ * Called with interrupts disabled each time a byte has been shifted
+ * out.
+ *
+ * \param tx_byte Byte sent by the master.
+ *
+ * \return Byte sent back to the master.
+ */
+typedef uint8_t (*host_spi_slave_t)(uint8_t tx_byte);
+
+extern void *host_spi_get_base(uint8_t spi_id);
+extern uint8_t host_spi_read_reg(void *spi, uint8_t reg);
+extern void host_spi_write_reg(void *spi, uint8_t reg, uint8_t value);
+extern void host_spi_set_slave(uint8_t spi_id, host_spi_slave_t slave);
+extern unsigned int host_spi_get_collisions(uint8_t spi_id);
+
+/*
+ * The registers live in the model rather than in memory, since a write
+ * to the data register starts a transfer.
+ */
+#undef spi_write_reg
+#undef spi_read_reg
+#define spi_write_reg(spi, reg, value)				\
+	host_spi_write_reg(spi, SPI_##reg, value)
+#define spi_read_reg(spi, reg)					\
+	host_spi_read_reg(spi, SPI_##reg)
+
+static inline void *spi_get_base(uint8_t spi_id)
+{
+	return host_spi_get_base(spi_id);
+}
+
+static inline uint8_t spi_get_sysclk_port(uint8_t spi_id)
+{
+	return SYSCLK_PORT_GEN;
+}
+
+#include <spi/spi_xmega.h>
+#include <spi/spi_mega_xmega.h>
+
+//! \name spi_master derived type connections
+//! @{
+#define spi_master_type0	SPI_MASTER_NATIVE_TYPE
+//! @}
+
+//! \name spi_device derived type connections
+//! @{
+#define spi_device_type0	SPI_DEVICE_NATIVE_TYPE
+//! @}
+
+//! @}
+#endif /* CHIP_SPI_H_INCLUDED */
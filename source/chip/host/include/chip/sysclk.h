@@ -0,0 +1,80 @@
+/**
+ * \file
+ *
+ * \brief System clock management for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CHIP_SYSCLK_H_INCLUDED
+#define CHIP_SYSCLK_H_INCLUDED
+
+#include <stdint.h>
+
+/**
+ * \weakgroup sysclk_group
+ * @{
+ */
+
+/*
+ * Simulated devices don't need their clocks enabled, so there is
+ * nothing to do here. The CPU frequency is still taken from
+ * CONFIG_CPU_HZ, as some drivers use it to compute divider values.
+ */
+
+static inline unsigned long sysclk_get_cpu_hz(void)
+{
+	return CONFIG_CPU_HZ;
+}
+
+static inline void sysclk_init(void)
+{
+}
+
+/*
+ * Drivers shared with ATxmega, like the SPI driver, still enable and
+ * disable the clocks of their modules.
+ */
+#define SYSCLK_PORT_GEN         0               //!< No particular port
+#define SYSCLK_SPI              (1U << 3)       //!< SPI controller
+
+static inline void sysclk_enable_module(uint8_t port, uint8_t id)
+{
+}
+
+static inline void sysclk_disable_module(uint8_t port, uint8_t id)
+{
+}
+
+//! @}
+
+#endif /* CHIP_SYSCLK_H_INCLUDED */
@@ -0,0 +1,112 @@
+/**
+ * \file
+ *
+ * \brief Timer definitions for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CHIP_TIMER_H_INCLUDED
+#define CHIP_TIMER_H_INCLUDED
+
+#include <timer/timer_host.h>
+
+/**
+ * \addtogroup timer_host_group
+ * \section host_timer_section Host timers
+ *
+ * The host has two timers, with ID 0 and 1, both running on the
+ * virtual clock. Their alarms are delivered through the simulated
+ * interrupt controller, on \ref HOST_TIMER0_IRQ and \ref HOST_TIMER1_IRQ.
+ */
+
+//! Interrupt requested by the alarm of timer 0.
+#define HOST_TIMER0_IRQ		16
+//! Interrupt requested by the alarm of timer 1.
+#define HOST_TIMER1_IRQ		17
+
+#define timer0_init_priv(timer, callback) \
+	host_timer_init(0, timer, callback)
+#define timer1_init_priv(timer, callback) \
+	host_timer_init(1, timer, callback)
+
+#define timer0_start_priv(timer) \
+	host_timer_start(timer)
+#define timer1_start_priv(timer) \
+	host_timer_start(timer)
+
+#define timer0_stop_priv(timer) \
+	host_timer_stop(timer)
+#define timer1_stop_priv(timer) \
+	host_timer_stop(timer)
+
+#define timer0_set_alarm_priv(timer, delay) \
+	host_timer_set_alarm(timer, delay)
+#define timer1_set_alarm_priv(timer, delay) \
+	host_timer_set_alarm(timer, delay)
+
+#define timer0_get_time_priv(timer) \
+	host_timer_get_time(timer)
+#define timer1_get_time_priv(timer) \
+	host_timer_get_time(timer)
+
+#define timer0_default_resolution_priv(timer) \
+	host_timer_default_resolution()
+#define timer1_default_resolution_priv(timer) \
+	host_timer_default_resolution()
+
+#define timer0_write_resolution_priv(timer, resolution) \
+	host_timer_write_resolution(timer, resolution)
+#define timer1_write_resolution_priv(timer, resolution) \
+	host_timer_write_resolution(timer, resolution)
+
+#define timer0_read_resolution_priv(timer) \
+	host_timer_read_resolution(timer)
+#define timer1_read_resolution_priv(timer) \
+	host_timer_read_resolution(timer)
+
+#define timer0_set_resolution_priv(timer, resolution) \
+	host_timer_set_resolution(resolution)
+#define timer1_set_resolution_priv(timer, resolution) \
+	host_timer_set_resolution(resolution)
+
+#define timer0_get_resolution_priv(timer, resolution) \
+	host_timer_get_resolution(resolution)
+#define timer1_get_resolution_priv(timer, resolution) \
+	host_timer_get_resolution(resolution)
+
+#define timer0_get_maximum_delta_priv(timer) \
+	host_timer_get_maximum_delta()
+#define timer1_get_maximum_delta_priv(timer) \
+	host_timer_get_maximum_delta()
+
+#endif /* CHIP_TIMER_H_INCLUDED */
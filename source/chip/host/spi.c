@@ -0,0 +1,217 @@
+/**
+ * \file
+ *
+ * \brief Simulated SPI module for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <intc.h>
+#include <spi.h>
+#include <util.h>
+#include <arch/host_clock.h>
+
+/**
+ * \ingroup spi_host_internal_group
+ * @{
+ */
+
+//! State of a simulated SPI module.
+struct host_spi {
+	//! Register file, indexed by register offset.
+	uint8_t                 regs[4];
+	//! Byte being shifted out.
+	uint8_t                 tx_byte;
+	//! Last byte received, returned by reads of the data register.
+	uint8_t                 rx_byte;
+	//! True while a byte is being shifted out.
+	bool                    busy;
+	//! Event for the end of the byte being shifted out.
+	struct host_event       event;
+	//! Slave on the bus, or NULL if there is none.
+	host_spi_slave_t        slave;
+	//! Number of data register writes during a transfer.
+	unsigned int            collisions;
+};
+
+//! Set the interrupt flag, and request the interrupt if it is enabled.
+static void host_spi_priv_set_flag(struct host_spi *spi)
+{
+	spi->regs[SPI_STATUS] |= SPI_BIT(STATUS_IF);
+	if (spi->regs[SPI_INTCTRL] & SPI_BF(INTCTRL_INTLVL, ~0))
+		host_irq_raise(PMIC_SPI0_IRQ);
+}
+
+//! Complete the byte being shifted out.
+static void host_spi_byte_done(struct host_event *event)
+{
+	struct host_spi *spi = container_of(event, struct host_spi, event);
+
+	// MISO is pulled up when no slave drives it.
+	spi->rx_byte = 0xff;
+	if (spi->slave)
+		spi->rx_byte = spi->slave(spi->tx_byte);
+
+	spi->busy = false;
+	host_spi_priv_set_flag(spi);
+}
+
+//! Return the time taken to shift out a byte, in microseconds.
+static host_time_t host_spi_byte_time(struct host_spi *spi)
+{
+	static const uint8_t dividers[] = { 4, 16, 64, 128 };
+	uint8_t         ctrl = spi->regs[SPI_CTRL];
+	unsigned long   divider;
+	host_time_t     us;
+
+	divider = dividers[ctrl & SPI_BF(CTRL_PRESCALER, ~0)];
+	if (ctrl & SPI_BIT(CTRL_CLK2X))
+		divider /= 2;
+
+	us = 8ULL * divider * 1000000 / CONFIG_CPU_HZ;
+	if (!us)
+		us = 1;
+
+	return us;
+}
+
+static struct host_spi host_spi0 = {
+	.event.func     = host_spi_byte_done,
+};
+
+static struct host_spi *host_spi_of(uint8_t spi_id)
+{
+	assert(spi_id == 0);
+
+	return &host_spi0;
+}
+
+/**
+ * \brief Return the register base of simulated SPI module \a spi_id
+ */
+void *host_spi_get_base(uint8_t spi_id)
+{
+	return host_spi_of(spi_id);
+}
+
+/**
+ * \brief Read register \a reg of the simulated SPI module at \a base
+ *
+ * Reading the data register clears the interrupt and write collision
+ * flags. On the real hardware, the status register must be read first,
+ * which all drivers do anyway.
+ */
+uint8_t host_spi_read_reg(void *base, uint8_t reg)
+{
+	struct host_spi *spi = base;
+
+	assert(reg < ARRAY_LEN(spi->regs));
+
+	if (reg == SPI_DATA) {
+		spi->regs[SPI_STATUS] &= ~(SPI_BIT(STATUS_IF)
+				| SPI_BIT(STATUS_WRCOL));
+		return spi->rx_byte;
+	}
+
+	return spi->regs[reg];
+}
+
+/**
+ * \brief Write \a value to register \a reg of the simulated SPI module
+ * at \a base
+ */
+void host_spi_write_reg(void *base, uint8_t reg, uint8_t value)
+{
+	struct host_spi *spi = base;
+
+	assert(reg < ARRAY_LEN(spi->regs));
+
+	switch (reg) {
+	case SPI_CTRL:
+		spi->regs[SPI_CTRL] = value;
+		if (!(value & SPI_BIT(CTRL_ENABLE)) && spi->busy) {
+			host_event_cancel(&spi->event);
+			spi->busy = false;
+		}
+		break;
+
+	case SPI_INTCTRL:
+		spi->regs[SPI_INTCTRL] = value;
+		if (spi->regs[SPI_STATUS] & SPI_BIT(STATUS_IF))
+			host_spi_priv_set_flag(spi);
+		break;
+
+	case SPI_DATA:
+		// Only master mode is modelled.
+		assert(spi->regs[SPI_CTRL] & SPI_BIT(CTRL_ENABLE));
+		assert(spi->regs[SPI_CTRL] & SPI_BIT(CTRL_MASTER));
+
+		if (spi->busy) {
+			spi->regs[SPI_STATUS] |= SPI_BIT(STATUS_WRCOL);
+			spi->collisions++;
+			break;
+		}
+
+		spi->tx_byte = value;
+		spi->busy = true;
+		host_event_schedule(&spi->event, host_spi_byte_time(spi));
+		break;
+
+	default:
+		// The status register is read-only.
+		break;
+	}
+}
+
+/**
+ * \brief Connect \a slave to the bus of simulated SPI module \a spi_id
+ *
+ * \param spi_id SPI module ID.
+ * \param slave Function called for each byte sent, or NULL to leave the
+ * bus unconnected.
+ */
+void host_spi_set_slave(uint8_t spi_id, host_spi_slave_t slave)
+{
+	host_spi_of(spi_id)->slave = slave;
+}
+
+/**
+ * \brief Return the number of bytes written to the data register of
+ * simulated SPI module \a spi_id while it was busy
+ */
+unsigned int host_spi_get_collisions(uint8_t spi_id)
+{
+	return host_spi_of(spi_id)->collisions;
+}
+
+//! @}
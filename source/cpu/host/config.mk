@@ -0,0 +1,9 @@
+include $(src)/arch/host/config.mk
+
+CONFIG_CPU_HOST=y
+
+# Size of the host memory backing the internal SRAM pool
+CONFIG_HOST_SRAM_SIZE=0x10000
+
+config_mk		+= $(src)/cpu/host/config.mk
+platform-mkfiles	+= $(src)/cpu/host/cpu.mk
@@ -0,0 +1,16 @@
+incdir-y		+= $(src)/cpu/host/include
+
+src-$(CONFIG_PHYSMEM)	+= cpu/host/physmem_pools.c
+src-$(CONFIG_TOUCH_RESISTIVE)	+= cpu/host/touch.c
+
+hdr-y			+= cpu/host/include/cpu/dma.h
+hdr-y			+= include/generic/dma_nommu.h
+hdr-$(CONFIG_DMAPOOL)	+= cpu/host/include/cpu/dmapool.h
+hdr-$(CONFIG_DMAPOOL)	+= include/generic/dmapool_nommu.h
+hdr-$(CONFIG_PHYSMEM)	+= cpu/host/include/cpu/physmem.h
+hdr-$(CONFIG_PHYSMEM)	+= include/generic/physmem_nommu.h
+hdr-y			+= cpu/host/include/cpu/sleep.h
+hdr-$(CONFIG_SLEEPMGR)	+= cpu/host/include/cpu/sleepmgr.h
+hdr-y			+= cpu/host/include/cpu/unaligned.h
+hdr-y			+= include/generic/unaligned-direct.h
+hdr-$(CONFIG_TOUCH_RESISTIVE)	+= cpu/host/include/cpu/touch/resistive/touch.h
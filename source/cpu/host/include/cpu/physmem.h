@@ -0,0 +1,63 @@
+/**
+ * \file
+ *
+ * \brief Physical memory definitions for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_PHYSMEM_H_INCLUDED
+#define CPU_PHYSMEM_H_INCLUDED
+
+#include <stdint.h>
+
+/*
+ * Physical addresses are host pointers, so they need to be as wide as
+ * a pointer.
+ */
+
+/** \brief Type representing a physical address */
+typedef uintptr_t		phys_addr_t;
+
+/** \brief Type representing the size of a physical memory region */
+typedef uintptr_t		phys_size_t;
+
+/** \brief Return value indicating physical memory allocation failure. */
+#define PHYSMEM_ALLOC_ERR	((phys_addr_t)(-1))
+
+#include <generic/physmem_nommu.h>
+
+/* The internal SRAM is simulated by a single block of host memory */
+extern struct physmem_pool	cpu_sram_pool;
+#define dma_sram_pool		cpu_sram_pool
+
+#endif /* CPU_PHYSMEM_H_INCLUDED */
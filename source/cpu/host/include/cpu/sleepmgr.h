@@ -0,0 +1,77 @@
+/**
+ * \file
+ *
+ * \brief Sleep manager modes for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_SLEEPMGR_H_INCLUDED
+#define CPU_SLEEPMGR_H_INCLUDED
+
+#include <arch/host_clock.h>
+
+/**
+ * \weakgroup sleepmgr_group
+ * @{
+ */
+
+/**
+ * \brief Sleep modes of the host
+ *
+ * The host has no real sleep modes; sleeping in either of them moves
+ * the virtual clock forward to the next event. The deep mode is there
+ * so that the choice of mode and the locks taken by the drivers can be
+ * tested, and it shows up separately in the statistics.
+ */
+enum sleepmgr_mode {
+	SLEEPMGR_ACTIVE = 0,    //!< Don't sleep
+	SLEEPMGR_IDLE,          //!< Clock stopped, peripherals running
+	SLEEPMGR_DEEP,          //!< Peripheral clocks stopped too
+	SLEEPMGR_NR_MODES,
+};
+
+/**
+ * \internal
+ * \brief Enter sleep \a mode
+ *
+ * \pre Interrupts are disabled
+ * \post Interrupts are enabled
+ */
+static inline void cpu_sleepmgr_enter(enum sleepmgr_mode mode)
+{
+	host_idle();
+}
+
+//! @}
+
+#endif /* CPU_SLEEPMGR_H_INCLUDED */
@@ -0,0 +1,182 @@
+/**
+ * \file
+ *
+ * \brief Simulated resistive touch panel for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_TOUCH_H
+#define CPU_TOUCH_H
+
+#include <compiler.h>
+#include <stdint.h>
+#include <types.h>
+
+/**
+ * \ingroup touch_driver_4wres_group
+ * \defgroup touch_driver_4wres_host_group Host 4-wire resistive touch driver\
+ * internals
+ *
+ * On the host, the touch panel and the ADC are simulated. The panel is
+ * pressed, moved and released according to a script, which is read
+ * from the file given by the HOST_TOUCH_SCRIPT environment variable.
+ * Each line of the script has one of the following forms, where the
+ * time is given in milliseconds on the virtual clock and the
+ * coordinates are given in display pixels:
+ *
+ * \verbatim
+   <time> press <x> <y>
+   <time> move <x> <y>
+   <time> release\endverbatim
+ *
+ * Lines starting with '#' are ignored. The ADC returns the coordinates
+ * scaled linearly to 12 bits, so any calibration matrix computed
+ * against the display will map them back to the same pixels.
+ *
+ * @{
+ */
+
+/**
+ * \brief Number of samples returned per ADC sweep.
+ *
+ * The simulated ADC mimics the XMEGA ADC, which converts both ends of
+ * the touch surface twice in each sweep.
+ */
+#define TOUCH_ADC_SAMPLES_PER_SWEEP  2
+
+//! Touch surfaces which may be connected to the simulated ADC
+enum host_touch_surface {
+	HOST_TOUCH_SURFACE_X,
+	HOST_TOUCH_SURFACE_Y,
+};
+
+extern void host_touch_init(void);
+extern void host_touch_port_set_int(bool enable);
+extern bool host_touch_port_is_touched(void);
+extern void host_touch_port_set_detection(bool enable);
+extern void host_touch_adc_set_int(bool enable);
+extern void host_touch_adc_set_surface(enum host_touch_surface surface);
+extern void host_touch_adc_start(void);
+extern uint16_t host_touch_adc_get(void);
+
+__always_inline static void touch_priv_port_init(void)
+{
+	host_touch_init();
+}
+
+__always_inline static void touch_priv_port_enable_int(void)
+{
+	host_touch_port_set_int(true);
+}
+
+__always_inline static void touch_priv_port_disable_int(void)
+{
+	host_touch_port_set_int(false);
+}
+
+/**
+ * \brief Return current state of port interrupt flag.
+ *
+ * The simulated detection interrupt is level-sensitive, so the flag is
+ * set for as long as the panel is touched.
+ */
+__always_inline static bool touch_priv_port_is_int_flag_set(void)
+{
+	return host_touch_port_is_touched();
+}
+
+__always_inline static void touch_priv_port_clear_int_flag(void)
+{
+}
+
+__always_inline static void touch_priv_port_set_detection(void)
+{
+	host_touch_port_set_detection(true);
+}
+
+__always_inline static void touch_priv_port_set_gradient_x(void)
+{
+	host_touch_port_set_detection(false);
+}
+
+__always_inline static void touch_priv_port_set_gradient_y(void)
+{
+	host_touch_port_set_detection(false);
+}
+
+__always_inline static void touch_priv_adc_init(void)
+{
+}
+
+__always_inline static void touch_priv_adc_enable_int(void)
+{
+	host_touch_adc_set_int(true);
+}
+
+__always_inline static void touch_priv_adc_disable_int(void)
+{
+	host_touch_adc_set_int(false);
+}
+
+__always_inline static void touch_priv_adc_clear_int_flag(void)
+{
+}
+
+__always_inline static void touch_priv_adc_set_surface_y(void)
+{
+	host_touch_adc_set_surface(HOST_TOUCH_SURFACE_Y);
+}
+
+__always_inline static void touch_priv_adc_set_surface_x(void)
+{
+	host_touch_adc_set_surface(HOST_TOUCH_SURFACE_X);
+}
+
+__always_inline static void touch_priv_adc_start(void)
+{
+	host_touch_adc_start();
+}
+
+/**
+ * \brief Return sum of two means of the simulated ADC measurements.
+ */
+__always_inline static uint16_t touch_priv_adc_get_x(void)
+{
+	return host_touch_adc_get();
+}
+
+#define touch_priv_adc_get_y       touch_priv_adc_get_x
+
+//! @}
+
+#endif /* CPU_TOUCH_H */
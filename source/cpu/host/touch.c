@@ -0,0 +1,237 @@
+/**
+ * \file
+ *
+ * \brief Simulated resistive touch panel for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <intc.h>
+#include <arch/host_clock.h>
+#include <cpu/touch/resistive/touch.h>
+
+/**
+ * \weakgroup touch_driver_4wres_host_group
+ * @{
+ */
+
+#ifndef CONFIG_HOST_TOUCH_WIDTH
+# define CONFIG_HOST_TOUCH_WIDTH	320
+#endif
+#ifndef CONFIG_HOST_TOUCH_HEIGHT
+# define CONFIG_HOST_TOUCH_HEIGHT	240
+#endif
+
+//! Time taken by one ADC sweep, in microseconds.
+#define HOST_TOUCH_ADC_SWEEP_US		50
+
+//! Full scale value of the simulated 12-bit ADC.
+#define HOST_TOUCH_ADC_MAX		4095
+
+//! State of the simulated touch panel and ADC
+struct host_touch {
+	//! Script file, or NULL when the script has ended.
+	FILE			*script;
+	//! Event for the next line of the script.
+	struct host_event	script_event;
+	//! Event for completion of the ADC sweep in progress.
+	struct host_event	adc_event;
+	//! Current panel position, in display pixels.
+	unsigned int		x;
+	unsigned int		y;
+	//! Surface currently connected to the ADC.
+	enum host_touch_surface	surface;
+	//! Result of the last ADC sweep.
+	uint16_t		adc_result;
+	bool			touched;
+	//! Action read from the script, to be applied when due.
+	unsigned int		next_x;
+	unsigned int		next_y;
+	bool			next_touched;
+	bool			detection;
+	bool			port_int_enabled;
+	bool			adc_int_enabled;
+};
+
+static struct host_touch host_touch;
+
+/**
+ * \internal
+ * \brief Request the detection interrupt if it is active
+ *
+ * The detection interrupt is level-sensitive, so it stays active for as
+ * long as the panel is touched and the port is set up for detection.
+ */
+static void host_touch_update_port_int(void)
+{
+	if (host_touch.port_int_enabled && host_touch.detection
+			&& host_touch.touched)
+		host_irq_raise(CONFIG_TOUCH_PORT_IRQ_ID);
+}
+
+/**
+ * \internal
+ * \brief Read the next action from the script and schedule it
+ */
+static void host_touch_read_script(void)
+{
+	char		line[80];
+	char		action[16];
+	unsigned long	ms;
+	int		n;
+
+	while (fgets(line, sizeof(line), host_touch.script)) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+
+		n = sscanf(line, "%lu %15s %u %u", &ms, action,
+				&host_touch.next_x, &host_touch.next_y);
+		if (n == 2 && !strcmp(action, "release")) {
+			host_touch.next_touched = false;
+		} else if (n == 4 && (!strcmp(action, "press")
+					|| !strcmp(action, "move"))) {
+			host_touch.next_touched = true;
+		} else {
+			dbg_error("touch: bad script line: %s", line);
+			continue;
+		}
+
+		if ((host_time_t)ms * 1000 < host_clock_now())
+			ms = host_clock_now() / 1000;
+		host_event_schedule(&host_touch.script_event,
+				(host_time_t)ms * 1000 - host_clock_now());
+		return;
+	}
+
+	fclose(host_touch.script);
+	host_touch.script = NULL;
+}
+
+/**
+ * \internal
+ * \brief Apply the action read from the script
+ */
+static void host_touch_run_script(struct host_event *event)
+{
+	if (host_touch.next_touched) {
+		assert(host_touch.next_x < CONFIG_HOST_TOUCH_WIDTH);
+		assert(host_touch.next_y < CONFIG_HOST_TOUCH_HEIGHT);
+		host_touch.x = host_touch.next_x;
+		host_touch.y = host_touch.next_y;
+	}
+	host_touch.touched = host_touch.next_touched;
+	host_touch_update_port_int();
+
+	host_touch_read_script();
+}
+
+/**
+ * \internal
+ * \brief Complete the ADC sweep in progress
+ */
+static void host_touch_adc_done(struct host_event *event)
+{
+	unsigned long	value;
+
+	if (host_touch.surface == HOST_TOUCH_SURFACE_X)
+		value = (unsigned long)host_touch.x * HOST_TOUCH_ADC_MAX
+				/ (CONFIG_HOST_TOUCH_WIDTH - 1);
+	else
+		value = (unsigned long)host_touch.y * HOST_TOUCH_ADC_MAX
+				/ (CONFIG_HOST_TOUCH_HEIGHT - 1);
+
+	host_touch.adc_result = value * TOUCH_ADC_SAMPLES_PER_SWEEP;
+	if (host_touch.adc_int_enabled)
+		host_irq_raise(CONFIG_TOUCH_ADC_IRQ_ID);
+}
+
+void host_touch_init(void)
+{
+	const char	*path = getenv("HOST_TOUCH_SCRIPT");
+
+	host_event_init(&host_touch.script_event, host_touch_run_script);
+	host_event_init(&host_touch.adc_event, host_touch_adc_done);
+
+	if (!path)
+		return;
+
+	host_touch.script = fopen(path, "r");
+	if (!host_touch.script) {
+		dbg_error("touch: cannot open %s\n", path);
+		return;
+	}
+
+	host_touch_read_script();
+}
+
+void host_touch_port_set_int(bool enable)
+{
+	host_touch.port_int_enabled = enable;
+	host_touch_update_port_int();
+}
+
+bool host_touch_port_is_touched(void)
+{
+	return host_touch.detection && host_touch.touched;
+}
+
+void host_touch_port_set_detection(bool enable)
+{
+	host_touch.detection = enable;
+}
+
+void host_touch_adc_set_int(bool enable)
+{
+	host_touch.adc_int_enabled = enable;
+}
+
+void host_touch_adc_set_surface(enum host_touch_surface surface)
+{
+	host_touch.surface = surface;
+}
+
+void host_touch_adc_start(void)
+{
+	host_event_schedule(&host_touch.adc_event, HOST_TOUCH_ADC_SWEEP_US);
+}
+
+uint16_t host_touch_adc_get(void)
+{
+	return host_touch.adc_result;
+}
+
+//! @}
@@ -11,5 +11,6 @@ hdr-$(CONFIG_PHYSMEM)	+= cpu/mega/include/cpu/physmem.h
 hdr-$(CONFIG_PHYSMEM)	+= include/generic/physmem_nommu.h
 hdr-y			+= cpu/mega/include/cpu/regs.h
 hdr-y			+= cpu/mega/include/cpu/sleep.h
+hdr-$(CONFIG_SLEEPMGR)	+= cpu/mega/include/cpu/sleepmgr.h
 hdr-y			+= cpu/mega/include/cpu/unaligned.h
 hdr-y			+= include/generic/unaligned-direct.h
@@ -0,0 +1,113 @@
+/**
+ * \file
+ *
+ * \brief Sleep manager modes for megaAVR
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_SLEEPMGR_H_INCLUDED
+#define CPU_SLEEPMGR_H_INCLUDED
+
+#include <compiler.h>
+#include <chip/regs.h>
+
+/**
+ * \weakgroup sleepmgr_group
+ * @{
+ */
+
+/**
+ * \brief Sleep modes of megaAVR
+ *
+ * The I/O clock only runs in Idle mode, so the timers, SPI, USART and
+ * the USB controller with an active bus need Idle mode to keep working.
+ */
+enum sleepmgr_mode {
+	SLEEPMGR_ACTIVE = 0,    //!< Don't sleep
+	SLEEPMGR_IDLE,          //!< CPU and flash clocks stopped
+	SLEEPMGR_ADC,           //!< ADC Noise Reduction: I/O clock stopped
+	SLEEPMGR_ESTDBY,        //!< Extended Standby: Power-save, OSC on
+	SLEEPMGR_PSAVE,         //!< Power-save: Power-down, timer 2 running
+	SLEEPMGR_STDBY,         //!< Standby: Power-down, OSC on
+	SLEEPMGR_PDOWN,         //!< Power-down: all clocks stopped
+	SLEEPMGR_NR_MODES,
+};
+
+/**
+ * \internal
+ * \brief Enter sleep \a mode
+ *
+ * Interrupts are enabled right before the sleep instruction, which is
+ * always executed before any pending interrupt is handled.
+ *
+ * \pre Interrupts are disabled
+ * \post Interrupts are enabled
+ */
+static inline void cpu_sleepmgr_enter(enum sleepmgr_mode mode)
+{
+	uint8_t sm;
+
+	switch (mode) {
+	case SLEEPMGR_ADC:
+		sm = 1;
+		break;
+	case SLEEPMGR_ESTDBY:
+		sm = 7;
+		break;
+	case SLEEPMGR_PSAVE:
+		sm = 3;
+		break;
+	case SLEEPMGR_STDBY:
+		sm = 6;
+		break;
+	case SLEEPMGR_PDOWN:
+		sm = 2;
+		break;
+	default:
+		sm = 0;
+		break;
+	}
+
+	avr_write_reg8(SMCR, AVR_BF(SM, sm) | AVR_BIT(SE));
+#ifdef __GNUC__
+	asm volatile("sei\n\tsleep" ::: "memory");
+#else
+	__enable_interrupt();
+	__sleep();
+#endif
+	avr_write_reg8(SMCR, 0);
+}
+
+//! @}
+
+#endif /* CPU_SLEEPMGR_H_INCLUDED */
@@ -13,6 +13,7 @@ hdr-y			+= cpu/uc3/include/cpu/intc.h
 hdr-$(CONFIG_PHYSMEM)	+= cpu/uc3/include/cpu/physmem.h
 hdr-$(CONFIG_PHYSMEM)	+= include/generic/physmem_nommu.h
 hdr-y			+= cpu/uc3/include/cpu/sleep.h
+hdr-$(CONFIG_SLEEPMGR)	+= cpu/uc3/include/cpu/sleepmgr.h
 hdr-y			+= cpu/uc3/include/cpu/sysreg.h
 hdr-y			+= cpu/uc3/include/cpu/unaligned.h
 
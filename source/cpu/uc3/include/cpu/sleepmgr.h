@@ -0,0 +1,120 @@
+/**
+ * \file
+ *
+ * \brief Sleep manager modes for AVR32 UC3
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_SLEEPMGR_H_INCLUDED
+#define CPU_SLEEPMGR_H_INCLUDED
+
+#include <compiler.h>
+#include <chip/sleep.h>
+#include <cpu/sleep.h>
+
+/**
+ * \weakgroup sleepmgr_group
+ * @{
+ */
+
+/**
+ * \brief Sleep modes of UC3
+ *
+ * The PBA and PBB peripherals keep running in Frozen mode, but the
+ * DMA and the other HSB masters need Idle mode.
+ */
+enum sleepmgr_mode {
+	SLEEPMGR_ACTIVE = 0,    //!< Don't sleep
+	SLEEPMGR_IDLE,          //!< CPU clock stopped
+	SLEEPMGR_FROZEN,        //!< HSB clock stopped
+	SLEEPMGR_STANDBY,       //!< Peripheral clocks stopped
+	SLEEPMGR_STOP,          //!< Main OSCs and PLLs stopped
+	SLEEPMGR_DEEPSTOP,      //!< BOD and bandgap disabled
+	SLEEPMGR_STATIC,        //!< All clocks stopped
+	SLEEPMGR_NR_MODES,
+};
+
+#ifdef __GNUC__
+# define cpu_sleepmgr_priv_sleep(smode)                         \
+	asm volatile("sleep %0" :                               \
+			: "n"((smode) | SLEEP_MODE_CLEAR_GM)    \
+			: "memory")
+#else
+// Expand the mode before it is turned into a string.
+# define cpu_sleepmgr_priv_sleep(smode)                         \
+	cpu_sleepmgr_priv_sleep_str(smode)
+# define cpu_sleepmgr_priv_sleep_str(smode)                     \
+	do {                                                    \
+		barrier();                                      \
+		asm("sleep " #smode " | 0x80");                 \
+		barrier();                                      \
+	} while (0)
+#endif
+
+/**
+ * \internal
+ * \brief Enter sleep \a mode
+ *
+ * The sleep instruction takes the mode as an immediate operand, and
+ * enables interrupts atomically.
+ *
+ * \pre Interrupts are disabled
+ * \post Interrupts are enabled
+ */
+static inline void cpu_sleepmgr_enter(enum sleepmgr_mode mode)
+{
+	switch (mode) {
+	case SLEEPMGR_FROZEN:
+		cpu_sleepmgr_priv_sleep(SLEEP_MODE_FROZEN);
+		break;
+	case SLEEPMGR_STANDBY:
+		cpu_sleepmgr_priv_sleep(SLEEP_MODE_STANDBY);
+		break;
+	case SLEEPMGR_STOP:
+		cpu_sleepmgr_priv_sleep(SLEEP_MODE_STOP);
+		break;
+	case SLEEPMGR_DEEPSTOP:
+		cpu_sleepmgr_priv_sleep(SLEEP_MODE_DEEP_STOP);
+		break;
+	case SLEEPMGR_STATIC:
+		cpu_sleepmgr_priv_sleep(SLEEP_MODE_STATIC);
+		break;
+	default:
+		cpu_sleepmgr_priv_sleep(SLEEP_MODE_IDLE);
+		break;
+	}
+}
+
+//! @}
+
+#endif /* CPU_SLEEPMGR_H_INCLUDED */
@@ -2,16 +2,21 @@ incdir-y		+= $(src)/cpu/xmega/include
 
 src-y                   += cpu/xmega/ccp.S
 src-$(CONFIG_PHYSMEM)	+= cpu/xmega/physmem_pools.c
+src-$(CONFIG_HUGEMEM_DMA)	+= cpu/xmega/hugemem_dma.c
 
 hdr-y			+= cpu/xmega/include/cpu/dma.h
 hdr-y			+= include/generic/dma_nommu.h
 hdr-$(CONFIG_DMAPOOL)	+= cpu/xmega/include/cpu/dmapool.h
 hdr-$(CONFIG_DMAPOOL)	+= include/generic/dmapool_nommu.h
+hdr-$(CONFIG_HUGEMEM_DMA)	+= cpu/xmega/include/cpu/hugemem_dma.h
+hdr-$(CONFIG_HUGEMEM_DMA)	+= include/regs/xmega_dma.h
 hdr-y			+= cpu/xmega/include/cpu/io.h
 hdr-$(CONFIG_PHYSMEM)	+= cpu/xmega/include/cpu/physmem.h
 hdr-$(CONFIG_PHYSMEM)	+= include/generic/physmem_nommu.h
 hdr-y			+= cpu/xmega/include/cpu/regs.h
 hdr-y			+= cpu/xmega/include/cpu/sleep.h
+hdr-$(CONFIG_SLEEPMGR)	+= cpu/xmega/include/cpu/sleepmgr.h
+hdr-$(CONFIG_SLEEPMGR)	+= include/regs/xmega_sleep.h
 hdr-y			+= include/pmic.h
 hdr-y			+= include/pmic_regs.h
 hdr-$(CONFIG_HAVE_EBI)  += include/regs/xmega_ebi.h
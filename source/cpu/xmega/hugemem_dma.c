@@ -0,0 +1,420 @@
+/**
+ * \file
+ *
+ * \brief ATxmega DMA engine for huge memory block operations
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <hugemem.h>
+#include <interrupt.h>
+#include <intc.h>
+#include <pmic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
+#include <clk/sys.h>
+#include <chip/memory-map.h>
+#include <cpu/hugemem_dma.h>
+#include <regs/xmega_dma.h>
+
+#ifdef CONFIG_HUGEMEM_ASYNC
+# include <hugemem_async.h>
+# include <slist.h>
+# include <workqueue.h>
+#endif
+
+#ifdef CONFIG_SLEEPMGR
+# include <sleepmgr.h>
+#endif
+
+/**
+ * \weakgroup hugemem_dma_group
+ * @{
+ */
+
+/**
+ * \internal
+ * \brief Largest block to transfer in one go
+ *
+ * The block transfer count is 16 bits wide, and this keeps it a
+ * multiple of the 8-byte burst length.
+ */
+#define HUGEMEM_DMA_MAX_BLOCK   0x8000U
+
+//! True when the DMA controller has been enabled.
+static bool hugemem_dma_enabled;
+//! True while the synchronous channel is in use.
+static bool hugemem_dma_sync_busy;
+//! Fill pattern for the synchronous channel, reloaded after each burst.
+static uint8_t hugemem_dma_sync_pattern[8];
+
+#ifdef CONFIG_HUGEMEM_ASYNC
+//! Queue of asynchronous requests. The head is being transferred.
+static struct slist hugemem_dma_queue;
+//! Fill pattern for the asynchronous channel.
+static uint8_t hugemem_dma_async_pattern[8];
+
+static void hugemem_dma_priv_interrupt(void *int_data);
+
+INTC_DEFINE_HANDLER(PMIC_DMA_INT_CH3_IRQ, hugemem_dma_priv_interrupt,
+		CONFIG_HUGEMEM_DMA_INTLVL);
+#endif
+
+/**
+ * \internal
+ * \brief Enable the DMA controller if not done already
+ *
+ * Must be called with interrupts disabled.
+ */
+static void hugemem_dma_priv_enable(void)
+{
+	if (hugemem_dma_enabled)
+		return;
+
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_DMA);
+	dma_write_reg(CTRL, DMA_BIT(CTRL_ENABLE));
+
+#ifdef CONFIG_HUGEMEM_ASYNC
+	slist_init(&hugemem_dma_queue);
+	intc_setup_handler(PMIC_DMA_INT_CH3_IRQ, CONFIG_HUGEMEM_DMA_INTLVL,
+			NULL);
+#endif
+
+	hugemem_dma_enabled = true;
+}
+
+/**
+ * \internal
+ * \brief Start one block transfer on a DMA channel
+ *
+ * Blocks of 8 bytes or more are moved in 8-byte bursts, since the block
+ * size must be a multiple of the burst length. The remaining bytes are
+ * moved in a final block with 1-byte bursts.
+ *
+ * For fills, \a from points to an 8-byte pattern which is reloaded
+ * after each burst.
+ *
+ * \param ch     DMA channel to use.
+ * \param to     Destination address.
+ * \param from   Source address.
+ * \param size   Number of bytes left to move.
+ * \param fill   True if \a from is a fill pattern.
+ * \param intlvl Interrupt level for the transaction complete interrupt.
+ *
+ * \return Number of bytes in the block which was started.
+ */
+static uint16_t hugemem_dma_priv_start(uint8_t ch, uint32_t to,
+		uint32_t from, uint32_t size, bool fill, uint8_t intlvl)
+{
+	uint16_t        block;
+	uint8_t         burstlen;
+
+	block = min_u(size, HUGEMEM_DMA_MAX_BLOCK);
+	if (block >= 8) {
+		block &= ~7U;
+		burstlen = DMA_BURSTLEN_8BYTE;
+	} else {
+		burstlen = DMA_BURSTLEN_1BYTE;
+	}
+
+	if (fill)
+		dma_ch_write_reg(ch, ADDRCTRL,
+				DMA_BF(CH_ADDRCTRL_SRCRELOAD, DMA_RELOAD_BURST)
+				| DMA_BF(CH_ADDRCTRL_SRCDIR, DMA_DIR_INC)
+				| DMA_BF(CH_ADDRCTRL_DESTDIR, DMA_DIR_INC));
+	else
+		dma_ch_write_reg(ch, ADDRCTRL,
+				DMA_BF(CH_ADDRCTRL_SRCDIR, DMA_DIR_INC)
+				| DMA_BF(CH_ADDRCTRL_DESTDIR, DMA_DIR_INC));
+
+	dma_ch_write_reg(ch, TRIGSRC, 0);
+	dma_ch_write_reg16(ch, TRFCNT, block);
+	dma_ch_write_reg(ch, SRCADDR0, from);
+	dma_ch_write_reg(ch, SRCADDR1, from >> 8);
+	dma_ch_write_reg(ch, SRCADDR2, from >> 16);
+	dma_ch_write_reg(ch, DESTADDR0, to);
+	dma_ch_write_reg(ch, DESTADDR1, to >> 8);
+	dma_ch_write_reg(ch, DESTADDR2, to >> 16);
+
+	// Clear any old flags, and set the interrupt levels.
+	dma_ch_write_reg(ch, CTRLB, DMA_BIT(CH_CTRLB_TRNIF)
+			| DMA_BIT(CH_CTRLB_ERRIF)
+			| DMA_BF(CH_CTRLB_TRNINTLVL, intlvl)
+			| DMA_BF(CH_CTRLB_ERRINTLVL, intlvl));
+
+	dma_ch_write_reg(ch, CTRLA, DMA_BIT(CH_CTRLA_ENABLE)
+			| DMA_BF(CH_CTRLA_BURSTLEN, burstlen));
+	dma_ch_write_reg(ch, CTRLA, DMA_BIT(CH_CTRLA_ENABLE)
+			| DMA_BIT(CH_CTRLA_TRFREQ)
+			| DMA_BF(CH_CTRLA_BURSTLEN, burstlen));
+
+	return block;
+}
+
+/**
+ * \internal
+ * \brief Claim the synchronous DMA channel
+ *
+ * \retval true  The channel is ours until it is released.
+ * \retval false The channel is in use, e.g., by code we have interrupted.
+ */
+static bool hugemem_dma_priv_claim(void)
+{
+	irqflags_t      iflags;
+	bool            claimed = false;
+
+	iflags = cpu_irq_save();
+	hugemem_dma_priv_enable();
+	if (!hugemem_dma_sync_busy) {
+		hugemem_dma_sync_busy = true;
+		claimed = true;
+	}
+	cpu_irq_restore(iflags);
+
+	return claimed;
+}
+
+/**
+ * \internal
+ * \brief Move \a size bytes on the synchronous DMA channel
+ *
+ * \pre The synchronous channel has been claimed.
+ */
+static void hugemem_dma_priv_run(uint32_t to, uint32_t from, uint32_t size,
+		bool fill)
+{
+	const uint8_t   ch = HUGEMEM_DMA_SYNC_CH;
+	uint16_t        block;
+	uint8_t         flags;
+
+	while (size > 0) {
+		block = hugemem_dma_priv_start(ch, to, from, size, fill,
+				PMIC_INTLVL_OFF);
+
+		do {
+			flags = dma_ch_read_reg(ch, CTRLB);
+		} while (!(flags & (DMA_BIT(CH_CTRLB_TRNIF)
+				| DMA_BIT(CH_CTRLB_ERRIF))));
+
+		assert(!(flags & DMA_BIT(CH_CTRLB_ERRIF)));
+		dma_ch_write_reg(ch, CTRLB, DMA_BIT(CH_CTRLB_TRNIF)
+				| DMA_BIT(CH_CTRLB_ERRIF));
+
+		to += block;
+		if (!fill)
+			from += block;
+		size -= block;
+	}
+
+	hugemem_dma_sync_busy = false;
+}
+
+/**
+ * \brief Copy a block of memory with the DMA controller
+ *
+ * \param to   Destination address in the data memory space.
+ * \param from Source address in the data memory space.
+ * \param size Number of bytes to copy.
+ *
+ * \retval true  The block has been copied.
+ * \retval false The DMA channel was busy, and nothing was done.
+ */
+bool hugemem_dma_copy(uint32_t to, uint32_t from, uint32_t size)
+{
+	if (!hugemem_dma_priv_claim())
+		return false;
+
+	hugemem_dma_priv_run(to, from, size, false);
+
+	return true;
+}
+
+/**
+ * \brief Fill a block of memory with the DMA controller
+ *
+ * \param to    Destination address in the data memory space.
+ * \param value Value to fill with.
+ * \param size  Number of bytes to fill.
+ *
+ * \retval true  The block has been filled.
+ * \retval false The DMA channel was busy, and nothing was done.
+ */
+bool hugemem_dma_fill(uint32_t to, uint8_t value, uint32_t size)
+{
+	uint8_t         i;
+
+	if (!hugemem_dma_priv_claim())
+		return false;
+
+	for (i = 0; i < ARRAY_LEN(hugemem_dma_sync_pattern); i++)
+		hugemem_dma_sync_pattern[i] = value;
+
+	hugemem_dma_priv_run(to,
+			(uint32_t)(uintptr_t)hugemem_dma_sync_pattern,
+			size, true);
+
+	return true;
+}
+
+#ifdef CONFIG_HUGEMEM_ASYNC
+
+/**
+ * \internal
+ * \brief Start the next block of \a req on the asynchronous channel
+ *
+ * Must be called with interrupts disabled.
+ */
+static void hugemem_dma_priv_next_block(struct hugemem_request *req)
+{
+	uint32_t        from;
+	uint16_t        block;
+	uint8_t         i;
+
+	if (req->fill) {
+		for (i = 0; i < ARRAY_LEN(hugemem_dma_async_pattern); i++)
+			hugemem_dma_async_pattern[i] = req->value;
+		from = (uint32_t)(uintptr_t)hugemem_dma_async_pattern;
+	} else {
+		from = (uint32_t)req->from;
+	}
+
+	block = hugemem_dma_priv_start(HUGEMEM_DMA_ASYNC_CH,
+			(uint32_t)req->to, from, req->size, req->fill,
+			CONFIG_HUGEMEM_DMA_INTLVL);
+
+	req->to = (hugemem_ptr_t)((uint32_t)req->to + block);
+	if (!req->fill)
+		req->from = (hugemem_ptr_t)((uint32_t)req->from + block);
+	req->size -= block;
+}
+
+/**
+ * \internal
+ * \brief Interrupt handler for the asynchronous DMA channel
+ *
+ * Starts the next block of the current request, or completes it and
+ * starts the next request in the queue.
+ */
+static void hugemem_dma_priv_interrupt(void *int_data)
+{
+	struct hugemem_request  *req;
+	uint8_t                 flags;
+
+	flags = dma_ch_read_reg(HUGEMEM_DMA_ASYNC_CH, CTRLB);
+	assert(!(flags & DMA_BIT(CH_CTRLB_ERRIF)));
+	dma_ch_write_reg(HUGEMEM_DMA_ASYNC_CH, CTRLB, DMA_BIT(CH_CTRLB_TRNIF)
+			| DMA_BIT(CH_CTRLB_ERRIF));
+
+	req = slist_peek_head(&hugemem_dma_queue, struct hugemem_request, node);
+	if (req->size == 0) {
+		slist_pop_head_node(&hugemem_dma_queue);
+		if (req->task)
+			workqueue_add_task(&main_workqueue, req->task);
+		if (slist_is_empty(&hugemem_dma_queue)) {
+#ifdef CONFIG_SLEEPMGR
+			sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
+			return;
+		}
+		req = slist_peek_head(&hugemem_dma_queue,
+				struct hugemem_request, node);
+	}
+
+	hugemem_dma_priv_next_block(req);
+}
+
+/**
+ * \internal
+ * \brief Queue \a req, and start it if the channel is idle
+ */
+static void hugemem_dma_priv_queue(struct hugemem_request *req)
+{
+	irqflags_t      iflags;
+	bool            idle;
+
+	if (req->size == 0) {
+		if (req->task)
+			workqueue_add_task(&main_workqueue, req->task);
+		return;
+	}
+
+	iflags = cpu_irq_save();
+	hugemem_dma_priv_enable();
+	idle = slist_is_empty(&hugemem_dma_queue);
+	slist_insert_tail(&hugemem_dma_queue, &req->node);
+	if (idle) {
+		/*
+		 * The DMA controller runs on the peripheral clock, so
+		 * don't sleep deeper than Idle until the queue is empty.
+		 */
+#ifdef CONFIG_SLEEPMGR
+		sleepmgr_lock_mode(SLEEPMGR_IDLE);
+#endif
+		hugemem_dma_priv_next_block(req);
+	}
+	cpu_irq_restore(iflags);
+}
+
+void hugemem_copy_async(struct hugemem_request *req, hugemem_ptr_t to,
+		const hugemem_ptr_t from, uint32_t size,
+		struct workqueue_task *task)
+{
+	assert(req);
+
+	req->to = to;
+	req->from = from;
+	req->size = size;
+	req->task = task;
+	req->fill = false;
+
+	hugemem_dma_priv_queue(req);
+}
+
+void hugemem_fill_async(struct hugemem_request *req, hugemem_ptr_t to,
+		uint8_t value, uint32_t size, struct workqueue_task *task)
+{
+	assert(req);
+
+	req->to = to;
+	req->value = value;
+	req->size = size;
+	req->task = task;
+	req->fill = true;
+
+	hugemem_dma_priv_queue(req);
+}
+
+#endif /* CONFIG_HUGEMEM_ASYNC */
+
+//! @}
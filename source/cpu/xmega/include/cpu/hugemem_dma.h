@@ -0,0 +1,86 @@
+/**
+ * \file
+ *
+ * \brief ATxmega DMA engine for huge memory block operations
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_HUGEMEM_DMA_H_INCLUDED
+#define CPU_HUGEMEM_DMA_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \ingroup hugemem_group
+ * \defgroup hugemem_dma_group ATxmega Huge Memory DMA Engine
+ *
+ * Copies and fills of at least \a CONFIG_HUGEMEM_DMA_THRESHOLD bytes
+ * are done by DMA channel #HUGEMEM_DMA_SYNC_CH, which is polled until
+ * the operation is done. The DMA address counters are 24 bits wide, so
+ * a single operation is not limited to one 64 kB bank.
+ *
+ * Asynchronous requests, see \ref hugemem_async_group, are handled by
+ * channel #HUGEMEM_DMA_ASYNC_CH, which interrupts the CPU at
+ * \a CONFIG_HUGEMEM_DMA_INTLVL when a block is done.
+ *
+ * Channel 0 is left alone, since the display drivers use it.
+ *
+ * @{
+ */
+
+//! Minimum number of bytes to use the DMA controller for.
+#ifndef CONFIG_HUGEMEM_DMA_THRESHOLD
+# define CONFIG_HUGEMEM_DMA_THRESHOLD   128
+#endif
+
+#if CONFIG_HUGEMEM_DMA_THRESHOLD < 8
+# error CONFIG_HUGEMEM_DMA_THRESHOLD must be at least 8
+#endif
+
+//! Interrupt level of the asynchronous DMA channel.
+#ifndef CONFIG_HUGEMEM_DMA_INTLVL
+# define CONFIG_HUGEMEM_DMA_INTLVL      PMIC_INTLVL_LOW
+#endif
+
+//! DMA channel used for synchronous operations.
+#define HUGEMEM_DMA_SYNC_CH             2
+//! DMA channel used for asynchronous operations.
+#define HUGEMEM_DMA_ASYNC_CH            3
+
+bool hugemem_dma_copy(uint32_t to, uint32_t from, uint32_t size);
+bool hugemem_dma_fill(uint32_t to, uint8_t value, uint32_t size);
+
+//! @}
+
+#endif /* CPU_HUGEMEM_DMA_H_INCLUDED */
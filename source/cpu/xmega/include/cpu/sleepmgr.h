@@ -0,0 +1,110 @@
+/**
+ * \file
+ *
+ * \brief Sleep manager modes for XMEGA
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CPU_SLEEPMGR_H_INCLUDED
+#define CPU_SLEEPMGR_H_INCLUDED
+
+#include <compiler.h>
+#include <regs/xmega_sleep.h>
+
+/**
+ * \weakgroup sleepmgr_group
+ * @{
+ */
+
+/**
+ * \brief Sleep modes of XMEGA
+ *
+ * The peripheral clocks only run in Idle mode, so all peripherals
+ * except the RTC, the asynchronous pin change interrupts and the TWI
+ * address match need Idle mode to keep working.
+ */
+enum sleepmgr_mode {
+	SLEEPMGR_ACTIVE = 0,    //!< Don't sleep
+	SLEEPMGR_IDLE,          //!< CPU clock stopped
+	SLEEPMGR_ESTDBY,        //!< Extended Standby: Power-save, OSCs on
+	SLEEPMGR_PSAVE,         //!< Power-save: Power-down, RTC running
+	SLEEPMGR_STDBY,         //!< Standby: Power-down, OSCs on
+	SLEEPMGR_PDOWN,         //!< Power-down: all clocks stopped
+	SLEEPMGR_NR_MODES,
+};
+
+/**
+ * \internal
+ * \brief Enter sleep \a mode
+ *
+ * Interrupts are enabled right before the sleep instruction, which is
+ * always executed before any pending interrupt is handled.
+ *
+ * \pre Interrupts are disabled
+ * \post Interrupts are enabled
+ */
+static inline void cpu_sleepmgr_enter(enum sleepmgr_mode mode)
+{
+	uint8_t smode;
+
+	switch (mode) {
+	case SLEEPMGR_ESTDBY:
+		smode = SLEEP_SMODE_ESTDBY;
+		break;
+	case SLEEPMGR_PSAVE:
+		smode = SLEEP_SMODE_PSAVE;
+		break;
+	case SLEEPMGR_STDBY:
+		smode = SLEEP_SMODE_STDBY;
+		break;
+	case SLEEPMGR_PDOWN:
+		smode = SLEEP_SMODE_PDOWN;
+		break;
+	default:
+		smode = SLEEP_SMODE_IDLE;
+		break;
+	}
+
+	sleep_write_reg(CTRL, SLEEP_BF(SMODE, smode) | SLEEP_BIT(SEN));
+#ifdef __GNUC__
+	asm volatile("sei\n\tsleep" ::: "memory");
+#else
+	__enable_interrupt();
+	__sleep();
+#endif
+	sleep_write_reg(CTRL, 0);
+}
+
+//! @}
+
+#endif /* CPU_SLEEPMGR_H_INCLUDED */
@@ -55,8 +55,9 @@
  * associated, i.e., port A for ADCA and port B for ADCB.
  *
  * The ADC is configured for measurements from both "ends" of the tri-stated
- * touch surfaces for improved accuracy, and an interrupt is only generated
- * when both conversions have been made.
+ * touch surfaces for improved accuracy. All four ADC channels are used, so
+ * that each sweep samples both ends twice, and an interrupt is only generated
+ * when the last conversion of the sweep has been made.
  *
  * @{
  */
@@ -74,6 +75,14 @@
 #define TOUCH_Y_MASK          (TOUCH_YD_MASK | TOUCH_YU_MASK)
 //@}
 
+/**
+ * \brief Number of samples returned per ADC sweep.
+ *
+ * Each sweep converts both ends of the touch surface twice, and
+ * touch_priv_adc_get_x() returns the sum of two mean values.
+ */
+#define TOUCH_ADC_SAMPLES_PER_SWEEP  2
+
 /**
  * \brief Initialize port for touch detection.
  *
@@ -213,7 +222,7 @@ __always_inline static void touch_priv_port_set_gradient_y(void)
 /**
  * \brief Initialize the ADC for readings from touch surfaces.
  *
- * Initializes ADC reference selection, channels 0 and 1, and clock prescaling.
+ * Initializes ADC reference selection, channels 0 to 3, and clock prescaling.
  */
 __always_inline static void touch_priv_adc_init(void)
 {
@@ -225,11 +234,15 @@ __always_inline static void touch_priv_adc_init(void)
 	adc_write_reg(CONFIG_TOUCH_ADC_BASE, REFCTRL,
 			ADC_BF(REFSEL, ADC_REFSEL_INTVCC));
 
-	// Set ADC channel 0 and 1 to single ended input mode.
+	// Set ADC channel 0 to 3 to single ended input mode.
 	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH0, CTRL,
 			ADCCH_BF(INPUTMODE, ADCCH_INPUTMODE_SINGLEENDED));
 	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH1, CTRL,
 			ADCCH_BF(INPUTMODE, ADCCH_INPUTMODE_SINGLEENDED));
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH2, CTRL,
+			ADCCH_BF(INPUTMODE, ADCCH_INPUTMODE_SINGLEENDED));
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH3, CTRL,
+			ADCCH_BF(INPUTMODE, ADCCH_INPUTMODE_SINGLEENDED));
 
 	// Enable the ADC.
 	adc_write_reg(CONFIG_TOUCH_ADC_BASE, CTRLA, ADC_BIT(ENABLE));
@@ -239,11 +252,12 @@ __always_inline static void touch_priv_adc_init(void)
 /**
  * \brief Enable ADC interrupts.
  *
- * Sets configured level for ADC interrupt on channel 1.
+ * Sets configured level for ADC interrupt on channel 3, which is the last
+ * channel to complete in a sweep.
  */
 __always_inline static void touch_priv_adc_enable_int(void)
 {
-	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH1, INTCTRL,
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH3, INTCTRL,
 			ADCCH_BF(INTLVL, CONFIG_TOUCH_ADC_INTLVL));
 }
 
@@ -251,11 +265,11 @@ __always_inline static void touch_priv_adc_enable_int(void)
 /**
  * \brief Disable ADC interrupts.
  *
- * Sets level for ADC interrupt on channel 1 to OFF.
+ * Sets level for ADC interrupt on channel 3 to OFF.
  */
 __always_inline static void touch_priv_adc_disable_int(void)
 {
-	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH1, INTCTRL,
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH3, INTCTRL,
 			ADCCH_BF(INTLVL, ADCCH_INTLVL_OFF));
 }
 
@@ -265,15 +279,15 @@ __always_inline static void touch_priv_adc_disable_int(void)
  */
 __always_inline static void touch_priv_adc_clear_int_flag(void)
 {
-	adc_write_reg(CONFIG_TOUCH_ADC_BASE, INTFLAGS, ADC_BIT(CH1IF));
+	adc_write_reg(CONFIG_TOUCH_ADC_BASE, INTFLAGS, ADC_BIT(CH3IF));
 }
 
 
 /**
  * \brief Start ADC scan sequence to measure position on Y surface.
  *
- * Configure ADC channel 0 and 1 to measure from XL and XR, then trigger
- * conversions on both channels.
+ * Configure ADC channel 0 and 2 to measure from XL, and channel 1 and 3 to
+ * measure from XR.
  *
  * The voltage on the XL and XR pins depends on the position along the Y axis.
  * By reading both XL and XR, the effect of touch proximity to either of these
@@ -285,14 +299,18 @@ __always_inline static void touch_priv_adc_set_surface_y(void)
 			ADCCH_BF(MUXPOS, CONFIG_TOUCH_XL_PIN));
 	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH1, MUXCTRL,
 			ADCCH_BF(MUXPOS, CONFIG_TOUCH_XR_PIN));
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH2, MUXCTRL,
+			ADCCH_BF(MUXPOS, CONFIG_TOUCH_XL_PIN));
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH3, MUXCTRL,
+			ADCCH_BF(MUXPOS, CONFIG_TOUCH_XR_PIN));
 }
 
 
 /**
  * \brief Set ADC scan sequence to measure position on X surface.
  *
- * Configure ADC channel 0 and 1 to measure from YD and YU, then trigger
- * conversions on both channels.
+ * Configure ADC channel 0 and 2 to measure from YD, and channel 1 and 3 to
+ * measure from YU.
  */
 __always_inline static void touch_priv_adc_set_surface_x(void)
 {
@@ -300,38 +318,48 @@ __always_inline static void touch_priv_adc_set_surface_x(void)
 			ADCCH_BF(MUXPOS, CONFIG_TOUCH_YD_PIN));
 	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH1, MUXCTRL,
 			ADCCH_BF(MUXPOS, CONFIG_TOUCH_YU_PIN));
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH2, MUXCTRL,
+			ADCCH_BF(MUXPOS, CONFIG_TOUCH_YD_PIN));
+	adcch_write_reg(CONFIG_TOUCH_ADC_BASE, CH3, MUXCTRL,
+			ADCCH_BF(MUXPOS, CONFIG_TOUCH_YU_PIN));
 }
 
 
 /**
  * \brief Trigger AD conversions.
  *
- * Starts conversions on ADC channels 0 and 1.
+ * Starts a sweep of conversions on ADC channels 0 to 3.
  */
 __always_inline static void touch_priv_adc_start(void)
 {
 	adc_write_reg(CONFIG_TOUCH_ADC_BASE, CTRLA,
-			ADC_BF(CHSTART, ADC_CHSTART_0 | ADC_CHSTART_1)
+			ADC_BF(CHSTART, ADC_CHSTART_0 | ADC_CHSTART_1
+				| ADC_CHSTART_2 | ADC_CHSTART_3)
 			| ADC_BIT(ENABLE));
 }
 
 
 /**
- * \brief Return mean of YD and YU ADC measurements.
+ * \brief Return sum of two means of YD and YU ADC measurements.
  *
- * This function returns the mean of the last YD and YU ADC readings.
+ * This function returns the mean of the last YD and YU ADC readings, scaled
+ * by \ref TOUCH_ADC_SAMPLES_PER_SWEEP.
  */
 __always_inline static uint16_t touch_priv_adc_get_x(void)
 {
 	uint16_t adc_result;
 
-	// Read CH0 result, add CH1 result and divide by two.
+	// Sum the results of all four channels.
 	adc_result = adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH0RESL);
 	adc_result |= adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH0RESH) << 8;
 	adc_result += adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH1RESL);
 	adc_result += adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH1RESH) << 8;
+	adc_result += adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH2RESL);
+	adc_result += adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH2RESH) << 8;
+	adc_result += adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH3RESL);
+	adc_result += adc_read_reg(CONFIG_TOUCH_ADC_BASE, CH3RESH) << 8;
 
-	// Divide by two to get the mean.
+	// Divide by two to get the sum of two means.
 	adc_result >>= 1;
 
 	return (adc_result);
@@ -339,7 +367,7 @@ __always_inline static uint16_t touch_priv_adc_get_x(void)
 
 
 /**
- * \brief Return mean of XL and XR ADC measurements.
+ * \brief Return sum of two means of XL and XR ADC measurements.
  *
  * \note Measurements are computed in the same way for both X and Y surfaces.
  */
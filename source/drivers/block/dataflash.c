@@ -96,10 +96,21 @@ read-back flash into buffer"];
 		WRITE_WAIT -> PAGE_DONE [label="ready"];
 		PAGE_DONE -> SETUP_WRITE [label="more pages to write"];
 		PAGE_DONE -> SETUP_READ [label="more pages to read"];
+		SETUP_READ -> TRANSFER [label="streaming read"];
 		PAGE_DONE -> IDLE [label="last page"];
 	}
  * \enddot
  *
+ * \section dataflash_streaming_read Streaming reads
+ *
+ * When the DataFlash is configured for power-of-2 page size, the continous
+ * array read command streams through consecutive pages without any gaps.
+ * A read request is then started with a single command and the device is
+ * kept selected until the last page of the request has been read, so only
+ * the first page pays for the command and chip select overhead. Otherwise
+ * the extra bytes at the end of each page are skipped by issuing a new
+ * command for every page.
+ *
  * @{
  */
 
@@ -120,6 +131,8 @@ struct dataflash_breq {
 	enum block_operation  operation;
 	//! Indicates if operation is waiting for free buffers
 	bool                  sleeping;
+	//! Indicates if a continous read is in progress across pages
+	bool                  streaming;
 };
 
 //! DataFlash specific block device
@@ -285,6 +298,7 @@ static void dataflash_page_done(struct workqueue_task *task)
 
 	df_breq->breq.buf_list_done(&df_bdev->bdev, &df_breq->breq,
 			&df_bdev->current_buf_list);
+	slist_init(&df_bdev->current_buf_list);
 	df_breq->breq.bytes_xfered += df_bdev->transfer_pos;
 	df_breq->remaining_blocks -=
 			df_bdev->transfer_pos / DATAFLASH_BLOCK_SIZE;
@@ -365,8 +379,14 @@ static void dataflash_read_done(struct workqueue_task *task)
 {
 	struct dataflash_breq *df_breq = dataflash_breq_of_task(task);
 	struct dataflash_bdev *df_bdev = dataflash_bdev_of(df_breq->breq.bdev);
+	block_len_t           blocks;
 
-	at45_deselect(&df_bdev->at45d);
+	// Keep streaming unless this was the last page of the request
+	blocks = df_bdev->transfer_pos / DATAFLASH_BLOCK_SIZE;
+	if (!df_breq->streaming || blocks == df_breq->remaining_blocks) {
+		at45_deselect(&df_bdev->at45d);
+		df_breq->streaming = false;
+	}
 	dataflash_page_done(task);
 }
 
@@ -379,6 +399,15 @@ static void dataflash_read_setup(struct workqueue_task *task)
 
 	df_bdev->transfer_pos = 0;
 
+	if (df_breq->streaming) {
+		// Device is still selected and streaming the next page
+		dataflash_transfer(task);
+		return;
+	}
+
+	df_breq->streaming = test_bit(AT45_FLAG_BINARY_PAGE,
+			&df_bdev->at45d.flags);
+
 	at45_select(&df_bdev->at45d);
 	at45_cmd_cont_array_read(&df_bdev->at45d, df_breq->lba >> 1,
 			(df_breq->lba & 1) << 9);
@@ -542,6 +571,7 @@ static void dataflash_prepare_req(struct block_device *bdev,
 	df_breq->remaining_blocks = nr_blocks;
 	df_breq->operation = operation;
 	df_breq->sleeping = false;
+	df_breq->streaming = false;
 }
 
 //! \see block_alloc_request
@@ -0,0 +1,349 @@
+/**
+ * \file
+ *
+ * \brief File-backed block device for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <bitops.h>
+#include <buffer.h>
+#include <debug.h>
+#include <interrupt.h>
+#include <malloc.h>
+#include <mempool.h>
+#include <physmem.h>
+#include <status_codes.h>
+#include <util.h>
+#include <workqueue.h>
+#include <arch/host_clock.h>
+#include <block/device.h>
+#include <block/host_file.h>
+
+/**
+ * \ingroup block_device_host_file_group
+ * \defgroup block_device_host_file_internals_group Internal Documentation
+ *
+ * Requests are processed synchronously from the main workqueue: each time
+ * the request task runs, all buffers submitted so far are transferred to or
+ * from the file and handed back to the client. When no buffers are
+ * available the request goes to sleep until the client submits more.
+ *
+ * If the \c HOST_BLOCK_LATENCY environment variable is set, each buffer
+ * is held back for that many microseconds per block on the virtual clock
+ * before it is handed back, and the next buffer is not started until
+ * then. This gives the clients the same chance of overlapping their work
+ * with the transfers as they get with a real storage device.
+ *
+ * @{
+ */
+
+//! The host file block device block size
+#define HOST_FILE_BLOCK_SIZE    512
+
+//! Host file specific block device request
+struct host_file_breq {
+	//! Base block request
+	struct block_request    breq;
+	//! Task associated with this request
+	struct workqueue_task   task;
+	//! Byte offset of the next transfer in the file
+	off_t                   offset;
+	//! Number of bytes left to transfer
+	block_len_t             remaining;
+	//! Operation to process (read, write)
+	enum block_operation    operation;
+	//! Indicates if operation is waiting for free buffers
+	bool                    sleeping;
+	//! Buffers transferred but not yet handed back
+	struct slist            delayed_list;
+	//! Virtual clock event for the end of the access time
+	struct host_event       event;
+};
+
+//! Host file specific block device
+struct host_file_bdev {
+	//! Base block device
+	struct block_device     bdev;
+	//! File descriptor of the backing file
+	int                     fd;
+	//! Memory pool used to allocate memory for \ref host_file_breq
+	struct mem_pool         req_pool;
+	//! Access time in microseconds per block, or 0 for none
+	host_time_t             block_latency;
+};
+
+static inline struct host_file_breq *host_file_breq_of(
+		struct block_request *req)
+{
+	return container_of(req, struct host_file_breq, breq);
+}
+
+static inline struct host_file_bdev *host_file_bdev_of(
+		struct block_device *dev)
+{
+	return container_of(dev, struct host_file_bdev, bdev);
+}
+
+static inline struct host_file_breq *host_file_breq_of_task(
+		struct workqueue_task *task)
+{
+	return container_of(task, struct host_file_breq, task);
+}
+
+/**
+ * \brief Transfer all buffers currently queued on a request
+ *
+ * \param task Workqueue task of the request
+ */
+static void host_file_transfer(struct workqueue_task *task)
+{
+	struct host_file_breq   *hf_breq = host_file_breq_of_task(task);
+	struct block_request    *breq = &hf_breq->breq;
+	struct host_file_bdev   *hf_bdev = host_file_bdev_of(breq->bdev);
+	struct slist            done_list;
+	struct buffer           *buf;
+	ssize_t                 len;
+	irqflags_t              flags;
+
+	slist_init(&done_list);
+	if (!slist_is_empty(&hf_breq->delayed_list))
+		slist_move_to_tail(&done_list, &hf_breq->delayed_list);
+
+	while (hf_breq->remaining && slist_is_empty(&hf_breq->delayed_list)) {
+		flags = cpu_irq_save();
+		if (slist_is_empty(&breq->buf_list)) {
+			dbg_verbose("HostFile: sleep\n");
+			hf_breq->sleeping = true;
+			cpu_irq_restore(flags);
+			break;
+		}
+		buf = buf_list_pop_head(&breq->buf_list);
+		cpu_irq_restore(flags);
+
+		assert(buf->len <= hf_breq->remaining);
+
+		if (hf_breq->operation == BLK_OP_READ)
+			len = pread(hf_bdev->fd, buf->addr.ptr, buf->len,
+					hf_breq->offset);
+		else
+			len = pwrite(hf_bdev->fd, buf->addr.ptr, buf->len,
+					hf_breq->offset);
+
+		if (len != (ssize_t)buf->len) {
+			slist_insert_tail(&done_list, &buf->node);
+			dbg_error("HostFile: I/O error @ %ld\n",
+					(long)hf_breq->offset);
+			breq->status = ERR_IO_ERROR;
+			breq->buf_list_done(breq->bdev, breq, &done_list);
+			breq->req_done(breq->bdev, breq);
+			return;
+		}
+
+		hf_breq->offset += len;
+		hf_breq->remaining -= len;
+		breq->bytes_xfered += len;
+
+		if (hf_bdev->block_latency) {
+			slist_insert_tail(&hf_breq->delayed_list, &buf->node);
+			host_event_schedule(&hf_breq->event,
+					hf_bdev->block_latency
+					* (len / HOST_FILE_BLOCK_SIZE));
+		} else {
+			slist_insert_tail(&done_list, &buf->node);
+		}
+	}
+
+	if (!slist_is_empty(&done_list))
+		breq->buf_list_done(breq->bdev, breq, &done_list);
+
+	if (!hf_breq->remaining && slist_is_empty(&hf_breq->delayed_list)) {
+		dbg_verbose("HostFile: req done\n");
+		breq->status = STATUS_OK;
+		breq->req_done(breq->bdev, breq);
+	}
+}
+
+static void host_file_access_done(struct host_event *event)
+{
+	struct host_file_breq *hf_breq =
+		container_of(event, struct host_file_breq, event);
+
+	workqueue_add_task(&main_workqueue, &hf_breq->task);
+}
+
+//! \see block_submit_req
+static void host_file_submit(struct block_device *bdev,
+		struct block_request *breq)
+{
+	struct host_file_breq *hf_breq = host_file_breq_of(breq);
+
+	workqueue_add_task(&main_workqueue, &hf_breq->task);
+}
+
+//! \see block_submit_buf_list
+static int host_file_submit_buf_list(struct block_device *bdev,
+		struct block_request *breq, struct slist *buf_list)
+{
+	struct host_file_breq *hf_breq = host_file_breq_of(breq);
+
+	slist_move_to_tail(&breq->buf_list, buf_list);
+	if (hf_breq->sleeping) {
+		dbg_verbose("HostFile: wakeup\n");
+		hf_breq->sleeping = false;
+		workqueue_add_task(&main_workqueue, &hf_breq->task);
+	}
+
+	return STATUS_OK;
+}
+
+//! \see block_prepare_req
+static void host_file_prepare_req(struct block_device *bdev,
+		struct block_request *breq,
+		block_addr_t lba, block_len_t nr_blocks,
+		enum block_operation operation)
+{
+	struct host_file_breq *hf_breq = host_file_breq_of(breq);
+
+	assert(lba + nr_blocks <= bdev->nr_blocks);
+
+	breq->status = OPERATION_IN_PROGRESS;
+	breq->bytes_xfered = 0;
+	workqueue_task_init(&hf_breq->task, host_file_transfer);
+	hf_breq->offset = (off_t)lba * HOST_FILE_BLOCK_SIZE;
+	hf_breq->remaining = nr_blocks * HOST_FILE_BLOCK_SIZE;
+	hf_breq->operation = operation;
+	hf_breq->sleeping = false;
+}
+
+//! \see block_alloc_request
+static struct block_request *host_file_alloc_req(struct block_device *bdev)
+{
+	struct host_file_bdev *hf_bdev = host_file_bdev_of(bdev);
+	struct host_file_breq *hf_breq;
+
+	hf_breq = mem_pool_alloc(&hf_bdev->req_pool);
+	if (!hf_breq)
+		return NULL;
+
+	slist_init(&hf_breq->breq.buf_list);
+	slist_init(&hf_breq->delayed_list);
+	host_event_init(&hf_breq->event, host_file_access_done);
+	hf_breq->breq.bdev = bdev;
+	hf_breq->breq.req_submit = host_file_submit;
+	hf_breq->breq.req_submit_buf_list = host_file_submit_buf_list;
+
+	return &hf_breq->breq;
+}
+
+//! \see block_free_request
+static void host_file_free_req(struct block_device *bdev,
+		struct block_request *breq)
+{
+	struct host_file_bdev *hf_bdev = host_file_bdev_of(bdev);
+	struct host_file_breq *hf_breq = host_file_breq_of(breq);
+
+	mem_pool_free(&hf_bdev->req_pool, hf_breq);
+}
+
+//! @}
+
+/**
+ * \ingroup block_device_host_file_group
+ * \brief Initialize a host file block device
+ *
+ * Opens the backing file and sizes the device from the length of the file,
+ * rounded down to whole blocks. The file is opened read-only if it can not
+ * be written. The workqueue task \a event_task is run once the device is
+ * ready, like for the other block device drivers.
+ *
+ * \param path       Path of the backing file, overridden by the
+ *                   \c HOST_BLOCK_FILE environment variable
+ * \param event_task Workqueue task to run on an event
+ *
+ * \return A new host file block device, or NULL if insufficient memory is
+ * available.
+ */
+struct block_device *host_file_blkdev_init(const char *path,
+		struct workqueue_task *event_task)
+{
+	struct host_file_bdev   *hf_bdev;
+	const char              *env_path;
+	const char              *env_latency;
+	struct stat             st;
+
+	hf_bdev = zalloc(sizeof(struct host_file_bdev));
+	if (!hf_bdev)
+		return NULL;
+
+	hf_bdev->bdev.prepare_req = host_file_prepare_req;
+	hf_bdev->bdev.alloc_req = host_file_alloc_req;
+	hf_bdev->bdev.free_req = host_file_free_req;
+	blkdev_set_block_size(&hf_bdev->bdev, HOST_FILE_BLOCK_SIZE);
+
+	mem_pool_init_physmem(&hf_bdev->req_pool, &cpu_sram_pool,
+			4, sizeof(struct host_file_breq), 2);
+
+	env_path = getenv("HOST_BLOCK_FILE");
+	if (env_path)
+		path = env_path;
+
+	env_latency = getenv("HOST_BLOCK_LATENCY");
+	if (env_latency)
+		hf_bdev->block_latency = strtoul(env_latency, NULL, 0);
+
+	hf_bdev->fd = -1;
+	if (path) {
+		hf_bdev->fd = open(path, O_RDWR);
+		if (hf_bdev->fd >= 0)
+			set_bit(BDEV_WRITEABLE, &hf_bdev->bdev.flags);
+		else
+			hf_bdev->fd = open(path, O_RDONLY);
+	}
+
+	if (hf_bdev->fd >= 0 && fstat(hf_bdev->fd, &st) == 0) {
+		hf_bdev->bdev.nr_blocks = st.st_size / HOST_FILE_BLOCK_SIZE;
+		set_bit(BDEV_PRESENT, &hf_bdev->bdev.flags);
+	} else if (path) {
+		dbg_warning("HostFile: unable to open %s\n", path);
+	}
+
+	workqueue_add_task(&main_workqueue, event_task);
+
+	return &hf_bdev->bdev;
+}
@@ -38,6 +38,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <spi.h>
+#include <util.h>
 #include <flash/at45_device.h>
 
 static bool at45_wait_poll_status(struct at45_device *at45d);
@@ -48,8 +49,19 @@ static bool at45_wait_poll_done(struct at45_device *at45d)
 	if (at45_rsp_status_is_ready(at45d)) {
 		at45d->next = NULL;
 		return true;
-	} else
-		return at45_wait_poll_status(at45d);
+	}
+
+#ifdef CONFIG_DELAYED_TASK
+	// Read the status again when the current task is run next time.
+	at45d->next = at45_wait_poll_status;
+	delayed_task_init(&at45d->poll, at45d->spim->nwq.current);
+	delayed_task_add(&at45d->poll,
+			DELAYED_TASK_US(CONFIG_AT45_POLL_INTERVAL),
+			DELAYED_TASK_US(CONFIG_AT45_POLL_INTERVAL));
+	return false;
+#else
+	return at45_wait_poll_status(at45d);
+#endif
 }
 
 static bool at45_wait_poll_cmd_done(struct at45_device *at45d)
@@ -138,6 +150,9 @@ static bool at45_identify_got_id(struct at45_device *at45d)
 		}
 		at45d->page_size = at45_get_page_size(at45d->cmdrsp[1]);
 		dbg_info("  Page size         : %d\n", at45d->page_size);
+		at45d->page_addr_shift = ilog2(at45d->page_size);
+		if (!test_bit(AT45_FLAG_BINARY_PAGE, &at45d->flags))
+			at45d->page_addr_shift++;
 	} else {
 		dbg_warning("at45_device: No valid dataflash detected!\n");
 	}
@@ -164,6 +179,8 @@ static bool at45_identify_got_status(struct at45_device *at45d)
 	dbg_info("at45_device: Status register: 0x%02x\n", at45d->cmdrsp[0]);
 	if (at45_rsp_status_is_protected(at45d))
 		set_bit(AT45_FLAG_PROTECTED, &at45d->flags);
+	if (at45_rsp_status_is_binary_page(at45d))
+		set_bit(AT45_FLAG_BINARY_PAGE, &at45d->flags);
 	at45_select(at45d);
 	at45_cmd_read_id(at45d);
 	return false;
@@ -221,5 +238,7 @@ void at45_device_init(struct at45_device *at45d, spi_id_t spi_id,
 	at45d->spid = spid;
 	at45d->next = NULL;
 	at45d->flags = 0;
+	// Largest page size without power-of-2 pages until identified
+	at45d->page_addr_shift = 11;
 }
 
@@ -39,9 +39,21 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 #include <assert.h>
+#include <hugemem.h>
+#include <progmem.h>
+#include <util.h>
 #include <gfx/gfx.h>
 
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+//! \internal Pixel colors expanded from an indexed bitmap.
+static gfx_color_t gfx_bitmap_line[CONFIG_GFX_BITMAP_LINE_PIXELS];
+
+//! \internal Packed pixel indexes read from an indexed bitmap.
+static uint8_t gfx_bitmap_indexes[CONFIG_GFX_BITMAP_LINE_PIXELS];
+#endif
+
 
 /**
  * \brief Draw a bitmap
@@ -149,6 +161,207 @@ void gfx_draw_bitmap_tiled(const struct gfx_bitmap *bmp, gfx_coord_t x1,
 	}
 }
 
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+/**
+ * \internal
+ * \brief Read packed pixel indexes from an indexed bitmap
+ *
+ * \param bmp    Indexed bitmap to read from.
+ * \param offset Byte offset into the pixel data.
+ * \param bytes  Number of bytes to read into gfx_bitmap_indexes.
+ */
+static void gfx_bitmap_read_indexes(const struct gfx_bitmap *bmp,
+		uint32_t offset, uint16_t bytes)
+{
+	const struct gfx_indexed_pixmap *ipx = bmp->data.indexed;
+
+	switch (bmp->type) {
+	case BITMAP_INDEXED_RAM:
+		memcpy(gfx_bitmap_indexes, ipx->pixels.ram + offset, bytes);
+		break;
+
+	case BITMAP_INDEXED_PROGMEM: {
+		const uint8_t __progmem_arg *from;
+		uint16_t                i;
+
+		from = ipx->pixels.progmem + offset;
+		for (i = 0; i < bytes; i++)
+			gfx_bitmap_indexes[i] = progmem_read8(from + i);
+		break;
+	}
+
+#ifdef CONFIG_HUGEMEM
+	case BITMAP_INDEXED_HUGEMEM:
+		hugemem_read_block(gfx_bitmap_indexes,
+				(hugemem_ptr_t)((phys_addr_t)ipx->pixels.hugemem
+				+ offset), bytes);
+		break;
+#endif
+
+	default:
+		unhandled_case(bmp->type);
+	}
+}
+
+/**
+ * \internal
+ * \brief Draw a rectangle of pixels from an indexed color bitmap
+ *
+ * Each line is read and expanded through the palette in parts of up to
+ * CONFIG_GFX_BITMAP_LINE_PIXELS pixels, which are copied to the screen.
+ * Each run of opaque pixels is copied to its own position, so transparent
+ * pixels are skipped. Bitmaps without a transparent index are streamed
+ * into the draw area, which is only positioned once.
+ *
+ * \param bmp   Pointer to indexed bitmap.
+ * \param map_x X coordinate inside pixel buffer.
+ * \param map_y Y coordinate inside pixel buffer.
+ * \param x     Left X coordinate on screen, already clipped.
+ * \param y     Top Y coordinate on screen, already clipped.
+ * \param x2    Right X coordinate on screen, already clipped.
+ * \param y2    Bottom Y coordinate on screen, already clipped.
+ */
+static void gfx_put_indexed_bitmap(const struct gfx_bitmap *bmp,
+		gfx_coord_t map_x, gfx_coord_t map_y,
+		gfx_coord_t x, gfx_coord_t y, gfx_coord_t x2, gfx_coord_t y2)
+{
+	const struct gfx_indexed_pixmap *ipx = bmp->data.indexed;
+	const gfx_color_t       *palette = ipx->palette;
+	uint8_t                 bpp = ipx->bpp;
+	uint8_t                 mask = (1 << bpp) - 1;
+	uint16_t                transparent = ipx->transparent;
+	bool                    opaque = (transparent == GFX_INDEX_NONE);
+	uint16_t                stride;
+	uint32_t                line_offset;
+
+	assert((bpp == 1) || (bpp == 2) || (bpp == 4) || (bpp == 8));
+	assert(palette);
+
+	stride = ((uint16_t)bmp->width * bpp + 7) / 8;
+	line_offset = (uint32_t)map_y * stride;
+
+	// Set up draw area.
+	gfx_set_bottom_right_limit(x2, y2);
+	if (opaque)
+		gfx_set_top_left_limit(x, y);
+
+	for (; y <= y2; y++) {
+		uint16_t        bit = (uint16_t)map_x * bpp;
+		gfx_coord_t     col = x;
+
+		while (col <= x2) {
+			gfx_coord_t     count;
+			gfx_coord_t     run = 0;
+			gfx_coord_t     run_x = col;
+			gfx_coord_t     i;
+			uint8_t         shift = bit % 8;
+			const uint8_t   *from = gfx_bitmap_indexes;
+
+			count = min_s(x2 - col + 1, CONFIG_GFX_BITMAP_LINE_PIXELS);
+			gfx_bitmap_read_indexes(bmp, line_offset + bit / 8,
+					(shift + count * bpp + 7) / 8);
+
+			for (i = 0; i < count; i++) {
+				uint8_t index;
+
+				shift += bpp;
+				index = (*from >> (8 - shift)) & mask;
+				if (shift == 8) {
+					shift = 0;
+					from++;
+				}
+
+				if (index != transparent) {
+					gfx_bitmap_line[run++] = palette[index];
+					continue;
+				}
+
+				// Copy the opaque pixels before this one.
+				if (run > 0) {
+					gfx_set_top_left_limit(run_x, y);
+					gfx_copy_pixels_to_screen(gfx_bitmap_line,
+							run);
+					run = 0;
+				}
+				run_x = col + i + 1;
+			}
+
+			if (run > 0) {
+				if (!opaque)
+					gfx_set_top_left_limit(run_x, y);
+				gfx_copy_pixels_to_screen(gfx_bitmap_line, run);
+			}
+
+			col += count;
+			bit += count * bpp;
+		}
+
+		line_offset += stride;
+	}
+}
+
+/**
+ * \internal
+ * \brief Expand a part of one line of an indexed color bitmap
+ *
+ * The indexes are looked up in the palette of the bitmap. Pixels with
+ * the transparent index are left as they were in \a pixels, so the
+ * caller can fill the buffer with the background first.
+ *
+ * \param bmp    Indexed bitmap to read from.
+ * \param pixels Buffer for the colors of \a count pixels.
+ * \param col    First column to read.
+ * \param row    Line to read.
+ * \param count  Number of pixels to read.
+ */
+void gfx_bitmap_priv_read_indexed(const struct gfx_bitmap *bmp,
+		gfx_color_t *pixels, gfx_coord_t col, gfx_coord_t row,
+		gfx_coord_t count)
+{
+	const struct gfx_indexed_pixmap *ipx = bmp->data.indexed;
+	const gfx_color_t       *palette = ipx->palette;
+	uint8_t                 bpp = ipx->bpp;
+	uint8_t                 mask = (1 << bpp) - 1;
+	uint16_t                transparent = ipx->transparent;
+	uint16_t                bit = (uint16_t)col * bpp;
+	uint32_t                line_offset;
+
+	assert((bpp == 1) || (bpp == 2) || (bpp == 4) || (bpp == 8));
+	assert(palette);
+
+	line_offset = (uint32_t)row * (((uint16_t)bmp->width * bpp + 7) / 8);
+
+	while (count > 0) {
+		gfx_coord_t     chunk;
+		gfx_coord_t     i;
+		uint8_t         shift = bit % 8;
+		const uint8_t   *from = gfx_bitmap_indexes;
+
+		chunk = min_s(count, CONFIG_GFX_BITMAP_LINE_PIXELS);
+		gfx_bitmap_read_indexes(bmp, line_offset + bit / 8,
+				(shift + chunk * bpp + 7) / 8);
+
+		for (i = 0; i < chunk; i++) {
+			uint8_t index;
+
+			shift += bpp;
+			index = (*from >> (8 - shift)) & mask;
+			if (shift == 8) {
+				shift = 0;
+				from++;
+			}
+
+			if (index != transparent)
+				pixels[i] = palette[index];
+		}
+
+		pixels += chunk;
+		count -= chunk;
+		bit += chunk * bpp;
+	}
+}
+#endif /* CONFIG_GFX_BITMAP_INDEXED */
+
 /**
  * \brief Write a rectangular block of pixels from a bitmap to
  * the screen.
@@ -160,6 +373,9 @@ void gfx_draw_bitmap_tiled(const struct gfx_bitmap *bmp, gfx_coord_t x1,
  * If the area to write is outside the clipping region, those pixels
  * will not be written.
  *
+ * Indexed color bitmaps are expanded through their palette while they
+ * are drawn, see \ref gfx_indexed_pixmap.
+ *
  * \note This function fails if the width or height is negative or the
  *       pixel rectangle is outside the pixmap buffer extents. Clipping
  *       is only performed on the screen, not inside the pixmap buffer itself.
@@ -320,12 +536,12 @@ void gfx_put_bitmap(const struct gfx_bitmap *bmp,
 	case BITMAP_HUGEMEM:
 		hugemem_pixmap = bmp->data.hugemem;
 		// Offset into pixmap.
-		hugemem_pixmap = (hugemem_ptr_t)((uint32_t)hugemem_pixmap +
+		hugemem_pixmap = (hugemem_ptr_t)((phys_addr_t)hugemem_pixmap +
 				map_x);
 
 		if (map_y > 0) {
 			hugemem_pixmap = (hugemem_ptr_t)
-				((uint32_t)hugemem_pixmap +
+				((phys_addr_t)hugemem_pixmap +
 				 ((uint32_t)map_y *
 				  (uint32_t)map_width));
 		}
@@ -353,7 +569,7 @@ void gfx_put_bitmap(const struct gfx_bitmap *bmp,
 				gfx_copy_hugemem_pixels_to_screen(
 						hugemem_pixmap, width);
 				hugemem_pixmap =
-					(hugemem_ptr_t)((uint32_t)hugemem_pixmap
+					(hugemem_ptr_t)((phys_addr_t)hugemem_pixmap
 							+ map_width);
 				--lines_left;
 			}
@@ -366,5 +582,15 @@ void gfx_put_bitmap(const struct gfx_bitmap *bmp,
 		gfx_gradient_draw(bmp->data.gradient, map_x, map_y, x, y, width, height);
 		break;
 #endif
+
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+	case BITMAP_INDEXED_RAM:
+	case BITMAP_INDEXED_PROGMEM:
+# ifdef CONFIG_HUGEMEM
+	case BITMAP_INDEXED_HUGEMEM:
+# endif
+		gfx_put_indexed_bitmap(bmp, map_x, map_y, x, y, x2, y2);
+		break;
+#endif
 	}
 }
@@ -0,0 +1,600 @@
+/**
+ * \file
+ *
+ * \brief Display lists for recorded drawing operations
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <hugemem.h>
+#include <util.h>
+
+#include <gfx/gfx.h>
+#include <gfx/dlist.h>
+
+/**
+ * \weakgroup gfx_dlist
+ *
+ * The list data is a \ref gfx_dlist_header followed by the operations
+ * back to back. Each operation starts with a \ref gfx_dlist_op holding
+ * the type, size and bounding box, followed by the parameters for the
+ * type. Operations are always copied into a local buffer before use, so
+ * they need no alignment in the list data.
+ *
+ * Position and size of rectangles, strings and bitmaps are given by the
+ * bounding box, so they are not stored again with the parameters.
+ *
+ * @{
+ */
+
+#if CONFIG_GFX_DLIST_STRING_MAX > 200
+# error CONFIG_GFX_DLIST_STRING_MAX is too large for the operation size field
+#endif
+
+//! \internal Display list operation types.
+enum gfx_dlist_op_type {
+	GFX_DLIST_OP_FILLED_RECT,       //!< gfx_draw_filled_rect()
+	GFX_DLIST_OP_RECT,              //!< gfx_draw_rect()
+	GFX_DLIST_OP_LINE,              //!< gfx_draw_line()
+	GFX_DLIST_OP_STRING,            //!< gfx_draw_string()
+	GFX_DLIST_OP_BITMAP,            //!< gfx_put_bitmap()
+#ifdef CONFIG_GRADIENT
+	GFX_DLIST_OP_GRADIENT,          //!< gfx_gradient_draw()
+#endif
+};
+
+//! \internal Local storage for any operation during replay.
+union gfx_dlist_op_buf {
+	struct gfx_dlist_op             op;
+	struct gfx_dlist_rect_op        rect;
+	struct gfx_dlist_line_op        line;
+	struct gfx_dlist_string_op      string;
+	struct gfx_dlist_bitmap_op      bitmap;
+#ifdef CONFIG_GRADIENT
+	struct gfx_dlist_gradient_op    gradient;
+#endif
+};
+
+//! \internal Where to read display list data from during replay.
+struct gfx_dlist_source {
+	//! List data in data memory.
+	const uint8_t           *data;
+#ifdef CONFIG_HUGEMEM
+	//! List data in hugemem, or HUGEMEM_NULL if in data memory.
+	hugemem_ptr_t           hugemem;
+#endif
+};
+
+/**
+ * \internal
+ * \brief Get header of display list being recorded
+ */
+static struct gfx_dlist_header *gfx_dlist_header_of(struct gfx_dlist *dlist)
+{
+	return (struct gfx_dlist_header *)dlist->data;
+}
+
+/**
+ * \brief Initialize a display list
+ *
+ * \param dlist Display list to initialize.
+ * \param buf   Buffer to record the list into.
+ * \param size  Size of \a buf in bytes.
+ */
+void gfx_dlist_init(struct gfx_dlist *dlist, void *buf, uint16_t size)
+{
+	assert(buf);
+	assert(size >= sizeof(struct gfx_dlist_header));
+
+	dlist->data = buf;
+	dlist->size = size;
+	gfx_dlist_clear(dlist);
+}
+
+/**
+ * \brief Remove all operations from a display list
+ *
+ * \param dlist Display list to clear.
+ */
+void gfx_dlist_clear(struct gfx_dlist *dlist)
+{
+	struct gfx_dlist_header *header = gfx_dlist_header_of(dlist);
+
+	header->length = sizeof(struct gfx_dlist_header);
+	// Empty bounding box, which no clipping region intersects.
+	header->bbox.x1 = 0;
+	header->bbox.y1 = 0;
+	header->bbox.x2 = -1;
+	header->bbox.y2 = -1;
+}
+
+/**
+ * \internal
+ * \brief Append an operation to a display list
+ *
+ * Fills in the operation header and extends the bounding box of the list.
+ *
+ * \param dlist  Display list.
+ * \param op     Operation with all parameters and bounding box set up.
+ * \param type   Operation type.
+ * \param size   Size of operation in bytes.
+ *
+ * \retval true  Operation was added.
+ * \retval false Not enough room left in the list.
+ */
+static bool gfx_dlist_append(struct gfx_dlist *dlist,
+		struct gfx_dlist_op *op, uint8_t type, uint8_t size)
+{
+	struct gfx_dlist_header *header = gfx_dlist_header_of(dlist);
+	struct gfx_dlist_bbox   *bbox = &header->bbox;
+
+	if (size > dlist->size - header->length)
+		return false;
+
+	op->type = type;
+	op->size = size;
+	memcpy(dlist->data + header->length, op, size);
+
+	if (header->length == sizeof(struct gfx_dlist_header)) {
+		*bbox = op->bbox;
+	} else {
+		bbox->x1 = min_s(bbox->x1, op->bbox.x1);
+		bbox->y1 = min_s(bbox->y1, op->bbox.y1);
+		bbox->x2 = max_s(bbox->x2, op->bbox.x2);
+		bbox->y2 = max_s(bbox->y2, op->bbox.y2);
+	}
+	header->length += size;
+
+	return true;
+}
+
+/**
+ * \internal
+ * \brief Set bounding box from rectangle position and size
+ *
+ * Negative width or height is handled as for gfx_draw_filled_rect().
+ *
+ * \retval true  Bounding box is set up.
+ * \retval false Rectangle is empty.
+ */
+static bool gfx_dlist_set_bbox(struct gfx_dlist_bbox *bbox,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height)
+{
+	if ((width == 0) || (height == 0))
+		return false;
+
+	if (width < 0) {
+		width = -width;
+		x -= width - 1;
+	}
+	if (height < 0) {
+		height = -height;
+		y -= height - 1;
+	}
+
+	bbox->x1 = x;
+	bbox->y1 = y;
+	bbox->x2 = x + width - 1;
+	bbox->y2 = y + height - 1;
+
+	return true;
+}
+
+/**
+ * \brief Add a filled rectangle to a display list
+ *
+ * \see gfx_draw_filled_rect() for a description of the parameters.
+ *
+ * \retval true  Operation was added, or the rectangle is empty.
+ * \retval false Not enough room left in the list.
+ */
+bool gfx_dlist_add_filled_rect(struct gfx_dlist *dlist,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_color_t color)
+{
+	struct gfx_dlist_rect_op op;
+
+	if (!gfx_dlist_set_bbox(&op.op.bbox, x, y, width, height))
+		return true;
+
+	op.color = color;
+
+	return gfx_dlist_append(dlist, &op.op, GFX_DLIST_OP_FILLED_RECT,
+			sizeof(op));
+}
+
+/**
+ * \brief Add a rectangle outline to a display list
+ *
+ * \see gfx_draw_rect() for a description of the parameters.
+ *
+ * \retval true  Operation was added, or the rectangle is empty.
+ * \retval false Not enough room left in the list.
+ */
+bool gfx_dlist_add_rect(struct gfx_dlist *dlist,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_color_t color)
+{
+	struct gfx_dlist_rect_op op;
+
+	if (!gfx_dlist_set_bbox(&op.op.bbox, x, y, width, height))
+		return true;
+
+	op.color = color;
+
+	return gfx_dlist_append(dlist, &op.op, GFX_DLIST_OP_RECT, sizeof(op));
+}
+
+/**
+ * \brief Add a line to a display list
+ *
+ * \see gfx_draw_line() for a description of the parameters.
+ *
+ * \retval true  Operation was added.
+ * \retval false Not enough room left in the list.
+ */
+bool gfx_dlist_add_line(struct gfx_dlist *dlist,
+		gfx_coord_t x1, gfx_coord_t y1,
+		gfx_coord_t x2, gfx_coord_t y2, gfx_color_t color)
+{
+	struct gfx_dlist_line_op op;
+
+	// Store the line left to right, so only the Y direction is needed.
+	if (x2 < x1) {
+		gfx_coord_t tmp;
+
+		tmp = x1;
+		x1 = x2;
+		x2 = tmp;
+		tmp = y1;
+		y1 = y2;
+		y2 = tmp;
+	}
+
+	op.flags = 0;
+	op.op.bbox.x1 = x1;
+	op.op.bbox.x2 = x2;
+	if (y2 < y1) {
+		op.flags |= GFX_DLIST_LINE_RISING;
+		op.op.bbox.y1 = y2;
+		op.op.bbox.y2 = y1;
+	} else {
+		op.op.bbox.y1 = y1;
+		op.op.bbox.y2 = y2;
+	}
+	op.color = color;
+
+	return gfx_dlist_append(dlist, &op.op, GFX_DLIST_OP_LINE, sizeof(op));
+}
+
+/**
+ * \brief Add a string to a display list
+ *
+ * The string is copied into the display list, while the font is only
+ * referenced.
+ *
+ * \see gfx_draw_string() for a description of the parameters.
+ *
+ * \retval true  Operation was added, or the string is empty.
+ * \retval false Not enough room left in the list, or the string is longer
+ *               than CONFIG_GFX_DLIST_STRING_MAX.
+ */
+bool gfx_dlist_add_string(struct gfx_dlist *dlist, const char *str,
+		gfx_coord_t x, gfx_coord_t y, struct font *font,
+		gfx_color_t color, gfx_color_t background_color)
+{
+	struct gfx_dlist_string_op op;
+	gfx_coord_t             width;
+	gfx_coord_t             height;
+	size_t                  len;
+
+	assert(str);
+	assert(font);
+
+	len = strlen(str);
+	if (len == 0)
+		return true;
+	if (len > CONFIG_GFX_DLIST_STRING_MAX)
+		return false;
+
+	gfx_get_string_bounding_box(str, font, &width, &height);
+	gfx_dlist_set_bbox(&op.op.bbox, x, y, width, height);
+
+	op.font = font;
+	op.color = color;
+	op.background_color = background_color;
+	memcpy(op.str, str, len + 1);
+
+	return gfx_dlist_append(dlist, &op.op, GFX_DLIST_OP_STRING,
+			offsetof(struct gfx_dlist_string_op, str) + len + 1);
+}
+
+/**
+ * \brief Add a bitmap to a display list
+ *
+ * The bitmap is only referenced by the display list.
+ *
+ * \see gfx_put_bitmap() for a description of the parameters.
+ *
+ * \retval true  Operation was added, or the area is empty.
+ * \retval false Not enough room left in the list.
+ */
+bool gfx_dlist_add_bitmap(struct gfx_dlist *dlist,
+		const struct gfx_bitmap *bmp,
+		gfx_coord_t map_x, gfx_coord_t map_y,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height)
+{
+	struct gfx_dlist_bitmap_op op;
+
+	assert(bmp);
+	assert((width >= 0) && (height >= 0));
+
+	if (!gfx_dlist_set_bbox(&op.op.bbox, x, y, width, height))
+		return true;
+
+	op.bmp = bmp;
+	op.map_x = map_x;
+	op.map_y = map_y;
+
+	return gfx_dlist_append(dlist, &op.op, GFX_DLIST_OP_BITMAP,
+			sizeof(op));
+}
+
+#if defined(CONFIG_GRADIENT) || defined(__DOXYGEN__)
+/**
+ * \brief Add a gradient to a display list
+ *
+ * The gradient is only referenced by the display list.
+ *
+ * \see gfx_gradient_draw() for a description of the parameters.
+ *
+ * \retval true  Operation was added, or the area is empty.
+ * \retval false Not enough room left in the list.
+ */
+bool gfx_dlist_add_gradient(struct gfx_dlist *dlist,
+		struct gfx_gradient *gradient,
+		gfx_coord_t map_x, gfx_coord_t map_y,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height)
+{
+	struct gfx_dlist_gradient_op op;
+
+	assert(gradient);
+	assert((width >= 0) && (height >= 0));
+
+	if (!gfx_dlist_set_bbox(&op.op.bbox, x, y, width, height))
+		return true;
+
+	op.gradient = gradient;
+	op.map_x = map_x;
+	op.map_y = map_y;
+
+	return gfx_dlist_append(dlist, &op.op, GFX_DLIST_OP_GRADIENT,
+			sizeof(op));
+}
+#endif
+
+/**
+ * \internal
+ * \brief Read display list data into local buffer
+ *
+ * \param src    Display list source.
+ * \param offset Offset in display list data.
+ * \param buf    Buffer to read into.
+ * \param size   Number of bytes to read.
+ */
+static void gfx_dlist_read(const struct gfx_dlist_source *src,
+		uint16_t offset, void *buf, uint8_t size)
+{
+#ifdef CONFIG_HUGEMEM
+	if (src->hugemem != HUGEMEM_NULL) {
+		hugemem_read_block(buf, (hugemem_ptr_t)((phys_addr_t)src->hugemem
+					+ offset), size);
+		return;
+	}
+#endif
+	memcpy(buf, src->data + offset, size);
+}
+
+/**
+ * \internal
+ * \brief Test if bounding box is outside clipping region
+ *
+ * \param bbox Bounding box to test.
+ * \param clip Clipping region, relative to the same origin as \a bbox.
+ */
+static bool gfx_dlist_is_outside(const struct gfx_dlist_bbox *bbox,
+		const struct gfx_dlist_bbox *clip)
+{
+	return (bbox->x1 > clip->x2) || (bbox->x2 < clip->x1)
+			|| (bbox->y1 > clip->y2) || (bbox->y2 < clip->y1);
+}
+
+/**
+ * \internal
+ * \brief Draw a single operation
+ *
+ * \param buf Operation to draw.
+ * \param x   X coordinate of list origin.
+ * \param y   Y coordinate of list origin.
+ */
+static void gfx_dlist_draw_op(union gfx_dlist_op_buf *buf,
+		gfx_coord_t x, gfx_coord_t y)
+{
+	const struct gfx_dlist_bbox *bbox = &buf->op.bbox;
+	gfx_coord_t                 x1 = x + bbox->x1;
+	gfx_coord_t                 y1 = y + bbox->y1;
+	gfx_coord_t                 width = bbox->x2 - bbox->x1 + 1;
+	gfx_coord_t                 height = bbox->y2 - bbox->y1 + 1;
+
+	switch (buf->op.type) {
+	case GFX_DLIST_OP_FILLED_RECT:
+		gfx_draw_filled_rect(x1, y1, width, height, buf->rect.color);
+		break;
+
+	case GFX_DLIST_OP_RECT:
+		gfx_draw_rect(x1, y1, width, height, buf->rect.color);
+		break;
+
+	case GFX_DLIST_OP_LINE:
+		if (buf->line.flags & GFX_DLIST_LINE_RISING)
+			gfx_draw_line(x1, y + bbox->y2, x + bbox->x2, y1,
+					buf->line.color);
+		else
+			gfx_draw_line(x1, y1, x + bbox->x2, y + bbox->y2,
+					buf->line.color);
+		break;
+
+	case GFX_DLIST_OP_STRING:
+		gfx_draw_string(buf->string.str, x1, y1, buf->string.font,
+				buf->string.color,
+				buf->string.background_color);
+		break;
+
+	case GFX_DLIST_OP_BITMAP:
+		gfx_put_bitmap(buf->bitmap.bmp, buf->bitmap.map_x,
+				buf->bitmap.map_y, x1, y1, width, height);
+		break;
+
+#ifdef CONFIG_GRADIENT
+	case GFX_DLIST_OP_GRADIENT:
+		gfx_gradient_draw(buf->gradient.gradient, buf->gradient.map_x,
+				buf->gradient.map_y, x1, y1, width, height);
+		break;
+#endif
+
+	default:
+		unhandled_case(buf->op.type);
+		break;
+	}
+}
+
+/**
+ * \internal
+ * \brief Replay display list from a source
+ *
+ * \param src Display list source.
+ * \param x   X coordinate of list origin.
+ * \param y   Y coordinate of list origin.
+ */
+static void gfx_dlist_replay_source(const struct gfx_dlist_source *src,
+		gfx_coord_t x, gfx_coord_t y)
+{
+	struct gfx_dlist_header header;
+	struct gfx_dlist_bbox   clip;
+	union gfx_dlist_op_buf  buf;
+	uint16_t                offset;
+
+	// Clipping region relative to the list origin.
+#ifdef CONFIG_GFX_USE_CLIPPING
+	clip.x1 = gfx_min_x - x;
+	clip.y1 = gfx_min_y - y;
+	clip.x2 = gfx_max_x - x;
+	clip.y2 = gfx_max_y - y;
+#else
+	clip.x1 = -x;
+	clip.y1 = -y;
+	clip.x2 = gfx_get_width() - 1 - x;
+	clip.y2 = gfx_get_height() - 1 - y;
+#endif
+
+	gfx_dlist_read(src, 0, &header, sizeof(header));
+	if (gfx_dlist_is_outside(&header.bbox, &clip))
+		return;
+
+	offset = sizeof(header);
+	while (offset < header.length) {
+		// Only fetch the parameters of visible operations.
+		gfx_dlist_read(src, offset, &buf.op, sizeof(buf.op));
+		assert(buf.op.size <= sizeof(buf));
+
+		if (!gfx_dlist_is_outside(&buf.op.bbox, &clip)) {
+			gfx_dlist_read(src, offset, &buf, buf.op.size);
+			gfx_dlist_draw_op(&buf, x, y);
+		}
+
+		offset += buf.op.size;
+	}
+}
+
+/**
+ * \brief Replay a display list
+ *
+ * Draws all operations of the display list which are inside the current
+ * clipping region, with the list origin at (\a x, \a y).
+ *
+ * \param dlist Display list to replay.
+ * \param x     X coordinate of list origin.
+ * \param y     Y coordinate of list origin.
+ */
+void gfx_dlist_replay(const struct gfx_dlist *dlist,
+		gfx_coord_t x, gfx_coord_t y)
+{
+	struct gfx_dlist_source src;
+
+	src.data = dlist->data;
+#ifdef CONFIG_HUGEMEM
+	src.hugemem = HUGEMEM_NULL;
+#endif
+	gfx_dlist_replay_source(&src, x, y);
+}
+
+#if defined(CONFIG_HUGEMEM) || defined(__DOXYGEN__)
+/**
+ * \brief Replay a display list stored in hugemem
+ *
+ * \see gfx_dlist_replay()
+ *
+ * \param data  Display list data in hugemem.
+ * \param x     X coordinate of list origin.
+ * \param y     Y coordinate of list origin.
+ */
+void gfx_dlist_replay_hugemem(const hugemem_ptr_t data,
+		gfx_coord_t x, gfx_coord_t y)
+{
+	struct gfx_dlist_source src;
+
+	assert(data != HUGEMEM_NULL);
+
+	src.data = NULL;
+	src.hugemem = data;
+	gfx_dlist_replay_source(&src, x, y);
+}
+#endif
+
+//! @}
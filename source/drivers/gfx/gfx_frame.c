@@ -0,0 +1,175 @@
+/**
+ * \file
+ *
+ * \brief Tearing-effect synchronized frame scheduler
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <interrupt.h>
+#include <softirq.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <workqueue.h>
+#include <gfx/frame.h>
+
+/**
+ * \ingroup gfx_frame
+ * @{
+ */
+
+//! Number of TE pulses seen, updated from interrupt context.
+volatile uint8_t gfx_frame_priv_count;
+//! Value of #gfx_frame_priv_count when tasks were last released.
+uint8_t gfx_frame_priv_released;
+
+//! Tasks waiting for the next TE pulse.
+static struct workqueue gfx_frame_queue;
+/**
+ * Marker queued on \ref main_workqueue behind the tasks released for a
+ * frame. When it has run, so have all the tasks in front of it.
+ */
+static struct workqueue_task gfx_frame_end_task;
+//! Number of TE pulses at which painting was still busy.
+static uint16_t gfx_frame_late;
+//! True if the display driver has the TE interrupt enabled.
+static bool gfx_frame_vsync_enabled;
+
+//! \internal Worker for the end-of-frame marker, which has nothing to do.
+static void gfx_frame_end_worker(struct workqueue_task *task)
+{
+}
+
+/**
+ * \internal
+ * \brief Release waiting tasks on a TE pulse
+ *
+ * This is the handler for \ref SOFTIRQ_GFX_FRAME.
+ *
+ * \param data Not used.
+ */
+static void gfx_frame_softirq(void *data)
+{
+	struct workqueue_task   *task;
+	irqflags_t              iflags;
+
+	iflags = cpu_irq_save();
+
+	if (workqueue_task_is_queued(&gfx_frame_end_task)) {
+		/* The previous frame is still being painted. Hold everything
+		 * back so that we don't fall further behind.
+		 */
+		gfx_frame_late++;
+	} else if (workqueue_is_empty(&gfx_frame_queue)) {
+		// Nothing to do until someone asks for another frame.
+		gfx_frame_priv_disable_vsync();
+		gfx_frame_vsync_enabled = false;
+	} else {
+		gfx_frame_priv_released = gfx_frame_priv_count;
+		while ((task = workqueue_pop_task(&gfx_frame_queue)))
+			workqueue_add_task(&main_workqueue, task);
+		workqueue_add_task(&main_workqueue, &gfx_frame_end_task);
+	}
+
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Initialize the frame scheduler
+ *
+ * Must be called after gfx_init() and before any other function in this
+ * module.
+ */
+void gfx_frame_init(void)
+{
+	workqueue_init(&gfx_frame_queue);
+	workqueue_task_init(&gfx_frame_end_task, gfx_frame_end_worker);
+	softirq_set_handler(SOFTIRQ_GFX_FRAME, gfx_frame_softirq, NULL);
+}
+
+/**
+ * \brief Run a task at the start of the next frame
+ *
+ * The task is queued on \ref main_workqueue when the next TE pulse
+ * arrives. If the task is already waiting for a frame, or has been
+ * released but has not run yet, the request is merged with the pending
+ * one.
+ *
+ * This function may be called from interrupt context.
+ *
+ * \param task The task to run.
+ *
+ * \retval true The task was queued.
+ * \retval false The task was already queued.
+ */
+bool gfx_frame_add_task(struct workqueue_task *task)
+{
+	irqflags_t      iflags;
+	bool            was_queued;
+
+	assert(task);
+
+	iflags = cpu_irq_save();
+	was_queued = workqueue_add_task(&gfx_frame_queue, task);
+	if (!gfx_frame_vsync_enabled) {
+		gfx_frame_vsync_enabled = true;
+		gfx_frame_priv_enable_vsync();
+	}
+	cpu_irq_restore(iflags);
+
+	return was_queued;
+}
+
+/**
+ * \brief Get number of late frames
+ *
+ * \return Number of TE pulses since gfx_frame_init() at which the tasks
+ * released for the previous frame had not finished.
+ */
+uint16_t gfx_frame_get_late_count(void)
+{
+	return gfx_frame_late;
+}
+
+/**
+ * \brief Signal a TE pulse
+ *
+ * Called by the display driver from interrupt context.
+ */
+void gfx_frame_priv_vsync(void)
+{
+	gfx_frame_priv_count++;
+	softirq_raise(SOFTIRQ_GFX_FRAME);
+}
+
+//! @}
@@ -40,8 +40,69 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <assert.h>
+#include <util.h>
 #include <gfx/gfx.h>
 
+#ifdef CONFIG_GFX_USE_CLIPPING
+/**
+ * \internal
+ * \brief True while drawing a primitive which is inside the clipping region
+ *
+ * Primitives made up of many spans check their bounding box against the
+ * clipping region once, and set this so that the spans can be drawn without
+ * checking each of them again.
+ */
+static bool gfx_generic_unclipped;
+
+/**
+ * \internal
+ * \brief Check if an area is entirely inside the clipping region
+ *
+ * \param x1 Left edge of the area.
+ * \param y1 Top edge of the area.
+ * \param x2 Right edge of the area.
+ * \param y2 Bottom edge of the area.
+ */
+static bool gfx_generic_is_inside_clip(gfx_coord_t x1, gfx_coord_t y1,
+		gfx_coord_t x2, gfx_coord_t y2)
+{
+	return (x1 >= gfx_min_x) && (y1 >= gfx_min_y)
+			&& (x2 <= gfx_max_x) && (y2 <= gfx_max_y);
+}
+#else
+// Nothing is clipped, so every span can take the fast path.
+# define gfx_generic_unclipped  true
+#endif
+
+/**
+ * \internal
+ * \brief Draw a span of a multi-span primitive
+ *
+ * If the primitive is inside the clipping region, the span is written
+ * directly without any clipping or sanity checks.
+ *
+ * \pre \a width and \a height must be positive.
+ */
+static void gfx_generic_draw_span(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_color_t color)
+{
+	if (gfx_generic_unclipped) {
+		gfx_set_limits(x, y, x + width - 1, y + height - 1);
+		gfx_duplicate_pixel(color, (uint32_t)width * height);
+	} else if (height == 1) {
+		gfx_draw_horizontal_line(x, y, width, color);
+	} else {
+		gfx_draw_vertical_line(x, y, height, color);
+	}
+}
+
+//! \internal Draw a horizontal span of a multi-span primitive.
+#define gfx_generic_draw_hspan(x, y, length, color)                     \
+	gfx_generic_draw_span(x, y, length, 1, color)
+//! \internal Draw a vertical span of a multi-span primitive.
+#define gfx_generic_draw_vspan(x, y, length, color)                     \
+	gfx_generic_draw_span(x, y, 1, length, color)
+
 void gfx_generic_draw_horizontal_line(gfx_coord_t x, gfx_coord_t y,
 		gfx_coord_t length, gfx_color_t color)
 {
@@ -54,79 +115,257 @@ void gfx_generic_draw_vertical_line(gfx_coord_t x, gfx_coord_t y,
 	gfx_draw_filled_rect(x, y, 1, length, color);
 }
 
+/**
+ * \internal
+ * \brief State for walking a line one run at a time
+ *
+ * The line is walked along its major axis, i.e. the axis along which it is
+ * longest. A run is a sequence of pixels sharing the same minor axis
+ * coordinate, which can be drawn as a single horizontal or vertical span.
+ */
+struct gfx_generic_line {
+	//! Current position along the major axis.
+	gfx_coord_t major;
+	//! Current position along the minor axis.
+	gfx_coord_t minor;
+	//! Major axis step, 1 or -1.
+	int8_t      major_inc;
+	//! Minor axis step, 1 or -1.
+	int8_t      minor_inc;
+	//! Length of the line along the major axis.
+	int16_t     d_major;
+	//! Length of the line along the minor axis.
+	int16_t     d_minor;
+	//! Fractional part of the minor axis position.
+	int16_t     error;
+	//! Number of pixels left to walk.
+	int16_t     remaining;
+};
+
+/**
+ * \internal
+ * \brief Prepare walking a line from (major1, minor1) to (major2, minor2)
+ *
+ * \pre The line must be at least as long along the major axis as along the
+ *      minor axis.
+ */
+static void gfx_generic_line_init(struct gfx_generic_line *line,
+		gfx_coord_t major1, gfx_coord_t minor1,
+		gfx_coord_t major2, gfx_coord_t minor2)
+{
+	line->major = major1;
+	line->minor = minor1;
+
+	line->major_inc = 1;
+	line->d_major = major2 - major1;
+	if (line->d_major < 0) {
+		line->major_inc = -1;
+		line->d_major = -line->d_major;
+	}
+	line->minor_inc = 1;
+	line->d_minor = minor2 - minor1;
+	if (line->d_minor < 0) {
+		line->minor_inc = -1;
+		line->d_minor = -line->d_minor;
+	}
+
+	assert(line->d_major >= line->d_minor);
+
+	line->error = line->d_major >> 1;
+	line->remaining = line->d_major + 1;
+}
+
+/**
+ * \internal
+ * \brief Get the next run of a line
+ *
+ * \param line  Line state.
+ * \param start Returns the lowest major axis coordinate of the run.
+ * \param minor Returns the minor axis coordinate of the run.
+ *
+ * \return Length of the run in pixels, or 0 if the whole line is done.
+ */
+static gfx_coord_t gfx_generic_line_next_run(struct gfx_generic_line *line,
+		gfx_coord_t *start, gfx_coord_t *minor)
+{
+	gfx_coord_t first = line->major;
+	gfx_coord_t length = 0;
+
+	*minor = line->minor;
+
+	while (line->remaining) {
+		++length;
+		--line->remaining;
+		line->major += line->major_inc;
+
+		// Update fractional part ("error"), and end the run when
+		// it crosses 0 and the minor axis is stepped.
+		line->error -= line->d_minor;
+		if (line->error < 0) {
+			line->error += line->d_major;
+			line->minor += line->minor_inc;
+			break;
+		}
+	}
+
+	*start = (line->major_inc > 0) ? first : first - length + 1;
+
+	return length;
+}
+
+/**
+ * \internal
+ * \brief Draw a horizontal span for a line
+ *
+ * Only the top left limit is set up, so the span is drawn for the cost of
+ * a single pixel plus the pixel data.
+ *
+ * \pre The bottom right limit must be set to the bottom right corner of
+ *      the screen.
+ */
+static void gfx_generic_draw_line_span(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t length, gfx_color_t color)
+{
+#ifdef CONFIG_GFX_USE_CLIPPING
+	if (!gfx_generic_unclipped) {
+		if ((y < gfx_min_y) || (y > gfx_max_y))
+			return;
+
+		if (x < gfx_min_x) {
+			length -= gfx_min_x - x;
+			x = gfx_min_x;
+		}
+		if ((x + length - 1) > gfx_max_x)
+			length = gfx_max_x - x + 1;
+		if (length <= 0)
+			return;
+	}
+#endif
+
+	gfx_set_top_left_limit(x, y);
+	gfx_duplicate_pixel(color, length);
+}
+
 void gfx_generic_draw_line(gfx_coord_t x1, gfx_coord_t y1,
 		gfx_coord_t x2, gfx_coord_t y2, gfx_color_t color)
 {
-	gfx_coord_t x;
-	gfx_coord_t y;
-	int16_t xinc;
-	int16_t yinc;
-	int16_t dx;
-	int16_t dy;
-
-	// Compute deltas, ie. "width" and "height" of line, then
-	// compute x and y direction, and make deltas positive for later use.
-	// Start off assuming direction is positive, ie. right and down.
-	xinc = 1;
+	struct gfx_generic_line line;
+	gfx_coord_t             start;
+	gfx_coord_t             minor;
+	gfx_coord_t             length;
+	int16_t                 dx;
+	int16_t                 dy;
+
 	dx = x2 - x1;
-	if (dx < 0) {
-		xinc = -1;
+	if (dx < 0)
 		dx = -dx;
-	}
-	yinc = 1;
 	dy = y2 - y1;
-	if (dy < 0) {
-		yinc = -1;
+	if (dy < 0)
 		dy = -dy;
-	}
 
-	// Set up current point and prepare bottom right corner of draw area.
-	x = x1;
-	y = y1;
-	gfx_set_bottom_right_limit(gfx_width - 1, gfx_height - 1);
+#ifdef CONFIG_GFX_USE_CLIPPING
+	gfx_generic_unclipped = gfx_generic_is_inside_clip(min_s(x1, x2),
+			min_s(y1, y2), max_s(x1, x2), max_s(y1, y2));
+#endif
 
-	/*
-	 * A "flat" line (dx>dy) is handled differently from a "steep"
-	 * line (dx<dy).
-	 */
 	if (dx > dy) {
-		gfx_coord_t i;
-		int16_t e = dx >> 1;
-
-		// Walk along X, draw pixel, and step Y when required.
-		for (i = 0; i <= dx; ++i) {
-			gfx_draw_line_pixel(x, y, color);
-			// Update fractional part ("error"),
-			// and step Y when it crosses 0.
-			e -= dy;
-			if (e < 0) {
-				e += dx;
-				y += yinc;
-			}
-			// Walk one step along X.
-			x += xinc;
-		}
+		/*
+		 * A "flat" line (dx>dy) is drawn as horizontal spans, which
+		 * only need the top left limit to be set up for each span.
+		 */
+		gfx_set_bottom_right_limit(gfx_width - 1, gfx_height - 1);
+		gfx_generic_line_init(&line, x1, y1, x2, y2);
+		while ((length = gfx_generic_line_next_run(&line,
+						&start, &minor)))
+			gfx_generic_draw_line_span(start, minor, length, color);
+	} else if (dy >= 2 * dx) {
+		/*
+		 * A "steep" line (dx<dy) is drawn as vertical spans, which
+		 * need the whole window to be set up for each span. This only
+		 * pays off when the spans are at least two pixels long on
+		 * average, so lines closer to diagonal are drawn pixel by
+		 * pixel.
+		 */
+		gfx_generic_line_init(&line, y1, x1, y2, x2);
+		while ((length = gfx_generic_line_next_run(&line,
+						&start, &minor)))
+			gfx_generic_draw_vspan(minor, start, length, color);
 	} else {
-		gfx_coord_t i;
-		int16_t e = dy >> 1;
-
-		// Walk along Y, draw pixel, and step X when required.
-		for (i = 0; i <= dy; ++i) {
-			gfx_draw_line_pixel(x,y,color);
-			// Update fractional part ("error"),
-			// and step X when it crosses 0.
-			e -= dx;
-			if (e < 0){
-				e += dy;
-				x += xinc;
-			}
-			// Walk one step along Y.
-			y += yinc;
+		gfx_set_bottom_right_limit(gfx_width - 1, gfx_height - 1);
+		gfx_generic_line_init(&line, y1, x1, y2, x2);
+		while ((length = gfx_generic_line_next_run(&line,
+						&start, &minor))) {
+			while (length--)
+				gfx_draw_line_pixel(minor, start++, color);
 		}
 	}
+
+#ifdef CONFIG_GFX_USE_CLIPPING
+	gfx_generic_unclipped = false;
+#endif
 }
 
+void gfx_generic_draw_thick_line(gfx_coord_t x1, gfx_coord_t y1,
+		gfx_coord_t x2, gfx_coord_t y2, gfx_coord_t thickness,
+		gfx_color_t color)
+{
+	struct gfx_generic_line line;
+	gfx_coord_t             start;
+	gfx_coord_t             minor;
+	gfx_coord_t             length;
+	gfx_coord_t             span_width;
+	int16_t                 dx;
+	int16_t                 dy;
+	int16_t                 d_major;
+	int16_t                 d_minor;
+
+	if (thickness <= 1) {
+		gfx_draw_line(x1, y1, x2, y2, color);
+		return;
+	}
+
+	dx = x2 - x1;
+	if (dx < 0)
+		dx = -dx;
+	dy = y2 - y1;
+	if (dy < 0)
+		dy = -dy;
+
+	if (dx > dy) {
+		d_major = dx;
+		d_minor = dy;
+	} else {
+		d_major = dy;
+		d_minor = dx;
+	}
+
+	/*
+	 * The spans are stacked along the minor axis, so scale the
+	 * thickness by length/d_major to keep the perpendicular thickness
+	 * constant. The length is approximated as d_major + 3/8 * d_minor,
+	 * which is within 7% of the exact value.
+	 */
+	span_width = thickness;
+	if (d_major > 0) {
+		span_width = ((int32_t)thickness * (d_major
+					+ ((3 * d_minor) >> 3))
+				+ (d_major >> 1)) / d_major;
+	}
 
+	if (dx > dy) {
+		gfx_generic_line_init(&line, x1, y1, x2, y2);
+		while ((length = gfx_generic_line_next_run(&line,
+						&start, &minor)))
+			gfx_draw_filled_rect(start, minor - (span_width >> 1),
+					length, span_width, color);
+	} else {
+		gfx_generic_line_init(&line, y1, x1, y2, x2);
+		while ((length = gfx_generic_line_next_run(&line,
+						&start, &minor)))
+			gfx_draw_filled_rect(minor - (span_width >> 1), start,
+					span_width, length, color);
+	}
+}
 
 void gfx_generic_draw_rect(gfx_coord_t x, gfx_coord_t y,
 		gfx_coord_t width, gfx_coord_t height,
@@ -203,43 +442,128 @@ void gfx_generic_draw_filled_rect(gfx_coord_t x, gfx_coord_t y,
 	gfx_duplicate_pixel(color, (uint32_t)width * height);
 }
 
-void gfx_generic_draw_circle(gfx_coord_t x, gfx_coord_t y,
-		gfx_coord_t radius, gfx_color_t color, uint8_t octant_mask)
+/**
+ * \internal
+ * \brief Draw the spans of one run of circle outline pixels
+ *
+ * A run is a sequence of steps where the offset along the outer axis stays
+ * the same. This gives horizontal spans in the octants at the top and
+ * bottom of the circle, and vertical spans in the octants at the left and
+ * right. Spans from two adjacent octants meeting at the middle of a side
+ * are merged into one.
+ *
+ * The right half of the circle is moved \a dw pixels right and the bottom
+ * half \a dh pixels down, with the straight sides of a rounded rectangle
+ * filling the gaps.
+ *
+ * \param x           X coordinate of top left center.
+ * \param y           Y coordinate of top left center.
+ * \param dw          Horizontal distance between left and right centers.
+ * \param dh          Vertical distance between top and bottom centers.
+ * \param start       First offset along the inner axis in the run.
+ * \param end         Last offset along the inner axis in the run.
+ * \param offset      Offset along the outer axis for the run.
+ * \param color       Color of the outline.
+ * \param octant_mask Bitmask indicating which octants to draw.
+ */
+static void gfx_generic_draw_arc_spans(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t dw, gfx_coord_t dh,
+		gfx_coord_t start, gfx_coord_t end, gfx_coord_t offset,
+		gfx_color_t color, uint8_t octant_mask)
+{
+	gfx_coord_t length = end - start + 1;
+	bool        merge = (start == 0);
+
+	// Top side, octants 2 and 1.
+	if (merge && (octant_mask & GFX_OCTANT2)
+			&& (octant_mask & GFX_OCTANT1)) {
+		gfx_generic_draw_hspan(x - end, y - offset,
+				dw + 2 * end + 1, color);
+	} else {
+		if (octant_mask & GFX_OCTANT2)
+			gfx_generic_draw_hspan(x - end, y - offset,
+					length, color);
+		if (octant_mask & GFX_OCTANT1)
+			gfx_generic_draw_hspan(x + dw + start, y - offset,
+					length, color);
+	}
+
+	// Bottom side, octants 5 and 6.
+	if (merge && (octant_mask & GFX_OCTANT5)
+			&& (octant_mask & GFX_OCTANT6)) {
+		gfx_generic_draw_hspan(x - end, y + dh + offset,
+				dw + 2 * end + 1, color);
+	} else {
+		if (octant_mask & GFX_OCTANT5)
+			gfx_generic_draw_hspan(x - end, y + dh + offset,
+					length, color);
+		if (octant_mask & GFX_OCTANT6)
+			gfx_generic_draw_hspan(x + dw + start,
+					y + dh + offset, length, color);
+	}
+
+	// Left side, octants 3 and 4.
+	if (merge && (octant_mask & GFX_OCTANT3)
+			&& (octant_mask & GFX_OCTANT4)) {
+		gfx_generic_draw_vspan(x - offset, y - end,
+				dh + 2 * end + 1, color);
+	} else {
+		if (octant_mask & GFX_OCTANT3)
+			gfx_generic_draw_vspan(x - offset, y - end,
+					length, color);
+		if (octant_mask & GFX_OCTANT4)
+			gfx_generic_draw_vspan(x - offset, y + dh + start,
+					length, color);
+	}
+
+	// Right side, octants 0 and 7.
+	if (merge && (octant_mask & GFX_OCTANT0)
+			&& (octant_mask & GFX_OCTANT7)) {
+		gfx_generic_draw_vspan(x + dw + offset, y - end,
+				dh + 2 * end + 1, color);
+	} else {
+		if (octant_mask & GFX_OCTANT0)
+			gfx_generic_draw_vspan(x + dw + offset, y - end,
+					length, color);
+		if (octant_mask & GFX_OCTANT7)
+			gfx_generic_draw_vspan(x + dw + offset,
+					y + dh + start, length, color);
+	}
+}
+
+/**
+ * \internal
+ * \brief Draw circle outline arcs as spans
+ *
+ * Walks one octant of the circle and draws each run of pixels sharing the
+ * same outer offset with gfx_generic_draw_arc_spans().
+ *
+ * \see gfx_generic_draw_arc_spans() for a description of the parameters.
+ */
+static void gfx_generic_draw_arcs(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t dw, gfx_coord_t dh, gfx_coord_t radius,
+		gfx_color_t color, uint8_t octant_mask)
 {
 	gfx_coord_t offset_x;
 	gfx_coord_t offset_y;
+	gfx_coord_t run_start;
+	gfx_coord_t run_y;
 	int16_t error;
 
-	// Draw only a pixel if radius is zero.
-	if (radius == 0) {
-		gfx_draw_pixel(x, y, color);
-		return;
-	}
+#ifdef CONFIG_GFX_USE_CLIPPING
+	gfx_generic_unclipped = gfx_generic_is_inside_clip(x - radius,
+			y - radius, x + dw + radius, y + dh + radius);
+#endif
 
 	// Set up start iterators.
 	offset_x = 0;
 	offset_y = radius;
 	error = 3 - 2 * radius;
+	run_start = 0;
 
-	// Iterate offsetX from 0 to radius.
+	// Iterate offset_x from 0 to radius.
 	while (offset_x <= offset_y) {
-		// Draw one pixel for each octant enabled in octant_mask.
-		if (octant_mask & GFX_OCTANT0)
-			gfx_draw_pixel(x + offset_y, y - offset_x, color);
-		if (octant_mask & GFX_OCTANT1)
-			gfx_draw_pixel(x + offset_x, y - offset_y, color);
-		if (octant_mask & GFX_OCTANT2)
-			gfx_draw_pixel(x - offset_x, y - offset_y, color);
-		if (octant_mask & GFX_OCTANT3)
-			gfx_draw_pixel(x - offset_y, y - offset_x, color);
-		if (octant_mask & GFX_OCTANT4)
-			gfx_draw_pixel(x - offset_y, y + offset_x, color);
-		if (octant_mask & GFX_OCTANT5)
-			gfx_draw_pixel(x - offset_x, y + offset_y, color);
-		if (octant_mask & GFX_OCTANT6)
-			gfx_draw_pixel(x + offset_x, y + offset_y, color);
-		if (octant_mask & GFX_OCTANT7)
-			gfx_draw_pixel(x + offset_y, y + offset_x, color);
+		run_y = offset_y;
 
 		// Update error value and step offset_y when required.
 		if (error < 0) {
@@ -251,22 +575,87 @@ void gfx_generic_draw_circle(gfx_coord_t x, gfx_coord_t y,
 
 		// Next X.
 		++offset_x;
+
+		// Draw the run when offset_y is stepped or the octant is done.
+		if ((offset_y != run_y) || (offset_x > offset_y)) {
+			gfx_generic_draw_arc_spans(x, y, dw, dh, run_start,
+					offset_x - 1, run_y, color, octant_mask);
+			run_start = offset_x;
+		}
 	}
+#ifdef CONFIG_GFX_USE_CLIPPING
+	gfx_generic_unclipped = false;
+#endif
 }
 
+/**
+ * \internal
+ * \brief Draw a column of a filled circle, spanning the upper and/or lower
+ * quadrant.
+ */
+static void gfx_generic_draw_filled_column(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t dh, gfx_coord_t offset, gfx_color_t color,
+		bool upper, bool lower)
+{
+	if (upper && lower)
+		gfx_generic_draw_vspan(x, y - offset, dh + 2 * offset + 1,
+				color);
+	else if (upper)
+		gfx_generic_draw_vspan(x, y - offset, offset + 1, color);
+	else if (lower)
+		gfx_generic_draw_vspan(x, y + dh, offset + 1, color);
+}
 
-void gfx_generic_draw_filled_circle(gfx_coord_t x, gfx_coord_t y,
-		gfx_coord_t radius, gfx_color_t color, uint8_t quadrant_mask)
+/**
+ * \internal
+ * \brief Draw the left and right columns of a filled circle at a given
+ * horizontal offset from the center.
+ *
+ * \see gfx_generic_draw_arc_spans() for a description of the parameters.
+ */
+static void gfx_generic_draw_filled_columns(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t dw, gfx_coord_t dh,
+		gfx_coord_t offset_x, gfx_coord_t offset_y,
+		gfx_color_t color, uint8_t quadrant_mask)
+{
+	// Left and right columns are the same at the center line.
+	if ((offset_x == 0) && (dw == 0)) {
+		gfx_generic_draw_filled_column(x, y, dh, offset_y, color,
+				quadrant_mask & (GFX_QUADRANT0 | GFX_QUADRANT1),
+				quadrant_mask & (GFX_QUADRANT2 | GFX_QUADRANT3));
+		return;
+	}
+
+	gfx_generic_draw_filled_column(x + dw + offset_x, y, dh, offset_y,
+			color, quadrant_mask & GFX_QUADRANT0,
+			quadrant_mask & GFX_QUADRANT3);
+	gfx_generic_draw_filled_column(x - offset_x, y, dh, offset_y,
+			color, quadrant_mask & GFX_QUADRANT1,
+			quadrant_mask & GFX_QUADRANT2);
+}
+
+/**
+ * \internal
+ * \brief Draw filled circle quadrants as vertical spans
+ *
+ * Each column of the circle is drawn once, with upper and lower quadrants
+ * merged into a single span when both are drawn.
+ *
+ * \see gfx_generic_draw_arc_spans() for a description of the parameters.
+ */
+static void gfx_generic_draw_filled_arcs(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t dw, gfx_coord_t dh, gfx_coord_t radius,
+		gfx_color_t color, uint8_t quadrant_mask)
 {
 	gfx_coord_t offset_x;
 	gfx_coord_t offset_y;
+	gfx_coord_t run_y;
 	int16_t error;
 
-	// Draw only a pixel if radius is zero.
-	if (radius == 0) {
-		gfx_draw_pixel(x, y, color);
-		return;
-	}
+#ifdef CONFIG_GFX_USE_CLIPPING
+	gfx_generic_unclipped = gfx_generic_is_inside_clip(x - radius,
+			y - radius, x + dw + radius, y + dh + radius);
+#endif
 
 	// Set up start iterators.
 	offset_x = 0;
@@ -275,31 +664,11 @@ void gfx_generic_draw_filled_circle(gfx_coord_t x, gfx_coord_t y,
 
 	// Iterate offset_x from 0 to radius.
 	while (offset_x <= offset_y) {
-		// Draw vertical lines tracking each quadrant.
-		if (quadrant_mask & GFX_QUADRANT0) {
-			gfx_draw_vertical_line(x + offset_y,
-					y - offset_x, offset_x + 1, color);
-			gfx_draw_vertical_line(x + offset_x,
-					y - offset_y, offset_y + 1, color);
-		}
-		if (quadrant_mask & GFX_QUADRANT1) {
-			gfx_draw_vertical_line(x - offset_y,
-					y - offset_x, offset_x + 1, color);
-			gfx_draw_vertical_line(x - offset_x,
-					y - offset_y, offset_y + 1, color);
-		}
-		if (quadrant_mask & GFX_QUADRANT2) {
-			gfx_draw_vertical_line(x - offset_y,
-					y, offset_x + 1, color);
-			gfx_draw_vertical_line(x - offset_x,
-					y, offset_y + 1, color);
-		}
-		if (quadrant_mask & GFX_QUADRANT3) {
-			gfx_draw_vertical_line(x + offset_y,
-					y, offset_x + 1, color);
-			gfx_draw_vertical_line(x + offset_x,
-					y, offset_y + 1, color);
-		}
+		run_y = offset_y;
+
+		// Draw the inner columns, which are all different.
+		gfx_generic_draw_filled_columns(x, y, dw, dh, offset_x,
+				offset_y, color, quadrant_mask);
 
 		// Update error value and step offset_y when required.
 		if (error < 0) {
@@ -309,11 +678,99 @@ void gfx_generic_draw_filled_circle(gfx_coord_t x, gfx_coord_t y,
 			--offset_y;
 		}
 
+		/* Draw the outer column when offset_y is stepped or the
+		 * octant is done, as it is then at its highest. Skip it if it
+		 * was just drawn as an inner column.
+		 */
+		if (((offset_y != run_y) || (offset_x + 1 > offset_y))
+				&& (run_y != offset_x)) {
+			gfx_generic_draw_filled_columns(x, y, dw, dh, run_y,
+					offset_x, color, quadrant_mask);
+		}
+
 		// Next X.
 		++offset_x;
 	}
+#ifdef CONFIG_GFX_USE_CLIPPING
+	gfx_generic_unclipped = false;
+#endif
+}
+
+void gfx_generic_draw_circle(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t radius, gfx_color_t color, uint8_t octant_mask)
+{
+	// Draw only a pixel if radius is zero.
+	if (radius == 0) {
+		gfx_draw_pixel(x, y, color);
+		return;
+	}
+
+	gfx_generic_draw_arcs(x, y, 0, 0, radius, color, octant_mask);
+}
+
+void gfx_generic_draw_filled_circle(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t radius, gfx_color_t color, uint8_t quadrant_mask)
+{
+	// Draw only a pixel if radius is zero.
+	if (radius == 0) {
+		gfx_draw_pixel(x, y, color);
+		return;
+	}
+
+	gfx_generic_draw_filled_arcs(x, y, 0, 0, radius, color,
+			quadrant_mask);
+}
+
+/**
+ * \internal
+ * \brief Limit corner radius to fit inside a rectangle
+ */
+static gfx_coord_t gfx_generic_fit_radius(gfx_coord_t width,
+		gfx_coord_t height, gfx_coord_t radius)
+{
+	if (2 * radius >= width)
+		radius = (width - 1) / 2;
+	if (2 * radius >= height)
+		radius = (height - 1) / 2;
+
+	return radius;
+}
+
+void gfx_generic_draw_rounded_rect(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_coord_t radius,
+		gfx_color_t color)
+{
+	if ((width <= 0) || (height <= 0))
+		return;
+
+	radius = gfx_generic_fit_radius(width, height, radius);
+
+	// The corners are the quadrants of a circle split at its center.
+	gfx_generic_draw_arcs(x + radius, y + radius,
+			width - 2 * radius - 1, height - 2 * radius - 1,
+			radius, color, GFX_WHOLE);
 }
 
+void gfx_generic_draw_filled_rounded_rect(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_coord_t radius,
+		gfx_color_t color)
+{
+	gfx_coord_t dw;
+
+	if ((width <= 0) || (height <= 0))
+		return;
+
+	radius = gfx_generic_fit_radius(width, height, radius);
+	dw = width - 2 * radius - 1;
+
+	// Columns between the left and right corners have full height.
+	if (dw > 1)
+		gfx_draw_filled_rect(x + radius + 1, y, dw - 1, height, color);
+
+	gfx_generic_draw_filled_arcs(x + radius, y + radius,
+			dw, height - 2 * radius - 1,
+			radius, color, GFX_WHOLE);
+}
 
 void gfx_generic_get_pixmap(gfx_color_t *pixmap, gfx_coord_t map_width,
 		gfx_coord_t map_x, gfx_coord_t map_y,
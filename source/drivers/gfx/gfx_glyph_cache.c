@@ -0,0 +1,474 @@
+/**
+ * \file
+ *
+ * \brief Glyph cache for fonts stored in hugemem
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <hugemem.h>
+#include <util.h>
+
+#include <gfx/gfx.h>
+#include <gfx/glyph_cache.h>
+
+/**
+ * \weakgroup gfx_glyph_cache
+ *
+ * Each cached glyph is stored row by row. A row starts with the number
+ * of foreground runs in the row, followed by one (x offset, length) byte
+ * pair per run. Rows without any foreground pixels are one byte.
+ *
+ * All glyph data is packed at the start of \ref glyph_cache_data. When a
+ * glyph is evicted, the data following it is moved down to close the
+ * gap, so the free space is always one contiguous block at the end.
+ *
+ * @{
+ */
+
+#ifndef CONFIG_FONT_PIXELS_PER_BYTE
+# define CONFIG_FONT_PIXELS_PER_BYTE    8
+#endif
+
+#if CONFIG_GFX_GLYPH_CACHE_SIZE > 0xffff
+# error CONFIG_GFX_GLYPH_CACHE_SIZE must fit in 16 bits
+#endif
+
+//! Maximum number of bytes in one row of a glyph bitmap.
+#define GLYPH_CACHE_MAX_ROW_SIZE        ((UINT8_MAX + 7) / 8)
+
+//! \internal Cached glyph metadata
+struct glyph_cache_entry {
+	//! Font the glyph belongs to, or NULL if the entry is unused.
+	const struct font       *font;
+	//! Font data the glyph was read from.
+	hugemem_ptr_t           font_data;
+	//! Offset of the glyph data in \ref glyph_cache_data.
+	uint16_t                offset;
+	//! Number of bytes of glyph data.
+	uint16_t                length;
+	//! Value of \ref glyph_cache_clock when the glyph was last drawn.
+	uint16_t                last_used;
+	//! Character the glyph represents.
+	uint8_t                 ch;
+};
+
+//! \internal Metadata for all glyphs in the cache.
+static struct glyph_cache_entry
+		glyph_cache_entries[CONFIG_GFX_GLYPH_CACHE_NR_ENTRIES];
+//! \internal Storage for the pre-expanded glyph data.
+static uint8_t glyph_cache_data[CONFIG_GFX_GLYPH_CACHE_SIZE];
+//! \internal Number of bytes at the start of glyph_cache_data in use.
+static uint16_t glyph_cache_used;
+//! \internal Counter incremented for every glyph drawn, used for LRU.
+static uint16_t glyph_cache_clock;
+//! \internal Usage statistics.
+static struct gfx_glyph_cache_stats glyph_cache_stats;
+
+/**
+ * \internal
+ * \brief Find foreground runs in one row of a glyph bitmap
+ *
+ * \param row Row bitmap, MSB of the first byte is the leftmost pixel.
+ * \param width Number of pixels in the row.
+ * \param spans Buffer to store (x offset, length) pairs in, or NULL to
+ *      only count the runs.
+ *
+ * \return Number of foreground runs in the row.
+ */
+static uint8_t glyph_cache_scan_row(const uint8_t *row, uint8_t width,
+		uint8_t *spans)
+{
+	uint8_t nr_spans = 0;
+	uint8_t start = 0;
+	bool    in_span = false;
+	uint8_t i;
+
+	for (i = 0; i < width; i++) {
+		bool set = row[i / 8] & (0x80 >> (i % 8));
+
+		if (set && !in_span) {
+			start = i;
+			in_span = true;
+		} else if (!set && in_span) {
+			if (spans) {
+				*spans++ = start;
+				*spans++ = i - start;
+			}
+			nr_spans++;
+			in_span = false;
+		}
+	}
+
+	if (in_span) {
+		if (spans) {
+			*spans++ = start;
+			*spans++ = width - start;
+		}
+		nr_spans++;
+	}
+
+	return nr_spans;
+}
+
+/**
+ * \internal
+ * \brief Look up a glyph in the cache
+ *
+ * \return Cache entry for \a ch in \a font, or NULL if not cached.
+ */
+static struct glyph_cache_entry *glyph_cache_lookup(char ch,
+		const struct font *font)
+{
+	struct glyph_cache_entry        *entry;
+	uint8_t                         i;
+
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++) {
+		entry = &glyph_cache_entries[i];
+		if (entry->font == font && entry->ch == (uint8_t)ch
+				&& entry->font_data == font->data.hugemem)
+			return entry;
+	}
+
+	return NULL;
+}
+
+/**
+ * \internal
+ * \brief Find the least recently used glyph in the cache
+ *
+ * \return The least recently used entry, or NULL if the cache is empty.
+ */
+static struct glyph_cache_entry *glyph_cache_find_lru(void)
+{
+	struct glyph_cache_entry        *lru = NULL;
+	uint16_t                        lru_age = 0;
+	uint8_t                         i;
+
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++) {
+		struct glyph_cache_entry        *entry;
+		uint16_t                        age;
+
+		entry = &glyph_cache_entries[i];
+		if (!entry->font)
+			continue;
+
+		age = glyph_cache_clock - entry->last_used;
+		if (!lru || age >= lru_age) {
+			lru = entry;
+			lru_age = age;
+		}
+	}
+
+	return lru;
+}
+
+//! \internal Hugemem address of \a offset in the glyph data.
+static inline hugemem_ptr_t glyph_cache_ptr(uint16_t offset)
+{
+	return (hugemem_ptr_t)(uintptr_t)&glyph_cache_data[offset];
+}
+
+/**
+ * \internal
+ * \brief Remove a glyph from the cache
+ *
+ * The glyph data is removed by moving all data following it down,
+ * including \a pending bytes of a glyph currently being added.
+ *
+ * \param entry Entry to remove.
+ * \param pending Number of bytes following the committed data to move.
+ */
+static void glyph_cache_remove(struct glyph_cache_entry *entry,
+		uint16_t pending)
+{
+	uint16_t        start = entry->offset;
+	uint16_t        length = entry->length;
+	uint16_t        end = glyph_cache_used + pending;
+	uint8_t         i;
+
+	assert(entry->font);
+	assert(start + length <= glyph_cache_used);
+
+	/*
+	 * Areas overlap, but data only moves down, which hugemem_copy()
+	 * allows. Internal SRAM is part of the hugemem address space, so
+	 * this lets the DMA controller move large blocks where available.
+	 */
+	hugemem_copy(glyph_cache_ptr(start), glyph_cache_ptr(start + length),
+			end - (start + length));
+
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++) {
+		struct glyph_cache_entry *other = &glyph_cache_entries[i];
+
+		if (other->font && other->offset > start)
+			other->offset -= length;
+	}
+
+	entry->font = NULL;
+	glyph_cache_used -= length;
+}
+
+/**
+ * \internal
+ * \brief Read a glyph from hugemem and add it to the cache
+ *
+ * Least recently used glyphs are evicted as needed to make room for the
+ * new glyph.
+ *
+ * \return Cache entry for the new glyph, or NULL if the glyph is too large
+ *      to fit in the cache.
+ */
+static struct glyph_cache_entry *glyph_cache_fill(char ch,
+		const struct font *font)
+{
+	struct glyph_cache_entry        *entry = NULL;
+	hugemem_ptr_t                   glyph_data;
+	uint8_t                         row[GLYPH_CACHE_MAX_ROW_SIZE];
+	uint8_t                         char_row_size;
+	uint16_t                        written = 0;
+	uint8_t                         i;
+
+	// Even an empty glyph needs one byte per row.
+	if (font->height > CONFIG_GFX_GLYPH_CACHE_SIZE)
+		return NULL;
+
+	// Grab an unused entry, or evict the least recently used glyph.
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++) {
+		if (!glyph_cache_entries[i].font) {
+			entry = &glyph_cache_entries[i];
+			break;
+		}
+	}
+	if (!entry) {
+		entry = glyph_cache_find_lru();
+		glyph_cache_remove(entry, 0);
+		glyph_cache_stats.evictions++;
+	}
+
+	char_row_size = font->width / CONFIG_FONT_PIXELS_PER_BYTE;
+	if (font->width % CONFIG_FONT_PIXELS_PER_BYTE)
+		char_row_size++;
+
+	glyph_data = (hugemem_ptr_t)((phys_addr_t)font->data.hugemem
+			+ (uint32_t)char_row_size * font->height
+			* ((uint8_t)ch - font->first_char));
+
+	/*
+	 * The new glyph is built at the end of the committed data. Its entry
+	 * is not marked as used until it is complete, so it is never picked
+	 * for eviction while in progress.
+	 */
+	for (i = 0; i < font->height; i++) {
+		uint8_t         *out;
+		uint8_t         nr_spans;
+		uint16_t        needed;
+
+		hugemem_read_block(row, glyph_data, char_row_size);
+		glyph_data = (hugemem_ptr_t)((phys_addr_t)glyph_data
+				+ char_row_size);
+
+		nr_spans = glyph_cache_scan_row(row, font->width, NULL);
+		needed = 1 + 2 * nr_spans;
+
+		while (glyph_cache_used + written + needed
+				> CONFIG_GFX_GLYPH_CACHE_SIZE) {
+			struct glyph_cache_entry *victim;
+
+			victim = glyph_cache_find_lru();
+			if (!victim)
+				return NULL;
+
+			glyph_cache_remove(victim, written);
+			glyph_cache_stats.evictions++;
+		}
+
+		out = &glyph_cache_data[glyph_cache_used + written];
+		*out++ = nr_spans;
+		glyph_cache_scan_row(row, font->width, out);
+		written += needed;
+	}
+
+	entry->font = font;
+	entry->font_data = font->data.hugemem;
+	entry->ch = ch;
+	entry->offset = glyph_cache_used;
+	entry->length = written;
+	glyph_cache_used += written;
+
+	return entry;
+}
+
+/**
+ * \internal
+ * \brief Draw a cached glyph to the display
+ */
+static void glyph_cache_draw(const struct glyph_cache_entry *entry,
+		gfx_coord_t x, gfx_coord_t y, const struct font *font,
+		gfx_color_t color)
+{
+	const uint8_t   *data = &glyph_cache_data[entry->offset];
+	uint8_t         scale = font->scale;
+	uint8_t         rows_left = font->height;
+
+	do {
+		uint8_t nr_spans = *data++;
+
+		while (nr_spans--) {
+			uint8_t span_x = *data++;
+			uint8_t span_length = *data++;
+
+			if (scale == 1)
+				gfx_draw_horizontal_line(x + span_x, y,
+						span_length, color);
+			else
+				gfx_draw_filled_rect(x + span_x * scale, y,
+						span_length * scale, scale,
+						color);
+		}
+
+		y += scale;
+	} while (--rows_left > 0);
+}
+
+/**
+ * \brief Draw a character from a hugemem font through the glyph cache
+ *
+ * If the glyph is not already cached, it is read from hugemem and added
+ * to the cache before it is drawn. Only the foreground pixels are drawn.
+ *
+ * \param ch Character to draw, must be within the range of \a font.
+ * \param x X coordinate on screen.
+ * \param y Y coordinate on screen.
+ * \param font Font to draw character in, must be stored in hugemem.
+ * \param color Foreground color of character.
+ *
+ * \retval true if the character was drawn
+ * \retval false if the glyph does not fit in the cache and the character
+ *      was not drawn
+ */
+bool gfx_glyph_cache_draw_char(char ch, gfx_coord_t x, gfx_coord_t y,
+		const struct font *font, gfx_color_t color)
+{
+	struct glyph_cache_entry        *entry;
+
+	assert(font);
+	assert(font->type == FONT_LOC_HUGEMEM);
+	assert(font->height > 0);
+
+	glyph_cache_clock++;
+
+	entry = glyph_cache_lookup(ch, font);
+	if (entry) {
+		glyph_cache_stats.hits++;
+	} else {
+		glyph_cache_stats.misses++;
+		entry = glyph_cache_fill(ch, font);
+		if (!entry)
+			return false;
+	}
+
+	entry->last_used = glyph_cache_clock;
+	glyph_cache_draw(entry, x, y, font, color);
+
+	return true;
+}
+
+/**
+ * \brief Remove all glyphs of a font from the cache
+ *
+ * This must be called before the glyph data or metadata of \a font is
+ * replaced.
+ *
+ * \param font Font to invalidate.
+ */
+void gfx_glyph_cache_invalidate_font(const struct font *font)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++) {
+		struct glyph_cache_entry *entry = &glyph_cache_entries[i];
+
+		if (entry->font == font)
+			glyph_cache_remove(entry, 0);
+	}
+}
+
+/**
+ * \brief Remove all glyphs from the cache
+ */
+void gfx_glyph_cache_flush(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++)
+		glyph_cache_entries[i].font = NULL;
+
+	glyph_cache_used = 0;
+}
+
+/**
+ * \brief Read glyph cache statistics
+ *
+ * \param stats Structure to store the statistics in.
+ */
+void gfx_glyph_cache_get_stats(struct gfx_glyph_cache_stats *stats)
+{
+	uint8_t i;
+
+	assert(stats);
+
+	memcpy(stats, &glyph_cache_stats, sizeof(struct gfx_glyph_cache_stats));
+
+	stats->bytes_used = glyph_cache_used;
+	stats->nr_glyphs = 0;
+	for (i = 0; i < ARRAY_LEN(glyph_cache_entries); i++) {
+		if (glyph_cache_entries[i].font)
+			stats->nr_glyphs++;
+	}
+}
+
+/**
+ * \brief Reset the hit, miss and eviction counters
+ */
+void gfx_glyph_cache_reset_stats(void)
+{
+	glyph_cache_stats.hits = 0;
+	glyph_cache_stats.misses = 0;
+	glyph_cache_stats.evictions = 0;
+}
+
+//! @}
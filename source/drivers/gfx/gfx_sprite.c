@@ -0,0 +1,818 @@
+/**
+ * \file
+ *
+ * \brief Sprite layer with transparency and save-under
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <hugemem.h>
+#include <progmem.h>
+#include <util.h>
+#include <workqueue.h>
+
+#include <gfx/gfx.h>
+#include <gfx/sprite.h>
+
+#ifdef CONFIG_GFX_FRAME
+# include <gfx/frame.h>
+#endif
+
+/**
+ * \weakgroup gfx_sprite
+ * @{
+ */
+
+//! \name Sprite state flags
+//@{
+//! The sprite should be on the screen after the next compose.
+#define GFX_SPRITE_VISIBLE      (1 << 0)
+//! The sprite is currently drawn on the screen.
+#define GFX_SPRITE_SHOWN        (1 << 1)
+//! The sprite has changed since the last compose.
+#define GFX_SPRITE_DIRTY        (1 << 2)
+//! The second save-under buffer holds the current background.
+#define GFX_SPRITE_SAVE_ALT     (1 << 3)
+//! The table entry is freed on the next compose.
+#define GFX_SPRITE_DESTROYED    (1 << 4)
+//@}
+
+//! Maximum number of dirty rectangles, one old and one new per sprite.
+#define GFX_SPRITE_NR_DIRTY     (2 * CONFIG_GFX_SPRITE_NR)
+
+//! \internal Screen rectangle, all coordinates inclusive.
+struct gfx_sprite_rect {
+	gfx_coord_t     x1;
+	gfx_coord_t     y1;
+	gfx_coord_t     x2;
+	gfx_coord_t     y2;
+};
+
+//! \internal Sprite table.
+static struct gfx_sprite gfx_sprite_table[CONFIG_GFX_SPRITE_NR];
+
+//! \internal Sprites which are visible after the compose, by ascending z.
+static struct gfx_sprite *gfx_sprite_order[CONFIG_GFX_SPRITE_NR];
+
+//! \internal Dirty rectangles of the compose in progress.
+static struct gfx_sprite_rect gfx_sprite_dirty[GFX_SPRITE_NR_DIRTY];
+
+//! \internal Screen line being composed.
+static gfx_color_t gfx_sprite_line[CONFIG_GFX_SPRITE_LINE_PIXELS];
+
+//! \internal Sprite pixels read from the bitmap.
+static gfx_color_t gfx_sprite_pixels[CONFIG_GFX_SPRITE_LINE_PIXELS];
+
+//! \internal Sprite mask bits read from the mask, with room for misalignment.
+static uint8_t gfx_sprite_mask_bits[CONFIG_GFX_SPRITE_LINE_PIXELS / 8 + 2];
+
+//! \internal Task running gfx_sprite_compose() from the main workqueue.
+static struct workqueue_task gfx_sprite_task;
+
+/**
+ * \internal
+ * \brief Get the screen rectangle covered by a sprite at a position
+ *
+ * The rectangle is not clipped to the screen.
+ */
+static void gfx_sprite_get_rect(const struct gfx_sprite *sprite,
+		gfx_coord_t x, gfx_coord_t y, struct gfx_sprite_rect *rect)
+{
+	rect->x1 = x;
+	rect->y1 = y;
+	rect->x2 = x + sprite->bmp->width - 1;
+	rect->y2 = y + sprite->bmp->height - 1;
+}
+
+/**
+ * \internal
+ * \brief Check if two rectangles overlap
+ */
+static bool gfx_sprite_rect_overlaps(const struct gfx_sprite_rect *a,
+		const struct gfx_sprite_rect *b)
+{
+	return (a->x1 <= b->x2) && (b->x1 <= a->x2)
+			&& (a->y1 <= b->y2) && (b->y1 <= a->y2);
+}
+
+/**
+ * \internal
+ * \brief Add a screen area to the dirty rectangles
+ *
+ * The area is clipped to the screen, and merged with the existing dirty
+ * rectangles until none of them overlap, so that no pixel is composed
+ * twice.
+ *
+ * \param rect     Area to add.
+ * \param nr_dirty Number of dirty rectangles so far.
+ *
+ * \return New number of dirty rectangles.
+ */
+static uint8_t gfx_sprite_add_dirty(const struct gfx_sprite_rect *rect,
+		uint8_t nr_dirty)
+{
+	struct gfx_sprite_rect  area;
+	uint8_t                 i;
+
+	area.x1 = max_s(rect->x1, 0);
+	area.y1 = max_s(rect->y1, 0);
+	area.x2 = min_s(rect->x2, gfx_get_width() - 1);
+	area.y2 = min_s(rect->y2, gfx_get_height() - 1);
+	if (area.x1 > area.x2 || area.y1 > area.y2)
+		return nr_dirty;
+
+	/*
+	 * Each merge removes one rectangle from the list and grows the new
+	 * area, which may then overlap rectangles already checked, so
+	 * start over after every merge.
+	 */
+	i = 0;
+	while (i < nr_dirty) {
+		struct gfx_sprite_rect *dirty = &gfx_sprite_dirty[i];
+
+		if (!gfx_sprite_rect_overlaps(&area, dirty)) {
+			i++;
+			continue;
+		}
+
+		area.x1 = min_s(area.x1, dirty->x1);
+		area.y1 = min_s(area.y1, dirty->y1);
+		area.x2 = max_s(area.x2, dirty->x2);
+		area.y2 = max_s(area.y2, dirty->y2);
+
+		*dirty = gfx_sprite_dirty[--nr_dirty];
+		i = 0;
+	}
+
+	assert(nr_dirty < GFX_SPRITE_NR_DIRTY);
+	gfx_sprite_dirty[nr_dirty] = area;
+
+	return nr_dirty + 1;
+}
+
+/**
+ * \internal
+ * \brief Get the address of a pixel in a save-under buffer
+ *
+ * \param sprite Sprite owning the save-under.
+ * \param alt    True for the buffer not currently in use.
+ * \param col    Column within the sprite.
+ * \param row    Line within the sprite.
+ */
+static hugemem_ptr_t gfx_sprite_save_under_ptr(
+		const struct gfx_sprite *sprite, bool alt,
+		gfx_coord_t col, gfx_coord_t row)
+{
+	uint32_t        pixels = (uint32_t)sprite->bmp->width
+			* sprite->bmp->height;
+	uint32_t        offset;
+
+	if (!!(sprite->flags & GFX_SPRITE_SAVE_ALT) != alt)
+		offset = pixels;
+	else
+		offset = 0;
+	offset += (uint32_t)row * sprite->bmp->width + col;
+
+	return (hugemem_ptr_t)((phys_addr_t)sprite->save_under
+			+ offset * sizeof(gfx_color_t));
+}
+
+/**
+ * \internal
+ * \brief Read a part of one line of the sprite bitmap
+ *
+ * Pixels with the transparent index of an indexed color bitmap are taken
+ * from \a line, so they leave the screen unchanged whatever the
+ * transparency mode of the sprite is.
+ *
+ * \param sprite Sprite to read.
+ * \param line   Line buffer position of column \a col.
+ * \param col    First column within the sprite.
+ * \param row    Line within the sprite.
+ * \param count  Number of pixels to read.
+ *
+ * \return Pointer to the pixels, which is either the bitmap itself or
+ * the sprite pixel buffer.
+ */
+static const gfx_color_t *gfx_sprite_read_pixels(
+		const struct gfx_sprite *sprite, const gfx_color_t *line,
+		gfx_coord_t col, gfx_coord_t row, gfx_coord_t count)
+{
+	const struct gfx_bitmap *bmp = sprite->bmp;
+	uint32_t                offset;
+	gfx_coord_t             i;
+
+	offset = (uint32_t)row * bmp->width + col;
+
+	switch (bmp->type) {
+	case BITMAP_SOLID:
+		for (i = 0; i < count; i++)
+			gfx_sprite_pixels[i] = bmp->data.color;
+		return gfx_sprite_pixels;
+
+	case BITMAP_RAM:
+		return bmp->data.pixmap + offset;
+
+	case BITMAP_PROGMEM: {
+		const uint8_t __progmem_arg *from;
+		uint8_t                 *to = (uint8_t *)gfx_sprite_pixels;
+		uint16_t                bytes = count * sizeof(gfx_color_t);
+
+		from = (const uint8_t __progmem_arg *)(bmp->data.progmem
+				+ offset);
+		while (bytes--)
+			*to++ = progmem_read8(from++);
+		return gfx_sprite_pixels;
+	}
+
+#ifdef CONFIG_HUGEMEM
+	case BITMAP_HUGEMEM:
+		hugemem_read_block(gfx_sprite_pixels,
+				(hugemem_ptr_t)((phys_addr_t)bmp->data.hugemem
+				+ offset * sizeof(gfx_color_t)),
+				count * sizeof(gfx_color_t));
+		return gfx_sprite_pixels;
+#endif
+
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+	case BITMAP_INDEXED_RAM:
+	case BITMAP_INDEXED_PROGMEM:
+# ifdef CONFIG_HUGEMEM
+	case BITMAP_INDEXED_HUGEMEM:
+# endif
+		memcpy(gfx_sprite_pixels, line, count * sizeof(gfx_color_t));
+		gfx_bitmap_priv_read_indexed(bmp, gfx_sprite_pixels, col, row,
+				count);
+		return gfx_sprite_pixels;
+#endif
+
+	default:
+		unhandled_case(bmp->type);
+		return gfx_sprite_pixels;
+	}
+}
+
+/**
+ * \internal
+ * \brief Read the mask bits for a part of one line of the sprite
+ *
+ * The mask bytes covering the columns are copied to the mask buffer.
+ * The bit for column \a col is found at bit (col & 7), counting from the
+ * most significant bit, of the first byte.
+ */
+static void gfx_sprite_read_mask(const struct gfx_sprite *sprite,
+		gfx_coord_t col, gfx_coord_t row, gfx_coord_t count)
+{
+	uint16_t        offset;
+	uint8_t         bytes;
+
+	offset = row * ((sprite->bmp->width + 7) / 8) + col / 8;
+	bytes = ((col & 7) + count + 7) / 8;
+
+	switch (sprite->mask_type) {
+	case BITMAP_RAM:
+		memcpy(gfx_sprite_mask_bits, sprite->mask.ram + offset, bytes);
+		break;
+
+	case BITMAP_PROGMEM: {
+		const uint8_t __progmem_arg *from;
+		uint8_t                 i;
+
+		from = sprite->mask.progmem + offset;
+		for (i = 0; i < bytes; i++)
+			gfx_sprite_mask_bits[i] = progmem_read8(from + i);
+		break;
+	}
+
+#ifdef CONFIG_HUGEMEM
+	case BITMAP_HUGEMEM:
+		hugemem_read_block(gfx_sprite_mask_bits,
+				(hugemem_ptr_t)((phys_addr_t)sprite->mask.hugemem
+				+ offset), bytes);
+		break;
+#endif
+
+	default:
+		unhandled_case(sprite->mask_type);
+	}
+}
+
+/**
+ * \internal
+ * \brief Paint a part of one line of a sprite into the line buffer
+ *
+ * \param sprite Sprite to paint.
+ * \param line   Line buffer position of column \a col.
+ * \param col    First column within the sprite.
+ * \param row    Line within the sprite.
+ * \param count  Number of pixels to paint.
+ */
+static void gfx_sprite_paint(const struct gfx_sprite *sprite,
+		gfx_color_t *line, gfx_coord_t col, gfx_coord_t row,
+		gfx_coord_t count)
+{
+	const gfx_color_t       *pixels;
+	gfx_coord_t             i;
+
+	pixels = gfx_sprite_read_pixels(sprite, line, col, row, count);
+
+	switch (sprite->transparency) {
+	case GFX_SPRITE_OPAQUE:
+		memcpy(line, pixels, count * sizeof(gfx_color_t));
+		break;
+
+	case GFX_SPRITE_COLOR_KEY:
+		for (i = 0; i < count; i++) {
+			if (pixels[i] != sprite->color_key)
+				line[i] = pixels[i];
+		}
+		break;
+
+	case GFX_SPRITE_MASK: {
+		const uint8_t   *bits = gfx_sprite_mask_bits;
+		uint8_t         bit = 0x80 >> (col & 7);
+
+		gfx_sprite_read_mask(sprite, col, row, count);
+		for (i = 0; i < count; i++) {
+			if (*bits & bit)
+				line[i] = pixels[i];
+			bit >>= 1;
+			if (!bit) {
+				bit = 0x80;
+				bits++;
+			}
+		}
+		break;
+	}
+
+	default:
+		unhandled_case(sprite->transparency);
+	}
+}
+
+/**
+ * \internal
+ * \brief Compose one line of a dirty rectangle
+ *
+ * \param x1 Left screen column of the line.
+ * \param x2 Right screen column of the line.
+ * \param y  Screen line.
+ * \param nr_visible Number of sprites in \ref gfx_sprite_order.
+ */
+static void gfx_sprite_compose_line(gfx_coord_t x1, gfx_coord_t x2,
+		gfx_coord_t y, uint8_t nr_visible)
+{
+	struct gfx_sprite       *sprite;
+	struct gfx_sprite_rect  rect;
+	gfx_coord_t             count = x2 - x1 + 1;
+	gfx_coord_t             sx1;
+	gfx_coord_t             sx2;
+	uint8_t                 i;
+
+	gfx_set_limits(x1, y, x2, y);
+	gfx_copy_pixels_from_screen(gfx_sprite_line, count);
+
+	/*
+	 * Put back the background under the sprites currently on the
+	 * screen. All save-unders are taken from lines which have been
+	 * restored like this, so they never contain other sprites, and the
+	 * order in which they are restored does not matter.
+	 */
+	for (i = 0; i < CONFIG_GFX_SPRITE_NR; i++) {
+		sprite = &gfx_sprite_table[i];
+		if (!(sprite->flags & GFX_SPRITE_SHOWN))
+			continue;
+
+		gfx_sprite_get_rect(sprite, sprite->shown_x, sprite->shown_y,
+				&rect);
+		if (y < rect.y1 || y > rect.y2)
+			continue;
+		sx1 = max_s(x1, rect.x1);
+		sx2 = min_s(x2, rect.x2);
+		if (sx1 > sx2)
+			continue;
+
+		hugemem_read_block(&gfx_sprite_line[sx1 - x1],
+				gfx_sprite_save_under_ptr(sprite, false,
+					sx1 - rect.x1, y - rect.y1),
+				(sx2 - sx1 + 1) * sizeof(gfx_color_t));
+	}
+
+	/*
+	 * The line is now pure background. Save it under the sprites which
+	 * have changed, and paint all visible sprites on top of it.
+	 */
+	for (i = 0; i < nr_visible; i++) {
+		sprite = gfx_sprite_order[i];
+
+		gfx_sprite_get_rect(sprite, sprite->x, sprite->y, &rect);
+		if (y < rect.y1 || y > rect.y2)
+			continue;
+		sx1 = max_s(x1, rect.x1);
+		sx2 = min_s(x2, rect.x2);
+		if (sx1 > sx2)
+			continue;
+
+		if (sprite->flags & GFX_SPRITE_DIRTY)
+			hugemem_write_block(gfx_sprite_save_under_ptr(sprite,
+						true, sx1 - rect.x1, y - rect.y1),
+					&gfx_sprite_line[sx1 - x1],
+					(sx2 - sx1 + 1) * sizeof(gfx_color_t));
+	}
+
+	for (i = 0; i < nr_visible; i++) {
+		sprite = gfx_sprite_order[i];
+
+		gfx_sprite_get_rect(sprite, sprite->x, sprite->y, &rect);
+		if (y < rect.y1 || y > rect.y2)
+			continue;
+		sx1 = max_s(x1, rect.x1);
+		sx2 = min_s(x2, rect.x2);
+		if (sx1 > sx2)
+			continue;
+
+		gfx_sprite_paint(sprite, &gfx_sprite_line[sx1 - x1],
+				sx1 - rect.x1, y - rect.y1, sx2 - sx1 + 1);
+	}
+
+	gfx_set_limits(x1, y, x2, y);
+	gfx_copy_pixels_to_screen(gfx_sprite_line, count);
+}
+
+/**
+ * \internal
+ * \brief Mark a sprite as changed
+ */
+static void gfx_sprite_set_dirty(struct gfx_sprite *sprite)
+{
+	assert(sprite);
+	assert(sprite->bmp);
+	assert(!(sprite->flags & GFX_SPRITE_DESTROYED));
+
+	sprite->flags |= GFX_SPRITE_DIRTY;
+}
+
+/**
+ * \brief Create a sprite
+ *
+ * Allocate an entry in the sprite table for a bitmap. The sprite is
+ * created hidden and opaque at position (0, 0).
+ *
+ * The save-under must be gfx_sprite_save_under_size() bytes of hugemem,
+ * and must be kept until the sprite has been destroyed and composed.
+ * Sprites which are never visible at the same time may share a
+ * save-under.
+ *
+ * \param bmp        Bitmap to draw. Gradient bitmaps are not supported.
+ *                   Indexed color bitmaps are, and their transparent
+ *                   index is honored in all transparency modes.
+ * \param save_under Buffer for the pixels under the sprite.
+ * \param z          Height in the z-order. Sprites of equal height are
+ *                   drawn in table order.
+ *
+ * \return The new sprite, or NULL if the sprite table is full.
+ */
+struct gfx_sprite *gfx_sprite_create(const struct gfx_bitmap *bmp,
+		hugemem_ptr_t save_under, uint8_t z)
+{
+	struct gfx_sprite       *sprite;
+	uint8_t                 i;
+
+	assert(bmp);
+	assert(bmp->width > 0 && bmp->height > 0);
+#ifdef CONFIG_GRADIENT
+	assert(bmp->type != BITMAP_GRADIENT);
+#endif
+	assert(save_under != HUGEMEM_NULL);
+
+	for (i = 0; i < CONFIG_GFX_SPRITE_NR; i++) {
+		sprite = &gfx_sprite_table[i];
+		if (!sprite->bmp) {
+			memset(sprite, 0, sizeof(*sprite));
+			sprite->bmp = bmp;
+			sprite->save_under = save_under;
+			sprite->z = z;
+			sprite->transparency = GFX_SPRITE_OPAQUE;
+			return sprite;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Destroy a sprite
+ *
+ * The sprite is removed from the screen on the next compose, after which
+ * its table entry, bitmap and save-under may be reused.
+ *
+ * \param sprite Sprite to destroy.
+ */
+void gfx_sprite_destroy(struct gfx_sprite *sprite)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->flags &= ~GFX_SPRITE_VISIBLE;
+	sprite->flags |= GFX_SPRITE_DESTROYED;
+}
+
+/**
+ * \brief Draw a sprite with a transparent color
+ *
+ * \param sprite Sprite to change.
+ * \param key    Color of the pixels which are not drawn.
+ */
+void gfx_sprite_set_color_key(struct gfx_sprite *sprite, gfx_color_t key)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->transparency = GFX_SPRITE_COLOR_KEY;
+	sprite->color_key = key;
+}
+
+/**
+ * \brief Draw a sprite through a transparency mask in SRAM
+ *
+ * The mask has one bit per bitmap pixel, most significant bit first,
+ * and pixels with a zero bit are not drawn. See gfx_sprite_mask_size().
+ *
+ * \param sprite Sprite to change.
+ * \param mask   Transparency mask.
+ */
+void gfx_sprite_set_mask(struct gfx_sprite *sprite, const uint8_t *mask)
+{
+	assert(mask);
+
+	gfx_sprite_set_dirty(sprite);
+	sprite->transparency = GFX_SPRITE_MASK;
+	sprite->mask_type = BITMAP_RAM;
+	sprite->mask.ram = mask;
+}
+
+/**
+ * \brief Draw a sprite through a transparency mask in progmem
+ *
+ * \param sprite Sprite to change.
+ * \param mask   Transparency mask, see gfx_sprite_set_mask().
+ */
+void gfx_sprite_set_progmem_mask(struct gfx_sprite *sprite,
+		const uint8_t __progmem_arg *mask)
+{
+	assert(mask);
+
+	gfx_sprite_set_dirty(sprite);
+	sprite->transparency = GFX_SPRITE_MASK;
+	sprite->mask_type = BITMAP_PROGMEM;
+	sprite->mask.progmem = mask;
+}
+
+#if defined(CONFIG_HUGEMEM) || defined(__DOXYGEN__)
+/**
+ * \brief Draw a sprite through a transparency mask in hugemem
+ *
+ * \param sprite Sprite to change.
+ * \param mask   Transparency mask, see gfx_sprite_set_mask().
+ */
+void gfx_sprite_set_hugemem_mask(struct gfx_sprite *sprite,
+		hugemem_ptr_t mask)
+{
+	assert(mask != HUGEMEM_NULL);
+
+	gfx_sprite_set_dirty(sprite);
+	sprite->transparency = GFX_SPRITE_MASK;
+	sprite->mask_type = BITMAP_HUGEMEM;
+	sprite->mask.hugemem = mask;
+}
+#endif
+
+/**
+ * \brief Draw all pixels of a sprite
+ *
+ * \param sprite Sprite to change.
+ */
+void gfx_sprite_set_opaque(struct gfx_sprite *sprite)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->transparency = GFX_SPRITE_OPAQUE;
+}
+
+/**
+ * \brief Change the bitmap of a sprite
+ *
+ * This is typically used to step through the frames of an animation.
+ * The new bitmap must have the same size as the old one, as the size of
+ * the save-under and mask depend on it.
+ *
+ * \param sprite Sprite to change.
+ * \param bmp    New bitmap.
+ */
+void gfx_sprite_set_bitmap(struct gfx_sprite *sprite,
+		const struct gfx_bitmap *bmp)
+{
+	assert(bmp);
+	gfx_sprite_set_dirty(sprite);
+	assert(bmp->width == sprite->bmp->width);
+	assert(bmp->height == sprite->bmp->height);
+#ifdef CONFIG_GRADIENT
+	assert(bmp->type != BITMAP_GRADIENT);
+#endif
+
+	sprite->bmp = bmp;
+}
+
+/**
+ * \brief Move a sprite
+ *
+ * The sprite may be partly or completely outside the screen.
+ *
+ * \param sprite Sprite to move.
+ * \param x      New left screen coordinate.
+ * \param y      New top screen coordinate.
+ */
+void gfx_sprite_move(struct gfx_sprite *sprite, gfx_coord_t x,
+		gfx_coord_t y)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->x = x;
+	sprite->y = y;
+}
+
+/**
+ * \brief Change the height of a sprite in the z-order
+ *
+ * \param sprite Sprite to change.
+ * \param z      New height. Higher sprites are drawn on top.
+ */
+void gfx_sprite_set_z(struct gfx_sprite *sprite, uint8_t z)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->z = z;
+}
+
+/**
+ * \brief Show a sprite on the next compose
+ *
+ * \param sprite Sprite to show.
+ */
+void gfx_sprite_show(struct gfx_sprite *sprite)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->flags |= GFX_SPRITE_VISIBLE;
+}
+
+/**
+ * \brief Remove a sprite from the screen on the next compose
+ *
+ * \param sprite Sprite to hide.
+ */
+void gfx_sprite_hide(struct gfx_sprite *sprite)
+{
+	gfx_sprite_set_dirty(sprite);
+	sprite->flags &= ~GFX_SPRITE_VISIBLE;
+}
+
+/**
+ * \brief Update the screen with the changes to the sprites
+ *
+ * Only the screen areas covered by changed sprites, before or after the
+ * change, are read back and written to the screen.
+ */
+void gfx_sprite_compose(void)
+{
+	struct gfx_sprite       *sprite;
+	struct gfx_sprite_rect  rect;
+	uint8_t                 nr_dirty = 0;
+	uint8_t                 nr_visible = 0;
+	uint8_t                 i;
+	uint8_t                 j;
+
+	for (i = 0; i < CONFIG_GFX_SPRITE_NR; i++) {
+		sprite = &gfx_sprite_table[i];
+		if (!sprite->bmp)
+			continue;
+
+		if (sprite->flags & GFX_SPRITE_DIRTY) {
+			if (sprite->flags & GFX_SPRITE_SHOWN) {
+				gfx_sprite_get_rect(sprite, sprite->shown_x,
+						sprite->shown_y, &rect);
+				nr_dirty = gfx_sprite_add_dirty(&rect,
+						nr_dirty);
+			}
+			if (sprite->flags & GFX_SPRITE_VISIBLE) {
+				gfx_sprite_get_rect(sprite, sprite->x,
+						sprite->y, &rect);
+				nr_dirty = gfx_sprite_add_dirty(&rect,
+						nr_dirty);
+			}
+		}
+
+		if (!(sprite->flags & GFX_SPRITE_VISIBLE))
+			continue;
+
+		// Insertion sort by z, keeping table order for equal z.
+		for (j = nr_visible; j > 0; j--) {
+			if (gfx_sprite_order[j - 1]->z <= sprite->z)
+				break;
+			gfx_sprite_order[j] = gfx_sprite_order[j - 1];
+		}
+		gfx_sprite_order[j] = sprite;
+		nr_visible++;
+	}
+
+	for (i = 0; i < nr_dirty; i++) {
+		struct gfx_sprite_rect  *dirty = &gfx_sprite_dirty[i];
+		gfx_coord_t             x1;
+		gfx_coord_t             x2;
+		gfx_coord_t             y;
+
+		for (x1 = dirty->x1; x1 <= dirty->x2; x1 = x2 + 1) {
+			x2 = min_s(dirty->x2,
+					x1 + CONFIG_GFX_SPRITE_LINE_PIXELS - 1);
+			for (y = dirty->y1; y <= dirty->y2; y++)
+				gfx_sprite_compose_line(x1, x2, y, nr_visible);
+		}
+	}
+
+	for (i = 0; i < CONFIG_GFX_SPRITE_NR; i++) {
+		sprite = &gfx_sprite_table[i];
+		if (!sprite->bmp || !(sprite->flags & GFX_SPRITE_DIRTY))
+			continue;
+
+		if (sprite->flags & GFX_SPRITE_DESTROYED) {
+			sprite->bmp = NULL;
+			sprite->flags = 0;
+			continue;
+		}
+
+		sprite->flags &= ~(GFX_SPRITE_DIRTY | GFX_SPRITE_SHOWN);
+		if (sprite->flags & GFX_SPRITE_VISIBLE) {
+			sprite->flags ^= GFX_SPRITE_SAVE_ALT;
+			sprite->flags |= GFX_SPRITE_SHOWN;
+			sprite->shown_x = sprite->x;
+			sprite->shown_y = sprite->y;
+		}
+	}
+}
+
+//! \internal Workqueue wrapper for gfx_sprite_compose().
+static void gfx_sprite_compose_worker(struct workqueue_task *task)
+{
+	gfx_sprite_compose();
+}
+
+/**
+ * \brief Compose the sprites from the main workqueue
+ *
+ * If a compose is already queued, all changes made until it runs are
+ * included in it, so several parts of an application can update their
+ * sprites and schedule a compose without drawing the screen more than
+ * once.
+ *
+ * With the \ref gfx_frame "frame scheduler", the compose is held back
+ * until the next refresh of the panel starts, so the sprites are
+ * composed at most once per refresh and never while the panel scans
+ * them out.
+ */
+void gfx_sprite_schedule_compose(void)
+{
+	workqueue_task_set_work_func(&gfx_sprite_task,
+			gfx_sprite_compose_worker);
+#ifdef CONFIG_GFX_FRAME
+	gfx_frame_add_task(&gfx_sprite_task);
+#else
+	workqueue_add_task(&main_workqueue, &gfx_sprite_task);
+#endif
+}
+
+//! @}
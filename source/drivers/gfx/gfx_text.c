@@ -42,6 +42,9 @@
 #endif
 
 #include <gfx/gfx.h>
+#ifdef CONFIG_GFX_GLYPH_CACHE
+#include <gfx/glyph_cache.h>
+#endif
 
 #ifndef CONFIG_FONT_PIXELS_PER_BYTE
 # define CONFIG_FONT_PIXELS_PER_BYTE    8
@@ -99,7 +102,7 @@ static void gfx_draw_char_hugemem(char ch, gfx_coord_t x, gfx_coord_t y,
 					hugemem_ptr_t source =
 						font->data.hugemem;
 					source = (hugemem_ptr_t)
-						((uint32_t)source +
+						((phys_addr_t)source +
 						 glyph_data_offset);
 
 					hugemem_read_block(char_buff, source,
@@ -220,6 +223,11 @@ void gfx_draw_char(char c, gfx_coord_t x, gfx_coord_t y, struct font* font,
 		break;
 #ifdef CONFIG_HUGEMEM
 	case FONT_LOC_HUGEMEM:
+#ifdef CONFIG_GFX_GLYPH_CACHE
+		// Fall back to reading hugemem if glyph is too large to cache.
+		if (gfx_glyph_cache_draw_char(c, x, y, font, color))
+			break;
+#endif
 		gfx_draw_char_hugemem(c, x, y, font, color, background_color);
 		break;
 #endif
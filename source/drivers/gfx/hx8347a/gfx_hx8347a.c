@@ -50,6 +50,8 @@
 # include "hx8347a_xmega.h"
 #elif defined(CONFIG_CPU_UC3)
 # include "hx8347a_ebi.h"
+#elif defined(CONFIG_CPU_HOST)
+# include "hx8347a_host.h"
 #endif
 
 #ifdef CONFIG_GFX_USE_CLIPPING
@@ -59,12 +61,10 @@ gfx_coord_t gfx_max_x;
 gfx_coord_t gfx_max_y;
 #endif
 
+#ifndef CONFIG_GFX_FIXED_ORIENTATION
 gfx_coord_t gfx_width;
 gfx_coord_t gfx_height;
-
-
-#define GFX_PANELWIDTH 240
-#define GFX_PANELHEIGHT 320
+#endif
 
 //! \internal Read-modify-write shortcut to set bits in a register.
 static void gfx_set_register(uint8_t address, uint8_t bitmask)
@@ -202,11 +202,21 @@ void gfx_init(void)
 
 	// Start off with standard orientation..
 	gfx_set_orientation(GFX_DEFAULT_ORIENTATION);
+
+#ifdef CONFIG_GFX_FRAME
+	// Drive the TE output, which the frame scheduler syncs to.
+	gfx_init_te();
+	gfx_set_register(HX8347A_INTERNAL28, 1 << HX8347A_TEON);
+#endif
 }
 
 void gfx_sync(void)
 {
+#ifdef CONFIG_GFX_HX8347A_DMA
+	hx_dma_wait();
+#else
 	// Intentionally empty, since this driver implementation is synchronous.
+#endif
 }
 
 void gfx_set_clipping(gfx_coord_t min_x, gfx_coord_t min_y,
@@ -235,6 +245,10 @@ void gfx_set_orientation(uint8_t flags)
 	uint8_t setting = 0;
 	uint8_t regval;
 
+#ifdef CONFIG_GFX_FIXED_ORIENTATION
+	assert(flags == GFX_FIXED_ORIENTATION);
+#endif
+
 	setting |= (flags & GFX_FLIP_X ? GFX_HX_FLIP_X : 0);
 	setting |= (flags & GFX_FLIP_Y ? GFX_HX_FLIP_Y : 0);
 	setting |= (flags & GFX_SWITCH_XY ? GFX_HX_SWITCH_XY : 0);
@@ -245,14 +259,16 @@ void gfx_set_orientation(uint8_t flags)
 	regval |= setting;
 	gfx_write_register(HX8347A_MEMACCESSCTRL, regval);
 
+#ifndef CONFIG_GFX_FIXED_ORIENTATION
 	// Switch width and height if XY is switched.
 	if ((setting & GFX_HX_SWITCH_XY) != 0x00) {
-		gfx_width = GFX_PANELHEIGHT;
-		gfx_height = GFX_PANELWIDTH;
+		gfx_width = GFX_PANEL_HEIGHT;
+		gfx_height = GFX_PANEL_WIDTH;
 	} else {
-		gfx_width = GFX_PANELWIDTH;
-		gfx_height = GFX_PANELHEIGHT;
+		gfx_width = GFX_PANEL_WIDTH;
+		gfx_height = GFX_PANEL_HEIGHT;
 	}
+#endif
 
 #ifdef CONFIG_GFX_USE_CLIPPING
 	// Reset clipping region.
@@ -0,0 +1,367 @@
+/**
+ * \file
+ *
+ * \brief HX8347A display controller DMA backend for AVR32 UC3 DMACA
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef DRIVERS_GFX_HX8347A_HX8347A_DMACA_H_INCLUDED
+#define DRIVERS_GFX_HX8347A_HX8347A_DMACA_H_INCLUDED
+
+#include <assert.h>
+#include <byteorder.h>
+#include <hugemem.h>
+#include <intc.h>
+#include <interrupt.h>
+#include <io.h>
+#include <physmem.h>
+#include <util.h>
+#include <workqueue.h>
+#include <chip/irq-map.h>
+#include <chip/memory-map.h>
+#include <chip/sysclk.h>
+#include <regs/avr32_dmaca.h>
+
+#ifdef CONFIG_SLEEPMGR
+# include <sleepmgr.h>
+#endif
+
+/*
+ * Pixel data is moved to the command register of the display controller
+ * by a DMACA channel, while the CPU goes on with other work:
+ *   - Fills use a constant source holding the color.
+ *   - Copies are converted to the byte order of the display bus into one of
+ *     two bounce buffers, which is sent while the next part of the copy is
+ *     converted into the other one.
+ *
+ * Both kinds of operations may return before all pixels have been sent.
+ * Every other access to the display controller starts by writing the index
+ * register through hx_write_index(), which waits for the channel to finish
+ * first, so the display is always accessed in order. gfx_sync() waits as
+ * well, and gfx_sync_async() schedules a task when the channel is done.
+ *
+ * Blocks are chained from the DMACA interrupt handler, or by polling when
+ * waiting for the channel, so waiting also works with interrupts masked.
+ */
+
+//! DMACA channel moving pixels to the display.
+#ifndef CONFIG_GFX_HX8347A_DMA_CH
+# define CONFIG_GFX_HX8347A_DMA_CH      0
+#endif
+
+//! Interrupt level of the DMACA interrupt.
+#ifndef CONFIG_GFX_HX8347A_DMA_INTLVL
+# define CONFIG_GFX_HX8347A_DMA_INTLVL  0
+#endif
+
+//! Minimum number of pixels to use the DMACA for.
+#ifndef CONFIG_GFX_HX8347A_DMA_THRESHOLD
+# define CONFIG_GFX_HX8347A_DMA_THRESHOLD       16
+#endif
+
+//! Number of pixels in each bounce buffer.
+#ifndef CONFIG_GFX_HX8347A_DMA_BUF_PIXELS
+# define CONFIG_GFX_HX8347A_DMA_BUF_PIXELS      256
+#endif
+
+#if CONFIG_GFX_HX8347A_DMA_BUF_PIXELS > DMACA_MAX_BLOCK_TS
+# error CONFIG_GFX_HX8347A_DMA_BUF_PIXELS is larger than a DMACA block
+#endif
+
+//! Mask of the DMACA channel in the channel and interrupt registers.
+#define HX_DMA_CH_MASK          (1U << CONFIG_GFX_HX8347A_DMA_CH)
+
+/**
+ * \internal
+ * \brief DMA state of the display driver.
+ */
+struct hx_dma {
+	//! Tasks waiting for the channel to be done.
+	struct workqueue        waiters;
+	//! Constant source for fills, in DMA-able memory.
+	uint16_t                *fill_color;
+	//! Bounce buffers for copies, in DMA-able memory.
+	uint16_t                *bounce[2];
+	//! Index of the bounce buffer to fill next.
+	uint8_t                 next_bounce;
+	//! True if the source address is the same for all pixels.
+	bool                    fixed_src;
+	//! True while the channel is moving pixels.
+	volatile bool           busy;
+	//! Address of the first pixel of the next block.
+	uint32_t                src;
+	//! Number of pixels left after the current block.
+	uint32_t                remaining;
+};
+
+static struct hx_dma hx_dma;
+
+/**
+ * \internal
+ * \brief Start moving the next block of pixels
+ *
+ * \pre Interrupts are masked.
+ */
+static void hx_dma_start_block(void)
+{
+	uint32_t        ctl;
+	uint32_t        count;
+
+	count = min_u(hx_dma.remaining, DMACA_MAX_BLOCK_TS);
+
+	ctl = DMACA_BIT(CTL_INT_EN)
+		| DMACA_BF(CTL_DST_TR_WIDTH, DMACA_TR_WIDTH_16)
+		| DMACA_BF(CTL_SRC_TR_WIDTH, DMACA_TR_WIDTH_16)
+		| DMACA_BF(CTL_DINC, DMACA_INC_NO_CHANGE)
+		| DMACA_BF(CTL_DST_MSIZE, DMACA_MSIZE_4)
+		| DMACA_BF(CTL_SRC_MSIZE, DMACA_MSIZE_4)
+		| DMACA_BF(CTL_TT_FC, DMACA_TT_FC_MEM2MEM_DMA);
+	if (hx_dma.fixed_src)
+		ctl |= DMACA_BF(CTL_SINC, DMACA_INC_NO_CHANGE);
+
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, SAR,
+			hx_dma.src);
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, DAR,
+			HX_REG_CMD);
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, LLP, 0);
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, CTL_LO,
+			ctl);
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, CTL_HI,
+			DMACA_BF(CTL_BLOCK_TS, count));
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, CFG_LO, 0);
+	dmaca_chan_write_reg(DMACA_BASE, CONFIG_GFX_HX8347A_DMA_CH, CFG_HI, 0);
+
+	if (!hx_dma.fixed_src)
+		hx_dma.src += count * sizeof(uint16_t);
+	hx_dma.remaining -= count;
+
+	dmaca_write_reg(DMACA_BASE, CH_EN,
+			DMACA_BF(CH, HX_DMA_CH_MASK)
+			| DMACA_BF(CH_WE, HX_DMA_CH_MASK));
+}
+
+/**
+ * \internal
+ * \brief Handle the end of a block
+ *
+ * This starts the next block, or schedules the tasks waiting for the
+ * channel if all pixels have been sent.
+ *
+ * \pre Interrupts are masked.
+ */
+static void hx_dma_block_done(void)
+{
+	struct workqueue_task   *task;
+
+	dmaca_write_reg(DMACA_BASE, CLEAR_TFR, HX_DMA_CH_MASK);
+
+	if (hx_dma.remaining) {
+		hx_dma_start_block();
+		return;
+	}
+
+	hx_dma.busy = false;
+#ifdef CONFIG_SLEEPMGR
+	sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
+	while ((task = workqueue_pop_task(&hx_dma.waiters)))
+		workqueue_add_task(&main_workqueue, task);
+}
+
+static void hx_dma_interrupt(void *data)
+{
+	irqflags_t      iflags;
+
+	// hx_dma_wait() may have handled the block already.
+	iflags = cpu_irq_save();
+	if (hx_dma.busy && (dmaca_read_reg(DMACA_BASE, STATUS_TFR)
+				& HX_DMA_CH_MASK))
+		hx_dma_block_done();
+	cpu_irq_restore(iflags);
+}
+INTC_DEFINE_HANDLER(DMACA_IRQ, hx_dma_interrupt,
+		CONFIG_GFX_HX8347A_DMA_INTLVL);
+
+/**
+ * \internal
+ * \brief Wait until all pixels have been sent
+ */
+static void hx_dma_wait(void)
+{
+	irqflags_t      iflags;
+
+	while (hx_dma.busy) {
+		iflags = cpu_irq_save();
+		if (hx_dma.busy && (dmaca_read_reg(DMACA_BASE, RAW_TFR)
+					& HX_DMA_CH_MASK))
+			hx_dma_block_done();
+		cpu_irq_restore(iflags);
+	}
+}
+
+/**
+ * \internal
+ * \brief Start sending \a count pixels from \a src to the display
+ *
+ * \pre The channel is idle.
+ */
+static void hx_dma_start(const void *src, uint32_t count, bool fixed_src)
+{
+	irqflags_t      iflags;
+
+	assert(!hx_dma.busy);
+
+	hx_dma.src = (uint32_t)src;
+	hx_dma.remaining = count;
+	hx_dma.fixed_src = fixed_src;
+	hx_dma.busy = true;
+#ifdef CONFIG_SLEEPMGR
+	// The DMACA is on the HSB, which is stopped in the Frozen mode.
+	sleepmgr_lock_mode(SLEEPMGR_IDLE);
+#endif
+
+	iflags = cpu_irq_save();
+	hx_dma_start_block();
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \internal
+ * \brief Return the bounce buffer which is not used by the channel
+ */
+static uint16_t *hx_dma_get_bounce(void)
+{
+	uint16_t        *buf;
+
+	buf = hx_dma.bounce[hx_dma.next_bounce];
+	hx_dma.next_bounce ^= 1;
+
+	return buf;
+}
+
+static void hx_dma_fill(gfx_color_t color, uint32_t count)
+{
+	// The previous fill is done, since the index register was written.
+	*hx_dma.fill_color = cpu_to_le16(color);
+	hx_dma_start(hx_dma.fill_color, count, true);
+}
+
+static void hx_dma_copy(const gfx_color_t *pixels, uint32_t count)
+{
+	uint16_t        *buf;
+	uint16_t        nr_pixels;
+	uint16_t        i;
+
+	while (count) {
+		nr_pixels = min_u(count, CONFIG_GFX_HX8347A_DMA_BUF_PIXELS);
+		buf = hx_dma_get_bounce();
+		for (i = 0; i < nr_pixels; i++)
+			buf[i] = cpu_to_le16(pixels[i]);
+
+		hx_dma_wait();
+		hx_dma_start(buf, nr_pixels, false);
+
+		pixels += nr_pixels;
+		count -= nr_pixels;
+	}
+}
+
+static void hx_dma_copy_hugemem(hugemem_ptr_t pixels, uint32_t count)
+{
+	uint16_t        *buf;
+	uint16_t        nr_pixels;
+	uint16_t        i;
+
+	while (count) {
+		nr_pixels = min_u(count, CONFIG_GFX_HX8347A_DMA_BUF_PIXELS);
+		buf = hx_dma_get_bounce();
+		for (i = 0; i < nr_pixels; i++) {
+			buf[i] = cpu_to_le16(hugemem_read16(pixels));
+			pixels = (hugemem_ptr_t)((uintptr_t)pixels
+					+ sizeof(gfx_color_t));
+		}
+
+		hx_dma_wait();
+		hx_dma_start(buf, nr_pixels, false);
+
+		count -= nr_pixels;
+	}
+}
+
+static void hx_dma_init(void)
+{
+	phys_addr_t     addr;
+
+	// The fill color is followed by the two bounce buffers.
+	addr = physmem_alloc(&dma_sram_pool, sizeof(uint32_t)
+			+ 2 * CONFIG_GFX_HX8347A_DMA_BUF_PIXELS
+			* sizeof(uint16_t), 2);
+	assert(addr != PHYSMEM_ALLOC_ERR);
+
+	hx_dma.fill_color = (uint16_t *)addr;
+	hx_dma.bounce[0] = (uint16_t *)(addr + sizeof(uint32_t));
+	hx_dma.bounce[1] = hx_dma.bounce[0]
+		+ CONFIG_GFX_HX8347A_DMA_BUF_PIXELS;
+	workqueue_init(&hx_dma.waiters);
+
+	sysclk_enable_hsb_module(SYSCLK_DMACA);
+	dmaca_write_reg(DMACA_BASE, DMA_CFG, DMACA_BIT(DMA_CFG_DMA_EN));
+	dmaca_write_reg(DMACA_BASE, CLEAR_TFR, HX_DMA_CH_MASK);
+	dmaca_write_reg(DMACA_BASE, MASK_TFR,
+			DMACA_BF(CH, HX_DMA_CH_MASK)
+			| DMACA_BF(CH_WE, HX_DMA_CH_MASK));
+	intc_setup_handler(DMACA_IRQ, CONFIG_GFX_HX8347A_DMA_INTLVL, NULL);
+}
+
+/**
+ * \brief Schedule a task when all pixels have been sent to the display
+ *
+ * Fills and copies to the display may return before the pixels have been
+ * sent. This adds \a task to the main workqueue when they have, without
+ * waiting like gfx_sync() does.
+ *
+ * \param task Task to schedule.
+ */
+void gfx_sync_async(struct workqueue_task *task)
+{
+	irqflags_t      iflags;
+
+	iflags = cpu_irq_save();
+	if (hx_dma.busy)
+		workqueue_add_task(&hx_dma.waiters, task);
+	else
+		workqueue_add_task(&main_workqueue, task);
+	cpu_irq_restore(iflags);
+}
+
+#endif /* DRIVERS_GFX_HX8347A_HX8347A_DMACA_H_INCLUDED */
@@ -46,8 +46,23 @@
 #define HX_REG_INDEX    (GFX_HX8347A_BASE + 0)
 #define HX_REG_CMD      (GFX_HX8347A_BASE + (1 << GFX_HX8347A_DNC_BIT))
 
+#ifdef CONFIG_GFX_HX8347A_DMA
+# include "hx8347a_dmaca.h"
+#endif
+
+#ifdef CONFIG_GFX_FRAME
+# include <gpio.h>
+# include <intc.h>
+# include <chip/irq-map.h>
+# include <gfx/frame.h>
+#endif
+
 static void hx_write_index(uint8_t address)
 {
+#ifdef CONFIG_GFX_HX8347A_DMA
+	// Pixels may still be on their way to the display.
+	hx_dma_wait();
+#endif
 	mmio_write8((void *)HX_REG_INDEX, address);
 }
 
@@ -87,6 +102,9 @@ static uint8_t gfx_read_register(uint8_t address)
 static void gfx_init_comms(void)
 {
 	ebi_enable_clock();
+#ifdef CONFIG_GFX_HX8347A_DMA
+	hx_dma_init();
+#endif
 }
 
 static void gfx_setup_interface(void)
@@ -127,6 +145,12 @@ void gfx_duplicate_pixel(gfx_color_t color, uint32_t count)
 	assert(count > 0);
 
 	hx_write_index(HX8347A_SRAMWRITE);
+#ifdef CONFIG_GFX_HX8347A_DMA
+	if (count >= CONFIG_GFX_HX8347A_DMA_THRESHOLD) {
+		hx_dma_fill(color, count);
+		return;
+	}
+#endif
 	while (count-- > 0)
 		hx_write_cmd16(color);
 }
@@ -137,6 +161,12 @@ void gfx_copy_pixels_to_screen(const gfx_color_t *pixels, uint32_t count)
 	assert(count > 0);
 
 	hx_write_index(HX8347A_SRAMWRITE);
+#ifdef CONFIG_GFX_HX8347A_DMA
+	if (count >= CONFIG_GFX_HX8347A_DMA_THRESHOLD) {
+		hx_dma_copy(pixels, count);
+		return;
+	}
+#endif
 	while (count-- > 0)
 		hx_write_cmd16(*pixels++);
 }
@@ -150,14 +180,24 @@ void gfx_copy_progmem_pixels_to_screen(const gfx_color_t *pixels,
 void gfx_copy_hugemem_pixels_to_screen(const hugemem_ptr_t pixels,
 		uint32_t count)
 {
+	hugemem_ptr_t pixel_ptr = pixels;
+
 	assert(pixels);
 	assert(count);
 
 	hx_write_index(HX8347A_SRAMWRITE);
+#ifdef CONFIG_GFX_HX8347A_DMA
+	if (count >= CONFIG_GFX_HX8347A_DMA_THRESHOLD) {
+		hx_dma_copy_hugemem(pixels, count);
+		return;
+	}
+#endif
 
 	while(count--) {
-		uint16_t pixel = hugemem_read16(pixels);
+		uint16_t pixel = hugemem_read16(pixel_ptr);
 		hx_write_cmd16(pixel);
+		pixel_ptr = (hugemem_ptr_t)((uintptr_t)pixel_ptr
+				+ sizeof(gfx_color_t));
 	}
 }
 
@@ -182,4 +222,50 @@ void gfx_copy_pixels_from_screen(gfx_color_t *pixels, uint32_t count)
 	}
 }
 
+#ifdef CONFIG_GFX_FRAME
+# ifndef CONFIG_GFX_FRAME_INTLVL
+#  define CONFIG_GFX_FRAME_INTLVL       0
+# endif
+
+/*
+ * The TE pin is set up to sense rising edges through the glitch filter.
+ * All GPIO interrupts share one group, so this driver owns the GPIO
+ * interrupt handler when the frame scheduler is enabled.
+ */
+static void gfx_te_interrupt(void *data)
+{
+	gpio_write_reg(gpio_pin_to_port(GFX_TE_PIN), IFRC,
+			gpio_pin_to_mask(GFX_TE_PIN));
+	gfx_frame_priv_vsync();
+}
+INTC_DEFINE_HANDLER(GPIO_IRQ, gfx_te_interrupt, CONFIG_GFX_FRAME_INTLVL);
+
+//! \internal Prepare the TE pin for interrupts, leaving them disabled.
+static void gfx_init_te(void)
+{
+	void            *port = gpio_pin_to_port(GFX_TE_PIN);
+	pin_mask_t      mask = gpio_pin_to_mask(GFX_TE_PIN);
+
+	gpio_write_reg(port, IMR0S, mask);
+	gpio_write_reg(port, IMR1C, mask);
+	gpio_write_reg(port, GFERS, mask);
+	intc_setup_handler(GPIO_IRQ, CONFIG_GFX_FRAME_INTLVL, NULL);
+}
+
+void gfx_frame_priv_enable_vsync(void)
+{
+	void            *port = gpio_pin_to_port(GFX_TE_PIN);
+	pin_mask_t      mask = gpio_pin_to_mask(GFX_TE_PIN);
+
+	gpio_write_reg(port, IFRC, mask);
+	gpio_write_reg(port, IERS, mask);
+}
+
+void gfx_frame_priv_disable_vsync(void)
+{
+	gpio_write_reg(gpio_pin_to_port(GFX_TE_PIN), IERC,
+			gpio_pin_to_mask(GFX_TE_PIN));
+}
+#endif /* CONFIG_GFX_FRAME */
+
 #endif /* DRIVERS_GFX_HX8347A_HX8347A_EBI_H_INCLUDED */
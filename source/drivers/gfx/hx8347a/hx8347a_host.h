@@ -0,0 +1,159 @@
+/**
+ * \file
+ *
+ * \brief HX8347A driver backend for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef DRIVERS_GFX_HX8347A_HX8347A_HOST_H_INCLUDED
+#define DRIVERS_GFX_HX8347A_HX8347A_HOST_H_INCLUDED
+
+#include <board/hx8347a.h>
+#include <hugemem.h>
+
+#include "hx8347a_sim.h"
+
+#ifdef CONFIG_GFX_FRAME
+# include <gfx/frame.h>
+#endif
+
+static void gfx_write_register(uint8_t address, uint8_t value)
+{
+	hx8347a_sim_write_index(address);
+	hx8347a_sim_write_data(value);
+}
+
+static uint8_t gfx_read_register(uint8_t address)
+{
+	hx8347a_sim_write_index(address);
+	return hx8347a_sim_read_data();
+}
+
+static void gfx_init_comms(void)
+{
+	hx8347a_sim_init();
+}
+
+static void gfx_setup_interface(void)
+{
+	gpio_set_value(GFX_BACKLIGHT_PIN, true);
+	gpio_set_value(GFX_RESET_PIN, true);
+}
+
+static gfx_color_t gfx_read_gram(void)
+{
+	hx8347a_sim_write_index(HX8347A_SRAMWRITE);
+	return hx8347a_sim_read_pixel();
+}
+
+static void gfx_write_gram(gfx_color_t color)
+{
+	hx8347a_sim_write_index(HX8347A_SRAMWRITE);
+	hx8347a_sim_write_pixel(color);
+}
+
+void gfx_duplicate_pixel(gfx_color_t color, uint32_t count)
+{
+	// Count should not exceed 24 bit, and not be zero.
+	assert((count >> 24) == 0);
+	assert(count > 0);
+
+	hx8347a_sim_write_index(HX8347A_SRAMWRITE);
+	while (count-- > 0)
+		hx8347a_sim_write_pixel(color);
+}
+
+void gfx_copy_pixels_to_screen(const gfx_color_t *pixels, uint32_t count)
+{
+	assert(pixels);
+	assert(count > 0);
+
+	hx8347a_sim_write_index(HX8347A_SRAMWRITE);
+	while (count-- > 0)
+		hx8347a_sim_write_pixel(*pixels++);
+}
+
+void gfx_copy_progmem_pixels_to_screen(const gfx_color_t __progmem_arg *pixels,
+		uint32_t count)
+{
+	gfx_copy_pixels_to_screen(pixels, count);
+}
+
+void gfx_copy_hugemem_pixels_to_screen(const hugemem_ptr_t pixels,
+		uint32_t count)
+{
+	hugemem_ptr_t   pixel_ptr = pixels;
+
+	assert(pixels);
+	assert(count > 0);
+
+	hx8347a_sim_write_index(HX8347A_SRAMWRITE);
+	while (count-- > 0) {
+		hx8347a_sim_write_pixel(hugemem_read16(pixel_ptr));
+		pixel_ptr = (hugemem_ptr_t)((uintptr_t)pixel_ptr
+				+ sizeof(gfx_color_t));
+	}
+}
+
+void gfx_copy_pixels_from_screen(gfx_color_t *pixels, uint32_t count)
+{
+	assert(pixels);
+	assert(count > 0);
+
+	hx8347a_sim_write_index(HX8347A_SRAMWRITE);
+	while (count-- > 0)
+		*pixels++ = hx8347a_sim_read_pixel();
+}
+
+uint32_t gfx_hx8347a_get_bus_transfers(void)
+{
+	return hx8347a_sim_get_transfers();
+}
+
+#ifdef CONFIG_GFX_FRAME
+static void gfx_init_te(void)
+{
+}
+
+void gfx_frame_priv_enable_vsync(void)
+{
+	hx8347a_sim_set_te_handler(gfx_frame_priv_vsync);
+}
+
+void gfx_frame_priv_disable_vsync(void)
+{
+	hx8347a_sim_set_te_handler(NULL);
+}
+#endif /* CONFIG_GFX_FRAME */
+
+#endif /* DRIVERS_GFX_HX8347A_HX8347A_HOST_H_INCLUDED */
@@ -0,0 +1,300 @@
+/**
+ * \file
+ *
+ * \brief Simulated HX8347A display controller for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <gfx/gfx.h>
+#include <board/hx8347a.h>
+#include <arch/host_clock.h>
+
+#include "hx8347a_regs.h"
+#include "hx8347a_sim.h"
+
+/**
+ * \ingroup gfx_hx8347a_sim
+ * @{
+ */
+
+//! Width of the panel in native orientation.
+#define HX_SIM_PANEL_WIDTH      240
+//! Height of the panel in native orientation.
+#define HX_SIM_PANEL_HEIGHT     320
+//! Time between TE pulses, for a refresh rate of 60 Hz.
+#define HX_SIM_FRAME_US         16667
+
+//! State of the simulated controller.
+struct hx8347a_sim {
+	//! Register file.
+	uint8_t         regs[256];
+	//! Register selected by the last index write.
+	uint8_t         index;
+	//! Column of the address counter, in window coordinates.
+	uint16_t        col;
+	//! Row of the address counter, in window coordinates.
+	uint16_t        row;
+	//! Number of index, register data and pixel transfers.
+	uint32_t        transfers;
+	//! Panel contents, in the byte order of #gfx_color_t.
+	gfx_color_t     gram[HX_SIM_PANEL_WIDTH * HX_SIM_PANEL_HEIGHT];
+};
+
+static struct hx8347a_sim hx_sim;
+
+//! Function called on each TE pulse, or NULL if TE is not watched.
+static void (*hx_sim_te_handler)(void);
+//! Event for the next TE pulse.
+static struct host_event hx_sim_te_event;
+
+static uint16_t hx_sim_reg16(uint8_t high)
+{
+	return (hx_sim.regs[high] << 8) | hx_sim.regs[high + 1];
+}
+
+/**
+ * \internal
+ * \brief Map a window coordinate to an offset in the GRAM
+ *
+ * \param flags Memory access control flags to apply.
+ * \param col Column in window coordinates.
+ * \param row Row in window coordinates.
+ *
+ * \return Offset into the GRAM, or -1 if the pixel is outside the panel.
+ */
+static long hx_sim_gram_offset(uint8_t flags, uint16_t col, uint16_t row)
+{
+	uint16_t x = col;
+	uint16_t y = row;
+
+	if (flags & GFX_HX_SWITCH_XY) {
+		x = row;
+		y = col;
+	}
+
+	if (x >= HX_SIM_PANEL_WIDTH || y >= HX_SIM_PANEL_HEIGHT)
+		return -1;
+
+	if (flags & GFX_HX_FLIP_X)
+		x = HX_SIM_PANEL_WIDTH - 1 - x;
+	if (flags & GFX_HX_FLIP_Y)
+		y = HX_SIM_PANEL_HEIGHT - 1 - y;
+
+	return (long)y * HX_SIM_PANEL_WIDTH + x;
+}
+
+static long hx_sim_current_offset(void)
+{
+	return hx_sim_gram_offset(hx_sim.regs[HX8347A_MEMACCESSCTRL],
+			hx_sim.col, hx_sim.row);
+}
+
+//! \internal Advance the address counter, wrapping inside the window.
+static void hx_sim_advance(void)
+{
+	if (hx_sim.col++ < hx_sim_reg16(HX8347A_COLENDHIGH))
+		return;
+
+	hx_sim.col = hx_sim_reg16(HX8347A_COLSTARTHIGH);
+	if (hx_sim.row++ < hx_sim_reg16(HX8347A_ROWENDHIGH))
+		return;
+
+	hx_sim.row = hx_sim_reg16(HX8347A_ROWSTARTHIGH);
+}
+
+/**
+ * \internal
+ * \brief Write the panel to the file named by \c HOST_GFX_DUMP
+ *
+ * The image is written as it would be seen with the default orientation of
+ * the board, so that it matches what the application draws.
+ */
+static void hx_sim_dump(void)
+{
+	const char      *path = getenv("HOST_GFX_DUMP");
+	uint8_t         flags = 0;
+	uint16_t        width = HX_SIM_PANEL_WIDTH;
+	uint16_t        height = HX_SIM_PANEL_HEIGHT;
+	uint16_t        x;
+	uint16_t        y;
+	FILE            *file;
+
+	if (!path)
+		return;
+
+	file = fopen(path, "wb");
+	if (!file) {
+		perror(path);
+		return;
+	}
+
+	flags |= (GFX_DEFAULT_ORIENTATION & GFX_FLIP_X) ? GFX_HX_FLIP_X : 0;
+	flags |= (GFX_DEFAULT_ORIENTATION & GFX_FLIP_Y) ? GFX_HX_FLIP_Y : 0;
+	if (GFX_DEFAULT_ORIENTATION & GFX_SWITCH_XY) {
+		flags |= GFX_HX_SWITCH_XY;
+		width = HX_SIM_PANEL_HEIGHT;
+		height = HX_SIM_PANEL_WIDTH;
+	}
+
+	fprintf(file, "P6\n%u %u\n255\n", width, height);
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < width; x++) {
+			gfx_color_t     color;
+			uint16_t        rgb;
+
+			color = hx_sim.gram[hx_sim_gram_offset(flags, x, y)];
+			// GRAM data is big endian, see gfx_color().
+			rgb = (color >> 8) | (color << 8);
+
+			putc(((rgb >> 11) & 0x1f) << 3, file);
+			putc(((rgb >> 5) & 0x3f) << 2, file);
+			putc((rgb & 0x1f) << 3, file);
+		}
+	}
+
+	fclose(file);
+}
+
+void hx8347a_sim_init(void)
+{
+	static bool     registered;
+
+	if (!registered) {
+		atexit(hx_sim_dump);
+		registered = true;
+	}
+}
+
+void hx8347a_sim_write_index(uint8_t address)
+{
+	hx_sim.transfers++;
+	hx_sim.index = address;
+
+	// Accessing GRAM restarts at the top left corner of the window.
+	if (address == HX8347A_SRAMWRITE) {
+		hx_sim.col = hx_sim_reg16(HX8347A_COLSTARTHIGH);
+		hx_sim.row = hx_sim_reg16(HX8347A_ROWSTARTHIGH);
+	}
+}
+
+void hx8347a_sim_write_data(uint8_t value)
+{
+	assert(hx_sim.index != HX8347A_SRAMWRITE);
+
+	hx_sim.transfers++;
+	hx_sim.regs[hx_sim.index] = value;
+}
+
+uint8_t hx8347a_sim_read_data(void)
+{
+	assert(hx_sim.index != HX8347A_SRAMWRITE);
+
+	hx_sim.transfers++;
+	return hx_sim.regs[hx_sim.index];
+}
+
+void hx8347a_sim_write_pixel(uint16_t color)
+{
+	long    offset;
+
+	assert(hx_sim.index == HX8347A_SRAMWRITE);
+
+	hx_sim.transfers++;
+	offset = hx_sim_current_offset();
+	if (offset >= 0)
+		hx_sim.gram[offset] = color;
+	hx_sim_advance();
+}
+
+uint16_t hx8347a_sim_read_pixel(void)
+{
+	long            offset;
+	gfx_color_t     color = 0;
+
+	assert(hx_sim.index == HX8347A_SRAMWRITE);
+
+	hx_sim.transfers++;
+	offset = hx_sim_current_offset();
+	if (offset >= 0)
+		color = hx_sim.gram[offset];
+	hx_sim_advance();
+
+	return color;
+}
+
+uint32_t hx8347a_sim_get_transfers(void)
+{
+	return hx_sim.transfers;
+}
+
+/**
+ * \internal
+ * \brief Signal a TE pulse and schedule the next one
+ *
+ * The controller only drives the TE output if TEON is set, but the
+ * refresh goes on regardless.
+ */
+static void hx_sim_te_pulse(struct host_event *event)
+{
+	host_event_schedule(event, HX_SIM_FRAME_US);
+
+	if (hx_sim.regs[HX8347A_INTERNAL28] & (1 << HX8347A_TEON))
+		hx_sim_te_handler();
+}
+
+/**
+ * \brief Watch the TE output of the controller
+ *
+ * \param handler Function to call on each TE pulse, with interrupts
+ * disabled, or NULL to stop watching.
+ */
+void hx8347a_sim_set_te_handler(void (*handler)(void))
+{
+	hx_sim_te_handler = handler;
+
+	/* Only keep the refresh running while someone is watching. Otherwise,
+	 * the pending event would keep the application from ever exiting.
+	 */
+	if (handler) {
+		host_event_init(&hx_sim_te_event, hx_sim_te_pulse);
+		host_event_schedule(&hx_sim_te_event, HX_SIM_FRAME_US);
+	} else {
+		host_event_cancel(&hx_sim_te_event);
+	}
+}
+
+//! @}
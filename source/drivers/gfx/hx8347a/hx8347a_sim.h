@@ -0,0 +1,79 @@
+/**
+ * \file
+ *
+ * \brief Simulated HX8347A display controller for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef DRIVERS_GFX_HX8347A_HX8347A_SIM_H_INCLUDED
+#define DRIVERS_GFX_HX8347A_HX8347A_SIM_H_INCLUDED
+
+#include <stdint.h>
+
+/**
+ * \internal
+ * \defgroup gfx_hx8347a_sim Simulated HX8347A controller
+ *
+ * The host backend talks to a software model of the HX8347A instead of a
+ * bus. The model keeps the register file and the GRAM of the controller,
+ * and implements the column/row window and address counter so that the
+ * generic driver code runs unmodified.
+ *
+ * If the environment variable \c HOST_GFX_DUMP is set, the contents of the
+ * panel are written to that path as a binary PPM image when the program
+ * exits.
+ *
+ * The TE output of the controller is modelled as a pulse every 1/60 second
+ * on the virtual clock. Pulses only happen while a handler is registered
+ * with hx8347a_sim_set_te_handler().
+ *
+ * Each access on the bus, i.e. each index write, register data read or
+ * write and pixel read or write, is counted. The count, returned by
+ * hx8347a_sim_get_transfers(), is what the drawing code costs on the
+ * real bus, independent of the speed of the host.
+ *
+ * @{
+ */
+
+extern void hx8347a_sim_init(void);
+extern void hx8347a_sim_write_index(uint8_t address);
+extern void hx8347a_sim_write_data(uint8_t value);
+extern uint8_t hx8347a_sim_read_data(void);
+extern void hx8347a_sim_write_pixel(uint16_t color);
+extern uint16_t hx8347a_sim_read_pixel(void);
+extern void hx8347a_sim_set_te_handler(void (*handler)(void));
+extern uint32_t hx8347a_sim_get_transfers(void);
+
+//! @}
+
+#endif /* DRIVERS_GFX_HX8347A_HX8347A_SIM_H_INCLUDED */
@@ -47,6 +47,12 @@
 
 #include <board/hx8347a.h>
 
+#ifdef CONFIG_GFX_FRAME
+# include <intc.h>
+# include <pmic.h>
+# include <gfx/frame.h>
+#endif
+
 #define gfx_select_chip()   (GFX_CS_PORT.OUTCLR = GFX_CS_PINMASK)
 #define gfx_deselect_chip() (GFX_CS_PORT.OUTSET = GFX_CS_PINMASK)
 
@@ -407,4 +413,41 @@ void gfx_copy_pixels_from_screen(gfx_color_t *pixels, uint32_t count)
 	gfx_deselect_chip();
 }
 
+#ifdef CONFIG_GFX_FRAME
+# ifndef CONFIG_GFX_FRAME_INTLVL
+#  define CONFIG_GFX_FRAME_INTLVL       PMIC_INTLVL_LOW
+# endif
+
+/*
+ * The TE pin is set up to sense rising edges, and interrupt 0 of its port
+ * is used to signal them. The interrupt flag is cleared by hardware when
+ * the handler runs.
+ */
+static void gfx_te_interrupt(void *data)
+{
+	gfx_frame_priv_vsync();
+}
+INTC_DEFINE_HANDLER(GFX_TE_IRQ, gfx_te_interrupt, CONFIG_GFX_FRAME_INTLVL);
+
+//! \internal Prepare the TE pin for interrupts, leaving them disabled.
+static void gfx_init_te(void)
+{
+	port_select_gpio_pin(GFX_TE_PIN, PORT_DIR_INPUT | PORT_RISING);
+	GFX_TE_PORT.INT0MASK = GFX_TE_PINMASK;
+	intc_setup_handler(GFX_TE_IRQ, CONFIG_GFX_FRAME_INTLVL, NULL);
+}
+
+void gfx_frame_priv_enable_vsync(void)
+{
+	GFX_TE_PORT.INTFLAGS = PORT_INT0IF_bm;
+	GFX_TE_PORT.INTCTRL = (GFX_TE_PORT.INTCTRL & ~PORT_INT0LVL_gm)
+			| (CONFIG_GFX_FRAME_INTLVL << PORT_INT0LVL_gp);
+}
+
+void gfx_frame_priv_disable_vsync(void)
+{
+	GFX_TE_PORT.INTCTRL &= ~PORT_INT0LVL_gm;
+}
+#endif /* CONFIG_GFX_FRAME */
+
 #endif /* DRIVERS_GFX_HX8347A_HX8347A_XMEGA_H_INCLUDED */
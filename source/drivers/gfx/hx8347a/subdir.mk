@@ -2,10 +2,15 @@ hdr-y                   += include/gfx/gfx_hx8347a.h
 hdr-y                   += include/gfx/gfx_generic.h
 
 hdr-$(CONFIG_EBI_PARAMS_HX8347A) += drivers/gfx/hx8347a/hx8347a_ebi.h
+hdr-$(CONFIG_GFX_HX8347A_DMA)    += drivers/gfx/hx8347a/hx8347a_dmaca.h
+hdr-$(CONFIG_GFX_HX8347A_DMA)    += include/regs/avr32_dmaca.h
 hdr-y                            += drivers/gfx/hx8347a/hx8347a_regs.h
 hdr-$(CONFIG_CPU_XMEGA)          += drivers/gfx/hx8347a/hx8347a_xmega.h
+hdr-$(CONFIG_CPU_HOST)           += drivers/gfx/hx8347a/hx8347a_host.h
+hdr-$(CONFIG_CPU_HOST)           += drivers/gfx/hx8347a/hx8347a_sim.h
 
 src-y                   += drivers/gfx/hx8347a/gfx_hx8347a.c
+src-$(CONFIG_CPU_HOST)  += drivers/gfx/hx8347a/hx8347a_sim.c
 src-y                   += drivers/gfx/gfx_generic.c
 src-y                   += drivers/gfx/gfx_text.c
 
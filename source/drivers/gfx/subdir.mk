@@ -4,7 +4,15 @@ include $(addsuffix /subdir.mk, $(gfx-subdir-y))
 
 src-y                   += drivers/gfx/gfx_bitmap.c
 src-y                   += drivers/gfx/gfx_gradient.c
+src-$(CONFIG_GFX_GLYPH_CACHE) += drivers/gfx/gfx_glyph_cache.c
+src-$(CONFIG_GFX_DLIST)       += drivers/gfx/gfx_dlist.c
+src-$(CONFIG_GFX_SPRITE)      += drivers/gfx/gfx_sprite.c
+src-$(CONFIG_GFX_FRAME)       += drivers/gfx/gfx_frame.c
 
 hdr-y                   += include/gfx/gfx.h
+hdr-$(CONFIG_GFX_GLYPH_CACHE) += include/gfx/glyph_cache.h
+hdr-$(CONFIG_GFX_DLIST)       += include/gfx/dlist.h
+hdr-$(CONFIG_GFX_SPRITE)      += include/gfx/sprite.h
+hdr-$(CONFIG_GFX_FRAME)       += include/gfx/frame.h
 
 mkfiles                 += $(src)/drivers/gfx/subdir.mk
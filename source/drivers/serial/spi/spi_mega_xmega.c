@@ -128,7 +128,9 @@ static void spi_poll(struct workqueue_task *task)
 	while (residue > 1) {
 		if (write_op)
 			tx_byte = *write;
-		while (i--) {
+		// Stop at 0, so running out of loops is seen below.
+		while (i) {
+			i--;
 			if (spi_priv_is_int_flag_set(spim)) {
 				rx_byte = spi_priv_read_data(spim);
 				spi_priv_write_data(spim, tx_byte);
@@ -169,12 +171,20 @@ yield:
 	spi_polled_sched_poll(spim);
 }
 
+#if defined(CONFIG_SPI_MASTER_INT) \
+	&& (defined(CONFIG_CPU_XMEGA) || defined(CONFIG_CPU_HOST))
+# define spi_priv_start		spi_priv_int_start
+#else
 static void spi_priv_start(struct spi_master *spim,
 		uint8_t tx_byte)
 {
 	spi_priv_write_data(spim, tx_byte);
+	spi_polled_sched_poll(spim);
 }
 
+# define spi_priv_int_master_init(spi_id, spim)	do { } while (0)
+#endif
+
 void spi_priv_master_setup_device(spi_id_t spi_id, struct spi_device *device,
 		spi_flags_t flags, unsigned long baud_rate,
 		board_spi_select_id_t sel_id)
@@ -201,6 +211,7 @@ void spi_priv_master_init(spi_id_t spi_id, struct spi_master *spim)
 {
 	spi_polled_master_init(spim, spi_poll, spi_priv_start);
 	spi_priv_master_init_regs(spi_id, spim);
+	spi_priv_int_master_init(spi_id, spim);
 }
 
 //! @}
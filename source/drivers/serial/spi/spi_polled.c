@@ -59,7 +59,6 @@ void spi_polled_start(struct spi_master *spim, uint8_t tx_byte, size_t residue)
 	spim->residue = residue;
 	spim->status = OPERATION_IN_PROGRESS;
 	spim_poll->start(spim, tx_byte);
-	spi_polled_sched_poll(spim);
 }
 
 /**
@@ -46,42 +46,70 @@
  */
 
 /**
- * \brief Iterate to next buffer in SPI buffer list operation
+ * \brief Load next buffer in SPI buffer list operation
  *
- * \param task Task struct
+ * Advances the read and write data pointers to the next buffer in the
+ * list(s) of the ongoing operation.
+ *
+ * \param spim    SPI master struct
+ * \param tx_byte Pointer to store first byte to send in
+ * \param len     Pointer to store length of the next buffer in
+ *
+ * \retval true  Next buffer was loaded
+ * \retval false The last buffer has been transferred
+ *
+ * \note This may be called from interrupt context.
  */
-void spi_polled_next_buffer(struct workqueue_task *task)
+bool spi_polled_load_next_buffer(struct spi_master *spim, uint8_t *tx_byte,
+		size_t *len)
 {
-	struct spi_master_polled *spim_poll =
-		container_of(task, struct spi_master_polled, poll_next_buffer);
-	struct spi_master        *spim = &spim_poll->base;
-	size_t                   len = 0;
-	uint8_t                  tx_byte = 0;
+	struct spi_master_polled *spim_poll = spi_master_polled_of(spim);
+
+	*tx_byte = 0;
+	*len = 0;
 
 	if (test_bit(SPI_OP_READ, &spim_poll->op)) {
 		if (slist_node_is_last(spim_poll->read_buf_list,
 					&spim_poll->read_buffer->node))
-			goto done;
+			return false;
 		spim_poll->read_buffer =
 			buf_list_peek_next(spim_poll->read_buffer);
 		spim_poll->read_data = spim_poll->read_buffer->addr.ptr;
-		len = spim_poll->read_buffer->len;
+		*len = spim_poll->read_buffer->len;
 	}
 	if (test_bit(SPI_OP_WRITE, &spim_poll->op)) {
 		if (slist_node_is_last(spim_poll->write_buf_list,
 					&spim_poll->write_buffer->node))
-			goto done;
+			return false;
 		spim_poll->write_buffer =
 			buf_list_peek_next(spim_poll->write_buffer);
-		tx_byte = *(uint8_t *)spim_poll->write_buffer->addr.ptr;
+		*tx_byte = *(uint8_t *)spim_poll->write_buffer->addr.ptr;
 		spim_poll->write_data =
 			(uint8_t *)spim_poll->write_buffer->addr.ptr + 1;
-		len = spim_poll->write_buffer->len;
+		*len = spim_poll->write_buffer->len;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Iterate to next buffer in SPI buffer list operation
+ *
+ * \param task Task struct
+ */
+void spi_polled_next_buffer(struct workqueue_task *task)
+{
+	struct spi_master_polled *spim_poll =
+		container_of(task, struct spi_master_polled, poll_next_buffer);
+	struct spi_master        *spim = &spim_poll->base;
+	size_t                   len;
+	uint8_t                  tx_byte;
+
+	if (spi_polled_load_next_buffer(spim, &tx_byte, &len)) {
+		spi_polled_start(spim, tx_byte, len);
+		return;
 	}
-	spi_polled_start(spim, tx_byte, len);
-	return;
 
-done:
 	spim->residue = 0;
 	spim->status = STATUS_OK;
 	workqueue_add_task(&main_workqueue, spim->nwq.current);
@@ -151,8 +179,8 @@ void spi_polled_exchange_buf_list(struct spi_master *spim,
 	spim_poll->read_data = read_buffer->addr.ptr;
 	spim_poll->write_buffer = write_buffer;
 	spim_poll->write_buf_list = write_buf_list;
-	spim_poll->read_buffer = write_buffer;
-	spim_poll->read_buf_list = write_buf_list;
+	spim_poll->read_buffer = read_buffer;
+	spim_poll->read_buf_list = read_buf_list;
 	spi_polled_start(spim, *write, write_buffer->len);
 }
 
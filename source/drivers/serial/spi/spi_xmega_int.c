@@ -0,0 +1,194 @@
+/**
+ * \file
+ *
+ * \brief Interrupt driven SPI master for ATxmega
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <bitops.h>
+#include <intc.h>
+#include <spi.h>
+#include <board/spi.h>
+
+#ifdef CONFIG_SLEEPMGR
+#include <sleepmgr.h>
+#endif
+
+/**
+ * \addtogroup spi_xmega_internal_group
+ * \section spi_xmega_int_section Interrupt driven transfers
+ *
+ * If CONFIG_SPI_MASTER_INT is set, transfers are driven by the SPI
+ * interrupt instead of the poll task. Each byte is handled directly in the
+ * interrupt handler, which also moves on to the next buffer of a buffer
+ * list operation, so the workqueue is only involved when the whole
+ * operation has completed. The interrupt level is given by
+ * CONFIG_SPI_MASTER_INTLVL, which defaults to PMIC_INTLVL_LOW.
+ *
+ * With CONFIG_SLEEPMGR, the CPU is kept from sleeping deeper than idle
+ * while a transfer is in progress, since the SPI module needs the
+ * peripheral clock.
+ *
+ * @{
+ */
+
+/**
+ * \internal
+ * \brief SPI interrupt handler
+ *
+ * Stores the received byte and sends the next one. When the last byte of a
+ * buffer has been received, the next buffer of a buffer list operation is
+ * started, or the interrupt is disabled and the task which issued the
+ * operation is scheduled.
+ *
+ * \param int_data SPI master struct
+ */
+static void spi_priv_int_handler(void *int_data)
+{
+	struct spi_master        *spim = int_data;
+	struct spi_master_polled *spim_poll = spi_master_polled_of(spim);
+	uint8_t                  rx_byte;
+	uint8_t                  tx_byte;
+#ifdef CONFIG_SPI_BUF_LIST_API
+	size_t                   len;
+#endif
+
+	// The interrupt flag is cleared when the vector is executed.
+	rx_byte = spi_priv_read_data(spim);
+
+	if (spim->residue > 1) {
+		// Keep the bus busy before storing the received byte.
+		tx_byte = 0;
+		if (test_bit(SPI_OP_WRITE, &spim_poll->op))
+			tx_byte = *spim_poll->write_data++;
+		spi_priv_write_data(spim, tx_byte);
+	}
+
+	if (test_bit(SPI_OP_READ, &spim_poll->op))
+		*spim_poll->read_data++ = rx_byte;
+
+	if (--spim->residue)
+		return;
+
+#ifdef CONFIG_SPI_BUF_LIST_API
+	if (spi_polled_is_buffer_op(spim)
+			&& spi_polled_load_next_buffer(spim, &tx_byte, &len)) {
+		spim->residue = len;
+		spi_priv_write_data(spim, tx_byte);
+		return;
+	}
+#endif
+
+	spi_priv_disable_int(spim);
+#ifdef CONFIG_SLEEPMGR
+	sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
+	spim->status = STATUS_OK;
+	workqueue_add_task(&main_workqueue, spim->nwq.current);
+}
+
+#ifdef CONFIG_SPI0
+INTC_DEFINE_HANDLER(PMIC_SPI0_IRQ, spi_priv_int_handler,
+		CONFIG_SPI_MASTER_INTLVL);
+#endif
+#ifdef CONFIG_SPI1
+INTC_DEFINE_HANDLER(PMIC_SPI1_IRQ, spi_priv_int_handler,
+		CONFIG_SPI_MASTER_INTLVL);
+#endif
+#ifdef CONFIG_SPI2
+INTC_DEFINE_HANDLER(PMIC_SPI2_IRQ, spi_priv_int_handler,
+		CONFIG_SPI_MASTER_INTLVL);
+#endif
+#ifdef CONFIG_SPI3
+INTC_DEFINE_HANDLER(PMIC_SPI3_IRQ, spi_priv_int_handler,
+		CONFIG_SPI_MASTER_INTLVL);
+#endif
+
+/**
+ * \internal
+ * \brief Start interrupt driven SPI transfer
+ *
+ * \param spim    SPI master struct
+ * \param tx_byte First byte to send
+ */
+void spi_priv_int_start(struct spi_master *spim, uint8_t tx_byte)
+{
+#ifdef CONFIG_SLEEPMGR
+	sleepmgr_lock_mode(SLEEPMGR_IDLE);
+#endif
+	spi_priv_write_data(spim, tx_byte);
+	spi_priv_enable_int(spim);
+}
+
+/**
+ * \internal
+ * \brief Connect SPI interrupt to SPI master
+ *
+ * \param spi_id \ref spi_module_id
+ * \param spim   SPI master struct
+ */
+void spi_priv_int_master_init(spi_id_t spi_id, struct spi_master *spim)
+{
+	switch (spi_id) {
+#ifdef CONFIG_SPI0
+	case 0:
+		intc_setup_handler(PMIC_SPI0_IRQ, CONFIG_SPI_MASTER_INTLVL,
+				spim);
+		break;
+#endif
+#ifdef CONFIG_SPI1
+	case 1:
+		intc_setup_handler(PMIC_SPI1_IRQ, CONFIG_SPI_MASTER_INTLVL,
+				spim);
+		break;
+#endif
+#ifdef CONFIG_SPI2
+	case 2:
+		intc_setup_handler(PMIC_SPI2_IRQ, CONFIG_SPI_MASTER_INTLVL,
+				spim);
+		break;
+#endif
+#ifdef CONFIG_SPI3
+	case 3:
+		intc_setup_handler(PMIC_SPI3_IRQ, CONFIG_SPI_MASTER_INTLVL,
+				spim);
+		break;
+#endif
+	default:
+		unhandled_case(spi_id);
+		break;
+	}
+}
+
+//! @}
@@ -10,6 +10,12 @@ src-mega-xmega-y			+= drivers/serial/spi/spi_mega_xmega.c
 
 src-$(CONFIG_CPU_MEGA)			+= $(src-mega-xmega-y)
 src-$(CONFIG_CPU_XMEGA)			+= $(src-mega-xmega-y)
+src-xmega-int-$(CONFIG_SPI_MASTER_INT)	+= drivers/serial/spi/spi_xmega_int.c
+src-$(CONFIG_CPU_XMEGA)			+= $(src-xmega-int-y)
+
+# The host simulates an ATxmega SPI module
+src-$(CONFIG_CPU_HOST)			+= $(src-mega-xmega-y)
+src-$(CONFIG_CPU_HOST)			+= $(src-xmega-int-y)
 
 hdr-mega-xmega-y			+= $(hdr-polled-y)
 hdr-mega-xmega-$(CONFIG_CPU_MEGA)	+= include/spi/spi_mega.h
@@ -19,5 +25,11 @@ hdr-mega-xmega-y			+= include/spi/spi_mega_xmega.h
 
 hdr-$(CONFIG_CPU_MEGA)			+= $(hdr-mega-xmega-y)
 hdr-$(CONFIG_CPU_XMEGA)			+= $(hdr-mega-xmega-y)
+hdr-$(CONFIG_CPU_HOST)			+= $(hdr-polled-y)
+hdr-$(CONFIG_CPU_HOST)			+= include/spi/spi_xmega.h
+hdr-$(CONFIG_CPU_HOST)			+= include/regs/xmega_spi.h
+hdr-$(CONFIG_CPU_HOST)			+= include/spi/spi_mega_xmega.h
+hdr-$(CONFIG_CPU_HOST)			+= include/pmic.h
+hdr-$(CONFIG_CPU_HOST)			+= include/pmic_regs.h
 
 mkfiles					+= $(src)/drivers/serial/spi/subdir.mk
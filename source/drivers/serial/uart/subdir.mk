@@ -6,6 +6,8 @@ hdr-$(CONFIG_ARCH_AVR32)	+= include/regs/avr32_usart.h
 hdr-$(CONFIG_CPU_XMEGA)		+= include/uart/uart_xmega.h
 hdr-$(CONFIG_CPU_XMEGA)		+= include/regs/xmega_usart.h
 hdr-$(CONFIG_CPU_MEGA)		+= include/uart/uart_mega.h
+src-$(CONFIG_ARCH_HOST)		+= drivers/serial/uart/uart_host.c
+hdr-$(CONFIG_ARCH_HOST)		+= include/uart/uart_host.h
 
 stream-src-y			:=
 stream-hdr-y			:=
@@ -23,6 +25,7 @@ ctrl-src-$(CONFIG_CPU_XMEGA)	+= drivers/serial/uart/uart_xmega_ctrl.c
 ctrl-hdr-$(CONFIG_CPU_XMEGA)	+= include/uart/ctrl_xmega.h
 ctrl-src-$(CONFIG_CPU_MEGA)	+= drivers/serial/uart/uart_mega_ctrl.c
 ctrl-hdr-$(CONFIG_CPU_MEGA)	+= include/uart/ctrl_mega.h
+ctrl-hdr-$(CONFIG_ARCH_HOST)	+= include/uart/ctrl_host.h
 
 cdc-hdr-y                       += include/uart/cdc.h
 cdc-hdr-$(CONFIG_ARCH_AVR32)    += include/uart/cdc_avr32.h
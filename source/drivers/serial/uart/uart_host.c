@@ -0,0 +1,98 @@
+/**
+ * \file
+ *
+ * \brief Simulated UART for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <uart.h>
+#include <arch/host_clock.h>
+
+/**
+ * \weakgroup uart_host_group
+ * @{
+ */
+
+void host_uart_enable(unsigned int uart_id, uart_flags_t flags)
+{
+	if (flags & UART_FLAG_TX)
+		setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+bool host_uart_put_byte(unsigned int uart_id, uint8_t data)
+{
+	putchar(data);
+
+	return true;
+}
+
+/**
+ * \brief Test if a byte can be read without blocking
+ */
+bool host_uart_rx_is_ready(unsigned int uart_id)
+{
+	struct pollfd	pfd = {
+		.fd	= STDIN_FILENO,
+		.events	= POLLIN,
+	};
+
+	return poll(&pfd, 1, 0) > 0;
+}
+
+/**
+ * \brief Read a byte from standard input
+ *
+ * If no byte is available and nothing is scheduled on the virtual
+ * clock, nothing else can happen until more input arrives, so this
+ * blocks instead of letting the caller spin.
+ */
+bool host_uart_get_byte(unsigned int uart_id, uint8_t *data)
+{
+	ssize_t		ret;
+
+	if (host_event_is_pending() && !host_uart_rx_is_ready(uart_id))
+		return false;
+
+	fflush(stdout);
+	ret = read(STDIN_FILENO, data, 1);
+	if (ret <= 0)
+		exit(EXIT_SUCCESS);
+
+	return true;
+}
+
+//! @}
@@ -0,0 +1,128 @@
+/**
+ * \file
+ *
+ * \brief Host sampling profiler backend
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#define _GNU_SOURCE
+#include <link.h>
+#include <signal.h>
+#include <string.h>
+#include <ucontext.h>
+#include <sys/time.h>
+#include <assert.h>
+#include <profile.h>
+
+/**
+ * \weakgroup profile_group
+ * @{
+ */
+
+//! Difference between run-time and link-time addresses of the program.
+static uintptr_t profile_host_load_bias;
+
+static int profile_host_find_bias(struct dl_phdr_info *info, size_t size,
+		void *data)
+{
+	// The first object is the program itself.
+	profile_host_load_bias = info->dlpi_addr;
+
+	return 1;
+}
+
+static void profile_host_sample(int sig, siginfo_t *info, void *context)
+{
+	ucontext_t      *uc = context;
+	uintptr_t       pc;
+
+#if defined(__x86_64__)
+	pc = uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+	pc = uc->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+	pc = uc->uc_mcontext.pc;
+#else
+# error Unable to find the program counter of an interrupted thread
+#endif
+
+	/*
+	 * Samples outside the program, e.g. in the C library, end up at
+	 * addresses which do not belong to any symbol.
+	 */
+	profile_priv_record((pc - profile_host_load_bias)
+			& PROFILE_SAMPLE_PC_MASK);
+}
+
+/**
+ * \internal
+ * \brief Start taking a sample each \a rate'th of a second of CPU time
+ *
+ * \return The actual number of samples per second.
+ */
+uint32_t profile_priv_timer_start(uint32_t rate)
+{
+	struct sigaction        sa;
+	struct itimerval        it;
+
+	dl_iterate_phdr(profile_host_find_bias, NULL);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = profile_host_sample;
+	sa.sa_flags = SA_SIGINFO | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGPROF, &sa, NULL);
+
+	memset(&it, 0, sizeof(it));
+	it.it_interval.tv_usec = 1000000 / rate;
+	if (!it.it_interval.tv_usec)
+		it.it_interval.tv_usec = 1;
+	it.it_value = it.it_interval;
+	setitimer(ITIMER_PROF, &it, NULL);
+
+	return 1000000 / it.it_interval.tv_usec;
+}
+
+/**
+ * \internal
+ * \brief Stop taking samples
+ */
+void profile_priv_timer_stop(void)
+{
+	struct itimerval        it;
+
+	memset(&it, 0, sizeof(it));
+	setitimer(ITIMER_PROF, &it, NULL);
+}
+
+//! @}
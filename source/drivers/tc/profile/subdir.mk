@@ -0,0 +1,5 @@
+src-$(CONFIG_CPU_XMEGA)		+= drivers/tc/profile/tc_profile_xmega.c
+src-$(CONFIG_CPU_XMEGA)		+= drivers/tc/profile/tc_profile_xmega_entry.S
+src-$(CONFIG_ARCH_HOST)		+= drivers/tc/profile/profile_host.c
+
+mkfiles				+= $(src)/drivers/tc/profile/subdir.mk
@@ -0,0 +1,118 @@
+/**
+ * \file
+ *
+ * \brief XMEGA Timer/Counter sampling profiler backend
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <pmic.h>
+#include <profile.h>
+#include <util.h>
+#include <chip/tc.h>
+#include <regs/xmega_tc.h>
+#include <tc/tc_xmega.h>
+
+/**
+ * \weakgroup profile_group
+ * @{
+ */
+
+/*
+ * The sampling interrupt handler in tc_profile_xmega_entry.S passes the
+ * PMIC status bits on as context flags.
+ */
+#if PROFILE_CTX_IRQ_LOW != PMIC_STATUS_LOLVLEX                          \
+		|| PROFILE_CTX_IRQ_MEDIUM != PMIC_STATUS_MEDLVLEX
+# error Profiler context flags do not match the PMIC status register
+#endif
+
+//! Registers of the sampling Timer/Counter.
+#define PROFILE_TC_REGS         tc_get_regs(CONFIG_PROFILE_TC_ID)
+
+/**
+ * \internal
+ * \brief Start the sampling interrupt
+ *
+ * The Timer/Counter runs in frequency mode, where it restarts from zero on
+ * each compare match on channel A. The slowest clock giving at least 256
+ * counts per sample is used, so that the rate is accurate within 0.4%.
+ *
+ * \param rate Requested number of samples per second.
+ *
+ * \return The actual number of samples per second.
+ */
+uint32_t profile_priv_timer_start(uint32_t rate)
+{
+	void            *regs = PROFILE_TC_REGS;
+	uint8_t         clksel;
+	uint32_t        clk;
+	uint32_t        period;
+
+	assert(rate <= tc_get_pclk_hz(CONFIG_PROFILE_TC_ID) / 256);
+
+	clksel = tc_select_clock(CONFIG_PROFILE_TC_ID, rate * 256);
+	clk = tc_get_resolution(CONFIG_PROFILE_TC_ID, clksel);
+	period = min_u(clk / rate, 0x10000);
+
+	tc_enable_pclk(CONFIG_PROFILE_TC_ID);
+	tc_write_reg8(regs, CTRLA, TC_CLKSEL_OFF);
+	tc_write_reg8(regs, CTRLFSET, TC_BF(CMD, TC_CMD_RESET));
+	tc_write_reg8(regs, CTRLB, TC_BF(CTRLB_WGMODE, TC_WGMODE_FRQ)
+			| TC_BIT(CTRLB_CCAEN));
+	tc_write_reg16(regs, CCA, period - 1);
+	tc_write_reg8(regs, INTCTRLB, TC_BF(INTCTRLB_CCAINTLVL,
+			PMIC_INTLVL_HIGH));
+	tc_write_reg8(regs, CTRLA, clksel);
+
+	return clk / period;
+}
+
+/**
+ * \internal
+ * \brief Stop the sampling interrupt
+ */
+void profile_priv_timer_stop(void)
+{
+	void            *regs = PROFILE_TC_REGS;
+
+	if (!tc_pclk_is_enabled(CONFIG_PROFILE_TC_ID))
+		return;
+
+	tc_write_reg8(regs, INTCTRLB, TC_BF(INTCTRLB_CCAINTLVL,
+			PMIC_INTLVL_OFF));
+	tc_write_reg8(regs, CTRLA, TC_CLKSEL_OFF);
+	tc_disable_pclk(CONFIG_PROFILE_TC_ID);
+}
+
+//! @}
@@ -1,7 +1,9 @@
 timer-subdir-$(CONFIG_TIMER)		+= $(src)/drivers/tc/timer
 timekeeper-subdir-$(CONFIG_TIMEKEEPER)	+= $(src)/drivers/tc/timekeeper
+profile-subdir-$(CONFIG_PROFILE)	+= $(src)/drivers/tc/profile
 
 include $(addsuffix /subdir.mk, $(timer-subdir-y))
 include $(addsuffix /subdir.mk, $(timekeeper-subdir-y))
+include $(addsuffix /subdir.mk, $(profile-subdir-y))
 
 mkfiles					+= $(src)/drivers/tc/subdir.mk
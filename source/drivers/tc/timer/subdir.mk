@@ -6,6 +6,8 @@ src-$(CONFIG_ARCH_AVR32)	+= $(src-avr32-y)
 src-xmega-tc-$(CONFIG_HAVE_TC)   = drivers/tc/timer/tc_timer_xmega.c
 src-$(CONFIG_CPU_XMEGA)         += $(src-xmega-tc-y)
 
+src-$(CONFIG_ARCH_HOST)         += drivers/tc/timer/timer_host.c
+
 hdr-avr32-$(CONFIG_HAVE_TC)	+= include/timer/tc_timer_avr32.h
 hdr-avr32-$(CONFIG_HAVE_TC)	+= include/tc/tc_ints_avr32.h
 hdr-avr32-$(CONFIG_HAVE_TC)	+= include/tc/tc_avr32.h
@@ -20,4 +22,6 @@ hdr-xmega-tc-$(CONFIG_HAVE_TC)  += include/tc/tc_xmega.h
 hdr-$(CONFIG_CPU_XMEGA)         += $(hdr-xmega-tc-y)
 hdr-$(CONFIG_CPU_XMEGA)         += include/timer/timer_xmega.h
 
+hdr-$(CONFIG_ARCH_HOST)         += include/timer/timer_host.h
+
 mkfiles                         += $(src)/drivers/tc/timer/subdir.mk
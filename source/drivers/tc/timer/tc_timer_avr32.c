@@ -43,6 +43,10 @@
 #include <assert.h>
 #include <interrupt.h>
 
+#ifdef CONFIG_SLEEPMGR
+#include <sleepmgr.h>
+#endif
+
 /**
  * \weakgroup tc_timer_avr32_internal_group AVR32 TC timer internals
  * \ingroup timer_avr32_group
@@ -111,6 +115,9 @@ void tc_timer0_init(timer_t *timer, timer_callback_t timer_callback)
 
 	timer->regs = tc_get_channel_regs(0, 0);
 	timer->callback = timer_callback;
+#ifdef CONFIG_SLEEPMGR
+	timer->running = false;
+#endif
 	tc_register_channel_int(0, 0, tc_timer_irq_handler, timer);
 	tc_timer_init_common(timer, 0, clksel);
 }
@@ -121,6 +128,9 @@ void tc_timer1_init(timer_t *timer, timer_callback_t timer_callback)
 
 	timer->regs = tc_get_channel_regs(0, 1);
 	timer->callback = timer_callback;
+#ifdef CONFIG_SLEEPMGR
+	timer->running = false;
+#endif
 	tc_register_channel_int(0, 1, tc_timer_irq_handler, timer);
 	tc_timer_init_common(timer, 0, clksel);
 }
@@ -131,6 +141,9 @@ void tc_timer2_init(timer_t *timer, timer_callback_t timer_callback)
 
 	timer->regs = tc_get_channel_regs(0, 2);
 	timer->callback = timer_callback;
+#ifdef CONFIG_SLEEPMGR
+	timer->running = false;
+#endif
 	tc_register_channel_int(0, 2, tc_timer_irq_handler, timer);
 	tc_timer_init_common(timer, 0, clksel);
 }
@@ -142,6 +155,9 @@ void tc_timer3_init(timer_t *timer, timer_callback_t timer_callback)
 
 	timer->regs = tc_get_channel_regs(1, 0);
 	timer->callback = timer_callback;
+#ifdef CONFIG_SLEEPMGR
+	timer->running = false;
+#endif
 	tc_register_channel_int(1, 0, tc_timer_irq_handler, timer);
 	tc_timer_init_common(timer, 1, clksel);
 }
@@ -152,6 +168,9 @@ void tc_timer4_init(timer_t *timer, timer_callback_t timer_callback)
 
 	timer->regs = tc_get_channel_regs(1, 1);
 	timer->callback = timer_callback;
+#ifdef CONFIG_SLEEPMGR
+	timer->running = false;
+#endif
 	tc_register_channel_int(1, 1, tc_timer_irq_handler, timer);
 	tc_timer_init_common(timer, 1, clksel);
 }
@@ -162,6 +181,9 @@ void tc_timer5_init(timer_t *timer, timer_callback_t timer_callback)
 
 	timer->regs = tc_get_channel_regs(1, 2);
 	timer->callback = timer_callback;
+#ifdef CONFIG_SLEEPMGR
+	timer->running = false;
+#endif
 	tc_register_channel_int(1, 2, tc_timer_irq_handler, timer);
 	tc_timer_init_common(timer, 1, clksel);
 }
@@ -175,6 +197,12 @@ timer_res_t tc_timer_set_resolution(unsigned int tc_id,
 
 void tc_timer_start(timer_t *timer)
 {
+#ifdef CONFIG_SLEEPMGR
+	// The TC runs on the PBA clock, which is stopped below frozen.
+	if (!timer->running)
+		sleepmgr_lock_mode(SLEEPMGR_FROZEN);
+	timer->running = true;
+#endif
 	// Reset timer count value and enable input clock
 	tc_write_reg(timer->regs, CCR, TC_BIT(CCR_CLKEN) | TC_BIT(CCR_SWTRG));
 }
@@ -222,6 +250,11 @@ void tc_timer_stop(timer_t *timer)
 	tc_write_reg(timer->regs, IDR, TC_BIT(CPAS));
 	// Disable timer by disabling the input clock
 	tc_write_reg(timer->regs, CCR, TC_BIT(CCR_CLKDIS));
+#ifdef CONFIG_SLEEPMGR
+	if (timer->running)
+		sleepmgr_unlock_mode(SLEEPMGR_FROZEN);
+	timer->running = false;
+#endif
 }
 
 uint32_t tc_timer_get_time(timer_t *timer)
@@ -47,6 +47,10 @@
 #include <chip/tc.h>
 #include <pmic.h>
 
+#ifdef CONFIG_SLEEPMGR
+#include <sleepmgr.h>
+#endif
+
 /**
  * \weakgroup timer_xmega_internal_group
  * \ingroup timer_xmega_group
@@ -275,6 +279,11 @@ void tc_timer_start(uint8_t tc_id, struct timer *timer)
 {
 	assert(timer->regs);
 
+#ifdef CONFIG_SLEEPMGR
+	// The TC runs on the peripheral clock, which is stopped below idle.
+	if (!tc_pclk_is_enabled(tc_id))
+		sleepmgr_lock_mode(SLEEPMGR_IDLE);
+#endif
 	tc_enable_pclk(tc_id);
 
 	// Reset TC value, then start counting.
@@ -355,6 +364,10 @@ void tc_timer_stop(uint8_t tc_id, struct timer *timer)
 	tc_write_reg8(timer->regs, INTCTRLB, TC_BF(INTCTRLB_CCAINTLVL,
 			PMIC_INTLVL_OFF));
 	tc_write_reg8(timer->regs, CTRLA, TC_BF(CTRLA_CLKSEL, TC_CLKSEL_OFF));
+#ifdef CONFIG_SLEEPMGR
+	if (tc_pclk_is_enabled(tc_id))
+		sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
 	tc_disable_pclk(tc_id);
 }
 
@@ -0,0 +1,170 @@
+/**
+ * \file
+ *
+ * \brief Timer driver for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <interrupt.h>
+#include <intc.h>
+#include <timer.h>
+#include <util.h>
+
+#ifdef CONFIG_SLEEPMGR
+#include <sleepmgr.h>
+#endif
+
+/**
+ * \weakgroup timer_host_group
+ * @{
+ */
+
+//! Convert \a ticks at \a resolution Hz to microseconds, rounding up.
+static host_time_t host_timer_ticks_to_us(uint32_t ticks,
+		timer_res_t resolution)
+{
+	return ((host_time_t)ticks * 1000000 + resolution - 1) / resolution;
+}
+
+/**
+ * \internal
+ * \brief Timer alarm interrupt handler
+ *
+ * \param int_data Pointer to a timer struct.
+ */
+static void host_timer_irq_handler(void *int_data)
+{
+	struct timer *timer = int_data;
+
+	assert(timer);
+
+	if (timer->callback)
+		timer->callback(timer);
+}
+
+INTC_DEFINE_HANDLER(HOST_TIMER0_IRQ, host_timer_irq_handler, 0);
+INTC_DEFINE_HANDLER(HOST_TIMER1_IRQ, host_timer_irq_handler, 0);
+
+//! Request the alarm interrupt of the timer whose alarm \a event is due.
+static void host_timer_alarm(struct host_event *event)
+{
+	struct timer *timer = container_of(event, struct timer, event);
+
+	if (timer->id == 0)
+		host_irq_raise(HOST_TIMER0_IRQ);
+	else
+		host_irq_raise(HOST_TIMER1_IRQ);
+}
+
+/**
+ * \brief Initialize a host timer
+ *
+ * \param id Timer ID.
+ * \param timer Pointer to timer struct.
+ * \param callback Function called from interrupt context when an alarm
+ * triggers.
+ */
+void host_timer_init(uint8_t id, struct timer *timer,
+		timer_callback_t callback)
+{
+	assert(timer);
+
+	if (id == 0)
+		intc_set_irq_data(HOST_TIMER0_IRQ, timer);
+	else
+		intc_set_irq_data(HOST_TIMER1_IRQ, timer);
+
+	timer->id = id;
+	timer->callback = callback;
+	timer->resolution = CONFIG_TIMER_RESOLUTION;
+	timer->running = false;
+	host_event_init(&timer->event, host_timer_alarm);
+}
+
+/**
+ * \brief Reset the counter and start the timer
+ */
+void host_timer_start(struct timer *timer)
+{
+#ifdef CONFIG_SLEEPMGR
+	if (!timer->running)
+		sleepmgr_lock_mode(SLEEPMGR_IDLE);
+#endif
+	timer->start = host_clock_now();
+	timer->running = true;
+}
+
+/**
+ * \brief Stop the timer and cancel any pending alarm
+ */
+void host_timer_stop(struct timer *timer)
+{
+#ifdef CONFIG_SLEEPMGR
+	if (timer->running)
+		sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
+	timer->running = false;
+	host_event_cancel(&timer->event);
+}
+
+/**
+ * \brief Trigger an alarm \a delay ticks from now
+ *
+ * \param timer Pointer to timer struct.
+ * \param delay Number of ticks until the alarm triggers.
+ */
+void host_timer_set_alarm(struct timer *timer, uint16_t delay)
+{
+	assert(timer->running);
+
+	host_event_schedule(&timer->event,
+			host_timer_ticks_to_us(delay, timer->resolution));
+}
+
+/**
+ * \brief Read the 16-bit counter
+ */
+uint16_t host_timer_get_time(struct timer *timer)
+{
+	host_time_t	elapsed;
+
+	if (!timer->running)
+		return 0;
+
+	elapsed = host_clock_now() - timer->start;
+
+	return elapsed * timer->resolution / 1000000;
+}
+
+//! @}
@@ -1,4 +1,5 @@
 src-$(CONFIG_CPU_XMEGA)		+= drivers/touch/resistive/touch.c
+src-$(CONFIG_CPU_HOST)		+= drivers/touch/resistive/touch.c
 
 hdr-y				+= include/touch/touch.h
 
@@ -38,9 +38,12 @@
 
 #include <assert.h>
 #include <interrupt.h>
-#include <pmic.h>
 #include <intc.h>
 
+#ifdef CONFIG_CPU_XMEGA
+# include <pmic.h>
+#endif
+
 #include <touch/touch.h>
 #include <cpu/touch/resistive/touch.h>
 
@@ -48,6 +51,10 @@
 # include <softirq.h>
 #endif
 
+#ifdef CONFIG_SLEEPMGR
+# include <sleepmgr.h>
+#endif
+
 /**
  * \ingroup touch_driver_group
  * \defgroup touch_driver_4wres_group 4-wire resistive touch driver\
@@ -79,6 +86,26 @@ static uint16_t touch_raw_x;
 //! Temporary raw sample value for Y surface.
 static uint16_t touch_raw_y;
 
+#ifdef CONFIG_TOUCH_FILTER
+//! Position filter state for one touch surface.
+struct touch_filter {
+	//! The last three raw samples, for median filtering.
+	uint16_t history[3];
+	//! IIR filtered value, scaled by 2^CONFIG_TOUCH_FILTER_IIR_SHIFT.
+	uint32_t iir;
+};
+
+//! Filter state for X surface.
+static struct touch_filter touch_filter_x;
+//! Filter state for Y surface.
+static struct touch_filter touch_filter_y;
+#endif
+
+//! Handler which paces the sampling, or NULL if sampling freely.
+static touch_event_handler_t touch_paced_handler;
+//! True if sampling is stopped until the consumer has handled an event.
+static bool touch_waiting_for_consumer;
+
 //! Calibration matrix for the driver.
 static struct touch_calibration_matrix touch_matrix;
 //! Current touch event handler (set to NULL if no handler should be called).
@@ -138,6 +165,7 @@ void touch_enable(void)
 {
 	touch_state = TOUCH_NOT_TOUCHED;
 	touch_last_event.type = TOUCH_NO_EVENT;
+	touch_waiting_for_consumer = false;
 
 	touch_priv_port_set_detection();
 
@@ -167,6 +195,15 @@ void touch_disable(void)
 	touch_priv_port_disable_int();
 	touch_priv_adc_disable_int();
 
+#ifdef CONFIG_SLEEPMGR
+	// A sweep which is cut short must release its sleep lock.
+	if ((touch_state == TOUCH_READING_X)
+			|| (touch_state == TOUCH_READING_Y)) {
+		sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+	}
+#endif
+	touch_state = TOUCH_DISABLED;
+
 	cpu_irq_restore(irqflags);
 }
 
@@ -205,6 +242,10 @@ bool touch_is_touched(void)
 /**
  * \brief Set touch event handler for driver.
  *
+ * Sampling is only paced while the handler which enabled pacing with
+ * \ref touch_set_paced() is installed, so other handlers do not have to
+ * call \ref touch_event_consumed().
+ *
  * \param handler Address of new handler function.
  */
 void touch_set_event_handler(touch_event_handler_t handler)
@@ -214,6 +255,10 @@ void touch_set_event_handler(touch_event_handler_t handler)
 
 	touch_event_handler = handler;
 
+	// Don't wait for a consumer which no longer gets the events.
+	if (handler != touch_paced_handler)
+		touch_event_consumed();
+
 	cpu_irq_restore(irqflags);
 }
 
@@ -229,6 +274,48 @@ touch_event_handler_t touch_get_event_handler(void)
 }
 
 
+/**
+ * \brief Enable or disable pacing of sampling by the event consumer.
+ *
+ * When pacing is enabled, the driver does not start a new measurement after
+ * sending a press or move event to the event handler until
+ * \ref touch_event_consumed() is called. This limits the rate of move events
+ * to the rate at which the consumer can handle them.
+ *
+ * Pacing applies to the current event handler only. It is suspended while
+ * another handler is installed with \ref touch_set_event_handler(), and
+ * resumes when the handler is restored.
+ *
+ * \param paced True to enable pacing, false to sample freely.
+ */
+void touch_set_paced(bool paced)
+{
+	touch_paced_handler = paced ? touch_event_handler : NULL;
+
+	if (!paced)
+		touch_event_consumed();
+}
+
+
+/**
+ * \brief Notify driver that the last touch event has been handled.
+ *
+ * Restarts touch detection if the driver is waiting for the consumer. This
+ * may be called at any time, also when no event is pending.
+ */
+void touch_event_consumed(void)
+{
+	irqflags_t irqflags = cpu_irq_save();
+
+	if (touch_waiting_for_consumer) {
+		touch_waiting_for_consumer = false;
+		touch_priv_port_enable_int();
+	}
+
+	cpu_irq_restore(irqflags);
+}
+
+
 /**
  * \brief Assign a calibration matrix to the driver.
  *
@@ -317,6 +404,89 @@ void touch_compute_calibration_matrix(
 			- ((x_r2 - x_r3) * (y_r1 - y_r3));
 }
 
+#ifdef CONFIG_TOUCH_FILTER
+/**
+ * \internal
+ * \brief Reset filter to a new touch.
+ *
+ * \param filter Filter to reset.
+ * \param sample First raw sample of the touch.
+ */
+static void touch_priv_filter_reset(struct touch_filter *filter,
+		uint16_t sample)
+{
+	filter->history[0] = sample;
+	filter->history[1] = sample;
+	filter->history[2] = sample;
+	filter->iir = (uint32_t)sample << CONFIG_TOUCH_FILTER_IIR_SHIFT;
+}
+
+
+/**
+ * \internal
+ * \brief Add a raw sample to a filter and return the filtered value.
+ *
+ * \param filter Filter to update.
+ * \param sample New raw sample.
+ *
+ * \return Median of the last three samples, smoothed by the IIR filter.
+ */
+static uint16_t touch_priv_filter_sample(struct touch_filter *filter,
+		uint16_t sample)
+{
+	uint16_t a;
+	uint16_t b;
+	uint16_t c;
+	uint16_t median;
+
+	filter->history[0] = filter->history[1];
+	filter->history[1] = filter->history[2];
+	filter->history[2] = sample;
+
+	a = filter->history[0];
+	b = filter->history[1];
+	c = filter->history[2];
+
+	// Pick the middle value of the three.
+	if (a > b) {
+		median = a;
+		a = b;
+		b = median;
+	}
+	median = (c < a) ? a : ((c > b) ? b : c);
+
+	// iir += median - iir / 2^N, where iir holds the value scaled by 2^N.
+	filter->iir -= filter->iir >> CONFIG_TOUCH_FILTER_IIR_SHIFT;
+	filter->iir += median;
+
+	return filter->iir >> CONFIG_TOUCH_FILTER_IIR_SHIFT;
+}
+#endif
+
+
+/**
+ * \internal
+ * \brief Check if a position has moved far enough for a move event.
+ *
+ * \param panel_x Current panel X coordinate.
+ * \param panel_y Current panel Y coordinate.
+ *
+ * \retval true  Position differs from the last event by at least
+ *                \ref CONFIG_TOUCH_MOVE_THRESHOLD along either axis.
+ * \retval false Position has not moved far enough.
+ */
+static bool touch_priv_has_moved(int32_t panel_x, int32_t panel_y)
+{
+	int32_t dx = panel_x - touch_last_event.point.panel_x;
+	int32_t dy = panel_y - touch_last_event.point.panel_y;
+
+	return (dx >= CONFIG_TOUCH_MOVE_THRESHOLD)
+			|| (dx <= -CONFIG_TOUCH_MOVE_THRESHOLD)
+			|| (dy >= CONFIG_TOUCH_MOVE_THRESHOLD)
+			|| (dy <= -CONFIG_TOUCH_MOVE_THRESHOLD);
+}
+
+
 /**
  * \brief Process touch samples.
  *
@@ -346,6 +516,22 @@ void touch_priv_process_samples(void *int_data)
 	touch_raw_x >>= CONFIG_TOUCH_OVERSAMPLING;
 	touch_raw_y >>= CONFIG_TOUCH_OVERSAMPLING;
 
+#ifdef CONFIG_TOUCH_FILTER
+	/* Restart the filters on a new touch, so that the press event is
+	 * not smeared towards the position of the previous touch.
+	 */
+	if ((touch_last_event.type == TOUCH_NO_EVENT)
+			|| (touch_last_event.type == TOUCH_RELEASE)) {
+		touch_priv_filter_reset(&touch_filter_x, touch_raw_x);
+		touch_priv_filter_reset(&touch_filter_y, touch_raw_y);
+	} else {
+		touch_raw_x = touch_priv_filter_sample(&touch_filter_x,
+				touch_raw_x);
+		touch_raw_y = touch_priv_filter_sample(&touch_filter_y,
+				touch_raw_y);
+	}
+#endif
+
 	// Compute panel X coordinate of touch.
 	int32_t panel_x = (touch_matrix.a * touch_raw_x)
 			+ (touch_matrix.b * touch_raw_y)
@@ -390,11 +576,10 @@ void touch_priv_process_samples(void *int_data)
 			touch_last_event.type = TOUCH_PRESS;
 			send_event = true;
 		}
-		/* Otherwise, if the touch panel coordinates have changed, the
-		 * event is a move of the touch.
+		/* Otherwise, if the touch panel coordinates have changed
+		 * enough, the event is a move of the touch.
 		 */
-		else if ((touch_last_event.point.panel_x != panel_x)
-				|| (touch_last_event.point.panel_y != panel_y)) {
+		else if (touch_priv_has_moved(panel_x, panel_y)) {
 			touch_last_event.type = TOUCH_MOVE;
 			send_event = true;
 		}
@@ -409,13 +594,25 @@ void touch_priv_process_samples(void *int_data)
 			touch_last_event.point.panel_y = panel_y;
 
 			if (touch_event_handler != NULL) {
+				/* Leave touch detection off until the
+				 * consumer has handled the event, if paced.
+				 */
+				if (touch_event_handler
+						== touch_paced_handler) {
+					touch_waiting_for_consumer = true;
+				}
+
 				touch_event_handler(&touch_last_event);
 			}
 		}
 	}
 
-	// Re-enable touch detection to trigger new measurements.
-	touch_priv_port_enable_int();
+	/* Re-enable touch detection to trigger new measurements, unless
+	 * the consumer will do so when it has handled the event.
+	 */
+	if (!touch_waiting_for_consumer) {
+		touch_priv_port_enable_int();
+	}
 }
 
 
@@ -439,6 +636,11 @@ void touch_priv_port_handler(void *int_data)
 	touch_raw_x = 0;
 	touch_raw_y = 0;
 
+#ifdef CONFIG_SLEEPMGR
+	// The ADC needs the peripheral clock until the sweep is done.
+	sleepmgr_lock_mode(SLEEPMGR_IDLE);
+#endif
+
 	// Update driver state and commence measurements of X.
 	touch_state = TOUCH_READING_X;
 	touch_priv_port_set_gradient_x();
@@ -461,6 +663,10 @@ void touch_priv_adc_handler(void *int_data)
 {
 	static uint8_t sample_count = 0;
 
+	// Each sweep must deliver a whole fraction of the samples.
+	build_assert(((1 << CONFIG_TOUCH_OVERSAMPLING)
+			% TOUCH_ADC_SAMPLES_PER_SWEEP) == 0);
+
 	switch (touch_state) {
 		case TOUCH_READING_X:
 			// Sum raw X position measurements from the ADC.
@@ -468,7 +674,7 @@ void touch_priv_adc_handler(void *int_data)
 
 			// Change state and start ADC reading of X
 			// when enough samples have been taken.
-			++sample_count;
+			sample_count += TOUCH_ADC_SAMPLES_PER_SWEEP;
 
 			if (sample_count < (1 << CONFIG_TOUCH_OVERSAMPLING)) {
 				touch_priv_adc_start();
@@ -489,7 +695,7 @@ void touch_priv_adc_handler(void *int_data)
 
 			// Change state and start ADC reading of Y
 			// when enough samples have been taken.
-			++sample_count;
+			sample_count += TOUCH_ADC_SAMPLES_PER_SWEEP;
 
 			if (sample_count < (1 << CONFIG_TOUCH_OVERSAMPLING)) {
 				touch_priv_adc_start();
@@ -497,6 +703,9 @@ void touch_priv_adc_handler(void *int_data)
 				sample_count = 0;
 
 				touch_state = TOUCH_PROCESSING;
+#ifdef CONFIG_SLEEPMGR
+				sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
 
 				// Prepare touch detection again.
 				touch_priv_port_set_detection();
@@ -60,6 +60,10 @@
 
 #include <app/usb.h>
 
+#ifdef CONFIG_SLEEPMGR
+#include <sleepmgr.h>
+#endif
+
 #include "at90usb_internal.h"
 #include "at90usb_regs.h"
 
@@ -1520,6 +1524,11 @@ static void at90usb_udc_maybe_attach(struct at90usb_udc *udc90)
 #ifdef CONFIG_AT90USB_ENABLE_UVREG
 		avr_write_reg8(UHWCON, avr_read_reg8(UHWCON)
 				| AT90USB_UHWCON_UVREGE);
+#endif
+#ifdef CONFIG_SLEEPMGR
+		// The USB controller needs its clock while attached.
+		if (avr_read_reg8(UDCON) & AT90USB_UDCON_DETACH)
+			sleepmgr_lock_mode(SLEEPMGR_IDLE);
 #endif
 		avr_write_reg8(UDCON, avr_read_reg8(UDCON)
 				& ~AT90USB_UDCON_DETACH);
@@ -1552,6 +1561,9 @@ static void at90usb_udc_detach(struct at90usb_udc *udc90)
 
 		avr_write_reg8(UDCON, udcon | AT90USB_UDCON_DETACH);
 		avr_write_reg8(UDIEN, 0);
+#ifdef CONFIG_SLEEPMGR
+		sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+#endif
 	}
 }
 
@@ -0,0 +1,787 @@
+/**
+ * \file
+ *
+ * \brief Simulated USB Device Controller for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <bitops.h>
+#include <byteorder.h>
+#include <debug.h>
+#include <interrupt.h>
+#include <status_codes.h>
+#include <string.h>
+#include <util.h>
+#include <workqueue.h>
+#include <arch/host_clock.h>
+
+#include <usb/request.h>
+#include <usb/dev.h>
+#include <usb/udc.h>
+#include <usb/udc_lib.h>
+
+#include <app/usb.h>
+
+/**
+ * \weakgroup udc_host_group
+ * @{
+ */
+
+/*
+ * Bus timing. The overhead covers tokens, handshakes, CRCs and
+ * inter-packet gaps, and is chosen so that a transfer moves 19 packets of
+ * 64 bytes per frame at full speed and 13 packets of 512 bytes per
+ * microframe at high speed, which is what a good host controller
+ * achieves for bulk transfers.
+ */
+#ifdef CONFIG_UDC_HIGH_SPEED
+//! Picoseconds per byte on the bus
+# define HOST_UDC_BYTE_PS		16667
+//! Overhead per packet, in byte times
+# define HOST_UDC_PACKET_OVERHEAD	65
+#else
+# define HOST_UDC_BYTE_PS		666667
+# define HOST_UDC_PACKET_OVERHEAD	15
+#endif
+
+//! Flags indicating the state of a simulated endpoint
+enum host_udc_ep_flag {
+	HOST_UDC_EP_ALLOCATED,		//!< Endpoint is in use
+	HOST_UDC_EP_ENABLED,		//!< Endpoint accepts requests
+	HOST_UDC_EP_IS_IN,		//!< Endpoint sends data to the host
+	HOST_UDC_EP_HALTED,		//!< Endpoint is halted
+	HOST_UDC_EP_WEDGE,		//!< Halt can't be cleared by the host
+};
+
+//! A simulated non-control endpoint
+struct host_udc_ep {
+	//! Bitmask of flags from \ref host_udc_ep_flag
+	bit_word_t		flags;
+	//! Maximum packet size
+	uint16_t		maxpacket;
+	//! Requests submitted by the device
+	struct slist		req_queue;
+	//! Transfer submitted by the host, if any
+	struct host_udc_xfer	*xfer;
+};
+
+//! The simulated USB Device Controller
+struct host_udc {
+	//! Generic UDC state
+	struct udc		udc;
+	//! Endpoints, of which ep[0] is unused
+	struct host_udc_ep	ep[APP_UDC_NR_ENDPOINTS];
+	//! Task completing transactions and control transfers
+	struct workqueue_task	task;
+	//! Virtual clock event for the end of the current transaction
+	struct host_event	bus_event;
+	//! Endpoint of the transaction on the bus, or 0 if the bus is idle
+	usb_ep_id_t		bus_ep;
+	//! Device request of the transaction on the bus
+	struct usb_request	*bus_req;
+	//! Number of data bytes in the transaction on the bus
+	size_t			bus_len;
+	//! Bus time left over from previous transactions, in picoseconds
+	uint32_t		bus_ps;
+	//! True when the transaction on the bus has ended
+	bool			bus_done;
+	//! Endpoint to look at first when starting a transaction
+	usb_ep_id_t		next_ep;
+	//! Control transfer in progress, if any
+	struct host_udc_xfer	*ctrl_xfer;
+	//! SETUP packet of \a ctrl_xfer
+	struct usb_setup_req	setup;
+	//! True until \a setup has been handed to the device
+	bool			setup_pending;
+	//! Control data request waiting for completion
+	struct usb_request	*ep0_req;
+};
+
+static struct host_udc the_host_udc;
+
+static inline struct host_udc *host_udc_of(struct udc *udc)
+{
+	return container_of(udc, struct host_udc, udc);
+}
+
+static inline struct host_udc *host_udc_task_of(struct workqueue_task *task)
+{
+	return container_of(task, struct host_udc, task);
+}
+
+static void host_udc_req_done(struct udc *udc, struct usb_request *req,
+		status_t status)
+{
+	req->status = status;
+
+	if (req->req_done)
+		req->req_done(udc, req);
+}
+
+static void host_udc_xfer_done(struct udc *udc, struct host_udc_xfer *xfer,
+		status_t status)
+{
+	xfer->status = status;
+
+	if (xfer->done)
+		xfer->done(udc, xfer);
+}
+
+//! Total length of the buffers in \a req
+static size_t host_udc_req_len(struct usb_request *req)
+{
+	struct buffer	*buf;
+	size_t		len = 0;
+
+	for (buf = buf_list_peek_head(&req->buf_list);
+			slist_node_is_valid(&req->buf_list, &buf->node);
+			buf = buf_list_peek_next(buf))
+		len += buf->len;
+
+	return len;
+}
+
+/**
+ * \internal
+ * \brief Copy data between a host transfer and a device request
+ *
+ * \param req The device request.
+ * \param offset Byte offset into the buffers of \a req.
+ * \param data Host data.
+ * \param len Number of bytes to copy.
+ * \param is_in True to copy from \a req to \a data, false for the other
+ * direction.
+ */
+static void host_udc_copy(struct usb_request *req, size_t offset,
+		uint8_t *data, size_t len, bool is_in)
+{
+	struct buffer	*buf;
+	size_t		nbytes;
+
+	for (buf = buf_list_peek_head(&req->buf_list);
+			len && slist_node_is_valid(&req->buf_list, &buf->node);
+			buf = buf_list_peek_next(buf)) {
+		if (offset >= buf->len) {
+			offset -= buf->len;
+			continue;
+		}
+
+		nbytes = min_u(len, buf->len - offset);
+		if (is_in)
+			memcpy(data, (uint8_t *)buf->addr.ptr + offset, nbytes);
+		else
+			memcpy((uint8_t *)buf->addr.ptr + offset, data, nbytes);
+
+		data += nbytes;
+		len -= nbytes;
+		offset = 0;
+	}
+}
+
+static void host_udc_bus_event(struct host_event *event)
+{
+	struct host_udc *hudc = container_of(event, struct host_udc, bus_event);
+
+	hudc->bus_done = true;
+	workqueue_add_task(&main_workqueue, &hudc->task);
+}
+
+/**
+ * \internal
+ * \brief Put the next transaction on the bus, if the bus is idle
+ *
+ * Endpoints where both the host and the device have a transfer pending
+ * are served round-robin. A transaction covers as much data as both
+ * sides have room for, and ends when the bus time of all its packets
+ * has elapsed.
+ */
+static void host_udc_start_transaction(struct host_udc *hudc)
+{
+	struct host_udc_ep	*ep;
+	struct host_udc_xfer	*xfer;
+	struct usb_request	*req;
+	unsigned int		i;
+	usb_ep_id_t		id;
+	size_t			len;
+	size_t			packets;
+	uint64_t		ps;
+	irqflags_t		iflags;
+
+	iflags = cpu_irq_save();
+	if (hudc->bus_ep)
+		goto out;
+
+	for (i = 0; i < APP_UDC_NR_ENDPOINTS - 1; i++) {
+		id = 1 + (hudc->next_ep + i - 1) % (APP_UDC_NR_ENDPOINTS - 1);
+		ep = &hudc->ep[id];
+		xfer = ep->xfer;
+
+		if (!xfer || !test_bit(HOST_UDC_EP_ENABLED, &ep->flags))
+			continue;
+		if (test_bit(HOST_UDC_EP_HALTED, &ep->flags)) {
+			/* Let the task report the STALL */
+			workqueue_add_task(&main_workqueue, &hudc->task);
+			continue;
+		}
+		if (slist_is_empty(&ep->req_queue))
+			continue;
+
+		req = slist_peek_head(&ep->req_queue,
+				struct usb_request, node);
+		len = min_u(xfer->len - xfer->actual,
+				host_udc_req_len(req) - req->bytes_xfered);
+		packets = max_u(div_ceil(len, ep->maxpacket), 1);
+		ps = hudc->bus_ps + (uint64_t)HOST_UDC_BYTE_PS
+				* (len + packets * HOST_UDC_PACKET_OVERHEAD);
+
+		hudc->bus_ep = id;
+		hudc->bus_req = req;
+		hudc->bus_len = len;
+		hudc->bus_ps = ps % 1000000;
+		hudc->next_ep = id % (APP_UDC_NR_ENDPOINTS - 1) + 1;
+		host_event_schedule(&hudc->bus_event, ps / 1000000);
+		break;
+	}
+
+out:
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \internal
+ * \brief Move the data of the transaction which just ended
+ *
+ * The device request is done when its buffers are full, or for OUT
+ * endpoints, when a short packet is received. The host transfer is done
+ * when it has got all its data, or for IN endpoints, when a short packet
+ * is received.
+ */
+static void host_udc_finish_transaction(struct host_udc *hudc)
+{
+	struct udc		*udc = &hudc->udc;
+	struct host_udc_ep	*ep = &hudc->ep[hudc->bus_ep];
+	struct host_udc_xfer	*xfer = ep->xfer;
+	struct usb_request	*req = hudc->bus_req;
+	size_t			len = hudc->bus_len;
+	bool			is_in;
+	bool			short_pkt;
+	bool			req_done;
+	bool			xfer_done;
+
+	hudc->bus_ep = 0;
+
+	/* The request may have been flushed meanwhile */
+	if (!xfer || slist_is_empty(&ep->req_queue)
+			|| slist_peek_head(&ep->req_queue,
+				struct usb_request, node) != req)
+		return;
+
+	is_in = test_bit(HOST_UDC_EP_IS_IN, &ep->flags);
+	host_udc_copy(req, req->bytes_xfered,
+			(uint8_t *)xfer->data + xfer->actual, len, is_in);
+	req->bytes_xfered += len;
+	xfer->actual += len;
+
+	short_pkt = len == 0 || len % ep->maxpacket;
+	if (is_in) {
+		req_done = req->bytes_xfered == host_udc_req_len(req);
+		xfer_done = xfer->actual == xfer->len || short_pkt
+			|| (req_done && test_bit(USB_REQ_SHORT_PKT,
+						&req->flags));
+	} else {
+		req_done = req->bytes_xfered == host_udc_req_len(req)
+			|| short_pkt;
+		xfer_done = xfer->actual == xfer->len;
+	}
+
+	/*
+	 * The device may queue its next request from the completion
+	 * callback, so make sure that it doesn't get to see the host
+	 * transfer which is already done.
+	 */
+	if (xfer_done)
+		ep->xfer = NULL;
+	if (req_done) {
+		slist_pop_head_node(&ep->req_queue);
+		host_udc_req_done(udc, req, STATUS_OK);
+	}
+	if (xfer_done)
+		host_udc_xfer_done(udc, xfer, STATUS_OK);
+}
+
+//! Complete the control transfer in progress
+static void host_udc_ctrl_done(struct host_udc *hudc, status_t status)
+{
+	struct host_udc_xfer	*xfer = hudc->ctrl_xfer;
+
+	assert(xfer);
+
+	hudc->ctrl_xfer = NULL;
+	host_udc_xfer_done(&hudc->udc, xfer, status);
+}
+
+static void host_udc_worker(struct workqueue_task *task)
+{
+	struct host_udc		*hudc = host_udc_task_of(task);
+	struct udc		*udc = &hudc->udc;
+	struct host_udc_xfer	*xfer;
+	struct usb_request	*req;
+	unsigned int		i;
+
+	if (hudc->bus_done) {
+		hudc->bus_done = false;
+		host_udc_finish_transaction(hudc);
+	}
+
+	for (i = 1; i < APP_UDC_NR_ENDPOINTS; i++) {
+		struct host_udc_ep *ep = &hudc->ep[i];
+
+		xfer = ep->xfer;
+		if (xfer && hudc->bus_ep != i
+				&& test_bit(HOST_UDC_EP_HALTED, &ep->flags)) {
+			ep->xfer = NULL;
+			host_udc_xfer_done(udc, xfer, ERR_PROTOCOL);
+		}
+	}
+
+	if (hudc->ctrl_xfer && hudc->setup_pending) {
+		hudc->setup_pending = false;
+		if (udc->speed == USB_SPEED_UNKNOWN)
+			host_udc_ctrl_done(hudc, ERR_FLUSHED);
+		else if (udc_lib_process_setup_request(udc, &hudc->setup) < 0)
+			host_udc_ctrl_done(hudc, ERR_PROTOCOL);
+	}
+
+	req = hudc->ep0_req;
+	if (req) {
+		hudc->ep0_req = NULL;
+		host_udc_req_done(udc, req, STATUS_OK);
+	}
+
+	host_udc_start_transaction(hudc);
+}
+
+/**
+ * \brief Submit a transfer from the simulated host
+ *
+ * \param udc The USB Device Controller
+ * \param ep_addr Endpoint address, including the direction bit
+ * \param xfer The transfer. Its \a data, \a len and \a done fields must
+ * be set up by the caller.
+ *
+ * \pre No other transfer is pending on the same endpoint.
+ */
+void host_udc_submit(struct udc *udc, uint8_t ep_addr,
+		struct host_udc_xfer *xfer)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+	struct host_udc_ep	*ep;
+	usb_ep_id_t		id = ep_addr & USB_EP_ADDR_MASK;
+
+	assert(id > 0 && id < APP_UDC_NR_ENDPOINTS);
+
+	ep = &hudc->ep[id];
+	assert(!ep->xfer);
+
+	xfer->actual = 0;
+	xfer->status = OPERATION_IN_PROGRESS;
+
+	if (udc->speed == USB_SPEED_UNKNOWN) {
+		host_udc_xfer_done(udc, xfer, ERR_FLUSHED);
+		return;
+	}
+
+	ep->xfer = xfer;
+	host_udc_start_transaction(hudc);
+}
+
+/**
+ * \brief Submit a control transfer from the simulated host
+ *
+ * The direction and length of the data stage are given by \a setup. The
+ * transfer completes with ERR_PROTOCOL if the device STALLs the request.
+ *
+ * \param udc The USB Device Controller
+ * \param setup The SETUP packet
+ * \param xfer The transfer. Its \a data and \a done fields must be set up
+ * by the caller, and \a len must match \a setup.
+ *
+ * \pre No other control transfer is in progress.
+ */
+void host_udc_control(struct udc *udc, const struct usb_setup_req *setup,
+		struct host_udc_xfer *xfer)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+
+	assert(!hudc->ctrl_xfer);
+	assert(xfer->len == le16_to_cpu(setup->wLength));
+
+	xfer->actual = 0;
+	xfer->status = OPERATION_IN_PROGRESS;
+
+	hudc->setup = *setup;
+	hudc->ctrl_xfer = xfer;
+	hudc->setup_pending = true;
+	workqueue_add_task(&main_workqueue, &hudc->task);
+}
+
+void udc_ep0_submit_out_req(struct udc *udc, struct usb_request *req)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+	struct host_udc_xfer	*xfer = hudc->ctrl_xfer;
+	size_t			len;
+
+	assert(xfer && !hudc->ep0_req);
+
+	len = min_u(host_udc_req_len(req), xfer->len - xfer->actual);
+	host_udc_copy(req, 0, (uint8_t *)xfer->data + xfer->actual,
+			len, false);
+	req->bytes_xfered = len;
+	xfer->actual += len;
+
+	hudc->ep0_req = req;
+	workqueue_add_task(&main_workqueue, &hudc->task);
+}
+
+void udc_ep0_submit_in_req(struct udc *udc, struct usb_request *req)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+	struct host_udc_xfer	*xfer = hudc->ctrl_xfer;
+	size_t			len;
+
+	assert(xfer && !hudc->ep0_req);
+
+	len = min_u(host_udc_req_len(req), xfer->len - xfer->actual);
+	host_udc_copy(req, 0, (uint8_t *)xfer->data + xfer->actual,
+			len, true);
+	req->bytes_xfered = len;
+	xfer->actual += len;
+
+	hudc->ep0_req = req;
+	workqueue_add_task(&main_workqueue, &hudc->task);
+}
+
+status_t udc_ep0_write_sync(struct udc *udc, const void *data, size_t len)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+	struct host_udc_xfer	*xfer = hudc->ctrl_xfer;
+
+	assert(xfer);
+	assert(len > 0);
+
+	len = min_u(len, APP_UDC_MAXPACKETSIZE0);
+	memcpy((uint8_t *)xfer->data + xfer->actual, data,
+			min_u(len, xfer->len - xfer->actual));
+	xfer->actual += min_u(len, xfer->len - xfer->actual);
+
+	return len;
+}
+
+void udc_ep0_send_status(struct udc *udc)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+
+	if (hudc->setup.bRequest == USB_REQ_SET_ADDRESS
+			&& usb_setup_type(&hudc->setup)
+				== USB_REQTYPE_STANDARD)
+		udc->address = le16_to_cpu(hudc->setup.wValue) & 0x7f;
+
+	host_udc_ctrl_done(hudc, STATUS_OK);
+}
+
+void udc_ep0_expect_status(struct udc *udc)
+{
+	host_udc_ctrl_done(host_udc_of(udc), STATUS_OK);
+}
+
+void udc_ep_submit_out_req(struct udc *udc, usb_ep_id_t ep_id,
+		struct usb_request *req)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+	struct host_udc_ep	*ep = &hudc->ep[ep_id];
+	bool			queued = true;
+
+	assert(ep_id > 0 && ep_id < APP_UDC_NR_ENDPOINTS);
+
+	req->bytes_xfered = 0;
+	req->status = OPERATION_IN_PROGRESS;
+
+	cpu_irq_disable();
+	if (test_bit(HOST_UDC_EP_ENABLED, &ep->flags))
+		slist_insert_tail(&ep->req_queue, &req->node);
+	else
+		queued = false;
+	cpu_irq_enable();
+
+	if (queued)
+		host_udc_start_transaction(hudc);
+	else
+		host_udc_req_done(udc, req, ERR_FLUSHED);
+}
+
+void udc_ep_submit_in_req(struct udc *udc, usb_ep_id_t ep_id,
+		struct usb_request *req)
+{
+	/* Requests are served the same way in both directions */
+	udc_ep_submit_out_req(udc, ep_id, req);
+}
+
+status_t udc_ep_is_halted(struct udc *udc, usb_ep_id_t ep)
+{
+	if (ep >= APP_UDC_NR_ENDPOINTS)
+		return -1;
+
+	return test_bit(HOST_UDC_EP_HALTED, &host_udc_of(udc)->ep[ep].flags);
+}
+
+status_t udc_ep_set_halt(struct udc *udc, usb_ep_id_t ep)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+
+	dbg_verbose("host-udc: ep%d: set halt\n", ep);
+
+	if (ep >= APP_UDC_NR_ENDPOINTS)
+		return -1;
+
+	if (ep == 0) {
+		/* Protocol STALL, cleared by the next SETUP packet */
+		if (hudc->ctrl_xfer)
+			host_udc_ctrl_done(hudc, ERR_PROTOCOL);
+		return 0;
+	}
+
+	set_bit(HOST_UDC_EP_HALTED, &hudc->ep[ep].flags);
+	if (hudc->ep[ep].xfer)
+		workqueue_add_task(&main_workqueue, &hudc->task);
+
+	return 0;
+}
+
+status_t udc_ep_clear_halt(struct udc *udc, usb_ep_id_t ep)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+
+	dbg_verbose("host-udc: ep%d: clear halt\n", ep);
+
+	if (ep >= APP_UDC_NR_ENDPOINTS)
+		return -1;
+
+	if (!test_bit(HOST_UDC_EP_WEDGE, &hudc->ep[ep].flags)) {
+		clear_bit(HOST_UDC_EP_HALTED, &hudc->ep[ep].flags);
+		host_udc_start_transaction(hudc);
+	}
+
+	return 0;
+}
+
+bool udc_ep_is_wedged(struct udc *udc, usb_ep_id_t ep)
+{
+	assert(ep < APP_UDC_NR_ENDPOINTS);
+
+	return test_bit(HOST_UDC_EP_WEDGE, &host_udc_of(udc)->ep[ep].flags);
+}
+
+void udc_ep_set_wedge(struct udc *udc, usb_ep_id_t ep)
+{
+	dbg_verbose("host-udc: ep%d: set wedge\n", ep);
+
+	assert(ep < APP_UDC_NR_ENDPOINTS);
+
+	set_bit(HOST_UDC_EP_WEDGE, &host_udc_of(udc)->ep[ep].flags);
+	udc_ep_set_halt(udc, ep);
+}
+
+void udc_ep_clear_wedge(struct udc *udc, usb_ep_id_t ep)
+{
+	dbg_verbose("host-udc: ep%d: clear wedge\n", ep);
+
+	assert(ep < APP_UDC_NR_ENDPOINTS);
+
+	clear_bit(HOST_UDC_EP_WEDGE, &host_udc_of(udc)->ep[ep].flags);
+}
+
+void udc_ep_flush(struct udc *udc, usb_ep_id_t ep_id)
+{
+	struct host_udc_ep	*ep = &host_udc_of(udc)->ep[ep_id];
+	struct usb_request	*req;
+	struct slist		req_queue;
+
+	dbg_verbose("host-udc: flush ep%u\n", ep_id);
+
+	assert(ep_id > 0 && ep_id < APP_UDC_NR_ENDPOINTS);
+
+	cpu_irq_disable();
+	slist_init(&req_queue);
+	if (!slist_is_empty(&ep->req_queue))
+		slist_move_to_tail(&req_queue, &ep->req_queue);
+	cpu_irq_enable();
+
+	while (!slist_is_empty(&req_queue)) {
+		req = slist_pop_head(&req_queue, struct usb_request, node);
+		host_udc_req_done(udc, req, ERR_FLUSHED);
+	}
+}
+
+static usb_ep_id_t host_udc_ep_create(struct udc *udc, uint8_t addr,
+		uint16_t max_packet_size)
+{
+	struct host_udc_ep	*ep;
+	usb_ep_id_t		id = addr & USB_EP_ADDR_MASK;
+
+	assert(id > 0 && id < APP_UDC_NR_ENDPOINTS);
+
+	ep = &host_udc_of(udc)->ep[id];
+	if (atomic_test_and_set_bit(HOST_UDC_EP_ALLOCATED, &ep->flags))
+		return ERR_BUSY;
+
+	if (addr & USB_DIR_IN)
+		set_bit(HOST_UDC_EP_IS_IN, &ep->flags);
+	ep->maxpacket = max_packet_size;
+	slist_init(&ep->req_queue);
+
+	barrier();
+	set_bit(HOST_UDC_EP_ENABLED, &ep->flags);
+
+	return id;
+}
+
+usb_ep_id_t udc_ep_create_bulk(struct udc *udc, uint8_t addr,
+		uint16_t max_packet_size)
+{
+	dbg_verbose("host-udc: create BULK ep addr: %02x size: %u\n",
+			addr, max_packet_size);
+
+	return host_udc_ep_create(udc, addr, max_packet_size);
+}
+
+usb_ep_id_t udc_ep_create_interrupt(struct udc *udc, uint8_t addr,
+		uint16_t max_packet_size)
+{
+	dbg_verbose("host-udc: create INTERRUPT ep addr: %02x size: %u\n",
+			addr, max_packet_size);
+
+	return host_udc_ep_create(udc, addr, max_packet_size);
+}
+
+void udc_ep_destroy(struct udc *udc, usb_ep_id_t ep_id)
+{
+	struct host_udc_ep	*ep = &host_udc_of(udc)->ep[ep_id];
+	struct host_udc_xfer	*xfer;
+
+	dbg_verbose("host-udc: destroy ep%u\n", ep_id);
+
+	assert(ep_id > 0 && ep_id < APP_UDC_NR_ENDPOINTS);
+
+	clear_bit(HOST_UDC_EP_ENABLED, &ep->flags);
+	udc_ep_flush(udc, ep_id);
+
+	/* The host sees the endpoint disappear */
+	xfer = ep->xfer;
+	ep->xfer = NULL;
+	ep->flags = 0;
+	if (xfer)
+		host_udc_xfer_done(udc, xfer, ERR_FLUSHED);
+}
+
+status_t udc_enter_test_mode(struct udc *udc, unsigned int mode)
+{
+	return -1;
+}
+
+void udc_attach(struct udc *udc)
+{
+	if (test_bit(UDC_AUTOATTACH, &udc->flags))
+		return;
+
+	set_bit(UDC_AUTOATTACH, &udc->flags);
+
+	/* The host resets the device as soon as it is connected */
+	udc->address = 0;
+#ifdef CONFIG_UDC_HIGH_SPEED
+	udc->speed = USB_SPEED_HIGH;
+#else
+	udc->speed = USB_SPEED_FULL;
+#endif
+	dbg_verbose("host-udc: reset speed %u\n", udc->speed);
+	usb_dev_reset(udc);
+}
+
+void udc_detach(struct udc *udc)
+{
+	struct host_udc		*hudc = host_udc_of(udc);
+	struct host_udc_xfer	*xfer;
+	unsigned int		i;
+
+	if (!test_bit(UDC_AUTOATTACH, &udc->flags))
+		return;
+
+	clear_bit(UDC_AUTOATTACH, &udc->flags);
+	udc->speed = USB_SPEED_UNKNOWN;
+	udc->address = 0;
+	usb_dev_reset(udc);
+
+	for (i = 1; i < APP_UDC_NR_ENDPOINTS; i++) {
+		xfer = hudc->ep[i].xfer;
+		hudc->ep[i].xfer = NULL;
+		if (xfer)
+			host_udc_xfer_done(udc, xfer, ERR_FLUSHED);
+	}
+	if (hudc->ctrl_xfer)
+		host_udc_ctrl_done(hudc, ERR_FLUSHED);
+}
+
+/**
+ * \brief Initialize the simulated USB Device Controller
+ *
+ * The controller is connected to the simulated host when udc_attach()
+ * is called.
+ */
+struct udc *udc_init(void)
+{
+	struct host_udc		*hudc = &the_host_udc;
+	unsigned int		i;
+
+	for (i = 0; i < APP_UDC_NR_ENDPOINTS; i++)
+		slist_init(&hudc->ep[i].req_queue);
+
+	hudc->udc.flags = 1 << UDC_IS_ENABLED;
+	hudc->udc.speed = USB_SPEED_UNKNOWN;
+	hudc->next_ep = 1;
+	workqueue_task_init(&hudc->task, host_udc_worker);
+	host_event_init(&hudc->bus_event, host_udc_bus_event);
+
+	return &hudc->udc;
+}
+
+//! @}
@@ -0,0 +1,5 @@
+usb-src-$(CONFIG_UDC)	+= host_udc/host_udc.c
+
+hdr-$(CONFIG_UDC)       += include/usb/udc_host.h
+
+mkfiles			+= $(src)/drivers/usb/host_udc/subdir.mk
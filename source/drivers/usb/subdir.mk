@@ -1,5 +1,6 @@
 usb-subdir-y				+= $(src)/drivers/usb/core
 usb-subdir-$(CONFIG_AT90USB)		+= $(src)/drivers/usb/at90usb
+usb-subdir-$(CONFIG_HOST_UDC)		+= $(src)/drivers/usb/host_udc
 usb-subdir-$(CONFIG_UDC)		+= $(src)/drivers/usb/udi
 usb-subdir-$(CONFIG_USBB)		+= $(src)/drivers/usb/usbb
 
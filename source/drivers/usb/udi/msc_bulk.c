@@ -38,6 +38,9 @@
 #include <assert.h>
 #include <atomic.h>
 #include <byteorder.h>
+#ifdef CONFIG_UDI_MSC_CRC32
+# include <crc32.h>
+#endif
 #include <dmapool.h>
 #include <interrupt.h>
 #include <physmem.h>
@@ -66,17 +69,32 @@
 # define APP_UDI_MSC_FS_BULK_EP_SIZE	64
 #endif
 
-#define MSC_DATA_BUFFER_SIZE	CONFIG_DMAPOOL_LARGE_OBJ_SIZE
-#define MSC_MAX_NR_BUFFERS	(CONFIG_DMAPOOL_NR_LARGE_OBJS / 2)
-#define MSC_MAX_DATA_LEN	(MSC_MAX_NR_BUFFERS * MSC_DATA_BUFFER_SIZE)
+//! Physical memory pool holding the MSC data buffers.
+#ifndef APP_UDI_MSC_BUF_PHYSMEM_POOL
+# define APP_UDI_MSC_BUF_PHYSMEM_POOL	dma_sram_pool
+#endif
+
+//! Size of each MSC data buffer. Must be a multiple of the block size.
+#ifndef CONFIG_UDI_MSC_BUFFER_SIZE
+# define CONFIG_UDI_MSC_BUFFER_SIZE	CONFIG_DMAPOOL_LARGE_OBJ_SIZE
+#endif
+
+//! Number of buffers in the MSC data buffer pool.
+#ifndef CONFIG_UDI_MSC_NR_BUFFERS
+# define CONFIG_UDI_MSC_NR_BUFFERS	2
+#endif
+
+//! Number of buffer segments kept in flight during READ and WRITE.
+#ifndef CONFIG_UDI_MSC_PIPELINE_DEPTH
+# define CONFIG_UDI_MSC_PIPELINE_DEPTH	2
+#endif
+
+#define MSC_DATA_BUFFER_SIZE	CONFIG_UDI_MSC_BUFFER_SIZE
 
 /* Convert endpoint indexes to endpoint addresses */
 #define MSC_BULK_IN_EP_ADDR		(APP_UDI_MSC_BULK_IN_EP | USB_DIR_IN)
 #define MSC_BULK_OUT_EP_ADDR		(APP_UDI_MSC_BULK_OUT_EP | USB_DIR_OUT)
 
-/// Maximum number of pending block buffer segments
-#define MSC_MAX_NR_SEGS	(2)
-
 /* The serial number may be at most 28 characters */
 #define MSC_VPD_SERIAL_BUF_SIZE	(MSC_MAX_SERIAL_LEN + SCSI_VPD_HEADER_SIZE)
 
@@ -120,6 +138,10 @@ struct msc_interface {
 	atomic_t		blk_blocks_pending;
 	//! Number of pending USB data requests
 	atomic_t		usb_reqs_pending;
+	//! Data buffers not used by any transfer
+	struct slist		free_bufs;
+	//! Number of buffers in \a free_bufs
+	unsigned int		nr_free_bufs;
 	//! The Command Block Wrapper
 	dma_addr_t		cbw;
 	//! The Command Status Wrapper
@@ -140,6 +162,10 @@ struct msc_interface {
 	bool			not_ready;
 	//! True if there's currently a block data transfer in progress
 	bool			xfer_in_progress;
+#ifdef CONFIG_UDI_MSC_CRC32
+	//! CRC-32 of the blocks read so far by #UDI_MSC_CMD_CRC32
+	uint32_t		crc;
+#endif
 };
 
 static inline struct msc_interface *msc_interface_of(
@@ -211,14 +237,54 @@ static struct usb_msc_csw *msc_get_csw(struct msc_interface *msc)
 	return msc->csw.ptr;
 }
 
-static void msc_free_dma_buf_list(struct slist *buf_list)
+/**
+ * \internal
+ * \brief Take a data buffer from the MSC buffer pool
+ *
+ * \return A buffer of #MSC_DATA_BUFFER_SIZE bytes, or NULL if all the
+ * buffers are in use.
+ */
+static struct buffer *msc_buf_alloc(struct msc_interface *msc)
 {
-	struct buffer	*buf;
+	struct buffer	*buf = NULL;
+	irqflags_t	iflags;
 
-	while (!slist_is_empty(buf_list)) {
-		buf = slist_pop_head(buf_list, struct buffer, node);
-		buffer_dma_free(buf, MSC_DATA_BUFFER_SIZE);
+	iflags = cpu_irq_save();
+	if (!slist_is_empty(&msc->free_bufs)) {
+		buf = slist_pop_head(&msc->free_bufs, struct buffer, node);
+		msc->nr_free_bufs--;
 	}
+	cpu_irq_restore(iflags);
+
+	if (buf)
+		buffer_resize(buf, MSC_DATA_BUFFER_SIZE);
+
+	return buf;
+}
+
+/**
+ * \internal
+ * \brief Return all the buffers in \a buf_list to the MSC buffer pool
+ */
+static void msc_free_buf_list(struct msc_interface *msc,
+		struct slist *buf_list)
+{
+	struct buffer	*buf;
+	unsigned int	nr_bufs = 0;
+	irqflags_t	iflags;
+
+	if (slist_is_empty(buf_list))
+		return;
+
+	for (buf = buf_list_peek_head(buf_list);
+			slist_node_is_valid(buf_list, &buf->node);
+			buf = buf_list_peek_next(buf))
+		nr_bufs++;
+
+	iflags = cpu_irq_save();
+	slist_move_to_tail(&msc->free_bufs, buf_list);
+	msc->nr_free_bufs += nr_bufs;
+	cpu_irq_restore(iflags);
 }
 
 /**
@@ -294,8 +360,8 @@ static void msc_prepare_csw(struct msc_interface *msc, uint32_t residue,
 	buf = usb_req_get_first_buffer(req);
 	buffer_init_tx(buf, csw, sizeof(struct usb_msc_csw));
 
-	dbg_verbose("msc: CSW t%08lx r%lu s%u\n", le32_to_cpu(csw->dCSWTag),
-			residue, status);
+	dbg_verbose("msc: CSW t%08lx r%lu s%u\n", (unsigned long)le32_to_cpu(csw->dCSWTag),
+			(unsigned long)residue, status);
 }
 
 static void msc_request_data_done(struct udc *udc, struct msc_interface *msc)
@@ -314,8 +380,8 @@ static void msc_request_data_done(struct udc *udc, struct msc_interface *msc)
 	}
 
 	dbg_verbose("msc data done: t%08lx r%lu s%u %s\n",
-			le32_to_cpu(csw->dCSWTag),
-			le32_to_cpu(csw->dCSWDataResidue),
+			(unsigned long)le32_to_cpu(csw->dCSWTag),
+			(unsigned long)le32_to_cpu(csw->dCSWDataResidue),
 			csw->bCSWStatus,
 			(msc_get_cbw(msc)->bmCBWFlags & USB_CBW_DIRECTION_IN)
 			? "IN" : "OUT");
@@ -372,7 +438,8 @@ static void msc_phase_error(struct msc_interface *msc)
 	dbg_error("msc: Phase Error (opcode %02x)\n",
 			scsi_cdb_get_opcode(cbw->CDB));
 	dbg_verbose("msc:   CBW bmCBWFlags = 0x%02x\n", cbw->bmCBWFlags);
-	dbg_verbose("msc:   CBW dCBWDataTransferLength = 0x%lx\n", cbw_xfer_len);
+	dbg_verbose("msc:   CBW dCBWDataTransferLength = 0x%lx\n",
+			(unsigned long)cbw_xfer_len);
 
 	msc_prepare_csw(msc, cbw_xfer_len, USB_CSW_STATUS_PE);
 	msc_request_done_nodata(msc->udc, msc, cbw_xfer_len);
@@ -519,7 +586,8 @@ static long msc_validate_req(struct msc_interface *msc, struct usb_msc_cbw *cbw,
 static void msc_test_unit_ready(struct msc_interface *msc, struct udc *udc,
 		uint32_t cbw_data_len)
 {
-	dbg_verbose("msc TEST UNIT READY len %lu\n", cbw_data_len);
+	dbg_verbose("msc TEST UNIT READY len %lu\n",
+			(unsigned long)cbw_data_len);
 
 	if (msc->not_ready) {
 		msc_request_failed(msc, cbw_data_len, USB_CSW_STATUS_FAIL,
@@ -879,7 +947,7 @@ static void msc_mode_sense(struct msc_interface *msc, struct udc *udc,
 	dbg_verbose("msc MODE SENSE(N) page %u PC%u len %lu\n",
 			scsi_mode_sense_get_page_code(cdb),
 			scsi_mode_sense_get_pc(cdb),
-			alloc_len);
+			(unsigned long)alloc_len);
 
 	residue = msc_validate_req(msc, cbw, alloc_len, USB_CBW_DIRECTION_IN);
 	if (residue < 0)
@@ -987,7 +1055,7 @@ static void msc_read_capacity(struct msc_interface *msc, struct udc *udc,
 	build_assert(sizeof(*response) == 8);
 
 	dbg_verbose("msc READ CAPACITY LBA %lx blklen %u\n",
-			msc->bdev->nr_blocks - 1,
+			(unsigned long)(msc->bdev->nr_blocks - 1),
 			blkdev_get_block_size(msc->bdev));
 
 	residue = msc_validate_req(msc, cbw, 8, USB_CBW_DIRECTION_IN);
@@ -1021,20 +1089,21 @@ err_req_alloc:
 	msc_out_of_memory(msc);
 }
 
-static uint32_t msc_fill_buffer_list(struct slist *buf_list,
-		unsigned int block_size, uint32_t nr_blocks)
+static uint32_t msc_fill_buffer_list(struct msc_interface *msc,
+		struct slist *buf_list, unsigned int block_size,
+		uint32_t nr_blocks, unsigned int nr_bufs)
 {
 	uint32_t		blocks_remaining;
 	uint32_t		blocks_per_buf;
-	uint_fast8_t		i;
+	unsigned int		i;
 
 	blocks_remaining = nr_blocks;
 	blocks_per_buf = MSC_DATA_BUFFER_SIZE / block_size;
 
-	for (i = 0; i < MSC_MAX_NR_BUFFERS; i++) {
+	for (i = 0; i < nr_bufs; i++) {
 		struct buffer		*buf;
 
-		buf = buffer_dma_alloc(MSC_DATA_BUFFER_SIZE);
+		buf = msc_buf_alloc(msc);
 		if (!buf)
 			break;
 
@@ -1052,13 +1121,47 @@ static uint32_t msc_fill_buffer_list(struct slist *buf_list,
 	return nr_blocks - blocks_remaining;
 }
 
+/**
+ * \internal
+ * \brief Decide how many buffers to use for the next pipeline segment
+ *
+ * The buffer pool is split into #CONFIG_UDI_MSC_PIPELINE_DEPTH segments,
+ * so that one segment can be moved over USB while the block device is
+ * working on the others. Transfers which don't fill the whole pipeline,
+ * including the tail of longer transfers, are spread over all the
+ * segments instead so that they are pipelined as well.
+ *
+ * \pre Interrupts are disabled.
+ *
+ * \return The number of buffers to use for the next segment, or 0 if the
+ * segment has to wait until more buffers are freed.
+ */
+static unsigned int msc_next_seg_bufs(struct msc_interface *msc,
+		unsigned int block_size, uint32_t blocks_remaining)
+{
+	uint32_t	bufs_needed;
+	unsigned int	seg_bufs;
+
+	bufs_needed = div_ceil(blocks_remaining,
+			MSC_DATA_BUFFER_SIZE / block_size);
+	seg_bufs = CONFIG_UDI_MSC_NR_BUFFERS / CONFIG_UDI_MSC_PIPELINE_DEPTH;
+	seg_bufs = min_u(seg_bufs,
+			div_ceil(bufs_needed, CONFIG_UDI_MSC_PIPELINE_DEPTH));
+	seg_bufs = max_u(seg_bufs, 1);
+
+	if (msc->nr_free_bufs < seg_bufs)
+		return 0;
+
+	return seg_bufs;
+}
+
 /**
  * \internal
  *
  * Submit a list of buffers for storing data read from the block device.
  * We will stop submitting buffers when
  *   - we have submitted enough to store all the data we intend to read, or
- *   - we have reached the maximum amount of data for a single buffer list, or
+ *   - we have submitted \a nr_bufs buffers, or
  *   - there's no more buffer memory available, or
  *   - the request was ended prematurely
  *
@@ -1066,17 +1169,18 @@ static uint32_t msc_fill_buffer_list(struct slist *buf_list,
  */
 static int msc_submit_read_buffers(struct msc_interface *msc,
 		struct block_device *bdev, struct block_request *breq,
-		uint32_t nr_blocks)
+		uint32_t nr_blocks, unsigned int nr_bufs)
 {
 	struct slist		buf_list;
 	uint32_t		blocks_queued;
 
 	slist_init(&buf_list);
-	blocks_queued = msc_fill_buffer_list(&buf_list,
-				blkdev_get_block_size(bdev), nr_blocks);
+	blocks_queued = msc_fill_buffer_list(msc, &buf_list,
+				blkdev_get_block_size(bdev), nr_blocks,
+				nr_bufs);
 
-	dbg_verbose("msc: blocks %lu/%lu queued for read\n", blocks_queued,
-			nr_blocks);
+	dbg_verbose("msc: blocks %lu/%lu queued for read\n",
+			(unsigned long)blocks_queued, (unsigned long)nr_blocks);
 
 	if (unlikely(!blocks_queued))
 		return 0;
@@ -1088,7 +1192,7 @@ static int msc_submit_read_buffers(struct msc_interface *msc,
 	atomic_add(&msc->blk_blocks_pending, blocks_queued);
 	if (block_submit_buf_list(bdev, breq, &buf_list)) {
 		atomic_sub(&msc->blk_blocks_pending, blocks_queued);
-		msc_free_dma_buf_list(&buf_list);
+		msc_free_buf_list(msc, &buf_list);
 		return 0;
 	}
 
@@ -1105,38 +1209,45 @@ static int msc_submit_read_buffers(struct msc_interface *msc,
  *   - The block device has started processing our request
  *
  * The function will then try to keep both the block device and the USB
- * controller as busy as possible by submitting new requests and buffer
- * lists.
+ * controller as busy as possible by submitting new buffer lists to the
+ * block device for as long as there are buffers for another pipeline
+ * segment.
  */
 static void msc_read_worker(struct msc_interface *msc)
 {
 	struct block_device	*bdev = msc->bdev;
 	struct block_request	*breq = msc->block_req;
+	unsigned int		block_size;
 	uint32_t		blocks_remaining;
 	uint32_t		submitted;
-	uint32_t		blocks_per_seg;
+	unsigned int		seg_bufs;
+
+	block_size = blkdev_get_block_size(bdev);
 
 	cpu_irq_disable();
-	dbg_verbose("msc: blk pending %u locked %d\n",
+	dbg_verbose("msc: blk pending %u free %u locked %d\n",
 			atomic_read(&msc->blk_blocks_pending),
-			msc->queue_locked);
-	blocks_per_seg = MSC_DATA_BUFFER_SIZE / blkdev_get_block_size(bdev);
-	while ((atomic_read(&msc->blk_blocks_pending) * blocks_per_seg)
-			< MSC_MAX_NR_SEGS
-			&& !msc->queue_locked) {
+			msc->nr_free_bufs, msc->queue_locked);
+	while (!msc->queue_locked) {
 		dbg_verbose("msc: read worker: q%lu <= t%lu s %d\n",
-				msc->blocks_queued, msc->blocks_total,
+				(unsigned long)msc->blocks_queued,
+				(unsigned long)msc->blocks_total,
 				breq->status);
 		assert(msc->blocks_queued <= msc->blocks_total);
 		blocks_remaining = msc->blocks_total - msc->blocks_queued;
 		if (!blocks_remaining)
 			break;
 
+		seg_bufs = msc_next_seg_bufs(msc, block_size,
+				blocks_remaining);
+		if (!seg_bufs)
+			break;
+
 		msc->queue_locked = true;
 		cpu_irq_enable();
 
 		submitted = msc_submit_read_buffers(msc, bdev, breq,
-				blocks_remaining);
+				blocks_remaining, seg_bufs);
 
 		cpu_irq_disable();
 		msc->queue_locked = false;
@@ -1159,7 +1270,7 @@ static void msc_read_data_sent(struct udc *udc, struct usb_request *req)
 			slist_peek_head_node(&req->buf_list),
 			slist_peek_tail_node(&req->buf_list));
 
-	msc_free_dma_buf_list(&req->buf_list);
+	msc_free_buf_list(msc, &req->buf_list);
 	status = req->status;
 	usb_req_free(req);
 
@@ -1216,7 +1327,7 @@ static void msc_block_read_done(struct block_device *bdev,
 		blocks_xfered = blk_req_get_blocks_xfered(bdev, breq);
 
 		dbg_warning("msc: block read failed: %d (after %lu blocks)\n",
-				breq->status, blocks_xfered);
+				breq->status, (unsigned long)blocks_xfered);
 
 		cbw = msc_get_cbw(msc);
 		residue = le32_to_cpu(cbw->dCBWDataTransferLength);
@@ -1246,14 +1357,14 @@ static void msc_block_read_buffers_done(struct block_device *bdev,
 
 	if (breq->status != OPERATION_IN_PROGRESS || !msc->bulk_in_ep) {
 		dbg_verbose("  request terminated, discarding buffers\n");
-		msc_free_dma_buf_list(buf_list);
+		msc_free_buf_list(msc, buf_list);
 		return;
 	}
 
 	req = usb_req_alloc();
 	if (!req) {
 		block_abort_req(bdev, breq);
-		msc_free_dma_buf_list(buf_list);
+		msc_free_buf_list(msc, buf_list);
 		msc_out_of_memory(msc);
 		return;
 	}
@@ -1291,9 +1402,11 @@ static void msc_do_read(struct msc_interface *msc, struct udc *udc,
 	long			residue;
 	uint32_t		cdb_data_len;
 	uint32_t		blocks_queued;
+	unsigned int		seg_bufs;
 	irqflags_t		iflags;
 
-	dbg_verbose("msc READ(x) %lu blocks, LBA %lu\n", nr_blocks, lba);
+	dbg_verbose("msc READ(x) %lu blocks, LBA %lu\n",
+			(unsigned long)nr_blocks, (unsigned long)lba);
 
 	assert(!msc->xfer_in_progress);
 
@@ -1342,7 +1455,17 @@ static void msc_do_read(struct msc_interface *msc, struct udc *udc,
 	breq->context = msc;
 	block_queue_req(bdev, breq, lba, nr_blocks, BLK_OP_READ);
 
-	blocks_queued = msc_submit_read_buffers(msc, bdev, breq, nr_blocks);
+	/*
+	 * Only the first segment is submitted here; the rest of the
+	 * pipeline is filled once the block device has started.
+	 */
+	iflags = cpu_irq_save();
+	seg_bufs = msc_next_seg_bufs(msc, blkdev_get_block_size(bdev),
+			nr_blocks);
+	cpu_irq_restore(iflags);
+
+	blocks_queued = msc_submit_read_buffers(msc, bdev, breq, nr_blocks,
+			seg_bufs);
 	if (blocks_queued == 0) {
 		block_abort_req(bdev, breq);
 		msc_out_of_memory(msc);
@@ -1358,13 +1481,14 @@ static void msc_write_data_received(struct udc *udc, struct usb_request *req);
  * Submit a USB OUT request for receiving data to be written to the
  * block device. We will add buffers to the request until
  *   - we have submitted enough to receive all the data we intend to write, or
- *   - we have reached the maximum amount of data for a single buffer list, or
+ *   - we have added \a nr_bufs buffers, or
  *   - there's no more buffer memory available
  *
  * \return The number of blocks covered by the submitted request
  */
 static int msc_submit_write_data_req(struct msc_interface *msc,
-		struct block_device *bdev, uint32_t nr_blocks)
+		struct block_device *bdev, uint32_t nr_blocks,
+		unsigned int nr_bufs)
 {
 	struct usb_request	*req;
 	uint32_t		blocks_queued;
@@ -1376,11 +1500,12 @@ static int msc_submit_write_data_req(struct msc_interface *msc,
 	req->context = msc;
 	req->req_done = msc_write_data_received;
 
-	blocks_queued = msc_fill_buffer_list(&req->buf_list,
-				blkdev_get_block_size(bdev), nr_blocks);
+	blocks_queued = msc_fill_buffer_list(msc, &req->buf_list,
+				blkdev_get_block_size(bdev), nr_blocks,
+				nr_bufs);
 
-	dbg_verbose("msc: blocks %lu/%lu queued for write\n", blocks_queued,
-			nr_blocks);
+	dbg_verbose("msc: blocks %lu/%lu queued for write\n",
+			(unsigned long)blocks_queued, (unsigned long)nr_blocks);
 
 	if (unlikely(!blocks_queued)) {
 		usb_req_free(req);
@@ -1403,31 +1528,42 @@ static int msc_submit_write_data_req(struct msc_interface *msc,
  *   - The block device is done processing one buffer list
  *
  * The function will then try to keep both the block device and the USB
- * controller as busy as possible by submitting new requests and buffer
- * lists.
+ * controller as busy as possible by submitting new OUT requests for as
+ * long as there are buffers for another pipeline segment.
  */
 static void msc_write_worker(void *data)
 {
 	struct msc_interface	*msc = data;
 	struct block_device	*bdev = msc->bdev;
+	unsigned int		block_size;
 	uint32_t		blocks_remaining;
 	uint32_t		submitted;
+	unsigned int		seg_bufs;
+	irqflags_t		iflags;
+
+	block_size = blkdev_get_block_size(bdev);
 
-	while (atomic_read(&msc->usb_reqs_pending) < MSC_MAX_NR_SEGS
-			&& !msc->queue_locked) {
-		dbg_verbose("msc: write worker: q%lu <= 5%lu s %d\n",
-				msc->blocks_queued, msc->blocks_total,
+	iflags = cpu_irq_save();
+	while (!msc->queue_locked) {
+		dbg_verbose("msc: write worker: q%lu <= t%lu s %d\n",
+				(unsigned long)msc->blocks_queued,
+				(unsigned long)msc->blocks_total,
 				msc->block_req->status);
 		assert(msc->blocks_queued <= msc->blocks_total);
 		blocks_remaining = msc->blocks_total - msc->blocks_queued;
 		if (!blocks_remaining)
 			break;
 
+		seg_bufs = msc_next_seg_bufs(msc, block_size,
+				blocks_remaining);
+		if (!seg_bufs)
+			break;
+
 		msc->queue_locked = true;
 		cpu_irq_enable();
 
 		submitted = msc_submit_write_data_req(msc, bdev,
-				blocks_remaining);
+				blocks_remaining, seg_bufs);
 
 		cpu_irq_disable();
 		msc->queue_locked = false;
@@ -1435,6 +1571,7 @@ static void msc_write_worker(void *data)
 		if (!submitted)
 			break;
 	}
+	cpu_irq_restore(iflags);
 }
 
 static void msc_block_write_started(struct block_device *bdev,
@@ -1464,7 +1601,7 @@ static void msc_block_write_done(struct block_device *bdev,
 		blocks_xfered = blk_req_get_blocks_xfered(bdev, breq);
 
 		dbg_warning("msc: block write failed: %d (after %lu blocks)\n",
-				breq->status, blocks_xfered);
+				breq->status, (unsigned long)blocks_xfered);
 
 		cbw = msc_get_cbw(msc);
 		residue = le32_to_cpu(cbw->dCBWDataTransferLength);
@@ -1488,8 +1625,6 @@ static void msc_block_write_buffers_done(struct block_device *bdev,
 	struct buffer		*buf;
 	uint32_t		nr_blocks;
 
-	msc_free_dma_buf_list(buf_list);
-
 	assert(atomic_read(&msc->blk_blocks_pending) > 0);
 
 	for (nr_blocks = 0, buf = buf_list_peek_head(buf_list);
@@ -1499,6 +1634,8 @@ static void msc_block_write_buffers_done(struct block_device *bdev,
 	}
 	atomic_sub(&msc->blk_blocks_pending, nr_blocks);
 
+	msc_free_buf_list(msc, buf_list);
+
 	assert(msc->blocks_queued <= msc->blocks_total);
 	if (msc->blocks_queued < msc->blocks_total)
 		msc_write_worker(msc);
@@ -1534,7 +1671,7 @@ static void msc_write_data_received(struct udc *udc, struct usb_request *req)
 
 		if (block_submit_buf_list(bdev, breq, &buf_list)) {
 			atomic_sub(&msc->blk_blocks_pending, nr_blocks);
-			msc_free_dma_buf_list(&buf_list);
+			msc_free_buf_list(msc, &buf_list);
 		}
 	} else {
 		block_abort_req(bdev, breq);
@@ -1549,9 +1686,11 @@ static void msc_do_write(struct msc_interface *msc, struct udc *udc,
 	long			residue;
 	uint32_t		cdb_data_len;
 	uint32_t		blocks_queued;
+	unsigned int		seg_bufs;
 	irqflags_t		iflags;
 
-	dbg_verbose("msc WRITE(x) %lu blocks, LBA %lu\n", nr_blocks, lba);
+	dbg_verbose("msc WRITE(x) %lu blocks, LBA %lu\n",
+			(unsigned long)nr_blocks, (unsigned long)lba);
 
 	assert(!msc->xfer_in_progress);
 
@@ -1599,7 +1738,13 @@ static void msc_do_write(struct msc_interface *msc, struct udc *udc,
 	breq->context = msc;
 	block_queue_req(bdev, breq, lba, nr_blocks, BLK_OP_WRITE);
 
-	blocks_queued = msc_submit_write_data_req(msc, bdev, nr_blocks);
+	iflags = cpu_irq_save();
+	seg_bufs = msc_next_seg_bufs(msc, blkdev_get_block_size(bdev),
+			nr_blocks);
+	cpu_irq_restore(iflags);
+
+	blocks_queued = msc_submit_write_data_req(msc, bdev, nr_blocks,
+			seg_bufs);
 	if (blocks_queued == 0) {
 		block_abort_req(bdev, breq);
 		msc_out_of_memory(msc);
@@ -1609,7 +1754,11 @@ static void msc_do_write(struct msc_interface *msc, struct udc *udc,
 
 static void msc_verify_read(struct msc_interface *msc,
 		struct block_device *bdev, uint32_t first_lba,
-		uint32_t nr_blocks);
+		uint32_t nr_blocks,
+		void (*req_done)(struct block_device *bdev,
+			struct block_request *breq),
+		void (*buf_list_done)(struct block_device *bdev,
+			struct block_request *breq, struct slist *buf_list));
 static void msc_verify_bytchk(struct msc_interface *msc,
 		struct block_device *bdev, uint32_t first_lba,
 		uint32_t nr_blocks);
@@ -1682,17 +1831,28 @@ static void msc_verify_read_buffers_done(struct block_device *bdev,
 
 	if (!slist_is_empty(&new_buf_list)) {
 		if (block_submit_buf_list(bdev, breq, &new_buf_list))
-			msc_free_dma_buf_list(&new_buf_list);
+			msc_free_buf_list(msc, &new_buf_list);
 		else
 			msc->blocks_queued = blocks_queued;
 	}
 
 	/* Free whatever is left over from the loop above */
-	msc_free_dma_buf_list(buf_list);
+	msc_free_buf_list(msc, buf_list);
 }
 
+/**
+ * \internal
+ *
+ * Read blocks from the block device without sending them anywhere.
+ * \a buf_list_done gets to look at the data before the buffers are
+ * reused, and must pass them on to msc_verify_read_buffers_done().
+ */
 static void msc_verify_read(struct msc_interface *msc, struct block_device *bdev,
-		uint32_t first_lba, uint32_t nr_blocks)
+		uint32_t first_lba, uint32_t nr_blocks,
+		void (*req_done)(struct block_device *bdev,
+			struct block_request *breq),
+		void (*buf_list_done)(struct block_device *bdev,
+			struct block_request *breq, struct slist *buf_list))
 {
 	struct slist		buf_list;
 	struct block_request	*breq;
@@ -1705,15 +1865,16 @@ static void msc_verify_read(struct msc_interface *msc, struct block_device *bdev
 	msc->blocks_total = nr_blocks;
 	breq = msc->block_req;
 	breq->req_started = NULL;
-	breq->req_done = msc_verify_read_done;
-	breq->buf_list_done = msc_verify_read_buffers_done;
+	breq->req_done = req_done;
+	breq->buf_list_done = buf_list_done;
 	breq->context = msc;
 	block_queue_req(bdev, breq, first_lba, nr_blocks, BLK_OP_READ);
 
 	slist_init(&buf_list);
 
-	blocks_queued = msc_fill_buffer_list(&buf_list,
-				blkdev_get_block_size(bdev), nr_blocks);
+	blocks_queued = msc_fill_buffer_list(msc, &buf_list,
+				blkdev_get_block_size(bdev), nr_blocks,
+				CONFIG_UDI_MSC_NR_BUFFERS);
 
 	if (unlikely(blocks_queued == 0)) {
 		block_abort_req(bdev, breq);
@@ -1724,7 +1885,7 @@ static void msc_verify_read(struct msc_interface *msc, struct block_device *bdev
 	msc->blocks_queued = blocks_queued;
 	if (block_submit_buf_list(bdev, breq, &buf_list)) {
 		block_abort_req(bdev, breq);
-		msc_free_dma_buf_list(&buf_list);
+		msc_free_buf_list(msc, &buf_list);
 		msc_out_of_memory(msc);
 	}
 }
@@ -1738,7 +1899,8 @@ static void msc_do_verify(struct msc_interface *msc, struct udc *udc,
 	uint32_t		cdb_data_len = 0;
 	irqflags_t		iflags;
 
-	dbg_verbose("msc VERIFY(x) %lu blocks, LBA %lu\n", nr_blocks, lba);
+	dbg_verbose("msc VERIFY(x) %lu blocks, LBA %lu\n",
+			(unsigned long)nr_blocks, (unsigned long)lba);
 
 	/* Only expect to transfer data when doing byte checking */
 	if (bytchk)
@@ -1772,8 +1934,139 @@ static void msc_do_verify(struct msc_interface *msc, struct udc *udc,
 	if (bytchk)
 		msc_verify_bytchk(msc, bdev, lba, nr_blocks);
 	else
-		msc_verify_read(msc, bdev, lba, nr_blocks);
+		msc_verify_read(msc, bdev, lba, nr_blocks,
+				msc_verify_read_done,
+				msc_verify_read_buffers_done);
+}
+
+#ifdef CONFIG_UDI_MSC_CRC32
+static void msc_crc32_sent(struct udc *udc, struct usb_request *req)
+{
+	struct buffer		*buf;
+
+	buf = usb_req_get_first_buffer(req);
+	buffer_dma_free(buf, sizeof(be32_t));
+	msc_data_sent(udc, req);
+}
+
+static void msc_crc32_send(struct msc_interface *msc, struct udc *udc)
+{
+	struct usb_request	*req;
+	struct buffer		*buf;
+
+	req = usb_req_alloc();
+	if (!req)
+		goto err_req_alloc;
+	req->req_done = msc_crc32_sent;
+	req->context = msc;
+
+	buf = buffer_dma_alloc(sizeof(be32_t));
+	if (!buf)
+		goto err_buf_alloc;
+	usb_req_add_buffer(req, buf);
+
+	*(be32_t *)buf->addr.ptr = cpu_to_be32(msc->crc);
+
+	udc_ep_submit_in_req(udc, msc->bulk_in_ep, req);
+	msc_request_done(udc, msc,
+			le32_to_cpu(msc_get_csw(msc)->dCSWDataResidue));
+
+	return;
+
+err_buf_alloc:
+	usb_req_free(req);
+err_req_alloc:
+	msc_out_of_memory(msc);
+}
+
+static void msc_crc32_read_done(struct block_device *bdev,
+		struct block_request *breq)
+{
+	struct msc_interface	*msc = breq->context;
+	struct usb_msc_csw	*csw = msc_get_csw(msc);
+
+	assert(breq == msc->block_req);
+
+	if (breq->status) {
+		uint32_t	blocks_xfered;
+
+		blocks_xfered = blk_req_get_blocks_xfered(bdev, breq);
+
+		/* No data is sent, so the whole transfer is residue */
+		csw->dCSWDataResidue = msc_get_cbw(msc)->dCBWDataTransferLength;
+		csw->bCSWStatus = USB_CSW_STATUS_FAIL;
+		msc_init_sense(msc, SCSI_SK_MEDIUM_ERROR,
+				SCSI_ASC_UNRECOVERED_READ_ERROR,
+				msc->first_lba + blocks_xfered);
+		msc_request_done_nodata(msc->udc, msc,
+				le32_to_cpu(csw->dCSWDataResidue));
+		return;
+	}
+
+	dbg_verbose("msc CRC32 %08lx\n", (unsigned long)msc->crc);
+	msc_crc32_send(msc, msc->udc);
+}
+
+static void msc_crc32_read_buffers_done(struct block_device *bdev,
+		struct block_request *breq, struct slist *buf_list)
+{
+	struct msc_interface	*msc = breq->context;
+	struct buffer		*buf;
+
+	for (buf = buf_list_peek_head(buf_list);
+			slist_node_is_valid(buf_list, &buf->node);
+			buf = buf_list_peek_next(buf))
+		msc->crc = crc32_update(msc->crc, buf->addr.ptr, buf->len);
+
+	msc_verify_read_buffers_done(bdev, breq, buf_list);
+}
+
+/**
+ * \internal
+ * \brief Handle the vendor-specific #UDI_MSC_CMD_CRC32 command
+ *
+ * The blocks are read just like for VERIFY without BYTCHK, and the
+ * CRC-32 of their contents is sent back as a 4-byte big-endian value.
+ */
+static void msc_do_crc32(struct msc_interface *msc, struct udc *udc,
+		struct usb_msc_cbw *cbw, uint32_t lba, uint32_t nr_blocks)
+{
+	long			residue;
+	irqflags_t		iflags;
+
+	dbg_verbose("msc CRC32 %lu blocks, LBA %lu\n",
+			(unsigned long)nr_blocks, (unsigned long)lba);
+
+	residue = msc_validate_req(msc, cbw, sizeof(be32_t),
+			USB_CBW_DIRECTION_IN);
+	if (unlikely(residue < 0))
+		return;
+
+	iflags = cpu_irq_save();
+	if (msc->not_ready) {
+		cpu_irq_restore(iflags);
+		msc_request_failed(msc,
+				le32_to_cpu(cbw->dCBWDataTransferLength),
+				USB_CSW_STATUS_FAIL,
+				SCSI_SK_NOT_READY, msc->busy_asc);
+		return;
+	}
+
+	msc->xfer_in_progress = true;
+	cpu_irq_restore(iflags);
+
+	msc_prepare_csw(msc, residue, USB_CSW_STATUS_PASS);
+
+	msc->crc = 0;
+	msc->first_lba = lba;
+	if (unlikely(nr_blocks == 0))
+		msc_crc32_send(msc, udc);
+	else
+		msc_verify_read(msc, msc->bdev, lba, nr_blocks,
+				msc_crc32_read_done,
+				msc_crc32_read_buffers_done);
 }
+#endif /* CONFIG_UDI_MSC_CRC32 */
 
 static void msc_cbw_received(struct udc *udc, struct usb_request *req)
 {
@@ -1861,6 +2154,13 @@ static void msc_cbw_received(struct udc *udc, struct usb_request *req)
 				scsi_cdb10_get_alloc_len(cbw->CDB));
 		break;
 
+#ifdef CONFIG_UDI_MSC_CRC32
+	case UDI_MSC_CMD_CRC32:
+		msc_do_crc32(msc, udc, cbw, scsi_cdb10_get_lba(cbw->CDB),
+				scsi_cdb10_get_xfer_len(cbw->CDB));
+		break;
+#endif
+
 	default:
 		dbg_verbose("MSC: Unhandled opcode %02x\n", opcode);
 
@@ -2245,14 +2545,44 @@ static struct msc_interface msc_interface = {
 	.iface.free_descriptor		= udi_msc_free_descriptor,
 };
 
+//! DMA memory backing the MSC data buffers
+static struct dma_pool msc_buf_pool;
+//! The MSC data buffers, each permanently attached to a chunk of memory
+static struct buffer msc_data_buf[CONFIG_UDI_MSC_NR_BUFFERS];
+
 struct udm_interface *udi_msc_create_iface(struct block_device *bdev)
 {
 	struct msc_interface	*msc = &msc_interface;
+	unsigned int		i;
 
 	msc->bdev = bdev;
 
 	build_assert(CONFIG_DMAPOOL_SMALL_OBJ_SIZE % 4 == 0);
 	build_assert(MSC_DATA_BUFFER_SIZE % 512 == 0);
+	build_assert(CONFIG_UDI_MSC_PIPELINE_DEPTH >= 1);
+	build_assert(CONFIG_UDI_MSC_PIPELINE_DEPTH
+			<= CONFIG_UDI_MSC_NR_BUFFERS);
+	/* Each buffer may be in a USB request of its own, plus the CBW */
+	build_assert(APP_USB_NR_REQUESTS > CONFIG_UDI_MSC_NR_BUFFERS);
+
+	/*
+	 * The data buffers are set aside once and for all, so READ and
+	 * WRITE never compete with other users of the generic DMA pools
+	 * and may be placed in a different (e.g. external) memory.
+	 */
+	dma_pool_init_coherent_physmem(&msc_buf_pool,
+			&APP_UDI_MSC_BUF_PHYSMEM_POOL,
+			CONFIG_UDI_MSC_NR_BUFFERS, MSC_DATA_BUFFER_SIZE,
+			CPU_DMA_ALIGN);
+	slist_init(&msc->free_bufs);
+	for (i = 0; i < CONFIG_UDI_MSC_NR_BUFFERS; i++) {
+		struct buffer	*buf = &msc_data_buf[i];
+
+		buffer_init_rx_mapped(buf, dma_pool_alloc(&msc_buf_pool),
+				MSC_DATA_BUFFER_SIZE);
+		slist_insert_tail(&msc->free_bufs, &buf->node);
+	}
+	msc->nr_free_bufs = CONFIG_UDI_MSC_NR_BUFFERS;
 
 	msc->sense_data = dma_alloc(32);
 	msc_init_sense(msc, SCSI_SK_NO_SENSE,
@@ -0,0 +1,67 @@
+/**
+ * \file
+ *
+ * \brief File-backed block device for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef BLOCK_HOST_FILE_H_INCLUDED
+#define BLOCK_HOST_FILE_H_INCLUDED
+
+#include <workqueue.h>
+#include <block/device.h>
+
+/**
+ * \defgroup block_device_host_file_group Host File Block Device
+ * \ingroup block_device_group
+ *
+ * This is a block device driver which stores its blocks in a regular file
+ * on the host, typically an image of the storage used on the target, e.g.
+ * the DataFlash contents. It allows file systems and applications using
+ * block devices to run natively on the build machine.
+ *
+ * The file named by the environment variable \c HOST_BLOCK_FILE is used
+ * instead of the path given to host_file_blkdev_init() if it is set.
+ * Setting \c HOST_BLOCK_LATENCY to a number of microseconds makes each
+ * block take that long on the virtual clock, e.g. to measure how well a
+ * client overlaps its own work with slow storage like DataFlash.
+ *
+ * @{
+ */
+
+struct block_device *host_file_blkdev_init(const char *path,
+		struct workqueue_task *event_task);
+
+//! @}
+
+#endif /* BLOCK_HOST_FILE_H_INCLUDED */
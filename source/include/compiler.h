@@ -259,6 +259,17 @@
 # define is_constant(exp) (0)
 #endif
 
+/**
+ * \def compiler_return_address()
+ * \brief Return address of the current function, i.e., the address in
+ * its caller which execution will return to.
+ *
+ * \return The return address, or NULL if not supported by the compiler.
+ */
+#ifndef compiler_return_address
+# define compiler_return_address() ((void *)0)
+#endif
+
 //! @}
 
 //! \name Top-level Directives
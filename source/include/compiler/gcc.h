@@ -41,6 +41,10 @@
 #define __noreturn __attribute__((noreturn))
 #define __must_check __attribute__((warn_unused_result))
 #define __used __attribute__((used))
+
+/* The host C library may already provide its own variants of these */
+#undef __always_inline
+#undef __nonnull
 #define __always_inline inline __attribute__((always_inline))
 #define __nonnull(...) __attribute__((nonnull (__VA_ARGS__)))
 #define __printf_format(fmt_index, first_arg_index) \
@@ -53,6 +57,7 @@
 #define unlikely(exp)           __builtin_expect(!!(exp), 0)
 #define is_constant(exp)        __builtin_constant_p(exp)
 #define barrier()               asm volatile("" ::: "memory")
+#define compiler_return_address() __builtin_return_address(0)
 
 #if defined(__GNUC__)
 # if __NO_INLINE__
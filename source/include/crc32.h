@@ -0,0 +1,75 @@
+/**
+ * \file
+ *
+ * \brief CRC-32 checksum calculation
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef CRC32_H_INCLUDED
+#define CRC32_H_INCLUDED
+
+#include <types.h>
+
+/**
+ * \ingroup utility_group
+ * \defgroup crc32_group CRC-32 Checksums
+ *
+ * This module calculates the CRC-32 used by Ethernet, ZIP and PNG
+ * (polynomial 0x04c11db7, bit-reversed, with the CRC inverted before
+ * and after). The result is identical to that of \c zlib.crc32() in
+ * Python, so host-side tools can check data without any extra code.
+ *
+ * The calculation is table-driven, with the 1 KiB table in program
+ * memory, and processes one byte per table lookup.
+ *
+ * @{
+ */
+
+/**
+ * \brief Update a CRC-32 with more data
+ *
+ * To calculate the CRC of a single buffer, pass 0 as \a crc. To
+ * calculate the CRC of data split over several buffers, pass the
+ * return value of the previous call as \a crc for the next buffer.
+ *
+ * \param crc The CRC of the preceding data, or 0 to start a new CRC.
+ * \param data The data to be added to the CRC.
+ * \param len The number of bytes at \a data.
+ *
+ * \return The CRC of all the data so far.
+ */
+extern uint32_t crc32_update(uint32_t crc, const void *data, size_t len);
+
+//! @}
+
+#endif /* CRC32_H_INCLUDED */
@@ -0,0 +1,192 @@
+/**
+ * \file
+ *
+ * \brief Delayed work queue tasks
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef DELAYED_TASK_H_INCLUDED
+#define DELAYED_TASK_H_INCLUDED
+
+#include <assert.h>
+#include <compiler.h>
+#include <types.h>
+
+struct workqueue_task;
+
+/**
+ * \ingroup mainloop_group
+ * \defgroup delayed_task_group Delayed Tasks
+ *
+ * A delayed task adds a \ref workqueue_task "work queue task" to
+ * \ref main_workqueue once a given time has passed. This replaces busy
+ * polling, where a task keeps re-adding itself to the work queue until
+ * some condition becomes true, and keeps the CPU from sleeping while
+ * doing so.
+ *
+ * Each delayed task has a \a delay, the earliest time it may run, and a
+ * \a slack, how much later than that it may run without harm. All delayed
+ * tasks share the \ref timer_group "timer" \a CONFIG_DELAYED_TASK_TIMER_ID,
+ * whose alarm is set to the latest time at which the most urgent task
+ * must run. When the alarm triggers, all tasks whose delay has passed are
+ * added to the work queue, so tasks with enough slack are batched into a
+ * single wake-up. Tasks whose delay has passed are also added whenever
+ * the main loop runs out of work, since the CPU is awake anyway.
+ *
+ * The timer only runs while there are delayed tasks pending, so it does
+ * not cause any periodic wake-ups and does not keep the
+ * \ref sleepmgr_group "sleep manager" from entering deeper sleep modes
+ * when there is nothing to wait for.
+ *
+ * Times are given in timer ticks at \a CONFIG_DELAYED_TASK_RESOLUTION Hz,
+ * and can be converted from real time using DELAYED_TASK_US() and
+ * DELAYED_TASK_MS(). The sum of the delay and the slack must not exceed
+ * #DELAYED_TASK_MAX_TICKS.
+ *
+ * The application must call delayed_task_setup() before adding any
+ * delayed tasks.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_DELAYED_TASK_RESOLUTION
+ * \brief Resolution of the delayed task timer in Hz.
+ *
+ * The timer must be able to run at exactly this rate. The default gives a
+ * resolution of 32 us and a maximum delay of about one second.
+ */
+#ifndef CONFIG_DELAYED_TASK_RESOLUTION
+# define CONFIG_DELAYED_TASK_RESOLUTION 31250
+#endif
+
+//! Longest total time a delayed task may wait, in ticks.
+#define DELAYED_TASK_MAX_TICKS          0x7fff
+
+/**
+ * \brief Convert \a us microseconds to delayed task ticks, rounding up
+ *
+ * This is meant to be used with constant arguments only.
+ */
+#define DELAYED_TASK_US(us)                                             \
+	((uint16_t)(((uint64_t)(us) * CONFIG_DELAYED_TASK_RESOLUTION    \
+			+ 999999) / 1000000))
+
+/**
+ * \brief Convert \a ms milliseconds to delayed task ticks, rounding up
+ *
+ * This is meant to be used with constant arguments only.
+ */
+#define DELAYED_TASK_MS(ms)                                             \
+	((uint16_t)(((uint64_t)(ms) * CONFIG_DELAYED_TASK_RESOLUTION    \
+			+ 999) / 1000))
+
+/**
+ * \brief A work queue task to be run after a delay
+ *
+ * All fields are private.
+ */
+struct delayed_task {
+	//! Next pending delayed task.
+	struct delayed_task     *next;
+	//! The task to add to \ref main_workqueue.
+	struct workqueue_task   *task;
+	//! Earliest time to run, in timer ticks.
+	uint16_t                due;
+	//! Latest time to run, in timer ticks.
+	uint16_t                latest;
+	//! True if waiting for the delay to pass.
+	bool                    pending;
+};
+
+/**
+ * \brief Delayed task statistics
+ *
+ * These show how well the wake-ups are batched: the number of tasks
+ * queued from the alarm compared to the number of alarms, and the number
+ * of tasks queued without a wake-up of their own.
+ */
+struct delayed_task_stats {
+	//! Number of timer alarms.
+	uint16_t                nr_alarms;
+	//! Number of tasks queued from the timer alarm.
+	uint16_t                nr_alarm_tasks;
+	//! Number of tasks queued by delayed_task_poll().
+	uint16_t                nr_polled_tasks;
+};
+
+/**
+ * \brief Initialize a delayed task
+ *
+ * \param dtask The delayed task.
+ * \param task The work queue task to add to \ref main_workqueue when the
+ * delay has passed.
+ */
+static inline void delayed_task_init(struct delayed_task *dtask,
+		struct workqueue_task *task)
+{
+	dtask->task = task;
+	dtask->pending = false;
+}
+
+/**
+ * \brief Change the work queue task run by \a dtask
+ *
+ * \pre \a dtask is not pending.
+ */
+static inline void delayed_task_set_task(struct delayed_task *dtask,
+		struct workqueue_task *task)
+{
+	assert(!dtask->pending);
+	dtask->task = task;
+}
+
+/**
+ * \brief Return true if \a dtask is waiting for its delay to pass
+ */
+static inline bool delayed_task_is_pending(struct delayed_task *dtask)
+{
+	return dtask->pending;
+}
+
+extern void delayed_task_setup(void);
+extern void delayed_task_add(struct delayed_task *dtask, uint16_t delay,
+		uint16_t slack);
+extern void delayed_task_cancel(struct delayed_task *dtask);
+extern bool delayed_task_poll(void);
+extern void delayed_task_get_stats(struct delayed_task_stats *stats);
+extern void delayed_task_reset_stats(void);
+
+//! @}
+
+#endif /* DELAYED_TASK_H_INCLUDED */
@@ -40,6 +40,10 @@
 
 #include <flash/at45.h>
 
+#ifdef CONFIG_DELAYED_TASK
+#include <delayed_task.h>
+#endif
+
 /**
  * \defgroup at45_device_group AT45 DataFlash Device Driver
  *
@@ -56,13 +60,31 @@
  * Exclusive access must be ended with at45_release(). And this will start any
  * other pending requests, or set it available.
  *
+ * While the device is busy, at45_wait_ready() reads the status register
+ * over and over again. If \a CONFIG_DELAYED_TASK is defined, it instead
+ * waits \a CONFIG_AT45_POLL_INTERVAL microseconds between each read using
+ * a \ref delayed_task_group "delayed task", letting the CPU sleep or do
+ * other work in between.
+ *
  * @{
  */
 
+#ifdef CONFIG_DELAYED_TASK
+/**
+ * \brief Time between status reads while the device is busy, in us.
+ *
+ * The delayed task may run up to the same time later.
+ */
+# ifndef CONFIG_AT45_POLL_INTERVAL
+#  define CONFIG_AT45_POLL_INTERVAL     250
+# endif
+#endif
+
 //! AT45 device flags
 enum at45_device_flag {
 	AT45_FLAG_VALID,     //!< Valid AT45 device detected
 	AT45_FLAG_PROTECTED, //!< Device is protected from write operations
+	AT45_FLAG_BINARY_PAGE, //!< Device is configured for power-of-2 pages
 };
 
 // Forward reference
@@ -84,10 +106,23 @@ struct at45_device {
 	spi_id_t              spi_id;
 	//! \internal Next call to be made for chained operations
 	at45_next_call_t      next;
+#ifdef CONFIG_DELAYED_TASK
+	//! \internal Delayed task for polling the status while busy
+	struct delayed_task   poll;
+#endif
 	//! Device size
 	uint32_t              size;
 	//! Device page size
 	uint16_t              page_size;
+	/**
+	 * \brief Bit position of the page address in command addresses
+	 *
+	 * With power-of-2 pages the page address directly follows the
+	 * position in page, making the address space linear. Otherwise one
+	 * more bit is used for the position, to cover the extra bytes in
+	 * each page.
+	 */
+	uint8_t               page_addr_shift;
 	//! \ref at45_device_flag
 	uint8_t               flags;
 	/**
@@ -190,6 +225,30 @@ static inline void at45_read_rsp(struct at45_device *at45d, uint8_t size)
 	spi_read(at45d->spi_id, at45d->spim, at45d->cmdrsp, size);
 }
 
+/**
+ * \brief Store address for AT45 device command
+ *
+ * Stores the 24-bit address for page \a page and position \a pos after the
+ * command opcode in at45_device::cmdrsp .
+ *
+ * \param at45d AT45 device struct
+ * \param page  Page address
+ * \param pos   Position in page
+ */
+static inline void at45_set_cmd_addr(struct at45_device *at45d,
+		uint16_t page, uint16_t pos)
+{
+	uint32_t addr;
+
+	assert(!(page & ~AT45_PAGE_ADDR_MASK));
+	assert(!(pos & ~AT45_PAGE_POS_MASK));
+
+	addr = ((uint32_t)page << at45d->page_addr_shift) | pos;
+	at45d->cmdrsp[1] = addr >> 16;
+	at45d->cmdrsp[2] = addr >> 8;
+	at45d->cmdrsp[3] = addr;
+}
+
 /**
  * \brief Write AT45 device command: read status register
  *
@@ -219,6 +278,12 @@ static inline void at45_cmd_read_id(struct at45_device *at45d)
 /**
  * \brief Write AT45 device command: continous array read
  *
+ * Once the command has been written, data can be read continously from
+ * the given address for as long as the device stays selected. The read
+ * wraps into the next page at the end of each page, so when the device is
+ * configured for power-of-2 pages (\ref AT45_FLAG_BINARY_PAGE) any number
+ * of consecutive pages can be read with a single command.
+ *
  * \param at45d AT45 device struct
  * \param page  Page address
  * \param pos   Position in page
@@ -228,16 +293,8 @@ static inline void at45_cmd_read_id(struct at45_device *at45d)
 static inline void at45_cmd_cont_array_read(struct at45_device *at45d, uint16_t page,
 		uint16_t pos)
 {
-	assert(!(page & ~AT45_PAGE_ADDR_MASK));
-	assert(!(pos & ~AT45_PAGE_POS_MASK));
-
 	at45d->cmdrsp[0] = AT45_CMD_CONTINOUS_ARRAY_READ;
-	/* 24-bit address split between 13-bits page and 11-bits position in
-	 * page.
-	 */
-	at45d->cmdrsp[1] = page >> 5;
-	at45d->cmdrsp[2] = (page << 3) | (pos >> 8);
-	at45d->cmdrsp[3] = pos;
+	at45_set_cmd_addr(at45d, page, pos);
 	at45d->cmdrsp[4] = 0; // Dummy byte required for this command
 	at45_write_cmd(at45d, 5);
 }
@@ -252,14 +309,9 @@ static inline void at45_cmd_cont_array_read(struct at45_device *at45d, uint16_t
  */
 static inline void at45_cmd_buffer_1_write(struct at45_device *at45d, uint16_t pos)
 {
-	assert(!(pos & ~AT45_PAGE_POS_MASK));
-
 	at45d->cmdrsp[0] = AT45_CMD_BUFFER_1_WRITE;
-	/* 24-bit address split between 13-bits don't care and 11-bits position
-	 * in page.
-	 */
-	at45d->cmdrsp[2] = pos >> 8;
-	at45d->cmdrsp[3] = pos;
+	// Page address is don't care for buffer access
+	at45_set_cmd_addr(at45d, 0, pos);
 	at45_write_cmd(at45d, 4);
 }
 
@@ -274,12 +326,9 @@ static inline void at45_cmd_buffer_1_write(struct at45_device *at45d, uint16_t p
 static inline void at45_cmd_main_memory_to_buffer_1_transfer(struct at45_device *at45d,
 		uint16_t page)
 {
-	assert(!(page & ~AT45_PAGE_ADDR_MASK));
-
 	at45d->cmdrsp[0] = AT45_CMD_MAIN_MEMORY_TO_BUFFER_1_TRANSFER;
-	// 24-bit address split between 13-bits page and 11-bits don't care
-	at45d->cmdrsp[1] = page >> 5;
-	at45d->cmdrsp[2] = page << 3;
+	// Position in page is don't care
+	at45_set_cmd_addr(at45d, page, 0);
 	at45_write_cmd(at45d, 4);
 }
 
@@ -294,12 +343,9 @@ static inline void at45_cmd_main_memory_to_buffer_1_transfer(struct at45_device
 static inline void at45_cmd_buffer_1_main_memory_program_with_erase(
 		struct at45_device *at45d, uint16_t page)
 {
-	assert(!(page & ~AT45_PAGE_ADDR_MASK));
-
 	at45d->cmdrsp[0] = AT45_CMD_BUFFER_1_MAIN_MEMORY_PROGRAM_WITH_ERASE;
-	// 24-bit address split between 13-bits page and 11-bits don't care
-	at45d->cmdrsp[1] = page >> 5;
-	at45d->cmdrsp[2] = page << 3;
+	// Position in page is don't care
+	at45_set_cmd_addr(at45d, page, 0);
 	at45_write_cmd(at45d, 4);
 }
 
@@ -355,6 +401,18 @@ static inline bool at45_rsp_status_is_protected(struct at45_device *at45d)
 	return at45d->cmdrsp[0] & (1 << AT45_STATUS_PROTECT);
 }
 
+/**
+ * \brief Test if AT45 device status register bit is set to power-of-2 pages
+ *
+ * \param at45d AT45 device struct
+ * \pre Status register must have been read with at45_cmd_read_status_register
+ *      first
+ */
+static inline bool at45_rsp_status_is_binary_page(struct at45_device *at45d)
+{
+	return at45d->cmdrsp[0] & (1 << AT45_STATUS_PAGE_SIZE);
+}
+
 bool at45_wait_ready(struct at45_device *at45d);
 bool at45_identify(struct at45_device *at45d);
 void at45_device_init(struct at45_device *at45d, spi_id_t spi_id,
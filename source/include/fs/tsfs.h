@@ -78,6 +78,15 @@
 //! Size of block in bytes.
 #define TSFS_BLOCKSIZE          512
 
+/**
+ * \brief Header flag: the file table is sorted by filename.
+ *
+ * Set by image builders which sort the file table entries by their padded
+ * filename bytes, allowing files to be located by binary search. The file
+ * data may still be laid out in any order.
+ */
+#define TSFS_FLAG_SORTED        (1 << 0)
+
 #define TSFS_FILETABLE_ENTRIES_PER_BLOCK \
 	(TSFS_BLOCKSIZE / (sizeof(struct tsfs_filetable_entry)))
 
@@ -101,8 +110,8 @@ struct tsfs_header {
 	uint16_t        id;
 	//! TSFS version
 	uint8_t         version;
-	//! Rereved for future use
-	uint8_t         reserved1;
+	//! Volume flags, see \ref TSFS_FLAG_SORTED
+	uint8_t         flags;
 	//! Size of entire volume, including header
 	uint32_t        volume_size;
 	//! Number of files in the system
@@ -92,6 +92,8 @@ static inline void hugemem_write32(hugemem_ptr_t to, uint32_t val)
 
 #define hugemem_read_block(to, from, size)     memcpy(to, from, size)
 #define hugemem_write_block(to, from, size)    memcpy(to, from, size)
+#define hugemem_copy(to, from, size)           memmove(to, from, size)
+#define hugemem_fill(to, value, size)          memset(to, value, size)
 
 //@}
 
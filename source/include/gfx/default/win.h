@@ -76,6 +76,15 @@ typedef uint16_t clock_jiffy_t;
  */
 #define WIN_EVENT_QUEUE_SIZE 16
 
+/**
+ * \brief Coalesce consecutive pointer move events in the event queue.
+ *
+ * When defined, a pointer move event is merged into the most recently queued
+ * event if that is also a move with the same button state, so that only the
+ * latest position is processed when the event queue backs up during a drag.
+ */
+#define WIN_EVENT_COALESCE_MOVES
+
 //! Button mask for touch screens.
 #define WIN_TOUCH_BUTTON (1 << 0)
 
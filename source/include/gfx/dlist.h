@@ -0,0 +1,241 @@
+/**
+ * \file
+ *
+ * \brief Display lists for recorded drawing operations
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef GFX_DLIST_H_INCLUDED
+#define GFX_DLIST_H_INCLUDED
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <gfx/gfx.h>
+
+/**
+ * \ingroup gfx_gfx
+ * \defgroup gfx_dlist Display lists
+ *
+ * A display list is a recorded sequence of drawing operations which can
+ * be replayed any number of times at any position. Widgets which draw the
+ * same primitives on every redraw can record them once, with coordinates
+ * relative to the window origin, and replay the list on each
+ * \ref WIN_EVENT_DRAW event with the origin of the clipping region.
+ *
+ * Every operation is stored with its bounding box, and the list keeps the
+ * bounding box of all its operations. During replay, the whole list is
+ * skipped if it does not intersect the current clipping region, and so is
+ * each operation which is completely outside it. This avoids running the
+ * software clipping, and any data memory access, for primitives which
+ * would not put a single pixel on the screen.
+ *
+ * A list is recorded into a buffer supplied with gfx_dlist_init(). The
+ * buffer contents are self-contained, so a recorded list can be copied to
+ * hugemem with hugemem_write_block() and replayed from there with
+ * gfx_dlist_replay_hugemem(). The first gfx_dlist_get_length() bytes of
+ * the buffer must be copied.
+ *
+ * Strings are copied into the list, while bitmaps, gradients and fonts
+ * are referenced and must stay valid for as long as the list is used.
+ * Lists are only valid for the build they were recorded with.
+ *
+ * Display list support is enabled with CONFIG_GFX_DLIST.
+ *
+ * @{
+ */
+
+#ifndef CONFIG_GFX_DLIST_STRING_MAX
+//! Maximum length of a string stored in a display list.
+# define CONFIG_GFX_DLIST_STRING_MAX    32
+#endif
+
+//! Bounding box of display list or operation, inclusive.
+struct gfx_dlist_bbox {
+	//! Left edge.
+	gfx_coord_t     x1;
+	//! Top edge.
+	gfx_coord_t     y1;
+	//! Right edge.
+	gfx_coord_t     x2;
+	//! Bottom edge.
+	gfx_coord_t     y2;
+};
+
+//! Header at the start of display list data.
+struct gfx_dlist_header {
+	//! Number of bytes used, including this header.
+	uint16_t                length;
+	//! Bounding box of all operations in the list.
+	struct gfx_dlist_bbox   bbox;
+};
+
+//! Display list recording state.
+struct gfx_dlist {
+	//! Buffer holding the list, starting with a \ref gfx_dlist_header.
+	uint8_t         *data;
+	//! Size of buffer in bytes.
+	uint16_t        size;
+};
+
+/*
+ * The operations are only used by the display list implementation, and
+ * are here for the size of each operation to be known to its users.
+ */
+
+//! \internal Common header of all display list operations.
+struct gfx_dlist_op {
+	//! Operation type, \ref gfx_dlist_op_type.
+	uint8_t                 type;
+	//! Size of operation in bytes, including this header.
+	uint8_t                 size;
+	//! Bounding box relative to list origin.
+	struct gfx_dlist_bbox   bbox;
+};
+
+//! \internal Filled or outlined rectangle.
+struct gfx_dlist_rect_op {
+	struct gfx_dlist_op     op;
+	gfx_color_t             color;
+};
+
+//! \internal Line flag: line goes from bottom left to top right.
+#define GFX_DLIST_LINE_RISING   (1 << 0)
+
+//! \internal Line between two corners of the bounding box.
+struct gfx_dlist_line_op {
+	struct gfx_dlist_op     op;
+	gfx_color_t             color;
+	//! Line flags, GFX_DLIST_LINE_RISING.
+	uint8_t                 flags;
+};
+
+//! \internal String at the top left corner of the bounding box.
+struct gfx_dlist_string_op {
+	struct gfx_dlist_op     op;
+	struct font             *font;
+	gfx_color_t             color;
+	gfx_color_t             background_color;
+	//! String, only stored up to and including the terminating NUL.
+	char                    str[CONFIG_GFX_DLIST_STRING_MAX + 1];
+};
+
+//! \internal Bitmap area filling the bounding box.
+struct gfx_dlist_bitmap_op {
+	struct gfx_dlist_op     op;
+	const struct gfx_bitmap *bmp;
+	gfx_coord_t             map_x;
+	gfx_coord_t             map_y;
+};
+
+#ifdef CONFIG_GRADIENT
+//! \internal Gradient area filling the bounding box.
+struct gfx_dlist_gradient_op {
+	struct gfx_dlist_op     op;
+	struct gfx_gradient     *gradient;
+	gfx_coord_t             map_x;
+	gfx_coord_t             map_y;
+};
+#endif
+
+/**
+ * \name Size of display list operations
+ *
+ * These give the number of bytes each operation takes in a display list,
+ * for sizing the buffer of a list which always records the same
+ * operations. The buffer must also hold a \ref gfx_dlist_header.
+ *
+ * @{
+ */
+//! Size of gfx_dlist_add_filled_rect() and gfx_dlist_add_rect().
+#define GFX_DLIST_RECT_SIZE     sizeof(struct gfx_dlist_rect_op)
+//! Size of gfx_dlist_add_line().
+#define GFX_DLIST_LINE_SIZE     sizeof(struct gfx_dlist_line_op)
+//! Size of gfx_dlist_add_string() for a string of \a len characters.
+#define GFX_DLIST_STRING_SIZE(len)                                      \
+	(offsetof(struct gfx_dlist_string_op, str) + (len) + 1)
+//! Size of gfx_dlist_add_bitmap().
+#define GFX_DLIST_BITMAP_SIZE   sizeof(struct gfx_dlist_bitmap_op)
+//! @}
+
+void gfx_dlist_init(struct gfx_dlist *dlist, void *buf, uint16_t size);
+void gfx_dlist_clear(struct gfx_dlist *dlist);
+
+/**
+ * \brief Get number of bytes used by a display list
+ *
+ * \param dlist Display list.
+ *
+ * \return Number of bytes at the start of the display list buffer that
+ * make up the list.
+ */
+static inline uint16_t gfx_dlist_get_length(const struct gfx_dlist *dlist)
+{
+	return ((const struct gfx_dlist_header *)dlist->data)->length;
+}
+
+bool gfx_dlist_add_filled_rect(struct gfx_dlist *dlist,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_color_t color);
+bool gfx_dlist_add_rect(struct gfx_dlist *dlist,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_color_t color);
+bool gfx_dlist_add_line(struct gfx_dlist *dlist,
+		gfx_coord_t x1, gfx_coord_t y1,
+		gfx_coord_t x2, gfx_coord_t y2, gfx_color_t color);
+bool gfx_dlist_add_string(struct gfx_dlist *dlist, const char *str,
+		gfx_coord_t x, gfx_coord_t y, struct font *font,
+		gfx_color_t color, gfx_color_t background_color);
+bool gfx_dlist_add_bitmap(struct gfx_dlist *dlist,
+		const struct gfx_bitmap *bmp,
+		gfx_coord_t map_x, gfx_coord_t map_y,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height);
+#ifdef CONFIG_GRADIENT
+bool gfx_dlist_add_gradient(struct gfx_dlist *dlist,
+		struct gfx_gradient *gradient,
+		gfx_coord_t map_x, gfx_coord_t map_y,
+		gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height);
+#endif
+
+void gfx_dlist_replay(const struct gfx_dlist *dlist,
+		gfx_coord_t x, gfx_coord_t y);
+#ifdef CONFIG_HUGEMEM
+void gfx_dlist_replay_hugemem(const hugemem_ptr_t data,
+		gfx_coord_t x, gfx_coord_t y);
+#endif
+
+//! @}
+
+#endif /* GFX_DLIST_H_INCLUDED */
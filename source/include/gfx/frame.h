@@ -0,0 +1,132 @@
+/**
+ * \file
+ *
+ * \brief Tearing-effect synchronized frame scheduler
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef GFX_FRAME_H_INCLUDED
+#define GFX_FRAME_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <workqueue.h>
+
+/**
+ * \ingroup gfx_gfx
+ * \defgroup gfx_frame Frame scheduler
+ *
+ * The frame scheduler paces screen updates to the refresh of the panel.
+ * Display controllers with a tearing effect (TE) output signal the start
+ * of each vertical blanking period. Drawing which starts at that point
+ * has a full refresh period before the scan reaches the same lines
+ * again, so animations do not show half-updated frames.
+ *
+ * Instead of queueing their paint task on \ref main_workqueue directly,
+ * typically from a timer callback, applications call
+ * gfx_frame_add_task(). The task is held back until the next TE pulse.
+ * The TE interrupt raises the \ref SOFTIRQ_GFX_FRAME softirq, which
+ * releases all held tasks to the main workqueue in one go. So each task
+ * is run at most once per refresh, and a task which is requested several
+ * times during a frame is only run once.
+ *
+ * If the tasks released for the previous refresh have not finished when
+ * the next TE pulse arrives, the frame is counted as late, and nothing
+ * is released for this refresh. The pending tasks stay queued, and any
+ * new requests for them are merged, until painting has caught up.
+ *
+ * A task which has a lot of drawing to do can check
+ * gfx_frame_in_budget() as it goes. When it returns false, the next
+ * refresh has started, so the task should re-add itself with
+ * gfx_frame_add_task() and continue on the next frame.
+ *
+ * The TE interrupt is only enabled while tasks are waiting, so an idle
+ * display costs no interrupts.
+ *
+ * The frame scheduler is enabled with CONFIG_GFX_FRAME, and requires
+ * CONFIG_SOFTIRQ and a \c SOFTIRQ_GFX_FRAME entry in the application's
+ * \c app/softirq.h. The display driver must support the TE signal.
+ *
+ * @{
+ */
+
+extern volatile uint8_t gfx_frame_priv_count;
+extern uint8_t gfx_frame_priv_released;
+
+void gfx_frame_init(void);
+bool gfx_frame_add_task(struct workqueue_task *task);
+uint16_t gfx_frame_get_late_count(void);
+
+/**
+ * \brief Get frame counter
+ *
+ * \return Number of TE pulses seen since gfx_frame_init(), wrapping at
+ * 256. Pulses are only counted while tasks are waiting for a frame.
+ */
+static inline uint8_t gfx_frame_get_count(void)
+{
+	return gfx_frame_priv_count;
+}
+
+/**
+ * \brief Check if the current frame has time left
+ *
+ * Tasks released by the frame scheduler may call this while drawing to
+ * check that the refresh they were released for has not ended yet.
+ *
+ * \retval true The next TE pulse has not arrived yet.
+ * \retval false The frame is over, and any further drawing may tear.
+ */
+static inline bool gfx_frame_in_budget(void)
+{
+	return gfx_frame_priv_count == gfx_frame_priv_released;
+}
+
+/**
+ * \internal
+ * \name Display driver interface
+ *
+ * These are implemented by display drivers that support the TE signal.
+ * The driver calls gfx_frame_priv_vsync() from interrupt context on each
+ * TE pulse while the signal is enabled.
+ *
+ * @{
+ */
+void gfx_frame_priv_enable_vsync(void);
+void gfx_frame_priv_disable_vsync(void);
+void gfx_frame_priv_vsync(void);
+//! @}
+
+//! @}
+
+#endif /* GFX_FRAME_H_INCLUDED */
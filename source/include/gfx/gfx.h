@@ -233,8 +233,21 @@ extern gfx_coord_t gfx_max_x;	//!< Minimum X of current clipping region.
 extern gfx_coord_t gfx_max_y;	//!< Maximum Y of current clipping region.
 #endif
 
+#if defined(CONFIG_GFX_FIXED_ORIENTATION) && !defined(__DOXYGEN__)
+/*
+ * The orientation is fixed at build time, so the screen size is a
+ * constant which the compiler can fold into the drawing code.
+ */
+enum {
+	gfx_width = (GFX_FIXED_ORIENTATION & GFX_SWITCH_XY)
+			? GFX_PANEL_HEIGHT : GFX_PANEL_WIDTH,
+	gfx_height = (GFX_FIXED_ORIENTATION & GFX_SWITCH_XY)
+			? GFX_PANEL_WIDTH : GFX_PANEL_HEIGHT,
+};
+#else
 extern gfx_coord_t gfx_width;  //!< Current width of screen.
 extern gfx_coord_t gfx_height; //!< Current height of screen.
+#endif
 //@}
 
 /** Valid storage locations for font data
@@ -360,8 +373,64 @@ enum gfx_bitmap_type {
 	//! Gradient bitmap.
 	BITMAP_GRADIENT,
 #endif
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+	//! Indexed color bitmap with pixels stored in SRAM
+	BITMAP_INDEXED_RAM,
+	//! Indexed color bitmap with pixels stored in progmem
+	BITMAP_INDEXED_PROGMEM,
+# ifdef CONFIG_HUGEMEM
+	//! Indexed color bitmap with pixels stored in hugemem
+	BITMAP_INDEXED_HUGEMEM,
+# endif
+#endif
 };
 
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+
+#ifndef CONFIG_GFX_BITMAP_LINE_PIXELS
+//! Number of pixels expanded at a time when drawing indexed bitmaps.
+# define CONFIG_GFX_BITMAP_LINE_PIXELS  32
+#endif
+
+//! Transparent index which does not match any pixel.
+#define GFX_INDEX_NONE          0x100
+
+/**
+ * \brief Pixel data and palette of an indexed color bitmap
+ *
+ * Each pixel is an index into the palette, packed 1, 2, 4 or 8 bits per
+ * pixel with the leftmost pixel in the most significant bits of a byte.
+ * Each line starts on a byte boundary, so a line takes
+ * (width * bpp + 7) / 8 bytes.
+ *
+ * The palette is always kept in SRAM, since it is looked up for every
+ * pixel. It must have an entry for every index used by the pixels.
+ *
+ * Pixels equal to \a transparent are not drawn. Set it to
+ * \ref GFX_INDEX_NONE for bitmaps without transparent pixels, which are
+ * drawn faster.
+ */
+struct gfx_indexed_pixmap {
+	//! Bits per pixel, one of 1, 2, 4 or 8
+	uint8_t                                bpp;
+	//! Transparent index, or \ref GFX_INDEX_NONE
+	uint16_t                               transparent;
+	//! Palette with the color for each index
+	const gfx_color_t                     *palette;
+	union {
+		//! Pointer to pixels for bitmap stored in SRAM
+		const uint8_t                     *ram;
+		//! Pointer to pixels for bitmap stored in progmem
+		const uint8_t __progmem_arg       *progmem;
+#ifdef CONFIG_HUGEMEM
+		//! Pointer to pixels for bitmap stored in hugemem
+		hugemem_ptr_t                      hugemem;
+#endif
+	}                                      pixels;
+};
+
+#endif /* CONFIG_GFX_BITMAP_INDEXED */
+
  
 /**
  * \brief Storage structure for bitmap pixel data and metadata
@@ -387,10 +456,20 @@ struct gfx_bitmap {
 #ifdef CONFIG_GRADIENT
 		//! Pointer to gradient data
 		struct gfx_gradient               *gradient;
+#endif
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+		//! Pointer to pixels and palette for indexed color bitmaps
+		const struct gfx_indexed_pixmap   *indexed;
 #endif
 	}                                      data;
 };
 
+#ifdef CONFIG_GFX_BITMAP_INDEXED
+void gfx_bitmap_priv_read_indexed(const struct gfx_bitmap *bmp,
+		gfx_color_t *pixels, gfx_coord_t col, gfx_coord_t row,
+		gfx_coord_t count);
+#endif
+
 void gfx_draw_bitmap(const struct gfx_bitmap *bmp, gfx_coord_t x,
 		gfx_coord_t y);
 
@@ -449,6 +528,11 @@ void gfx_sync(void);
  * Note that rotating the screen 90 degress means switching X/Y _and_
  * mirroring one of the axes. It is not enough to just switch X/Y.
  *
+ * If CONFIG_GFX_FIXED_ORIENTATION is set, the orientation is fixed at
+ * build time to the default orientation of the board, and the screen
+ * width and height are compile-time constants. This function must then
+ * only be called with the default orientation.
+ *
  * \param flags A bitmask of which axes to flip and/or switch.
  */
 void gfx_set_orientation(uint8_t flags);
@@ -486,6 +570,9 @@ gfx_coord_t gfx_get_height(void);
  * displays which has a low bandwidth from the CPU.
  * Software is enabled by the CONFIG_GFX_USE_CLIPPING configuration symbol.
  * Clipping region is set with the \ref gfx_set_clipping function.
+ * Primitives which are drawn as many spans, like lines and circles, check
+ * their bounding box against the clipping region once, and draw the spans
+ * without clipping if it is entirely inside.
  *
  * Hardware clipping is used in the supported display drivers to efficiently
  * draw primitives on a subset of the display. Example: when drawing a
@@ -704,6 +791,23 @@ void gfx_copy_pixels_from_screen(gfx_color_t *pixels, uint32_t count);
  * \param  color       Color of the line, in display native format.
  */
 
+/**
+ * \def gfx_draw_thick_line(x1, y1, x2, y2, thickness, color)
+ * \brief Draw a line of a given thickness between two arbitrary points.
+ *
+ * The line is centered on the line between the two points, and its ends
+ * are cut off straight along the X or Y axis, whichever is closest to
+ * perpendicular to the line. Thickness less than two gives the same
+ * result as gfx_draw_line().
+ *
+ * \param  x1          Start X coordinate.
+ * \param  y1          Start Y coordinate.
+ * \param  x2          End X coordinate.
+ * \param  y2          End Y coordinate.
+ * \param  thickness   Thickness of the line in pixels.
+ * \param  color       Color of the line, in display native format.
+ */
+
 /**
  * \def gfx_draw_rect(x, y, width, height, color)
  * \brief Draw an outline of a rectangle.
@@ -770,6 +874,36 @@ void gfx_copy_pixels_from_screen(gfx_color_t *pixels, uint32_t count);
  * \param  quadrant_mask Bitmask indicating which quadrants to draw.
  */
 
+/**
+ * \def gfx_draw_rounded_rect(x, y, width, height, radius, color)
+ * \brief Draw an outline of a rectangle with rounded corners.
+ *
+ * The corners are quadrants of a circle with the given radius, which is
+ * reduced if needed to fit within the rectangle. Radius equal to zero
+ * gives the same result as gfx_draw_rect().
+ *
+ * \param  x           X coordinate of the left side.
+ * \param  y           Y coordinate of the top side.
+ * \param  width       Width of the rectangle.
+ * \param  height      Height of the rectangle.
+ * \param  radius      Corner radius in pixels.
+ * \param  color       Color of the rectangle, in display native format.
+ */
+
+/**
+ * \def gfx_draw_filled_rounded_rect(x, y, width, height, radius, color)
+ * \brief Draw a filled rectangle with rounded corners.
+ *
+ * \see gfx_draw_rounded_rect() for a description of the corner radius.
+ *
+ * \param  x           X coordinate of the left side.
+ * \param  y           Y coordinate of the top side.
+ * \param  width       Width of the rectangle.
+ * \param  height      Height of the rectangle.
+ * \param  radius      Corner radius in pixels.
+ * \param  color       Color of the rectangle, in display native format.
+ */
+
 /**
  * \def gfx_get_pixmap(pixmap, map_width, map_x,  map_y, x, y, width, height)
  * \brief Read a rectangular block of pixels from the screen into data
@@ -63,6 +63,11 @@ void gfx_generic_draw_line(gfx_coord_t x1, gfx_coord_t y1,
 		gfx_coord_t x2, gfx_coord_t y2,
 		gfx_color_t color);
 
+//! Generic implementation of gfx_draw_thick_line().
+void gfx_generic_draw_thick_line(gfx_coord_t x1, gfx_coord_t y1,
+		gfx_coord_t x2, gfx_coord_t y2, gfx_coord_t thickness,
+		gfx_color_t color);
+
 //! Generic implementation of gfx_draw_rect().
 void gfx_generic_draw_rect(gfx_coord_t x, gfx_coord_t y,
 		gfx_coord_t width, gfx_coord_t height,
@@ -83,6 +88,16 @@ void gfx_generic_draw_filled_circle(gfx_coord_t x, gfx_coord_t y,
 		gfx_coord_t radius, gfx_color_t color,
 		uint8_t quadrant_mask);
 
+//! Generic implementation of gfx_draw_rounded_rect().
+void gfx_generic_draw_rounded_rect(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_coord_t radius,
+		gfx_color_t color);
+
+//! Generic implementation of gfx_draw_filled_rounded_rect().
+void gfx_generic_draw_filled_rounded_rect(gfx_coord_t x, gfx_coord_t y,
+		gfx_coord_t width, gfx_coord_t height, gfx_coord_t radius,
+		gfx_color_t color);
+
 //! Generic implementation of gfx_get_pixmap().
 void gfx_generic_get_pixmap(gfx_color_t *pixmap, gfx_coord_t map_width,
 		gfx_coord_t map_x, gfx_coord_t map_y,
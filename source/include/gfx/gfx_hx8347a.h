@@ -44,6 +44,17 @@
  * @{
  */
 
+//! Width of the HX8347A panel in its native orientation.
+#define GFX_PANEL_WIDTH         240
+//! Height of the HX8347A panel in its native orientation.
+#define GFX_PANEL_HEIGHT        320
+
+#if defined(CONFIG_GFX_FIXED_ORIENTATION) || defined(__DOXYGEN__)
+# include <board/hx8347a.h>
+//! Orientation flags used when the orientation is fixed at build time.
+# define GFX_FIXED_ORIENTATION  GFX_DEFAULT_ORIENTATION
+#endif
+
 /*
  * Use the generic drawing functions for this driver
  */
@@ -69,6 +80,13 @@
 #define gfx_draw_line(x1, y1, x2, y2, color) \
 		gfx_generic_draw_line(x1, y1, x2, y2, color)
 
+/**
+ * HX8347A display driver uses generic gfx implementation for this function. See
+ * \ref gfx_generic_draw_thick_line
+ */
+#define gfx_draw_thick_line(x1, y1, x2, y2, thickness, color) \
+		gfx_generic_draw_thick_line(x1, y1, x2, y2, thickness, color)
+
 /**
  * HX8347A display driver uses generic gfx implementation for this function. See
  * \ref gfx_generic_draw_rect
@@ -97,6 +115,21 @@
 #define gfx_draw_filled_circle(x, y, radius, color, quadrant_mask) \
 		gfx_generic_draw_filled_circle(x, y, radius, color, quadrant_mask)
 
+/**
+ * HX8347A display driver uses generic gfx implementation for this function. See
+ * \ref gfx_generic_draw_rounded_rect
+ */
+#define gfx_draw_rounded_rect(x, y, width, height, radius, color) \
+		gfx_generic_draw_rounded_rect(x, y, width, height, radius, color)
+
+/**
+ * HX8347A display driver uses generic gfx implementation for this function. See
+ * \ref gfx_generic_draw_filled_rounded_rect
+ */
+#define gfx_draw_filled_rounded_rect(x, y, width, height, radius, color) \
+		gfx_generic_draw_filled_rounded_rect(x, y, width, height, \
+				radius, color)
+
 /**
  * HX8347A display driver uses generic gfx implementation for this function. See
  * \ref gfx_generic_get_pixmap
@@ -131,6 +164,25 @@ typedef int16_t gfx_coord_t;
 
 #define GFX_COLOR_TRANSPARENT   GFX_COLOR(254,0,0)
 
+#ifdef CONFIG_GFX_HX8347A_DMA
+/*
+ * On UC3, pixel fills and copies may be done by the DMA controller, and
+ * return before all pixels have been sent to the display. gfx_sync()
+ * waits for them, and gfx_sync_async() schedules a task instead.
+ */
+struct workqueue_task;
+void gfx_sync_async(struct workqueue_task *task);
+#endif
+
+#ifdef CONFIG_CPU_HOST
+/*
+ * On the host, the display is a model of the controller which counts the
+ * accesses on its bus. The count is the cost of the drawing on the real
+ * bus, however fast the host is.
+ */
+uint32_t gfx_hx8347a_get_bus_transfers(void);
+#endif
+
 //! @}
 
 #endif // GFX_HX8347A_H_INCLUDED
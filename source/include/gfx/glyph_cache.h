@@ -0,0 +1,105 @@
+/**
+ * \file
+ *
+ * \brief Glyph cache for fonts stored in hugemem
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef GFX_GLYPH_CACHE_H_INCLUDED
+#define GFX_GLYPH_CACHE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <gfx/gfx.h>
+
+/**
+ * \ingroup gfx_gfx
+ * \defgroup gfx_glyph_cache Glyph cache
+ *
+ * Drawing a character from a font stored in hugemem requires the glyph
+ * bitmap to be read from external memory every time the character is
+ * drawn. The glyph cache keeps recently used glyphs in internal SRAM,
+ * pre-expanded into horizontal runs of foreground pixels, so that
+ * drawing a cached glyph costs no hugemem accesses and one primitive
+ * per run instead of one per pixel.
+ *
+ * The glyphs are stored independently of the drawing colors, so a
+ * cached glyph can be drawn with any foreground and background color.
+ * When the cache is full, the least recently used glyphs are evicted.
+ *
+ * The cache is enabled with CONFIG_GFX_GLYPH_CACHE. The size of the
+ * glyph data area in bytes is set with CONFIG_GFX_GLYPH_CACHE_SIZE, and
+ * the maximum number of glyphs with CONFIG_GFX_GLYPH_CACHE_NR_ENTRIES.
+ *
+ * The cache looks up glyphs by font object and font data address. If
+ * the glyph data of a \ref font is replaced or freed, the font must be
+ * invalidated with gfx_glyph_cache_invalidate_font() before the memory
+ * is reused.
+ *
+ * @{
+ */
+
+#ifndef CONFIG_GFX_GLYPH_CACHE_SIZE
+//! Number of bytes of SRAM used to store cached glyphs.
+# define CONFIG_GFX_GLYPH_CACHE_SIZE            512
+#endif
+
+#ifndef CONFIG_GFX_GLYPH_CACHE_NR_ENTRIES
+//! Maximum number of glyphs stored in the cache at any time.
+# define CONFIG_GFX_GLYPH_CACHE_NR_ENTRIES      32
+#endif
+
+//! Glyph cache usage statistics.
+struct gfx_glyph_cache_stats {
+	//! Number of glyphs drawn from the cache.
+	uint32_t        hits;
+	//! Number of glyphs which had to be read from hugemem.
+	uint32_t        misses;
+	//! Number of glyphs evicted to make room for new ones.
+	uint32_t        evictions;
+	//! Number of bytes currently used for glyph data.
+	uint16_t        bytes_used;
+	//! Number of glyphs currently in the cache.
+	uint8_t         nr_glyphs;
+};
+
+bool gfx_glyph_cache_draw_char(char ch, gfx_coord_t x, gfx_coord_t y,
+		const struct font *font, gfx_color_t color);
+void gfx_glyph_cache_invalidate_font(const struct font *font);
+void gfx_glyph_cache_flush(void);
+void gfx_glyph_cache_get_stats(struct gfx_glyph_cache_stats *stats);
+void gfx_glyph_cache_reset_stats(void);
+
+//! @}
+
+#endif /* GFX_GLYPH_CACHE_H_INCLUDED */
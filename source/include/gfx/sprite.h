@@ -0,0 +1,200 @@
+/**
+ * \file
+ *
+ * \brief Sprite layer with transparency and save-under
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef GFX_SPRITE_H_INCLUDED
+#define GFX_SPRITE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <hugemem.h>
+#include <gfx/gfx.h>
+
+/**
+ * \ingroup gfx_gfx
+ * \defgroup gfx_sprite Sprite layer
+ *
+ * The sprite layer moves small bitmaps around on top of whatever has
+ * been drawn on the screen, without the application having to redraw
+ * the background. Each sprite can be drawn with a transparent color
+ * key or a 1-bit transparency mask, so sprites need not be rectangular.
+ *
+ * The pixels under each visible sprite are kept in a save-under buffer
+ * in hugemem. Changes to the sprites, such as moving them or changing
+ * their bitmap, are only recorded until gfx_sprite_compose() is called.
+ * The compose step collects the screen areas which were covered before
+ * and after the changes into a set of non-overlapping dirty rectangles,
+ * and rebuilds only those one line at a time: the line is read back from
+ * the screen, the old save-unders are restored into it, the new
+ * save-unders are taken from it, and the sprites are painted on top in
+ * z-order before the line is written back. Pixels outside the dirty
+ * rectangles are never touched.
+ *
+ * Animations will typically update the sprites from a workqueue task
+ * started by a timer, and call gfx_sprite_schedule_compose() to run the
+ * compose step from the main workqueue. With CONFIG_GFX_FRAME, the
+ * compose step is run by the \ref gfx_frame "frame scheduler" at the
+ * start of the next refresh instead, so the refresh timer of the panel
+ * paces the screen updates. The sprite functions must not be called
+ * from interrupt context.
+ *
+ * The number of sprites is set with CONFIG_GFX_SPRITE_NR, and the width
+ * of the line buffers in pixels with CONFIG_GFX_SPRITE_LINE_PIXELS.
+ * Wider dirty rectangles are rebuilt in several column strips.
+ *
+ * \note The application must not draw under a visible sprite, as the
+ * save-under would no longer match the screen. Hide the sprites and
+ * compose before redrawing the background, or draw the background
+ * before the sprites are first shown.
+ * \note The compose step writes directly to the screen and ignores the
+ * clipping region.
+ *
+ * @{
+ */
+
+#ifndef CONFIG_GFX_SPRITE_NR
+//! Number of entries in the sprite table.
+# define CONFIG_GFX_SPRITE_NR                   8
+#endif
+
+#ifndef CONFIG_GFX_SPRITE_LINE_PIXELS
+//! Width in pixels of the line buffers used when composing.
+# define CONFIG_GFX_SPRITE_LINE_PIXELS          64
+#endif
+
+//! Sprite transparency modes.
+enum gfx_sprite_transparency {
+	//! All pixels of the bitmap are drawn.
+	GFX_SPRITE_OPAQUE,
+	//! Pixels which are equal to the color key are not drawn.
+	GFX_SPRITE_COLOR_KEY,
+	//! Pixels for which the bit in the mask is zero are not drawn.
+	GFX_SPRITE_MASK,
+};
+
+/**
+ * \brief Sprite
+ *
+ * \internal The members are private to the sprite layer and must only be
+ * changed through the gfx_sprite functions.
+ */
+struct gfx_sprite {
+	//! Bitmap to draw, or NULL if the table entry is free.
+	const struct gfx_bitmap         *bmp;
+	//! Two save-under buffers, each of one bitmap size.
+	hugemem_ptr_t                   save_under;
+	//! Transparency mask, in the memory given by \a mask_type.
+	union {
+		const uint8_t           *ram;
+		const uint8_t __progmem_arg *progmem;
+		hugemem_ptr_t           hugemem;
+	}                               mask;
+	//! Transparent color for \ref GFX_SPRITE_COLOR_KEY.
+	gfx_color_t                     color_key;
+	//! Position to draw the sprite at on the next compose.
+	gfx_coord_t                     x;
+	//! Position to draw the sprite at on the next compose.
+	gfx_coord_t                     y;
+	//! Position the sprite is currently drawn at on the screen.
+	gfx_coord_t                     shown_x;
+	//! Position the sprite is currently drawn at on the screen.
+	gfx_coord_t                     shown_y;
+	//! Height in the z-order. Higher sprites are drawn on top.
+	uint8_t                         z;
+	//! Transparency mode, one of \ref gfx_sprite_transparency.
+	uint8_t                         transparency;
+	//! Memory holding the mask: BITMAP_RAM, BITMAP_PROGMEM or BITMAP_HUGEMEM.
+	uint8_t                         mask_type;
+	//! Sprite state flags.
+	uint8_t                         flags;
+};
+
+/**
+ * \brief Return the save-under size needed by a sprite
+ *
+ * \param width  Width of the sprite bitmap.
+ * \param height Height of the sprite bitmap.
+ *
+ * \return Number of bytes of hugemem to pass to gfx_sprite_create().
+ */
+static inline uint32_t gfx_sprite_save_under_size(gfx_coord_t width,
+		gfx_coord_t height)
+{
+	return 2UL * width * height * sizeof(gfx_color_t);
+}
+
+/**
+ * \brief Return the size of a transparency mask
+ *
+ * Masks hold one bit per pixel, most significant bit first, and each
+ * line of the mask starts on a new byte.
+ *
+ * \param width  Width of the sprite bitmap.
+ * \param height Height of the sprite bitmap.
+ *
+ * \return Number of bytes in the transparency mask.
+ */
+static inline uint16_t gfx_sprite_mask_size(gfx_coord_t width,
+		gfx_coord_t height)
+{
+	return ((width + 7) / 8) * height;
+}
+
+struct gfx_sprite *gfx_sprite_create(const struct gfx_bitmap *bmp,
+		hugemem_ptr_t save_under, uint8_t z);
+void gfx_sprite_destroy(struct gfx_sprite *sprite);
+void gfx_sprite_set_color_key(struct gfx_sprite *sprite, gfx_color_t key);
+void gfx_sprite_set_mask(struct gfx_sprite *sprite, const uint8_t *mask);
+void gfx_sprite_set_progmem_mask(struct gfx_sprite *sprite,
+		const uint8_t __progmem_arg *mask);
+#ifdef CONFIG_HUGEMEM
+void gfx_sprite_set_hugemem_mask(struct gfx_sprite *sprite,
+		hugemem_ptr_t mask);
+#endif
+void gfx_sprite_set_opaque(struct gfx_sprite *sprite);
+void gfx_sprite_set_bitmap(struct gfx_sprite *sprite,
+		const struct gfx_bitmap *bmp);
+void gfx_sprite_move(struct gfx_sprite *sprite, gfx_coord_t x,
+		gfx_coord_t y);
+void gfx_sprite_set_z(struct gfx_sprite *sprite, uint8_t z);
+void gfx_sprite_show(struct gfx_sprite *sprite);
+void gfx_sprite_hide(struct gfx_sprite *sprite);
+void gfx_sprite_compose(void);
+void gfx_sprite_schedule_compose(void);
+
+//! @}
+
+#endif /* GFX_SPRITE_H_INCLUDED */
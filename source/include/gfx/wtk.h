@@ -39,6 +39,7 @@
 #define WTK_H_INCLUDED
 
 #include <app/wtk.h>
+#include <hugemem.h>
 #include <gfx/win.h>
 #include <gfx/sysfont.h>
 
@@ -59,6 +60,9 @@
  * - \ref gfx_wtk_radio_button
  * - \ref gfx_wtk_slider
  * - \ref gfx_wtk_label
+ *
+ * Redraws of the simpler widgets can be sped up with the
+ * \ref gfx_wtk_surface_cache.
  * @{
  */
 
@@ -472,6 +476,63 @@ void wtk_plot_set_colors(struct wtk_plot *plot,
 //! @}
 
 
+/**
+ * \defgroup gfx_wtk_surface_cache Widget surface cache
+ *
+ * Drawing a button, check box or radio button involves measuring and
+ * drawing the caption text, which is slow compared to copying pixels.
+ * The surface cache keeps a copy of what each of these widgets looked like
+ * on the screen, one per visual state, in a hugemem arena. When a widget is
+ * redrawn in a state which is cached, the copy is put on the screen with
+ * gfx_put_bitmap() instead, restricted to the clipping region.
+ *
+ * A surface is stored after a widget has been drawn with a clipping region
+ * covering the whole widget, by reading it back from the screen. For
+ * widgets which are drawn on top of their parent, such as the check box,
+ * the surface includes the parent background. Surfaces are therefore only
+ * used again at the same screen position and with the same parent
+ * background bitmap, and are dropped when the widget is moved, resized or
+ * destroyed. If the application changes what is drawn below a widget in
+ * any other way, it must call wtk_surface_cache_invalidate().
+ *
+ * The cache is enabled with CONFIG_GFX_WTK_SURFACE_CACHE, and does nothing
+ * until wtk_surface_cache_init() has given it an arena. The arena size is
+ * the memory budget: when it is full, the least recently used surfaces are
+ * evicted. The maximum number of surfaces is set with
+ * CONFIG_GFX_WTK_SURFACE_CACHE_NR_ENTRIES.
+ *
+ * @{
+ */
+
+#ifndef CONFIG_GFX_WTK_SURFACE_CACHE_NR_ENTRIES
+//! Maximum number of widget surfaces stored in the cache at any time.
+# define CONFIG_GFX_WTK_SURFACE_CACHE_NR_ENTRIES        16
+#endif
+
+//! Widget surface cache usage statistics.
+struct wtk_surface_cache_stats {
+	//! Number of widget redraws served from the cache.
+	uint32_t        hits;
+	//! Number of widget redraws which were drawn normally.
+	uint32_t        misses;
+	//! Number of surfaces evicted to make room for new ones.
+	uint32_t        evictions;
+	//! Number of bytes of the arena currently in use.
+	uint32_t        bytes_used;
+};
+
+void wtk_surface_cache_init(hugemem_ptr_t arena, uint32_t size);
+bool wtk_surface_cache_draw(const struct win_window *win, uint8_t state,
+		const struct win_clip_region *clip);
+void wtk_surface_cache_store(const struct win_window *win, uint8_t state,
+		const struct win_clip_region *clip);
+void wtk_surface_cache_invalidate(const struct win_window *win);
+void wtk_surface_cache_flush(void);
+void wtk_surface_cache_get_stats(struct wtk_surface_cache_stats *stats);
+
+//! @}
+
+
 
 
 
@@ -107,6 +107,22 @@
  * address \a to.
  */
 
+/**
+ * \fn void hugemem_copy(hugemem_ptr_t to, const hugemem_ptr_t from, uint32_t size)
+ *
+ * \brief Copy \a size bytes from huge memory address \a from to huge memory
+ * address \a to.
+ *
+ * Unlike the other block functions, the size is not limited to 64 kB. The
+ * areas may only overlap if \a to is below \a from.
+ */
+
+/**
+ * \fn void hugemem_fill(hugemem_ptr_t to, uint8_t value, uint32_t size)
+ *
+ * \brief Set \a size bytes at huge memory address \a to to \a value.
+ */
+
 /**
  * \fn void hugemem_write8(hugemem_ptr_t to, uint_fast8_t val)
  *
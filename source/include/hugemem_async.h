@@ -0,0 +1,99 @@
+/**
+ * \file
+ *
+ * \brief Asynchronous huge memory block operations
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef HUGEMEM_ASYNC_H_INCLUDED
+#define HUGEMEM_ASYNC_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <hugemem.h>
+#include <slist.h>
+#include <workqueue.h>
+
+/**
+ * \ingroup hugemem_group
+ * \defgroup hugemem_async_group Asynchronous Huge Memory Operations
+ *
+ * Large copies within huge memory, such as moving a bitmap into a
+ * back buffer, can be started without waiting for them to finish. The
+ * request is queued, and a workqueue task is scheduled on the main
+ * workqueue when it has completed.
+ *
+ * On ATxmega with \a CONFIG_HUGEMEM_DMA, the requests are handled one
+ * by one by a DMA channel, and the CPU is free to do other work in the
+ * meantime. Otherwise, the operation is done before the function
+ * returns, and only the completion is deferred. This is also what
+ * happens when the code is built for a host without huge memory.
+ *
+ * The source and destination must not be touched by the CPU until the
+ * task has been scheduled.
+ *
+ * @{
+ */
+
+/**
+ * \brief Asynchronous huge memory request
+ *
+ * \internal All fields are private, and are set up by the functions
+ * starting the request.
+ */
+struct hugemem_request {
+	//! Node in the request queue.
+	struct slist_node       node;
+	//! Destination address.
+	hugemem_ptr_t           to;
+	//! Source address, unused for fill requests.
+	hugemem_ptr_t           from;
+	//! Number of bytes left to move.
+	uint32_t                size;
+	//! Task to schedule when the request is done, or NULL.
+	struct workqueue_task   *task;
+	//! Value to fill with.
+	uint8_t                 value;
+	//! True for a fill request, false for a copy request.
+	bool                    fill;
+};
+
+void hugemem_copy_async(struct hugemem_request *req, hugemem_ptr_t to,
+		const hugemem_ptr_t from, uint32_t size,
+		struct workqueue_task *task);
+void hugemem_fill_async(struct hugemem_request *req, hugemem_ptr_t to,
+		uint8_t value, uint32_t size, struct workqueue_task *task);
+
+//! @}
+
+#endif /* HUGEMEM_ASYNC_H_INCLUDED */
@@ -81,6 +81,11 @@
  * handler-specific data, and running any code dealing with soft
  * interrupt handling, etc. before returning.
  *
+ * If \a CONFIG_LATENCY or \a CONFIG_SLEEPMGR_STATS is defined, the
+ * entry point calls a wrapper around \a handler which collects the
+ * \ref latency_group "latency" or \ref sleepmgr_group "wake-up"
+ * statistics.
+ *
  * \note This is not a function-like macro; it should not be called
  * from within functions. Instead, it should be invoked at the top level
  * right after the definition of the interrupt handler function.
@@ -89,6 +94,46 @@
  * \param handler The interrupt handler function
  * \param level The priority level of this interrupt
  */
+#define INTC_DEFINE_HANDLER(id, handler, level)                         \
+	INTC_PRIV_TIMED_HANDLER(id, handler)                            \
+	INTC_PRIV_WAKE_HANDLER(id, intc_priv_timed_sym(id, handler))    \
+	intc_priv_define_handler(id,                                    \
+			intc_priv_wake_sym(id,                          \
+				intc_priv_timed_sym(id, handler)),      \
+			level)
+
+/*
+ * With CONFIG_LATENCY, the handler is wrapped by a function measuring
+ * its execution time.
+ */
+#ifdef CONFIG_LATENCY
+# include <latency.h>
+# define INTC_PRIV_TIMED_HANDLER(id, handler)                           \
+	LATENCY_DEFINE_IRQ_HANDLER(id, handler)
+# define intc_priv_timed_sym(id, handler)       latency_priv_irq_sym(id)
+#else
+# define INTC_PRIV_TIMED_HANDLER(id, handler)
+# define intc_priv_timed_sym(id, handler)       handler
+#endif
+
+/*
+ * With CONFIG_SLEEPMGR_STATS, the result is wrapped by a function
+ * recording the first interrupt after a sleep as the wake-up source.
+ */
+#ifdef CONFIG_SLEEPMGR_STATS
+# include <sleepmgr.h>
+# define INTC_PRIV_WAKE_HANDLER(id, handler)                            \
+	SLEEPMGR_DEFINE_IRQ_HANDLER(id, handler)
+# define intc_priv_wake_sym(id, handler)        sleepmgr_priv_irq_sym(id)
+#else
+# define INTC_PRIV_WAKE_HANDLER(id, handler)
+# define intc_priv_wake_sym(id, handler)        handler
+#endif
+
+/* Expand the handler name before it may be turned into a string. */
+#define intc_priv_define_handler(id, handler, level)                   \
+	INTC_PRIV_DEFINE_HANDLER(id, handler, level)
+
 /**
  * \def intc_set_irq_data
  * \brief Associate a data pointer with an interrupt
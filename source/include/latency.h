@@ -0,0 +1,136 @@
+/**
+ * \file
+ *
+ * \brief Workqueue and interrupt latency instrumentation
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef LATENCY_H_INCLUDED
+#define LATENCY_H_INCLUDED
+
+#include <compiler.h>
+#include <types.h>
+
+/**
+ * \defgroup latency_group Latency Instrumentation
+ *
+ * If \a CONFIG_LATENCY is defined, the main loop measures how long each work
+ * queue task waited in \ref main_workqueue before it was run, and how long it
+ * ran, and all interrupt handlers defined by INTC_DEFINE_HANDLER() measure
+ * how long they run. This helps finding the tasks and handlers which delay
+ * everything else, e.g. when the touch screen lags or the USB host sees a lot
+ * of NAKs under load.
+ *
+ * The statistics are kept per worker function, since the worker identifies
+ * the kind of task while the task structure may be reused or allocated on
+ * the fly. For each worker, a histogram of the wait and run times is kept,
+ * with bucket \a n holding the number of times between 4^n and 4^(n+1) - 1
+ * ticks, and the last bucket holding all longer times. For each interrupt,
+ * the number of calls and the total and longest run time are kept. The time
+ * of an interrupt handler includes the time spent in handlers of higher
+ * levels which interrupted it.
+ *
+ * The time of a task waiting in the main work queue is counted from the last
+ * time it was added to a work queue, so for tasks which are moved from a
+ * \ref nested_workqueue into the main work queue, only the time waiting for
+ * the CPU is counted.
+ *
+ * Times are taken from the \ref timer_group "timer" \a CONFIG_TIMER_ID, which
+ * the application must set up and start before passing it to latency_init().
+ * The counter is 16 bits wide, so the resolution should be low enough for
+ * the longest interesting time to fit. Longer times are not detected.
+ *
+ * latency_show_top() prints a summary on the debug console, with the workers
+ * using the most CPU time first, and latency_dump() prints the histograms.
+ * Worker functions are printed as addresses, which can be looked up in the
+ * output of nm. On AVR, the addresses of functions are word addresses.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_LATENCY_NR_WORKERS
+ * \brief Number of worker functions to keep statistics for.
+ *
+ * Tasks with other worker functions are counted, but not measured.
+ */
+#ifndef CONFIG_LATENCY_NR_WORKERS
+# define CONFIG_LATENCY_NR_WORKERS      16
+#endif
+
+/**
+ * \def CONFIG_LATENCY_NR_IRQS
+ * \brief Number of interrupts to keep statistics for.
+ *
+ * Calls to handlers of other interrupts are counted, but not measured.
+ */
+#ifndef CONFIG_LATENCY_NR_IRQS
+# define CONFIG_LATENCY_NR_IRQS         8
+#endif
+
+//! Number of buckets in each histogram.
+#define LATENCY_NR_BUCKETS              8
+
+struct timer;
+struct workqueue_task;
+
+extern void latency_init(struct timer *timer, uint32_t resolution);
+extern void latency_reset(void);
+extern void latency_show_top(void);
+extern void latency_dump(void);
+
+extern uint16_t latency_priv_get_time(void);
+extern void latency_priv_run_task(struct workqueue_task *task);
+extern void latency_priv_irq_done(uint8_t id, uint16_t start);
+
+#define latency_priv_irq_sym(id)        latency_priv_irq##id
+
+/**
+ * \internal
+ * \brief Define a function timing the interrupt handler \a handler
+ *
+ * This is used by INTC_DEFINE_HANDLER(), which binds the function to the
+ * interrupt instead of \a handler.
+ */
+#define LATENCY_DEFINE_IRQ_HANDLER(id, handler)                         \
+	static void __used latency_priv_irq_sym(id)(void *data)         \
+	{                                                               \
+		uint16_t start = latency_priv_get_time();               \
+									\
+		handler(data);                                          \
+		latency_priv_irq_done(id, start);                       \
+	}
+
+//! @}
+
+#endif /* LATENCY_H_INCLUDED */
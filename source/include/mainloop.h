@@ -46,6 +46,22 @@
 #include <softirq.h>
 #endif
 
+#ifdef CONFIG_ARCH_HOST
+#include <arch/host_clock.h>
+#endif
+
+#ifdef CONFIG_LATENCY
+#include <latency.h>
+#endif
+
+#ifdef CONFIG_SLEEPMGR
+#include <sleepmgr.h>
+#endif
+
+#ifdef CONFIG_DELAYED_TASK
+#include <delayed_task.h>
+#endif
+
 /**
  * \defgroup mainloop_group Main Loop Processing
  * @{
@@ -55,7 +71,9 @@
  * \brief Run the main loop
  *
  * This function will loop forever processing work queues and soft
- * interrupts.
+ * interrupts. When there is nothing to do, the CPU is put to sleep,
+ * in the mode picked by the \ref sleepmgr_group "sleep manager" if
+ * \a CONFIG_SLEEPMGR is defined.
  *
  * \note This function will enable interrupts unconditionally before
  * processing any work queue tasks.
@@ -76,9 +94,31 @@ __noreturn static inline void mainloop_run(struct workqueue *queue)
 		task = workqueue_pop_task(queue);
 		if (task) {
 			cpu_irq_enable();
+#ifdef CONFIG_LATENCY
+			latency_priv_run_task(task);
+#else
 			workqueue_run_task(task);
+#endif
+#ifdef CONFIG_ARCH_HOST
+			host_clock_advance(HOST_TASK_COST_US);
+#endif
 		} else {
+#ifdef CONFIG_DELAYED_TASK
+			/*
+			 * A delayed task may have become due after its
+			 * alarm was set, e.g. if the alarm was too close
+			 * to be programmed.
+			 */
+			if (delayed_task_poll()) {
+				cpu_irq_enable();
+				continue;
+			}
+#endif
+#ifdef CONFIG_SLEEPMGR
+			sleepmgr_enter_sleep();
+#else
 			cpu_enter_sleep();
+#endif
 		}
 	}
 }
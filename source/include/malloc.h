@@ -40,6 +40,8 @@
 
 #if defined(CONFIG_MALLOC_SIMPLE)
 # include <malloc/simple.h>
+#elif defined(CONFIG_MALLOC_HOST)
+# include <malloc/host.h>
 #else
 # error No malloc() implementation is available
 #endif
@@ -67,12 +67,75 @@
  * different size objects is allocated.  (Reduces internal
  * fragmentation)
  *
- * Allocation of memory with the membag allocator has a max run time which
- * is dependent on the number of bags that is configured.
+ * Allocation of memory with the membag allocator looks up the smallest
+ * suitable bag through a table of size classes, and freeing memory looks up
+ * the owning bag through a table of address ranges. The run time of both is
+ * therefore not dependent on the number of bags that is configured. The bags
+ * must be configured in order of increasing block size.
+ *
+ * If \ref CONFIG_MEMBAG_TRACK_ALLOC_SITES is defined, the allocator records
+ * the call site of each allocated block. See \ref membag_get_alloc_site and
+ * \ref membag_dump_alloc_sites.
+ *
+ * If \ref CONFIG_MEMBAG_TRACE is defined, every allocation and free can be
+ * recorded with \ref membag_trace_start, and printed with
+ * \ref membag_trace_dump for the membag tuner in tools/membag-tuner, which
+ * suggests a bag configuration for the recorded allocation pattern.
  *
  * @{
  */
 
+/**
+ * \def CONFIG_MEMBAG_TRACK_ALLOC_SITES
+ * \brief Record the call site of each allocation.
+ *
+ * This costs one pointer per block in each bag, allocated from the same
+ * physical memory pool as the bag itself.
+ */
+
+/**
+ * \def CONFIG_MEMBAG_TRACE
+ * \brief Enable recording of allocator events.
+ */
+
+/**
+ * \brief Size of the blocks of a bag configured for \a objsize bytes
+ *
+ * Bags are sized for the objects of the target. Pointers and most other
+ * types are up to four times larger on the host, so the blocks are scaled
+ * there to make room for the same objects.
+ */
+#ifdef CONFIG_ARCH_HOST
+# define MEMBAG_BLOCK_SIZE(objsize)	((objsize) * 4)
+#else
+# define MEMBAG_BLOCK_SIZE(objsize)	(objsize)
+#endif
+
+/**
+ * \def CONFIG_MEMBAG_TRACE_ENTRIES
+ * \brief Number of events the trace buffer can hold.
+ */
+#ifndef CONFIG_MEMBAG_TRACE_ENTRIES
+# define CONFIG_MEMBAG_TRACE_ENTRIES  64
+#endif
+
+#ifdef CONFIG_MEMBAG_TRACE
+//! Type of recorded allocator event.
+enum membag_trace_type {
+	MEMBAG_TRACE_ALLOC, //!< Call to membag_alloc().
+	MEMBAG_TRACE_FREE, //!< Call to membag_free().
+};
+
+//! Recorded allocator event.
+struct membag_trace_entry {
+	uint8_t type; //!< Event type, from \ref membag_trace_type.
+	uint16_t timestamp; //!< Sequence number of the event.
+	uint16_t size; //!< Requested size, 0 for frees.
+	const void *ptr; //!< Block allocated or freed, NULL if failed.
+	const void *caller; //!< Return address of the call.
+};
+#endif
+
 #ifdef CONFIG_MEMBAG_USE_TUNING
 //! Statistics for a bag, used for debugging and tuning.
 struct membag_bagstats {
@@ -102,6 +165,18 @@ void membag_free(void *ptr);
 void membag_get_bag_stats(size_t bag_no, struct membag_bagstats *stats);
 #endif
 
+#ifdef CONFIG_MEMBAG_TRACK_ALLOC_SITES
+const void *membag_get_alloc_site(const void *ptr);
+void membag_dump_alloc_sites(void);
+#endif
+
+#ifdef CONFIG_MEMBAG_TRACE
+void membag_trace_start(void);
+void membag_trace_stop(void);
+uint16_t membag_trace_get_entries(const struct membag_trace_entry **entries);
+void membag_trace_dump(void);
+#endif
+
 //! @}
 
 #endif /* MEMBAG_H_INCLUDED */
@@ -56,9 +56,13 @@
 struct physmem_pool;
 
 /**
- * \brief Opaque structure representing a free memory pool object.
+ * \internal
+ * \brief Free memory pool object, linked into the freelist.
  */
-struct mem_pool_object;
+struct mem_pool_object {
+	//! Next free object, or NULL if this is the last one.
+	struct mem_pool_object	*next;
+};
 
 /**
  * \brief Memory pool
@@ -84,6 +88,47 @@ extern void mem_pool_init_physmem(struct mem_pool *mempool,
 void *mem_pool_alloc(struct mem_pool *pool);
 void mem_pool_free(struct mem_pool *pool, const void *obj);
 
+/**
+ * \internal
+ * \brief Allocate an object from a memory pool with interrupts disabled.
+ *
+ * This is mem_pool_alloc() for callers which already run with interrupts
+ * disabled, and need to update their own state along with the pool.
+ *
+ * \param pool The memory pool from which the object is allocated.
+ * \return A pointer to the newly allocated object, or NULL if the
+ *	pool is exhausted.
+ */
+static inline void *mem_pool_priv_alloc(struct mem_pool *pool)
+{
+	struct mem_pool_object	*obj;
+
+	obj = pool->freelist;
+	if (obj)
+		pool->freelist = obj->next;
+
+	return obj;
+}
+
+/**
+ * \internal
+ * \brief Free an object to a memory pool with interrupts disabled.
+ *
+ * This is mem_pool_free() for callers which already run with interrupts
+ * disabled. \a obj must not be NULL.
+ *
+ * \param pool The memory pool which the object belongs to.
+ * \param obj The object to be freed.
+ */
+static inline void mem_pool_priv_free(struct mem_pool *pool,
+		const void *obj)
+{
+	struct mem_pool_object	*free_obj = (struct mem_pool_object *)obj;
+
+	free_obj->next = pool->freelist;
+	pool->freelist = free_obj;
+}
+
 //! @}
 
 #endif /* MEMPOOL_H_INCLUDED */
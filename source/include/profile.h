@@ -0,0 +1,121 @@
+/**
+ * \file
+ *
+ * \brief Statistical PC-sampling profiler
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef PROFILE_H_INCLUDED
+#define PROFILE_H_INCLUDED
+
+#include <types.h>
+
+/**
+ * \defgroup profile_group Sampling Profiler
+ *
+ * The sampling profiler interrupts the CPU at a fixed rate and records the
+ * address of the instruction which was interrupted. Over a long enough run,
+ * the number of samples falling within a function is proportional to the
+ * time spent executing it.
+ *
+ * Each sample also records which interrupt levels were executing when it was
+ * taken, so that time spent in interrupt handlers can be told apart from time
+ * spent in the main loop. The call stack is not recorded, since return
+ * addresses cannot be told apart from other data on the stack.
+ *
+ * Samples are stored in huge memory, and recording stops when the buffer is
+ * full rather than wrapping around, so that a profile always covers the start
+ * of the period of interest. Call \ref profile_start and \ref profile_stop
+ * around the code to profile, e.g. a single redraw or a USB transfer, and
+ * \ref profile_dump to print the samples on the debug console. The script in
+ * tools/profile-report turns the output into a flat profile or folded stacks
+ * by looking up the sampled addresses in the ELF file of the application.
+ *
+ * On XMEGA, the sampling interrupt is the compare channel A interrupt of a
+ * Timer/Counter which is not used for anything else, selected by
+ * \ref CONFIG_PROFILE_TC_ID. It runs at high interrupt level, so that low and
+ * medium level handlers are profiled as well. Time spent in other high level
+ * handlers, or with interrupts masked, is attributed to the instruction
+ * following the end of the masked section. On the host, the samples are
+ * taken from a \c SIGPROF timer counting the CPU time of the process.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_PROFILE_NR_SAMPLES
+ * \brief Number of samples the sample buffer can hold.
+ *
+ * Each sample takes four bytes of huge memory.
+ */
+#ifndef CONFIG_PROFILE_NR_SAMPLES
+# define CONFIG_PROFILE_NR_SAMPLES      4096
+#endif
+
+/**
+ * \def CONFIG_PROFILE_TC_ID
+ * \brief ID of the Timer/Counter generating the sampling interrupt.
+ *
+ * The Timer/Counter must not be used by the \ref timer_group "timer driver"
+ * or anything else.
+ */
+
+//! \name Sample layout
+//@{
+//! Mask of the byte address of the sampled instruction.
+#define PROFILE_SAMPLE_PC_MASK          0x00ffffffUL
+//! Bit position of the context flags.
+#define PROFILE_SAMPLE_CTX_SHIFT        24
+//! A low level interrupt handler was executing.
+#define PROFILE_CTX_IRQ_LOW             (1 << 0)
+//! A medium level interrupt handler was executing.
+#define PROFILE_CTX_IRQ_MEDIUM          (1 << 1)
+//@}
+
+void profile_init(void);
+void profile_start(uint32_t rate);
+void profile_stop(void);
+void profile_reset(void);
+uint16_t profile_get_nr_samples(void);
+void profile_dump(void);
+
+//! \name Sampling timer backend
+//@{
+void profile_priv_record(uint32_t sample);
+uint32_t profile_priv_timer_start(uint32_t rate);
+void profile_priv_timer_stop(void);
+//@}
+
+//! @}
+
+#endif /* PROFILE_H_INCLUDED */
@@ -0,0 +1,207 @@
+/**
+ * \file
+ *
+ * \brief AVR32 DMA Controller (DMACA) register definitions
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef REGS_AVR32_DMACA_H_INCLUDED
+#define REGS_AVR32_DMACA_H_INCLUDED
+
+/**
+ * \ingroup regs_group
+ * \defgroup avr32_dmaca_regs_group AVR32 DMACA Register Definitions
+ *
+ * This is the register interface to the DMA Controller (DMACA) present on
+ * the AT32UC3A3. Only the registers used for memory-to-memory transfers are
+ * defined.
+ *
+ * @{
+ */
+
+//! \name Channel Register Offsets
+//@{
+#define DMACA_CHAN_SAR			0x0000	//!< Source Address
+#define DMACA_CHAN_DAR			0x0008	//!< Destination Address
+#define DMACA_CHAN_LLP			0x0010	//!< Linked List Pointer
+#define DMACA_CHAN_CTL_LO		0x0018	//!< Control, low word
+#define DMACA_CHAN_CTL_HI		0x001c	//!< Control, high word
+#define DMACA_CHAN_CFG_LO		0x0040	//!< Configuration, low word
+#define DMACA_CHAN_CFG_HI		0x0044	//!< Configuration, high word
+//@}
+
+//! Offset between the register sets of two channels.
+#define DMACA_CHAN_REGS_SIZE		0x0058
+
+//! \name Global Register Offsets
+//@{
+#define DMACA_RAW_TFR			0x02c0	//!< Raw Transfer Complete
+#define DMACA_RAW_BLOCK			0x02c8	//!< Raw Block Complete
+#define DMACA_RAW_ERR			0x02e0	//!< Raw Error
+#define DMACA_STATUS_TFR		0x02e8	//!< Transfer Complete Status
+#define DMACA_STATUS_ERR		0x0308	//!< Error Status
+#define DMACA_MASK_TFR			0x0310	//!< Transfer Complete Mask
+#define DMACA_MASK_BLOCK		0x0318	//!< Block Complete Mask
+#define DMACA_MASK_ERR			0x0330	//!< Error Mask
+#define DMACA_CLEAR_TFR			0x0338	//!< Transfer Complete Clear
+#define DMACA_CLEAR_BLOCK		0x0340	//!< Block Complete Clear
+#define DMACA_CLEAR_ERR			0x0358	//!< Error Clear
+#define DMACA_STATUS_INT		0x0360	//!< Combined Interrupt Status
+#define DMACA_DMA_CFG			0x0398	//!< DMA Configuration
+#define DMACA_CH_EN			0x03a0	//!< Channel Enable
+//@}
+
+//! \name Bitfields in CTL_LO
+//@{
+#define DMACA_CTL_INT_EN_BIT		0	//!< Interrupt Enable
+#define DMACA_CTL_DST_TR_WIDTH_START	1	//!< Destination Transfer Width
+#define DMACA_CTL_DST_TR_WIDTH_SIZE	3	//!< Destination Transfer Width
+#define DMACA_CTL_SRC_TR_WIDTH_START	4	//!< Source Transfer Width
+#define DMACA_CTL_SRC_TR_WIDTH_SIZE	3	//!< Source Transfer Width
+#define DMACA_CTL_DINC_START		7	//!< Destination Address Increment
+#define DMACA_CTL_DINC_SIZE		2	//!< Destination Address Increment
+#define DMACA_CTL_SINC_START		9	//!< Source Address Increment
+#define DMACA_CTL_SINC_SIZE		2	//!< Source Address Increment
+#define DMACA_CTL_DST_MSIZE_START	11	//!< Destination Burst Length
+#define DMACA_CTL_DST_MSIZE_SIZE	3	//!< Destination Burst Length
+#define DMACA_CTL_SRC_MSIZE_START	14	//!< Source Burst Length
+#define DMACA_CTL_SRC_MSIZE_SIZE	3	//!< Source Burst Length
+#define DMACA_CTL_TT_FC_START		20	//!< Transfer Type and Flow Control
+#define DMACA_CTL_TT_FC_SIZE		3	//!< Transfer Type and Flow Control
+#define DMACA_CTL_DMS_START		23	//!< Destination Master Select
+#define DMACA_CTL_DMS_SIZE		2	//!< Destination Master Select
+#define DMACA_CTL_SMS_START		25	//!< Source Master Select
+#define DMACA_CTL_SMS_SIZE		2	//!< Source Master Select
+//@}
+
+//! \name Bitfields in CTL_HI
+//@{
+#define DMACA_CTL_BLOCK_TS_START	0	//!< Block Transfer Size
+#define DMACA_CTL_BLOCK_TS_SIZE		12	//!< Block Transfer Size
+#define DMACA_CTL_DONE_BIT		12	//!< Block Done
+//@}
+
+//! \name Bitfields in CFG_LO
+//@{
+#define DMACA_CFG_CH_PRIOR_START	5	//!< Channel Priority
+#define DMACA_CFG_CH_PRIOR_SIZE		3	//!< Channel Priority
+#define DMACA_CFG_CH_SUSP_BIT		8	//!< Channel Suspend
+#define DMACA_CFG_FIFO_EMPTY_BIT	9	//!< Channel FIFO Empty
+//@}
+
+//! \name Bitfields in CFG_HI
+//@{
+#define DMACA_CFG_FCMODE_BIT		0	//!< Flow Control Mode
+#define DMACA_CFG_FIFO_MODE_BIT		1	//!< FIFO Mode Select
+//@}
+
+//! \name Bitfields in DMA_CFG
+//@{
+#define DMACA_DMA_CFG_DMA_EN_BIT	0	//!< DMA Controller Enable
+//@}
+
+//! \name Bitfields in CH_EN and the interrupt registers
+//@{
+#define DMACA_CH_START			0	//!< Channel bits
+#define DMACA_CH_SIZE			8	//!< Channel bits
+#define DMACA_CH_WE_START		8	//!< Write enable for channel bits
+#define DMACA_CH_WE_SIZE		8	//!< Write enable for channel bits
+//@}
+
+//! \name CTL_SRC_TR_WIDTH and CTL_DST_TR_WIDTH Bitfield Values
+//@{
+#define DMACA_TR_WIDTH_8		0	//!< 8 bits
+#define DMACA_TR_WIDTH_16		1	//!< 16 bits
+#define DMACA_TR_WIDTH_32		2	//!< 32 bits
+//@}
+
+//! \name CTL_SINC and CTL_DINC Bitfield Values
+//@{
+#define DMACA_INC_INCREMENT		0	//!< Increment the address
+#define DMACA_INC_DECREMENT		1	//!< Decrement the address
+#define DMACA_INC_NO_CHANGE		2	//!< Keep the address fixed
+//@}
+
+//! \name CTL_SRC_MSIZE and CTL_DST_MSIZE Bitfield Values
+//@{
+#define DMACA_MSIZE_1			0	//!< 1 item per burst
+#define DMACA_MSIZE_4			1	//!< 4 items per burst
+#define DMACA_MSIZE_8			2	//!< 8 items per burst
+#define DMACA_MSIZE_16			3	//!< 16 items per burst
+//@}
+
+//! \name CTL_TT_FC Bitfield Values
+//@{
+//! Memory to memory, flow controlled by the DMACA
+#define DMACA_TT_FC_MEM2MEM_DMA		0
+//@}
+
+//! Maximum number of items in one block.
+#define DMACA_MAX_BLOCK_TS		((1U << DMACA_CTL_BLOCK_TS_SIZE) - 1)
+
+//! \name Bit manipulation macros
+//@{
+//! \brief Create a mask with bit \a name set.
+#define DMACA_BIT(name)							\
+	(1U << DMACA_##name##_BIT)
+//! \brief Create a mask with bitfield \a name set to \a value.
+#define DMACA_BF(name, value)						\
+	((value) << DMACA_##name##_START)
+//! \brief Extract the value of bitfield \a name from \a regval.
+#define DMACA_BFEXT(name, regval)					\
+	(((regval) >> DMACA_##name##_START)				\
+		& ((1U << DMACA_##name##_SIZE) - 1))
+//@}
+
+//! \name Register access macros
+//@{
+//! \brief Read the value of DMACA register \a reg.
+#define dmaca_read_reg(base, reg)					\
+	mmio_read32((void *)((uintptr_t)(base) + DMACA_##reg))
+//! \brief Write \a value to DMACA register \a reg.
+#define dmaca_write_reg(base, reg, value)				\
+	mmio_write32((void *)((uintptr_t)(base) + DMACA_##reg), (value))
+//! \brief Read the value of register \a reg of channel \a ch.
+#define dmaca_chan_read_reg(base, ch, reg)				\
+	mmio_read32((void *)((uintptr_t)(base)				\
+			+ (ch) * DMACA_CHAN_REGS_SIZE + DMACA_CHAN_##reg))
+//! \brief Write \a value to register \a reg of channel \a ch.
+#define dmaca_chan_write_reg(base, ch, reg, value)			\
+	mmio_write32((void *)((uintptr_t)(base)				\
+			+ (ch) * DMACA_CHAN_REGS_SIZE + DMACA_CHAN_##reg), \
+			(value))
+//@}
+
+//! @}
+
+#endif /* REGS_AVR32_DMACA_H_INCLUDED */
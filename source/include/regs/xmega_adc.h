@@ -204,7 +204,7 @@
 #define ADC_CH0IF_BIT          0  //!< ADC channel 0 interrupt flag
 #define ADC_CH1IF_BIT          1  //!< ADC channel 1 interrupt flag
 #define ADC_CH2IF_BIT          2  //!< ADC channel 2 interrupt flag
-#define ADC_CH3IF_BIT          4  //!< ADC channel 3 interrupt flag
+#define ADC_CH3IF_BIT          3  //!< ADC channel 3 interrupt flag
 //@}
 
 //! \name Bit manipulation macros
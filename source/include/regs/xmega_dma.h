@@ -0,0 +1,178 @@
+/**
+ * \file
+ *
+ * \brief ATxmega DMA Controller registers.
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+
+#ifndef REGS_XMEGA_DMA_H_INCLUDED
+#define REGS_XMEGA_DMA_H_INCLUDED
+
+#include <io.h>
+
+/**
+ * \ingroup regs_group
+ * \defgroup dma_regs_group DMA Controller Register Definitions
+ * @{
+ */
+
+//! \name Controller Register Offset
+//@{
+#define DMA_CTRL                        0x00    //!< Control Register
+#define DMA_INTFLAGS                    0x03    //!< Interrupt Status Register
+#define DMA_STATUS                      0x04    //!< Status Register
+//@}
+
+//! \name Channel Register Offset
+//@{
+#define DMA_CH_CTRLA                    0x00    //!< Channel Control A
+#define DMA_CH_CTRLB                    0x01    //!< Channel Control B
+#define DMA_CH_ADDRCTRL                 0x02    //!< Address Control
+#define DMA_CH_TRIGSRC                  0x03    //!< Trigger Source
+#define DMA_CH_TRFCNT                   0x04    //!< Block Transfer Count
+#define DMA_CH_REPCNT                   0x06    //!< Repeat Count
+#define DMA_CH_SRCADDR0                 0x08    //!< Source Address 0
+#define DMA_CH_SRCADDR1                 0x09    //!< Source Address 1
+#define DMA_CH_SRCADDR2                 0x0a    //!< Source Address 2
+#define DMA_CH_DESTADDR0                0x0c    //!< Destination Address 0
+#define DMA_CH_DESTADDR1                0x0d    //!< Destination Address 1
+#define DMA_CH_DESTADDR2                0x0e    //!< Destination Address 2
+//@}
+
+//! Offset of the registers of channel \a ch from the controller base
+#define DMA_CH_OFFSET(ch)               (0x10 + 0x10 * (ch))
+
+// \name Bitfields in CTRL
+//@{
+#define DMA_CTRL_PRIMODE_START          0       //!< Channel Priority Mode
+#define DMA_CTRL_PRIMODE_SIZE           2       //!< Channel Priority Mode
+#define DMA_CTRL_DBUFMODE_START         2       //!< Double Buffer Mode
+#define DMA_CTRL_DBUFMODE_SIZE          2       //!< Double Buffer Mode
+#define DMA_CTRL_RESET_BIT              6       //!< Software Reset
+#define DMA_CTRL_ENABLE_BIT             7       //!< Enable
+//@}
+
+// \name Bitfields in CH_CTRLA
+//@{
+#define DMA_CH_CTRLA_BURSTLEN_START     0       //!< Burst Length
+#define DMA_CH_CTRLA_BURSTLEN_SIZE      2       //!< Burst Length
+#define DMA_CH_CTRLA_SINGLE_BIT         2       //!< Single Shot Data Transfer
+#define DMA_CH_CTRLA_TRFREQ_BIT         4       //!< Transfer Request
+#define DMA_CH_CTRLA_REPEAT_BIT         5       //!< Repeat Mode
+#define DMA_CH_CTRLA_RESET_BIT          6       //!< Channel Software Reset
+#define DMA_CH_CTRLA_ENABLE_BIT         7       //!< Channel Enable
+//@}
+
+// \name Bitfields in CH_CTRLB
+//@{
+#define DMA_CH_CTRLB_TRNINTLVL_START    0       //!< Transaction Complete Level
+#define DMA_CH_CTRLB_TRNINTLVL_SIZE     2       //!< Transaction Complete Level
+#define DMA_CH_CTRLB_ERRINTLVL_START    2       //!< Error Interrupt Level
+#define DMA_CH_CTRLB_ERRINTLVL_SIZE     2       //!< Error Interrupt Level
+#define DMA_CH_CTRLB_TRNIF_BIT          4       //!< Transaction Complete Flag
+#define DMA_CH_CTRLB_ERRIF_BIT          5       //!< Error Flag
+#define DMA_CH_CTRLB_CHPEND_BIT         6       //!< Channel Pending
+#define DMA_CH_CTRLB_CHBUSY_BIT         7       //!< Channel Busy
+//@}
+
+// \name Bitfields in CH_ADDRCTRL
+//@{
+#define DMA_CH_ADDRCTRL_DESTDIR_START    0      //!< Destination Address Mode
+#define DMA_CH_ADDRCTRL_DESTDIR_SIZE     2      //!< Destination Address Mode
+#define DMA_CH_ADDRCTRL_DESTRELOAD_START 2      //!< Destination Address Reload
+#define DMA_CH_ADDRCTRL_DESTRELOAD_SIZE  2      //!< Destination Address Reload
+#define DMA_CH_ADDRCTRL_SRCDIR_START     4      //!< Source Address Mode
+#define DMA_CH_ADDRCTRL_SRCDIR_SIZE      2      //!< Source Address Mode
+#define DMA_CH_ADDRCTRL_SRCRELOAD_START  6      //!< Source Address Reload
+#define DMA_CH_ADDRCTRL_SRCRELOAD_SIZE   2      //!< Source Address Reload
+//@}
+
+//! \name Burst lengths
+//@{
+#define DMA_BURSTLEN_1BYTE              0       //!< 1 byte per burst
+#define DMA_BURSTLEN_2BYTE              1       //!< 2 bytes per burst
+#define DMA_BURSTLEN_4BYTE              2       //!< 4 bytes per burst
+#define DMA_BURSTLEN_8BYTE              3       //!< 8 bytes per burst
+//@}
+
+//! \name Address modes
+//@{
+#define DMA_DIR_FIXED                   0       //!< Fixed address
+#define DMA_DIR_INC                     1       //!< Increment address
+#define DMA_DIR_DEC                     2       //!< Decrement address
+//@}
+
+//! \name Address reload modes
+//@{
+#define DMA_RELOAD_NONE                 0       //!< No reload
+#define DMA_RELOAD_BLOCK                1       //!< Reload after each block
+#define DMA_RELOAD_BURST                2       //!< Reload after each burst
+#define DMA_RELOAD_TRANSACTION          3       //!< Reload after transaction
+//@}
+
+//! \name Bit manipulation macros
+//@{
+//! \brief Create a mask with bit \a name set
+#define DMA_BIT(name)                                   \
+	(1 << DMA_##name##_BIT)
+//! \brief Create a mask with bitfield \a name set to \a value
+#define DMA_BF(name,value)                              \
+	(((value) & ((1 << DMA_##name##_SIZE) - 1))     \
+	 << DMA_##name##_START)
+//@}
+
+//! \name Register access macros
+//@{
+//! \brief Write \a value to DMA controller register \a reg
+#define dma_write_reg(reg, value) \
+	mmio_write8((void *)(DMA_BASE + DMA_##reg), value)
+//! \brief Read the value of DMA controller register \a reg
+#define dma_read_reg(reg) \
+	mmio_read8((void *)(DMA_BASE + DMA_##reg))
+//! \brief Write \a value to register \a reg of DMA channel \a ch
+#define dma_ch_write_reg(ch, reg, value) \
+	mmio_write8((void *)(DMA_BASE + DMA_CH_OFFSET(ch) \
+			+ DMA_CH_##reg), value)
+//! \brief Write 16-bit \a value to register \a reg of DMA channel \a ch
+#define dma_ch_write_reg16(ch, reg, value) \
+	mmio_write16((void *)(DMA_BASE + DMA_CH_OFFSET(ch) \
+			+ DMA_CH_##reg), value)
+//! \brief Read the value of register \a reg of DMA channel \a ch
+#define dma_ch_read_reg(ch, reg) \
+	mmio_read8((void *)(DMA_BASE + DMA_CH_OFFSET(ch) \
+			+ DMA_CH_##reg))
+//@}
+
+//! @}
+#endif /* REGS_XMEGA_DMA_H_INCLUDED */
@@ -0,0 +1,97 @@
+/**
+ * \file
+ *
+ * \brief XMEGA Sleep Controller register definitions
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef REGS_XMEGA_SLEEP_H_INCLUDED
+#define REGS_XMEGA_SLEEP_H_INCLUDED
+
+#include <chip/memory-map.h>
+#include <io.h>
+
+/**
+ * \ingroup regs_group
+ * \defgroup xmega_sleep_regs_group XMEGA Sleep Controller Register Definitions
+ *
+ * These are the XMEGA Sleep Controller registers taken from the XMEGA A
+ * manual.
+ *
+ * @{
+ */
+
+//! \name Register Offsets
+//@{
+#define XMEGA_SLEEP_CTRL        0x00    //!< Control Register
+//@}
+
+//! \name Bitfields in CTRL
+//@{
+#define SLEEP_SEN_BIT           0       //!< Sleep Enable
+#define SLEEP_SMODE_START       1       //!< Sleep Mode
+#define SLEEP_SMODE_SIZE        3
+//@}
+
+//! \name Sleep Mode values
+//@{
+#define SLEEP_SMODE_IDLE        0       //!< Idle
+#define SLEEP_SMODE_PDOWN       2       //!< Power-down
+#define SLEEP_SMODE_PSAVE       3       //!< Power-save
+#define SLEEP_SMODE_STDBY       6       //!< Standby
+#define SLEEP_SMODE_ESTDBY      7       //!< Extended Standby
+//@}
+
+//! \name Bit manipulation macros
+//@{
+//! \brief Create a mask with bit \a name set.
+#define SLEEP_BIT(name)         (1U << SLEEP_##name##_BIT)
+//! \brief Create a mask with bitfield \a name set to \a value.
+#define SLEEP_BF(name, value)                                   \
+	(((value) & ((1U << SLEEP_##name##_SIZE) - 1))          \
+		<< SLEEP_##name##_START)
+//@}
+
+//! \name Register access macros
+//@{
+//! \brief Read the value of Sleep Controller register \a reg.
+#define sleep_read_reg(reg)                                     \
+	mmio_read8((void *)(SLEEP_BASE + XMEGA_SLEEP_##reg))
+//! \brief Write \a value to Sleep Controller register \a reg.
+#define sleep_write_reg(reg, value)                             \
+	mmio_write8((void *)(SLEEP_BASE + XMEGA_SLEEP_##reg), (value))
+//@}
+
+//! @}
+
+#endif /* REGS_XMEGA_SLEEP_H_INCLUDED */
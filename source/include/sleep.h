@@ -54,9 +54,9 @@
  * mode. This will all happen atomically, so no interrupts will be
  * handled before the sleep instruction has been executed.
  *
- * \todo Currently, no sleep modes deeper than Idle will be entered.
- * Deeper sleep modes will require a proper sleep manager to be
- * implemented and supported by all drivers.
+ * This function never enters sleep modes deeper than Idle. Deeper
+ * sleep modes are entered by the \ref sleepmgr_group "sleep manager",
+ * which the main loop uses instead if \a CONFIG_SLEEPMGR is defined.
  *
  * \pre Interrupts are disabled
  * \post Interrupts are enabled
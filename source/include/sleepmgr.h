@@ -0,0 +1,151 @@
+/**
+ * \file
+ *
+ * \brief Sleep manager
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef SLEEPMGR_H_INCLUDED
+#define SLEEPMGR_H_INCLUDED
+
+#include <compiler.h>
+#include <types.h>
+#include <cpu/sleepmgr.h>
+
+/**
+ * \ingroup mainloop_group
+ * \defgroup sleepmgr_group Sleep Manager
+ *
+ * If \a CONFIG_SLEEPMGR is defined, the main loop lets the sleep manager
+ * pick the sleep mode whenever \ref main_workqueue is empty, instead of
+ * always entering the mode chosen by cpu_enter_sleep().
+ *
+ * The sleep modes of the CPU are listed in enum sleepmgr_mode, starting
+ * with #SLEEPMGR_ACTIVE (not sleeping at all) followed by the other modes
+ * from the shallowest to the deepest. Each deeper mode stops more clocks,
+ * so fewer peripherals keep running and fewer events can wake up the CPU.
+ *
+ * Drivers register the constraints of their peripherals by calling
+ * sleepmgr_lock_mode() with the deepest mode in which the peripheral
+ * still works while it is in use, and sleepmgr_unlock_mode() when it is
+ * done. Each mode has a lock count, so several users may lock the same
+ * mode. The main loop then enters the deepest mode which is not deeper
+ * than any of the locked modes, or the deepest mode of the CPU if
+ * nothing is locked. The following drivers lock a mode:
+ *   - The \ref timer_group "timers" while they are running, so pending
+ *     alarms, including those of \ref delayed_task_group "delayed
+ *     tasks", keep the CPU out of the modes which would stop them.
+ *   - The SPI master drivers while a transfer is in progress.
+ *   - The USB device controller drivers while attached to the bus.
+ *   - The board code of boards using SDRAM through the EBI, since the
+ *     SDRAM must be refreshed.
+ *
+ * Other peripherals, e.g. a UART sending debug output, must be covered
+ * by the application locking a suitable mode.
+ *
+ * If \a CONFIG_SLEEPMGR_STATS is defined as well, the sleep manager
+ * counts the number of times each mode was entered and how long the CPU
+ * stayed in it, and how long it was awake in between. It also records
+ * which interrupt woke up the CPU: all interrupt handlers defined by
+ * INTC_DEFINE_HANDLER() check if they are the first to run after a
+ * sleep. Times are taken from the \ref timer_group "timer"
+ * \a CONFIG_TIMER_ID, which the application must set up and start before
+ * passing it to sleepmgr_stats_init(). The counter is 16 bits wide, so
+ * the resolution should be low enough for the longest interesting sleep
+ * or awake period to fit. Note that the running timer locks a sleep mode
+ * itself.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_SLEEPMGR_NR_WAKE_SOURCES
+ * \brief Number of interrupts to keep wake-up statistics for.
+ *
+ * Wake-ups by other interrupts are counted, but not identified.
+ */
+#ifndef CONFIG_SLEEPMGR_NR_WAKE_SOURCES
+# define CONFIG_SLEEPMGR_NR_WAKE_SOURCES        8
+#endif
+
+extern void sleepmgr_lock_mode(enum sleepmgr_mode mode);
+extern void sleepmgr_unlock_mode(enum sleepmgr_mode mode);
+extern enum sleepmgr_mode sleepmgr_get_sleep_mode(void);
+extern void sleepmgr_enter_sleep(void);
+
+#ifdef CONFIG_SLEEPMGR_STATS
+
+struct timer;
+
+extern void sleepmgr_stats_init(struct timer *timer, uint32_t resolution);
+extern void sleepmgr_stats_reset(void);
+extern void sleepmgr_stats_show(void);
+
+//! \internal True from entering a sleep mode until the first wake-up.
+extern bool sleepmgr_priv_sleeping;
+
+extern void sleepmgr_priv_woken_by(uint8_t id);
+
+/**
+ * \internal
+ * \brief Record interrupt \a id as the wake-up source if the CPU slept
+ *
+ * This is called on entry to every interrupt handler.
+ */
+static inline void sleepmgr_priv_irq_wake(uint8_t id)
+{
+	if (sleepmgr_priv_sleeping)
+		sleepmgr_priv_woken_by(id);
+}
+
+#define sleepmgr_priv_irq_sym(id)       sleepmgr_priv_irq##id
+
+/**
+ * \internal
+ * \brief Define a function recording wake-ups by interrupt \a id
+ *
+ * This is used by INTC_DEFINE_HANDLER(), which binds the function to the
+ * interrupt instead of \a handler.
+ */
+#define SLEEPMGR_DEFINE_IRQ_HANDLER(id, handler)                        \
+	static void __used sleepmgr_priv_irq_sym(id)(void *data)        \
+	{                                                               \
+		sleepmgr_priv_irq_wake(id);                             \
+		handler(data);                                          \
+	}
+
+#endif /* CONFIG_SLEEPMGR_STATS */
+
+//! @}
+
+#endif /* SLEEPMGR_H_INCLUDED */
@@ -58,6 +58,9 @@ enum spi_polled_op_flags {
 /**
  * \brief SPI start transfer function
  *
+ * Writes the first byte and arranges for the rest of the transfer to be
+ * handled, either by scheduling the poll task or by enabling interrupts.
+ *
  * \param spim    SPI master struct
  * \param tx_byte First byte to be written
  */
@@ -143,6 +146,8 @@ static inline void spi_polled_sched_poll(struct spi_master *spim)
 	workqueue_add_task(&main_workqueue, &spim_poll->poll);
 }
 
+bool spi_polled_load_next_buffer(struct spi_master *spim, uint8_t *tx_byte,
+		size_t *len);
 void spi_polled_next_buffer(struct workqueue_task *task);
 
 /**
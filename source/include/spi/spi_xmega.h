@@ -39,6 +39,7 @@
 #define SPI_SPI_XMEGA_H_INCLUDED
 
 #include <clk/sys.h>
+#include <pmic.h>
 #include <spi/spi_polled.h>
 
 /**
@@ -172,6 +173,33 @@ static inline void spi_priv_deselect_device_regs(struct spi_master *spim,
 {
 }
 
+#ifdef CONFIG_SPI_MASTER_INT
+/**
+ * \brief Interrupt level for interrupt driven SPI master transfers
+ */
+# ifndef CONFIG_SPI_MASTER_INTLVL
+#  define CONFIG_SPI_MASTER_INTLVL	PMIC_INTLVL_LOW
+# endif
+
+static inline void spi_priv_enable_int(struct spi_master *spim)
+{
+	struct spi_master_priv *spim_p = spi_master_priv_of(spim);
+
+	spi_write_reg(spim_p->regs, INTCTRL,
+			SPI_BF(INTCTRL_INTLVL, CONFIG_SPI_MASTER_INTLVL));
+}
+
+static inline void spi_priv_disable_int(struct spi_master *spim)
+{
+	struct spi_master_priv *spim_p = spi_master_priv_of(spim);
+
+	spi_write_reg(spim_p->regs, INTCTRL, 0);
+}
+
+void spi_priv_int_start(struct spi_master *spim, uint8_t tx_byte);
+void spi_priv_int_master_init(spi_id_t spi_id, struct spi_master *spim);
+#endif
+
 static inline void spi_priv_master_init_regs(spi_id_t spi_id,
 		struct spi_master *spim)
 {
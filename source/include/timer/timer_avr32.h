@@ -90,6 +90,10 @@ struct timer {
 	void *regs;
 	/** Function pointer to application timer callback function*/
 	void (*callback)(struct timer *timer);
+#ifdef CONFIG_SLEEPMGR
+	/** True if the counter clock is enabled. */
+	bool running;
+#endif
 };
 
 /**
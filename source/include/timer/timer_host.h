@@ -0,0 +1,162 @@
+/**
+ * \file
+ *
+ * \brief Timer driver for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef TIMER_TIMER_HOST_H_INCLUDED
+#define TIMER_TIMER_HOST_H_INCLUDED
+
+#include <types.h>
+#include <arch/host_clock.h>
+
+/**
+ * \ingroup timer_group
+ * \defgroup timer_host_group Host timer driver
+ *
+ * The host timers count ticks on the virtual clock, so alarms are
+ * delivered at exactly the right time however long the application
+ * takes to run. Like the XMEGA TC, a timer has a 16-bit counter and the
+ * callback is run in interrupt context.
+ *
+ * @{
+ */
+
+//! Timer resolution, stored as a tick rate in Hz.
+typedef uint32_t timer_res_t;
+
+struct timer;
+
+/**
+ * \brief Timer callback function
+ *
+ * \param timer The timer which triggered.
+ */
+typedef void (*timer_callback_t) (struct timer *timer);
+
+/**
+ * \brief Timer control structure
+ */
+struct timer {
+	//! Virtual clock event for the alarm.
+	struct host_event	event;
+	//! Virtual clock time at which the counter was started.
+	host_time_t		start;
+	//! Tick rate in Hz.
+	timer_res_t		resolution;
+	//! Function pointer to application timer callback function.
+	timer_callback_t	callback;
+	//! ID of the timer.
+	uint8_t			id;
+	//! True if the counter is running.
+	bool			running;
+};
+
+#define TIMER_SELECT(func, timer_id, ...)                                  \
+	timer##timer_id##_##func##_priv(__VA_ARGS__)
+
+#define timer_init(timer_id, timer, timer_callback)                        \
+	TIMER_SELECT(init, timer_id, timer, timer_callback)
+
+#define timer_start(timer_id, timer)                                       \
+	TIMER_SELECT(start, timer_id, timer)
+
+#define timer_stop(timer_id, timer)                                        \
+	TIMER_SELECT(stop, timer_id, timer)
+
+#define timer_set_alarm(timer_id, timer, delay)                            \
+	TIMER_SELECT(set_alarm, timer_id, timer, delay)
+
+#define timer_get_time(timer_id, timer)                                    \
+	TIMER_SELECT(get_time, timer_id, timer)
+
+#define timer_default_resolution(timer_id)                                 \
+	TIMER_SELECT(default_resolution, timer_id)
+
+#define timer_write_resolution(timer_id, timer, timer_resolution)          \
+	TIMER_SELECT(write_resolution, timer_id, timer, timer_resolution)
+
+#define timer_read_resolution(timer_id, timer)                             \
+	TIMER_SELECT(read_resolution, timer_id, timer)
+
+#define timer_set_resolution(timer_id, timer, resolution)                  \
+	TIMER_SELECT(set_resolution, timer_id, timer, resolution)
+
+#define timer_get_resolution(timer_id, timer, timer_resolution)            \
+	TIMER_SELECT(get_resolution, timer_id, timer, timer_resolution)
+
+#define timer_maximum_delta(timer_id, timer)                               \
+	TIMER_SELECT(get_maximum_delta, timer_id, timer)
+
+void host_timer_init(uint8_t id, struct timer *timer,
+		timer_callback_t callback);
+void host_timer_start(struct timer *timer);
+void host_timer_stop(struct timer *timer);
+void host_timer_set_alarm(struct timer *timer, uint16_t delay);
+uint16_t host_timer_get_time(struct timer *timer);
+
+static inline timer_res_t host_timer_default_resolution(void)
+{
+	return CONFIG_TIMER_RESOLUTION;
+}
+
+static inline timer_res_t host_timer_set_resolution(uint32_t resolution)
+{
+	return resolution;
+}
+
+static inline uint32_t host_timer_get_resolution(timer_res_t resolution)
+{
+	return resolution;
+}
+
+static inline void host_timer_write_resolution(struct timer *timer,
+		timer_res_t resolution)
+{
+	timer->resolution = resolution;
+}
+
+static inline timer_res_t host_timer_read_resolution(struct timer *timer)
+{
+	return timer->resolution;
+}
+
+static inline uint16_t host_timer_get_maximum_delta(void)
+{
+	return (uint16_t)~0;
+}
+
+//! @}
+
+#endif /* TIMER_TIMER_HOST_H_INCLUDED */
@@ -39,6 +39,7 @@
 #ifndef TOUCH_TOUCH_H
 #define TOUCH_TOUCH_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 /**
@@ -50,6 +51,15 @@
  * with ID \a SOFTIRQ_TOUCH_PROCESS for processing of measurements and
  * calling the current touch event handler function.
  *
+ * A consumer which cannot keep up with the sample rate of the driver, e.g.,
+ * a user interface which redraws on every move, can make the driver pace its
+ * sampling with \ref touch_set_paced(). The driver will then not start a new
+ * measurement after a press or move event until \ref touch_event_consumed()
+ * has been called, adapting the sample rate to the rate of the consumer.
+ * Pacing only applies while the handler which enabled it is installed, so
+ * e.g. a calibration screen temporarily replacing the handler of the window
+ * system does not have to acknowledge its events.
+ *
  * \pre
  * For 4-wire resistive touch with XMEGA, the driver needs the following
  * configuration symbols to be defined:
@@ -161,7 +171,57 @@
  * which in turn is limited by the ADC resolution.\n The driver accumulates the
  * samples in unsigned 16-bit integers, meaning this setting should not be
  * higher than 16 - \a N_bits (number of bits in maximum sample value).
+ *
+ * \note Drivers which sample several channels per conversion sweep, such as
+ * the XMEGA driver, require this to be at least 1.
+ */
+
+/**
+ * \name Position filtering
+ *
+ * If \a CONFIG_TOUCH_FILTER is defined, the raw samples of each touch are
+ * passed through a median-of-three filter to reject spikes, followed by a
+ * first-order IIR filter to smooth out noise. The filter state is reset on
+ * every new touch, so the first position of a touch is never delayed.
+ *
+ * @{
+ */
+
+/**
+ * \def CONFIG_TOUCH_FILTER
+ *
+ * \brief Enable median and IIR filtering of touch positions.
+ */
+
+/**
+ * \def CONFIG_TOUCH_FILTER_IIR_SHIFT
+ *
+ * \brief IIR filter coefficient, as an exponent of 2.
+ *
+ * Each new sample is weighted by 1 / 2^N in the filtered position. A value of
+ * 0 disables the IIR filter, leaving only the median filter.
+ */
+#ifndef CONFIG_TOUCH_FILTER_IIR_SHIFT
+# define CONFIG_TOUCH_FILTER_IIR_SHIFT  1
+#endif
+
+//@}
+
+/**
+ * \def CONFIG_TOUCH_MOVE_THRESHOLD
+ *
+ * \brief Minimum panel distance, in pixels, for a move event.
+ *
+ * A \ref TOUCH_MOVE event is only sent when the calibrated position has
+ * changed by at least this much along either axis since the last event.
  */
+#ifndef CONFIG_TOUCH_MOVE_THRESHOLD
+# ifdef CONFIG_TOUCH_FILTER
+#  define CONFIG_TOUCH_MOVE_THRESHOLD  2
+# else
+#  define CONFIG_TOUCH_MOVE_THRESHOLD  1
+# endif
+#endif
 
 
 //! Panel coordinate and measurement data of a single touch.
@@ -232,6 +292,8 @@ void touch_compute_calibration_matrix(
 		struct touch_calibration_matrix *matrix);
 void touch_set_event_handler(touch_event_handler_t handler);
 touch_event_handler_t touch_get_event_handler(void);
+void touch_set_paced(bool paced);
+void touch_event_consumed(void);
 
 //@}
 
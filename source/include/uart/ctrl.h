@@ -124,6 +124,8 @@
 # include <uart/ctrl_mega.h>
 #elif defined(CONFIG_CPU_XMEGA)
 # include <uart/ctrl_xmega.h>
+#elif defined(CONFIG_ARCH_HOST)
+# include <uart/ctrl_host.h>
 #endif
 
 /**
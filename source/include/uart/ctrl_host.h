@@ -0,0 +1,165 @@
+/**
+ * \file
+ *
+ * \brief UART control interface for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef UART_CTRL_HOST_H_INCLUDED
+#define UART_CTRL_HOST_H_INCLUDED
+
+#include <assert.h>
+#include <types.h>
+
+/**
+ * \weakgroup uart_ctrl_group
+ * @{
+ */
+
+/*
+ * The standard input and output of the host have no line settings, so
+ * the values below are only stored to keep the API happy.
+ */
+
+//! Host representation of a baud rate
+struct uart_baud {
+	uint32_t	rate;
+};
+
+//! Host representation of a set of communication parameters
+struct uart_mode {
+	uint8_t		chrlen;
+	uint8_t		stop_bits;
+	uint8_t		parity;
+};
+
+enum uart_mode_sb {
+	UART_MODE_SB_1		= 0,	//!< 1 stop bit
+	UART_MODE_SB_2		= 1,	//!< 2 stop bits
+};
+
+enum uart_mode_par {
+	UART_MODE_PAR_NONE	= 0,	//!< No parity
+	UART_MODE_PAR_EVEN	= 2,	//!< Even parity
+	UART_MODE_PAR_ODD	= 3,	//!< Odd parity
+};
+
+static inline struct uart_mode uart_mode_defaults(unsigned int uart_id)
+{
+	return (struct uart_mode){ .chrlen = 8 };
+}
+
+#define uart_mode_read(uart_id)                 uart_mode_defaults(uart_id)
+
+static inline void uart_mode_write(unsigned int uart_id,
+		struct uart_mode *mode)
+{
+	/* The simulated UART has no mode register */
+}
+
+static inline struct uart_mode *uart_mode_set_chrlen(unsigned int uart_id,
+		struct uart_mode *mode, uint8_t bits)
+{
+	assert(bits >= 5 && bits <= 8);
+
+	mode->chrlen = bits;
+	return mode;
+}
+
+static inline uint8_t uart_mode_get_chrlen(unsigned int uart_id,
+		struct uart_mode *mode)
+{
+	return mode->chrlen;
+}
+
+static inline bool uart_mode_chrlen_is_valid(unsigned int uart_id,
+		uint8_t bits)
+{
+	return bits >= 5 && bits <= 8;
+}
+
+static inline struct uart_mode *uart_mode_set_stop_bits(unsigned int uart_id,
+		struct uart_mode *mode, enum uart_mode_sb value)
+{
+	mode->stop_bits = value;
+	return mode;
+}
+
+static inline enum uart_mode_sb uart_mode_get_stop_bits(unsigned int uart_id,
+		struct uart_mode *mode)
+{
+	return mode->stop_bits;
+}
+
+static inline struct uart_mode *uart_mode_set_parity(unsigned int uart_id,
+		struct uart_mode *mode, enum uart_mode_par value)
+{
+	mode->parity = value;
+	return mode;
+}
+
+static inline enum uart_mode_par uart_mode_get_parity(unsigned int uart_id,
+		struct uart_mode *mode)
+{
+	return mode->parity;
+}
+
+static inline void uart_baud_default(unsigned int uart_id,
+		struct uart_baud *baud)
+{
+	baud->rate = CONFIG_UART_BAUD_RATE;
+}
+
+#define uart_baud_read(uart_id, baud)           uart_baud_default(uart_id, baud)
+
+static inline void uart_baud_write(unsigned int uart_id,
+		struct uart_baud *baud)
+{
+	/* The simulated UART has no baud rate register */
+}
+
+static inline void uart_baud_set_rate(unsigned int uart_id,
+		struct uart_baud *baud, uint32_t rate)
+{
+	baud->rate = rate;
+}
+
+static inline bool uart_baud_rate_is_valid(unsigned int uart_id,
+		struct uart_baud *baud, uint32_t rate)
+{
+	return rate != 0;
+}
+
+//! @}
+
+#endif /* UART_CTRL_HOST_H_INCLUDED */
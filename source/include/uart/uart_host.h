@@ -0,0 +1,81 @@
+/**
+ * \file
+ *
+ * \brief Simulated UART for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef UART_UART_HOST_H_INCLUDED
+#define UART_UART_HOST_H_INCLUDED
+
+#include <types.h>
+
+/**
+ * \ingroup uart_group
+ * \defgroup uart_host_group Host UART simulation
+ *
+ * All UARTs on the host are connected to the standard input and output
+ * of the application. The transmitter is always ready, and the
+ * receiver has a byte available whenever one can be read from standard
+ * input. When standard input reaches end of file, the application
+ * exits.
+ *
+ * @{
+ */
+
+typedef uint8_t uart_flags_t;
+
+#define UART_FLAG_TX		(1 << 0)
+#define UART_FLAG_RX		(1 << 1)
+
+extern void host_uart_enable(unsigned int uart_id, uart_flags_t flags);
+extern bool host_uart_put_byte(unsigned int uart_id, uint8_t data);
+extern bool host_uart_get_byte(unsigned int uart_id, uint8_t *data);
+extern bool host_uart_rx_is_ready(unsigned int uart_id);
+
+#define uart_enable(uart_id, flags)                     \
+	host_uart_enable(uart_id, flags)
+#define uart_transmit_is_complete(uart_id)      true
+#define uart_tx_buffer_is_empty(uart_id)        true
+#define uart_send_byte(uart_id, data)                   \
+	((void)host_uart_put_byte(uart_id, data))
+#define uart_put_byte(uart_id, data)                    \
+	host_uart_put_byte(uart_id, data)
+#define uart_rx_buffer_is_full(uart_id)                 \
+	host_uart_rx_is_ready(uart_id)
+#define uart_get_byte(uart_id, data)                    \
+	host_uart_get_byte(uart_id, data)
+
+//! @}
+
+#endif /* UART_UART_HOST_H_INCLUDED */
@@ -44,6 +44,10 @@
 #include <chip/uart.h>
 #include <regs/xmega_usart.h>
 
+#ifdef CONFIG_SLEEPMGR
+# include <sleepmgr.h>
+#endif
+
 /**
  * \weakgroup uart_simple_group
  * @{
@@ -69,12 +73,30 @@ typedef void *uart_t;
 #define uart_get_byte(uart_id, data) \
 	uart_get_byte_priv(uart_get_regs(uart_id), data)
 
+/*
+ * The USART needs the peripheral clock to shift data in and out, so the
+ * first uart_enable() of a USART keeps the sleep manager from going
+ * deeper than Idle. There is no way to disable a USART again, so the
+ * lock is never released.
+ */
+#ifdef CONFIG_SLEEPMGR
+# define uart_priv_lock_sleep(old_ctrlb)				\
+	do {								\
+		if (!((old_ctrlb) & (USART_BIT(TXEN) | USART_BIT(RXEN)))) \
+			sleepmgr_lock_mode(SLEEPMGR_IDLE);		\
+	} while (0)
+#else
+# define uart_priv_lock_sleep(old_ctrlb)	do { } while (0)
+#endif
+
 #define uart_enable(uart_id, flags)			\
 	do {						\
 		uint8_t	ctrlb;				\
 		uint8_t	_flags = (flags);		\
 		void	*regs = uart_get_regs(uart_id);	\
 		ctrlb = usart_read_reg(regs, CTRLB);	\
+		if (_flags)				\
+			uart_priv_lock_sleep(ctrlb);	\
 		if (_flags & UART_FLAG_TX)		\
 			ctrlb |= USART_BIT(TXEN);	\
 		if (_flags & UART_FLAG_RX)		\
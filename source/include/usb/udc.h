@@ -108,6 +108,8 @@ struct udc {
 # include <usb/udc_usbb.h>
 #elif defined(CONFIG_AT90USB_UDC)
 # include <usb/udc_at90usb.h>
+#elif defined(CONFIG_HOST_UDC)
+# include <usb/udc_host.h>
 #else
 /* Needed for the testsuite */
 extern void udc_set_address(struct udc *udc, unsigned int addr);
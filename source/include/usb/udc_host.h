@@ -0,0 +1,110 @@
+/**
+ * \file
+ *
+ * \brief Simulated USB Device Controller for the host
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#ifndef USB_UDC_HOST_H_INCLUDED
+#define USB_UDC_HOST_H_INCLUDED
+
+#include <types.h>
+
+/**
+ * \ingroup udc_group
+ * \defgroup udc_host_group Simulated USB Device Controller
+ *
+ * This UDC driver lets the USB device stack run natively on the build
+ * machine. Instead of a real bus, the controller is connected to a
+ * simulated USB host which is driven by the application through
+ * host_udc_submit() and host_udc_control().
+ *
+ * Bulk and interrupt data is moved between the host and the device
+ * requests one transaction at a time, and each transaction keeps the
+ * bus busy for as long as the packets would take on a real full-speed
+ * (or high-speed, with #CONFIG_UDC_HIGH_SPEED) bus, measured on the
+ * virtual clock. Endpoints that have no request queued on the device
+ * side are NAKed without taking any bus time. Control transfers are
+ * processed immediately.
+ *
+ * @{
+ */
+
+struct host_udc_xfer;
+
+/**
+ * \brief Function called when a simulated host transfer is done
+ *
+ * \param udc The USB Device Controller
+ * \param xfer The transfer that is done
+ */
+typedef void (*host_udc_xfer_done_t)(struct udc *udc,
+		struct host_udc_xfer *xfer);
+
+/**
+ * \brief A transfer issued by the simulated USB host
+ */
+struct host_udc_xfer {
+	//! Data to send or room for the data to receive
+	void			*data;
+	//! Number of bytes to send or receive
+	size_t			len;
+	//! Number of bytes actually transferred
+	size_t			actual;
+	/**
+	 * \brief Result of the transfer
+	 *
+	 * ERR_PROTOCOL means that the endpoint is halted, and
+	 * ERR_FLUSHED that the device has detached.
+	 */
+	status_t		status;
+	//! Function called when the transfer is done
+	host_udc_xfer_done_t	done;
+	//! Arbitrary data for use by the submitter
+	void			*context;
+};
+
+static inline void udc_set_address(struct udc *udc, unsigned int addr)
+{
+	/* The address is updated when the status stage is done. */
+}
+
+extern void host_udc_submit(struct udc *udc, uint8_t ep_addr,
+		struct host_udc_xfer *xfer);
+extern void host_udc_control(struct udc *udc,
+		const struct usb_setup_req *setup,
+		struct host_udc_xfer *xfer);
+
+//! @}
+
+#endif /* USB_UDC_HOST_H_INCLUDED */
@@ -58,6 +58,26 @@
  * - SCSI Primary Commands - 3 (SPC-3)
  * - SCSI Block Commands - 2 (SBC-2)
  *
+ * READ and WRITE data is staged in a dedicated pool of
+ * #CONFIG_UDI_MSC_NR_BUFFERS buffers of #CONFIG_UDI_MSC_BUFFER_SIZE bytes
+ * each, set aside by udi_msc_create_iface(). The memory is taken from
+ * the physmem pool named by \c APP_UDI_MSC_BUF_PHYSMEM_POOL in
+ * <app/usb.h>, which defaults to \c dma_sram_pool; boards with external
+ * RAM may use \c board_extram_pool to afford a larger pool.
+ *
+ * The buffers are handed out in up to #CONFIG_UDI_MSC_PIPELINE_DEPTH
+ * segments at a time, so that the block device can work on one segment
+ * while another is being moved over the bulk endpoints. Segments are
+ * made smaller towards the end of a transfer so that short transfers,
+ * e.g. 4 KiB file system accesses, are pipelined as well. Since each
+ * buffer may be moved in a USB request of its own, \c APP_USB_NR_REQUESTS
+ * must be larger than #CONFIG_UDI_MSC_NR_BUFFERS.
+ *
+ * If #CONFIG_UDI_MSC_CRC32 is defined, the vendor-specific command
+ * #UDI_MSC_CMD_CRC32 lets the host check a range of blocks by
+ * \ref crc32_group "CRC-32" instead of reading them back, e.g. to
+ * verify an image just written by \c tools/rawwrite/rawwrite.py.
+ *
  * @{
  */
 
@@ -70,6 +90,19 @@ struct block_device;
  */
 #define MSC_MAX_SERIAL_LEN	20
 
+/**
+ * \brief Vendor-specific SCSI command returning the CRC-32 of some blocks
+ *
+ * The CDB has the same layout as VERIFY(10): the big-endian LBA of the
+ * first block in bytes 2-5 and the big-endian number of blocks in bytes
+ * 7-8. The device reads the blocks and returns 4 bytes of data: the
+ * big-endian CRC-32 of their contents, as calculated by crc32_update()
+ * (and \c zlib.crc32() on the host).
+ *
+ * Only supported if #CONFIG_UDI_MSC_CRC32 is defined.
+ */
+#define UDI_MSC_CMD_CRC32	0xc0
+
 extern struct udm_interface *udi_msc_create_iface(struct block_device *bdev);
 
 status_t udi_msc_enable(struct udc *udc, struct udm_interface *iface,
@@ -248,7 +248,8 @@ ERROR_FUNC(priv_round_down_bad_type, "Invalid type passed to round_down");
  * \return \a x rounded down to the nearest multiple of (1 << \a order)
  */
 #define round_down(x, order)							\
-		(sizeof(x) == 4 ? round_down32((uint32_t)(x), (order)) :	\
+		(sizeof(x) == 8 ? round_down64((uint64_t)(x), (order)) :	\
+		 sizeof(x) == 4 ? round_down32((uint32_t)(x), (order)) :	\
 		 sizeof(x) == 2 ? round_down16((uint16_t)(x), (order)) :	\
 		 sizeof(x) == 1 ? round_down8 (( uint8_t)(x), (order)) :	\
 		(priv_round_down_bad_type(),1))
@@ -268,6 +269,11 @@ static inline uint32_t round_down32(uint32_t x, unsigned int order)
 	return (x & ~((1UL << order) - 1));
 }
 
+static inline uint64_t round_down64(uint64_t x, unsigned int order)
+{
+	return (x & ~((1ULL << order) - 1));
+}
+
 ERROR_FUNC(priv_round_up_bad_type, "Invalid type passed to round_up");
 
 /**
@@ -278,7 +284,8 @@ ERROR_FUNC(priv_round_up_bad_type, "Invalid type passed to round_up");
  * \return \a x rounded up to the next multiple of (1 << \a order)
  */
 #define round_up(x, order)						\
-		(sizeof(x) == 4 ? round_up32((uint32_t)(x), (order)) :	\
+		(sizeof(x) == 8 ? round_up64((uint64_t)(x), (order)) :	\
+		 sizeof(x) == 4 ? round_up32((uint32_t)(x), (order)) :	\
 		 sizeof(x) == 2 ? round_up16((uint16_t)(x), (order)) :	\
 		 sizeof(x) == 1 ? round_up8 (( uint8_t)(x), (order)) :	\
 		(priv_round_up_bad_type(),1))
@@ -298,6 +305,11 @@ static inline uint32_t round_up32(uint32_t x, unsigned int order)
 	return round_down32(x + (1UL << order) - 1, order);
 }
 
+static inline uint64_t round_up64(uint64_t x, unsigned int order)
+{
+	return round_down64(x + (1ULL << order) - 1, order);
+}
+
 /**
  * \brief Round up to the nearest word-aligned boundary.
  *
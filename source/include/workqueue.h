@@ -72,6 +72,10 @@ typedef void (*workqueue_func_t)(struct workqueue_task *task);
 struct workqueue_task {
 	workqueue_func_t	worker;	//!< Function implementing the task
 	struct slist_node	node;	//!< Node in the work queue task list
+#ifdef CONFIG_LATENCY
+	//! Time when the task was last queued, see \ref latency_group
+	uint16_t		queued_at;
+#endif
 };
 
 /**
@@ -37,6 +37,7 @@ obj-y           :=
 
 incdir-y        :=
 mkfiles         :=
+tsfs-manifest-y :=
 
 include $(src)/make/common.mk
 
@@ -117,6 +118,31 @@ PHONY           += clean
 clean:
 	$(call cmd,rmfiles)
 
+# TSFS volume image, built from the manifest given by the application in
+# tsfs-manifest-y. Each file starts on a new page of tsfs-page-size bytes.
+PYTHON          ?= python
+tsfs-page-size  ?= 512
+tsfs-image-file := $(app)-tsfs.raw
+mkfs-tsfs       := $(src)/../tools/tsfs/mkfs.tsfs/mkfs.tsfs.py
+
+quiet_cmd_mkfs_tsfs = TSFS    $@
+      cmd_mkfs_tsfs = $(PYTHON) $(mkfs-tsfs) -q -s -p $(tsfs-page-size) \
+			-M $(depfile) -m $< -o $@ || rm -f $@
+
+PHONY           += tsfs-image
+ifneq ($(tsfs-manifest-y),)
+tsfs-image: $(tsfs-image-file)
+
+$(tsfs-image-file): $(tsfs-manifest-y) $(mkfs-tsfs)
+	$(call cmd,mkfs_tsfs)
+
+clean-files     += $(tsfs-image-file) .$(tsfs-image-file).d
+-include .$(tsfs-image-file).d
+else
+tsfs-image:
+	@echo "No TSFS manifest for $(app)"
+endif
+
 # Build system
 make-files       = make/app.mk make/app-subdirs.mk make/commands.mk
 make-files      += make/common.mk make/genconfig.sh make/Makefile.app.in
@@ -188,6 +214,8 @@ help:
 	@echo "                  flash on the target."
 	@echo "  run             Start executing code on the target."
 	@echo "  reset           Reset the target."
+	@echo "  tsfs-image      Build the TSFS volume image of the"
+	@echo "                  application, if it has one."
 	@echo "  help            This help text."
 	@echo ""
 	@echo "Build system configuration variables:"
@@ -202,6 +230,8 @@ help:
 	@echo "                  The default toolchain is specified in the"
 	@echo "                  application Makefile."
 	@echo "  IAR_PATH        Path to IAR EWB installation."
+	@echo "  PYTHON          Python interpreter used for building the"
+	@echo "                  TSFS volume image."
 	@echo ""
 	@echo "Further information is available in doc/build_system_doc.c"
 	@echo ""
@@ -74,6 +74,13 @@ quiet_cmd_cpp_lds_S     = LDS     $@
 quiet_cmd_link          = LD      $@
       cmd_link          = $(LD) $(l_flags) -o $@ $(obj-y) $(ldlibs-y) $(ldlibs-gnu-y)
 
+# Without a linker script, let the compiler driver do the linking so
+# that the C library and startup files are pulled in as usual.
+ifeq ($(CONFIG_LINK_WITH_CC),y)
+l_flags          = $(addprefix -Wl$(comma),$(ldflags-gnu-y) -Map $@.map --cref)
+      cmd_link          = $(CC) $(cflags-gnu-y) $(l_flags) -o $@ $(obj-y) $(ldlibs-y)
+endif
+
 quiet_cmd_check         = CHECK   $<
       cmd_check         = $(CHECK) $(checkflags-y) $<
 
@@ -49,6 +49,7 @@ obj             := $(src)/build/$(app)/$(CONFIG)/$(TOOLCHAIN)
 
 delegate-targets := clean docs program reset run filelist
 delegate-targets += archive-check tar-archive help
+delegate-targets += tsfs-image
 
 .PHONY: $(delegate-targets)
 $(delegate-targets): delegate
@@ -45,6 +45,11 @@ ifeq ($(PROGTOOL),avr32program)
 include $(src)/make/avr32program.mk
 else ifeq ($(PROGTOOL),avrdude)
 include $(src)/make/avrdude.mk
+else ifeq ($(PROGTOOL),host)
+# Host executables don't need programming, they are simply run
+cmd_program = true
+cmd_reset = true
+cmd_run = ./$(app-elf)
 else
 cmd_program = echo Unknown programmer tool: $(PROGTOOL); \
 	echo Please verify the PROGTOOL variable
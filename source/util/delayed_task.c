@@ -0,0 +1,312 @@
+/**
+ * \file
+ *
+ * \brief Delayed work queue tasks
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <delayed_task.h>
+#include <interrupt.h>
+#include <timer.h>
+#include <workqueue.h>
+
+/**
+ * \weakgroup delayed_task_group
+ * @{
+ */
+
+//! Timer providing the time and the alarms.
+static struct timer delayed_task_timer;
+
+//! Delayed tasks waiting for their delay to pass, in no particular order.
+static struct delayed_task *delayed_task_list;
+
+static struct delayed_task_stats delayed_task_stats;
+
+/**
+ * \internal
+ * \brief Return true if time \a a is before or equal to time \a b
+ *
+ * All times of pending tasks are less than half the counter range away
+ * from the current time, so wrapping of the counter is handled.
+ */
+static bool delayed_task_time_is_before_eq(uint16_t a, uint16_t b)
+{
+	return (int16_t)(b - a) >= 0;
+}
+
+static uint16_t delayed_task_get_time(void)
+{
+	return timer_get_time(CONFIG_DELAYED_TASK_TIMER_ID,
+			&delayed_task_timer);
+}
+
+/**
+ * \internal
+ * \brief Add all tasks whose delay has passed to the main work queue
+ *
+ * \pre Interrupts are disabled
+ *
+ * \return The number of tasks added.
+ */
+static uint8_t delayed_task_queue_due(uint16_t now)
+{
+	struct delayed_task     **pnext = &delayed_task_list;
+	struct delayed_task     *dtask;
+	uint8_t                 nr_queued = 0;
+
+	while ((dtask = *pnext)) {
+		if (delayed_task_time_is_before_eq(dtask->due, now)) {
+			*pnext = dtask->next;
+			dtask->pending = false;
+			workqueue_add_task(&main_workqueue, dtask->task);
+			nr_queued++;
+		} else {
+			pnext = &dtask->next;
+		}
+	}
+
+	return nr_queued;
+}
+
+/**
+ * \internal
+ * \brief Set the alarm for the most urgent pending task
+ *
+ * The timer is stopped when no tasks are pending.
+ *
+ * \pre Interrupts are disabled
+ * \pre No pending task is due at \a now
+ */
+static void delayed_task_set_alarm(uint16_t now)
+{
+	struct delayed_task     *dtask = delayed_task_list;
+	uint16_t                alarm;
+	uint16_t                max_delta;
+	uint16_t                delta;
+
+	if (!dtask) {
+		timer_stop(CONFIG_DELAYED_TASK_TIMER_ID, &delayed_task_timer);
+		return;
+	}
+
+	alarm = dtask->latest;
+	for (dtask = dtask->next; dtask; dtask = dtask->next)
+		if (delayed_task_time_is_before_eq(dtask->latest, alarm))
+			alarm = dtask->latest;
+
+	delta = alarm - now;
+	max_delta = timer_maximum_delta(CONFIG_DELAYED_TASK_TIMER_ID,
+			&delayed_task_timer);
+	if (delta > max_delta)
+		delta = max_delta;
+
+	timer_set_alarm(CONFIG_DELAYED_TASK_TIMER_ID, &delayed_task_timer,
+			delta);
+}
+
+static void delayed_task_alarm(struct timer *timer)
+{
+	irqflags_t      iflags;
+	uint16_t        now;
+	uint8_t         nr_queued;
+
+	iflags = cpu_irq_save();
+	now = delayed_task_get_time();
+	nr_queued = delayed_task_queue_due(now);
+	delayed_task_stats.nr_alarms++;
+	delayed_task_stats.nr_alarm_tasks += nr_queued;
+	delayed_task_set_alarm(now);
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Set up the delayed task timer
+ *
+ * This initializes the timer \a CONFIG_DELAYED_TASK_TIMER_ID, which must
+ * not be used for anything else.
+ */
+void delayed_task_setup(void)
+{
+	timer_res_t     timer_res;
+
+	timer_init(CONFIG_DELAYED_TASK_TIMER_ID, &delayed_task_timer,
+			delayed_task_alarm);
+	timer_res = timer_set_resolution(CONFIG_DELAYED_TASK_TIMER_ID,
+			&delayed_task_timer, CONFIG_DELAYED_TASK_RESOLUTION);
+	assert(timer_get_resolution(CONFIG_DELAYED_TASK_TIMER_ID,
+			&delayed_task_timer, timer_res)
+			== CONFIG_DELAYED_TASK_RESOLUTION);
+	timer_write_resolution(CONFIG_DELAYED_TASK_TIMER_ID,
+			&delayed_task_timer, timer_res);
+}
+
+/**
+ * \brief Run a work queue task after a delay
+ *
+ * The task of \a dtask is added to \ref main_workqueue no earlier than
+ * \a delay ticks from now, and if possible no later than \a delay +
+ * \a slack ticks from now. If \a dtask is already pending, it is
+ * rescheduled.
+ *
+ * This may be called from any context.
+ *
+ * \param dtask The delayed task.
+ * \param delay Minimum number of ticks to wait.
+ * \param slack Number of ticks the task may be run later than \a delay.
+ * Tasks with more slack can share a wake-up with more other tasks.
+ */
+void delayed_task_add(struct delayed_task *dtask, uint16_t delay,
+		uint16_t slack)
+{
+	irqflags_t      iflags;
+	uint16_t        now;
+
+	assert(dtask->task);
+	assert(delay <= DELAYED_TASK_MAX_TICKS);
+	assert(slack <= DELAYED_TASK_MAX_TICKS - delay);
+
+	iflags = cpu_irq_save();
+	if (dtask->pending)
+		delayed_task_cancel(dtask);
+
+	if (!delayed_task_list)
+		timer_start(CONFIG_DELAYED_TASK_TIMER_ID, &delayed_task_timer);
+
+	now = delayed_task_get_time();
+	dtask->due = now + delay;
+	dtask->latest = dtask->due + slack;
+	dtask->pending = true;
+	dtask->next = delayed_task_list;
+	delayed_task_list = dtask;
+
+	/*
+	 * The task may be due right away, and some timers cannot set an
+	 * alarm which triggers immediately.
+	 */
+	delayed_task_queue_due(now);
+	delayed_task_set_alarm(now);
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Stop waiting for the delay of \a dtask to pass
+ *
+ * If \a dtask is not pending, this does nothing. If the task has already
+ * been added to the work queue, it is not removed from it.
+ */
+void delayed_task_cancel(struct delayed_task *dtask)
+{
+	struct delayed_task     **pnext;
+	irqflags_t              iflags;
+
+	iflags = cpu_irq_save();
+	if (dtask->pending) {
+		for (pnext = &delayed_task_list; *pnext != dtask;
+				pnext = &(*pnext)->next)
+			assert(*pnext);
+		*pnext = dtask->next;
+		dtask->pending = false;
+
+		/*
+		 * Leave the alarm alone; triggering too early does no
+		 * harm. Only stop the timer when nothing is left.
+		 */
+		if (!delayed_task_list)
+			timer_stop(CONFIG_DELAYED_TASK_TIMER_ID,
+					&delayed_task_timer);
+	}
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Add the tasks whose delay has passed to the main work queue
+ *
+ * This is called by the main loop when it runs out of work, so that tasks
+ * which are due get run before the CPU goes to sleep instead of waking it
+ * up again later.
+ *
+ * \retval true if any tasks were added.
+ * \retval false if no tasks were due.
+ */
+bool delayed_task_poll(void)
+{
+	irqflags_t      iflags;
+	uint16_t        now;
+	uint8_t         nr_queued = 0;
+
+	if (!delayed_task_list)
+		return false;
+
+	iflags = cpu_irq_save();
+	if (delayed_task_list) {
+		now = delayed_task_get_time();
+		nr_queued = delayed_task_queue_due(now);
+		if (nr_queued) {
+			delayed_task_stats.nr_polled_tasks += nr_queued;
+			delayed_task_set_alarm(now);
+		}
+	}
+	cpu_irq_restore(iflags);
+
+	return nr_queued != 0;
+}
+
+/**
+ * \brief Read the delayed task statistics
+ */
+void delayed_task_get_stats(struct delayed_task_stats *stats)
+{
+	irqflags_t      iflags;
+
+	iflags = cpu_irq_save();
+	*stats = delayed_task_stats;
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Clear the delayed task statistics
+ */
+void delayed_task_reset_stats(void)
+{
+	irqflags_t      iflags;
+
+	iflags = cpu_irq_save();
+	delayed_task_stats.nr_alarms = 0;
+	delayed_task_stats.nr_alarm_tasks = 0;
+	delayed_task_stats.nr_polled_tasks = 0;
+	cpu_irq_restore(iflags);
+}
+
+//! @}
@@ -366,6 +366,44 @@ static void tsfs_get_filetable_entry(struct tsfs *tsfs, uint8_t file_index,
 #endif
 }
 
+/**
+ * \brief Locate a file in a sorted file table
+ *
+ * Binary search for the first entry whose name is not less than \a filename,
+ * so that the first of several files with the same name is found, as with
+ * the linear search.
+ */
+static uint32_t tsfs_search_sorted_table(struct tsfs *tsfs,
+		const char *filename)
+{
+	struct tsfs_filetable_entry     ft_entry;
+	uint32_t                        first = 0;
+	uint32_t                        last = tsfs->header.nr_files;
+	char                            name_buffer[TSFS_FILENAME_LEN];
+
+	while (first < last) {
+		uint32_t middle = first + (last - first) / 2;
+
+		tsfs_get_filetable_entry(tsfs, middle, &ft_entry);
+		memcpy(name_buffer, ft_entry.filename, TSFS_FILENAME_LEN);
+
+		if (strncmp(name_buffer, filename, TSFS_FILENAME_LEN) < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	if (first < tsfs->header.nr_files) {
+		tsfs_get_filetable_entry(tsfs, first, &ft_entry);
+		memcpy(name_buffer, ft_entry.filename, TSFS_FILENAME_LEN);
+
+		if (strncmp(name_buffer, filename, TSFS_FILENAME_LEN) == 0)
+			return first;
+	}
+
+	return tsfs->header.nr_files;
+}
+
 static uint32_t tsfs_locate_file_in_table(struct tsfs *tsfs,
 		const char *filename)
 {
@@ -373,6 +411,9 @@ static uint32_t tsfs_locate_file_in_table(struct tsfs *tsfs,
 	uint32_t                        file_index = 0;
 	char                            name_buffer[TSFS_FILENAME_LEN];
 
+	if (tsfs->header.flags & TSFS_FLAG_SORTED)
+		return tsfs_search_sorted_table(tsfs, filename);
+
 	while (file_index < tsfs->header.nr_files) {
 		tsfs_get_filetable_entry(tsfs, file_index, &ft_entry);
 
@@ -394,6 +435,9 @@ static uint32_t tsfs_locate_file_in_table(struct tsfs *tsfs,
  * matches the \a filename string. Note that this can be a pointer to any
  * normal character array, even though TSFS filenames do not have a termchar
  *
+ * If the volume header has the \ref TSFS_FLAG_SORTED flag set, the filetable
+ * is binary searched instead of scanned from the start.
+ *
  * \param tsfs TSFS structure which holds file system information
  * \param filename Name of file to be opened
  * \param filehandle File structure to store results
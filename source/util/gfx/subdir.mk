@@ -17,5 +17,6 @@ src-$(CONFIG_GFX_WTK)           += util/gfx/wtk_progress_bar.c
 src-$(CONFIG_GFX_WTK)           += util/gfx/wtk_radio_button.c
 src-$(CONFIG_GFX_WTK)           += util/gfx/wtk_slider.c
 src-$(CONFIG_GFX_WTK)           += util/gfx/wtk_plot.c
+src-$(CONFIG_GFX_WTK_SURFACE_CACHE) += util/gfx/wtk_surface_cache.c
 
 mkfiles                         += $(src)/util/gfx/subdir.mk
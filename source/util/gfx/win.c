@@ -178,6 +178,11 @@ static struct win_event_queue win_event_queue;
 //! Diagnostic value counting number of dropped events due to event queue full.
 static uint32_t win_num_dropped_events;
 
+#ifdef WIN_EVENT_COALESCE_MOVES
+//! Diagnostic value counting number of move events merged into queued moves.
+static uint32_t win_num_coalesced_events;
+#endif
+
 //! Current pointer grabbing window, or NULL. Grabber gets all pointer events.
 static struct win_window *win_pointer_grabber;
 //! Current keyboard focus, or NULL. Keyboard focus gets all keyboard events.
@@ -215,8 +220,12 @@ void win_init(void)
 	win_last_pointer_pos.y = gfx_get_height() / 2;
 
 #ifdef CONFIG_GFX_WIN_USE_TOUCH
-	// Hook into touch driver.
+	/*
+	 * Hook into touch driver, and let it pace its sampling to the
+	 * rate at which we process events.
+	 */
 	touch_set_event_handler(win_queue_touch_event);
+	touch_set_paced(true);
 #endif
 }
 
@@ -842,6 +851,56 @@ static void win_event_queue_pop(void)
 	ring_extract_entries(&win_event_queue.ring, 1);
 }
 
+#ifdef WIN_EVENT_COALESCE_MOVES
+/**
+ * \internal
+ * Try to merge a pointer move event into the most recently queued event.
+ *
+ * The newest event is only updated if it is a pointer move with the same
+ * button state and position mode, and if it is not at the tail of the
+ * queue, since the tail event may currently be processed by
+ * win_process_events(). Must be called with interrupts disabled.
+ *
+ * \param  event  Event to merge.
+ *
+ * \retval true   Event was merged into the queue.
+ * \retval false  Event must be queued separately.
+ */
+static bool win_event_queue_coalesce(const struct win_event *event)
+{
+	unsigned int index;
+	struct win_event *last;
+
+	if ((event->type != WIN_EVENT_POINTER)
+			|| (event->pointer.type != WIN_POINTER_MOVE))
+		return false;
+
+	if (ring_entries_used(&win_event_queue.ring) < 2)
+		return false;
+
+	index = (win_event_queue.ring.head - 1) & (WIN_EVENT_QUEUE_SIZE - 1);
+	last = &win_event_queue.buffer[index];
+
+	if ((last->type != WIN_EVENT_POINTER)
+			|| (last->pointer.type != WIN_POINTER_MOVE)
+			|| (last->pointer.buttons != event->pointer.buttons)
+			|| (last->pointer.is_relative != event->pointer.is_relative))
+		return false;
+
+	// Relative moves accumulate, absolute moves keep the latest position.
+	if (event->pointer.is_relative) {
+		last->pointer.pos.x += event->pointer.pos.x;
+		last->pointer.pos.y += event->pointer.pos.y;
+	} else {
+		last->pointer.pos = event->pointer.pos;
+	}
+
+	++win_num_coalesced_events;
+
+	return true;
+}
+#endif
+
 /**
  * This function processes all pending events from the internal queue.
  * In order for the window system to work properly, this function
@@ -883,6 +942,11 @@ void win_process_events(void)
 		// We're done with the front event now, so remove it.
 		win_event_queue_pop();
 	}
+
+#ifdef CONFIG_GFX_WIN_USE_TOUCH
+	// Caught up with the queue, so let the touch driver sample again.
+	touch_event_consumed();
+#endif
 }
 
 
@@ -1789,6 +1853,14 @@ static void win_queue_event(const struct win_event *event)
 	 */
 	iflags = cpu_irq_save();
 
+#ifdef WIN_EVENT_COALESCE_MOVES
+	// Merge into the last queued move, if possible.
+	if (win_event_queue_coalesce(event)) {
+		cpu_irq_restore(iflags);
+		return;
+	}
+#endif
+
 	// Drop event if queue is full.
 	if (win_event_queue_is_full()) {
 		++win_num_dropped_events;
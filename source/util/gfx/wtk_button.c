@@ -41,12 +41,29 @@
 #include <membag.h>
 #include <string.h>
 #include <gfx/wtk.h>
+#ifdef CONFIG_GFX_DLIST
+# include <gfx/dlist.h>
+#endif
 
 /**
  * \ingroup gfx_wtk_button
  * @{
  */
 
+#if defined(CONFIG_GFX_DLIST) || defined(__DOXYGEN__)
+/**
+ * \internal
+ * \brief Size of buffer button drawings are first recorded into
+ *
+ * This holds the background, the border and a caption of
+ * CONFIG_GFX_DLIST_STRING_MAX characters. Each button keeps a copy of its
+ * drawing, with just the bytes recorded.
+ */
+# define WTK_BUTTON_DLIST_SIZE                                          \
+	(sizeof(struct gfx_dlist_header) + 2 * GFX_DLIST_RECT_SIZE       \
+		+ GFX_DLIST_STRING_SIZE(CONFIG_GFX_DLIST_STRING_MAX))
+#endif
+
 /** Valid states for button, relevant to pointer and keyboard operations.
  * \internal
  */
@@ -74,8 +91,21 @@ struct wtk_button {
 	win_command_t           command_data;
 	//! Current state.
 	enum wtk_button_state   state;
+#ifdef CONFIG_GFX_DLIST
+	//! Recorded drawing, with NULL data if there is none.
+	struct gfx_dlist        dlist;
+	//! State \a dlist was recorded for.
+	enum wtk_button_state   dlist_state;
+	//! Size \a dlist was recorded for.
+	struct win_point        dlist_size;
+#endif
 };
 
+#ifdef CONFIG_GFX_DLIST
+//! \internal Buffer button drawings are first recorded into.
+static uint8_t wtk_button_dlist_buf[WTK_BUTTON_DLIST_SIZE];
+#endif
+
 /**
  * This function returns a reference to the window that should be used when
  * managing the widget, such as move, resize, destroy and reparenting.
@@ -90,6 +120,173 @@ struct win_window *wtk_button_as_child(struct wtk_button *button)
 	return button->container;
 }
 
+/**
+ * \internal
+ * \brief Get background and caption colors for a button state
+ *
+ * If pressed/highlighted, the colors are inverted.
+ *
+ * \param state            Button state.
+ * \param background_color Returns the background color.
+ * \param caption_color    Returns the caption color.
+ */
+static void wtk_button_get_colors(enum wtk_button_state state,
+		gfx_color_t *background_color, gfx_color_t *caption_color)
+{
+	switch (state) {
+	case WTK_BUTTON_NORMAL:
+		*background_color = WTK_BUTTON_BACKGROUND_COLOR;
+		*caption_color = WTK_BUTTON_CAPTION_COLOR;
+		break;
+
+	case WTK_BUTTON_PRESSED:
+		*background_color = WTK_BUTTON_CAPTION_COLOR;
+		*caption_color = WTK_BUTTON_BACKGROUND_COLOR;
+		break;
+
+	default:
+		assert(false);
+		*background_color = WTK_BUTTON_BACKGROUND_COLOR;
+		*caption_color = WTK_BUTTON_CAPTION_COLOR;
+	}
+}
+
+/**
+ * \internal
+ * \brief Draw a button
+ *
+ * \param button Button to draw.
+ * \param origin Top left corner of the button on screen.
+ * \param size   Size of the button.
+ */
+static void wtk_button_draw(struct wtk_button *button,
+		struct win_point const *origin, struct win_point const *size)
+{
+	gfx_color_t background_color;
+	gfx_color_t caption_color;
+	gfx_coord_t width;
+	gfx_coord_t height;
+
+	wtk_button_get_colors(button->state, &background_color,
+			&caption_color);
+
+	// Draw background.
+	gfx_draw_filled_rect(origin->x, origin->y, size->x, size->y,
+			background_color);
+
+	// Draw border.
+	gfx_draw_rect(origin->x, origin->y, size->x, size->y,
+			WTK_BUTTON_BORDER_COLOR);
+
+	// Get string size and draw the caption text in the center of the button.
+	gfx_get_string_bounding_box(button->caption, &sysfont,
+			&width, &height);
+
+	gfx_draw_string(button->caption,
+			origin->x + (size->x / 2) - (width / 2),
+			origin->y + (size->y / 2) - (height / 2),
+			&sysfont, caption_color, GFX_COLOR_TRANSPARENT);
+}
+
+#if defined(CONFIG_GFX_DLIST) || defined(__DOXYGEN__)
+/**
+ * \internal
+ * \brief Record the drawing of a button into a display list
+ *
+ * The operations are the ones of wtk_button_draw(), relative to the top
+ * left corner of the button.
+ *
+ * \param button Button to record.
+ * \param dlist  Display list to record into.
+ * \param size   Size of the button.
+ *
+ * \retval true  The whole drawing was recorded.
+ * \retval false There was no room for it in the list.
+ */
+static bool wtk_button_record(struct wtk_button *button,
+		struct gfx_dlist *dlist, struct win_point const *size)
+{
+	gfx_color_t background_color;
+	gfx_color_t caption_color;
+	gfx_coord_t width;
+	gfx_coord_t height;
+
+	wtk_button_get_colors(button->state, &background_color,
+			&caption_color);
+	gfx_get_string_bounding_box(button->caption, &sysfont,
+			&width, &height);
+
+	gfx_dlist_clear(dlist);
+
+	return gfx_dlist_add_filled_rect(dlist, 0, 0, size->x, size->y,
+				background_color)
+			&& gfx_dlist_add_rect(dlist, 0, 0, size->x, size->y,
+				WTK_BUTTON_BORDER_COLOR)
+			&& gfx_dlist_add_string(dlist, button->caption,
+				(size->x / 2) - (width / 2),
+				(size->y / 2) - (height / 2),
+				&sysfont, caption_color,
+				GFX_COLOR_TRANSPARENT);
+}
+
+/**
+ * \internal
+ * \brief Make sure the display list of a button matches its state and size
+ *
+ * The drawing is recorded again when the button has been pressed,
+ * released or resized since the last time. The first time, it is recorded
+ * into #wtk_button_dlist_buf, and copied into a buffer from the membags
+ * of just the recorded length, which is kept by the button.
+ *
+ * \param button Button to update.
+ * \param size   Current size of the button.
+ *
+ * \retval true  \a button has a display list to replay.
+ * \retval false The button must be drawn directly, as the caption is too
+ *               long for a display list or there is no memory for it.
+ */
+static bool wtk_button_update_dlist(struct wtk_button *button,
+		struct win_point const *size)
+{
+	struct gfx_dlist        dlist;
+	uint16_t                length;
+	uint8_t                 *data;
+
+	if (button->dlist.data) {
+		if ((button->dlist_state == button->state)
+				&& (button->dlist_size.x == size->x)
+				&& (button->dlist_size.y == size->y))
+			return true;
+
+		if (wtk_button_record(button, &button->dlist, size))
+			goto recorded;
+
+		// The drawing has grown since the list was allocated.
+		membag_free(button->dlist.data);
+		button->dlist.data = NULL;
+	}
+
+	gfx_dlist_init(&dlist, wtk_button_dlist_buf,
+			sizeof(wtk_button_dlist_buf));
+	if (!wtk_button_record(button, &dlist, size))
+		return false;
+
+	length = gfx_dlist_get_length(&dlist);
+	data = membag_alloc(length);
+	if (!data)
+		return false;
+
+	memcpy(data, wtk_button_dlist_buf, length);
+	button->dlist.data = data;
+	button->dlist.size = length;
+
+recorded:
+	button->dlist_state = button->state;
+	button->dlist_size = *size;
+	return true;
+}
+#endif
+
 /**
  * This function is the window event handler for button widgets.
  * It handles all events sent to the windows composing the widget.
@@ -116,56 +313,26 @@ static bool wtk_button_handler(struct win_window *win,
 					(struct win_clip_region const *)data;
 			struct win_area const *area = win_get_area(win);
 
-			// Preare background and caption colors depending on state of
-			// button. If pressed/highlighted, the colors are inverted.
-			gfx_color_t background_color;
-			gfx_color_t caption_color;
-
 			// There should not be other windows in this widget.
 			assert(win == button->container);
 
-			switch (button->state) {
-			case WTK_BUTTON_NORMAL:
-				background_color = WTK_BUTTON_BACKGROUND_COLOR;
-				caption_color = WTK_BUTTON_CAPTION_COLOR;
-				break;
-
-			case WTK_BUTTON_PRESSED:
-				background_color = WTK_BUTTON_CAPTION_COLOR;
-				caption_color = WTK_BUTTON_BACKGROUND_COLOR;
-				break;
-
-			default:
-				assert(false);
-				background_color = WTK_BUTTON_BACKGROUND_COLOR;
-				caption_color = WTK_BUTTON_CAPTION_COLOR;
-			}
-
-			// Draw background.
-			gfx_draw_filled_rect(clip->origin.x, clip->origin.y,
-					area->size.x, area->size.y,
-					background_color);
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			if (wtk_surface_cache_draw(win, button->state, clip))
+				return true;
+#endif
 
-			// Draw border.
-			gfx_draw_rect(clip->origin.x, clip->origin.y,
-					area->size.x, area->size.y,
-					WTK_BUTTON_BORDER_COLOR);
+#ifdef CONFIG_GFX_DLIST
+			if (wtk_button_update_dlist(button, &area->size))
+				gfx_dlist_replay(&button->dlist,
+						clip->origin.x, clip->origin.y);
+			else
+#endif
+				wtk_button_draw(button, &clip->origin,
+						&area->size);
 
-			/* Get string size and draw the caption text in the
-			 * center of the button.
-			 */
-			gfx_coord_t width;
-			gfx_coord_t height;
-
-			gfx_get_string_bounding_box(button->caption, &sysfont,
-					&width, &height);
-
-			gfx_draw_string(button->caption,
-					clip->origin.x + (area->size.x / 2) -
-					(width / 2),
-					clip->origin.y + (area->size.y / 2) -
-					(height / 2), &sysfont, caption_color,
-					GFX_COLOR_TRANSPARENT);
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			wtk_surface_cache_store(win, button->state, clip);
+#endif
 
 			/* Always accept DRAW events, as the return value is
 			 * ignored anyway for that event type.
@@ -250,6 +417,13 @@ static bool wtk_button_handler(struct win_window *win,
 			 * destroyed by the window system. We must destroy
 			 * other allocations.
 			 */
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			wtk_surface_cache_invalidate(win);
+#endif
+#ifdef CONFIG_GFX_DLIST
+			if (button->dlist.data)
+				membag_free(button->dlist.data);
+#endif
 			membag_free(button->caption);
 			membag_free(button);
 
@@ -259,6 +433,13 @@ static bool wtk_button_handler(struct win_window *win,
 			return true;
 		}
 
+	case WIN_EVENT_ATTRIBUTES:
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+		// Cached surfaces are only valid for the old position and size.
+		wtk_surface_cache_invalidate(win);
+#endif
+		return true;
+
 	default:
 		// Reject unknown event types.
 		return false;
@@ -324,6 +505,9 @@ struct wtk_button *wtk_button_create(struct win_window *parent,
 
 	button->state = WTK_BUTTON_NORMAL;
 	button->command_data = command_data;
+#ifdef CONFIG_GFX_DLIST
+	button->dlist.data = NULL;
+#endif
 
 	// Allocate memory for caption string, and copy text.
 	button->caption = membag_alloc((strlen(caption) + 1) * sizeof(char));
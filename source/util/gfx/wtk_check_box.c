@@ -164,6 +164,12 @@ static bool wtk_check_box_handler(struct win_window *win,
 			struct win_clip_region const *clip =
 					(struct win_clip_region const *)data;
 
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			if (wtk_surface_cache_draw(win, check_box->selected,
+						clip))
+				return true;
+#endif
+
 			// Check check box square.
 			gfx_draw_rect(clip->origin.x + WTK_CHECKBOX_BOX_X,
 					clip->origin.y + WTK_CHECKBOX_BOX_Y,
@@ -190,6 +196,10 @@ static bool wtk_check_box_handler(struct win_window *win,
 					WTK_CHECKBOX_CAPTION_COLOR,
 					GFX_COLOR_TRANSPARENT);
 
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			wtk_surface_cache_store(win, check_box->selected, clip);
+#endif
+
 			/* Always accept DRAW events, as the return value is
 			 * ignored anyway for that event type.
 			 */
@@ -275,6 +285,9 @@ static bool wtk_check_box_handler(struct win_window *win,
 		/* Memory allocated for windows will be automatically destroyed
 		 * by the window system. We must destroy other allocations.
 		 */
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+		wtk_surface_cache_invalidate(win);
+#endif
 		membag_free(check_box->caption);
 		membag_free(check_box);
 
@@ -283,6 +296,13 @@ static bool wtk_check_box_handler(struct win_window *win,
 		 */
 		return true;
 
+	case WIN_EVENT_ATTRIBUTES:
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+		// Cached surfaces are only valid for the old position and size.
+		wtk_surface_cache_invalidate(win);
+#endif
+		return true;
+
 	default:
 		// Reject unknown event types.
 		return false;
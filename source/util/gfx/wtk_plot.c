@@ -462,7 +462,6 @@ static bool wtk_plot_handler(struct win_window *win,
 	struct win_area const           *area;
 	struct wtk_plot                 *plot;
 	struct gfx_bitmap               *background;
-	uint8_t                         option;
 
 	plot = (struct wtk_plot *)win_get_custom_data(win);
 
@@ -479,8 +478,6 @@ static bool wtk_plot_handler(struct win_window *win,
 		area = win_get_area(win);
 		background = plot->background;
 
-		option = plot->option;
-
 		if (background != NULL){
 			// Draw a window border.
 			gfx_draw_rect(clip->origin.x, clip->origin.y,
@@ -180,6 +180,13 @@ static bool wtk_radio_button_handler(struct win_window *win,
 			// There should not be other windows in this widget.
 			assert(win == radio_button->container);
 
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			if (wtk_surface_cache_draw(win,
+					radio_button->group->selected
+					== radio_button, clip))
+				return true;
+#endif
+
 			// Draw radio button circle.
 			gfx_draw_circle(clip->origin.x +
 					WTK_RADIOBUTTON_BUTTON_X,
@@ -209,6 +216,12 @@ static bool wtk_radio_button_handler(struct win_window *win,
 					WTK_RADIOBUTTON_CAPTION_COLOR,
 					GFX_COLOR_TRANSPARENT);
 
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+			wtk_surface_cache_store(win,
+					radio_button->group->selected
+					== radio_button, clip);
+#endif
+
 			/* Always accept DRAW events, as the return value is
 			 * ignored anyway for that event type.
 			 */
@@ -301,6 +314,9 @@ static bool wtk_radio_button_handler(struct win_window *win,
 		/* Memory allocated for windows will be automatically destroyed
 		 * by the window system. We must destroy other allocations.
 		 */
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+		wtk_surface_cache_invalidate(win);
+#endif
 		membag_free(radio_button->caption);
 
 		/* Destroy radio group as well if we are the last one in the
@@ -322,6 +338,13 @@ static bool wtk_radio_button_handler(struct win_window *win,
 		 */
 		return true;
 
+	case WIN_EVENT_ATTRIBUTES:
+#ifdef CONFIG_GFX_WTK_SURFACE_CACHE
+		// Cached surfaces are only valid for the old position and size.
+		wtk_surface_cache_invalidate(win);
+#endif
+		return true;
+
 	default:
 		// Reject unknown event types.
 		return false;
@@ -0,0 +1,410 @@
+/**
+ * \file
+ *
+ * \brief Widget surface cache
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <hugemem.h>
+#include <util.h>
+#include <gfx/wtk.h>
+
+/**
+ * \weakgroup gfx_wtk_surface_cache
+ *
+ * Each surface is stored as a plain RGB565 pixmap, line by line, so that
+ * it can be drawn as a \ref BITMAP_HUGEMEM bitmap. All surfaces are packed
+ * at the start of the arena. When a surface is removed, the surfaces
+ * following it are moved down to close the gap, so the free space is
+ * always one contiguous block at the end.
+ *
+ * @{
+ */
+
+//! Number of pixels read from the screen or moved in the arena at a time.
+#define WTK_SURFACE_CACHE_CHUNK_PIXELS  32
+
+//! \internal Cached widget surface metadata
+struct wtk_surface {
+	//! Widget window, or NULL if the entry is unused.
+	const struct win_window         *win;
+	//! Background bitmap of the parent window when the surface was stored.
+	const struct gfx_bitmap         *parent_background;
+	//! Screen position of the widget when the surface was stored.
+	struct win_point                origin;
+	//! Size of the widget, and of the surface.
+	struct win_point                size;
+	//! Offset of the pixels in the arena.
+	uint32_t                        offset;
+	//! Value of \ref wtk_surface_cache_clock when last drawn.
+	uint16_t                        last_used;
+	//! Widget specific visual state.
+	uint8_t                         state;
+};
+
+//! \internal Metadata for all surfaces in the cache.
+static struct wtk_surface
+		wtk_surface_cache_entries[CONFIG_GFX_WTK_SURFACE_CACHE_NR_ENTRIES];
+//! \internal Arena holding the surface pixels, or HUGEMEM_NULL if disabled.
+static hugemem_ptr_t wtk_surface_cache_arena = HUGEMEM_NULL;
+//! \internal Size of the arena in bytes.
+static uint32_t wtk_surface_cache_size;
+//! \internal Counter incremented for every surface used, for LRU.
+static uint16_t wtk_surface_cache_clock;
+//! \internal Usage statistics, including the number of bytes in use.
+static struct wtk_surface_cache_stats wtk_surface_cache_stats;
+
+/**
+ * \internal
+ * \brief Get the address of a location in the arena
+ */
+static hugemem_ptr_t wtk_surface_cache_ptr(uint32_t offset)
+{
+	return (hugemem_ptr_t)((phys_addr_t)wtk_surface_cache_arena + offset);
+}
+
+/**
+ * \internal
+ * \brief Get the number of bytes of pixels in a surface
+ */
+static uint32_t wtk_surface_length(const struct wtk_surface *surface)
+{
+	return (uint32_t)surface->size.x * surface->size.y
+			* sizeof(gfx_color_t);
+}
+
+/**
+ * \internal
+ * \brief Look up the surface of a widget state
+ *
+ * \return Cache entry for \a state of \a win, or NULL if not cached.
+ */
+static struct wtk_surface *wtk_surface_cache_lookup(
+		const struct win_window *win, uint8_t state)
+{
+	struct wtk_surface      *surface;
+	uint8_t                 i;
+
+	for (i = 0; i < ARRAY_LEN(wtk_surface_cache_entries); i++) {
+		surface = &wtk_surface_cache_entries[i];
+		if (surface->win == win && surface->state == state)
+			return surface;
+	}
+
+	return NULL;
+}
+
+/**
+ * \internal
+ * \brief Find the least recently used surface in the cache
+ *
+ * \return The least recently used entry, or NULL if the cache is empty.
+ */
+static struct wtk_surface *wtk_surface_cache_find_lru(void)
+{
+	struct wtk_surface      *lru = NULL;
+	uint16_t                lru_age = 0;
+	uint8_t                 i;
+
+	for (i = 0; i < ARRAY_LEN(wtk_surface_cache_entries); i++) {
+		struct wtk_surface      *surface;
+		uint16_t                age;
+
+		surface = &wtk_surface_cache_entries[i];
+		if (!surface->win)
+			continue;
+
+		age = wtk_surface_cache_clock - surface->last_used;
+		if (!lru || age >= lru_age) {
+			lru = surface;
+			lru_age = age;
+		}
+	}
+
+	return lru;
+}
+
+/**
+ * \internal
+ * \brief Remove a surface from the cache
+ *
+ * The pixels of the surfaces following it are moved down to close the gap.
+ */
+static void wtk_surface_cache_remove(struct wtk_surface *surface)
+{
+	uint32_t        start = surface->offset;
+	uint32_t        length = wtk_surface_length(surface);
+	uint32_t        end = wtk_surface_cache_stats.bytes_used;
+	uint8_t         i;
+
+	assert(surface->win);
+	assert(start + length <= end);
+
+	// Areas may overlap, but data only moves down, as hugemem_copy() needs.
+	hugemem_copy(wtk_surface_cache_ptr(start),
+			wtk_surface_cache_ptr(start + length),
+			end - (start + length));
+
+	for (i = 0; i < ARRAY_LEN(wtk_surface_cache_entries); i++) {
+		struct wtk_surface *other = &wtk_surface_cache_entries[i];
+
+		if (other->win && other->offset > start)
+			other->offset -= length;
+	}
+
+	surface->win = NULL;
+	wtk_surface_cache_stats.bytes_used -= length;
+}
+
+/**
+ * \brief Give the surface cache an arena to store surfaces in
+ *
+ * Any surfaces in the previous arena are dropped. The arena is typically
+ * allocated from external memory at startup, for example:
+ * \code
+ * wtk_surface_cache_init(hugemem_alloc(&board_extram_pool, 32768, 0),
+ *         32768);
+ * \endcode
+ *
+ * \param arena Hugemem area to store surfaces in, or HUGEMEM_NULL to
+ *              disable the cache.
+ * \param size  Size of \a arena in bytes.
+ */
+void wtk_surface_cache_init(hugemem_ptr_t arena, uint32_t size)
+{
+	wtk_surface_cache_flush();
+
+	wtk_surface_cache_arena = arena;
+	wtk_surface_cache_size = (arena != HUGEMEM_NULL) ? size : 0;
+}
+
+/**
+ * \brief Draw a widget from its cached surface
+ *
+ * This is called by widgets at the start of a \ref WIN_EVENT_DRAW event.
+ * A surface which was stored at a different position or size, or over a
+ * different parent background, is dropped.
+ *
+ * \param win   Widget window being drawn.
+ * \param state Widget specific visual state.
+ * \param clip  Clipping region of the draw event.
+ *
+ * \retval true  The widget has been drawn from the cache.
+ * \retval false The widget is not cached and must be drawn normally.
+ */
+bool wtk_surface_cache_draw(const struct win_window *win, uint8_t state,
+		const struct win_clip_region *clip)
+{
+	const struct win_area   *area = win_get_area(win);
+	const struct win_window *parent = win_get_parent(win);
+	struct wtk_surface      *surface;
+	struct gfx_bitmap       bmp;
+
+	if (wtk_surface_cache_arena == HUGEMEM_NULL)
+		return false;
+
+	surface = wtk_surface_cache_lookup(win, state);
+	if (!surface)
+		goto miss;
+
+	if (surface->origin.x != clip->origin.x
+			|| surface->origin.y != clip->origin.y
+			|| surface->size.x != area->size.x
+			|| surface->size.y != area->size.y
+			|| (parent && surface->parent_background
+				!= win_get_attributes(parent)->background)) {
+		wtk_surface_cache_remove(surface);
+		goto miss;
+	}
+
+	surface->last_used = ++wtk_surface_cache_clock;
+	wtk_surface_cache_stats.hits++;
+
+	bmp.width = surface->size.x;
+	bmp.height = surface->size.y;
+	bmp.type = BITMAP_HUGEMEM;
+	bmp.data.hugemem = wtk_surface_cache_ptr(surface->offset);
+
+	// The bitmap is clipped to the clipping region of the draw event.
+	gfx_put_bitmap(&bmp, 0, 0, clip->origin.x, clip->origin.y,
+			bmp.width, bmp.height);
+
+	return true;
+
+miss:
+	wtk_surface_cache_stats.misses++;
+	return false;
+}
+
+/**
+ * \brief Store the surface of a widget which has just been drawn
+ *
+ * This is called by widgets at the end of a \ref WIN_EVENT_DRAW event.
+ * Nothing is stored unless the clipping region covers the whole widget,
+ * as the rest of the widget has not been drawn. Least recently used
+ * surfaces are evicted as needed to make room for the new one.
+ *
+ * \param win   Widget window which has been drawn.
+ * \param state Widget specific visual state.
+ * \param clip  Clipping region of the draw event.
+ */
+void wtk_surface_cache_store(const struct win_window *win, uint8_t state,
+		const struct win_clip_region *clip)
+{
+	const struct win_area   *area = win_get_area(win);
+	const struct win_window *parent = win_get_parent(win);
+	struct wtk_surface      *surface = NULL;
+	gfx_color_t             buf[WTK_SURFACE_CACHE_CHUNK_PIXELS];
+	uint32_t                length;
+	uint32_t                offset;
+	gfx_coord_t             x;
+	gfx_coord_t             y;
+	uint8_t                 i;
+
+	if (wtk_surface_cache_arena == HUGEMEM_NULL)
+		return;
+
+	if (clip->NW.x != clip->origin.x || clip->NW.y != clip->origin.y
+			|| clip->SE.x != clip->origin.x + area->size.x - 1
+			|| clip->SE.y != clip->origin.y + area->size.y - 1)
+		return;
+
+	length = (uint32_t)area->size.x * area->size.y * sizeof(gfx_color_t);
+	if (length > wtk_surface_cache_size)
+		return;
+
+	surface = wtk_surface_cache_lookup(win, state);
+	if (surface)
+		wtk_surface_cache_remove(surface);
+
+	// Grab an unused entry, or evict the least recently used surface.
+	for (i = 0; i < ARRAY_LEN(wtk_surface_cache_entries); i++) {
+		if (!wtk_surface_cache_entries[i].win) {
+			surface = &wtk_surface_cache_entries[i];
+			break;
+		}
+	}
+	if (!surface) {
+		surface = wtk_surface_cache_find_lru();
+		wtk_surface_cache_remove(surface);
+		wtk_surface_cache_stats.evictions++;
+	}
+
+	while (wtk_surface_cache_stats.bytes_used + length
+			> wtk_surface_cache_size) {
+		struct wtk_surface      *victim;
+
+		victim = wtk_surface_cache_find_lru();
+		assert(victim);
+		wtk_surface_cache_remove(victim);
+		wtk_surface_cache_stats.evictions++;
+	}
+
+	// Read the widget back from the screen, line by line.
+	offset = wtk_surface_cache_stats.bytes_used;
+	for (y = clip->NW.y; y <= clip->SE.y; y++) {
+		for (x = clip->NW.x; x <= clip->SE.x;
+				x += WTK_SURFACE_CACHE_CHUNK_PIXELS) {
+			gfx_coord_t count = min_s(clip->SE.x - x + 1,
+					WTK_SURFACE_CACHE_CHUNK_PIXELS);
+
+			gfx_set_limits(x, y, x + count - 1, y);
+			gfx_copy_pixels_from_screen(buf, count);
+			hugemem_write_block(wtk_surface_cache_ptr(offset), buf,
+					count * sizeof(gfx_color_t));
+			offset += count * sizeof(gfx_color_t);
+		}
+	}
+
+	surface->win = win;
+	surface->state = state;
+	surface->parent_background = parent
+			? win_get_attributes(parent)->background : NULL;
+	surface->origin = clip->origin;
+	surface->size = area->size;
+	surface->offset = wtk_surface_cache_stats.bytes_used;
+	surface->last_used = ++wtk_surface_cache_clock;
+	wtk_surface_cache_stats.bytes_used += length;
+}
+
+/**
+ * \brief Drop all cached surfaces of a widget
+ *
+ * Widgets call this when destroyed, moved or resized. Applications must
+ * call it if they change what is drawn below a widget, other than by
+ * changing the background of its parent window.
+ *
+ * \param win Widget window.
+ */
+void wtk_surface_cache_invalidate(const struct win_window *win)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(wtk_surface_cache_entries); i++) {
+		if (wtk_surface_cache_entries[i].win == win)
+			wtk_surface_cache_remove(&wtk_surface_cache_entries[i]);
+	}
+}
+
+/**
+ * \brief Drop all cached surfaces
+ *
+ * This must be called if the widget colors or font are changed.
+ */
+void wtk_surface_cache_flush(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(wtk_surface_cache_entries); i++)
+		wtk_surface_cache_entries[i].win = NULL;
+
+	wtk_surface_cache_stats.bytes_used = 0;
+}
+
+/**
+ * \brief Get surface cache usage statistics
+ *
+ * \param stats Structure to store the statistics in.
+ */
+void wtk_surface_cache_get_stats(struct wtk_surface_cache_stats *stats)
+{
+	assert(stats);
+
+	*stats = wtk_surface_cache_stats;
+}
+
+//! @}
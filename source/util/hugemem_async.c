@@ -0,0 +1,89 @@
+/**
+ * \file
+ *
+ * \brief Generic asynchronous huge memory operations
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <hugemem.h>
+#include <hugemem_async.h>
+#include <workqueue.h>
+
+/**
+ * \weakgroup hugemem_async_group
+ * @{
+ */
+
+/**
+ * \brief Copy a block of huge memory asynchronously
+ *
+ * \param req  Request to keep the operation state in. Must be kept
+ *             until \a task has been scheduled.
+ * \param to   Destination address.
+ * \param from Source address.
+ * \param size Number of bytes to copy.
+ * \param task Task to schedule when the copy is done, or NULL.
+ */
+void hugemem_copy_async(struct hugemem_request *req, hugemem_ptr_t to,
+		const hugemem_ptr_t from, uint32_t size,
+		struct workqueue_task *task)
+{
+	assert(req);
+
+	hugemem_copy(to, from, size);
+	if (task)
+		workqueue_add_task(&main_workqueue, task);
+}
+
+/**
+ * \brief Fill a block of huge memory asynchronously
+ *
+ * \param req   Request to keep the operation state in. Must be kept
+ *              until \a task has been scheduled.
+ * \param to    Destination address.
+ * \param value Value to fill with.
+ * \param size  Number of bytes to fill.
+ * \param task  Task to schedule when the fill is done, or NULL.
+ */
+void hugemem_fill_async(struct hugemem_request *req, hugemem_ptr_t to,
+		uint8_t value, uint32_t size, struct workqueue_task *task)
+{
+	assert(req);
+
+	hugemem_fill(to, value, size);
+	if (task)
+		workqueue_add_task(&main_workqueue, task);
+}
+
+//! @}
@@ -0,0 +1,369 @@
+/**
+ * \file
+ *
+ * \brief Workqueue and interrupt latency instrumentation
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <debug.h>
+#include <interrupt.h>
+#include <latency.h>
+#include <string.h>
+#include <timer.h>
+#include <util.h>
+#include <workqueue.h>
+
+/**
+ * \weakgroup latency_group
+ * @{
+ */
+
+/**
+ * \internal
+ * \brief Statistics for one worker function.
+ */
+struct latency_worker {
+	//! Worker function, NULL if the entry is unused.
+	workqueue_func_t        worker;
+	//! Number of times a task with this worker has run.
+	uint16_t                nr_runs;
+	//! Longest time waiting in the main work queue.
+	uint16_t                max_wait;
+	//! Longest run time.
+	uint16_t                max_run;
+	//! Total run time.
+	uint32_t                total_run;
+	//! Histogram of the time waiting in the main work queue.
+	uint16_t                wait_hist[LATENCY_NR_BUCKETS];
+	//! Histogram of the run time.
+	uint16_t                run_hist[LATENCY_NR_BUCKETS];
+};
+
+/**
+ * \internal
+ * \brief Statistics for one interrupt.
+ */
+struct latency_irq {
+	//! Number of calls to the handler, 0 if the entry is unused.
+	uint16_t                nr_calls;
+	//! Interrupt ID.
+	uint8_t                 id;
+	//! Longest run time of the handler.
+	uint16_t                max_run;
+	//! Total run time of the handler.
+	uint32_t                total_run;
+};
+
+/**
+ * \internal
+ * \brief Latency instrumentation state.
+ */
+struct latency {
+	//! Timer providing the time, NULL before latency_init().
+	struct timer            *timer;
+	//! Resolution of \a timer in Hz.
+	uint32_t                resolution;
+	//! Tasks run whose worker did not fit in \a workers.
+	uint16_t                nr_untracked_runs;
+	//! Interrupts whose ID did not fit in \a irqs.
+	uint16_t                nr_untracked_irqs;
+	//! Worker function statistics.
+	struct latency_worker   workers[CONFIG_LATENCY_NR_WORKERS];
+	//! Interrupt statistics.
+	struct latency_irq      irqs[CONFIG_LATENCY_NR_IRQS];
+};
+
+static struct latency latency;
+
+/**
+ * \brief Start measuring latencies
+ *
+ * \param timer Timer \a CONFIG_TIMER_ID, which must be running. Pass NULL
+ * to stop measuring.
+ * \param resolution Resolution of \a timer in Hz, used for printing.
+ */
+void latency_init(struct timer *timer, uint32_t resolution)
+{
+	latency_reset();
+	latency.resolution = resolution;
+	latency.timer = timer;
+}
+
+/**
+ * \brief Clear all statistics
+ */
+void latency_reset(void)
+{
+	irqflags_t      iflags;
+
+	iflags = cpu_irq_save();
+	latency.nr_untracked_runs = 0;
+	latency.nr_untracked_irqs = 0;
+	memset(latency.workers, 0, sizeof(latency.workers));
+	memset(latency.irqs, 0, sizeof(latency.irqs));
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \internal
+ * \brief Return the current time in ticks
+ *
+ * This may be called from any context.
+ */
+uint16_t latency_priv_get_time(void)
+{
+	if (!latency.timer)
+		return 0;
+
+	return timer_get_time(CONFIG_TIMER_ID, latency.timer);
+}
+
+/**
+ * \internal
+ * \brief Return the histogram bucket counting \a ticks
+ */
+static uint8_t latency_get_bucket(uint16_t ticks)
+{
+	uint8_t         bucket = 0;
+
+	while (ticks >= 4 && bucket < LATENCY_NR_BUCKETS - 1) {
+		ticks >>= 2;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/**
+ * \internal
+ * \brief Add one to a histogram bucket, saturating at the maximum count
+ */
+static void latency_count(uint16_t *hist, uint16_t ticks)
+{
+	uint8_t         bucket = latency_get_bucket(ticks);
+
+	if (hist[bucket] != 0xffff)
+		hist[bucket]++;
+}
+
+static struct latency_worker *latency_find_worker(workqueue_func_t worker)
+{
+	struct latency_worker   *entry;
+	uint8_t                 i;
+
+	for (i = 0; i < ARRAY_LEN(latency.workers); i++) {
+		entry = &latency.workers[i];
+		if (entry->worker == worker)
+			return entry;
+		if (!entry->worker) {
+			entry->worker = worker;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * \internal
+ * \brief Run a task from the main loop, measuring its wait and run times
+ *
+ * \param task Task which has just been removed from the main work queue.
+ */
+void latency_priv_run_task(struct workqueue_task *task)
+{
+	struct latency_worker   *entry;
+	workqueue_func_t        worker = task->worker;
+	uint16_t                start;
+	uint16_t                wait;
+	uint16_t                run;
+
+	// The task may be freed or queued again by the worker.
+	start = latency_priv_get_time();
+	wait = start - task->queued_at;
+	workqueue_run_task(task);
+	run = latency_priv_get_time() - start;
+
+	entry = latency_find_worker(worker);
+	if (!entry) {
+		latency.nr_untracked_runs++;
+		return;
+	}
+
+	if (entry->nr_runs != 0xffff)
+		entry->nr_runs++;
+	entry->max_wait = max_u(entry->max_wait, wait);
+	entry->max_run = max_u(entry->max_run, run);
+	entry->total_run += run;
+	latency_count(entry->wait_hist, wait);
+	latency_count(entry->run_hist, run);
+}
+
+/**
+ * \internal
+ * \brief Record the run time of an interrupt handler
+ *
+ * \param id Interrupt ID.
+ * \param start Time when the handler was called.
+ */
+void latency_priv_irq_done(uint8_t id, uint16_t start)
+{
+	struct latency_irq      *entry;
+	irqflags_t              iflags;
+	uint16_t                run;
+	uint8_t                 i;
+
+	run = latency_priv_get_time() - start;
+
+	// Handlers of higher levels may update the table as well.
+	iflags = cpu_irq_save();
+	for (i = 0; i < ARRAY_LEN(latency.irqs); i++) {
+		entry = &latency.irqs[i];
+		if (!entry->nr_calls || entry->id == id)
+			break;
+	}
+
+	if (i < ARRAY_LEN(latency.irqs)) {
+		entry->id = id;
+		if (entry->nr_calls != 0xffff)
+			entry->nr_calls++;
+		entry->max_run = max_u(entry->max_run, run);
+		entry->total_run += run;
+	} else {
+		latency.nr_untracked_irqs++;
+	}
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Print a summary of the statistics on the debug console
+ *
+ * The workers are printed with the ones using the most CPU time first,
+ * followed by the interrupts. All times are in timer ticks.
+ */
+void latency_show_top(void)
+{
+	struct latency_worker   *entry;
+	struct latency_irq      irq;
+	irqflags_t              iflags;
+	uint8_t                 order[CONFIG_LATENCY_NR_WORKERS];
+	uint8_t                 nr_workers;
+	uint8_t                 i;
+	uint8_t                 j;
+
+	// Sort the workers by total run time, using insertion sort.
+	for (nr_workers = 0; nr_workers < ARRAY_LEN(latency.workers);
+			nr_workers++) {
+		entry = &latency.workers[nr_workers];
+		if (!entry->worker)
+			break;
+
+		for (j = nr_workers; j > 0; j--) {
+			if (latency.workers[order[j - 1]].total_run
+					>= entry->total_run)
+				break;
+			order[j] = order[j - 1];
+		}
+		order[j] = nr_workers;
+	}
+
+	dbg_info("latency: %lu ticks per second\n",
+			(unsigned long)latency.resolution);
+	dbg_info("   runs   run total   run max  wait max  worker\n");
+	for (i = 0; i < nr_workers; i++) {
+		entry = &latency.workers[order[i]];
+		dbg_info("%7u %11lu %9u %9u  %p\n", entry->nr_runs,
+				(unsigned long)entry->total_run,
+				entry->max_run, entry->max_wait,
+				(void *)entry->worker);
+	}
+	if (latency.nr_untracked_runs)
+		dbg_info("%u runs of other workers\n",
+				latency.nr_untracked_runs);
+
+	dbg_info("  calls   run total   run max  irq\n");
+	for (i = 0; i < ARRAY_LEN(latency.irqs); i++) {
+		iflags = cpu_irq_save();
+		irq = latency.irqs[i];
+		cpu_irq_restore(iflags);
+
+		if (!irq.nr_calls)
+			break;
+		dbg_info("%7u %11lu %9u  %u\n", irq.nr_calls,
+				(unsigned long)irq.total_run, irq.max_run,
+				irq.id);
+	}
+	if (latency.nr_untracked_irqs)
+		dbg_info("%u calls to other interrupt handlers\n",
+				latency.nr_untracked_irqs);
+}
+
+/**
+ * \brief Print the histograms on the debug console
+ *
+ * For each worker, one line with the wait time histogram and one with the
+ * run time histogram are printed, starting with the bucket of the shortest
+ * times:
+ *
+ * \code
+ * LAT W <worker> <count> <count> ...
+ * LAT R <worker> <count> <count> ...
+ * \endcode
+ */
+void latency_dump(void)
+{
+	struct latency_worker   *entry;
+	uint8_t                 i;
+
+	for (i = 0; i < ARRAY_LEN(latency.workers); i++) {
+		entry = &latency.workers[i];
+		if (!entry->worker)
+			break;
+
+		dbg_info("LAT W %p %u %u %u %u %u %u %u %u\n",
+				(void *)entry->worker,
+				entry->wait_hist[0], entry->wait_hist[1],
+				entry->wait_hist[2], entry->wait_hist[3],
+				entry->wait_hist[4], entry->wait_hist[5],
+				entry->wait_hist[6], entry->wait_hist[7]);
+		dbg_info("LAT R %p %u %u %u %u %u %u %u %u\n",
+				(void *)entry->worker,
+				entry->run_hist[0], entry->run_hist[1],
+				entry->run_hist[2], entry->run_hist[3],
+				entry->run_hist[4], entry->run_hist[5],
+				entry->run_hist[6], entry->run_hist[7]);
+	}
+}
+
+//! @}
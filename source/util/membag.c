@@ -36,6 +36,8 @@
  * DAMAGE.
  */
 #include <assert.h>
+#include <bitops.h>
+#include <compiler.h>
 #include <debug.h>
 #include <interrupt.h>
 #include <util.h>
@@ -54,6 +56,10 @@ struct membag {
 
 	void *start; //!< Pointer to start of this bag
 	void *end; //!< Pointer to end of this bag
+#ifdef CONFIG_MEMBAG_TRACK_ALLOC_SITES
+	size_t stride; //!< Distance in bytes between blocks in this bag.
+	const void **alloc_sites; //!< Allocation site per block, NULL if free.
+#endif
 #ifdef CONFIG_MEMBAG_USE_TUNING
 	struct membag_bagstats stats; //!< Keeps track of statistics for this bag
 #endif
@@ -70,8 +76,9 @@ struct membag {
  * \param pool Pointer to physmem_pool to allocate this memory from.
  * \sa physmem_pool
  */
-#define MEMBAG(objsize, nr_objs, pool)			\
-	{ .block_size = objsize, .num_blocks = nr_objs, .phys_pool = pool }
+#define MEMBAG(objsize, nr_objs, pool)				\
+	{ .block_size = MEMBAG_BLOCK_SIZE(objsize),		\
+		.num_blocks = nr_objs, .phys_pool = pool }
 
 /**
  * \brief Memory bag
@@ -99,6 +106,149 @@ static struct membag membags[] = {
 	APP_MEMBAG_INITIALIZER
 };
 
+//! Mask with one bit per bag, wide enough for all configured bags.
+typedef uint16_t membag_mask_t;
+
+/**
+ * \internal
+ * \brief Mask of bags which have at least one free block.
+ *
+ * Bit \a n is set if bag \a n has a free block, so that an allocation can
+ * skip exhausted bags without trying to allocate from them.
+ */
+static membag_mask_t membag_available;
+
+/**
+ * \internal
+ * \brief Number of size classes.
+ *
+ * Requests are grouped into classes by the base-2 logarithm of their size,
+ * rounded up. Class \a k holds requests of 2^(k-1) + 1 to 2^k bytes, and
+ * class 0 holds requests of at most one byte.
+ */
+#define MEMBAG_NR_SIZE_CLASSES   (8 * sizeof(size_t) + 1)
+
+/**
+ * \internal
+ * \brief Bags to allocate a request of a size class from.
+ *
+ * A request is given the \a first bag if it fits, and the \a fit bag
+ * otherwise. Only bags with a block size strictly inside the size class
+ * lie between the two, so when there is at most one of those, which is
+ * always the case with power-of-two block sizes, this is the best fit.
+ */
+struct membag_size_class {
+	//! Index of the first bag that can hold the smallest request.
+	uint8_t         first;
+	//! Index of the first bag that can hold every request.
+	uint8_t         fit;
+};
+
+//! \internal Bags to allocate from, for each size class.
+static struct membag_size_class membag_size_classes[MEMBAG_NR_SIZE_CLASSES];
+
+/**
+ * \def CONFIG_MEMBAG_OWNER_TABLE_SIZE
+ * \brief Number of entries in the table used to look up the bag owning a
+ * block on free.
+ *
+ * The address range covered by the bags is split into this many granules,
+ * so larger values give fewer bags per granule to check on free.
+ */
+#ifndef CONFIG_MEMBAG_OWNER_TABLE_SIZE
+# define CONFIG_MEMBAG_OWNER_TABLE_SIZE  32
+#endif
+
+//! Bag indexes, sorted by start address of the bag.
+static uint8_t membag_by_addr[ARRAY_LEN(membags)];
+
+/**
+ * \internal
+ * \brief Owner lookup table for freeing blocks.
+ *
+ * Entry \a n holds the position in \ref membag_by_addr of the last bag that
+ * starts at or before the start of granule \a n.
+ */
+static uint8_t membag_owner_table[CONFIG_MEMBAG_OWNER_TABLE_SIZE];
+//! Lowest address of any bag.
+static uintptr_t membag_owner_base;
+//! log2 of the size of each granule in the owner lookup table.
+static uint8_t membag_owner_shift;
+
+#ifdef CONFIG_MEMBAG_TRACE
+/**
+ * \internal
+ * \brief Allocation trace state.
+ */
+struct membag_trace {
+	//! Recorded events, in order.
+	struct membag_trace_entry entries[CONFIG_MEMBAG_TRACE_ENTRIES];
+	//! Number of recorded events.
+	uint16_t nr_entries;
+	//! Number of events not recorded since the buffer was full.
+	uint16_t nr_dropped;
+	//! Sequence number of the next event, used as timestamp.
+	uint16_t sequence;
+	//! True if events are being recorded.
+	bool enabled;
+};
+
+//! Allocation trace buffer.
+static struct membag_trace membag_trace;
+
+/**
+ * \internal
+ * \brief Record an allocator event in the trace buffer.
+ *
+ * Recording stops when the buffer is full rather than wrapping around, so
+ * that every recorded free has its allocation in the trace, unless the
+ * block was allocated before the trace was started.
+ *
+ * \param type   Event type.
+ * \param size   Requested size for allocations, 0 for frees.
+ * \param ptr    Block allocated or freed, NULL for failed allocations.
+ * \param caller Return address of the call to the allocator.
+ */
+static void membag_trace_record(enum membag_trace_type type, size_t size,
+		const void *ptr, const void *caller)
+{
+	struct membag_trace_entry *entry;
+	irqflags_t iflags;
+
+	iflags = cpu_irq_save();
+
+	if (membag_trace.enabled) {
+		if (membag_trace.nr_entries < CONFIG_MEMBAG_TRACE_ENTRIES) {
+			entry = &membag_trace.entries[membag_trace.nr_entries++];
+			entry->type = type;
+			entry->timestamp = membag_trace.sequence;
+			entry->size = size;
+			entry->ptr = ptr;
+			entry->caller = caller;
+		} else {
+			membag_trace.nr_dropped++;
+		}
+		membag_trace.sequence++;
+	}
+
+	cpu_irq_restore(iflags);
+}
+
+/*
+ * These are macros so that the return address is that of the caller of
+ * membag_alloc() or membag_free().
+ */
+# define membag_trace_alloc(size, ptr)					\
+	membag_trace_record(MEMBAG_TRACE_ALLOC, (size), (ptr),		\
+			compiler_return_address())
+# define membag_trace_free(ptr)						\
+	membag_trace_record(MEMBAG_TRACE_FREE, 0, (ptr),		\
+			compiler_return_address())
+#else
+# define membag_trace_alloc(size, ptr)  do { } while (0)
+# define membag_trace_free(ptr)         do { } while (0)
+#endif
+
 
 /**
  * \internal Internal function for initializing each membag
@@ -137,6 +287,18 @@ static void membag_pool_init_physmem(struct membag *mb, unsigned int align_order
 	mb->start = pool_vaddr;
 	mb->end = (uint8_t *)pool_vaddr + pool_size;
 
+#ifdef CONFIG_MEMBAG_TRACK_ALLOC_SITES
+	mb->stride = block_size;
+
+	pool_size = mb->num_blocks * sizeof(*mb->alloc_sites);
+	pool_addr = physmem_alloc(mb->phys_pool, pool_size, align_order);
+	assert(pool_addr != PHYSMEM_ALLOC_ERR);
+
+	mb->alloc_sites = physmem_map(pool_addr, pool_size,
+			PHYS_MAP_WRBUF | PHYS_MAP_WRBACK);
+	memset(mb->alloc_sites, 0, pool_size);
+#endif
+
 #ifdef CONFIG_MEMBAG_USE_TUNING
 	mb->stats.num_free_blocks = mb->num_blocks;
 	mb->stats.max_blocks_used = 0;
@@ -147,6 +309,144 @@ static void membag_pool_init_physmem(struct membag *mb, unsigned int align_order
 }
 
 
+/**
+ * \internal
+ * \brief Fill in the size class table from the bag configuration.
+ */
+static void membag_init_size_classes(void)
+{
+	uint8_t class;
+	uint8_t i = 0;
+	uint8_t j;
+	size_t min_size;
+
+	for (class = 0; class < MEMBAG_NR_SIZE_CLASSES; class++) {
+		// Smallest request in this size class.
+		min_size = (class == 0) ? 0 : ((size_t)1 << (class - 1)) + 1;
+
+		while ((i < ARRAY_LEN(membags))
+				&& (membags[i].block_size < min_size))
+			i++;
+
+		// Skip bags smaller than 2^class, the largest request.
+		j = i;
+		if (class > 0) {
+			while ((j < ARRAY_LEN(membags))
+					&& ((membags[j].block_size
+						>> (class - 1)) < 2))
+				j++;
+		}
+
+		membag_size_classes[class].first = i;
+		membag_size_classes[class].fit = j;
+	}
+}
+
+/**
+ * \internal
+ * \brief Return the size class of a request.
+ *
+ * \param size Number of bytes requested.
+ *
+ * \return Index into \ref membag_size_classes for \a size.
+ */
+static uint8_t membag_get_size_class(size_t size)
+{
+	if (size <= 1)
+		return 0;
+
+	return ilog2(size - 1) + 1;
+}
+
+/**
+ * \internal
+ * \brief Build the address-sorted bag list and the owner lookup table.
+ *
+ * The granule size is chosen as the smallest power of two which lets the
+ * table cover all bags.
+ */
+static void membag_init_owner_table(void)
+{
+	uintptr_t start;
+	uintptr_t end = 0;
+	uint8_t entry;
+	uint8_t pos;
+	uint8_t i;
+	uint8_t j;
+
+	// Insertion sort of bag indexes by start address.
+	for (i = 0; i < ARRAY_LEN(membags); i++) {
+		start = (uintptr_t)membags[i].start;
+
+		for (j = i; j > 0; j--) {
+			if ((uintptr_t)membags[membag_by_addr[j - 1]].start
+					< start)
+				break;
+			membag_by_addr[j] = membag_by_addr[j - 1];
+		}
+		membag_by_addr[j] = i;
+
+		if ((uintptr_t)membags[i].end > end)
+			end = (uintptr_t)membags[i].end;
+	}
+
+	membag_owner_base = (uintptr_t)membags[membag_by_addr[0]].start;
+
+	membag_owner_shift = 0;
+	while (((end - membag_owner_base - 1) >> membag_owner_shift)
+			>= CONFIG_MEMBAG_OWNER_TABLE_SIZE)
+		membag_owner_shift++;
+
+	pos = 0;
+	for (entry = 0; entry < CONFIG_MEMBAG_OWNER_TABLE_SIZE; entry++) {
+		start = membag_owner_base
+			+ ((uintptr_t)entry << membag_owner_shift);
+
+		while ((pos + 1 < ARRAY_LEN(membags))
+				&& ((uintptr_t)membags[membag_by_addr[pos + 1]]
+					.start <= start))
+			pos++;
+
+		membag_owner_table[entry] = pos;
+	}
+}
+
+/**
+ * \internal
+ * \brief Find the bag which a block belongs to.
+ *
+ * \param ptr Pointer to a block.
+ *
+ * \return Index of the bag containing \a ptr, or -1 if no bag contains it.
+ */
+static int_fast8_t membag_find_owner(const void *ptr)
+{
+	uintptr_t addr = (uintptr_t)ptr;
+	uintptr_t offset;
+	uint8_t pos;
+	uint8_t i;
+
+	if (addr < membag_owner_base)
+		return -1;
+
+	offset = (addr - membag_owner_base) >> membag_owner_shift;
+	if (offset >= CONFIG_MEMBAG_OWNER_TABLE_SIZE)
+		return -1;
+
+	// Skip past any bags which start within the granule, before ptr.
+	pos = membag_owner_table[offset];
+	while ((pos + 1 < ARRAY_LEN(membags))
+			&& ((uintptr_t)membags[membag_by_addr[pos + 1]].start
+				<= addr))
+		pos++;
+
+	i = membag_by_addr[pos];
+	if (addr >= (uintptr_t)membags[i].end)
+		return -1;
+
+	return i;
+}
+
 /**
  * \brief Initialize memory manager before use
  *
@@ -164,10 +464,21 @@ void membag_init(const unsigned int align_order)
 {
 	uint8_t i;
 
+	build_assert(ARRAY_LEN(membags) <= 8 * sizeof(membag_mask_t));
+
 	// Iterate over all bags and allocate them from physical memory
 	for (i = 0; i < ARRAY_LEN(membags); i++) {
+		// Size class lookup relies on the bags being sorted by size.
+		assert((i == 0)
+				|| (membags[i - 1].block_size
+					<= membags[i].block_size));
+
 		membag_pool_init_physmem(&membags[i], align_order);
+		membag_available |= (membag_mask_t)1 << i;
 	}
+
+	membag_init_size_classes();
+	membag_init_owner_table();
 }
 
 /**
@@ -264,61 +575,90 @@ size_t membag_get_largest_free_block_size(void)
  * equal or larger than the number of bytes requested. Memory is then
  * allocated from within that bag.
  *
+ * The first bag large enough for the request is looked up through a table
+ * of size classes, and exhausted bags are skipped by use of a mask of bags
+ * with free blocks, so the run time does not depend on the number of bags.
+ * The block is taken off the freelist of the bag in the same critical
+ * section as the mask is updated.
+ *
  * \param size Size of buffer to allocate
  * \return A pointer to the memory block. NULL if no memory was available
  */
 void *membag_alloc(size_t size)
 {
+	const struct membag_size_class *class;
+	membag_mask_t candidates;
+	irqflags_t iflags;
 	uint8_t i;
-	void *ptr = NULL;
+	void *ptr;
 
-	// Iterate through bags to find smallest available bag
-	for (i = 0; i < ARRAY_LEN(membags); i++) {
-		// If bag is too small then skip to next bag
-		if (membags[i].block_size < size) {
-			continue;
-		}
+	// Find the smallest bag that can hold the request.
+	class = &membag_size_classes[membag_get_size_class(size)];
+	i = class->first;
+	if ((i < ARRAY_LEN(membags)) && (membags[i].block_size < size))
+		i = class->fit;
+
+	if (i == ARRAY_LEN(membags)) {
+		membag_trace_alloc(size, NULL);
+		return NULL;
+	}
 
-		// Try to allocate memory
-		ptr = mem_pool_alloc(&membags[i].pool);
+	iflags = cpu_irq_save();
 
-		// If allocation failed we continue to the next bag
-		if (ptr == NULL) {
-			continue;
-		}
+	// Pick the smallest bag of sufficient size which has a free block.
+	candidates = membag_available & ~(((membag_mask_t)1 << i) - 1);
+	if (!candidates) {
+		cpu_irq_restore(iflags);
+		membag_trace_alloc(size, NULL);
+		return NULL;
+	}
+
+	i = bit_word_find_first_one_bit(candidates);
+	ptr = mem_pool_priv_alloc(&membags[i].pool);
+	assert(ptr);
+
+	if (!membags[i].pool.freelist)
+		membag_available &= ~((membag_mask_t)1 << i);
+
+#ifdef CONFIG_MEMBAG_TRACK_ALLOC_SITES
+	membags[i].alloc_sites[((uintptr_t)ptr - (uintptr_t)membags[i].start)
+			/ membags[i].stride] = compiler_return_address();
+#endif
 
 #ifdef CONFIG_MEMBAG_USE_TUNING
-		membags[i].stats.num_free_blocks--;
+	membags[i].stats.num_free_blocks--;
 
-		// Update allocations
-		membags[i].stats.num_allocations++;
+	// Update allocations
+	membags[i].stats.num_allocations++;
 
-		// Update high/low watermarks
-		if (membags[i].stats.num_allocations >
-				membags[i].stats.max_blocks_used) {
-			membags[i].stats.max_blocks_used =
-				membags[i].stats.num_allocations;
-		}
+	// Update high/low watermarks
+	if (membags[i].stats.num_allocations >
+			membags[i].stats.max_blocks_used) {
+		membags[i].stats.max_blocks_used =
+			membags[i].stats.num_allocations;
+	}
 
-		if (size < membags[i].stats.min_block_size) {
-			membags[i].stats.min_block_size = size;
-		}
+	if (size < membags[i].stats.min_block_size) {
+		membags[i].stats.min_block_size = size;
+	}
 
-		if (size > membags[i].stats.max_block_size) {
-			membags[i].stats.max_block_size = size;
-		}
+	if (size > membags[i].stats.max_block_size) {
+		membags[i].stats.max_block_size = size;
+	}
 #endif
 
-		// Memory has been allocated, skip any further looping
-		break;
-	}
+	cpu_irq_restore(iflags);
+
+	membag_trace_alloc(size, ptr);
+
 	return ptr;
 }
 
 /**
  * \brief Free previously allocated memory
  *
- * This function returns a block of memory to the correct memory bag
+ * This function returns a block of memory to the correct memory bag,
+ * which is found through an address lookup table.
  *
  * \note Invalid addresses will be ignored.
  * \note Do not free previously freed memory
@@ -326,20 +666,84 @@ void *membag_alloc(size_t size)
  */
 void membag_free(void *ptr)
 {
-	uint8_t i;
+	irqflags_t iflags;
+	int_fast8_t i;
 
-	// Iterate through bags to free memory in correct bag
-	for (i = 0; i < ARRAY_LEN(membags); i++) {
-		if ((ptr >= membags[i].start) && (ptr <= membags[i].end)) {
-			// Found correct bag. Free memory and return
-			mem_pool_free(&membags[i].pool, ptr);
+	i = membag_find_owner(ptr);
+	if (i < 0)
+		return;
+
+	membag_trace_free(ptr);
+
+	iflags = cpu_irq_save();
+
+	mem_pool_priv_free(&membags[i].pool, ptr);
+	membag_available |= (membag_mask_t)1 << i;
+
+#ifdef CONFIG_MEMBAG_TRACK_ALLOC_SITES
+	membags[i].alloc_sites[((uintptr_t)ptr - (uintptr_t)membags[i].start)
+			/ membags[i].stride] = NULL;
+#endif
 #ifdef CONFIG_MEMBAG_USE_TUNING
-			membags[i].stats.num_free_blocks++;
+	membags[i].stats.num_free_blocks++;
 #endif
-			break;
+
+	cpu_irq_restore(iflags);
+}
+
+#ifdef CONFIG_MEMBAG_TRACK_ALLOC_SITES
+/**
+ * \brief Get allocation site of a block
+ *
+ * This function returns the return address of the call to \ref membag_alloc()
+ * which allocated the block at \a ptr, which can be translated to a source
+ * line with, e.g., addr2line.
+ *
+ * \note On AVR, the return address is a word address, and must be multiplied
+ * by two to get the byte address used by the toolchain.
+ *
+ * \param ptr Pointer to an allocated block.
+ *
+ * \return Address of allocation site, or NULL if \a ptr is not allocated.
+ */
+const void *membag_get_alloc_site(const void *ptr)
+{
+	int_fast8_t i;
+
+	i = membag_find_owner(ptr);
+	if (i < 0)
+		return NULL;
+
+	return membags[i].alloc_sites[((uintptr_t)ptr
+			- (uintptr_t)membags[i].start) / membags[i].stride];
+}
+
+/**
+ * \brief Print all allocated blocks with their allocation sites
+ *
+ * This function prints, through the debug console, which call site holds
+ * each allocated block in each bag.
+ */
+void membag_dump_alloc_sites(void)
+{
+	const void *site;
+	size_t block;
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_LEN(membags); i++) {
+		dbg_info("membag %u: %zu x %zu bytes\n", i,
+				membags[i].num_blocks, membags[i].block_size);
+
+		for (block = 0; block < membags[i].num_blocks; block++) {
+			site = membags[i].alloc_sites[block];
+			if (site)
+				dbg_info("  %p: %p\n", (uint8_t *)membags[i].start
+						+ block * membags[i].stride,
+						site);
 		}
 	}
 }
+#endif
 
 #ifdef CONFIG_MEMBAG_USE_TUNING
 /**
@@ -360,3 +764,86 @@ void membag_get_bag_stats(size_t bag_no, struct membag_bagstats *stats)
 	memcpy(stats, &membags[bag_no].stats, sizeof(struct membag_bagstats));
 }
 #endif
+
+#ifdef CONFIG_MEMBAG_TRACE
+/**
+ * \brief Start recording allocator events
+ *
+ * This function clears the trace buffer and starts recording every call to
+ * \ref membag_alloc() and \ref membag_free() until the buffer is full or
+ * \ref membag_trace_stop() is called.
+ */
+void membag_trace_start(void)
+{
+	irqflags_t iflags;
+
+	iflags = cpu_irq_save();
+	membag_trace.nr_entries = 0;
+	membag_trace.nr_dropped = 0;
+	membag_trace.sequence = 0;
+	membag_trace.enabled = true;
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Stop recording allocator events
+ */
+void membag_trace_stop(void)
+{
+	membag_trace.enabled = false;
+}
+
+/**
+ * \brief Get recorded allocator events
+ *
+ * \param entries Pointer to store address of the first recorded event in.
+ *
+ * \return Number of recorded events.
+ */
+uint16_t membag_trace_get_entries(const struct membag_trace_entry **entries)
+{
+	*entries = membag_trace.entries;
+
+	return membag_trace.nr_entries;
+}
+
+/**
+ * \brief Print the bag layout and the recorded allocator events
+ *
+ * This function prints the trace through the debug console, one event per
+ * line, in the format read by the membag tuner in tools/membag-tuner:
+ * - "MBT L <block size> <number of blocks>" for each configured bag,
+ * - "MBT A <timestamp> <size> <pointer> <caller>" for each allocation,
+ * - "MBT F <timestamp> <pointer> <caller>" for each free,
+ * - "MBT D <number of events>" if events were dropped.
+ *
+ * A failed allocation is printed with a null pointer. Recording should be
+ * stopped before calling this function.
+ */
+void membag_trace_dump(void)
+{
+	const struct membag_trace_entry *entry;
+	uint16_t i;
+
+	for (i = 0; i < ARRAY_LEN(membags); i++) {
+		dbg_info("MBT L %zu %zu\n", membags[i].block_size,
+				membags[i].num_blocks);
+	}
+
+	for (i = 0; i < membag_trace.nr_entries; i++) {
+		entry = &membag_trace.entries[i];
+
+		if (entry->type == MEMBAG_TRACE_ALLOC) {
+			dbg_info("MBT A %u %u %p %p\n", entry->timestamp,
+					entry->size, entry->ptr, entry->caller);
+		} else {
+			dbg_info("MBT F %u %p %p\n", entry->timestamp,
+					entry->ptr, entry->caller);
+		}
+	}
+
+	if (membag_trace.nr_dropped) {
+		dbg_info("MBT D %u\n", membag_trace.nr_dropped);
+	}
+}
+#endif
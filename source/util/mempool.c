@@ -48,10 +48,6 @@
  * @{
  */
 
-struct mem_pool_object {
-	struct mem_pool_object	*next;
-};
-
 /**
  * \brief Initialize a memory pool
  *
@@ -162,9 +158,7 @@ void *mem_pool_alloc(struct mem_pool *pool)
 	assert(pool);
 
 	iflags = cpu_irq_save();
-	obj = pool->freelist;
-	if (obj)
-		pool->freelist = obj->next;
+	obj = mem_pool_priv_alloc(pool);
 	cpu_irq_restore(iflags);
 
 	return obj;
@@ -189,7 +183,6 @@ void *mem_pool_alloc(struct mem_pool *pool)
  */
 void mem_pool_free(struct mem_pool *pool, const void *obj)
 {
-	struct mem_pool_object	*free_obj;
 	unsigned long		iflags;
 
 	assert(pool);
@@ -197,11 +190,8 @@ void mem_pool_free(struct mem_pool *pool, const void *obj)
 	if (!obj)
 		return;
 
-	free_obj = (struct mem_pool_object *)obj;
-
 	iflags = cpu_irq_save();
-	free_obj->next = pool->freelist;
-	pool->freelist = free_obj;
+	mem_pool_priv_free(pool, obj);
 	cpu_irq_restore(iflags);
 }
 
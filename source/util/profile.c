@@ -0,0 +1,199 @@
+/**
+ * \file
+ *
+ * \brief Sampling profiler sample buffer
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <debug.h>
+#include <hugemem.h>
+#include <interrupt.h>
+#include <profile.h>
+#include <board/physmem.h>
+
+/**
+ * \weakgroup profile_group
+ * @{
+ */
+
+//! Number of samples printed on each line by profile_dump().
+#define PROFILE_SAMPLES_PER_LINE        8
+
+/**
+ * \internal
+ * \brief Profiler state.
+ */
+struct profile {
+	//! Sample buffer, holding \ref CONFIG_PROFILE_NR_SAMPLES samples.
+	hugemem_ptr_t   samples;
+	//! Number of recorded samples.
+	uint16_t        nr_samples;
+	//! Number of samples not recorded since the buffer was full.
+	uint16_t        nr_dropped;
+	//! Actual sampling rate in Hz, 0 if not sampling.
+	uint32_t        rate;
+};
+
+static struct profile profile;
+
+/**
+ * \brief Initialize the profiler
+ *
+ * This allocates the sample buffer from the external RAM pool.
+ */
+void profile_init(void)
+{
+	profile.samples = hugemem_alloc(&board_extram_pool,
+			(phys_size_t)CONFIG_PROFILE_NR_SAMPLES * 4, 2);
+	assert(profile.samples != HUGEMEM_NULL);
+}
+
+/**
+ * \internal
+ * \brief Record a sample
+ *
+ * This is called by the sampling timer backend for each sample, with
+ * interrupts masked.
+ *
+ * \param sample The byte address of the interrupted instruction, with the
+ * context flags in bits 31:24.
+ */
+void profile_priv_record(uint32_t sample)
+{
+	if (profile.nr_samples < CONFIG_PROFILE_NR_SAMPLES) {
+		hugemem_write32((hugemem_ptr_t)((phys_addr_t)profile.samples
+					+ (phys_addr_t)profile.nr_samples * 4),
+				sample);
+		profile.nr_samples++;
+	} else {
+		profile.nr_dropped++;
+	}
+}
+
+/**
+ * \brief Start sampling
+ *
+ * Samples are added to the ones already in the buffer. Call
+ * profile_reset() first to start a new profile.
+ *
+ * \param rate Number of samples per second. The actual rate may be
+ * slightly different, and is printed by profile_dump().
+ */
+void profile_start(uint32_t rate)
+{
+	assert(rate);
+	assert(profile.samples != HUGEMEM_NULL);
+
+	profile_priv_timer_stop();
+	profile.rate = profile_priv_timer_start(rate);
+}
+
+/**
+ * \brief Stop sampling
+ */
+void profile_stop(void)
+{
+	profile_priv_timer_stop();
+}
+
+/**
+ * \brief Discard all recorded samples
+ */
+void profile_reset(void)
+{
+	irqflags_t      iflags;
+
+	iflags = cpu_irq_save();
+	profile.nr_samples = 0;
+	profile.nr_dropped = 0;
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Return the number of recorded samples
+ */
+uint16_t profile_get_nr_samples(void)
+{
+	return profile.nr_samples;
+}
+
+/**
+ * \brief Print the recorded samples on the debug console
+ *
+ * The output starts with a header line giving the sampling rate in Hz, the
+ * number of samples and the number of samples which were dropped because the
+ * buffer was full, followed by the samples in hex, several on each line, and
+ * an end marker:
+ *
+ * \code
+ * PRF H <rate> <samples> <dropped>
+ * PRF S <sample> <sample> ...
+ * PRF E
+ * \endcode
+ *
+ * Sampling should be stopped while the samples are printed.
+ */
+void profile_dump(void)
+{
+	uint16_t        i;
+	uint8_t         j;
+	uint32_t        s[PROFILE_SAMPLES_PER_LINE];
+	hugemem_ptr_t   p = profile.samples;
+
+	dbg_info("PRF H %lu %u %u\n", (unsigned long)profile.rate,
+			profile.nr_samples, profile.nr_dropped);
+
+	for (i = 0; i < profile.nr_samples; i += PROFILE_SAMPLES_PER_LINE) {
+		for (j = 0; j < PROFILE_SAMPLES_PER_LINE; j++) {
+			if (i + j < profile.nr_samples) {
+				s[j] = hugemem_read32(p);
+				p = (hugemem_ptr_t)((phys_addr_t)p + 4);
+			} else {
+				s[j] = 0;
+			}
+		}
+
+		// Zero samples at the end of the last line are ignored.
+		dbg_info("PRF S %08lx %08lx %08lx %08lx "
+				"%08lx %08lx %08lx %08lx\n",
+				(unsigned long)s[0], (unsigned long)s[1],
+				(unsigned long)s[2], (unsigned long)s[3],
+				(unsigned long)s[4], (unsigned long)s[5],
+				(unsigned long)s[6], (unsigned long)s[7]);
+	}
+
+	dbg_info("PRF E\n");
+}
+
+//! @}
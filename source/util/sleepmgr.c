@@ -0,0 +1,349 @@
+/**
+ * \file
+ *
+ * \brief Sleep manager
+ *
+ * Copyright (C) 2011 Atmel Corporation. All rights reserved.
+ *
+ * \page License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. The name of Atmel may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ *
+ * 4. This software may only be redistributed and used in connection with an
+ * Atmel AVR product.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ */
+#include <assert.h>
+#include <debug.h>
+#include <interrupt.h>
+#include <sleepmgr.h>
+#include <string.h>
+#include <util.h>
+
+#ifdef CONFIG_SLEEPMGR_STATS
+#include <timer.h>
+#endif
+
+/**
+ * \weakgroup sleepmgr_group
+ * @{
+ */
+
+//! Lock count of each sleep mode.
+static uint8_t sleepmgr_locks[SLEEPMGR_NR_MODES];
+
+#ifdef CONFIG_SLEEPMGR_STATS
+
+/**
+ * \internal
+ * \brief Statistics for one sleep mode.
+ */
+struct sleepmgr_mode_stats {
+	//! Number of times the mode was entered.
+	uint16_t                nr_sleeps;
+	//! Longest time spent in the mode.
+	uint16_t                max_residency;
+	//! Total time spent in the mode.
+	uint32_t                residency;
+};
+
+/**
+ * \internal
+ * \brief Wake-up statistics for one interrupt.
+ */
+struct sleepmgr_wake_source {
+	//! Number of wake-ups, 0 if the entry is unused.
+	uint16_t                nr_wakes;
+	//! Interrupt ID.
+	uint8_t                 id;
+};
+
+/**
+ * \internal
+ * \brief Sleep manager statistics.
+ */
+struct sleepmgr_stats {
+	//! Timer providing the time, NULL before sleepmgr_stats_init().
+	struct timer            *timer;
+	//! Resolution of \a timer in Hz.
+	uint32_t                resolution;
+	//! Time of the last wake-up.
+	uint16_t                woke_at;
+	//! Total time awake.
+	uint32_t                active;
+	//! Wake-ups without any interrupt handler running first.
+	uint16_t                nr_unknown_wakes;
+	//! Wake-ups by interrupts whose ID did not fit in \a sources.
+	uint16_t                nr_untracked_wakes;
+	//! Sleep mode statistics.
+	struct sleepmgr_mode_stats modes[SLEEPMGR_NR_MODES];
+	//! Wake-up source statistics.
+	struct sleepmgr_wake_source sources[CONFIG_SLEEPMGR_NR_WAKE_SOURCES];
+};
+
+static struct sleepmgr_stats sleepmgr_stats;
+
+bool sleepmgr_priv_sleeping;
+
+#endif /* CONFIG_SLEEPMGR_STATS */
+
+/**
+ * \brief Prevent the CPU from sleeping deeper than \a mode
+ *
+ * This may be called from any context. Each call must be balanced by a
+ * call to sleepmgr_unlock_mode() with the same mode.
+ *
+ * \param mode The deepest sleep mode allowed, or #SLEEPMGR_ACTIVE to
+ * keep the CPU from sleeping at all.
+ */
+void sleepmgr_lock_mode(enum sleepmgr_mode mode)
+{
+	irqflags_t      iflags;
+
+	assert(mode < SLEEPMGR_NR_MODES);
+
+	iflags = cpu_irq_save();
+	assert(sleepmgr_locks[mode] != 0xff);
+	sleepmgr_locks[mode]++;
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Release a lock taken by sleepmgr_lock_mode()
+ *
+ * \param mode The mode passed to sleepmgr_lock_mode().
+ */
+void sleepmgr_unlock_mode(enum sleepmgr_mode mode)
+{
+	irqflags_t      iflags;
+
+	assert(mode < SLEEPMGR_NR_MODES);
+
+	iflags = cpu_irq_save();
+	assert(sleepmgr_locks[mode] != 0);
+	sleepmgr_locks[mode]--;
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \brief Return the deepest sleep mode allowed by the locked modes
+ */
+enum sleepmgr_mode sleepmgr_get_sleep_mode(void)
+{
+	uint8_t         mode;
+
+	for (mode = SLEEPMGR_ACTIVE; mode < SLEEPMGR_NR_MODES - 1; mode++)
+		if (sleepmgr_locks[mode])
+			break;
+
+	return (enum sleepmgr_mode)mode;
+}
+
+#ifdef CONFIG_SLEEPMGR_STATS
+
+/**
+ * \brief Start collecting statistics
+ *
+ * \param timer Timer \a CONFIG_TIMER_ID, which must be running. Pass NULL
+ * to stop measuring times; the sleeps and wake-ups are still counted.
+ * \param resolution Resolution of \a timer in Hz, used for printing.
+ */
+void sleepmgr_stats_init(struct timer *timer, uint32_t resolution)
+{
+	sleepmgr_stats.timer = timer;
+	sleepmgr_stats.resolution = resolution;
+	sleepmgr_stats_reset();
+}
+
+//! Return the current time in ticks.
+static uint16_t sleepmgr_stats_get_time(void)
+{
+	if (!sleepmgr_stats.timer)
+		return 0;
+
+	return timer_get_time(CONFIG_TIMER_ID, sleepmgr_stats.timer);
+}
+
+/**
+ * \brief Clear all statistics
+ */
+void sleepmgr_stats_reset(void)
+{
+	irqflags_t      iflags;
+
+	iflags = cpu_irq_save();
+	sleepmgr_stats.woke_at = sleepmgr_stats_get_time();
+	sleepmgr_stats.active = 0;
+	sleepmgr_stats.nr_unknown_wakes = 0;
+	sleepmgr_stats.nr_untracked_wakes = 0;
+	memset(sleepmgr_stats.modes, 0, sizeof(sleepmgr_stats.modes));
+	memset(sleepmgr_stats.sources, 0, sizeof(sleepmgr_stats.sources));
+	cpu_irq_restore(iflags);
+}
+
+/**
+ * \internal
+ * \brief Record interrupt \a id as the source of the current wake-up
+ *
+ * This is called from the first interrupt handler run after entering a
+ * sleep mode, with interrupts disabled.
+ */
+void sleepmgr_priv_woken_by(uint8_t id)
+{
+	struct sleepmgr_wake_source     *entry;
+	uint8_t                         i;
+
+	sleepmgr_priv_sleeping = false;
+	sleepmgr_stats.woke_at = sleepmgr_stats_get_time();
+
+	for (i = 0; i < ARRAY_LEN(sleepmgr_stats.sources); i++) {
+		entry = &sleepmgr_stats.sources[i];
+		if (!entry->nr_wakes || entry->id == id)
+			break;
+	}
+
+	if (i < ARRAY_LEN(sleepmgr_stats.sources)) {
+		entry->id = id;
+		if (entry->nr_wakes != 0xffff)
+			entry->nr_wakes++;
+	} else if (sleepmgr_stats.nr_untracked_wakes != 0xffff) {
+		sleepmgr_stats.nr_untracked_wakes++;
+	}
+}
+
+/**
+ * \internal
+ * \brief Enter \a mode, measuring the time until the CPU wakes up
+ *
+ * \pre Interrupts are disabled
+ * \post Interrupts are enabled
+ */
+static void sleepmgr_stats_sleep(enum sleepmgr_mode mode)
+{
+	struct sleepmgr_mode_stats      *entry = &sleepmgr_stats.modes[mode];
+	uint16_t                        start;
+	uint16_t                        residency;
+
+	start = sleepmgr_stats_get_time();
+	sleepmgr_stats.active += (uint16_t)(start - sleepmgr_stats.woke_at);
+
+	sleepmgr_priv_sleeping = true;
+	cpu_sleepmgr_enter(mode);
+	cpu_irq_disable();
+
+	if (sleepmgr_priv_sleeping) {
+		// Woken up by something other than an interrupt handler
+		sleepmgr_priv_sleeping = false;
+		sleepmgr_stats.woke_at = sleepmgr_stats_get_time();
+		if (sleepmgr_stats.nr_unknown_wakes != 0xffff)
+			sleepmgr_stats.nr_unknown_wakes++;
+	}
+
+	residency = sleepmgr_stats.woke_at - start;
+	if (entry->nr_sleeps != 0xffff)
+		entry->nr_sleeps++;
+	entry->max_residency = max_u(entry->max_residency, residency);
+	entry->residency += residency;
+
+	cpu_irq_enable();
+}
+
+/**
+ * \brief Print the statistics on the debug console
+ *
+ * Sleep modes are printed as their value in enum sleepmgr_mode, and
+ * all times are in timer ticks. The \a locks column shows the current
+ * lock count of each mode.
+ */
+void sleepmgr_stats_show(void)
+{
+	struct sleepmgr_stats   stats;
+	irqflags_t              iflags;
+	uint8_t                 i;
+
+	iflags = cpu_irq_save();
+	stats = sleepmgr_stats;
+	cpu_irq_restore(iflags);
+
+	dbg_info("sleepmgr: %lu ticks per second\n",
+			(unsigned long)stats.resolution);
+	dbg_info("   mode  locks  sleeps   residency       max\n");
+	for (i = 0; i < SLEEPMGR_NR_MODES; i++) {
+		struct sleepmgr_mode_stats      *entry = &stats.modes[i];
+
+		dbg_info("%7u %6u %7u %11lu %9u\n", i, sleepmgr_locks[i],
+				entry->nr_sleeps,
+				(unsigned long)entry->residency,
+				entry->max_residency);
+	}
+	dbg_info(" active                %11lu\n",
+			(unsigned long)stats.active);
+
+	dbg_info("  wakes  irq\n");
+	for (i = 0; i < ARRAY_LEN(stats.sources); i++) {
+		if (!stats.sources[i].nr_wakes)
+			break;
+		dbg_info("%7u  %u\n", stats.sources[i].nr_wakes,
+				stats.sources[i].id);
+	}
+	if (stats.nr_untracked_wakes)
+		dbg_info("%u wake-ups by other interrupts\n",
+				stats.nr_untracked_wakes);
+	if (stats.nr_unknown_wakes)
+		dbg_info("%u wake-ups without an interrupt\n",
+				stats.nr_unknown_wakes);
+}
+
+#endif /* CONFIG_SLEEPMGR_STATS */
+
+/**
+ * \brief Put the CPU to sleep in the deepest allowed mode
+ *
+ * This is called by the main loop when there is nothing to do. If
+ * #SLEEPMGR_ACTIVE is locked, it returns without sleeping.
+ *
+ * \pre Interrupts are disabled
+ * \post Interrupts are enabled
+ */
+void sleepmgr_enter_sleep(void)
+{
+	enum sleepmgr_mode      mode;
+
+	assert(!cpu_irq_is_enabled());
+
+	mode = sleepmgr_get_sleep_mode();
+	if (mode == SLEEPMGR_ACTIVE) {
+		cpu_irq_enable();
+		return;
+	}
+
+#ifdef CONFIG_SLEEPMGR_STATS
+	sleepmgr_stats_sleep(mode);
+#else
+	cpu_sleepmgr_enter(mode);
+#endif
+}
+
+//! @}
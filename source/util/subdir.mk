@@ -19,26 +19,34 @@ hdr-y				+= include/compiler/gcc.h
 hdr-y				+= include/compiler/iar.h
 hdr-y				+= include/compiler/sparse.h
 hdr-y				+= include/compiler.h
+hdr-$(CONFIG_CRC32)		+= include/crc32.h
 hdr-y				+= include/debug.h
 hdr-y				+= include/delay.h
+hdr-$(CONFIG_DELAYED_TASK)	+= include/delayed_task.h
 hdr-y				+= include/dma.h
 hdr-$(CONFIG_DMAPOOL)		+= include/dmapool.h
 hdr-y				+= include/intc.h
 hdr-y				+= include/interrupt.h
 hdr-y				+= include/io.h
+hdr-$(CONFIG_LATENCY)		+= include/latency.h
 hdr-y				+= include/led.h
 hdr-y				+= include/linker.h
 hdr-$(CONFIG_MAINLOOP)		+= include/mainloop.h
 hdr-$(CONFIG_MALLOC_SIMPLE)	+= include/malloc.h
 hdr-$(CONFIG_MALLOC_SIMPLE)	+= include/malloc/simple.h
+hdr-$(CONFIG_MALLOC_HOST)	+= include/malloc.h
+hdr-$(CONFIG_MALLOC_HOST)	+= include/malloc/host.h
 hdr-$(CONFIG_MEMBAG)		+= include/membag.h
 hdr-$(CONFIG_MEMPOOL)		+= include/mempool.h
 hdr-$(CONFIG_PHYSMEM)		+= include/physmem.h
 hdr-$(CONFIG_HUGEMEM)           += include/hugemem.h
+hdr-$(CONFIG_HUGEMEM_ASYNC)	+= include/hugemem_async.h
+hdr-$(CONFIG_PROFILE)		+= include/profile.h
 hdr-y                           += include/progmem.h
 hdr-y				+= include/ring.h
 hdr-$(CONFIG_SETJMP)		+= include/setjmp.h
 hdr-y				+= include/sleep.h
+hdr-$(CONFIG_SLEEPMGR)		+= include/sleepmgr.h
 hdr-y				+= include/slist.h
 hdr-$(CONFIG_SOFTIRQ)		+= include/softirq.h
 hdr-y				+= include/status_codes.h
@@ -50,12 +58,20 @@ hdr-y				+= include/util.h
 hdr-$(CONFIG_MAINLOOP)		+= include/workqueue.h
 
 src-$(CONFIG_BUFFER)		+= util/buffer.c
+src-$(CONFIG_CRC32)		+= util/crc32.c
+src-$(CONFIG_DELAYED_TASK)	+= util/delayed_task.c
 src-$(CONFIG_DMAPOOL)		+= util/dmapool.c
 src-$(CONFIG_HUGEMEM)           += util/hugemem.c
+ifneq ($(CONFIG_HUGEMEM_DMA),y)
+src-$(CONFIG_HUGEMEM_ASYNC)	+= util/hugemem_async.c
+endif
+src-$(CONFIG_LATENCY)		+= util/latency.c
 src-$(CONFIG_MALLOC_SIMPLE)	+= util/malloc_simple.c
 src-$(CONFIG_MEMBAG)		+= util/membag.c
 src-$(CONFIG_MEMPOOL)		+= util/mempool.c
 src-$(CONFIG_PHYSMEM)		+= util/physmem.c
+src-$(CONFIG_PROFILE)		+= util/profile.c
+src-$(CONFIG_SLEEPMGR)		+= util/sleepmgr.c
 src-$(CONFIG_SOFTIRQ)		+= util/softirq_common.c
 src-$(CONFIG_MAINLOOP)		+= util/workqueue.c
 
@@ -39,6 +39,10 @@
 #include <types.h>
 #include <workqueue.h>
 
+#ifdef CONFIG_LATENCY
+#include <latency.h>
+#endif
+
 /**
  * \weakgroup workqueue_group
  * @{
@@ -87,6 +91,9 @@ bool workqueue_add_task(struct workqueue *queue, struct workqueue_task *task)
 	iflags = cpu_irq_save();
 	if (!workqueue_task_is_queued(task)) {
 		slist_insert_tail(&queue->task_list, &task->node);
+#ifdef CONFIG_LATENCY
+		task->queued_at = latency_priv_get_time();
+#endif
 		was_queued = true;
 	}
 	cpu_irq_restore(iflags);
@@ -0,0 +1,243 @@
+#!
+# \file
+#
+# \brief Convert an image to an indexed color bitmap
+#
+# Copyright (C) 2011 Atmel Corporation. All rights reserved.
+#
+# \page License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# 3. The name of Atmel may not be used to endorse or promote products derived
+# from this software without specific prior written permission.
+#
+# 4. This software may only be redistributed and used in connection with an
+# Atmel AVR product.
+#
+# THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+# WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+# EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+# OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+# DAMAGE.
+import os, sys
+from optparse import OptionParser
+from PIL import Image
+
+BPP_CHOICES = [1, 2, 4, 8]
+
+def conv(color):
+	"""Convert an (r, g, b) tuple to RGB565, high byte first."""
+	red   = color[0] >> 3
+	green = color[1] >> 2
+	blue  = color[2] >> 3
+
+	color = red << 11 | green << 5 | blue
+	return (color >> 8, color & 0xff)
+
+def key(color):
+	"""Reduce an (r, g, b) tuple to the colors the display can show."""
+	return (color[0] & 0xf8, color[1] & 0xfc, color[2] & 0xf8)
+
+def parse_color(text):
+	fields = [int(field, 0) for field in text.split(",")]
+	if len(fields) != 3:
+		raise ValueError(text)
+	return key(fields)
+
+def image_data(image):
+	"""Return the pixels of an image, line by line."""
+	(width, height) = image.size
+	access = image.load()
+
+	return [access[x, y] for y in range(height) for x in range(width)]
+
+def choose_bpp(nr_colors):
+	for bpp in BPP_CHOICES:
+		if nr_colors <= (1 << bpp):
+			return bpp
+	return BPP_CHOICES[-1]
+
+def quantize(pixels, mask, size, nr_colors):
+	"""Reduce the opaque pixels to nr_colors colors by median cut.
+
+	Returns the palette and the palette index of each pixel. Transparent
+	pixels get index 0, which is not used.
+	"""
+	opaque = [pixel for (pixel, visible) in zip(pixels, mask) if visible]
+	fill = opaque[0]
+
+	image = Image.new("RGB", size)
+	image.putdata([pixel if visible else fill
+			for (pixel, visible) in zip(pixels, mask)])
+	image = image.quantize(colors=nr_colors, method=Image.MEDIANCUT)
+
+	flat = image.getpalette()
+	palette = [key(flat[i * 3:i * 3 + 3]) for i in range(nr_colors)]
+	indexes = image_data(image)
+
+	return (palette, indexes)
+
+def pack(indexes, width, height, bpp):
+	"""Pack the indexes of each line, leftmost pixel in the MSBs."""
+	data = bytearray()
+
+	for y in range(height):
+		byte = 0
+		shift = 8
+		for index in indexes[y * width:(y + 1) * width]:
+			shift -= bpp
+			byte |= index << shift
+			if shift == 0:
+				data.append(byte)
+				byte = 0
+				shift = 8
+		if shift != 8:
+			data.append(byte)
+
+	return data
+
+def convert(image, bpp=0, transparent_color=None):
+	"""Convert an image to an indexed color bitmap.
+
+	Returns the palette of 2^bpp colors in the 16bpp raw format followed
+	by the packed pixels, the bits per pixel, the number of colors used
+	and whether index 0 is transparent. A bpp of 0 picks the lowest
+	which holds all colors of the image. Raises ValueError if the image
+	cannot be converted.
+	"""
+	image = image.convert("RGBA")
+	(width, height) = image.size
+	pixels = []
+	mask = []
+	for pixel in image_data(image):
+		color = key(pixel[:3])
+		pixels.append(color)
+		mask.append(pixel[3] >= 128 and color != transparent_color)
+
+	has_transparency = not all(mask)
+	if not any(mask):
+		raise ValueError("all pixels are transparent")
+
+	# Index 0 is reserved for transparent pixels, if there are any.
+	reserved = 1 if has_transparency else 0
+	colors = sorted(set(pixel for (pixel, visible)
+			in zip(pixels, mask) if visible))
+
+	bpp = bpp or choose_bpp(len(colors) + reserved)
+	nr_colors = (1 << bpp) - reserved
+	if nr_colors < 1:
+		raise ValueError("1 bpp leaves no colors besides transparency")
+
+	if len(colors) > nr_colors:
+		(palette, indexes) = quantize(pixels, mask, image.size,
+				nr_colors)
+	else:
+		palette = colors
+		lookup = dict((color, index) for (index, color)
+				in enumerate(colors))
+		indexes = [lookup.get(pixel, 0) for pixel in pixels]
+
+	# Shift the opaque indexes above the transparent index.
+	nr_used = len(palette)
+	palette = [(0, 0, 0)] * reserved + palette
+	indexes = [index + reserved if visible else 0
+			for (index, visible) in zip(indexes, mask)]
+	palette += [(0, 0, 0)] * ((1 << bpp) - len(palette))
+
+	data = bytearray()
+	for color in palette:
+		data.extend(conv(color))
+	data.extend(pack(indexes, width, height, bpp))
+
+	return (data, bpp, nr_used, has_transparency)
+
+def main():
+	parser = OptionParser(usage="%prog [options] image-file [output file]",
+			description="bitmap2indexed.py converts an image to an "
+			"indexed color bitmap for the indexed bitmap types of "
+			"the graphics driver. The output file holds a palette of "
+			"2^bpp colors in the 16bpp raw format, followed by the "
+			"pixels, packed with each line starting on a byte "
+			"boundary. If the image has more colors than fit, the "
+			"palette is chosen by median cut quantization.")
+	parser.add_option("-b", "--bpp", dest="bpp", type="int", default=0,
+			help="bits per pixel, one of 1, 2, 4 or 8. Default is "
+			"the lowest which holds all colors of the image.",
+			metavar="BPP")
+	parser.add_option("-t", "--transparent", dest="transparent",
+			default=None, help="make pixels of the color R,G,B "
+			"transparent. Pixels with less than 50%% alpha are "
+			"always transparent. Transparent pixels use index 0.",
+			metavar="R,G,B")
+
+	(options, args) = parser.parse_args()
+
+	if len(args) < 1 or len(args) > 2:
+		parser.print_usage()
+		sys.exit(2)
+
+	if options.bpp and options.bpp not in BPP_CHOICES:
+		print("Error: %i bits per pixel is not supported." %
+				options.bpp)
+		sys.exit(2)
+
+	transparent_color = None
+	if options.transparent:
+		try:
+			transparent_color = parse_color(options.transparent)
+		except ValueError:
+			print("Error: invalid color '%s'." % options.transparent)
+			sys.exit(2)
+
+	input_file = args[0]
+	if len(args) > 1:
+		outname = args[1]
+	else:
+		# remove file extension
+		outname = os.path.splitext(input_file)[0]
+
+	try:
+		image = Image.open(input_file)
+	except IOError:
+		print("Error: could not read '%s'." % input_file)
+		sys.exit(2)
+
+	try:
+		(data, bpp, nr_used, has_transparency) = convert(image,
+				options.bpp, transparent_color)
+	except ValueError as error:
+		print("Error: %s." % error)
+		sys.exit(2)
+
+	try:
+		output_file = open(outname, "wb")
+		output_file.write(data)
+		output_file.close()
+	except IOError:
+		print("Error: could not write '%s'." % outname)
+		sys.exit(2)
+
+	(width, height) = image.size
+	print("%s: %ix%i, %i bpp, %i colors%s." % (outname, width, height,
+			bpp, nr_used,
+			", transparent index 0" if has_transparency else ""))
+	print("%i bytes, %i in the 16bpp raw format." % (len(data),
+			width * height * 2))
+
+if __name__ == "__main__":
+	main()
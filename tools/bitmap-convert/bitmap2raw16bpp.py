@@ -1,6 +1,9 @@
 import os, sys
 from PIL import Image
 
+# Must match FILE_THUMB_SCALE in apps/display-demo/file_loader.h
+THUMB_SCALE = 8
+
 def conv(pixel):
 	red   = pixel[0] >> 3;
 	green = pixel[1] >> 2;
@@ -9,35 +12,74 @@ def conv(pixel):
 	color = red << 11 | green << 5 | blue
 	return (color >> 8, color & 0xff)
 
-program = os.path.basename(sys.argv[0])
+def thumbnail(image_data, width, height):
+	# Average each THUMB_SCALE x THUMB_SCALE block of pixels
+	pixels = list(image_data)
+	thumb = []
+	area = THUMB_SCALE * THUMB_SCALE
+
+	for ty in range(height // THUMB_SCALE):
+		for tx in range(width // THUMB_SCALE):
+			total = [0, 0, 0]
+			for y in range(ty * THUMB_SCALE, (ty + 1) * THUMB_SCALE):
+				for x in range(tx * THUMB_SCALE, (tx + 1) * THUMB_SCALE):
+					pixel = pixels[y * width + x]
+					for i in range(3):
+						total[i] += pixel[i]
+			thumb.append([(value + area // 2) // area for value in total])
+
+	return thumb
+
+def convert(image_file, add_thumbnail=False):
+	# Return the 16bpp raw data of an image, optionally with thumbnail
+	image_file = image_file.convert("RGB")
+	(width, height) = image_file.size
+	access = image_file.load()
+	image_data = [access[x, y] for y in range(height)
+			for x in range(width)]
+	output = bytearray()
+
+	for pixel in image_data:
+		output.extend(conv(pixel))
+
+	if add_thumbnail:
+		for pixel in thumbnail(image_data, width, height):
+			output.extend(conv(pixel))
+
+	return output
+
+def main():
+	program = os.path.basename(sys.argv[0])
 
-if len(sys.argv) <= 1:
-	print "usage: %s [image file]" % program
-	sys.exit(0)
+	add_thumbnail = "-t" in sys.argv[1:]
+	args = [arg for arg in sys.argv[1:] if arg != "-t"]
 
-input_file = sys.argv[1]
+	if len(args) < 1:
+		print("usage: %s [-t] [image file]" % program)
+		print("  -t  append a thumbnail, 1/%i of the size, for previews"
+				% THUMB_SCALE)
+		sys.exit(0)
 
-try:
-	fsocks = open(input_file)
-except IOError:
-	print "The file '%s' does not exist, exiting." % input_file
-	sys.exit(2)
+	input_file = args[0]
 
-fsocks.close()
-print "Converting '%s' to 16bpp raw image data" % input_file
+	try:
+		fsocks = open(input_file)
+	except IOError:
+		print("The file '%s' does not exist, exiting." % input_file)
+		sys.exit(2)
 
-image_file = Image.open(input_file)
-image_data = image_file.getdata()
+	fsocks.close()
+	print("Converting '%s' to 16bpp raw image data" % input_file)
 
-# remove file extension
-outname = input_file.split('.')[0]
-output_file = open(outname, "wb")
+	output = convert(Image.open(input_file), add_thumbnail)
 
-for pixel in image_data:
-	color = conv(pixel);
-	output_file.write(chr(color[0]))
-	output_file.write(chr(color[1]))
+	# remove file extension
+	outname = input_file.split('.')[0]
+	output_file = open(outname, "wb")
+	output_file.write(output)
+	output_file.close()
 
-output_file.close()
+	print("Done (-: Output file is '%s'." % (outname))
 
-print "Done (-: Output file is '%s'." % (outname)
+if __name__ == "__main__":
+	main()
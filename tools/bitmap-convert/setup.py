@@ -5,6 +5,7 @@ sys.argv.append('py2exe')
 
 setup(
     options = {'py2exe': {'bundle_files': 1}},
-    console = [{'script': "bitmap2raw16bpp.py"}],
+    console = [{'script': "bitmap2raw16bpp.py"},
+               {'script': "bitmap2indexed.py"}],
     zipfile = None,
 )
\ No newline at end of file
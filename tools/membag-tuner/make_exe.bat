@@ -0,0 +1,3 @@
+python setup.py py2exe
+rd /s /q build
+pause
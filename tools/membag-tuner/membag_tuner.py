@@ -0,0 +1,335 @@
+#!
+# \file
+#
+# \brief Suggest a membag configuration from a recorded allocation trace
+#
+# Copyright (C) 2011 Atmel Corporation. All rights reserved.
+#
+# \page License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# 3. The name of Atmel may not be used to endorse or promote products derived
+# from this software without specific prior written permission.
+#
+# 4. This software may only be redistributed and used in connection with an
+# Atmel AVR product.
+#
+# THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+# WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+# EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+# OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+# DAMAGE.
+import sys
+from optparse import OptionParser
+
+class trace:
+	"""Allocator events parsed from the output of membag_trace_dump()."""
+
+	def __init__(self):
+		# Configured bags as (block size, number of blocks)
+		self.layout = []
+		# Requests as [size, first event, last event], where the last
+		# event is None for blocks which are never freed
+		self.requests = []
+		self.nr_events = 0
+		self.nr_dropped = 0
+		self.nr_unknown_frees = 0
+
+	def parse(self, lines, ignore_failed):
+		live = {}
+
+		for line in lines:
+			# Skip anything else printed on the debug console
+			fields = line.split()
+			if "MBT" not in fields:
+				continue
+			fields = fields[fields.index("MBT") + 1:]
+
+			if fields[0] == "L":
+				self.layout.append((int(fields[1]), int(fields[2])))
+			elif fields[0] == "A":
+				size = int(fields[2])
+				ptr = parse_pointer(fields[3])
+
+				if ptr == 0:
+					if ignore_failed:
+						continue
+					# Assume a failed request would have
+					# held its block until the end.
+					self.requests.append([size,
+						self.nr_events, None])
+				else:
+					request = [size, self.nr_events, None]
+					self.requests.append(request)
+					live[ptr] = request
+				self.nr_events += 1
+			elif fields[0] == "F":
+				ptr = parse_pointer(fields[2])
+
+				if ptr in live:
+					live.pop(ptr)[2] = self.nr_events
+					self.nr_events += 1
+				else:
+					# Allocated before the trace was started
+					self.nr_unknown_frees += 1
+			elif fields[0] == "D":
+				self.nr_dropped = int(fields[1])
+
+	def events(self):
+		"""Return a list of (event, request index, is_alloc) in order."""
+		events = []
+
+		for i, request in enumerate(self.requests):
+			events.append((request[1], i, True))
+			if request[2] is not None:
+				events.append((request[2], i, False))
+
+		events.sort()
+		return events
+
+def parse_pointer(text):
+	if text == "(nil)":
+		return 0
+	return int(text, 16)
+
+def simulate(layout, requests, events):
+	"""
+	Replay the requests against a layout with the same policy as
+	membag_alloc(): use the smallest bag which is large enough and has a
+	free block. Return (failures, peak wasted bytes).
+	"""
+	free = [count for (size, count) in layout]
+	owner = {}
+	failures = 0
+	waste = 0
+	peak_waste = 0
+
+	for (event, i, is_alloc) in events:
+		size = requests[i][0]
+
+		if is_alloc:
+			for bag in range(len(layout)):
+				if layout[bag][0] >= size and free[bag] > 0:
+					free[bag] -= 1
+					owner[i] = bag
+					waste += layout[bag][0] - size
+					break
+			else:
+				failures += 1
+			peak_waste = max(peak_waste, waste)
+		elif i in owner:
+			bag = owner.pop(i)
+			free[bag] += 1
+			waste -= layout[bag][0] - size
+
+	return (failures, peak_waste)
+
+def total_size(layout):
+	return sum([size * count for (size, count) in layout])
+
+def peak_usage(requests, events, low, high):
+	"""Return peak number of live requests with low < size <= high."""
+	live = 0
+	peak = 0
+
+	for (event, i, is_alloc) in events:
+		if low < requests[i][0] <= high:
+			if is_alloc:
+				live += 1
+				peak = max(peak, live)
+			else:
+				live -= 1
+
+	return peak
+
+def round_size(size, align, min_size):
+	size = max(size, min_size)
+	return (size + align - 1) // align * align
+
+def optimize(requests, events, max_bags, align, min_size):
+	"""
+	Find the bag sizes which need the least memory to serve all requests
+	without failures, with each bag holding the peak number of live
+	requests of the sizes it serves. The cost of a bag only depends on the
+	sizes between it and the next smaller bag, so this is solved by
+	dynamic programming over the sorted request sizes.
+	"""
+	sizes = sorted(set([round_size(request[0], align, min_size)
+		for request in requests]))
+	if not sizes:
+		return []
+
+	n = len(sizes)
+	lows = [0] + sizes
+
+	# cost[i][j]: bag of size sizes[j] serving sizes above lows[i]
+	cost = [[None] * n for i in range(n)]
+	count = [[0] * n for i in range(n)]
+	for i in range(n):
+		for j in range(i, n):
+			count[i][j] = peak_usage(requests, events, lows[i],
+					sizes[j])
+			cost[i][j] = sizes[j] * count[i][j]
+
+	# best[k][j]: least cost serving all sizes up to sizes[j] with k + 1
+	# bags, the largest being sizes[j]
+	infinity = float("inf")
+	best = [[infinity] * n for k in range(max_bags)]
+	choice = [[None] * n for k in range(max_bags)]
+	for j in range(n):
+		best[0][j] = cost[0][j]
+	for k in range(1, max_bags):
+		for j in range(n):
+			for i in range(j):
+				total = best[k - 1][i] + cost[i + 1][j]
+				if total < best[k][j]:
+					best[k][j] = total
+					choice[k][j] = i
+
+	k = min(range(max_bags), key=lambda k: best[k][n - 1])
+
+	layout = []
+	j = n - 1
+	while k >= 0:
+		i = choice[k][j] if k > 0 else -1
+		if count[i + 1][j] > 0:
+			layout.insert(0, (sizes[j], count[i + 1][j]))
+		j = i
+		k -= 1
+
+	return layout
+
+def fit_budget(layout, requests, events, budget):
+	"""
+	Remove blocks until the layout fits in the budget, each time from the
+	bag where it causes the fewest extra failures per byte saved.
+	"""
+	layout = list(layout)
+
+	while total_size(layout) > budget and layout:
+		failures = simulate(layout, requests, events)[0]
+		best = None
+
+		for bag in range(len(layout)):
+			size, count = layout[bag]
+			candidate = list(layout)
+			if count > 1:
+				candidate[bag] = (size, count - 1)
+			else:
+				del candidate[bag]
+
+			extra = simulate(candidate, requests, events)[0] - failures
+			score = (float(extra) / size, -size)
+			if best is None or score < best[0]:
+				best = (score, candidate)
+
+		layout = best[1]
+
+	return layout
+
+def print_layout(title, layout, requests, events):
+	failures, waste = simulate(layout, requests, events)
+
+	print("%s:" % title)
+	for (size, count) in layout:
+		print("  %5i x %3i = %6i bytes" % (size, count, size * count))
+	print("  total %i bytes, %i failed allocations, "
+		"%i bytes peak internal waste" %
+		(total_size(layout), failures, waste))
+	print("")
+
+def main():
+	parser = OptionParser(usage="%prog [options] [log file]",
+			description="membag_tuner.py reads the output of "
+			"membag_trace_dump() from a debug console log, replays "
+			"the recorded allocations against candidate bag layouts "
+			"and prints the APP_MEMBAG_INITIALIZER which needs the "
+			"least memory. The log is read from standard input if "
+			"no file is given.")
+	parser.add_option("-b", "--budget", dest="budget", type="int",
+			help="fit the layout in BYTES, accepting failed "
+			"allocations if needed", metavar="BYTES")
+	parser.add_option("-n", "--max-bags", dest="max_bags", type="int",
+			default=8, help="use at most N bags. Default is 8.",
+			metavar="N")
+	parser.add_option("-a", "--align", dest="align", type="int",
+			default=1, help="round block sizes up to a multiple of "
+			"BYTES. Default is 1.", metavar="BYTES")
+	parser.add_option("-m", "--min-size", dest="min_size", type="int",
+			default=2, help="smallest block size, which must hold "
+			"a pointer. Default is 2.", metavar="BYTES")
+	parser.add_option("-p", "--pool", dest="pool",
+			default="cpu_sram_pool", help="physmem pool to "
+			"allocate bags from. Default is cpu_sram_pool.")
+	parser.add_option("-i", "--ignore-failed", dest="ignore_failed",
+			default=False, action="store_true", help="ignore "
+			"allocations which failed during the trace, instead of "
+			"assuming they would be held until the end.")
+
+	(options, args) = parser.parse_args()
+
+	if len(args) > 1 or options.max_bags < 1 or options.max_bags > 16:
+		parser.print_usage()
+		sys.exit(2)
+
+	try:
+		if args:
+			log_file = open(args[0], "r")
+		else:
+			log_file = sys.stdin
+		lines = log_file.readlines()
+	except IOError:
+		print("Error: could not read '%s'." % args[0])
+		sys.exit(2)
+
+	t = trace()
+	t.parse(lines, options.ignore_failed)
+
+	if not t.requests:
+		print("No allocations found in trace, exiting.")
+		sys.exit(2)
+
+	print("Read %i allocations." % len(t.requests))
+	if t.nr_dropped:
+		print("Warning: %i events were dropped, increase "
+			"CONFIG_MEMBAG_TRACE_ENTRIES." % t.nr_dropped)
+	if t.nr_unknown_frees:
+		print("Note: %i blocks allocated before the trace was "
+			"started were freed." % t.nr_unknown_frees)
+	print("")
+
+	events = t.events()
+
+	if t.layout:
+		print_layout("Current layout", t.layout, t.requests, events)
+
+	layout = optimize(t.requests, events, options.max_bags,
+			options.align, options.min_size)
+
+	if options.budget is not None:
+		layout = fit_budget(layout, t.requests, events, options.budget)
+
+	print_layout("Suggested layout", layout, t.requests, events)
+
+	print("#define APP_MEMBAG_INITIALIZER                          \\")
+	for (size, count) in layout:
+		entry = "MEMBAG(%i, %i, &%s)," % (size, count, options.pool)
+		print("\t%-48s\\" % entry)
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,10 @@
+from distutils.core import setup
+import py2exe, sys, os
+
+sys.argv.append('py2exe')
+
+setup(
+    options = {'py2exe': {'bundle_files': 1}},
+    console = [{'script': "membag_tuner.py"}],
+    zipfile = None,
+)
\ No newline at end of file
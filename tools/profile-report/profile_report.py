@@ -0,0 +1,197 @@
+#!
+# \file
+#
+# \brief Build a flat profile from recorded profiler samples
+#
+# Copyright (C) 2011 Atmel Corporation. All rights reserved.
+#
+# \page License
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# 3. The name of Atmel may not be used to endorse or promote products derived
+# from this software without specific prior written permission.
+#
+# 4. This software may only be redistributed and used in connection with an
+# Atmel AVR product.
+#
+# THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR IMPLIED
+# WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+# MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+# EXPRESSLY AND SPECIFICALLY DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+# OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+# DAMAGE.
+import sys
+import subprocess
+from optparse import OptionParser
+
+# Context flags in bits 31:24 of each sample, see include/profile.h
+CTX_SHIFT = 24
+PC_MASK = (1 << CTX_SHIFT) - 1
+CTX_NAMES = [(1 << 0, "irq-low"), (1 << 1, "irq-medium")]
+
+class samples:
+	"""Samples parsed from the output of profile_dump()."""
+
+	def __init__(self):
+		self.rate = 0
+		self.nr_dropped = 0
+		self.values = []
+
+	def parse(self, lines):
+		expected = 0
+
+		for line in lines:
+			# Skip anything else printed on the debug console
+			fields = line.split()
+			if "PRF" not in fields:
+				continue
+			fields = fields[fields.index("PRF") + 1:]
+
+			if fields[0] == "H":
+				self.rate = int(fields[1])
+				expected = int(fields[2])
+				self.nr_dropped = int(fields[3])
+				self.values = []
+			elif fields[0] == "S":
+				for field in fields[1:]:
+					self.values.append(int(field, 16))
+			elif fields[0] == "E":
+				# The last line is padded with zero samples
+				del self.values[expected:]
+
+class symbols:
+	"""Function symbols of an ELF file, read with nm."""
+
+	def __init__(self, nm, elf):
+		self.addresses = []
+		self.names = []
+
+		output = subprocess.Popen([nm, "-n", "--defined-only", elf],
+				stdout=subprocess.PIPE).communicate()[0]
+		for line in output.decode().splitlines():
+			fields = line.split()
+			if len(fields) != 3 or fields[1] not in "tTwW":
+				continue
+			self.addresses.append(int(fields[0], 16))
+			self.names.append(fields[2])
+
+	def lookup(self, address):
+		"""Return the function containing address."""
+		low = 0
+		high = len(self.addresses)
+
+		while low < high:
+			middle = (low + high) // 2
+			if self.addresses[middle] <= address:
+				low = middle + 1
+			else:
+				high = middle
+
+		if low == 0:
+			return "0x%06x" % address
+		return self.names[low - 1]
+
+def context_frames(sample):
+	"""Return the pseudo-frames for the interrupt levels of a sample."""
+	ctx = sample >> CTX_SHIFT
+	frames = ["main"]
+
+	for (flag, name) in CTX_NAMES:
+		if ctx & flag:
+			frames.append(name)
+
+	return frames
+
+def main():
+	parser = OptionParser(usage="%prog [options] elf-file [log file]",
+			description="profile_report.py reads the output of "
+			"profile_dump() from a debug console log, looks up the "
+			"function of each sample in the ELF file of the "
+			"application and prints a flat profile. The log is read "
+			"from standard input if no file is given.")
+	parser.add_option("-n", "--nm", dest="nm", default="avr-nm",
+			help="nm program used to read the symbols. Default "
+			"is avr-nm.", metavar="PROGRAM")
+	parser.add_option("-f", "--folded", dest="folded", default=False,
+			action="store_true", help="print folded stacks, one "
+			"line per function and interrupt level, instead of "
+			"the flat profile. Only the interrupted function is "
+			"known, so the stacks hold the interrupt levels which "
+			"were active followed by the function.")
+	parser.add_option("-l", "--limit", dest="limit", type="int",
+			default=0, help="print only the N most sampled "
+			"functions.", metavar="N")
+
+	(options, args) = parser.parse_args()
+
+	if len(args) < 1 or len(args) > 2:
+		parser.print_usage()
+		sys.exit(2)
+
+	try:
+		if len(args) > 1:
+			log_file = open(args[1], "r")
+		else:
+			log_file = sys.stdin
+		lines = log_file.readlines()
+	except IOError:
+		print("Error: could not read '%s'." % args[1])
+		sys.exit(2)
+
+	try:
+		syms = symbols(options.nm, args[0])
+	except OSError:
+		print("Error: could not run '%s'." % options.nm)
+		sys.exit(2)
+
+	s = samples()
+	s.parse(lines)
+
+	if not s.values:
+		print("No samples found in log, exiting.")
+		sys.exit(2)
+
+	counts = {}
+	for sample in s.values:
+		name = syms.lookup(sample & PC_MASK)
+		if options.folded:
+			name = ";".join(context_frames(sample) + [name])
+		counts[name] = counts.get(name, 0) + 1
+
+	order = sorted(counts.keys(), key=lambda name: (-counts[name], name))
+	if options.limit > 0:
+		order = order[:options.limit]
+
+	if options.folded:
+		for name in order:
+			print("%s %i" % (name, counts[name]))
+		return
+
+	total = len(s.values)
+	print("%i samples at %i Hz, %.3f seconds." %
+		(total, s.rate, float(total) / max(s.rate, 1)))
+	if s.nr_dropped:
+		print("Warning: %i samples were dropped, increase "
+			"CONFIG_PROFILE_NR_SAMPLES." % s.nr_dropped)
+	print("")
+	print("  samples      %  function")
+	for name in order:
+		print("  %7i %6.2f  %s" % (counts[name],
+			100.0 * counts[name] / total, name))
+
+if __name__ == "__main__":
+	main()
@@ -35,13 +35,56 @@
 # OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 # DAMAGE.
 import string
+import struct
 import sys
 import win32con
 import win32file
 import wmi
+import zlib
 from optparse import OptionParser
 from optparse import OptionGroup
 
+# Vendor-specific SCSI command implemented by the framework's USB Mass
+# Storage interface (UDI_MSC_CMD_CRC32), returning the CRC-32 of a range
+# of blocks.
+SCSI_CMD_CRC32			= 0xc0
+# Maximum number of blocks covered by one CRC32 command
+CRC32_MAX_BLOCKS		= 0xffff
+
+IOCTL_SCSI_PASS_THROUGH		= 0x4d004
+SCSI_IOCTL_DATA_IN		= 1
+SCSI_PASS_THROUGH_TIMEOUT	= 60
+
+# struct SCSI_PASS_THROUGH followed by the sense and data buffers. The
+# trailing "0P" pads the struct to pointer alignment like the compiler
+# does.
+SCSI_PASS_THROUGH_FORMAT	= "@HBBBBBBBIIPI16s0P"
+SCSI_SENSE_LEN			= 32
+
+def scsi_crc32(file_handle, lba, nr_blocks):
+	"""Return the CRC-32 of nr_blocks blocks starting at lba, as
+	calculated by the device, or None if the device failed the
+	command."""
+	cdb = struct.pack(">BBIBH", SCSI_CMD_CRC32, 0, lba, 0, nr_blocks)
+	header_len = struct.calcsize(SCSI_PASS_THROUGH_FORMAT)
+	sense_offset = header_len
+	data_offset = sense_offset + SCSI_SENSE_LEN
+
+	request = struct.pack(SCSI_PASS_THROUGH_FORMAT, header_len, 0, 0,
+			0, 0, 10, SCSI_SENSE_LEN, SCSI_IOCTL_DATA_IN, 4,
+			SCSI_PASS_THROUGH_TIMEOUT, data_offset, sense_offset,
+			cdb.ljust(16, chr(0)))
+	request = request.ljust(data_offset + 4, chr(0))
+
+	response = win32file.DeviceIoControl(file_handle,
+			IOCTL_SCSI_PASS_THROUGH, request, len(request))
+
+	scsi_status = ord(response[2])
+	if scsi_status != 0:
+		return None
+
+	return struct.unpack(">I", response[data_offset:data_offset + 4])[0]
+
 def main():
 	def write_file_to_bdev(bdev, data):
 		sector_size = int(bdev.BytesPerSector or 0)
@@ -64,19 +107,66 @@ def main():
 
 		print "done"
 
-	def verify_data_on_bdev(bdev, data):
-		print "Verifying data on block device '%s'... " % \
-			(bdev.Caption),
-
+	def verify_data_by_readback(bdev, data):
 		file_handle     = open(bdev.DeviceID, 'rb')
 		bdev_data       = file_handle.read(len(data))
 
 		file_handle.close()
 
+		return data == bdev_data
+
+	def verify_data_by_crc32(bdev, data):
+		"""Compare the CRC-32 of each range of blocks with the CRC the
+		device calculates for it, without reading the data back.
+		Returns None if the device doesn't support the command."""
+		sector_size = int(bdev.BytesPerSector or 0)
+		chunk_size = sector_size * CRC32_MAX_BLOCKS
+
+		file_handle = win32file.CreateFile(bdev.DeviceID,
+				win32con.GENERIC_READ | win32con.GENERIC_WRITE,
+				win32con.FILE_SHARE_READ |
+				win32con.FILE_SHARE_WRITE, None,
+				win32file.OPEN_EXISTING,
+				win32file.FILE_ATTRIBUTE_NORMAL, None)
+
+		try:
+			for offset in range(0, len(data), chunk_size):
+				chunk = data[offset:offset + chunk_size]
+				# Pad the last chunk the same way it was written
+				if len(chunk) % sector_size != 0:
+					chunk = chunk.ljust(len(chunk) +
+						sector_size -
+						len(chunk) % sector_size,
+						chr(0))
+
+				crc = scsi_crc32(file_handle,
+						offset / sector_size,
+						len(chunk) / sector_size)
+				if crc is None:
+					return None
+				if crc != zlib.crc32(chunk) & 0xffffffff:
+					return False
+		except win32file.error:
+			return None
+		finally:
+			win32file.CloseHandle(file_handle)
+
+		return True
+
+	def verify_data_on_bdev(bdev, data):
+		print "Verifying data on block device '%s'... " % \
+			(bdev.Caption),
+
+		result = None
+		if not options.readback:
+			result = verify_data_by_crc32(bdev, data)
+		if result is None:
+			result = verify_data_by_readback(bdev, data)
+
 		print "done"
 		print ""
 
-		if data == bdev_data:
+		if result:
 			print "Write operation completed successfully."
 		else:
 			print "Warning: verification of data on block " \
@@ -103,6 +193,11 @@ def main():
 			"select the appropriate target and proceed with the "
 			"write.")
 	parser.add_option_group(group)
+	parser.add_option("-r", "--readback", dest="readback",
+			default=False, action="store_true", help="Verify "
+			"the written data by reading all of it back. By "
+			"default, only CRC-32 checksums are read from "
+			"devices which support it, which is much faster.")
 
 	(options, args) = parser.parse_args()
 
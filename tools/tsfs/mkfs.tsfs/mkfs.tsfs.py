@@ -36,7 +36,7 @@
 # DAMAGE.
 import sys
 from optparse import OptionParser
-from tsfscreator import volume_creator
+from tsfscreator import volume_creator, BLOCK_SIZE
 
 def main():
 	parser = OptionParser(usage="%prog [options] [files]",
@@ -44,25 +44,56 @@ def main():
 			"listed in FILES into a Tiny Simple File System "
 			"(TSFS)	image file with a TSFS structure. By default "
 			"mkfs.tsfs.py will write to 'out.raw', unless a file "
-			"is specified by the -o option.")
+			"is specified by the -o option. Files are stored in the "
+			"order given, after the files of the manifest given by "
+			"the -m option, so they should be listed in the order "
+			"the application reads them.")
 	parser.add_option("-o", "--output", dest="output",
 			help="write TSFS image to FILE. Default is raw.out.",
 			metavar="FILE", default="raw.out")
+	parser.add_option("-m", "--manifest", dest="manifest",
+			help="add the files listed in MANIFEST, converting "
+			"images from their source files.", metavar="MANIFEST")
+	parser.add_option("-p", "--page-size", dest="page_size", type="int",
+			help="start each file on a new page of SIZE bytes, "
+			"for storage with pages larger than the %i byte TSFS "
+			"block. Must be a power of two. Default is %i." %
+			(BLOCK_SIZE, BLOCK_SIZE), metavar="SIZE",
+			default=BLOCK_SIZE)
+	parser.add_option("-s", "--sort", dest="sort", action="store_true",
+			help="sort the file table by file name, allowing files "
+			"to be located by binary search.", default=False)
+	parser.add_option("-M", "--depend", dest="depend",
+			help="write make dependencies of the image to FILE.",
+			metavar="FILE")
+	parser.add_option("-q", "--quiet", dest="verbose",
+			action="store_false", default=True,
+			help="only print warnings and errors.")
 
 	(options, args) = parser.parse_args()
 
 	list_of_file_names = args
-	if len(list_of_file_names) == 0:
+	if len(list_of_file_names) == 0 and not options.manifest:
 		parser.print_usage()
 		sys.exit()
 
-	vc = volume_creator()
+	page_size = options.page_size
+	if page_size <= 0 or (page_size & (page_size - 1)) != 0:
+		print("Error: page size %i is not a power of two." % page_size)
+		sys.exit(2)
 
 	try:
+		vc = volume_creator(max(page_size, BLOCK_SIZE), options.sort)
+
+		if options.manifest:
+			vc.add_manifest(options.manifest)
 		vc.add_files(list_of_file_names)
-		vc.write_to_file(options.output)
-	except:
-		print "Unexpected error:", sys.exc_info()[0]
+		vc.write_to_file(options.output, options.verbose)
+
+		if options.depend:
+			vc.write_depend_file(options.depend, options.output)
+	except (IOError, ValueError, ImportError):
+		print("Error: %s" % sys.exc_info()[1])
 		parser.print_usage()
 		sys.exit(2)
 
@@ -36,7 +36,6 @@
 # DAMAGE.
 import os
 import sys
-import array
 import struct
 
 ZERO_BYTE                       = 0x00
@@ -45,6 +44,15 @@ BLOCK_SIZE                      = 512
 TSFS_IDENTITY                   = 0x17C1
 TSFS_HEADER_SIZE                = 16
 TSFS_FILE_TABLE_ENTRY_SIZE      = 16
+TSFS_FILENAME_LEN               = 8
+
+# Header flag for a file table sorted by name, see TSFS_FLAG_SORTED in
+# include/fs/tsfs.h
+TSFS_FLAG_SORTED                = 0x01
+
+# Asset types in a manifest, see volume_creator.add_manifest()
+MANIFEST_TYPES                  = ("raw", "image", "image-thumb",
+		"image-1bpp", "image-2bpp", "image-4bpp", "image-8bpp")
 
 #! \brief TSFS header structure
 #
@@ -53,102 +61,198 @@ TSFS_FILE_TABLE_ENTRY_SIZE      = 16
 class header_info:
 	identity        = TSFS_IDENTITY
 	version         = 1
+	flags           = 0
 	volume_size     = 0
 	number_of_files = 0
 
 class file_info(object):
-	def __init__(self, name_on_disk=None, name_on_volume=None, size=0):
+	def __init__(self, name_on_disk=None, name_on_volume=None, size=0,
+			data=None):
 		self.name_on_disk       = name_on_disk
 		self.name_on_volume     = name_on_volume
 		self.size               = size
+		self.data               = data
+		self.offset             = 0
+
+	def volume_name(self):
+		# File name as stored in the file table, padded with zeros
+		name = self.name_on_volume.encode("ascii")
+		return name.ljust(TSFS_FILENAME_LEN, b"\0")
+
+	def read(self):
+		if self.data is not None:
+			return self.data
+
+		handle = open(self.name_on_disk, 'rb')
+		raw_data = handle.read()
+		handle.close()
+		return raw_data
 
+def align_up(value, alignment):
+	if (value % alignment) != 0:
+		value += alignment - (value % alignment)
+	return value
+
+#! \brief TSFS volume image creator
+#
+# Files are laid out in the order they are added, which should be the order
+# the application is expected to read them in. Each file starts on a new
+# \a alignment boundary, which is the TSFS block size or, for storage with
+# larger pages, the page size. With \a sort_table the file table is sorted by
+# file name and flagged as such, so the file system can locate files by
+# binary search without changing the layout of the file data.
 class volume_creator(object):
-	files   = []
+	def __init__(self, alignment=BLOCK_SIZE, sort_table=False):
+		if alignment % BLOCK_SIZE != 0:
+			raise ValueError("alignment %i is not a multiple of the "
+					"block size %i" % (alignment, BLOCK_SIZE))
+
+		self.files      = []
+		self.sources    = []
+		self.alignment  = alignment
+		self.sort_table = sort_table
 
 	def create_header(self, volume_size, number_of_files):
 		header                  = header_info()
 		header.volume_size      = volume_size
 		header.number_of_files  = number_of_files
+		if self.sort_table:
+			header.flags    = TSFS_FLAG_SORTED
 
 		# TSFS header layout
 		#
 		# 2-byte identity
 		# 1-byte version
-		# 1-byte reserved for future use
+		# 1-byte flags
 		# 4-byte volume size
 		# 4-byte number of files
 		# 4-byte reserved for future use
 		return struct.pack('>HBBIII', header.identity, header.version,
-				ZERO_BYTE, header.volume_size,
+				header.flags, header.volume_size,
 				header.number_of_files, ZERO_BYTE)
 
+	def add_file(self, name_on_disk, name_on_volume=None):
+		# Strip directory path from file name
+		if name_on_volume is None:
+			name_on_volume = os.path.basename(name_on_disk)
+
+		if not os.path.isfile(name_on_disk):
+			raise IOError("File not found: %s" % name_on_disk)
+
+		self.check_name(name_on_volume)
+		self.sources.append(name_on_disk)
+		self.files.append(file_info(name_on_disk, name_on_volume,
+				os.path.getsize(name_on_disk)))
+
 	def add_files(self, filelist):
-		self.files.extend(filelist)
-
-	def prepare_file_list(self, list_of_file_names):
-		all_files = []
-		for file_name in list_of_file_names:
-			# Strip directory path from file name
-			short_name = os.path.basename(file_name)
-
-			if os.path.isfile(file_name):
-				file_size = os.path.getsize(file_name)
-				all_files.append(file_info(file_name,
-							short_name, file_size))
+		for file_name in filelist:
+			self.add_file(file_name)
+
+	def add_data(self, name_on_volume, data, name_on_disk=None):
+		self.check_name(name_on_volume)
+		if name_on_disk is not None:
+			self.sources.append(name_on_disk)
+		self.files.append(file_info(name_on_disk, name_on_volume,
+				len(data), bytes(data)))
+
+	def check_name(self, name_on_volume):
+		if len(name_on_volume) == 0 or \
+				len(name_on_volume) > TSFS_FILENAME_LEN:
+			raise ValueError("File name '%s' does not fit in %i "
+					"characters" % (name_on_volume,
+					TSFS_FILENAME_LEN))
+
+	#! \brief Add the files listed in a manifest
+	#
+	# Each line of a manifest holds a file name on the volume, an asset
+	# type and a source file name relative to the manifest. Empty lines
+	# and lines starting with '#' are ignored. Asset types are:
+	#
+	# raw:          the source file is copied as is
+	# image:        the source image is converted to 16bpp raw pixels
+	# image-thumb:  as image, followed by a thumbnail for previews
+	# image-<n>bpp: the source image is converted to an indexed color
+	#               bitmap with n bits per pixel, n being 1, 2, 4 or 8
+	#
+	# Images are converted by bitmap2raw16bpp.py or bitmap2indexed.py,
+	# which need the Python Imaging Library.
+	def add_manifest(self, manifest_name):
+		base_dir = os.path.dirname(manifest_name)
+		manifest = open(manifest_name, 'r')
+		self.sources.append(manifest_name)
+
+		for (line_number, line) in enumerate(manifest):
+			fields = line.split()
+			if len(fields) == 0 or fields[0].startswith("#"):
+				continue
+
+			if len(fields) != 3 or fields[1] not in MANIFEST_TYPES:
+				raise ValueError("%s:%i: expected name, one of "
+						"%s and source file" %
+						(manifest_name, line_number + 1,
+						", ".join(MANIFEST_TYPES)))
+
+			(name_on_volume, asset_type, source) = fields
+			source = os.path.join(base_dir, source)
+
+			if asset_type == "raw":
+				self.add_file(source, name_on_volume)
+			elif asset_type.endswith("bpp"):
+				self.add_data(name_on_volume,
+						convert_indexed_image(source,
+						int(asset_type[6:-3])), source)
 			else:
-				print "File not found:", file_name
-		return all_files
+				self.add_data(name_on_volume, convert_image(source,
+						asset_type == "image-thumb"),
+						source)
 
-	def write_to_file(self, target_file):
-		written_bytes   = 0
-		file_handle     = open(target_file, 'wb')
+		manifest.close()
 
-		print "Generating Tiny Simple File System image..."
-
-		written_bytes = self.write_to_volume(self.files, file_handle)
-		size_of_file  = file_handle.tell()
+	def layout(self):
+		# Find offset of first file data, right after the file table
+		offset = TSFS_HEADER_SIZE + (TSFS_FILE_TABLE_ENTRY_SIZE *
+				len(self.files))
+		offset = align_up(offset, self.alignment)
 
-		file_handle.close
+		for file in self.files:
+			file.offset = offset
+			offset = align_up(offset + file.size, self.alignment)
 
-		if written_bytes == size_of_file:
-			print "Completed: image file '%s' done, wrote" %    \
-					target_file, size_of_file, "bytes."
-		else:
-			print "Warning: mismatching volume size! Header "   \
-					"indicates size", written_bytes,    \
-					", file is", size_of_file
+		return offset
 
-	def write_to_volume(self, list_of_file_names, file_handle):
-		all_files = self.prepare_file_list(list_of_file_names)
+	def file_table(self):
+		if not self.sort_table:
+			return self.files
 
-		size_of_header           = TSFS_HEADER_SIZE
-		size_of_file_table_entry = TSFS_FILE_TABLE_ENTRY_SIZE
-		size_of_file_table       = (size_of_file_table_entry *
-				len(all_files))
-		volume_size              = size_of_header + size_of_file_table
+		# Sort by the bytes stored on the volume, which is the order
+		# strncmp() sees. The sort is stable, so the first of several
+		# files with the same name still comes first.
+		return sorted(self.files, key=lambda file: file.volume_name())
 
-		# Count bytes missing to move to next full block
-		if (volume_size % BLOCK_SIZE) != 0:
-			volume_size += BLOCK_SIZE - (volume_size % BLOCK_SIZE)
+	def write_to_file(self, target_file, verbose=True):
+		file_handle     = open(target_file, 'wb')
 
-		for file in all_files:
-			needed_blocks = int(file.size / BLOCK_SIZE) + 1
+		if verbose:
+			print("Generating Tiny Simple File System image...")
 
-			if (file.size % BLOCK_SIZE) == 0:
-				needed_blocks -= 1
-			volume_size += needed_blocks * BLOCK_SIZE
+		written_bytes = self.write_to_volume(file_handle)
+		size_of_file  = file_handle.tell()
 
-		header = self.create_header(volume_size, len(all_files))
+		file_handle.close()
 
-		file_handle.write(header)
+		if written_bytes != size_of_file:
+			print("Warning: mismatching volume size! Header "
+					"indicates size %i, file is %i" %
+					(written_bytes, size_of_file))
+		elif verbose:
+			print("Completed: image file '%s' done, wrote %i bytes."
+					% (target_file, size_of_file))
 
-		# Find offset of first file data
-		offset_in_file = size_of_header + size_of_file_table
+	def write_to_volume(self, file_handle):
+		volume_size = self.layout()
 
-		# Jump forward to next block
-		if (offset_in_file % BLOCK_SIZE) != 0:
-			offset_in_file += BLOCK_SIZE - (offset_in_file %
-					BLOCK_SIZE)
+		file_handle.write(self.create_header(volume_size,
+				len(self.files)))
 
 		# Write file table entries
 		#
@@ -157,47 +261,54 @@ class volume_creator(object):
 		# 4-byte address to offset in file system to file data
 		# 4-byte file size
 		# 8-byte file name
-		for file in all_files:
-			name_with_padding = file.name_on_volume.ljust(8, chr(0))
+		for file in self.file_table():
+			file_handle.write(struct.pack(">II", file.offset,
+					file.size))
+			file_handle.write(file.volume_name())
 
-			# Write 4 byte start adress
-			file_handle.write(struct.pack(">I", offset_in_file))
+		# Write raw file data, padded with zeros up to each file
+		for file in self.files:
+			file_handle.write(b"\0" * (file.offset -
+					file_handle.tell()))
+			file_handle.write(file.read())
 
-			# Write 4 byte file size
-			file_handle.write(struct.pack(">I", file.size))
+		file_handle.write(b"\0" * (volume_size - file_handle.tell()))
 
-			# Write 8 byte filename
-			file_handle.write(name_with_padding)
+		return volume_size
 
-			needed_blocks = int(file.size / BLOCK_SIZE)
-			if (file.size % BLOCK_SIZE) != 0:
-				needed_blocks += 1
+	def write_depend_file(self, depend_file, target_file):
+		# Make rule for rebuilding the image when a source changes
+		handle = open(depend_file, 'w')
+		handle.write("%s: %s\n" % (target_file,
+				" \\\n\t".join(self.sources)))
+		for source in self.sources:
+			handle.write("\n%s:\n" % source)
+		handle.close()
 
-			offset_in_file += needed_blocks * BLOCK_SIZE
+def import_bitmap_convert():
+	tools_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+			"..", "..", "bitmap-convert")
+	if tools_dir not in sys.path:
+		sys.path.append(tools_dir)
 
-		# Pad with zeros for the remainder of the block
-		file_length = file_handle.tell()
-		missing_bytes = BLOCK_SIZE - (file_length % BLOCK_SIZE)
-		padding = "".ljust(missing_bytes, chr(0))
-		file_handle.write(padding)
+def convert_image(image_name, add_thumbnail):
+	import_bitmap_convert()
 
-		# Write raw file data
-		for file in all_files:
-			handle      = open(file.name_on_disk, 'rb')
-			raw_data    = handle.read()
+	from PIL import Image
+	import bitmap2raw16bpp
 
-			# Pad raw_data to make it fit in flash blocks
-			if len(raw_data) % BLOCK_SIZE != 0:
-				missing_bytes = BLOCK_SIZE - (len(raw_data) %
-						BLOCK_SIZE)
+	return bitmap2raw16bpp.convert(Image.open(image_name), add_thumbnail)
 
-				raw_data = raw_data.ljust(len(raw_data) +
-						missing_bytes, chr(0))
+def convert_indexed_image(image_name, bpp):
+	import_bitmap_convert()
 
-			file_handle.write(raw_data)
-			handle.close
+	from PIL import Image
+	import bitmap2indexed
 
-		return volume_size
+	try:
+		return bitmap2indexed.convert(Image.open(image_name), bpp)[0]
+	except ValueError as error:
+		raise ValueError("%s: %s" % (image_name, error))
 
 if __name__ == "__main__":
-	print "Do not execute me directly, use mkfs.tsfs.py wrapper."
+	print("Do not execute me directly, use mkfs.tsfs.py wrapper.")